@@ -0,0 +1,239 @@
+﻿// AssetCooker.cpp : 离线资源烘焙工具
+//
+// 将清单中的模型/Shader转换为运行时可直接使用的数据并打包为AssetPack。
+// 每个资源的输入文件内容Hash记录在<output>.deps中，再次运行时仅重新烘焙输入发生变化的资源，
+// 烘焙结果缓存在<output>.cache目录中，多个资源在多个线程上并行烘焙。
+//
+// 用法: AssetCooker <manifest> <output.pak> [-j <threads>] [--force]
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include "Asset/AssetPack.h"
+#include "CookDatabase.h"
+#include "CookTasks.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	enum class CookState
+	{
+		UpToDate,
+		Cooked,
+		Failed,
+	};
+
+	void PrintUsage()
+	{
+		std::printf("usage: AssetCooker <manifest> <output.pak> [-j <threads>] [--force]\n");
+	}
+
+	bool ReadCacheFile(const std::string& path, std::vector<std::uint8_t>& outData)
+	{
+		std::ifstream fin(path, std::ios::binary);
+		if (!fin)
+			return false;
+
+		outData.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	bool WriteCacheFile(const std::string& path, const std::vector<std::uint8_t>& data)
+	{
+		std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+		if (!fout)
+			return false;
+
+		fout.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)data.size());
+		return fout.good();
+	}
+
+	// 烘焙单个任务，输入未变化时直接复用缓存
+	CookState CookOne(const CookTask& task, const fs::path& cacheDir, bool force, CookDatabase& database, std::mutex& logMutex)
+	{
+		const std::uint64_t recipeHash = task.RecipeHash();
+		if (!force && database.IsUpToDate(task.Name, recipeHash))
+			return CookState::UpToDate;
+
+		CookResult result;
+		if (!CookAsset(task, result))
+		{
+			std::lock_guard<std::mutex> lock(logMutex);
+			std::fprintf(stderr, "error: %s: %s\n", task.Name.c_str(), result.Error.c_str());
+			return CookState::Failed;
+		}
+
+		CookRecord record;
+		record.Name = task.Name;
+		record.RecipeHash = recipeHash;
+		record.OutputHash = AssetHash(result.Data.data(), result.Data.size());
+		record.CacheFile = (cacheDir / (task.Name + ".bin")).string();
+		for (const std::string& path : result.InputPaths)
+		{
+			CookInput input;
+			input.Path = path;
+			if (!database.HashFile(path, input.Hash))
+			{
+				std::lock_guard<std::mutex> lock(logMutex);
+				std::fprintf(stderr, "error: %s: cannot hash input %s\n", task.Name.c_str(), path.c_str());
+				return CookState::Failed;
+			}
+			record.Inputs.push_back(input);
+		}
+
+		// 缓存中的数据格式为 uint32 AssetType | 烘焙结果
+		std::vector<std::uint8_t> cacheData(sizeof(std::uint32_t) + result.Data.size());
+		const std::uint32_t type = (std::uint32_t)result.Type;
+		std::memcpy(cacheData.data(), &type, sizeof(type));
+		if (!result.Data.empty())
+			std::memcpy(cacheData.data() + sizeof(type), result.Data.data(), result.Data.size());
+		if (!WriteCacheFile(record.CacheFile, cacheData))
+		{
+			std::lock_guard<std::mutex> lock(logMutex);
+			std::fprintf(stderr, "error: %s: cannot write %s\n", task.Name.c_str(), record.CacheFile.c_str());
+			return CookState::Failed;
+		}
+
+		database.Update(record);
+
+		std::lock_guard<std::mutex> lock(logMutex);
+		if (result.Summary.empty())
+			std::printf("cooked %s (%zu bytes)\n", task.Name.c_str(), result.Data.size());
+		else
+			std::printf("cooked %s (%zu bytes, %s)\n", task.Name.c_str(), result.Data.size(), result.Summary.c_str());
+		return CookState::Cooked;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string manifestPath;
+	std::string outputPath;
+	unsigned threadCount = std::thread::hardware_concurrency();
+	bool force = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "-j" && i + 1 < argc)
+			threadCount = (unsigned)std::max(1, std::atoi(argv[++i]));
+		else if (arg == "--force")
+			force = true;
+		else if (manifestPath.empty())
+			manifestPath = arg;
+		else if (outputPath.empty())
+			outputPath = arg;
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+
+	if (manifestPath.empty() || outputPath.empty())
+	{
+		PrintUsage();
+		return 2;
+	}
+	if (threadCount == 0)
+		threadCount = 1;
+
+	std::vector<CookTask> tasks;
+	std::string error;
+	if (!ParseCookManifest(manifestPath, tasks, error))
+	{
+		std::fprintf(stderr, "error: %s\n", error.c_str());
+		return 1;
+	}
+
+	const std::string databasePath = outputPath + ".deps";
+	const fs::path cacheDir = outputPath + ".cache";
+	std::error_code ec;
+	fs::create_directories(cacheDir, ec);
+
+	CookDatabase database;
+	database.Load(databasePath);
+
+	std::uint64_t manifestHash = 0;
+	database.HashFile(manifestPath, manifestHash);
+
+	// 多线程并行烘焙，每个线程依次领取下一个任务
+	std::vector<CookState> states(tasks.size(), CookState::Failed);
+	std::atomic<std::size_t> nextTask(0);
+	std::mutex logMutex;
+	std::vector<std::thread> workers;
+	const unsigned workerCount = (unsigned)std::min<std::size_t>(threadCount, std::max<std::size_t>(tasks.size(), 1));
+	for (unsigned t = 0; t < workerCount; ++t)
+	{
+		workers.emplace_back([&]()
+		{
+			for (std::size_t i = nextTask++; i < tasks.size(); i = nextTask++)
+				states[i] = CookOne(tasks[i], cacheDir, force, database, logMutex);
+		});
+	}
+	for (std::thread& worker : workers)
+		worker.join();
+
+	std::size_t cooked = 0, upToDate = 0, failed = 0;
+	for (CookState state : states)
+	{
+		cooked += state == CookState::Cooked;
+		upToDate += state == CookState::UpToDate;
+		failed += state == CookState::Failed;
+	}
+
+	std::vector<std::string> liveNames;
+	for (const CookTask& task : tasks)
+		liveNames.push_back(task.Name);
+	database.Prune(liveNames);
+
+	// 资源与清单均未变化时无需重写资源包
+	const bool packUpToDate = cooked == 0 && failed == 0 && !force
+		&& database.GetManifestHash() == manifestHash && fs::exists(outputPath, ec);
+
+	if (failed == 0 && !packUpToDate)
+	{
+		AssetPackBuilder builder;
+		for (const CookTask& task : tasks)
+		{
+			CookRecord record;
+			std::vector<std::uint8_t> cacheData;
+			std::uint32_t type = 0;
+			if (!database.Find(task.Name, record) || !ReadCacheFile(record.CacheFile, cacheData) || cacheData.size() < sizeof(type))
+			{
+				std::fprintf(stderr, "error: %s: missing cooked data\n", task.Name.c_str());
+				++failed;
+				continue;
+			}
+
+			std::memcpy(&type, cacheData.data(), sizeof(type));
+			if (!builder.AddEntry(task.Name, (AssetType)type, cacheData.data() + sizeof(type), cacheData.size() - sizeof(type)))
+			{
+				std::fprintf(stderr, "error: %s: duplicate asset name\n", task.Name.c_str());
+				++failed;
+			}
+		}
+
+		if (failed == 0 && !builder.WriteToFile(outputPath))
+		{
+			std::fprintf(stderr, "error: cannot write %s\n", outputPath.c_str());
+			++failed;
+		}
+	}
+
+	// 失败时不记录清单Hash，保证下次运行重新生成资源包
+	database.SetManifestHash(failed == 0 ? manifestHash : 0);
+	database.Save(databasePath);
+
+	std::printf("%zu cooked, %zu up to date, %zu failed\n", cooked, upToDate, failed);
+	return failed == 0 ? 0 : 1;
+}
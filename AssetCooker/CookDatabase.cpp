@@ -0,0 +1,191 @@
+﻿#include "CookDatabase.h"
+#include "Asset/AssetPack.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+#define COOKDATABASE_HEADER "LearnDX12CookDB 1"
+
+namespace
+{
+	std::string ToHex(std::uint64_t value)
+	{
+		std::ostringstream ss;
+		ss << std::hex << value;
+		return ss.str();
+	}
+
+	std::uint64_t FromHex(const std::string& text)
+	{
+		return std::stoull(text, nullptr, 16);
+	}
+
+	// 按制表符拆分一行
+	std::vector<std::string> SplitTabs(const std::string& line)
+	{
+		std::vector<std::string> fields;
+		std::size_t start = 0;
+		while (true)
+		{
+			std::size_t tab = line.find('\t', start);
+			fields.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+			if (tab == std::string::npos)
+				break;
+			start = tab + 1;
+		}
+		return fields;
+	}
+}
+
+bool CookDatabase::Load(const std::string& filename)
+{
+	std::ifstream fin(filename);
+	if (!fin)
+		return false;
+
+	std::string line;
+	if (!std::getline(fin, line) || line != COOKDATABASE_HEADER)
+		return false;
+
+	std::map<std::string, CookRecord> records;
+	std::uint64_t manifestHash = 0;
+	CookRecord* current = nullptr;
+
+	try
+	{
+		while (std::getline(fin, line))
+		{
+			std::vector<std::string> fields = SplitTabs(line);
+			if (fields[0] == "manifest" && fields.size() == 2)
+			{
+				manifestHash = FromHex(fields[1]);
+			}
+			else if (fields[0] == "asset" && fields.size() == 5)
+			{
+				CookRecord& record = records[fields[1]];
+				record.Name = fields[1];
+				record.RecipeHash = FromHex(fields[2]);
+				record.OutputHash = FromHex(fields[3]);
+				record.CacheFile = fields[4];
+				current = &record;
+			}
+			else if (fields[0] == "input" && fields.size() == 3 && current != nullptr)
+			{
+				current->Inputs.push_back({ fields[2], FromHex(fields[1]) });
+			}
+			else if (fields[0] == "end")
+			{
+				current = nullptr;
+			}
+		}
+	}
+	catch (const std::exception&)
+	{
+		// 数据库损坏时视为不存在，所有资源重新烘焙
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(Mutex);
+	Records.swap(records);
+	ManifestHash = manifestHash;
+	return true;
+}
+
+bool CookDatabase::Save(const std::string& filename) const
+{
+	std::ofstream fout(filename, std::ios::trunc);
+	if (!fout)
+		return false;
+
+	std::lock_guard<std::mutex> lock(Mutex);
+	fout << COOKDATABASE_HEADER << "\n";
+	fout << "manifest\t" << ToHex(ManifestHash) << "\n";
+	for (const auto& it : Records)
+	{
+		const CookRecord& record = it.second;
+		fout << "asset\t" << record.Name << "\t" << ToHex(record.RecipeHash) << "\t" << ToHex(record.OutputHash) << "\t" << record.CacheFile << "\n";
+		for (const CookInput& input : record.Inputs)
+			fout << "input\t" << ToHex(input.Hash) << "\t" << input.Path << "\n";
+		fout << "end\n";
+	}
+	return fout.good();
+}
+
+bool CookDatabase::Find(const std::string& name, CookRecord& outRecord) const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	auto it = Records.find(name);
+	if (it == Records.end())
+		return false;
+
+	outRecord = it->second;
+	return true;
+}
+
+void CookDatabase::Update(const CookRecord& record)
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	Records[record.Name] = record;
+}
+
+void CookDatabase::Prune(const std::vector<std::string>& liveNames)
+{
+	std::unordered_set<std::string> live(liveNames.begin(), liveNames.end());
+
+	std::lock_guard<std::mutex> lock(Mutex);
+	for (auto it = Records.begin(); it != Records.end();)
+	{
+		if (live.count(it->first) == 0)
+			it = Records.erase(it);
+		else
+			++it;
+	}
+}
+
+bool CookDatabase::HashFile(const std::string& path, std::uint64_t& outHash)
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		auto it = FileHashCache.find(path);
+		if (it != FileHashCache.end())
+		{
+			outHash = it->second;
+			return true;
+		}
+	}
+
+	std::ifstream fin(path, std::ios::binary);
+	if (!fin)
+		return false;
+
+	std::vector<char> data((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+	outHash = AssetHash(data.data(), data.size());
+
+	std::lock_guard<std::mutex> lock(Mutex);
+	FileHashCache[path] = outHash;
+	return true;
+}
+
+bool CookDatabase::IsUpToDate(const std::string& name, std::uint64_t recipeHash)
+{
+	CookRecord record;
+	if (!Find(name, record))
+		return false;
+
+	if (record.RecipeHash != recipeHash || record.Inputs.empty())
+		return false;
+
+	// 缓存的烘焙结果丢失时需要重新烘焙
+	std::error_code ec;
+	if (!std::filesystem::exists(record.CacheFile, ec))
+		return false;
+
+	for (const CookInput& input : record.Inputs)
+	{
+		std::uint64_t hash = 0;
+		if (!HashFile(input.Path, hash) || hash != input.Hash)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,66 @@
+﻿#pragma once
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 参与烘焙的一个输入文件及其内容Hash
+struct CookInput
+{
+	std::string Path;
+	std::uint64_t Hash = 0;
+};
+
+// 一个资源的烘焙记录(依赖图中的一个节点)
+struct CookRecord
+{
+	std::string Name;
+	// 烘焙参数(类型/入口/目标等)与烘焙器版本的Hash，参数变化时需要重新烘焙
+	std::uint64_t RecipeHash = 0;
+	// 烘焙结果的Hash
+	std::uint64_t OutputHash = 0;
+	// 缓存的烘焙结果文件
+	std::string CacheFile;
+	// 所有输入文件(包括Shader的#include文件)
+	std::vector<CookInput> Inputs;
+};
+
+/**
+*	烘焙依赖数据库
+*	记录每个资源的输入文件内容Hash，再次烘焙时只有输入内容或参数发生变化的资源才会重新烘焙。
+*	数据库以文本格式保存，方便查看与版本比对。
+*/
+class CookDatabase
+{
+public:
+
+	bool	Load(const std::string& filename);
+	bool	Save(const std::string& filename) const;
+
+	// 查找资源的上次烘焙记录，未找到返回false
+	bool	Find(const std::string& name, CookRecord& outRecord) const;
+
+	// 更新资源的烘焙记录(线程安全)
+	void	Update(const CookRecord& record);
+
+	// 移除不再存在于清单中的资源记录
+	void	Prune(const std::vector<std::string>& liveNames);
+
+	// 计算文件内容Hash(同一文件在一次烘焙中只读取一次，线程安全)
+	bool	HashFile(const std::string& path, std::uint64_t& outHash);
+
+	// 判断资源是否需要重新烘焙
+	bool	IsUpToDate(const std::string& name, std::uint64_t recipeHash);
+
+	std::uint64_t	GetManifestHash() const { return ManifestHash; }
+	void			SetManifestHash(std::uint64_t hash) { ManifestHash = hash; }
+
+private:
+
+	mutable std::mutex Mutex;
+	std::map<std::string, CookRecord> Records;
+	std::unordered_map<std::string, std::uint64_t> FileHashCache;
+	std::uint64_t ManifestHash = 0;
+};
@@ -0,0 +1,566 @@
+﻿#include "CookTasks.h"
+#include "Mesh/MeshImporter.h"
+#include "Mesh/MeshIndexing.h"
+#include "Mesh/Meshlet.h"
+#include "Mesh/MeshOptimizer.h"
+#include "Mesh/MeshProcessor.h"
+#include "Mesh/MeshSimplifier.h"
+#include "Mesh/VertexFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <d3dcompiler.h>
+#include <wrl.h>
+#pragma comment(lib, "d3dcompiler.lib")
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	bool ReadBinaryFile(const std::string& path, std::vector<std::uint8_t>& outData)
+	{
+		std::ifstream fin(path, std::ios::binary);
+		if (!fin)
+			return false;
+
+		outData.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	// 可在清单中通过vertex=<name>选择的顶点格式
+	struct MeshVertexEncoding
+	{
+		const char* Name;
+		std::uint32_t FormatId;
+		std::uint32_t Stride;
+		void (*Encode)(const MeshData& mesh, std::vector<std::uint8_t>& outData);
+		// 位置使用16位浮点时，精度不足的模型改用的格式
+		const char* Fallback;
+	};
+
+	const MeshVertexEncoding VertexEncodings[] =
+	{
+		{ "float", ColorVertexFormat::GetId(), ColorVertexFormat::Stride, &EncodeVertices<ColorVertexFormat>, nullptr },
+		{ "packed", PackedColorVertexFormat::GetId(), PackedColorVertexFormat::Stride, &EncodeVertices<PackedColorVertexFormat>, "float" },
+		{ "lit", LitVertexFormat::GetId(), LitVertexFormat::Stride, &EncodeVertices<LitVertexFormat>, nullptr },
+		{ "packedlit", PackedLitVertexFormat::GetId(), PackedLitVertexFormat::Stride, &EncodeVertices<PackedLitVertexFormat>, "lit" },
+		{ "tangent", TangentVertexFormat::GetId(), TangentVertexFormat::Stride, &EncodeVertices<TangentVertexFormat>, nullptr },
+		{ "packedtangent", PackedTangentVertexFormat::GetId(), PackedTangentVertexFormat::Stride, &EncodeVertices<PackedTangentVertexFormat>, "tangent" },
+	};
+
+	const MeshVertexEncoding* FindVertexEncoding(const std::string& name)
+	{
+		for (const MeshVertexEncoding& encoding : VertexEncodings)
+		{
+			if (name == encoding.Name)
+				return &encoding;
+		}
+		return nullptr;
+	}
+
+	// 16位浮点位置的量化误差(约为坐标绝对值的1/4096)不超过包围盒对角线长度的千分之一时才使用16位浮点位置
+	bool CanUseHalfPositions(const MeshData& mesh)
+	{
+		if (mesh.Vertices.empty())
+			return true;
+
+		DirectX::XMFLOAT3 vMin = mesh.Vertices[0].Pos;
+		DirectX::XMFLOAT3 vMax = vMin;
+		float maxAbs = 0.0f;
+		for (const Vertex& v : mesh.Vertices)
+		{
+			ExpandMinMax(vMin, vMax, v.Pos);
+			maxAbs = std::max(maxAbs, std::max(std::fabs(v.Pos.x), std::max(std::fabs(v.Pos.y), std::fabs(v.Pos.z))));
+		}
+
+		const float dx = vMax.x - vMin.x, dy = vMax.y - vMin.y, dz = vMax.z - vMin.z;
+		const float diagonal = std::sqrt(dx * dx + dy * dy + dz * dz);
+		return maxAbs <= 65504.0f && maxAbs / 4096.0f <= diagonal / 1000.0f;
+	}
+
+	// 三角形数量不少于该值时默认生成Meshlet剔除数据及LOD链
+	const std::size_t AutoMeshletTriangleCount = 4096;
+	const std::size_t AutoLodTriangleCount = 4096;
+
+	// 解析LOD选项，auto/on使用默认比例，否则为逗号分隔的三角形比例(递减且在(0,1)之间)
+	bool ParseLodRatios(const std::string& value, std::size_t triangleCount, std::vector<float>& outRatios)
+	{
+		outRatios.clear();
+		if (value == "off" || (value == "auto" && triangleCount < AutoLodTriangleCount))
+			return true;
+		if (value == "auto" || value == "on")
+		{
+			outRatios = MeshLodOptions().Ratios;
+			return true;
+		}
+
+		std::stringstream ss(value);
+		std::string token;
+		while (std::getline(ss, token, ','))
+		{
+			char* end = nullptr;
+			const float ratio = std::strtof(token.c_str(), &end);
+			if (token.empty() || *end != '\0' || ratio <= 0.0f || ratio >= 1.0f || (!outRatios.empty() && ratio >= outRatios.back()))
+				return false;
+			outRatios.push_back(ratio);
+		}
+		return !outRatios.empty();
+	}
+
+	// 顶点格式是否包含某种语义的属性
+	bool HasSemantic(const MeshVertexEncoding& encoding, VertexSemantic semantic)
+	{
+		std::vector<VertexElementDesc> elements;
+		std::uint32_t stride = 0;
+		if (!GetVertexFormatElements(encoding.FormatId, elements, stride))
+			return false;
+		for (const VertexElementDesc& element : elements)
+		{
+			if (element.Semantic == semantic)
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	*	顶点合并及法线/切线生成
+	*	weld=off|on|<epsilon>      合并位置误差范围内且属性相同的顶点(on为位置完全相同)，默认off
+	*	normals=auto|compute       auto: 顶点格式需要法线而模型没有法线时生成；compute: 总是重新生成
+	*	顶点格式包含切线时由法线及纹理坐标生成切线
+	*/
+	bool PreprocessMesh(const CookTask& task, const MeshVertexEncoding& encoding, MeshData& mesh, std::string& outSummary, std::string& outError)
+	{
+		const std::string weldValue = task.GetOption("weld", "off");
+		const std::string normalMode = task.GetOption("normals", "auto");
+		if (normalMode != "auto" && normalMode != "compute")
+		{
+			outError = "unknown normals mode " + normalMode;
+			return false;
+		}
+
+		char text[160];
+		if (weldValue != "off")
+		{
+			MeshWeldOptions weldOptions;
+			if (weldValue != "on")
+			{
+				char* end = nullptr;
+				weldOptions.PositionEpsilon = std::strtof(weldValue.c_str(), &end);
+				if (weldValue.empty() || *end != '\0' || !(weldOptions.PositionEpsilon >= 0.0f))
+				{
+					outError = "bad weld option " + weldValue;
+					return false;
+				}
+			}
+
+			MeshWeldStats weldStats;
+			const auto start = std::chrono::steady_clock::now();
+			MeshProcessor::WeldVertices(mesh, weldOptions, &weldStats);
+			const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			std::snprintf(text, sizeof(text), ", welded %zu vertices/%zu degenerate tris (%.1f ms)",
+				weldStats.RemovedVertexCount, weldStats.RemovedTriangleCount, milliseconds);
+			outSummary += text;
+		}
+
+		const bool needNormals = HasSemantic(encoding, VertexSemantic::Normal);
+		if (normalMode == "compute" || (needNormals && mesh.Normals.size() != mesh.Vertices.size()))
+		{
+			const auto start = std::chrono::steady_clock::now();
+			MeshProcessor::ComputeNormals(mesh);
+			const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			std::snprintf(text, sizeof(text), ", normals (%.1f ms)", milliseconds);
+			outSummary += text;
+		}
+
+		// 没有纹理坐标的模型无法生成切线，使用默认切线
+		if (HasSemantic(encoding, VertexSemantic::Tangent))
+		{
+			MeshTangentStats tangentStats;
+			const auto start = std::chrono::steady_clock::now();
+			if (MeshProcessor::ComputeTangents(mesh, MeshTangentOptions(), &tangentStats))
+			{
+				const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				std::snprintf(text, sizeof(text), ", tangents (%zu split vertices, %.1f ms)", tangentStats.SplitVertexCount, milliseconds);
+				outSummary += text;
+			}
+		}
+		return true;
+	}
+
+	bool CookMesh(const CookTask& task, CookResult& outResult)
+	{
+		MeshData mesh;
+		MeshImportInfo info;
+		if (!MeshImporter::ImportFile(task.Source, mesh, outResult.Error, MeshImportOptions(), &info))
+		{
+			outResult.Error = task.Source + ": " + outResult.Error;
+			return false;
+		}
+
+		outResult.InputPaths = info.SourceFiles;
+
+		// 选择顶点格式，默认使用量化的位置+颜色格式
+		const std::string formatName = task.GetOption("vertex", "packed");
+		const MeshVertexEncoding* pEncoding = FindVertexEncoding(formatName);
+		if (pEncoding == nullptr)
+		{
+			outResult.Error = "unknown vertex format " + formatName;
+			return false;
+		}
+		if (pEncoding->Fallback != nullptr && !CanUseHalfPositions(mesh))
+			pEncoding = FindVertexEncoding(pEncoding->Fallback);
+
+		std::string processSummary;
+		if (!PreprocessMesh(task, *pEncoding, mesh, processSummary, outResult.Error))
+			return false;
+
+		// 重排三角形及顶点顺序，提高顶点缓存命中率并减少Overdraw
+		MeshOptimizeStats optimizeStats;
+		MeshOptimizer::OptimizeMesh(mesh, MeshOptimizeOptions(), &optimizeStats);
+
+		// 顶点超过65536个时尝试拆分为可使用16位索引的子集，仅在总字节数减少时采用拆分结果
+		MeshIndexStats indexStats;
+		if (!mesh.CanUse16BitIndices())
+		{
+			MeshData split = mesh;
+			SplitMeshFor16BitIndices(split, &indexStats);
+			if (indexStats.BytesSaved(pEncoding->Stride) > 0)
+				mesh = std::move(split);
+			else
+				indexStats = MeshIndexStats();
+		}
+		indexStats.IndexByteSize = SelectIndexByteSize(mesh);
+		indexStats.IndexCount = mesh.Indices32.size();
+
+		// 划分Meshlet(子集内的三角形按Meshlet重排)，供运行时按Meshlet进行视锥体/背面剔除
+		const std::string meshletMode = task.GetOption("meshlets", "auto");
+		if (meshletMode != "auto" && meshletMode != "on" && meshletMode != "off")
+		{
+			outResult.Error = "unknown meshlets mode " + meshletMode;
+			return false;
+		}
+		MeshletData meshlets;
+		double meshletMilliseconds = 0.0;
+		if (meshletMode == "on" || (meshletMode == "auto" && mesh.Indices32.size() / 3 >= AutoMeshletTriangleCount))
+		{
+			const auto start = std::chrono::steady_clock::now();
+			MeshletBuilder::BuildMeshlets(mesh, meshlets);
+			meshletMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		// 生成LOD链，各级LOD作为附加子集追加到索引缓冲区末尾，与LOD0共用顶点缓冲区
+		MeshLodOptions lodOptions;
+		const std::string lodValue = task.GetOption("lods", "auto");
+		if (!ParseLodRatios(lodValue, mesh.Indices32.size() / 3, lodOptions.Ratios))
+		{
+			outResult.Error = "bad lods option " + lodValue;
+			return false;
+		}
+		MeshLodStats lodStats;
+		double lodMilliseconds = 0.0;
+		if (!lodOptions.Ratios.empty())
+		{
+			const auto start = std::chrono::steady_clock::now();
+			MeshSimplifier::GenerateLods(mesh, lodOptions, &lodStats);
+			lodMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+		std::string lodSummary;
+		for (std::size_t level = 1; level < lodStats.TriangleCounts.size(); ++level)
+		{
+			char text[64];
+			std::snprintf(text, sizeof(text), "%sLOD%zu %zu tris (err %.4g)", lodSummary.empty() ? "" : ", ",
+				level, lodStats.TriangleCounts[level], lodStats.Errors[level]);
+			lodSummary += text;
+		}
+		if (!lodSummary.empty())
+		{
+			char text[32];
+			std::snprintf(text, sizeof(text), " (%.1f ms)", lodMilliseconds);
+			lodSummary = ", " + lodSummary + text;
+		}
+
+		// 顶点/索引数据以无损编码存放，运行时直接解码到Upload堆缓冲区
+		const std::string codecMode = task.GetOption("codec", "on");
+		if (codecMode != "on" && codecMode != "off")
+		{
+			outResult.Error = "unknown codec mode " + codecMode;
+			return false;
+		}
+		const MeshDataEncoding dataEncoding = codecMode == "on" ? MeshDataEncoding::Codec : MeshDataEncoding::None;
+
+		std::vector<std::uint8_t> vertexData;
+		pEncoding->Encode(mesh, vertexData);
+
+		char summary[448];
+		std::snprintf(summary, sizeof(summary), "%zu vertices as %s (%u bytes, %u before), %u-bit indices, %u subsets, %lld index bytes saved, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %zu meshlets (%.1f ms)",
+			mesh.Vertices.size(), pEncoding->Name, pEncoding->Stride, (unsigned)sizeof(Vertex),
+			indexStats.IndexByteSize * 8, (unsigned)mesh.Subsets.size(),
+			(long long)indexStats.BytesSaved(pEncoding->Stride),
+			optimizeStats.Before.ACMR(), optimizeStats.After.ACMR(), optimizeStats.Before.ATVR(), optimizeStats.After.ATVR(),
+			meshlets.Meshlets.size(), meshletMilliseconds);
+		outResult.Summary = summary + processSummary + lodSummary;
+
+		std::vector<MeshAssetSubset> subsets;
+		for (const MeshSubset& subset : mesh.Subsets)
+		{
+			MeshAssetSubset s;
+			s.NameHash = AssetNameHash(subset.Name);
+			s.IndexCount = subset.IndexCount;
+			s.StartIndexLocation = subset.StartIndexLocation;
+			s.BaseVertexLocation = subset.BaseVertexLocation;
+			s.BoundsCenter[0] = subset.Bounds.Center.x;
+			s.BoundsCenter[1] = subset.Bounds.Center.y;
+			s.BoundsCenter[2] = subset.Bounds.Center.z;
+			s.BoundsExtents[0] = subset.Bounds.Extents.x;
+			s.BoundsExtents[1] = subset.Bounds.Extents.y;
+			s.BoundsExtents[2] = subset.Bounds.Extents.z;
+			s.LodLevel = subset.LodLevel;
+			s.LodError = subset.LodError;
+			subsets.push_back(s);
+		}
+
+		std::vector<MeshAssetMeshlet> assetMeshlets(meshlets.Meshlets.size());
+		for (std::size_t i = 0; i < meshlets.Meshlets.size(); ++i)
+		{
+			const Meshlet& meshlet = meshlets.Meshlets[i];
+			const MeshletBounds& bounds = meshlets.Bounds[i];
+			MeshAssetMeshlet& m = assetMeshlets[i];
+			m.IndexCount = meshlet.IndexCount;
+			m.StartIndexLocation = meshlet.StartIndexLocation;
+			m.BaseVertexLocation = meshlet.BaseVertexLocation;
+			m.Center[0] = bounds.Center.x;
+			m.Center[1] = bounds.Center.y;
+			m.Center[2] = bounds.Center.z;
+			m.Radius = bounds.Radius;
+			m.ConeAxis[0] = bounds.ConeAxis.x;
+			m.ConeAxis[1] = bounds.ConeAxis.y;
+			m.ConeAxis[2] = bounds.ConeAxis.z;
+			m.ConeCutoff = bounds.ConeCutoff;
+		}
+
+		// 所有索引都能用16位表示时使用R16_UINT，使索引数据量减半
+		outResult.Type = AssetType::Mesh;
+		bool built = false;
+		if (indexStats.IndexByteSize == 2)
+		{
+			std::vector<std::uint16_t> indices16 = mesh.GetIndices16();
+			built = AssetPackBuilder::BuildMeshPayload(outResult.Data,
+				vertexData.data(), pEncoding->Stride, (std::uint32_t)mesh.Vertices.size(), pEncoding->FormatId,
+				indices16.data(), sizeof(std::uint16_t), (std::uint32_t)indices16.size(), subsets, assetMeshlets, dataEncoding);
+		}
+		else
+		{
+			built = AssetPackBuilder::BuildMeshPayload(outResult.Data,
+				vertexData.data(), pEncoding->Stride, (std::uint32_t)mesh.Vertices.size(), pEncoding->FormatId,
+				mesh.Indices32.data(), sizeof(std::uint32_t), (std::uint32_t)mesh.Indices32.size(), subsets, assetMeshlets, dataEncoding);
+		}
+		if (!built)
+		{
+			outResult.Error = task.Source + ": cannot build mesh payload (" + std::to_string(mesh.Vertices.size()) + " vertices, "
+				+ std::to_string(indexStats.IndexByteSize) + "-byte indices)";
+			return false;
+		}
+
+		MeshAssetHeader header;
+		std::memcpy(&header, outResult.Data.data(), sizeof(header));
+		// 顶点/索引分别决定是否编码，未编码的部分前后大小相同
+		if (header.VertexEncoding == MeshDataEncoding::Codec || header.IndexEncoding == MeshDataEncoding::Codec)
+		{
+			char text[96];
+			std::snprintf(text, sizeof(text), ", encoded VB %llu -> %llu bytes, IB %llu -> %llu bytes",
+				(unsigned long long)vertexData.size(), (unsigned long long)header.VertexDataStoredSize,
+				(unsigned long long)header.IndexByteSize * header.IndexCount, (unsigned long long)header.IndexDataStoredSize);
+			outResult.Summary += text;
+		}
+		return true;
+	}
+
+#if defined(_WIN32)
+	bool ReadTextFile(const std::string& path, std::string& outText)
+	{
+		std::ifstream fin(path, std::ios::binary);
+		if (!fin)
+			return false;
+
+		std::ostringstream ss;
+		ss << fin.rdbuf();
+		outText = ss.str();
+		return true;
+	}
+
+	// 记录Shader编译过程中打开的所有#include文件，作为该Shader的依赖
+	class CookShaderInclude : public ID3DInclude
+	{
+	public:
+
+		explicit CookShaderInclude(const fs::path& baseDir) : BaseDir(baseDir) {}
+
+		HRESULT __stdcall Open(D3D_INCLUDE_TYPE IncludeType, LPCSTR pFileName, LPCVOID pParentData, LPCVOID* ppData, UINT* pBytes) override
+		{
+			std::string path = (BaseDir / pFileName).string();
+			std::vector<std::uint8_t> data;
+			if (!ReadBinaryFile(path, data))
+				return E_FAIL;
+
+			Includes.push_back(path);
+			std::uint8_t* buffer = new std::uint8_t[data.size()];
+			std::memcpy(buffer, data.data(), data.size());
+			*ppData = buffer;
+			*pBytes = (UINT)data.size();
+			return S_OK;
+		}
+
+		HRESULT __stdcall Close(LPCVOID pData) override
+		{
+			delete[] static_cast<const std::uint8_t*>(pData);
+			return S_OK;
+		}
+
+		std::vector<std::string> Includes;
+
+	private:
+
+		fs::path BaseDir;
+	};
+#endif
+
+	bool CookShader(const CookTask& task, CookResult& outResult)
+	{
+		outResult.Type = AssetType::Shader;
+		outResult.InputPaths.push_back(task.Source);
+
+#if defined(_WIN32)
+		std::string source;
+		if (!ReadTextFile(task.Source, source))
+		{
+			outResult.Error = "cannot read " + task.Source;
+			return false;
+		}
+
+		CookShaderInclude includeHandler(fs::path(task.Source).parent_path());
+		Microsoft::WRL::ComPtr<ID3DBlob> byteCode;
+		Microsoft::WRL::ComPtr<ID3DBlob> errors;
+		HRESULT hr = D3DCompile(source.data(), source.size(), task.Source.c_str(), nullptr, &includeHandler,
+			task.EntryPoint.c_str(), task.Target.c_str(), D3DCOMPILE_OPTIMIZATION_LEVEL3, 0, &byteCode, &errors);
+		if (FAILED(hr))
+		{
+			outResult.Error = errors ? std::string((const char*)errors->GetBufferPointer(), errors->GetBufferSize()) : "D3DCompile failed";
+			return false;
+		}
+
+		const std::uint8_t* bytes = static_cast<const std::uint8_t*>(byteCode->GetBufferPointer());
+		outResult.Data.assign(bytes, bytes + byteCode->GetBufferSize());
+		outResult.InputPaths.insert(outResult.InputPaths.end(), includeHandler.Includes.begin(), includeHandler.Includes.end());
+		return true;
+#else
+		// 非Windows平台没有D3DCompiler，使用与源文件同目录下预编译的字节码(eg: color.hlsl + VS -> color_vs.cso)
+		fs::path source(task.Source);
+		std::string entry = task.EntryPoint;
+		for (char& c : entry)
+			c = (char)std::tolower((unsigned char)c);
+		std::string csoPath = (source.parent_path() / (source.stem().string() + "_" + entry + ".cso")).string();
+
+		if (!ReadBinaryFile(csoPath, outResult.Data) || outResult.Data.empty())
+		{
+			outResult.Error = "no precompiled bytecode " + csoPath + " (shader compilation requires Windows)";
+			return false;
+		}
+		outResult.InputPaths.push_back(csoPath);
+		return true;
+#endif
+	}
+}
+
+std::string CookTask::GetOption(const std::string& key, const std::string& defaultValue) const
+{
+	for (const std::string& option : Options)
+	{
+		if (option.size() > key.size() && option.compare(0, key.size(), key) == 0 && option[key.size()] == '=')
+			return option.substr(key.size() + 1);
+	}
+	return defaultValue;
+}
+
+std::uint64_t CookTask::RecipeHash() const
+{
+	std::string recipe = std::to_string(ASSETCOOKER_VERSION) + "|" + std::to_string((int)Type) + "|" + Source + "|" + EntryPoint + "|" + Target;
+	for (const std::string& option : Options)
+		recipe += "|" + option;
+	return AssetHash(recipe.data(), recipe.size());
+}
+
+bool ParseCookManifest(const std::string& filename, std::vector<CookTask>& outTasks, std::string& outError)
+{
+	std::ifstream fin(filename);
+	if (!fin)
+	{
+		outError = "cannot open manifest " + filename;
+		return false;
+	}
+
+	const fs::path baseDir = fs::path(filename).parent_path();
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(fin, line))
+	{
+		++lineNumber;
+		std::istringstream ss(line);
+		std::string kind;
+		if (!(ss >> kind) || kind[0] == '#')
+			continue;
+
+		CookTask task;
+		std::string source;
+		bool valid = false;
+		if (kind == "mesh")
+		{
+			task.Type = CookTaskType::Mesh;
+			valid = (bool)(ss >> task.Name >> source);
+			std::string option;
+			while (valid && ss >> option)
+			{
+				valid = option.find('=') != std::string::npos;
+				task.Options.push_back(option);
+			}
+		}
+		else if (kind == "shader")
+		{
+			task.Type = CookTaskType::Shader;
+			valid = (bool)(ss >> task.Name >> source >> task.EntryPoint >> task.Target);
+		}
+
+		if (!valid)
+		{
+			outError = filename + "(" + std::to_string(lineNumber) + "): invalid task";
+			return false;
+		}
+
+		task.Source = (baseDir / source).lexically_normal().string();
+		outTasks.push_back(task);
+	}
+	return true;
+}
+
+bool CookAsset(const CookTask& task, CookResult& outResult)
+{
+	switch (task.Type)
+	{
+	case CookTaskType::Mesh:
+		return CookMesh(task, outResult);
+	case CookTaskType::Shader:
+		return CookShader(task, outResult);
+	default:
+		return false;
+	}
+}
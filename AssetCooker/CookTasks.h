@@ -0,0 +1,58 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Asset/AssetPack.h"
+
+// 烘焙器版本，烘焙逻辑或输出格式变化时递增，使所有资源重新烘焙
+#define ASSETCOOKER_VERSION 10
+
+enum class CookTaskType
+{
+	Mesh,
+	Shader,
+};
+
+// 清单中的一个烘焙任务
+struct CookTask
+{
+	CookTaskType Type = CookTaskType::Mesh;
+	// 资源包中的条目名
+	std::string Name;
+	// 源文件路径
+	std::string Source;
+	// Shader入口函数及目标(eg: VS vs_5_0)
+	std::string EntryPoint;
+	std::string Target;
+	// 附加的烘焙参数(key=value，eg: vertex=float)
+	std::vector<std::string> Options;
+
+	// 读取附加参数，不存在时返回defaultValue
+	std::string		GetOption(const std::string& key, const std::string& defaultValue) const;
+
+	// 烘焙参数Hash
+	std::uint64_t	RecipeHash() const;
+};
+
+// 一个任务的烘焙结果
+struct CookResult
+{
+	AssetType Type = AssetType::Raw;
+	std::vector<std::uint8_t> Data;
+	// 烘焙过程中读取的所有文件
+	std::vector<std::string> InputPaths;
+	// 烘焙结果的简要说明(eg: 索引格式及节省的字节数)
+	std::string Summary;
+	std::string Error;
+};
+
+/**
+*	读取烘焙清单，每行一个任务，路径相对于清单文件所在目录
+*	mesh   <name> <source.obj/.gltf/.glb> [vertex=packed|float|packedlit|lit|packedtangent|tangent] [weld=off|on|<epsilon>]
+*	       [normals=auto|compute] [meshlets=auto|on|off] [lods=auto|off|<ratio,...>] [codec=on|off]
+*	shader <name> <source.hlsl> <entry> <target>
+*/
+bool	ParseCookManifest(const std::string& filename, std::vector<CookTask>& outTasks, std::string& outError);
+
+// 执行烘焙任务
+bool	CookAsset(const CookTask& task, CookResult& outResult);
@@ -0,0 +1,783 @@
+﻿// AssetBenchmark.cpp : 资源包及离线网格处理的性能回归测试
+//
+// 每个场景与预算(中位数，毫秒)比较，结果以JSON输出，任一场景超出预算或执行出错时退出码为1。
+//
+// 场景:
+//   asset_pack/open         映射并校验含E个条目的资源包(运行前生成到临时目录)
+//   asset_pack/find_entry   按名字查找全部E个条目
+//   asset_pack/read_entry   读取并解压E/16个LZ压缩的条目(每个16KB)
+//   geometry/<grid|sphere|geosphere>
+//                           生成708 x 708网格/1000 x 500经纬球(各约100万个三角形)/细分7次的球(33万个三角形)，输出数组在迭代间复用
+//   geometry/cache_hit      从GeometryCache中请求16种已缓存的几何体，共C次(默认10000)
+//   mesh_import/<obj|glb>   导入T x T个顶点的起伏地形(默认401 x 401，32万个三角形)，运行前生成到临时目录
+//   mesh_process/weld       合并未索引(每个三角形独立3个顶点)的地形顶点
+//   mesh_process/normals    地形的平滑法线生成
+//   mesh_process/tangents   地形的切线生成，纹理坐标u以中线镜像，中线上的顶点需要复制
+//   mesh_optimize/<ordered|shuffled>
+//                           地形的顶点缓存/Overdraw/顶点读取优化，shuffled为打乱三角形顺序后的地形，输出优化前后的ACMR/ATVR
+//   meshlet/build           优化后的地形划分为Meshlet
+//   meshlet/cull_<above|below>
+//                           环绕地形的相机(在地形上方/下方)对全部Meshlet做视锥体及法线锥剔除，下方时背面的Meshlet由法线锥剔除
+//   lod/generate            优化后的地形生成50%/25%/12.5%的LOD链，输出各级三角形数量及几何误差
+//   codec/vertices_<lit|packedlit>
+//                           解码优化后地形的编码顶点(LitVertexFormat 48字节/PackedLitVertexFormat 20字节)，输出压缩比及解码速度
+//   codec/indices           解码优化后地形的编码16位索引，输出每个三角形的位数及解码速度
+//
+// 用法: AssetBenchmark [--filter <name>] [--iterations <n>] [--warmup <n>] [--threads <n>] [--output <file.json>]
+//                      [--budget <scenario>=<ms>] [--budget-scale <factor>] [--entries <E>] [--terrain <T>]
+//                      [--cache-lookups <C>]
+//
+// Linux下构建(需要DirectXMath头文件):
+//   g++ -std=c++17 -O2 -I<DirectXMath>/Inc -ILearnDX12/Common/Include Benchmarks/AssetBenchmark.cpp Benchmarks/BenchmarkHarness.cpp
+//       LearnDX12/Common/Asset/AssetPack.cpp LearnDX12/Common/Mesh/{GeometryGenerator,MeshCodec,MeshImporter,MeshIndexing,Meshlet,MeshOptimizer,MeshProcessor,MeshSimplifier,VertexFormat}.cpp -lpthread -o AssetBenchmark
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+#include "BenchmarkHarness.h"
+#include "Asset/AssetPack.h"
+#include "Mesh/GeometryGenerator.h"
+#include "Mesh/MeshCodec.h"
+#include "Mesh/MeshImporter.h"
+#include "Mesh/MeshIndexing.h"
+#include "Mesh/Meshlet.h"
+#include "Mesh/MeshOptimizer.h"
+#include "Mesh/MeshProcessor.h"
+#include "Mesh/MeshSimplifier.h"
+#include "Mesh/VertexFormat.h"
+
+using namespace DirectX;
+namespace fs = std::filesystem;
+
+namespace
+{
+	// 每16个条目中有一个16KB的可压缩条目，其余为短小的未压缩条目
+	const std::size_t CompressedEntryInterval = 16;
+	const std::size_t CompressedEntryByteSize = 16 * 1024;
+
+	std::string MakeEntryName(std::size_t index)
+	{
+		return "meshes/level" + std::to_string(index % 8) + "/entry" + std::to_string(index);
+	}
+
+	// 类似顶点数据的可压缩内容(平缓变化的float及重复的属性)
+	std::vector<std::uint8_t> MakeCompressiblePayload(std::size_t index)
+	{
+		std::vector<float> values(CompressedEntryByteSize / sizeof(float));
+		for (std::size_t i = 0; i < values.size(); ++i)
+			values[i] = i % 8 < 3 ? (float)((i / 8 + index) % 64) * 0.25f : (i % 8 == 4 ? 1.0f : 0.0f);
+		const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(values.data());
+		return std::vector<std::uint8_t>(bytes, bytes + CompressedEntryByteSize);
+	}
+
+	void RunAssetPack(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results)
+	{
+		const char* names[] = { "asset_pack/open", "asset_pack/find_entry", "asset_pack/read_entry" };
+		// 默认预算按单核约3GHz的机器留出约3倍余量
+		const double budgets[] = { 0.5, 2.0, 10.0 };
+		if (!options.Matches(names[0]) && !options.Matches(names[1]) && !options.Matches(names[2]))
+			return;
+
+		const std::size_t count = (std::size_t)options.GetParameter("entries", 10000);
+		std::vector<std::string> entryNames(count);
+		AssetPackBuilder builder;
+		bool built = true;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			entryNames[i] = MakeEntryName(i);
+			if (i % CompressedEntryInterval == 0)
+			{
+				const std::vector<std::uint8_t> payload = MakeCompressiblePayload(i);
+				built = builder.AddEntry(entryNames[i], AssetType::Raw, payload.data(), payload.size(), AssetCompression::LZ) && built;
+			}
+			else
+				built = builder.AddEntry(entryNames[i], AssetType::Raw, entryNames[i].data(), entryNames[i].size()) && built;
+		}
+
+		const fs::path filename = fs::temp_directory_path() / "AssetBenchmark.pak";
+		built = builder.WriteToFile(filename.string()) && built;
+
+		AssetPackReader reader;
+		built = reader.Open(filename.string()) && built;
+
+		for (int kind = 0; kind < 3; ++kind)
+		{
+			if (!options.Matches(names[kind]))
+				continue;
+
+			std::size_t failedCount = 0;
+			std::uint64_t bytesRead = 0;
+			std::vector<std::uint8_t> data;
+			BenchmarkResult result = RunBenchmark(names[kind], options.WarmupIterations > 0 ? options.WarmupIterations : 5,
+				options.Iterations > 0 ? options.Iterations : 200, [&](std::size_t)
+				{
+					failedCount = 0;
+					bytesRead = 0;
+					if (kind == 0)
+					{
+						AssetPackReader pack;
+						if (!pack.Open(filename.string()))
+							++failedCount;
+					}
+					else if (kind == 1)
+					{
+						for (const std::string& name : entryNames)
+						{
+							const AssetPackEntry* entry = reader.FindEntry(name);
+							if (entry == nullptr)
+								++failedCount;
+							DoNotOptimize(entry);
+						}
+					}
+					else
+					{
+						for (std::size_t i = 0; i < count; i += CompressedEntryInterval)
+						{
+							const AssetPackEntry* entry = reader.FindEntry(entryNames[i]);
+							if (entry == nullptr || !reader.ReadEntry(*entry, data))
+								++failedCount;
+							bytesRead += data.size();
+							DoNotOptimize(data.data());
+						}
+					}
+				});
+
+			result.OperationsPerIteration = kind == 0 ? 1 : (kind == 1 ? count : (count + CompressedEntryInterval - 1) / CompressedEntryInterval);
+			result.BudgetMilliseconds = options.GetBudget(names[kind], budgets[kind]);
+			result.Metrics.emplace_back("entries", (double)count);
+			if (kind == 2 && result.MedianMilliseconds > 0.0)
+				result.Metrics.emplace_back("decompress_mb_per_s", (double)bytesRead / (result.MedianMilliseconds * 1000.0));
+			result.Metrics.emplace_back("failed", (double)failedCount);
+			result.Succeeded = built && failedCount == 0;
+			results.push_back(result);
+		}
+
+		reader.Close();
+		std::error_code error;
+		fs::remove(filename, error);
+	}
+
+	// 索引都在顶点范围内，每个顶点都有法线、纹理坐标及切线
+	bool IsValidGeneratedMesh(const MeshData& mesh)
+	{
+		bool valid = !mesh.Vertices.empty() && !mesh.Indices32.empty() && mesh.Indices32.size() % 3 == 0 && mesh.Subsets.size() == 1
+			&& mesh.Normals.size() == mesh.Vertices.size() && mesh.TexCoords.size() == mesh.Vertices.size() && mesh.Tangents.size() == mesh.Vertices.size();
+		for (std::size_t i = 0; valid && i < mesh.Indices32.size(); ++i)
+			valid = mesh.Indices32[i] < mesh.Vertices.size();
+		return valid;
+	}
+
+	void RunGeometryGenerator(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results)
+	{
+		const char* names[] = { "geometry/grid", "geometry/sphere", "geometry/geosphere" };
+		const GeometryDesc descs[] = { GeometryDesc::Grid(100.0f, 100.0f, 708, 708), GeometryDesc::Sphere(1.0f, 1000, 500), GeometryDesc::Geosphere(1.0f, 7) };
+		const double budgets[] = { 20.0, 40.0, 60.0 };
+		for (int kind = 0; kind < 3; ++kind)
+		{
+			if (!options.Matches(names[kind]))
+				continue;
+
+			MeshData mesh;
+			BenchmarkResult result = RunBenchmark(names[kind], options.WarmupIterations > 0 ? options.WarmupIterations : 1,
+				options.Iterations > 0 ? options.Iterations : 10, [&](std::size_t)
+				{
+					GeometryGenerator::Create(descs[kind], mesh);
+				});
+
+			result.OperationsPerIteration = mesh.Indices32.size() / 3;
+			result.BudgetMilliseconds = options.GetBudget(names[kind], budgets[kind]);
+			result.Metrics.emplace_back("vertices", (double)mesh.Vertices.size());
+			result.Metrics.emplace_back("triangles", (double)(mesh.Indices32.size() / 3));
+			result.Succeeded = IsValidGeneratedMesh(mesh) && (kind != 0 || mesh.Vertices.size() == 708 * 708);
+			results.push_back(result);
+		}
+
+		const std::string name = "geometry/cache_hit";
+		if (!options.Matches(name))
+			return;
+
+		GeometryCache& cache = GeometryCache::GetInstance();
+		cache.Clear();
+		std::vector<GeometryDesc> cachedDescs;
+		std::vector<std::shared_ptr<const MeshData>> cachedMeshes;
+		for (std::uint32_t i = 0; i < 16; ++i)
+		{
+			cachedDescs.push_back(i % 2 == 0 ? GeometryDesc::Box(1.0f, 1.0f, 1.0f, i + 1) : GeometryDesc::Sphere(1.0f, 8 + i, 8 + i));
+			cachedMeshes.push_back(cache.Get(cachedDescs.back()));
+		}
+
+		const std::size_t lookupCount = (std::size_t)options.GetParameter("cache-lookups", 10000);
+		const std::size_t missCount = cache.GetMissCount();
+		std::size_t mismatchCount = 0;
+		BenchmarkResult result = RunBenchmark(name, options.WarmupIterations > 0 ? options.WarmupIterations : 5,
+			options.Iterations > 0 ? options.Iterations : 200, [&](std::size_t)
+			{
+				mismatchCount = 0;
+				for (std::size_t i = 0; i < lookupCount; ++i)
+				{
+					const std::size_t index = i % cachedDescs.size();
+					if (cache.Get(cachedDescs[index]) != cachedMeshes[index])
+						++mismatchCount;
+				}
+			});
+
+		result.OperationsPerIteration = lookupCount;
+		result.BudgetMilliseconds = options.GetBudget(name, 2.0);
+		result.Metrics.emplace_back("cached_meshes", (double)cachedMeshes.size());
+		result.Metrics.emplace_back("misses", (double)(cache.GetMissCount() - missCount));
+		result.Succeeded = mismatchCount == 0 && cache.GetMissCount() == missCount;
+		results.push_back(result);
+		cache.Clear();
+	}
+
+	// 40 x 40的起伏地形，side x side个顶点，带法线及纹理坐标
+	void MakeTerrain(std::uint32_t side, MeshData& outMesh)
+	{
+		GeometryGenerator::CreateGrid(40.0f, 40.0f, side, side, outMesh);
+		for (Vertex& v : outMesh.Vertices)
+			v.Pos.y = 0.5f * std::sin(0.7f * v.Pos.x) * std::cos(0.5f * v.Pos.z) + 0.1f * std::sin(3.1f * v.Pos.x + 1.3f * v.Pos.z);
+		outMesh.Tangents.clear();
+	}
+
+	std::uint32_t GetTerrainSide(const BenchmarkOptions& options)
+	{
+		return std::max<std::uint32_t>(2, (std::uint32_t)options.GetParameter("terrain", 401));
+	}
+
+	bool WriteObj(const MeshData& mesh, const fs::path& path)
+	{
+		std::ofstream file(path);
+		if (!file)
+			return false;
+
+		for (const Vertex& v : mesh.Vertices)
+			file << "v " << v.Pos.x << ' ' << v.Pos.y << ' ' << v.Pos.z << '\n';
+		for (const XMFLOAT3& n : mesh.Normals)
+			file << "vn " << n.x << ' ' << n.y << ' ' << n.z << '\n';
+		for (const XMFLOAT2& t : mesh.TexCoords)
+			file << "vt " << t.x << ' ' << t.y << '\n';
+		for (std::size_t i = 0; i + 2 < mesh.Indices32.size(); i += 3)
+		{
+			file << 'f';
+			for (std::size_t k = 0; k < 3; ++k)
+			{
+				const std::uint32_t index = mesh.Indices32[i + k] + 1;
+				file << ' ' << index << '/' << index << '/' << index;
+			}
+			file << '\n';
+		}
+		return (bool)file;
+	}
+
+	// 单个图元的GLB: POSITION/NORMAL/TEXCOORD_0及32位索引各占一个bufferView
+	bool WriteGlb(const MeshData& mesh, const fs::path& path)
+	{
+		const std::size_t vertexCount = mesh.Vertices.size();
+		std::vector<std::uint8_t> binary;
+		auto append = [&](const void* data, std::size_t byteSize)
+		{
+			const std::size_t offset = binary.size();
+			binary.resize(offset + ((byteSize + 3) & ~(std::size_t)3), 0);
+			std::memcpy(binary.data() + offset, data, byteSize);
+			return offset;
+		};
+
+		std::vector<XMFLOAT3> positions(vertexCount);
+		for (std::size_t i = 0; i < vertexCount; ++i)
+			positions[i] = mesh.Vertices[i].Pos;
+		const std::size_t views[4] = {
+			append(positions.data(), vertexCount * sizeof(XMFLOAT3)),
+			append(mesh.Normals.data(), vertexCount * sizeof(XMFLOAT3)),
+			append(mesh.TexCoords.data(), vertexCount * sizeof(XMFLOAT2)),
+			append(mesh.Indices32.data(), mesh.Indices32.size() * sizeof(std::uint32_t)) };
+		const std::size_t viewSizes[4] = { vertexCount * 12, vertexCount * 12, vertexCount * 8, mesh.Indices32.size() * 4 };
+
+		std::string json = "{\"asset\":{\"version\":\"2.0\"},\"buffers\":[{\"byteLength\":" + std::to_string(binary.size()) + "}],\"bufferViews\":[";
+		for (int i = 0; i < 4; ++i)
+			json += std::string(i > 0 ? "," : "") + "{\"buffer\":0,\"byteOffset\":" + std::to_string(views[i]) + ",\"byteLength\":" + std::to_string(viewSizes[i]) + "}";
+		const std::string count = std::to_string(vertexCount);
+		json += "],\"accessors\":["
+			"{\"bufferView\":0,\"componentType\":5126,\"count\":" + count + ",\"type\":\"VEC3\"},"
+			"{\"bufferView\":1,\"componentType\":5126,\"count\":" + count + ",\"type\":\"VEC3\"},"
+			"{\"bufferView\":2,\"componentType\":5126,\"count\":" + count + ",\"type\":\"VEC2\"},"
+			"{\"bufferView\":3,\"componentType\":5125,\"count\":" + std::to_string(mesh.Indices32.size()) + ",\"type\":\"SCALAR\"}],"
+			"\"meshes\":[{\"name\":\"terrain\",\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}]}";
+		json.resize((json.size() + 3) & ~(std::size_t)3, ' ');
+
+		std::ofstream file(path, std::ios::binary);
+		if (!file)
+			return false;
+		const std::uint32_t header[5] = { 0x46546C67, 2, (std::uint32_t)(12 + 8 + json.size() + 8 + binary.size()), (std::uint32_t)json.size(), 0x4E4F534A };
+		const std::uint32_t binaryHeader[2] = { (std::uint32_t)binary.size(), 0x004E4942 };
+		file.write(reinterpret_cast<const char*>(header), sizeof(header));
+		file.write(json.data(), (std::streamsize)json.size());
+		file.write(reinterpret_cast<const char*>(binaryHeader), sizeof(binaryHeader));
+		file.write(reinterpret_cast<const char*>(binary.data()), (std::streamsize)binary.size());
+		return (bool)file;
+	}
+
+	void RunMeshImport(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results)
+	{
+		const char* names[] = { "mesh_import/obj", "mesh_import/glb" };
+		const double budgets[] = { 300.0, 60.0 };
+		if (!options.Matches(names[0]) && !options.Matches(names[1]))
+			return;
+
+		MeshData terrain;
+		MakeTerrain(GetTerrainSide(options), terrain);
+		const fs::path directory = fs::temp_directory_path() / "AssetBenchmarkMeshes";
+		fs::create_directories(directory);
+		const fs::path paths[] = { directory / "terrain.obj", directory / "terrain.glb" };
+
+		MeshImportOptions importOptions;
+		importOptions.ThreadCount = options.ThreadCount;
+		for (int kind = 0; kind < 2; ++kind)
+		{
+			if (!options.Matches(names[kind]))
+				continue;
+
+			const bool written = kind == 0 ? WriteObj(terrain, paths[kind]) : WriteGlb(terrain, paths[kind]);
+			bool imported = true;
+			MeshData mesh;
+			MeshImportInfo info;
+			BenchmarkResult result = RunBenchmark(names[kind], options.WarmupIterations > 0 ? options.WarmupIterations : 1,
+				options.Iterations > 0 ? options.Iterations : 10, [&](std::size_t)
+				{
+					std::string error;
+					info = MeshImportInfo();
+					imported = MeshImporter::ImportFile(paths[kind].string(), mesh, error, importOptions, &info) && imported;
+				});
+
+			result.OperationsPerIteration = info.TriangleCount;
+			result.BudgetMilliseconds = options.GetBudget(names[kind], budgets[kind]);
+			result.Metrics.emplace_back("triangles", (double)info.TriangleCount);
+			result.Metrics.emplace_back("vertices", (double)mesh.Vertices.size());
+			if (result.MedianMilliseconds > 0.0)
+				result.Metrics.emplace_back("source_mb_per_s", (double)info.SourceByteSize / (result.MedianMilliseconds * 1000.0));
+			result.Succeeded = written && imported && info.TriangleCount == terrain.Indices32.size() / 3
+				&& mesh.Vertices.size() == terrain.Vertices.size();
+			results.push_back(result);
+		}
+
+		std::error_code error;
+		fs::remove_all(directory, error);
+	}
+
+	// 打乱三角形顺序(三角形内的顶点顺序不变)
+	// 展开为每个三角形独立的3个顶点(导入未索引格式后的状态)
+	void UnweldMesh(MeshData& mesh)
+	{
+		MeshData soup;
+		soup.Name = mesh.Name;
+		soup.Vertices.reserve(mesh.Indices32.size());
+		soup.TexCoords.reserve(mesh.Indices32.size());
+		for (std::uint32_t index : mesh.Indices32)
+		{
+			soup.Indices32.push_back((std::uint32_t)soup.Vertices.size());
+			soup.Vertices.push_back(mesh.Vertices[index]);
+			soup.TexCoords.push_back(mesh.TexCoords[index]);
+		}
+		soup.Subsets = mesh.Subsets;
+		mesh = std::move(soup);
+	}
+
+	void RunMeshProcess(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results)
+	{
+		const char* names[] = { "mesh_process/weld", "mesh_process/normals", "mesh_process/tangents" };
+		const double budgets[] = { 400.0, 60.0, 200.0 };
+		const std::uint32_t side = GetTerrainSide(options);
+		MeshData terrain;
+		MakeTerrain(side, terrain);
+		const std::size_t triangleCount = terrain.Indices32.size() / 3;
+
+		for (int kind = 0; kind < 3; ++kind)
+		{
+			if (!options.Matches(names[kind]))
+				continue;
+
+			MeshData source = terrain;
+			if (kind == 0)
+				UnweldMesh(source);
+			else if (kind == 2)
+			{
+				MeshProcessor::ComputeNormals(source);
+				for (XMFLOAT2& texC : source.TexCoords)
+					texC.x = std::fabs(texC.x - 0.5f);
+			}
+
+			MeshData mesh;
+			MeshWeldStats weldStats;
+			MeshTangentStats tangentStats;
+			bool processed = true;
+			BenchmarkResult result = RunBenchmark(names[kind], options.WarmupIterations > 0 ? options.WarmupIterations : 1,
+				options.Iterations > 0 ? options.Iterations : 5, [&](std::size_t)
+				{
+					mesh = source;
+					if (kind == 0)
+					{
+						MeshWeldOptions weldOptions;
+						weldOptions.ThreadCount = options.ThreadCount;
+						weldStats = MeshWeldStats();
+						MeshProcessor::WeldVertices(mesh, weldOptions, &weldStats);
+					}
+					else if (kind == 1)
+					{
+						MeshNormalOptions normalOptions;
+						normalOptions.ThreadCount = options.ThreadCount;
+						MeshProcessor::ComputeNormals(mesh, normalOptions);
+					}
+					else
+					{
+						MeshTangentOptions tangentOptions;
+						tangentOptions.ThreadCount = options.ThreadCount;
+						tangentStats = MeshTangentStats();
+						processed = MeshProcessor::ComputeTangents(mesh, tangentOptions, &tangentStats);
+					}
+				});
+
+			result.OperationsPerIteration = kind == 0 ? source.Vertices.size() : triangleCount;
+			result.BudgetMilliseconds = options.GetBudget(names[kind], budgets[kind]);
+			if (kind == 0)
+			{
+				// 网格顶点的位置及纹理坐标各不相同，合并后应恢复为side x side个顶点
+				result.Metrics.emplace_back("vertices_before", (double)source.Vertices.size());
+				result.Metrics.emplace_back("vertices_after", (double)mesh.Vertices.size());
+				result.Metrics.emplace_back("removed_triangles", (double)weldStats.RemovedTriangleCount);
+				processed = mesh.Vertices.size() == (std::size_t)side * side && weldStats.RemovedTriangleCount == 0
+					&& mesh.Indices32.size() == source.Indices32.size();
+			}
+			else if (kind == 1)
+			{
+				// 起伏地形的法线都应为单位向量且朝向同一侧
+				std::size_t badCount = mesh.Normals.size() == mesh.Vertices.size() ? 0 : 1;
+				for (const XMFLOAT3& n : mesh.Normals)
+				{
+					const float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+					if (std::fabs(length - 1.0f) > 1.0e-3f || n.y < 0.5f)
+						++badCount;
+				}
+				result.Metrics.emplace_back("bad_normals", (double)badCount);
+				processed = badCount == 0;
+			}
+			else
+			{
+				// 切线应为与法线垂直的单位向量，镜像两侧的w符号相反
+				std::size_t badCount = mesh.Tangents.size() == mesh.Vertices.size() ? 0 : 1;
+				std::size_t mirroredCount = 0;
+				for (std::size_t i = 0; badCount == 0 && i < mesh.Tangents.size(); ++i)
+				{
+					const XMFLOAT4& t = mesh.Tangents[i];
+					const XMFLOAT3& n = mesh.Normals[i];
+					const float length = std::sqrt(t.x * t.x + t.y * t.y + t.z * t.z);
+					if (std::fabs(length - 1.0f) > 1.0e-3f || std::fabs(t.x * n.x + t.y * n.y + t.z * n.z) > 1.0e-3f)
+						++badCount;
+					if (t.w < 0.0f)
+						++mirroredCount;
+				}
+				result.Metrics.emplace_back("split_vertices", (double)tangentStats.SplitVertexCount);
+				result.Metrics.emplace_back("degenerate_triangles", (double)tangentStats.DegenerateTriangleCount);
+				result.Metrics.emplace_back("mirrored_vertices", (double)mirroredCount);
+				result.Metrics.emplace_back("bad_tangents", (double)badCount);
+				processed = processed && badCount == 0 && tangentStats.SplitVertexCount >= side
+					&& mirroredCount > 0 && mirroredCount < mesh.Vertices.size();
+			}
+			result.Succeeded = processed;
+			results.push_back(result);
+		}
+	}
+
+	void ShuffleTriangles(std::vector<std::uint32_t>& indices, std::uint32_t seed)
+	{
+		const std::size_t triangleCount = indices.size() / 3;
+		for (std::size_t t = triangleCount; t > 1; --t)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			const std::size_t other = (std::size_t)(seed >> 8) % t;
+			for (std::size_t k = 0; k < 3; ++k)
+				std::swap(indices[(t - 1) * 3 + k], indices[other * 3 + k]);
+		}
+	}
+
+	void RunMeshOptimize(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results)
+	{
+		const char* names[] = { "mesh_optimize/ordered", "mesh_optimize/shuffled" };
+		const double budgets[] = { 250.0, 300.0 };
+		for (int kind = 0; kind < 2; ++kind)
+		{
+			if (!options.Matches(names[kind]))
+				continue;
+
+			MeshData terrain;
+			MakeTerrain(GetTerrainSide(options), terrain);
+			if (kind == 1)
+				ShuffleTriangles(terrain.Indices32, 12345u);
+
+			// 每次优化一份拷贝(拷贝约占1%的时间)
+			MeshOptimizeOptions optimizeOptions;
+			optimizeOptions.ThreadCount = options.ThreadCount;
+			MeshOptimizeStats stats;
+			std::size_t triangleCount = 0;
+			BenchmarkResult result = RunBenchmark(names[kind], options.WarmupIterations > 0 ? options.WarmupIterations : 1,
+				options.Iterations > 0 ? options.Iterations : 5, [&](std::size_t)
+				{
+					MeshData mesh = terrain;
+					MeshOptimizer::OptimizeMesh(mesh, optimizeOptions, &stats);
+					triangleCount = mesh.Indices32.size() / 3;
+				});
+
+			result.OperationsPerIteration = terrain.Indices32.size() / 3;
+			result.BudgetMilliseconds = options.GetBudget(names[kind], budgets[kind]);
+			result.Metrics.emplace_back("acmr_before", stats.Before.ACMR());
+			result.Metrics.emplace_back("acmr_after", stats.After.ACMR());
+			result.Metrics.emplace_back("atvr_before", stats.Before.ATVR());
+			result.Metrics.emplace_back("atvr_after", stats.After.ATVR());
+			result.Succeeded = triangleCount == terrain.Indices32.size() / 3 && stats.After.ACMR() < stats.Before.ACMR();
+			results.push_back(result);
+		}
+	}
+
+	// 与AssetCooker相同的处理顺序: 优化、16位索引拆分
+	void MakeOptimizedTerrain(const BenchmarkOptions& options, MeshData& outMesh)
+	{
+		MakeTerrain(GetTerrainSide(options), outMesh);
+		MeshOptimizeOptions optimizeOptions;
+		optimizeOptions.ThreadCount = options.ThreadCount;
+		MeshOptimizer::OptimizeMesh(outMesh, optimizeOptions);
+		SplitMeshFor16BitIndices(outMesh);
+	}
+
+	void RunMeshlets(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results)
+	{
+		const char* names[] = { "meshlet/build", "meshlet/cull_above", "meshlet/cull_below" };
+		const double budgets[] = { 400.0, 0.1, 0.1 };
+		if (!options.Matches(names[0]) && !options.Matches(names[1]) && !options.Matches(names[2]))
+			return;
+
+		MeshData terrain;
+		MakeOptimizedTerrain(options, terrain);
+		MeshletBuildOptions buildOptions;
+		buildOptions.ThreadCount = options.ThreadCount;
+		MeshData mesh = terrain;
+		MeshletData meshlets;
+		MeshletBuilder::BuildMeshlets(mesh, meshlets, buildOptions);
+
+		if (options.Matches(names[0]))
+		{
+			std::size_t meshletCount = 0;
+			BenchmarkResult result = RunBenchmark(names[0], options.WarmupIterations > 0 ? options.WarmupIterations : 1,
+				options.Iterations > 0 ? options.Iterations : 5, [&](std::size_t)
+				{
+					MeshData copy = terrain;
+					MeshletData data;
+					MeshletBuilder::BuildMeshlets(copy, data, buildOptions);
+					meshletCount = data.Meshlets.size();
+				});
+
+			std::size_t vertexCount = 0;
+			std::size_t triangleCount = 0;
+			bool withinLimits = !meshlets.Meshlets.empty();
+			for (const Meshlet& meshlet : meshlets.Meshlets)
+			{
+				vertexCount += meshlet.VertexCount;
+				triangleCount += meshlet.TriangleCount;
+				withinLimits = withinLimits && meshlet.VertexCount <= MaxMeshletVertices && meshlet.TriangleCount <= MaxMeshletTriangles;
+			}
+			result.OperationsPerIteration = terrain.Indices32.size() / 3;
+			result.BudgetMilliseconds = options.GetBudget(names[0], budgets[0]);
+			result.Metrics.emplace_back("meshlets", (double)meshletCount);
+			result.Metrics.emplace_back("avg_vertices", meshletCount ? (double)vertexCount / meshletCount : 0.0);
+			result.Metrics.emplace_back("avg_triangles", meshletCount ? (double)triangleCount / meshletCount : 0.0);
+			result.Succeeded = withinLimits && meshletCount == meshlets.Meshlets.size() && triangleCount == terrain.Indices32.size() / 3;
+			results.push_back(result);
+		}
+
+		for (int kind = 1; kind < 3; ++kind)
+		{
+			if (!options.Matches(names[kind]))
+				continue;
+
+			std::vector<MeshletDrawRange> ranges;
+			MeshletCullStats stats;
+			const float height = kind == 1 ? 15.0f : -15.0f;
+			BenchmarkResult result = RunBenchmark(names[kind], options.WarmupIterations > 0 ? options.WarmupIterations : 5,
+				options.Iterations > 0 ? options.Iterations : 200, [&](std::size_t frame)
+				{
+					// 地形为模型空间(世界矩阵为单位矩阵)，相机在距中心30的圆周上看向中心
+					const float angle = 0.05f * (float)frame;
+					const XMFLOAT3 eye(30.0f * std::cos(angle), height, 30.0f * std::sin(angle));
+					const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(eye.x, eye.y, eye.z, 1.0f), XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+					XMFLOAT4X4 viewProj;
+					XMStoreFloat4x4(&viewProj, XMMatrixMultiply(view, XMMatrixPerspectiveFovLH(0.25f * XM_PI, 1280.0f / 768.0f, 1.0f, 1000.0f)));
+					MeshletCuller::Cull(MeshletCuller::MakeCullView(viewProj, eye), meshlets.Meshlets.data(), meshlets.Bounds.data(),
+						meshlets.Meshlets.size(), ranges, &stats);
+				});
+
+			result.OperationsPerIteration = meshlets.Meshlets.size();
+			result.BudgetMilliseconds = options.GetBudget(names[kind], budgets[kind]);
+			result.Metrics.emplace_back("meshlets", (double)stats.MeshletCount);
+			result.Metrics.emplace_back("frustum_culled", (double)stats.FrustumCulledCount);
+			result.Metrics.emplace_back("cone_culled", (double)stats.ConeCulledCount);
+			result.Metrics.emplace_back("visible_triangles", (double)stats.VisibleTriangleCount);
+			result.Metrics.emplace_back("draw_ranges", (double)stats.DrawRangeCount);
+			// 下方的相机看到的主要是地形的背面
+			result.Succeeded = stats.MeshletCount == meshlets.Meshlets.size() && stats.VisibleCount() > 0
+				&& (kind == 1 || stats.ConeCulledCount > meshlets.Meshlets.size() / 4);
+			results.push_back(result);
+		}
+	}
+
+	BenchmarkResult RunLodGeneration(const BenchmarkOptions& options, double defaultBudget)
+	{
+		const std::string name = "lod/generate";
+		MeshData terrain;
+		MakeOptimizedTerrain(options, terrain);
+
+		MeshLodOptions lodOptions;
+		lodOptions.ThreadCount = options.ThreadCount;
+		MeshLodStats stats;
+		std::size_t subsetCount = 0;
+		BenchmarkResult result = RunBenchmark(name, options.WarmupIterations > 0 ? options.WarmupIterations : 1,
+			options.Iterations > 0 ? options.Iterations : 3, [&](std::size_t)
+			{
+				MeshData mesh = terrain;
+				stats = MeshLodStats();
+				MeshSimplifier::GenerateLods(mesh, lodOptions, &stats);
+				subsetCount = mesh.Subsets.size();
+			});
+
+		result.OperationsPerIteration = terrain.Indices32.size() / 3;
+		result.BudgetMilliseconds = options.GetBudget(name, defaultBudget);
+		// 每级LOD的三角形数量应不超过目标比例(允许少量超出，锁定的边界顶点无法折叠)且误差递增
+		bool reduced = stats.TriangleCounts.size() == lodOptions.Ratios.size() + 1 && subsetCount > terrain.Subsets.size();
+		for (std::size_t level = 0; level < stats.TriangleCounts.size(); ++level)
+		{
+			result.Metrics.emplace_back("lod" + std::to_string(level) + "_triangles", (double)stats.TriangleCounts[level]);
+			if (level < stats.Errors.size())
+				result.Metrics.emplace_back("lod" + std::to_string(level) + "_error", stats.Errors[level]);
+			if (level > 0)
+			{
+				reduced = reduced && (double)stats.TriangleCounts[level] <= 1.1 * lodOptions.Ratios[level - 1] * (double)stats.TriangleCounts[0]
+					&& level < stats.Errors.size() && stats.Errors[level] >= stats.Errors[level - 1];
+			}
+		}
+		result.Succeeded = reduced;
+		return result;
+	}
+
+	// 与AssetCooker的Codec编码相同的输入: 优化及拆分后的地形转换为上传格式
+	void RunMeshCodec(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results)
+	{
+		const char* names[] = { "codec/vertices_lit", "codec/vertices_packedlit", "codec/indices" };
+		const double budgets[] = { 15.0, 8.0, 8.0 };
+		if (!options.Matches(names[0]) && !options.Matches(names[1]) && !options.Matches(names[2]))
+			return;
+
+		MeshData terrain;
+		MakeOptimizedTerrain(options, terrain);
+
+		for (int kind = 0; kind < 3; ++kind)
+		{
+			if (!options.Matches(names[kind]))
+				continue;
+
+			std::vector<std::uint8_t> raw;
+			std::size_t elementCount = 0;
+			std::size_t elementByteSize = 0;
+			std::vector<std::uint8_t> encoded;
+			bool encodedOk = true;
+			if (kind < 2)
+			{
+				if (kind == 0)
+					EncodeVertices<LitVertexFormat>(terrain, raw);
+				else
+					EncodeVertices<PackedLitVertexFormat>(terrain, raw);
+				elementCount = terrain.Vertices.size();
+				elementByteSize = raw.size() / elementCount;
+				EncodeVertexBuffer(raw.data(), elementCount, elementByteSize, encoded);
+			}
+			else
+			{
+				const std::vector<std::uint16_t> indices = terrain.GetIndices16();
+				raw.resize(indices.size() * sizeof(std::uint16_t));
+				std::memcpy(raw.data(), indices.data(), raw.size());
+				elementCount = indices.size();
+				elementByteSize = sizeof(std::uint16_t);
+				encodedOk = EncodeIndexBuffer(raw.data(), elementCount, elementByteSize, encoded);
+			}
+
+			std::vector<std::uint8_t> decoded(raw.size());
+			bool decodedOk = true;
+			BenchmarkResult result = RunBenchmark(names[kind], options.WarmupIterations > 0 ? options.WarmupIterations : 3,
+				options.Iterations > 0 ? options.Iterations : 30, [&](std::size_t)
+				{
+					if (kind < 2)
+						decodedOk = DecodeVertexBuffer(decoded.data(), elementCount, elementByteSize, encoded.data(), encoded.size());
+					else
+						decodedOk = DecodeIndexBuffer(decoded.data(), elementCount, elementByteSize, encoded.data(), encoded.size());
+					DoNotOptimize(decoded.data());
+				});
+
+			// 索引解码后三角形可能被旋转，按旋转到最小顶点在前后的结果比较
+			bool matches = decodedOk && encodedOk;
+			if (kind < 2)
+				matches = matches && decoded == raw;
+			else
+			{
+				const std::uint16_t* a = reinterpret_cast<const std::uint16_t*>(raw.data());
+				const std::uint16_t* b = reinterpret_cast<const std::uint16_t*>(decoded.data());
+				for (std::size_t i = 0; matches && i + 2 < elementCount; i += 3)
+				{
+					const std::size_t r = b[i] == a[i] ? 0 : (b[i] == a[i + 1] ? 1 : 2);
+					matches = b[i] == a[i + r] && b[i + 1] == a[i + (r + 1) % 3] && b[i + 2] == a[i + (r + 2) % 3];
+				}
+			}
+
+			result.OperationsPerIteration = kind < 2 ? elementCount : elementCount / 3;
+			result.BudgetMilliseconds = options.GetBudget(names[kind], budgets[kind]);
+			result.Metrics.emplace_back("raw_bytes", (double)raw.size());
+			result.Metrics.emplace_back("encoded_bytes", (double)encoded.size());
+			result.Metrics.emplace_back("ratio", encoded.empty() ? 0.0 : (double)raw.size() / encoded.size());
+			if (kind == 2)
+				result.Metrics.emplace_back("bits_per_triangle", elementCount ? 8.0 * encoded.size() / (elementCount / 3) : 0.0);
+			if (result.MedianMilliseconds > 0.0)
+				result.Metrics.emplace_back("decode_gb_per_s", (double)raw.size() / (result.MedianMilliseconds * 1.0e6));
+			result.Succeeded = matches && encoded.size() < raw.size();
+			results.push_back(result);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+	std::string error;
+	if (!ParseBenchmarkOptions(argc, argv, options, error))
+	{
+		std::fprintf(stderr, "%s\n", error.c_str());
+		std::fprintf(stderr, "usage: AssetBenchmark [--filter <name>] [--iterations <n>] [--warmup <n>] [--threads <n>] [--output <file.json>]\n"
+			"                      [--budget <scenario>=<ms>] [--budget-scale <factor>] [--entries <E>] [--terrain <T>]\n"
+			"                      [--cache-lookups <C>]\n");
+		return 2;
+	}
+
+	std::vector<BenchmarkResult> results;
+	RunAssetPack(options, results);
+	RunGeometryGenerator(options, results);
+	RunMeshImport(options, results);
+	RunMeshProcess(options, results);
+	RunMeshOptimize(options, results);
+	RunMeshlets(options, results);
+	if (options.Matches("lod/generate"))
+		results.push_back(RunLodGeneration(options, 2500.0));
+	RunMeshCodec(options, results);
+
+	return ReportBenchmarks(options, "AssetBenchmark", results);
+}
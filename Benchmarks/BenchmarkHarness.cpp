@@ -0,0 +1,256 @@
+﻿#include "BenchmarkHarness.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	// 通过volatile指针使编译器认为数据可能被读取
+	const void* volatile OptimizationSink = nullptr;
+
+	bool ParseUnsigned(const char* text, std::uint64_t& outValue)
+	{
+		char* end = nullptr;
+		const unsigned long long value = std::strtoull(text, &end, 10);
+		if (end == text || *end != '\0')
+			return false;
+		outValue = value;
+		return true;
+	}
+
+	bool ParseDouble(const char* text, double& outValue)
+	{
+		char* end = nullptr;
+		const double value = std::strtod(text, &end);
+		if (end == text || *end != '\0')
+			return false;
+		outValue = value;
+		return true;
+	}
+
+	void WriteJsonString(std::ostream& stream, const std::string& text)
+	{
+		stream << '"';
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+				stream << '\\' << c;
+			else if ((unsigned char)c < 0x20)
+				stream << ' ';
+			else
+				stream << c;
+		}
+		stream << '"';
+	}
+
+	// 线性插值的百分位数，samples已排序
+	double Percentile(const std::vector<double>& samples, double p)
+	{
+		if (samples.empty())
+			return 0.0;
+		const double position = p * (double)(samples.size() - 1);
+		const std::size_t index = (std::size_t)position;
+		if (index + 1 >= samples.size())
+			return samples.back();
+		const double t = position - (double)index;
+		return samples[index] + (samples[index + 1] - samples[index]) * t;
+	}
+}
+
+std::uint64_t BenchmarkOptions::GetParameter(const std::string& name, std::uint64_t defaultValue) const
+{
+	auto it = Parameters.find(name);
+	std::uint64_t value = 0;
+	return it != Parameters.end() && ParseUnsigned(it->second.c_str(), value) ? value : defaultValue;
+}
+
+double BenchmarkOptions::GetBudget(const std::string& name, double defaultBudget) const
+{
+	auto it = Budgets.find(name);
+	return (it != Budgets.end() ? it->second : defaultBudget) * BudgetScale;
+}
+
+double BenchmarkResult::GetNanosecondsPerOperation() const
+{
+	return OperationsPerIteration > 0 ? MeanMilliseconds * 1.0e6 / (double)OperationsPerIteration : 0.0;
+}
+
+double BenchmarkResult::GetOperationsPerSecond() const
+{
+	return MeanMilliseconds > 0.0 ? (double)OperationsPerIteration * 1000.0 / MeanMilliseconds : 0.0;
+}
+
+bool ParseBenchmarkOptions(int argc, char** argv, BenchmarkOptions& outOptions, std::string& outError)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		if (std::strncmp(arg, "--", 2) != 0 || i + 1 >= argc)
+		{
+			outError = std::string("unexpected argument: ") + arg;
+			return false;
+		}
+
+		const std::string name = arg + 2;
+		const char* value = argv[++i];
+		std::uint64_t number = 0;
+		if (name == "filter")
+			outOptions.Filter = value;
+		else if (name == "output")
+			outOptions.OutputPath = value;
+		else if (name == "iterations" || name == "warmup" || name == "threads")
+		{
+			if (!ParseUnsigned(value, number))
+			{
+				outError = "invalid --" + name + ": " + value;
+				return false;
+			}
+			if (name == "iterations")
+				outOptions.Iterations = (std::size_t)number;
+			else if (name == "warmup")
+				outOptions.WarmupIterations = (std::size_t)number;
+			else
+				outOptions.ThreadCount = (unsigned)number;
+		}
+		else if (name == "budget-scale")
+		{
+			if (!ParseDouble(value, outOptions.BudgetScale) || outOptions.BudgetScale <= 0.0)
+			{
+				outError = std::string("invalid --budget-scale: ") + value;
+				return false;
+			}
+		}
+		else if (name == "budget")
+		{
+			const char* separator = std::strchr(value, '=');
+			double budget = 0.0;
+			if (separator == nullptr || !ParseDouble(separator + 1, budget))
+			{
+				outError = std::string("invalid --budget (expected <scenario>=<ms>): ") + value;
+				return false;
+			}
+			outOptions.Budgets[std::string(value, separator)] = budget;
+		}
+		else
+			outOptions.Parameters[name] = value;
+	}
+	return true;
+}
+
+BenchmarkResult RunBenchmark(const std::string& name, std::size_t warmupIterations, std::size_t iterations,
+	const std::function<void(std::size_t iteration)>& iteration)
+{
+	for (std::size_t i = 0; i < warmupIterations; ++i)
+		iteration(i);
+
+	std::vector<double> milliseconds;
+	milliseconds.reserve(iterations);
+	for (std::size_t i = 0; i < iterations; ++i)
+	{
+		const auto begin = std::chrono::steady_clock::now();
+		iteration(warmupIterations + i);
+		const auto end = std::chrono::steady_clock::now();
+		milliseconds.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+	}
+
+	BenchmarkResult result;
+	result.Name = name;
+	SummarizeBenchmark(milliseconds, result);
+	return result;
+}
+
+void SummarizeBenchmark(std::vector<double>& milliseconds, BenchmarkResult& result)
+{
+	result.Iterations = milliseconds.size();
+	if (milliseconds.empty())
+		return;
+
+	std::sort(milliseconds.begin(), milliseconds.end());
+	double sum = 0.0;
+	for (double value : milliseconds)
+		sum += value;
+	result.MeanMilliseconds = sum / (double)milliseconds.size();
+	result.MedianMilliseconds = Percentile(milliseconds, 0.5);
+	result.P95Milliseconds = Percentile(milliseconds, 0.95);
+	result.MinMilliseconds = milliseconds.front();
+	result.MaxMilliseconds = milliseconds.back();
+}
+
+void WriteBenchmarkJson(std::ostream& stream, const char* suiteName, const std::vector<BenchmarkResult>& results)
+{
+	bool passed = true;
+	for (const BenchmarkResult& result : results)
+		passed = passed && result.IsPassed();
+
+	stream << "{\n  \"suite\": ";
+	WriteJsonString(stream, suiteName);
+	stream << ",\n  \"passed\": " << (passed ? "true" : "false") << ",\n  \"scenarios\": [";
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		const BenchmarkResult& result = results[i];
+		stream << (i > 0 ? "," : "") << "\n    {\"name\": ";
+		WriteJsonString(stream, result.Name);
+		stream << ", \"iterations\": " << result.Iterations
+			<< ", \"operations\": " << result.OperationsPerIteration
+			<< ", \"mean_ms\": " << result.MeanMilliseconds
+			<< ", \"median_ms\": " << result.MedianMilliseconds
+			<< ", \"p95_ms\": " << result.P95Milliseconds
+			<< ", \"min_ms\": " << result.MinMilliseconds
+			<< ", \"max_ms\": " << result.MaxMilliseconds
+			<< ", \"ns_per_op\": " << result.GetNanosecondsPerOperation()
+			<< ", \"ops_per_second\": " << result.GetOperationsPerSecond()
+			<< ", \"budget_ms\": " << result.BudgetMilliseconds
+			<< ", \"passed\": " << (result.IsPassed() ? "true" : "false");
+		for (const std::pair<std::string, double>& metric : result.Metrics)
+		{
+			stream << ", ";
+			WriteJsonString(stream, metric.first);
+			stream << ": " << metric.second;
+		}
+		stream << "}";
+	}
+	stream << "\n  ]\n}\n";
+}
+
+void PrintBenchmarkTable(std::FILE* file, const std::vector<BenchmarkResult>& results)
+{
+	std::fprintf(file, "%-40s %10s %10s %10s %12s %10s  %s\n", "scenario", "median ms", "p95 ms", "budget ms", "ns/op", "Mops/s", "result");
+	for (const BenchmarkResult& result : results)
+	{
+		std::fprintf(file, "%-40s %10.3f %10.3f %10.3f %12.2f %10.2f  %s\n", result.Name.c_str(), result.MedianMilliseconds,
+			result.P95Milliseconds, result.BudgetMilliseconds, result.GetNanosecondsPerOperation(), result.GetOperationsPerSecond() * 1.0e-6,
+			!result.Succeeded ? "FAILED" : (result.IsPassed() ? (result.BudgetMilliseconds > 0.0 ? "ok" : "-") : "OVER BUDGET"));
+	}
+}
+
+int ReportBenchmarks(const BenchmarkOptions& options, const char* suiteName, const std::vector<BenchmarkResult>& results)
+{
+	if (options.OutputPath.empty())
+		WriteBenchmarkJson(std::cout, suiteName, results);
+	else
+	{
+		std::ofstream file(options.OutputPath);
+		if (!file)
+		{
+			std::fprintf(stderr, "cannot write %s\n", options.OutputPath.c_str());
+			return 1;
+		}
+		WriteBenchmarkJson(file, suiteName, results);
+	}
+
+	PrintBenchmarkTable(stderr, results);
+	for (const BenchmarkResult& result : results)
+	{
+		if (!result.IsPassed())
+			return 1;
+	}
+	return 0;
+}
+
+void DoNotOptimize(const void* data)
+{
+	OptimizationSink = data;
+}
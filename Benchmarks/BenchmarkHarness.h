@@ -0,0 +1,91 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+*	基准测试的公共部分：命令行参数、逐次计时、统计及结果输出
+*	每个场景多次执行同一段代码，记录每次的耗时，以中位数与预算比较(中位数受偶发的调度抖动影响最小)。
+*/
+struct BenchmarkOptions
+{
+	// 只运行名称包含Filter的场景，为空时运行全部
+	std::string Filter;
+	// 每个场景的执行次数及预热次数，0表示使用场景的默认值
+	std::size_t Iterations = 0;
+	std::size_t WarmupIterations = 0;
+	unsigned ThreadCount = 0;
+	// JSON结果的输出文件，为空时输出到stdout
+	std::string OutputPath;
+	// 所有预算乘以该系数(较慢的机器上放宽预算)
+	double BudgetScale = 1.0;
+	// --budget <scenario>=<ms>指定的预算
+	std::unordered_map<std::string, double> Budgets;
+	// 其他--<name> <value>参数，由各场景读取(eg: --boxes 10000)
+	std::unordered_map<std::string, std::string> Parameters;
+
+	bool	Matches(const std::string& name) const { return Filter.empty() || name.find(Filter) != std::string::npos; }
+
+	std::uint64_t	GetParameter(const std::string& name, std::uint64_t defaultValue) const;
+
+	// 场景的预算(毫秒)：命令行指定的值或defaultBudget，乘以BudgetScale
+	double	GetBudget(const std::string& name, double defaultBudget) const;
+};
+
+struct BenchmarkResult
+{
+	std::string Name;
+	std::size_t Iterations = 0;
+	// 每次执行处理的数量(物体、文件、矩阵等)，用于计算每个操作的耗时及吞吐量
+	std::uint64_t OperationsPerIteration = 1;
+
+	double MeanMilliseconds = 0.0;
+	double MedianMilliseconds = 0.0;
+	double P95Milliseconds = 0.0;
+	double MinMilliseconds = 0.0;
+	double MaxMilliseconds = 0.0;
+
+	// 中位数的预算，0表示不检查
+	double BudgetMilliseconds = 0.0;
+	// 场景执行出错(eg: 文件导入失败)时为false，此时视为未通过
+	bool Succeeded = true;
+
+	// 场景相关的附加数据(eg: 绘制次数、可见物体数)
+	std::vector<std::pair<std::string, double>> Metrics;
+
+	bool	IsPassed() const { return Succeeded && (BudgetMilliseconds <= 0.0 || MedianMilliseconds <= BudgetMilliseconds); }
+
+	double	GetNanosecondsPerOperation() const;
+	double	GetOperationsPerSecond() const;
+};
+
+// 解析命令行，出错时返回false
+bool	ParseBenchmarkOptions(int argc, char** argv, BenchmarkOptions& outOptions, std::string& outError);
+
+/**
+*	执行warmupIterations次后计时执行iterations次
+*	iteration的参数为执行序号(从0开始，包括预热)，可用于推进动画时间
+*/
+BenchmarkResult	RunBenchmark(const std::string& name, std::size_t warmupIterations, std::size_t iterations,
+	const std::function<void(std::size_t iteration)>& iteration);
+
+// 由每次的耗时计算统计值
+void	SummarizeBenchmark(std::vector<double>& milliseconds, BenchmarkResult& result);
+
+// 所有场景的结果，一个JSON对象，passed为所有场景都在预算内
+void	WriteBenchmarkJson(std::ostream& stream, const char* suiteName, const std::vector<BenchmarkResult>& results);
+
+// 便于阅读的表格
+void	PrintBenchmarkTable(std::FILE* file, const std::vector<BenchmarkResult>& results);
+
+// 写出JSON结果(OutputPath为空时写到stdout)并在stderr打印表格，返回进程退出码：全部在预算内为0，否则为1
+int		ReportBenchmarks(const BenchmarkOptions& options, const char* suiteName, const std::vector<BenchmarkResult>& results);
+
+// 防止编译器将结果未被使用的计算优化掉
+void	DoNotOptimize(const void* data);
@@ -0,0 +1,1102 @@
+﻿// FrameBenchmark.cpp : 帧级性能回归测试
+//
+// 在不需要GPU的HeadlessCommandRecorder上运行一帧中的CPU部分(变换、剔除、排序、录制)及模型加载，
+// 每个场景与预算(中位数，毫秒)比较，结果以JSON输出，任一场景超出预算时退出码为1。
+//
+// 场景:
+//   static_boxes    N个静态盒子：剔除、排序键、DrawQueue排序及录制
+//   animated_boxes  N个运动的盒子：另外每帧更新世界矩阵、常量及包围盒
+//   mesh_load       导入M个OBJ文件(运行前生成到临时目录)
+//   culling         K个物体的SIMD视锥体剔除及间接绘制参数生成
+//   draw_queue/sort_<radix|std>
+//                   D个绘制(32种PSO、512种材质、256个网格，随机深度)的排序键排序：radix为RadixSortDrawKeys，std为std::stable_sort
+//   draw_queue/execute_<unsorted|sorted>
+//                   D个绘制按加入顺序/排序后录制，只设置变化的状态，输出实际设置及省略的状态数量
+//   static_batch/build      S个静态物体(盒子/球/圆柱，每7个中一个为镜像变换)按4种渲染状态及空间单元合批
+//   static_batch/record_<per_object|batched>
+//                   S个静态物体的剔除及录制：per_object为每个物体设置全部状态后绘制，batched为StaticBatcher::Record
+//   transform_hierarchy/dirty_<p>
+//                   H个节点的变换层级，每帧修改p%节点的局部矩阵(p为0/1/10/100)，更新世界矩阵并上传变化节点的常量
+//   scene_iterate / scene_insert / scene_churn
+//                   R个渲染物体的存储：store为SceneStore(组件数组 + 代数句柄)，geometry_ptrs为每个物体一个堆上的Geometry
+//                   iterate为剔除及生成排序键，insert为清空后创建R个物体，churn为删除R/4个随机物体后再创建R/4个
+//   material_upload/<registry|scan>_<static|dirty_1>
+//                   M个材质每帧写入当前帧资源的材质缓冲区：registry为MaterialRegistry的脏列表，scan为逐个检查NumFramesDirty，
+//                   static时材质不变，dirty_1时每帧修改1%的材质(脏列表的正确性见Tests/MaterialRegistryTests.cpp)
+//   cpu_profiler/scope
+//                   P个CPU_PROFILE_SCOPE(空作用域)的开销，ns/op为每个Scope的耗时，timestamp_ns为每次读取时间戳的耗时；
+//                   预算按每个Scope 50ns计算，20ns的目标在rdtsc约17ns的虚拟机上达不到(见CpuProfiler.h)
+//
+// 用法: FrameBenchmark [--filter <name>] [--iterations <n>] [--warmup <n>] [--threads <n>] [--output <file.json>]
+//                      [--budget <scenario>=<ms>] [--budget-scale <factor>] [--boxes <N>] [--meshes <M>] [--objects <K>] [--nodes <H>]
+//                      [--renderables <R>] [--materials <M>] [--statics <S>] [--draws <D>] [--scopes <P>]
+//
+// Linux下构建(需要DirectXMath头文件):
+//   g++ -std=c++17 -O2 -I<DirectXMath>/Inc -ILearnDX12/Common/Include Benchmarks/FrameBenchmark.cpp Benchmarks/BenchmarkHarness.cpp
+//       LearnDX12/Common/Render/{CommandRecorder,DrawQueue,IndirectDraw,MaterialRegistry,SceneStore,StaticBatcher,TransformHierarchy}.cpp
+//       LearnDX12/Common/Profile/{CpuProfiler,RenderCounters}.cpp
+//       LearnDX12/Common/Mesh/{GeometryGenerator,MeshImporter,MeshIndexing,Meshlet}.cpp -lpthread -o FrameBenchmark
+//
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+#include "BenchmarkHarness.h"
+#include "Mesh/GeometryGenerator.h"
+#include "Mesh/MeshImporter.h"
+#include "Mesh/Meshlet.h"
+#include "Profile/CpuProfiler.h"
+#include "Render/CommandRecorder.h"
+#include "Render/DrawQueue.h"
+#include "Render/IndirectDraw.h"
+#include "Render/MaterialRegistry.h"
+#include "Render/SceneStore.h"
+#include "Render/StaticBatcher.h"
+#include "Render/TransformHierarchy.h"
+
+using namespace DirectX;
+namespace fs = std::filesystem;
+
+namespace
+{
+	// 与LearnDX12中的相机参数一致
+	const float FovY = 0.25f * XM_PI;
+	const float AspectRatio = 1280.0f / 768.0f;
+	const float NearZ = 1.0f;
+	const float FarZ = 1000.0f;
+
+	// 盒子的状态种类，模拟少量PSO/材质
+	const std::uint32_t PipelineStateCount = 4;
+	const std::uint32_t MaterialCount = 16;
+	// 每个物体的常量缓冲区大小(256字节对齐)
+	const std::uint64_t ObjectConstantsStride = 256;
+
+	struct ObjectConstants
+	{
+		XMFLOAT4X4 WorldViewProj;
+	};
+
+	// 环绕场景中心的相机，返回ViewProj并输出相机位置
+	XMMATRIX MakeOrbitCamera(std::size_t frame, float radius, float height, XMFLOAT3& outEye)
+	{
+		const float angle = 0.01f * (float)frame;
+		outEye = XMFLOAT3(radius * std::cos(angle), height, radius * std::sin(angle));
+		const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(outEye.x, outEye.y, outEye.z, 1.0f), XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		return XMMatrixMultiply(view, XMMatrixPerspectiveFovLH(FovY, AspectRatio, NearZ, FarZ));
+	}
+
+	// 变换后的轴对齐包围盒(行向量约定)
+	BoundingBox TransformBounds(const BoundingBox& bounds, const XMFLOAT4X4& world)
+	{
+		const XMFLOAT3& c = bounds.Center;
+		const XMFLOAT3& e = bounds.Extents;
+		BoundingBox result;
+		result.Center.x = c.x * world.m[0][0] + c.y * world.m[1][0] + c.z * world.m[2][0] + world.m[3][0];
+		result.Center.y = c.x * world.m[0][1] + c.y * world.m[1][1] + c.z * world.m[2][1] + world.m[3][1];
+		result.Center.z = c.x * world.m[0][2] + c.y * world.m[1][2] + c.z * world.m[2][2] + world.m[3][2];
+		result.Extents.x = e.x * std::fabs(world.m[0][0]) + e.y * std::fabs(world.m[1][0]) + e.z * std::fabs(world.m[2][0]);
+		result.Extents.y = e.x * std::fabs(world.m[0][1]) + e.y * std::fabs(world.m[1][1]) + e.z * std::fabs(world.m[2][1]);
+		result.Extents.z = e.x * std::fabs(world.m[0][2]) + e.y * std::fabs(world.m[1][2]) + e.z * std::fabs(world.m[2][2]);
+		return result;
+	}
+
+	/**
+	*	网格排列的盒子
+	*	所有盒子共用一份顶点/索引缓冲区，每个盒子使用自己的常量缓冲区描述符
+	*/
+	class BoxField
+	{
+	public:
+
+		explicit BoxField(std::size_t count)
+		{
+			GeometryGenerator::CreateBox(1.0f, 1.0f, 1.0f, 0, BoxMesh);
+			LocalBounds = BoxMesh.Subsets.empty() ? BoundingBox() : BoxMesh.Subsets[0].Bounds;
+
+			const std::size_t side = (std::size_t)std::ceil(std::sqrt((double)count));
+			Spacing = 3.0f;
+			HalfSize = 0.5f * Spacing * (float)side;
+			Positions.resize(count);
+			Worlds.resize(count);
+			WorldBounds.resize(count);
+			Packets.resize(count);
+			SortIds.resize(count);
+			Constants.resize(count);
+
+			DrawPacket packet;
+			packet.RootSignature = 0x1000;
+			packet.DescriptorHeap = 0x2000;
+			packet.VertexBuffer.BufferLocation = 0x10000;
+			packet.VertexBuffer.SizeInBytes = (std::uint32_t)(BoxMesh.Vertices.size() * sizeof(Vertex));
+			packet.VertexBuffer.StrideInBytes = sizeof(Vertex);
+			packet.IndexBuffer.BufferLocation = 0x20000;
+			packet.IndexBuffer.SizeInBytes = (std::uint32_t)(BoxMesh.Indices32.size() * sizeof(std::uint16_t));
+			packet.IndexBuffer.IndexByteSize = 2;
+			packet.IndexCount = (std::uint32_t)BoxMesh.Indices32.size();
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				Positions[i] = XMFLOAT3(((float)(i % side) + 0.5f) * Spacing - HalfSize, 0.0f, ((float)(i / side) + 0.5f) * Spacing - HalfSize);
+				XMStoreFloat4x4(&Worlds[i], XMMatrixTranslation(Positions[i].x, Positions[i].y, Positions[i].z));
+				WorldBounds[i] = TransformBounds(LocalBounds, Worlds[i]);
+
+				packet.PipelineState = 0x100 + (i % PipelineStateCount);
+				packet.DescriptorTable = 0x100000 + i * ObjectConstantsStride;
+				Packets[i] = packet;
+				SortIds[i] = SortId{ GetRenderStateId(packet.PipelineState), GetRenderStateId(packet.RootSignature), (std::uint32_t)(i * 7 % MaterialCount) };
+			}
+		}
+
+		// 每个盒子绕自身的Y轴旋转并上下浮动，更新世界矩阵、常量及包围盒
+		void	Animate(float time, const XMMATRIX& viewProj)
+		{
+			for (std::size_t i = 0; i < Positions.size(); ++i)
+			{
+				const float phase = 0.37f * (float)i;
+				const XMFLOAT3& p = Positions[i];
+				const XMMATRIX world = XMMatrixMultiply(XMMatrixRotationY(time + phase), XMMatrixTranslation(p.x, p.y + std::sin(2.0f * time + phase), p.z));
+				XMStoreFloat4x4(&Worlds[i], world);
+				XMStoreFloat4x4(&Constants[i].WorldViewProj, XMMatrixTranspose(XMMatrixMultiply(world, viewProj)));
+				WorldBounds[i] = TransformBounds(LocalBounds, Worlds[i]);
+			}
+		}
+
+		// 剔除后按排序键加入绘制队列，与StaticBatchRenderer::Submit相同
+		void	Submit(DrawQueue& queue, const MeshletCullView& view) const
+		{
+			const XMFLOAT4& nearPlane = view.Planes[4];
+			for (std::size_t i = 0; i < Packets.size(); ++i)
+			{
+				const BoundingBox& bounds = WorldBounds[i];
+				if (StaticBatcher::IsOutsideFrustum(view, bounds))
+					continue;
+
+				const float depth = nearPlane.x * bounds.Center.x + nearPlane.y * bounds.Center.y + nearPlane.z * bounds.Center.z + nearPlane.w;
+				const SortId& ids = SortIds[i];
+				queue.Add(MakeDrawSortKey(0, ids.PipelineState, ids.RootSignature, ids.Material, QuantizeDrawDepth(depth, FarZ)), Packets[i]);
+			}
+		}
+
+		float	GetCameraRadius() const { return HalfSize * 1.2f + 10.0f; }
+
+		std::size_t	GetCount() const { return Packets.size(); }
+
+		const ObjectConstants*	GetConstants() const { return Constants.data(); }
+
+	private:
+
+		struct SortId
+		{
+			std::uint32_t PipelineState;
+			std::uint32_t RootSignature;
+			std::uint32_t Material;
+		};
+
+		MeshData BoxMesh;
+		BoundingBox LocalBounds;
+		float Spacing = 0.0f;
+		float HalfSize = 0.0f;
+
+		std::vector<XMFLOAT3> Positions;
+		std::vector<XMFLOAT4X4> Worlds;
+		std::vector<BoundingBox> WorldBounds;
+		std::vector<DrawPacket> Packets;
+		std::vector<SortId> SortIds;
+		// 模拟映射后的上传堆
+		std::vector<ObjectConstants> Constants;
+	};
+
+	// 剔除、排序、录制一帧
+	void RecordBoxFrame(const BoxField& boxes, const XMMATRIX& viewProj, const XMFLOAT3& eye, DrawQueue& queue, HeadlessCommandRecorder& recorder)
+	{
+		XMFLOAT4X4 viewProjMatrix;
+		XMStoreFloat4x4(&viewProjMatrix, viewProj);
+		const MeshletCullView view = MeshletCuller::MakeCullView(viewProjMatrix, eye);
+
+		queue.Reset();
+		boxes.Submit(queue, view);
+		queue.Sort();
+		recorder.Reset();
+		queue.Execute(recorder);
+	}
+
+	void AddRecorderMetrics(const HeadlessCommandRecorder& recorder, BenchmarkResult& result)
+	{
+		result.Metrics.emplace_back("draws", (double)recorder.GetCommandCount(RecordedCommandType::DrawIndexedInstanced));
+		result.Metrics.emplace_back("state_commands", (double)recorder.GetStateCommandCount());
+	}
+
+	BenchmarkResult RunBoxes(const BenchmarkOptions& options, const std::string& name, double defaultBudget, bool animate)
+	{
+		const std::size_t count = (std::size_t)options.GetParameter("boxes", 10000);
+		BoxField boxes(count);
+		DrawQueue queue;
+		queue.Reserve(count);
+		HeadlessCommandRecorder recorder;
+
+		BenchmarkResult result = RunBenchmark(name, options.WarmupIterations > 0 ? options.WarmupIterations : 5,
+			options.Iterations > 0 ? options.Iterations : 200, [&](std::size_t frame)
+			{
+				XMFLOAT3 eye;
+				const XMMATRIX viewProj = MakeOrbitCamera(frame, boxes.GetCameraRadius(), 40.0f, eye);
+				if (animate)
+				{
+					boxes.Animate(0.016f * (float)frame, viewProj);
+					DoNotOptimize(boxes.GetConstants());
+				}
+				RecordBoxFrame(boxes, viewProj, eye, queue, recorder);
+			});
+
+		result.OperationsPerIteration = count;
+		result.BudgetMilliseconds = options.GetBudget(name, defaultBudget);
+		AddRecorderMetrics(recorder, result);
+		return result;
+	}
+
+	bool WriteObj(const MeshData& mesh, const fs::path& path)
+	{
+		std::ofstream file(path);
+		if (!file)
+			return false;
+
+		const bool hasNormals = mesh.Normals.size() == mesh.Vertices.size();
+		const bool hasTexCoords = mesh.TexCoords.size() == mesh.Vertices.size();
+		for (const Vertex& v : mesh.Vertices)
+			file << "v " << v.Pos.x << ' ' << v.Pos.y << ' ' << v.Pos.z << '\n';
+		if (hasNormals)
+		{
+			for (const XMFLOAT3& n : mesh.Normals)
+				file << "vn " << n.x << ' ' << n.y << ' ' << n.z << '\n';
+		}
+		if (hasTexCoords)
+		{
+			for (const XMFLOAT2& t : mesh.TexCoords)
+				file << "vt " << t.x << ' ' << t.y << '\n';
+		}
+		for (std::size_t i = 0; i + 2 < mesh.Indices32.size(); i += 3)
+		{
+			file << 'f';
+			for (std::size_t k = 0; k < 3; ++k)
+			{
+				const std::uint32_t index = mesh.Indices32[i + k] + 1;
+				file << ' ' << index;
+				if (hasTexCoords || hasNormals)
+					file << '/' << (hasTexCoords ? std::to_string(index) : std::string()) << '/' << (hasNormals ? std::to_string(index) : std::string());
+			}
+			file << '\n';
+		}
+		return (bool)file;
+	}
+
+	BenchmarkResult RunMeshLoad(const BenchmarkOptions& options, double defaultBudget)
+	{
+		const std::string name = "mesh_load";
+		const std::size_t count = (std::size_t)options.GetParameter("meshes", 16);
+
+		// 生成不同细分程度的球体，每个约数千到两万个三角形
+		const fs::path directory = fs::temp_directory_path() / "FrameBenchmarkMeshes";
+		fs::create_directories(directory);
+		std::vector<std::string> files;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			MeshData sphere;
+			GeometryGenerator::CreateSphere(1.0f, 48 + (std::uint32_t)(i % 4) * 16, 32 + (std::uint32_t)(i % 4) * 8, sphere);
+			const fs::path path = directory / ("sphere" + std::to_string(i) + ".obj");
+			if (!WriteObj(sphere, path))
+				std::fprintf(stderr, "cannot write %s\n", path.string().c_str());
+			files.push_back(path.string());
+		}
+
+		MeshImportOptions importOptions;
+		importOptions.ThreadCount = options.ThreadCount;
+		std::size_t triangleCount = 0;
+		std::size_t failedCount = 0;
+		BenchmarkResult result = RunBenchmark(name, options.WarmupIterations > 0 ? options.WarmupIterations : 1,
+			options.Iterations > 0 ? options.Iterations : 10, [&](std::size_t)
+			{
+				triangleCount = 0;
+				failedCount = 0;
+				for (const std::string& file : files)
+				{
+					MeshData mesh;
+					std::string error;
+					if (!MeshImporter::ImportFile(file, mesh, error, importOptions))
+						++failedCount;
+					triangleCount += mesh.Indices32.size() / 3;
+				}
+			});
+
+		std::error_code error;
+		fs::remove_all(directory, error);
+
+		result.OperationsPerIteration = count;
+		result.BudgetMilliseconds = options.GetBudget(name, defaultBudget);
+		result.Metrics.emplace_back("triangles", (double)triangleCount);
+		result.Metrics.emplace_back("failed_files", (double)failedCount);
+		result.Succeeded = failedCount == 0;
+		return result;
+	}
+
+	BenchmarkResult RunCulling(const BenchmarkOptions& options, double defaultBudget)
+	{
+		const std::string name = "culling";
+		const std::size_t count = (std::size_t)options.GetParameter("objects", 100000);
+
+		// 物体随机分布在边长400的立方体内(固定种子的LCG，结果可重复)
+		IndirectDrawList draws;
+		std::uint32_t state = 12345u;
+		auto next = [&state]()
+		{
+			state = state * 1664525u + 1013904223u;
+			return (float)(state >> 8) * (1.0f / 16777216.0f);
+		};
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			IndirectDrawArguments arguments;
+			arguments.RootConstant = (std::uint32_t)i;
+			arguments.IndexCountPerInstance = 36;
+			draws.Add(XMFLOAT3(400.0f * next() - 200.0f, 400.0f * next() - 200.0f, 400.0f * next() - 200.0f), 0.5f + 2.0f * next(), arguments);
+		}
+
+		IndirectArgumentBuilder builder;
+		std::vector<IndirectDrawArguments> outArguments(count);
+		std::uint32_t visibleCount = 0;
+		BenchmarkResult result = RunBenchmark(name, options.WarmupIterations > 0 ? options.WarmupIterations : 5,
+			options.Iterations > 0 ? options.Iterations : 200, [&](std::size_t frame)
+			{
+				XMFLOAT3 eye;
+				XMFLOAT4X4 viewProj;
+				XMStoreFloat4x4(&viewProj, MakeOrbitCamera(frame, 300.0f, 50.0f, eye));
+				const MeshletCullView view = MeshletCuller::MakeCullView(viewProj, eye);
+				visibleCount = builder.Build(draws, &view, outArguments.data(), options.ThreadCount);
+				DoNotOptimize(outArguments.data());
+			});
+
+		result.OperationsPerIteration = count;
+		result.BudgetMilliseconds = options.GetBudget(name, defaultBudget);
+		result.Metrics.emplace_back("visible", (double)visibleCount);
+		return result;
+	}
+
+	void RunDrawQueue(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results)
+	{
+		const char* names[] = { "draw_queue/sort_radix", "draw_queue/sort_std", "draw_queue/execute_unsorted", "draw_queue/execute_sorted" };
+		const double budgets[] = { 8.0, 25.0, 15.0, 12.0 };
+		bool matched = false;
+		for (const char* name : names)
+			matched = matched || options.Matches(name);
+		if (!matched)
+			return;
+
+		// 固定种子的LCG，结果可重复
+		const std::size_t count = (std::size_t)options.GetParameter("draws", 100000);
+		std::uint32_t state = 12345u;
+		auto next = [&state](std::uint32_t range)
+		{
+			state = state * 1664525u + 1013904223u;
+			return (state >> 8) % range;
+		};
+		std::vector<DrawPacket> packets(count);
+		std::vector<DrawSortEntry> entries(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const std::uint32_t pipelineState = next(32);
+			const std::uint32_t material = next(512);
+			const std::uint32_t mesh = next(256);
+			DrawPacket& packet = packets[i];
+			packet.PipelineState = 0x100 + pipelineState;
+			packet.RootSignature = 0x1000 + pipelineState % 4;
+			packet.DescriptorHeap = 0x2000;
+			packet.DescriptorTable = 0x100000 + material * ObjectConstantsStride;
+			packet.VertexBuffer.BufferLocation = 0x10000000ull + mesh * 0x10000;
+			packet.VertexBuffer.SizeInBytes = 0x10000;
+			packet.VertexBuffer.StrideInBytes = sizeof(Vertex);
+			packet.IndexBuffer.BufferLocation = 0x20000000ull + mesh * 0x10000;
+			packet.IndexBuffer.SizeInBytes = 0x10000;
+			packet.IndexCount = 36;
+			entries[i].Key = MakeDrawSortKey(0, GetRenderStateId(packet.PipelineState), GetRenderStateId(packet.RootSignature),
+				material, QuantizeDrawDepth((float)next(100000) * 0.01f, FarZ));
+			entries[i].Packet = (std::uint32_t)i;
+		}
+
+		for (int kind = 0; kind < 2; ++kind)
+		{
+			if (!options.Matches(names[kind]))
+				continue;
+
+			std::vector<DrawSortEntry> sorted(count);
+			std::vector<DrawSortEntry> scratch(count);
+			BenchmarkResult result = RunBenchmark(names[kind], options.WarmupIterations > 0 ? options.WarmupIterations : 5,
+				options.Iterations > 0 ? options.Iterations : 100, [&](std::size_t)
+				{
+					sorted = entries;
+					if (kind == 0)
+						RadixSortDrawKeys(sorted.data(), scratch.data(), count);
+					else
+						std::stable_sort(sorted.begin(), sorted.end(), [](const DrawSortEntry& a, const DrawSortEntry& b) { return a.Key < b.Key; });
+				});
+
+			// 按键升序，键相同时保持加入顺序
+			bool ordered = true;
+			for (std::size_t i = 1; i < count; ++i)
+				ordered = ordered && (sorted[i - 1].Key < sorted[i].Key || (sorted[i - 1].Key == sorted[i].Key && sorted[i - 1].Packet < sorted[i].Packet));
+			result.OperationsPerIteration = count;
+			result.BudgetMilliseconds = options.GetBudget(names[kind], budgets[kind]);
+			result.Succeeded = ordered;
+			results.push_back(result);
+		}
+
+		DrawQueue queue;
+		queue.Reserve(count);
+		for (std::size_t i = 0; i < count; ++i)
+			queue.Add(entries[i].Key, packets[i]);
+		std::uint32_t unsortedStateCallCount = 0;
+		for (int kind = 2; kind < 4; ++kind)
+		{
+			if (kind == 3)
+				queue.Sort();
+			if (!options.Matches(names[kind]))
+				continue;
+
+			HeadlessCommandRecorder recorder;
+			DrawQueueStats stats;
+			BenchmarkResult result = RunBenchmark(names[kind], options.WarmupIterations > 0 ? options.WarmupIterations : 5,
+				options.Iterations > 0 ? options.Iterations : 100, [&](std::size_t)
+				{
+					recorder.Reset();
+					stats = DrawQueueStats();
+					queue.Execute(recorder, &stats);
+				});
+
+			if (kind == 2)
+				unsortedStateCallCount = stats.StateCallCount;
+			result.OperationsPerIteration = count;
+			result.BudgetMilliseconds = options.GetBudget(names[kind], budgets[kind]);
+			AddRecorderMetrics(recorder, result);
+			result.Metrics.emplace_back("redundant_state_calls", (double)stats.RedundantStateCallCount);
+			result.Succeeded = stats.PacketCount == count && recorder.GetCommandCount(RecordedCommandType::DrawIndexedInstanced) == count
+				&& (kind == 2 || unsortedStateCallCount == 0 || stats.StateCallCount < unsortedStateCallCount);
+			results.push_back(result);
+		}
+	}
+
+	void RunStaticBatch(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results)
+	{
+		const char* names[] = { "static_batch/build", "static_batch/record_per_object", "static_batch/record_batched" };
+		const double budgets[] = { 30.0, 0.5, 0.05 };
+		if (!options.Matches(names[0]) && !options.Matches(names[1]) && !options.Matches(names[2]))
+			return;
+
+		// 物体随机分布在边长200的区域内(固定种子的LCG，结果可重复)
+		const std::size_t count = (std::size_t)options.GetParameter("statics", 2000);
+		GeometryCache& cache = GeometryCache::GetInstance();
+		const std::shared_ptr<const MeshData> meshes[] = { cache.Get(GeometryDesc::Box(1.0f, 1.0f, 1.0f)),
+			cache.Get(GeometryDesc::Sphere(0.5f, 12, 8)), cache.Get(GeometryDesc::Cylinder(0.4f, 0.3f, 1.0f, 12, 1)) };
+		std::uint32_t state = 12345u;
+		auto next = [&state]()
+		{
+			state = state * 1664525u + 1013904223u;
+			return (float)(state >> 8) * (1.0f / 16777216.0f);
+		};
+		std::vector<StaticBatchInstance> instances(count);
+		std::vector<BoundingBox> worldBounds(count);
+		std::uint64_t sourceVertexCount = 0;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const float scale = 0.5f + next();
+			const float mirror = i % 7 == 0 ? -1.0f : 1.0f;
+			const XMMATRIX world = XMMatrixMultiply(XMMatrixMultiply(XMMatrixScaling(scale * mirror, scale, scale), XMMatrixRotationY(6.28f * next())),
+				XMMatrixTranslation(200.0f * next() - 100.0f, 0.0f, 200.0f * next() - 100.0f));
+			instances[i].Mesh = meshes[i % 3].get();
+			XMStoreFloat4x4(&instances[i].World, world);
+			instances[i].StateKey = i % PipelineStateCount;
+			worldBounds[i] = TransformBounds(instances[i].Mesh->Subsets[0].Bounds, instances[i].World);
+			sourceVertexCount += instances[i].Mesh->Vertices.size();
+		}
+
+		StaticBatchOptions batchOptions;
+		batchOptions.CellSize = 50.0f;
+		batchOptions.ThreadCount = options.ThreadCount;
+		std::vector<StaticBatch> batches;
+		StaticBatchStats stats;
+		StaticBatcher::Build(instances.data(), instances.size(), batchOptions, batches, &stats);
+
+		if (options.Matches(names[0]))
+		{
+			BenchmarkResult result = RunBenchmark(names[0], options.WarmupIterations > 0 ? options.WarmupIterations : 1,
+				options.Iterations > 0 ? options.Iterations : 10, [&](std::size_t)
+				{
+					std::vector<StaticBatch> built;
+					StaticBatcher::Build(instances.data(), instances.size(), batchOptions, built, &stats);
+					DoNotOptimize(built.data());
+				});
+
+			// 每次绘制的索引都能用16位表示
+			bool fits16Bit = true;
+			for (const StaticBatch& batch : batches)
+			{
+				for (const MeshSubset& draw : batch.Mesh.Subsets)
+				{
+					for (std::uint32_t k = 0; k < draw.IndexCount; ++k)
+						fits16Bit = fits16Bit && batch.Mesh.Indices32[draw.StartIndexLocation + k] <= 0xFFFF;
+				}
+			}
+			result.OperationsPerIteration = count;
+			result.BudgetMilliseconds = options.GetBudget(names[0], budgets[0]);
+			result.Metrics.emplace_back("source_draws", (double)stats.SourceDrawCount);
+			result.Metrics.emplace_back("batched_draws", (double)stats.DrawCount);
+			result.Metrics.emplace_back("batches", (double)stats.BatchCount);
+			result.Metrics.emplace_back("vertices", (double)stats.VertexCount);
+			result.Succeeded = fits16Bit && stats.InstanceCount == count && stats.BatchCount == PipelineStateCount
+				&& stats.DrawCount < stats.SourceDrawCount && stats.VertexCount == sourceVertexCount;
+			results.push_back(result);
+		}
+
+		// 每个批次(per_object时每个物体)使用独立的缓冲区
+		std::vector<StaticBatchBinding> bindings(batches.size());
+		for (std::size_t b = 0; b < batches.size(); ++b)
+		{
+			bindings[b].PipelineState = 0x100 + batches[b].StateKey;
+			bindings[b].RootSignature = 0x1000;
+			bindings[b].DescriptorHeap = 0x2000;
+			bindings[b].DescriptorTable = 0x100000 + b * ObjectConstantsStride;
+			bindings[b].VertexBuffer.BufferLocation = 0x10000000ull * (b + 1);
+			bindings[b].VertexBuffer.StrideInBytes = sizeof(Vertex);
+			bindings[b].IndexBuffer.BufferLocation = 0x20000000ull * (b + 1);
+			bindings[b].IndexBuffer.IndexByteSize = 2;
+		}
+
+		std::uint32_t perObjectDrawCount = 0;
+		for (int kind = 1; kind < 3; ++kind)
+		{
+			if (!options.Matches(names[kind]))
+				continue;
+
+			HeadlessCommandRecorder recorder;
+			std::uint32_t drawCount = 0;
+			BenchmarkResult result = RunBenchmark(names[kind], options.WarmupIterations > 0 ? options.WarmupIterations : 5,
+				options.Iterations > 0 ? options.Iterations : 200, [&](std::size_t frame)
+				{
+					XMFLOAT3 eye;
+					XMFLOAT4X4 viewProj;
+					XMStoreFloat4x4(&viewProj, MakeOrbitCamera(frame, 60.0f, 20.0f, eye));
+					const MeshletCullView view = MeshletCuller::MakeCullView(viewProj, eye);
+					recorder.Reset();
+					drawCount = 0;
+					if (kind == 1)
+					{
+						// 与Geometry::Draw相同，每个物体设置全部状态
+						for (std::size_t i = 0; i < count; ++i)
+						{
+							if (StaticBatcher::IsOutsideFrustum(view, worldBounds[i]))
+								continue;
+
+							const MeshData& mesh = *instances[i].Mesh;
+							VertexBufferBinding vertexBuffer;
+							vertexBuffer.BufferLocation = 0x10000000ull + i * 0x10000;
+							vertexBuffer.SizeInBytes = (std::uint32_t)(mesh.Vertices.size() * sizeof(Vertex));
+							vertexBuffer.StrideInBytes = sizeof(Vertex);
+							IndexBufferBinding indexBuffer;
+							indexBuffer.BufferLocation = 0x20000000ull + i * 0x10000;
+							indexBuffer.SizeInBytes = (std::uint32_t)(mesh.Indices32.size() * sizeof(std::uint16_t));
+							indexBuffer.IndexByteSize = 2;
+
+							recorder.SetDescriptorHeap(0x2000);
+							recorder.SetGraphicsRootSignature(0x1000);
+							recorder.SetGraphicsRootDescriptorTable(0, 0x100000 + i * ObjectConstantsStride);
+							recorder.SetPipelineState(0x100 + instances[i].StateKey);
+							recorder.SetVertexBuffer(vertexBuffer);
+							recorder.SetIndexBuffer(indexBuffer);
+							recorder.SetPrimitiveTopology(PrimitiveTopologyTriangleList);
+							for (const MeshSubset& subset : mesh.Subsets)
+								recorder.DrawIndexedInstanced(subset.IndexCount, 1, subset.StartIndexLocation, subset.BaseVertexLocation, 0);
+							++drawCount;
+						}
+					}
+					else
+					{
+						for (std::size_t b = 0; b < batches.size(); ++b)
+							drawCount += StaticBatcher::Record(recorder, batches[b], bindings[b], &view);
+					}
+				});
+
+			if (kind == 1)
+				perObjectDrawCount = drawCount;
+			result.OperationsPerIteration = count;
+			result.BudgetMilliseconds = options.GetBudget(names[kind], budgets[kind]);
+			AddRecorderMetrics(recorder, result);
+			result.Succeeded = drawCount > 0 && recorder.GetCommandCount(RecordedCommandType::DrawIndexedInstanced) == drawCount
+				&& (kind == 1 || perObjectDrawCount == 0 || drawCount < perObjectDrawCount);
+			results.push_back(result);
+		}
+	}
+
+	/**
+	*	H个节点的层级：前1/100为根节点，其余节点的父节点为(i - rootCount) / 4，深度约为log4(100)
+	*	每帧修改dirtyPercent%的节点(固定种子随机选取，可能重复)，更新后将变化节点的世界矩阵写入常量缓冲区
+	*/
+	BenchmarkResult RunTransformHierarchy(const BenchmarkOptions& options, std::uint32_t dirtyPercent, double defaultBudget)
+	{
+		const std::string name = "transform_hierarchy/dirty_" + std::to_string(dirtyPercent);
+		const std::size_t count = (std::size_t)options.GetParameter("nodes", 100000);
+		const std::size_t rootCount = std::max<std::size_t>(count / 100, 1);
+
+		// 局部矩阵在64个旋转平移矩阵中轮换
+		std::vector<XMFLOAT4X4> locals(64);
+		for (std::size_t i = 0; i < locals.size(); ++i)
+			XMStoreFloat4x4(&locals[i], XMMatrixMultiply(XMMatrixRotationY(0.1f * (float)i), XMMatrixTranslation(1.0f, 0.1f * (float)(i % 8), 0.0f)));
+
+		TransformHierarchy hierarchy;
+		hierarchy.Reserve(count);
+		std::vector<TransformId> ids(count);
+		for (std::size_t i = 0; i < count; ++i)
+			ids[i] = hierarchy.Create(locals[i % locals.size()], i < rootCount ? InvalidTransformId : ids[(i - rootCount) / 4]);
+		hierarchy.Update(options.ThreadCount);
+
+		std::vector<TransformId> dirtyIds(count * dirtyPercent / 100);
+		std::uint32_t state = 12345u;
+		for (TransformId& id : dirtyIds)
+		{
+			state = state * 1664525u + 1013904223u;
+			id = ids[(state >> 8) % count];
+		}
+
+		// 映射后的上传堆，每个节点256字节
+		std::vector<std::uint8_t> constantBuffer(count * ObjectConstantsStride);
+		TransformHierarchyStats stats;
+		std::uint64_t uploadBytes = 0;
+		BenchmarkResult result = RunBenchmark(name, options.WarmupIterations > 0 ? options.WarmupIterations : 5,
+			options.Iterations > 0 ? options.Iterations : 200, [&](std::size_t frame)
+			{
+				for (std::size_t i = 0; i < dirtyIds.size(); ++i)
+					hierarchy.SetLocal(dirtyIds[i], locals[(frame + i) % locals.size()]);
+				hierarchy.Update(options.ThreadCount, &stats);
+
+				const XMFLOAT4X4* worlds = hierarchy.GetWorldMatrices();
+				uploadBytes = 0;
+				for (std::uint32_t index : hierarchy.GetChangedIndices())
+				{
+					ObjectConstants constants;
+					XMStoreFloat4x4(&constants.WorldViewProj, XMMatrixTranspose(XMLoadFloat4x4(&worlds[index])));
+					std::memcpy(&constantBuffer[index * ObjectConstantsStride], &constants, sizeof(constants));
+					uploadBytes += sizeof(constants);
+				}
+				DoNotOptimize(constantBuffer.data());
+			});
+
+		result.OperationsPerIteration = count;
+		result.BudgetMilliseconds = options.GetBudget(name, defaultBudget);
+		result.Metrics.emplace_back("levels", (double)stats.LevelCount);
+		result.Metrics.emplace_back("dirty", (double)dirtyIds.size());
+		result.Metrics.emplace_back("updated", (double)stats.UpdatedCount);
+		result.Metrics.emplace_back("upload_bytes", (double)uploadBytes);
+		return result;
+	}
+
+	/**
+	*	与Geometry成员布局相同的对象(Geometry依赖D3D12，COM指针及描述符以相同大小的成员代替)，
+	*	末尾加上每个物体的世界矩阵、包围盒、模型、材质及可见性
+	*/
+	struct GeometryObject
+	{
+		std::string Name;
+		void* VertexBufferCPU = nullptr;
+		void* IndexBufferCPU = nullptr;
+		void* VertexBufferGPU = nullptr;
+		void* IndexBufferGPU = nullptr;
+		std::uint8_t VertexBufferView[16] = {};
+		std::uint8_t IndexBufferView[16] = {};
+		std::vector<MeshSubset> Submeshes;
+		MeshletData Meshlets;
+		std::vector<MeshletDrawRange> VisibleRanges;
+		MeshletCullStats LastCullStats;
+		XMFLOAT4X4 WorldViewProj = XMFLOAT4X4();
+		std::vector<float> LodErrors;
+		std::uint32_t CurrentLod = 0;
+		float LodPixelError = 1.0f;
+		float ViewportHeight = 768.0f;
+		BoundingSphere LodBounds;
+		void* VertexBufferUploader = nullptr;
+		void* IndexBufferUploader = nullptr;
+		void* CBVHeap = nullptr;
+		std::unique_ptr<ObjectConstants> ObjectConstantBuffer;
+		void* RootSignature = nullptr;
+		void* VSByteCode = nullptr;
+		void* PSByteCode = nullptr;
+		std::vector<std::array<std::uint8_t, 32>> InputLayout;
+		void* PSO = nullptr;
+		std::uint32_t PipelineStateId = 0;
+		std::uint32_t RootSignatureId = 0;
+		std::uint32_t MaterialId = 0;
+		float SortDepthRange = 1000.0f;
+		DrawQueue FrameQueue;
+
+		XMFLOAT4X4 World = XMFLOAT4X4();
+		BoundingBox Bounds;
+		std::uint32_t MeshId = 0;
+		std::uint8_t Visibility = RenderableVisible;
+	};
+
+	std::unique_ptr<GeometryObject> MakeGeometryObject(const RenderableDesc& desc)
+	{
+		std::unique_ptr<GeometryObject> object = std::make_unique<GeometryObject>();
+		object->Name = "box";
+		object->Submeshes.resize(1);
+		object->LodErrors.resize(1);
+		object->InputLayout.resize(2);
+		object->ObjectConstantBuffer = std::make_unique<ObjectConstants>();
+		object->World = desc.World;
+		object->Bounds = desc.Bounds;
+		object->MeshId = desc.MeshId;
+		object->MaterialId = desc.MaterialId;
+		object->Visibility = desc.Visibility;
+		return object;
+	}
+
+	// 剔除后的排序键(模型编号作为PSO字段，距离作为深度)
+	std::uint64_t MakeRenderableKey(const MeshletCullView& view, std::uint32_t meshId, std::uint32_t materialId, const BoundingBox& bounds)
+	{
+		const XMFLOAT4& nearPlane = view.Planes[4];
+		const float depth = nearPlane.x * bounds.Center.x + nearPlane.y * bounds.Center.y + nearPlane.z * bounds.Center.z + nearPlane.w;
+		return MakeDrawSortKey(0, meshId, 0, materialId, QuantizeDrawDepth(depth, FarZ));
+	}
+
+	/**
+	*	R个物体随机分布在边长400的立方体内(与culling相同)，每个场景分别测量SceneStore及Geometry指针数组
+	*	kind: 0为iterate，1为insert，2为churn
+	*/
+	void RunSceneStorage(const BenchmarkOptions& options, int kind, double defaultBudget, std::vector<BenchmarkResult>& results)
+	{
+		const char* kindNames[] = { "scene_iterate", "scene_insert", "scene_churn" };
+		const std::string storeName = std::string(kindNames[kind]) + "/store";
+		const std::string pointerName = std::string(kindNames[kind]) + "/geometry_ptrs";
+		const bool runStore = options.Matches(storeName);
+		const bool runPointers = options.Matches(pointerName);
+		if (!runStore && !runPointers)
+			return;
+
+		const std::size_t count = (std::size_t)options.GetParameter("renderables", 100000);
+		std::uint32_t state = 12345u;
+		auto next = [&state]()
+		{
+			state = state * 1664525u + 1013904223u;
+			return state >> 8;
+		};
+		auto nextFloat = [&next]() { return (float)next() * (1.0f / 16777216.0f); };
+
+		std::vector<RenderableDesc> descs(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			RenderableDesc& desc = descs[i];
+			const XMFLOAT3 position(400.0f * nextFloat() - 200.0f, 400.0f * nextFloat() - 200.0f, 400.0f * nextFloat() - 200.0f);
+			const float size = 0.5f + 2.0f * nextFloat();
+			XMStoreFloat4x4(&desc.World, XMMatrixTranslation(position.x, position.y, position.z));
+			desc.Bounds.Center = position;
+			desc.Bounds.Extents = XMFLOAT3(size, size, size);
+			desc.MeshId = (std::uint32_t)(i % PipelineStateCount);
+			desc.MaterialId = (std::uint32_t)(i * 7 % MaterialCount);
+			desc.Visibility = (i % 16) == 0 ? RenderableHidden : RenderableVisible;
+		}
+
+		// 删除的物体由随机数选择，两种存储使用相同的序列
+		const std::size_t churnCount = count / 4;
+		const std::size_t iterations = options.Iterations > 0 ? options.Iterations : 50;
+		const std::size_t warmup = options.WarmupIterations > 0 ? options.WarmupIterations : 2;
+		std::vector<std::uint32_t> visible;
+		std::vector<std::uint64_t> keys;
+		visible.reserve(count);
+		keys.reserve(count);
+
+		auto makeView = [](std::size_t frame)
+		{
+			XMFLOAT3 eye;
+			XMFLOAT4X4 viewProj;
+			XMStoreFloat4x4(&viewProj, MakeOrbitCamera(frame, 300.0f, 50.0f, eye));
+			return MeshletCuller::MakeCullView(viewProj, eye);
+		};
+
+		if (runStore)
+		{
+			SceneStore store;
+			store.Reserve(count);
+			for (const RenderableDesc& desc : descs)
+				store.Create(desc);
+
+			BenchmarkResult result = RunBenchmark(storeName, warmup, iterations, [&](std::size_t frame)
+				{
+					if (kind == 0)
+					{
+						const MeshletCullView view = makeView(frame);
+						store.CullVisible(view, visible);
+						keys.clear();
+						const std::uint32_t* meshIds = store.GetMeshIds();
+						const std::uint32_t* materialIds = store.GetMaterialIds();
+						const BoundingBox* bounds = store.GetBounds();
+						for (std::uint32_t index : visible)
+							keys.push_back(MakeRenderableKey(view, meshIds[index], materialIds[index], bounds[index]));
+						DoNotOptimize(keys.data());
+					}
+					else if (kind == 1)
+					{
+						store.Clear();
+						for (const RenderableDesc& desc : descs)
+							store.Create(desc);
+					}
+					else
+					{
+						for (std::size_t i = 0; i < churnCount; ++i)
+							store.Destroy(store.GetHandle(next() % (std::uint32_t)store.GetCount()));
+						for (std::size_t i = 0; i < churnCount; ++i)
+							store.Create(descs[next() % count]);
+					}
+				});
+			result.OperationsPerIteration = kind == 2 ? churnCount * 2 : count;
+			result.BudgetMilliseconds = options.GetBudget(storeName, defaultBudget);
+			if (kind == 0)
+				result.Metrics.emplace_back("visible", (double)visible.size());
+			results.push_back(result);
+		}
+
+		if (runPointers)
+		{
+			state = 12345u;
+			std::vector<std::unique_ptr<GeometryObject>> objects;
+			objects.reserve(count);
+			for (const RenderableDesc& desc : descs)
+				objects.push_back(MakeGeometryObject(desc));
+
+			BenchmarkResult result = RunBenchmark(pointerName, warmup, iterations, [&](std::size_t frame)
+				{
+					if (kind == 0)
+					{
+						const MeshletCullView view = makeView(frame);
+						visible.clear();
+						keys.clear();
+						for (std::size_t i = 0; i < objects.size(); ++i)
+						{
+							const GeometryObject& object = *objects[i];
+							if ((object.Visibility & RenderableVisible) != 0 && !StaticBatcher::IsOutsideFrustum(view, object.Bounds))
+								visible.push_back((std::uint32_t)i);
+						}
+						for (std::uint32_t index : visible)
+						{
+							const GeometryObject& object = *objects[index];
+							keys.push_back(MakeRenderableKey(view, object.MeshId, object.MaterialId, object.Bounds));
+						}
+						DoNotOptimize(keys.data());
+					}
+					else if (kind == 1)
+					{
+						objects.clear();
+						for (const RenderableDesc& desc : descs)
+							objects.push_back(MakeGeometryObject(desc));
+					}
+					else
+					{
+						// 与SceneStore相同的swap-remove，只比较数据布局及分配的差异
+						for (std::size_t i = 0; i < churnCount; ++i)
+						{
+							const std::size_t index = next() % (std::uint32_t)objects.size();
+							objects[index] = std::move(objects.back());
+							objects.pop_back();
+						}
+						for (std::size_t i = 0; i < churnCount; ++i)
+							objects.push_back(MakeGeometryObject(descs[next() % count]));
+					}
+				});
+			result.OperationsPerIteration = kind == 2 ? churnCount * 2 : count;
+			if (kind == 0)
+				result.Metrics.emplace_back("visible", (double)visible.size());
+			results.push_back(result);
+		}
+	}
+
+	// 帧资源数量(与LearnDX12示例中的gNumFrameResources相同)
+	const std::uint32_t FrameResourceCount = 3;
+
+	MaterialConstants MakeMaterialConstants(std::uint32_t seed)
+	{
+		MaterialConstants constants;
+		constants.DiffuseAlbedo = XMFLOAT4((float)(seed % 256) / 255.0f, (float)(seed / 256 % 256) / 255.0f, 0.5f, 1.0f);
+		constants.Roughness = (float)(seed % 100) / 100.0f;
+		return constants;
+	}
+
+	// scan的材质：与DX12Util.h中的Material相同，每个材质记录剩余帧数
+	struct ScannedMaterial
+	{
+		MaterialConstants Constants;
+		int NumFramesDirty = (int)FrameResourceCount;
+	};
+
+	void RunMaterialUpload(const BenchmarkOptions& options, bool registryVariant, std::uint32_t dirtyPercent, double defaultBudget, std::vector<BenchmarkResult>& results)
+	{
+		const std::string name = std::string("material_upload/") + (registryVariant ? "registry_" : "scan_") + (dirtyPercent > 0 ? "dirty_" + std::to_string(dirtyPercent) : std::string("static"));
+		if (!options.Matches(name))
+			return;
+
+		const std::size_t count = (std::size_t)options.GetParameter("materials", 100000);
+		// 初始的全部写入在计时前完成，此时不修改材质
+		std::size_t changes = 0;
+		std::vector<std::vector<MaterialConstants>> buffers(FrameResourceCount, std::vector<MaterialConstants>(count));
+		std::uint32_t state = 12345u;
+		auto nextIndex = [&]()
+		{
+			state = state * 1664525u + 1013904223u;
+			return (std::uint32_t)((state >> 8) % count);
+		};
+
+		MaterialRegistry registry(FrameResourceCount);
+		std::vector<ScannedMaterial> materials;
+		if (registryVariant)
+		{
+			registry.Reserve(count);
+			for (std::uint32_t i = 0; i < (std::uint32_t)count; ++i)
+				registry.Add("material" + std::to_string(i), MakeMaterialConstants(i));
+		}
+		else
+		{
+			materials.resize(count);
+			for (std::uint32_t i = 0; i < (std::uint32_t)count; ++i)
+				materials[i].Constants = MakeMaterialConstants(i);
+		}
+
+		std::uint64_t uploadBytes = 0;
+		std::uint64_t maxUploadBytes = 0;
+		auto frameBody = [&](std::size_t frame)
+		{
+			MaterialConstants* buffer = buffers[frame % FrameResourceCount].data();
+			uploadBytes = 0;
+			if (registryVariant)
+			{
+				for (std::size_t c = 0; c < changes; ++c)
+					registry.Set(nextIndex(), MakeMaterialConstants((std::uint32_t)frame));
+				MaterialUploadStats stats;
+				registry.Upload(buffer, sizeof(MaterialConstants), &stats);
+				uploadBytes = stats.UploadBytes;
+			}
+			else
+			{
+				for (std::size_t c = 0; c < changes; ++c)
+				{
+					ScannedMaterial& material = materials[nextIndex()];
+					material.Constants = MakeMaterialConstants((std::uint32_t)frame);
+					material.NumFramesDirty = (int)FrameResourceCount;
+				}
+				for (std::size_t i = 0; i < materials.size(); ++i)
+				{
+					ScannedMaterial& material = materials[i];
+					if (material.NumFramesDirty > 0)
+					{
+						std::memcpy(&buffer[i], &material.Constants, sizeof(MaterialConstants));
+						--material.NumFramesDirty;
+						uploadBytes += sizeof(MaterialConstants);
+					}
+				}
+			}
+			maxUploadBytes = std::max(maxUploadBytes, uploadBytes);
+			DoNotOptimize(buffer);
+		};
+
+		for (std::size_t frame = 0; frame < FrameResourceCount; ++frame)
+			frameBody(frame);
+		changes = count * dirtyPercent / 100;
+		maxUploadBytes = 0;
+
+		BenchmarkResult result = RunBenchmark(name, options.WarmupIterations > 0 ? options.WarmupIterations : 5,
+			options.Iterations > 0 ? options.Iterations : 200, frameBody);
+		result.OperationsPerIteration = count;
+		result.BudgetMilliseconds = options.GetBudget(name, registryVariant ? defaultBudget : 0.0);
+		result.Metrics.emplace_back("upload_bytes", (double)uploadBytes);
+		result.Metrics.emplace_back("max_upload_bytes", (double)maxUploadBytes);
+		results.push_back(result);
+	}
+
+	BenchmarkResult RunCpuProfilerScopes(const BenchmarkOptions& options, double defaultBudget)
+	{
+		const std::string name = "cpu_profiler/scope";
+		const std::size_t count = (std::size_t)options.GetParameter("scopes", 10000);
+		CpuProfiler& profiler = CpuProfiler::GetInstance();
+
+		// 计时中不收集：环形缓冲区写满后覆盖最早的记录，不影响写入的开销
+		BenchmarkResult result = RunBenchmark(name, options.WarmupIterations > 0 ? options.WarmupIterations : 5,
+			options.Iterations > 0 ? options.Iterations : 200, [&](std::size_t)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				CPU_PROFILE_SCOPE("BenchmarkScope");
+			}
+		});
+		profiler.EndFrame();
+		profiler.Clear();
+
+		// 连续读取时间戳的耗时，一个Scope的下限约为其两倍
+		const std::size_t timestampCount = 1000000;
+		std::uint64_t sum = 0;
+		const auto begin = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < timestampCount; ++i)
+			sum += CpuProfiler::Now();
+		const double timestampNanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / (double)timestampCount;
+		DoNotOptimize(&sum);
+
+		result.OperationsPerIteration = count;
+		result.BudgetMilliseconds = options.GetBudget(name, defaultBudget * (double)count / 10000.0);
+		result.Metrics.emplace_back("timestamp_ns", timestampNanoseconds);
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+	std::string error;
+	if (!ParseBenchmarkOptions(argc, argv, options, error))
+	{
+		std::fprintf(stderr, "%s\n", error.c_str());
+		std::fprintf(stderr, "usage: FrameBenchmark [--filter <name>] [--iterations <n>] [--warmup <n>] [--threads <n>] [--output <file.json>]\n"
+			"                      [--budget <scenario>=<ms>] [--budget-scale <factor>] [--boxes <N>] [--meshes <M>] [--objects <K>] [--nodes <H>]\n"
+			"                      [--renderables <R>] [--materials <M>] [--statics <S>] [--draws <D>] [--scopes <P>]\n");
+		return 2;
+	}
+
+	// 默认预算按单核约3GHz的机器留出约3倍余量
+	std::vector<BenchmarkResult> results;
+	if (options.Matches("static_boxes"))
+		results.push_back(RunBoxes(options, "static_boxes", 3.0, false));
+	if (options.Matches("animated_boxes"))
+		results.push_back(RunBoxes(options, "animated_boxes", 6.0, true));
+	if (options.Matches("mesh_load"))
+		results.push_back(RunMeshLoad(options, 150.0));
+	if (options.Matches("culling"))
+		results.push_back(RunCulling(options, 2.0));
+	RunDrawQueue(options, results);
+	RunStaticBatch(options, results);
+	const std::uint32_t dirtyPercents[] = { 0, 1, 10, 100 };
+	const double hierarchyBudgets[] = { 0.5, 3.0, 10.0, 30.0 };
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		if (options.Matches("transform_hierarchy/dirty_" + std::to_string(dirtyPercents[i])))
+			results.push_back(RunTransformHierarchy(options, dirtyPercents[i], hierarchyBudgets[i]));
+	}
+	const double sceneBudgets[] = { 6.0, 6.0, 9.0 };
+	for (int kind = 0; kind < 3; ++kind)
+		RunSceneStorage(options, kind, sceneBudgets[kind], results);
+	for (std::uint32_t dirtyPercent : { 0u, 1u })
+	{
+		RunMaterialUpload(options, true, dirtyPercent, dirtyPercent > 0 ? 1.0 : 0.05, results);
+		RunMaterialUpload(options, false, dirtyPercent, 0.0, results);
+	}
+	if (options.Matches("cpu_profiler/scope"))
+		results.push_back(RunCpuProfilerScopes(options, 0.5));
+
+	return ReportBenchmarks(options, "FrameBenchmark", results);
+}
@@ -0,0 +1,778 @@
+﻿// MathBenchmark.cpp : MathHelper及DirectXMath热点函数的微基准测试
+//
+// 每个操作分别测量标量、SSE、AVX2(FMA)及DirectXMath/MathHelper的实现，输出每个操作的纳秒数及吞吐量，
+// 并给出各实现与标量实现结果的最大误差，用于验证优化后的实现。
+//
+// 操作:
+//   mat_mul                 4x4矩阵乘法
+//   inverse_transpose       法线矩阵(MathHelper::InverseTranspose，平移置零后的逆转置)
+//   look_at                 XMMatrixLookAtLH
+//   perspective             XMMatrixPerspectiveFovLH
+//   spherical_to_cartesian  MathHelper::SphericalToCartesian
+//   rand_f / rand_int / rand_unit_vec3 / rand_hemisphere_unit_vec3
+//                           随机数: crt/rejection为原来基于rand()及拒绝采样的实现，mathhelper为线程独立的xoshiro128**，
+//                           batch为SIMD批量接口，batch_mt为多个线程分段调用批量接口
+//
+// look_at/perspective每次只生成一个矩阵，主要开销在平方根/三角函数，不提供AVX2版本(两个矩阵一组没有实际用途)。
+// DirectXMath的实现取决于编译选项: 默认使用SSE，/arch:AVX2(或-mavx2 -mfma)时使用AVX2/FMA，定义_XM_NO_INTRINSICS_时为标量。
+// AVX2版本在运行时检测CPU支持，不支持时跳过。
+//
+// 随机数的范围及分布检验见Tests/RandomGeneratorTests.cpp，这里只计时。
+//
+// 用法: MathBenchmark [--filter <name>] [--iterations <n>] [--warmup <n>] [--output <file.json>] [--count <N>]
+//                     [--rand_count <N>] [--threads <n>]
+//
+// Linux下构建(需要DirectXMath头文件):
+//   g++ -std=c++17 -O2 -I<DirectXMath>/Inc -ILearnDX12/Common/Include Benchmarks/MathBenchmark.cpp Benchmarks/BenchmarkHarness.cpp
+//       LearnDX12/Common/MathHelper.cpp LearnDX12/Common/RandomGenerator.cpp -pthread -o MathBenchmark
+//
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+#include "BenchmarkHarness.h"
+#include "MathHelper.h"
+#include "ParallelFor.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MATHBENCHMARK_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC中使用AVX2指令不需要额外的编译选项
+#define MATHBENCHMARK_AVX2_TARGET
+#else
+#define MATHBENCHMARK_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+using namespace DirectX;
+
+namespace
+{
+	bool HasAvx2()
+	{
+#if defined(MATHBENCHMARK_X86)
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		const bool fma = (info[2] & (1 << 12)) != 0;
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		if (!fma || !osxsave || (_xgetbv(0) & 0x6) != 0x6)
+			return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+#else
+		return false;
+#endif
+	}
+
+	// 固定种子的LCG，生成可重复的测试数据
+	class TestRandom
+	{
+	public:
+
+		float	Next(float a, float b)
+		{
+			State = State * 1664525u + 1013904223u;
+			return a + (b - a) * ((float)(State >> 8) * (1.0f / 16777216.0f));
+		}
+
+	private:
+
+		std::uint32_t State = 12345u;
+	};
+
+	// 旋转 * 缩放 * 平移的仿射矩阵
+	XMFLOAT4X4 MakeTestMatrix(TestRandom& random)
+	{
+		XMFLOAT4X4 m;
+		const float s = random.Next(0.5f, 2.0f);
+		const float a = random.Next(0.0f, XM_2PI);
+		const float c = std::cos(a);
+		const float n = std::sin(a);
+		const float values[4][4] =
+		{
+			{ c * s, random.Next(-0.2f, 0.2f), -n * s, 0.0f },
+			{ random.Next(-0.2f, 0.2f), s, random.Next(-0.2f, 0.2f), 0.0f },
+			{ n * s, random.Next(-0.2f, 0.2f), c * s, 0.0f },
+			{ random.Next(-100.0f, 100.0f), random.Next(-100.0f, 100.0f), random.Next(-100.0f, 100.0f), 1.0f },
+		};
+		for (int r = 0; r < 4; ++r)
+			for (int k = 0; k < 4; ++k)
+				m.m[r][k] = values[r][k];
+		return m;
+	}
+
+	float MaxError(const XMFLOAT4X4* a, const XMFLOAT4X4* b, std::size_t count)
+	{
+		float error = 0.0f;
+		for (std::size_t i = 0; i < count; ++i)
+			for (int r = 0; r < 4; ++r)
+				for (int c = 0; c < 4; ++c)
+					error = MathHelper::Max(error, std::fabs(a[i].m[r][c] - b[i].m[r][c]));
+		return error;
+	}
+
+	float MaxError(const XMFLOAT4* a, const XMFLOAT4* b, std::size_t count)
+	{
+		float error = 0.0f;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			error = MathHelper::Max(error, std::fabs(a[i].x - b[i].x));
+			error = MathHelper::Max(error, std::fabs(a[i].y - b[i].y));
+			error = MathHelper::Max(error, std::fabs(a[i].z - b[i].z));
+			error = MathHelper::Max(error, std::fabs(a[i].w - b[i].w));
+		}
+		return error;
+	}
+
+	//----------------------------------------------------------------------------------------
+	// 矩阵乘法 C = A * B(行向量约定)
+
+	void MultiplyScalar(const XMFLOAT4X4& a, const XMFLOAT4X4& b, XMFLOAT4X4& out)
+	{
+		for (int r = 0; r < 4; ++r)
+			for (int c = 0; c < 4; ++c)
+				out.m[r][c] = a.m[r][0] * b.m[0][c] + a.m[r][1] * b.m[1][c] + a.m[r][2] * b.m[2][c] + a.m[r][3] * b.m[3][c];
+	}
+
+#if defined(MATHBENCHMARK_X86)
+	// 结果的每一行为B各行以A对应行元素为权重的和
+	void MultiplySse(const XMFLOAT4X4& a, const XMFLOAT4X4& b, XMFLOAT4X4& out)
+	{
+		const __m128 b0 = _mm_loadu_ps(b.m[0]);
+		const __m128 b1 = _mm_loadu_ps(b.m[1]);
+		const __m128 b2 = _mm_loadu_ps(b.m[2]);
+		const __m128 b3 = _mm_loadu_ps(b.m[3]);
+		for (int r = 0; r < 4; ++r)
+		{
+			const __m128 row = _mm_loadu_ps(a.m[r]);
+			__m128 result = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+			_mm_storeu_ps(out.m[r], result);
+		}
+	}
+
+	// 一次计算两行：B的每一行复制到高低两个128位通道
+	MATHBENCHMARK_AVX2_TARGET void MultiplyAvx2(const XMFLOAT4X4& a, const XMFLOAT4X4& b, XMFLOAT4X4& out)
+	{
+		const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[0]));
+		const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[1]));
+		const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[2]));
+		const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[3]));
+		for (int r = 0; r < 4; r += 2)
+		{
+			const __m256 rows = _mm256_loadu_ps(a.m[r]);
+			__m256 result = _mm256_mul_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+			result = _mm256_fmadd_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(1, 1, 1, 1)), b1, result);
+			result = _mm256_fmadd_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(2, 2, 2, 2)), b2, result);
+			result = _mm256_fmadd_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(3, 3, 3, 3)), b3, result);
+			_mm256_storeu_ps(out.m[r], result);
+		}
+	}
+#endif
+
+	void MultiplyDirectXMath(const XMFLOAT4X4& a, const XMFLOAT4X4& b, XMFLOAT4X4& out)
+	{
+		XMStoreFloat4x4(&out, XMMatrixMultiply(XMLoadFloat4x4(&a), XMLoadFloat4x4(&b)));
+	}
+
+	//----------------------------------------------------------------------------------------
+	// 逆转置：平移置零后左上3x3的逆转置，各行为另两行的叉积除以行列式
+
+	void InverseTransposeScalar(const XMFLOAT4X4& m, XMFLOAT4X4& out)
+	{
+		const float* a = m.m[0];
+		const float* b = m.m[1];
+		const float* c = m.m[2];
+		const float bc[3] = { b[1] * c[2] - b[2] * c[1], b[2] * c[0] - b[0] * c[2], b[0] * c[1] - b[1] * c[0] };
+		const float ca[3] = { c[1] * a[2] - c[2] * a[1], c[2] * a[0] - c[0] * a[2], c[0] * a[1] - c[1] * a[0] };
+		const float ab[3] = { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+		const float invDet = 1.0f / (a[0] * bc[0] + a[1] * bc[1] + a[2] * bc[2]);
+		for (int k = 0; k < 3; ++k)
+		{
+			out.m[0][k] = bc[k] * invDet;
+			out.m[1][k] = ca[k] * invDet;
+			out.m[2][k] = ab[k] * invDet;
+			out.m[3][k] = 0.0f;
+		}
+		out.m[0][3] = 0.0f;
+		out.m[1][3] = 0.0f;
+		out.m[2][3] = 0.0f;
+		out.m[3][3] = 1.0f;
+	}
+
+#if defined(MATHBENCHMARK_X86)
+	inline __m128 CrossSse(__m128 a, __m128 b)
+	{
+		const __m128 aYzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 bYzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYzx), _mm_mul_ps(aYzx, b));
+		return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+	}
+
+	// w分量清零的行
+	inline __m128 LoadRow3Sse(const float* row)
+	{
+		const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+		return _mm_and_ps(_mm_loadu_ps(row), mask);
+	}
+
+	void InverseTransposeSse(const XMFLOAT4X4& m, XMFLOAT4X4& out)
+	{
+		const __m128 a = LoadRow3Sse(m.m[0]);
+		const __m128 b = LoadRow3Sse(m.m[1]);
+		const __m128 c = LoadRow3Sse(m.m[2]);
+		const __m128 bc = CrossSse(b, c);
+		// 行列式(所有分量相同)
+		__m128 det = _mm_mul_ps(a, bc);
+		det = _mm_add_ps(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(2, 3, 0, 1)));
+		det = _mm_add_ps(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(1, 0, 3, 2)));
+		const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+		_mm_storeu_ps(out.m[0], _mm_mul_ps(bc, invDet));
+		_mm_storeu_ps(out.m[1], _mm_mul_ps(CrossSse(c, a), invDet));
+		_mm_storeu_ps(out.m[2], _mm_mul_ps(CrossSse(a, b), invDet));
+		_mm_storeu_ps(out.m[3], _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f));
+	}
+
+	MATHBENCHMARK_AVX2_TARGET inline __m256 CrossAvx2(__m256 a, __m256 b)
+	{
+		const __m256 aYzx = _mm256_permute_ps(a, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m256 bYzx = _mm256_permute_ps(b, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m256 c = _mm256_fmsub_ps(a, bYzx, _mm256_mul_ps(aYzx, b));
+		return _mm256_permute_ps(c, _MM_SHUFFLE(3, 0, 2, 1));
+	}
+
+	// 低128位为m0的行，高128位为m1的行
+	MATHBENCHMARK_AVX2_TARGET inline __m256 LoadRowPairAvx2(const XMFLOAT4X4& m0, const XMFLOAT4X4& m1, int row)
+	{
+		const __m256 mask = _mm256_castsi256_ps(_mm256_set_epi32(0, -1, -1, -1, 0, -1, -1, -1));
+		const __m256 rows = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(m0.m[row])), _mm_loadu_ps(m1.m[row]), 1);
+		return _mm256_and_ps(rows, mask);
+	}
+
+	MATHBENCHMARK_AVX2_TARGET inline void StoreRowPairAvx2(XMFLOAT4X4& m0, XMFLOAT4X4& m1, int row, __m256 value)
+	{
+		_mm_storeu_ps(m0.m[row], _mm256_castps256_ps128(value));
+		_mm_storeu_ps(m1.m[row], _mm256_extractf128_ps(value, 1));
+	}
+
+	// 一次处理两个矩阵，每个128位通道为一个矩阵
+	MATHBENCHMARK_AVX2_TARGET void InverseTransposeAvx2(const XMFLOAT4X4& m0, const XMFLOAT4X4& m1, XMFLOAT4X4& out0, XMFLOAT4X4& out1)
+	{
+		const __m256 a = LoadRowPairAvx2(m0, m1, 0);
+		const __m256 b = LoadRowPairAvx2(m0, m1, 1);
+		const __m256 c = LoadRowPairAvx2(m0, m1, 2);
+		const __m256 bc = CrossAvx2(b, c);
+		__m256 det = _mm256_mul_ps(a, bc);
+		det = _mm256_add_ps(det, _mm256_permute_ps(det, _MM_SHUFFLE(2, 3, 0, 1)));
+		det = _mm256_add_ps(det, _mm256_permute_ps(det, _MM_SHUFFLE(1, 0, 3, 2)));
+		const __m256 invDet = _mm256_div_ps(_mm256_set1_ps(1.0f), det);
+		StoreRowPairAvx2(out0, out1, 0, _mm256_mul_ps(bc, invDet));
+		StoreRowPairAvx2(out0, out1, 1, _mm256_mul_ps(CrossAvx2(c, a), invDet));
+		StoreRowPairAvx2(out0, out1, 2, _mm256_mul_ps(CrossAvx2(a, b), invDet));
+		StoreRowPairAvx2(out0, out1, 3, _mm256_set_ps(1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f));
+	}
+#endif
+
+	void InverseTransposeMathHelper(const XMFLOAT4X4& m, XMFLOAT4X4& out)
+	{
+		XMStoreFloat4x4(&out, MathHelper::InverseTranspose(XMLoadFloat4x4(&m)));
+	}
+
+	//----------------------------------------------------------------------------------------
+	// 观察矩阵及投影矩阵
+
+	struct LookAtInput
+	{
+		XMFLOAT3 Eye;
+		XMFLOAT3 Target;
+	};
+
+	void LookAtScalar(const XMFLOAT3& eye, const XMFLOAT3& target, const XMFLOAT3& up, XMFLOAT4X4& out)
+	{
+		float z[3] = { target.x - eye.x, target.y - eye.y, target.z - eye.z };
+		const float zLength = 1.0f / std::sqrt(z[0] * z[0] + z[1] * z[1] + z[2] * z[2]);
+		z[0] *= zLength; z[1] *= zLength; z[2] *= zLength;
+		float x[3] = { up.y * z[2] - up.z * z[1], up.z * z[0] - up.x * z[2], up.x * z[1] - up.y * z[0] };
+		const float xLength = 1.0f / std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+		x[0] *= xLength; x[1] *= xLength; x[2] *= xLength;
+		const float y[3] = { z[1] * x[2] - z[2] * x[1], z[2] * x[0] - z[0] * x[2], z[0] * x[1] - z[1] * x[0] };
+		for (int k = 0; k < 3; ++k)
+		{
+			out.m[k][0] = x[k];
+			out.m[k][1] = y[k];
+			out.m[k][2] = z[k];
+			out.m[k][3] = 0.0f;
+		}
+		out.m[3][0] = -(x[0] * eye.x + x[1] * eye.y + x[2] * eye.z);
+		out.m[3][1] = -(y[0] * eye.x + y[1] * eye.y + y[2] * eye.z);
+		out.m[3][2] = -(z[0] * eye.x + z[1] * eye.y + z[2] * eye.z);
+		out.m[3][3] = 1.0f;
+	}
+
+#if defined(MATHBENCHMARK_X86)
+	// 前3个分量为点积
+	inline __m128 Dot3Sse(__m128 a, __m128 b)
+	{
+		const __m128 product = _mm_mul_ps(a, b);
+		return _mm_add_ps(_mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(3, 0, 2, 1))),
+			_mm_shuffle_ps(product, product, _MM_SHUFFLE(3, 1, 0, 2)));
+	}
+
+	inline __m128 Normalize3Sse(__m128 v)
+	{
+		// w分量也使用点积，避免0 / 0
+		const __m128 lengthSq = Dot3Sse(v, v);
+		return _mm_div_ps(v, _mm_sqrt_ps(_mm_shuffle_ps(lengthSq, lengthSq, _MM_SHUFFLE(0, 2, 1, 0))));
+	}
+
+	void LookAtSse(const XMFLOAT3& eye, const XMFLOAT3& target, const XMFLOAT3& up, XMFLOAT4X4& out)
+	{
+		const __m128 eyeV = _mm_set_ps(0.0f, eye.z, eye.y, eye.x);
+		const __m128 z = Normalize3Sse(_mm_sub_ps(_mm_set_ps(0.0f, target.z, target.y, target.x), eyeV));
+		const __m128 x = Normalize3Sse(CrossSse(_mm_set_ps(0.0f, up.z, up.y, up.x), z));
+		const __m128 y = CrossSse(z, x);
+
+		// x/y/z为前3列
+		__m128 r0 = x;
+		__m128 r1 = y;
+		__m128 r2 = z;
+		__m128 r3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		_mm_storeu_ps(out.m[0], r0);
+		_mm_storeu_ps(out.m[1], r1);
+		_mm_storeu_ps(out.m[2], r2);
+
+		// 第4行为(-dot(x, eye), -dot(y, eye), -dot(z, eye), 1)
+		const __m128 xy = _mm_unpacklo_ps(Dot3Sse(x, eyeV), Dot3Sse(y, eyeV));
+		const __m128 z1 = _mm_unpacklo_ps(Dot3Sse(z, eyeV), _mm_set1_ps(1.0f));
+		const __m128 sign = _mm_set_ps(0.0f, -0.0f, -0.0f, -0.0f);
+		_mm_storeu_ps(out.m[3], _mm_xor_ps(_mm_shuffle_ps(xy, z1, _MM_SHUFFLE(1, 0, 1, 0)), sign));
+	}
+#endif
+
+	void LookAtDirectXMath(const XMFLOAT3& eye, const XMFLOAT3& target, const XMFLOAT3& up, XMFLOAT4X4& out)
+	{
+		XMStoreFloat4x4(&out, XMMatrixLookAtLH(XMLoadFloat3(&eye), XMLoadFloat3(&target), XMLoadFloat3(&up)));
+	}
+
+	void PerspectiveScalar(float fovY, float aspect, float nearZ, float farZ, XMFLOAT4X4& out)
+	{
+		const float height = 1.0f / std::tan(0.5f * fovY);
+		const float range = farZ / (farZ - nearZ);
+		for (int r = 0; r < 4; ++r)
+			for (int c = 0; c < 4; ++c)
+				out.m[r][c] = 0.0f;
+		out.m[0][0] = height / aspect;
+		out.m[1][1] = height;
+		out.m[2][2] = range;
+		out.m[2][3] = 1.0f;
+		out.m[3][2] = -range * nearZ;
+	}
+
+	void PerspectiveDirectXMath(float fovY, float aspect, float nearZ, float farZ, XMFLOAT4X4& out)
+	{
+		XMStoreFloat4x4(&out, XMMatrixPerspectiveFovLH(fovY, aspect, nearZ, farZ));
+	}
+
+	//----------------------------------------------------------------------------------------
+	// 球坐标转换：每4/8个点一组计算sin/cos(与XMVectorSinCos相同的多项式：先规约到[-pi, pi]，再对称到[-pi/2, pi/2])
+
+	struct SphericalInput
+	{
+		std::vector<float> Radius;
+		std::vector<float> Theta;
+		std::vector<float> Phi;
+	};
+
+	const float SinCoefficients[5] = { -0.16666667f, 0.0083333310f, -0.00019840874f, 2.7525562e-06f, -2.3889859e-08f };
+	const float CosCoefficients[5] = { -0.5f, 0.041666638f, -0.0013888378f, 2.4760495e-05f, -2.6051615e-07f };
+
+	void SphericalScalar(const SphericalInput& input, std::size_t i, XMFLOAT4& out)
+	{
+		XMStoreFloat4(&out, MathHelper::SphericalToCartesian(input.Radius[i], input.Theta[i], input.Phi[i]));
+	}
+
+	// DirectXMath的批量方式：每4个角度一次XMVectorSinCos
+	void SphericalDirectXMath(const SphericalInput& input, std::size_t i, XMFLOAT4* out)
+	{
+		XMVECTOR sinTheta, cosTheta, sinPhi, cosPhi;
+		XMVectorSinCos(&sinTheta, &cosTheta, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&input.Theta[i])));
+		XMVectorSinCos(&sinPhi, &cosPhi, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&input.Phi[i])));
+		XMFLOAT4 r, st, ct, sp, cp;
+		XMStoreFloat4(&r, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&input.Radius[i])));
+		XMStoreFloat4(&st, sinTheta);
+		XMStoreFloat4(&ct, cosTheta);
+		XMStoreFloat4(&sp, sinPhi);
+		XMStoreFloat4(&cp, cosPhi);
+		const float* radius = &r.x;
+		const float* sinT = &st.x;
+		const float* cosT = &ct.x;
+		const float* sinP = &sp.x;
+		const float* cosP = &cp.x;
+		for (int k = 0; k < 4; ++k)
+			out[k] = XMFLOAT4(radius[k] * sinP[k] * cosT[k], radius[k] * cosP[k], radius[k] * sinP[k] * sinT[k], 1.0f);
+	}
+
+#if defined(MATHBENCHMARK_X86)
+	inline __m128 SelectSse(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	void SinCosSse(__m128 x, __m128& outSin, __m128& outCos)
+	{
+		// x - 2pi * round(x / 2pi)
+		const __m128 quotient = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.0f / XM_2PI))));
+		x = _mm_sub_ps(x, _mm_mul_ps(quotient, _mm_set1_ps(XM_2PI)));
+
+		// |x| > pi/2时使用sin(x) = sin(±pi - x)，cos(x) = -cos(±pi - x)
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 c = _mm_or_ps(_mm_and_ps(x, signMask), _mm_set1_ps(XM_PI));
+		const __m128 inRange = _mm_cmple_ps(_mm_andnot_ps(signMask, x), _mm_set1_ps(XM_PIDIV2));
+		x = SelectSse(inRange, x, _mm_sub_ps(c, x));
+		const __m128 sign = SelectSse(inRange, _mm_set1_ps(1.0f), _mm_set1_ps(-1.0f));
+
+		const __m128 x2 = _mm_mul_ps(x, x);
+		__m128 s = _mm_set1_ps(SinCoefficients[4]);
+		__m128 k = _mm_set1_ps(CosCoefficients[4]);
+		for (int i = 3; i >= 0; --i)
+		{
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(SinCoefficients[i]));
+			k = _mm_add_ps(_mm_mul_ps(k, x2), _mm_set1_ps(CosCoefficients[i]));
+		}
+		const __m128 one = _mm_set1_ps(1.0f);
+		outSin = _mm_mul_ps(x, _mm_add_ps(_mm_mul_ps(s, x2), one));
+		outCos = _mm_mul_ps(sign, _mm_add_ps(_mm_mul_ps(k, x2), one));
+	}
+
+	// 每次4个点，SoA计算后转置为XMFLOAT4
+	void SphericalSse(const SphericalInput& input, std::size_t i, XMFLOAT4* out)
+	{
+		__m128 sinTheta, cosTheta, sinPhi, cosPhi;
+		SinCosSse(_mm_loadu_ps(&input.Theta[i]), sinTheta, cosTheta);
+		SinCosSse(_mm_loadu_ps(&input.Phi[i]), sinPhi, cosPhi);
+		const __m128 radius = _mm_loadu_ps(&input.Radius[i]);
+		const __m128 radiusSinPhi = _mm_mul_ps(radius, sinPhi);
+		__m128 x = _mm_mul_ps(radiusSinPhi, cosTheta);
+		__m128 y = _mm_mul_ps(radius, cosPhi);
+		__m128 z = _mm_mul_ps(radiusSinPhi, sinTheta);
+		__m128 w = _mm_set1_ps(1.0f);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(&out[0].x, x);
+		_mm_storeu_ps(&out[1].x, y);
+		_mm_storeu_ps(&out[2].x, z);
+		_mm_storeu_ps(&out[3].x, w);
+	}
+
+	MATHBENCHMARK_AVX2_TARGET void SinCosAvx2(__m256 x, __m256& outSin, __m256& outCos)
+	{
+		const __m256 quotient = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.0f / XM_2PI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		x = _mm256_fnmadd_ps(quotient, _mm256_set1_ps(XM_2PI), x);
+
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+		const __m256 c = _mm256_or_ps(_mm256_and_ps(x, signMask), _mm256_set1_ps(XM_PI));
+		const __m256 inRange = _mm256_cmp_ps(_mm256_andnot_ps(signMask, x), _mm256_set1_ps(XM_PIDIV2), _CMP_LE_OQ);
+		x = _mm256_blendv_ps(_mm256_sub_ps(c, x), x, inRange);
+		const __m256 sign = _mm256_blendv_ps(_mm256_set1_ps(-1.0f), _mm256_set1_ps(1.0f), inRange);
+
+		const __m256 x2 = _mm256_mul_ps(x, x);
+		__m256 s = _mm256_set1_ps(SinCoefficients[4]);
+		__m256 k = _mm256_set1_ps(CosCoefficients[4]);
+		for (int i = 3; i >= 0; --i)
+		{
+			s = _mm256_fmadd_ps(s, x2, _mm256_set1_ps(SinCoefficients[i]));
+			k = _mm256_fmadd_ps(k, x2, _mm256_set1_ps(CosCoefficients[i]));
+		}
+		const __m256 one = _mm256_set1_ps(1.0f);
+		outSin = _mm256_mul_ps(x, _mm256_fmadd_ps(s, x2, one));
+		outCos = _mm256_mul_ps(sign, _mm256_fmadd_ps(k, x2, one));
+	}
+
+	// 每次8个点，高低128位分别转置
+	MATHBENCHMARK_AVX2_TARGET void SphericalAvx2(const SphericalInput& input, std::size_t i, XMFLOAT4* out)
+	{
+		__m256 sinTheta, cosTheta, sinPhi, cosPhi;
+		SinCosAvx2(_mm256_loadu_ps(&input.Theta[i]), sinTheta, cosTheta);
+		SinCosAvx2(_mm256_loadu_ps(&input.Phi[i]), sinPhi, cosPhi);
+		const __m256 radius = _mm256_loadu_ps(&input.Radius[i]);
+		const __m256 radiusSinPhi = _mm256_mul_ps(radius, sinPhi);
+		const __m256 x = _mm256_mul_ps(radiusSinPhi, cosTheta);
+		const __m256 y = _mm256_mul_ps(radius, cosPhi);
+		const __m256 z = _mm256_mul_ps(radiusSinPhi, sinTheta);
+		for (int half = 0; half < 2; ++half)
+		{
+			__m128 x4 = half == 0 ? _mm256_castps256_ps128(x) : _mm256_extractf128_ps(x, 1);
+			__m128 y4 = half == 0 ? _mm256_castps256_ps128(y) : _mm256_extractf128_ps(y, 1);
+			__m128 z4 = half == 0 ? _mm256_castps256_ps128(z) : _mm256_extractf128_ps(z, 1);
+			__m128 w4 = _mm_set1_ps(1.0f);
+			_MM_TRANSPOSE4_PS(x4, y4, z4, w4);
+			XMFLOAT4* dest = out + 4 * half;
+			_mm_storeu_ps(&dest[0].x, x4);
+			_mm_storeu_ps(&dest[1].x, y4);
+			_mm_storeu_ps(&dest[2].x, z4);
+			_mm_storeu_ps(&dest[3].x, w4);
+		}
+	}
+#endif
+
+	//----------------------------------------------------------------------------------------
+	// 随机数：原来的实现作为基线，以及分布检验
+
+	float CrtRandF(float a, float b)
+	{
+		return a + ((float)std::rand() / (float)RAND_MAX) * (b - a);
+	}
+
+	// 原来的RandUnitVec3/RandHemisphereUnitVec3：在立方体内取点，丢弃球外(及下半球)的点
+	XMVECTOR RejectionUnitVec3(FXMVECTOR n, bool hemisphere)
+	{
+		while (true)
+		{
+			XMVECTOR v = XMVectorSet(CrtRandF(-1.0f, 1.0f), CrtRandF(-1.0f, 1.0f), CrtRandF(-1.0f, 1.0f), 0.0f);
+			if (XMVector3Greater(XMVector3LengthSq(v), XMVectorSplatOne()))
+				continue;
+			if (hemisphere && XMVector3Less(XMVector3Dot(n, v), XMVectorZero()))
+				continue;
+			return XMVector3Normalize(v);
+		}
+	}
+
+	//----------------------------------------------------------------------------------------
+
+	struct MathBenchmarkRunner
+	{
+		const BenchmarkOptions& Options;
+		std::vector<BenchmarkResult>& Results;
+
+		// 每个场景的默认执行次数
+		std::size_t	GetIterations() const { return Options.Iterations > 0 ? Options.Iterations : 1000; }
+		std::size_t	GetWarmup() const { return Options.WarmupIterations > 0 ? Options.WarmupIterations : 10; }
+
+		// 运行一个实现，maxError小于0时不输出误差
+		template<typename Func>
+		void	Run(const std::string& name, std::uint64_t operations, float maxError, Func&& func)
+		{
+			if (!Options.Matches(name))
+				return;
+			BenchmarkResult result = RunBenchmark(name, GetWarmup(), GetIterations(), [&](std::size_t) { func(); });
+			result.OperationsPerIteration = operations;
+			result.BudgetMilliseconds = Options.GetBudget(name, 0.0);
+			if (maxError >= 0.0f)
+				result.Metrics.emplace_back("max_error", maxError);
+			Results.push_back(result);
+		}
+
+	};
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+	std::string error;
+	if (!ParseBenchmarkOptions(argc, argv, options, error))
+	{
+		std::fprintf(stderr, "%s\n", error.c_str());
+		std::fprintf(stderr, "usage: MathBenchmark [--filter <name>] [--iterations <n>] [--warmup <n>] [--output <file.json>] [--count <N>]\n");
+		return 2;
+	}
+
+	const bool avx2 = HasAvx2();
+	if (!avx2)
+		std::fprintf(stderr, "AVX2/FMA not available, skipping avx2 variants\n");
+
+	// 数量为8的倍数，便于SIMD实现成组处理
+	const std::size_t count = ((std::size_t)options.GetParameter("count", 1024) + 7) & ~(std::size_t)7;
+	TestRandom random;
+	std::vector<XMFLOAT4X4> a(count), b(count), reference(count), result(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		a[i] = MakeTestMatrix(random);
+		b[i] = MakeTestMatrix(random);
+	}
+
+	std::vector<BenchmarkResult> results;
+	MathBenchmarkRunner runner{ options, results };
+
+	// 每个实现先计算一次结果与标量实现比较，再计时
+	auto matrixError = [&](auto&& func)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+			func(i);
+		return MaxError(reference.data(), result.data(), count);
+	};
+
+	// 矩阵乘法
+	for (std::size_t i = 0; i < count; ++i)
+		MultiplyScalar(a[i], b[i], reference[i]);
+	runner.Run("mat_mul/scalar", count, -1.0f, [&]() { for (std::size_t i = 0; i < count; ++i) MultiplyScalar(a[i], b[i], result[i]); DoNotOptimize(result.data()); });
+#if defined(MATHBENCHMARK_X86)
+	{
+		auto sse = [&](std::size_t i) { MultiplySse(a[i], b[i], result[i]); };
+		runner.Run("mat_mul/sse", count, matrixError(sse), [&]() { for (std::size_t i = 0; i < count; ++i) sse(i); DoNotOptimize(result.data()); });
+		if (avx2)
+		{
+			auto avx = [&](std::size_t i) { MultiplyAvx2(a[i], b[i], result[i]); };
+			runner.Run("mat_mul/avx2", count, matrixError(avx), [&]() { for (std::size_t i = 0; i < count; ++i) avx(i); DoNotOptimize(result.data()); });
+		}
+	}
+#endif
+	{
+		auto dxm = [&](std::size_t i) { MultiplyDirectXMath(a[i], b[i], result[i]); };
+		runner.Run("mat_mul/directxmath", count, matrixError(dxm), [&]() { for (std::size_t i = 0; i < count; ++i) dxm(i); DoNotOptimize(result.data()); });
+	}
+
+	// 逆转置
+	for (std::size_t i = 0; i < count; ++i)
+		InverseTransposeScalar(a[i], reference[i]);
+	runner.Run("inverse_transpose/scalar", count, -1.0f, [&]() { for (std::size_t i = 0; i < count; ++i) InverseTransposeScalar(a[i], result[i]); DoNotOptimize(result.data()); });
+#if defined(MATHBENCHMARK_X86)
+	{
+		auto sse = [&](std::size_t i) { InverseTransposeSse(a[i], result[i]); };
+		runner.Run("inverse_transpose/sse", count, matrixError(sse), [&]() { for (std::size_t i = 0; i < count; ++i) sse(i); DoNotOptimize(result.data()); });
+		if (avx2)
+		{
+			auto avx = [&](std::size_t i) { if ((i & 1) == 0) InverseTransposeAvx2(a[i], a[i + 1], result[i], result[i + 1]); };
+			runner.Run("inverse_transpose/avx2", count, matrixError(avx), [&]() { for (std::size_t i = 0; i < count; i += 2) avx(i); DoNotOptimize(result.data()); });
+		}
+	}
+#endif
+	{
+		auto helper = [&](std::size_t i) { InverseTransposeMathHelper(a[i], result[i]); };
+		runner.Run("inverse_transpose/mathhelper", count, matrixError(helper), [&]() { for (std::size_t i = 0; i < count; ++i) helper(i); DoNotOptimize(result.data()); });
+	}
+
+	// 观察矩阵
+	std::vector<LookAtInput> cameras(count);
+	for (LookAtInput& camera : cameras)
+	{
+		camera.Eye = XMFLOAT3(random.Next(-50.0f, 50.0f), random.Next(1.0f, 50.0f), random.Next(-50.0f, 50.0f));
+		camera.Target = XMFLOAT3(random.Next(-5.0f, 5.0f), random.Next(-5.0f, 5.0f), random.Next(-5.0f, 5.0f));
+	}
+	const XMFLOAT3 up(0.0f, 1.0f, 0.0f);
+	for (std::size_t i = 0; i < count; ++i)
+		LookAtScalar(cameras[i].Eye, cameras[i].Target, up, reference[i]);
+	runner.Run("look_at/scalar", count, -1.0f, [&]() { for (std::size_t i = 0; i < count; ++i) LookAtScalar(cameras[i].Eye, cameras[i].Target, up, result[i]); DoNotOptimize(result.data()); });
+#if defined(MATHBENCHMARK_X86)
+	{
+		auto sse = [&](std::size_t i) { LookAtSse(cameras[i].Eye, cameras[i].Target, up, result[i]); };
+		runner.Run("look_at/sse", count, matrixError(sse), [&]() { for (std::size_t i = 0; i < count; ++i) sse(i); DoNotOptimize(result.data()); });
+	}
+#endif
+	{
+		auto dxm = [&](std::size_t i) { LookAtDirectXMath(cameras[i].Eye, cameras[i].Target, up, result[i]); };
+		runner.Run("look_at/directxmath", count, matrixError(dxm), [&]() { for (std::size_t i = 0; i < count; ++i) dxm(i); DoNotOptimize(result.data()); });
+	}
+
+	// 投影矩阵(每个矩阵使用不同的视角，避免编译器将计算提到循环外)
+	std::vector<float> fovs(count);
+	for (float& fov : fovs)
+		fov = random.Next(0.2f * XM_PI, 0.45f * XM_PI);
+	for (std::size_t i = 0; i < count; ++i)
+		PerspectiveScalar(fovs[i], 1280.0f / 768.0f, 1.0f, 1000.0f, reference[i]);
+	runner.Run("perspective/scalar", count, -1.0f, [&]() { for (std::size_t i = 0; i < count; ++i) PerspectiveScalar(fovs[i], 1280.0f / 768.0f, 1.0f, 1000.0f, result[i]); DoNotOptimize(result.data()); });
+	{
+		auto dxm = [&](std::size_t i) { PerspectiveDirectXMath(fovs[i], 1280.0f / 768.0f, 1.0f, 1000.0f, result[i]); };
+		runner.Run("perspective/directxmath", count, matrixError(dxm), [&]() { for (std::size_t i = 0; i < count; ++i) dxm(i); DoNotOptimize(result.data()); });
+	}
+
+	// 球坐标转换(角度范围与相机环绕一致，theta包括多圈)
+	SphericalInput spherical;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		spherical.Radius.push_back(random.Next(1.0f, 20.0f));
+		spherical.Theta.push_back(random.Next(-4.0f * XM_PI, 4.0f * XM_PI));
+		spherical.Phi.push_back(random.Next(0.1f, XM_PI - 0.1f));
+	}
+	std::vector<XMFLOAT4> points(count), pointReference(count);
+	for (std::size_t i = 0; i < count; ++i)
+		SphericalScalar(spherical, i, pointReference[i]);
+	auto pointError = [&](auto&& func, std::size_t step)
+	{
+		for (std::size_t i = 0; i < count; i += step)
+			func(i);
+		return MaxError(pointReference.data(), points.data(), count);
+	};
+	runner.Run("spherical_to_cartesian/scalar", count, -1.0f, [&]() { for (std::size_t i = 0; i < count; ++i) SphericalScalar(spherical, i, points[i]); DoNotOptimize(points.data()); });
+#if defined(MATHBENCHMARK_X86)
+	{
+		auto sse = [&](std::size_t i) { SphericalSse(spherical, i, &points[i]); };
+		runner.Run("spherical_to_cartesian/sse", count, pointError(sse, 4), [&]() { for (std::size_t i = 0; i < count; i += 4) sse(i); DoNotOptimize(points.data()); });
+		if (avx2)
+		{
+			auto avx = [&](std::size_t i) { SphericalAvx2(spherical, i, &points[i]); };
+			runner.Run("spherical_to_cartesian/avx2", count, pointError(avx, 8), [&]() { for (std::size_t i = 0; i < count; i += 8) avx(i); DoNotOptimize(points.data()); });
+		}
+	}
+#endif
+	{
+		auto dxm = [&](std::size_t i) { SphericalDirectXMath(spherical, i, &points[i]); };
+		runner.Run("spherical_to_cartesian/directxmath", count, pointError(dxm, 4), [&]() { for (std::size_t i = 0; i < count; i += 4) dxm(i); DoNotOptimize(points.data()); });
+	}
+
+	// 随机数
+	const std::size_t randCount = (std::size_t)options.GetParameter("rand_count", 16384);
+	std::srand(1);
+	SeedThreadRandom(1);
+
+	std::vector<float> randoms(randCount);
+	runner.Run("rand_f/crt", randCount, -1.0f, [&]() { for (std::size_t i = 0; i < randCount; ++i) randoms[i] = CrtRandF(0.0f, 1.0f); DoNotOptimize(randoms.data()); });
+	runner.Run("rand_f/mathhelper", randCount, -1.0f, [&]() { for (std::size_t i = 0; i < randCount; ++i) randoms[i] = MathHelper::RandF(); DoNotOptimize(randoms.data()); });
+	runner.Run("rand_f/batch", randCount, -1.0f, [&]() { MathHelper::RandF(randoms.data(), randCount); DoNotOptimize(randoms.data()); });
+
+	// 整数范围不是2的幂，取模及乘法映射都不能简化为移位
+	std::vector<int> ints(randCount);
+	runner.Run("rand_int/crt", randCount, -1.0f, [&]() { for (std::size_t i = 0; i < randCount; ++i) ints[i] = -3 + std::rand() % 10; DoNotOptimize(ints.data()); });
+	runner.Run("rand_int/mathhelper", randCount, -1.0f, [&]() { for (std::size_t i = 0; i < randCount; ++i) ints[i] = MathHelper::Rand(-3, 6); DoNotOptimize(ints.data()); });
+	runner.Run("rand_int/batch", randCount, -1.0f, [&]() { MathHelper::Rand(ints.data(), randCount, -3, 6); DoNotOptimize(ints.data()); });
+
+	// 方向。半球的法线不是坐标轴且未单位化
+	std::vector<XMFLOAT3> directions(randCount);
+	const XMVECTOR normal = XMVectorSet(1.2f, 0.0f, 1.6f, 0.0f);
+	const unsigned threadCount = options.ThreadCount;
+	for (int hemisphere = 0; hemisphere < 2; ++hemisphere)
+	{
+		const std::string name = hemisphere ? "rand_hemisphere_unit_vec3" : "rand_unit_vec3";
+		auto single = [&]() { return hemisphere ? MathHelper::RandHemisphereUnitVec3(normal) : MathHelper::RandUnitVec3(); };
+		auto batch = [&](XMFLOAT3* out, std::size_t count)
+		{
+			if (hemisphere)
+				MathHelper::RandHemisphereUnitVec3(normal, out, count);
+			else
+				MathHelper::RandUnitVec3(out, count);
+		};
+
+		runner.Run(name + "/rejection", randCount, -1.0f, [&]()
+			{
+				for (std::size_t i = 0; i < randCount; ++i)
+					XMStoreFloat3(&directions[i], RejectionUnitVec3(normal, hemisphere != 0));
+				DoNotOptimize(directions.data());
+			});
+		runner.Run(name + "/mathhelper", randCount, -1.0f, [&]()
+			{
+				for (std::size_t i = 0; i < randCount; ++i)
+					XMStoreFloat3(&directions[i], single());
+				DoNotOptimize(directions.data());
+			});
+		runner.Run(name + "/batch", randCount, -1.0f, [&]() { batch(directions.data(), randCount); DoNotOptimize(directions.data()); });
+		// 每个线程使用自己的生成器，不需要同步
+		runner.Run(name + "/batch_mt", randCount, -1.0f, [&]()
+			{
+				ParallelFor(randCount, 1024, [&](std::size_t begin, std::size_t end) { batch(&directions[begin], end - begin); }, threadCount);
+				DoNotOptimize(directions.data());
+			});
+	}
+
+	return ReportBenchmarks(options, "MathBenchmark", results);
+}
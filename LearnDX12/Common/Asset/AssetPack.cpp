@@ -0,0 +1,655 @@
+﻿#include "Asset/AssetPack.h"
+#include "Mesh/MeshCodec.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace
+{
+	// 将value向上对齐到alignment(2的幂)的整数倍
+	inline std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	inline std::uint32_t Load32(const std::uint8_t* p)
+	{
+		std::uint32_t v;
+		std::memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	// Hash高位作为桶下标，bucketBits为0时只有一个桶
+	inline std::uint32_t BucketIndex(std::uint64_t hash, std::uint32_t bucketBits)
+	{
+		return bucketBits == 0 ? 0 : (std::uint32_t)(hash >> (64 - bucketBits));
+	}
+
+	inline std::uint32_t Log2(std::uint32_t powerOfTwo)
+	{
+		std::uint32_t bits = 0;
+		while ((1u << bits) < powerOfTwo)
+			++bits;
+		return bits;
+	}
+
+	// 写入LZ变长长度(超过15的部分以255为单位追加)
+	void WriteLength(std::vector<std::uint8_t>& out, std::size_t length)
+	{
+		while (length >= 255)
+		{
+			out.push_back(255);
+			length -= 255;
+		}
+		out.push_back((std::uint8_t)length);
+	}
+
+	bool ReadLength(const std::uint8_t*& src, const std::uint8_t* srcEnd, std::size_t& length)
+	{
+		std::uint8_t b = 0;
+		do
+		{
+			if (src >= srcEnd)
+				return false;
+			b = *src++;
+			length += b;
+		} while (b == 255);
+		return true;
+	}
+
+	// 写入一个序列: token | 字面量长度扩展 | 字面量 | [偏移 | 匹配长度扩展]
+	void EmitSequence(std::vector<std::uint8_t>& out, const std::uint8_t* literals, std::size_t literalLength,
+		std::size_t matchOffset, std::size_t matchLength)
+	{
+		const std::size_t matchCode = matchLength ? matchLength - 4 : 0;
+		std::uint8_t token = (std::uint8_t)((std::min<std::size_t>(literalLength, 15) << 4) | std::min<std::size_t>(matchCode, 15));
+		out.push_back(token);
+		if (literalLength >= 15)
+			WriteLength(out, literalLength - 15);
+		out.insert(out.end(), literals, literals + literalLength);
+
+		// 最后一个序列只有字面量
+		if (matchLength == 0)
+			return;
+
+		out.push_back((std::uint8_t)(matchOffset & 0xFF));
+		out.push_back((std::uint8_t)(matchOffset >> 8));
+		if (matchCode >= 15)
+			WriteLength(out, matchCode - 15);
+	}
+}
+
+
+std::uint64_t AssetHash(const void* data, std::size_t byteSize, std::uint64_t seed)
+{
+	const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+	std::uint64_t hash = seed;
+	for (std::size_t i = 0; i < byteSize; ++i)
+	{
+		hash ^= p[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+std::uint64_t AssetNameHash(const std::string& name)
+{
+	return AssetHash(name.data(), name.size());
+}
+
+std::vector<std::uint8_t> AssetCompressLZ(const void* data, std::size_t byteSize)
+{
+	const std::uint8_t* in = static_cast<const std::uint8_t*>(data);
+	const std::size_t HashBits = 14;
+	const std::size_t NoPos = (std::size_t)-1;
+
+	std::vector<std::uint8_t> out;
+	out.reserve(byteSize + byteSize / 255 + 16);
+
+	// 以4字节序列的Hash记录最近一次出现的位置
+	std::vector<std::size_t> table((std::size_t)1 << HashBits, NoPos);
+
+	std::size_t anchor = 0;
+	std::size_t i = 0;
+	while (i + 4 <= byteSize)
+	{
+		const std::uint32_t seq = Load32(in + i);
+		const std::size_t h = (std::size_t)((seq * 2654435761u) >> (32 - HashBits));
+		const std::size_t candidate = table[h];
+		table[h] = i;
+
+		if (candidate != NoPos && i - candidate <= 0xFFFF && Load32(in + candidate) == seq)
+		{
+			std::size_t length = 4;
+			while (i + length < byteSize && in[candidate + length] == in[i + length])
+				++length;
+
+			EmitSequence(out, in + anchor, i - anchor, i - candidate, length);
+			i += length;
+			anchor = i;
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	EmitSequence(out, in + anchor, byteSize - anchor, 0, 0);
+	return out;
+}
+
+bool AssetDecompressLZ(const void* src, std::size_t srcSize, void* dst, std::size_t dstSize)
+{
+	const std::uint8_t* s = static_cast<const std::uint8_t*>(src);
+	const std::uint8_t* sEnd = s + srcSize;
+	std::uint8_t* d = static_cast<std::uint8_t*>(dst);
+	std::uint8_t* dBegin = d;
+	std::uint8_t* dEnd = d + dstSize;
+
+	while (s < sEnd)
+	{
+		const std::uint8_t token = *s++;
+
+		std::size_t literalLength = token >> 4;
+		if (literalLength == 15 && !ReadLength(s, sEnd, literalLength))
+			return false;
+		if ((std::size_t)(sEnd - s) < literalLength || (std::size_t)(dEnd - d) < literalLength)
+			return false;
+		std::memcpy(d, s, literalLength);
+		s += literalLength;
+		d += literalLength;
+
+		// 最后一个序列
+		if (s == sEnd)
+			break;
+
+		if (sEnd - s < 2)
+			return false;
+		const std::size_t offset = (std::size_t)s[0] | ((std::size_t)s[1] << 8);
+		s += 2;
+		if (offset == 0 || offset > (std::size_t)(d - dBegin))
+			return false;
+
+		std::size_t matchLength = token & 0x0F;
+		if (matchLength == 15 && !ReadLength(s, sEnd, matchLength))
+			return false;
+		matchLength += 4;
+		if ((std::size_t)(dEnd - d) < matchLength)
+			return false;
+
+		// 匹配区域可能与输出重叠，逐字节拷贝
+		const std::uint8_t* m = d - offset;
+		for (std::size_t k = 0; k < matchLength; ++k)
+			d[k] = m[k];
+		d += matchLength;
+	}
+
+	return d == dEnd;
+}
+
+
+AssetPackBuilder::AssetPackBuilder(std::uint32_t payloadAlignment)
+	: PayloadAlignment(payloadAlignment)
+{
+	// 对齐必须为2的幂且不小于16
+	if (PayloadAlignment < 16 || (PayloadAlignment & (PayloadAlignment - 1)) != 0)
+		PayloadAlignment = ASSETPACK_DEFAULT_ALIGNMENT;
+}
+
+bool AssetPackBuilder::AddEntry(const std::string& name, AssetType type, const void* data, std::size_t byteSize, AssetCompression compression)
+{
+	if (data == nullptr && byteSize > 0)
+		return false;
+
+	const std::uint64_t nameHash = AssetNameHash(name);
+	for (const PendingEntry& e : Entries)
+	{
+		// 同名或Hash冲突的条目无法区分
+		if (e.Entry.NameHash == nameHash)
+			return false;
+	}
+
+	PendingEntry pending;
+	pending.Entry.NameHash = nameHash;
+	pending.Entry.Type = type;
+	pending.Entry.RawSize = byteSize;
+	pending.Entry.Compression = AssetCompression::None;
+
+	if (compression == AssetCompression::LZ && byteSize > 0)
+	{
+		std::vector<std::uint8_t> compressed = AssetCompressLZ(data, byteSize);
+		if (compressed.size() < byteSize)
+		{
+			pending.Payload = std::move(compressed);
+			pending.Entry.Compression = AssetCompression::LZ;
+		}
+	}
+
+	if (pending.Entry.Compression == AssetCompression::None)
+	{
+		const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+		pending.Payload.assign(bytes, bytes + byteSize);
+	}
+
+	pending.Entry.StoredSize = pending.Payload.size();
+	Entries.push_back(std::move(pending));
+	return true;
+}
+
+bool AssetPackBuilder::AddMesh(const std::string& name,
+	const void* vertexData, std::uint32_t vertexByteStride, std::uint32_t vertexCount, std::uint32_t vertexFormat,
+	const void* indexData, std::uint32_t indexByteSize, std::uint32_t indexCount,
+	const std::vector<MeshAssetSubset>& subsets, const std::vector<MeshAssetMeshlet>& meshlets,
+	MeshDataEncoding encoding, AssetCompression compression)
+{
+	std::vector<std::uint8_t> payload;
+	if (!BuildMeshPayload(payload, vertexData, vertexByteStride, vertexCount, vertexFormat, indexData, indexByteSize, indexCount,
+		subsets, meshlets, encoding, PayloadAlignment))
+		return false;
+
+	return AddEntry(name, AssetType::Mesh, payload.data(), payload.size(), compression);
+}
+
+bool AssetPackBuilder::BuildMeshPayload(std::vector<std::uint8_t>& outPayload,
+	const void* vertexData, std::uint32_t vertexByteStride, std::uint32_t vertexCount, std::uint32_t vertexFormat,
+	const void* indexData, std::uint32_t indexByteSize, std::uint32_t indexCount,
+	const std::vector<MeshAssetSubset>& subsets, const std::vector<MeshAssetMeshlet>& meshlets,
+	MeshDataEncoding encoding, std::uint32_t payloadAlignment)
+{
+	if (indexByteSize != 2 && indexByteSize != 4)
+		return false;
+
+	// 编码后的顶点/索引数据，各自编码后没有变小(eg: 很小的Mesh)或索引无法编码(不是三角形列表)时该部分保持原样
+	const std::uint64_t vbRawByteSize = (std::uint64_t)vertexByteStride * vertexCount;
+	const std::uint64_t ibRawByteSize = (std::uint64_t)indexByteSize * indexCount;
+	std::vector<std::uint8_t> encodedVertices;
+	std::vector<std::uint8_t> encodedIndices;
+	bool verticesEncoded = false;
+	bool indicesEncoded = false;
+	if (encoding == MeshDataEncoding::Codec)
+	{
+		EncodeVertexBuffer(vertexData, vertexCount, vertexByteStride, encodedVertices);
+		verticesEncoded = encodedVertices.size() < vbRawByteSize;
+		indicesEncoded = EncodeIndexBuffer(indexData, indexCount, indexByteSize, encodedIndices) && encodedIndices.size() < ibRawByteSize;
+	}
+
+	MeshAssetHeader header;
+	header.VertexByteStride = vertexByteStride;
+	header.VertexCount = vertexCount;
+	header.VertexFormat = vertexFormat;
+	header.IndexByteSize = indexByteSize;
+	header.IndexCount = indexCount;
+	header.SubsetCount = (std::uint32_t)subsets.size();
+	header.MeshletCount = (std::uint32_t)meshlets.size();
+	header.VertexEncoding = verticesEncoded ? MeshDataEncoding::Codec : MeshDataEncoding::None;
+	header.IndexEncoding = indicesEncoded ? MeshDataEncoding::Codec : MeshDataEncoding::None;
+
+	const std::uint64_t vbByteSize = verticesEncoded ? encodedVertices.size() : vbRawByteSize;
+	const std::uint64_t ibByteSize = indicesEncoded ? encodedIndices.size() : ibRawByteSize;
+	header.VertexDataStoredSize = vbByteSize;
+	header.IndexDataStoredSize = ibByteSize;
+	const std::uint64_t subsetBytes = sizeof(MeshAssetSubset) * subsets.size();
+	const std::uint64_t meshletBytes = sizeof(MeshAssetMeshlet) * meshlets.size();
+
+	header.VertexDataOffset = AlignUp(sizeof(MeshAssetHeader) + subsetBytes + meshletBytes, payloadAlignment);
+	header.IndexDataOffset = AlignUp(header.VertexDataOffset + vbByteSize, payloadAlignment);
+
+	outPayload.assign((std::size_t)(header.IndexDataOffset + ibByteSize), 0);
+	std::memcpy(outPayload.data(), &header, sizeof(header));
+	if (!subsets.empty())
+		std::memcpy(outPayload.data() + sizeof(header), subsets.data(), (std::size_t)subsetBytes);
+	if (!meshlets.empty())
+		std::memcpy(outPayload.data() + sizeof(header) + subsetBytes, meshlets.data(), (std::size_t)meshletBytes);
+	if (vbByteSize > 0)
+		std::memcpy(outPayload.data() + header.VertexDataOffset, verticesEncoded ? encodedVertices.data() : vertexData, (std::size_t)vbByteSize);
+	if (ibByteSize > 0)
+		std::memcpy(outPayload.data() + header.IndexDataOffset, indicesEncoded ? encodedIndices.data() : indexData, (std::size_t)ibByteSize);
+
+	return true;
+}
+
+void AssetPackBuilder::WriteToMemory(std::vector<std::uint8_t>& outData) const
+{
+	// 条目按Hash升序排列
+	std::vector<const PendingEntry*> sorted;
+	sorted.reserve(Entries.size());
+	for (const PendingEntry& e : Entries)
+		sorted.push_back(&e);
+	std::sort(sorted.begin(), sorted.end(), [](const PendingEntry* a, const PendingEntry* b)
+	{
+		return a->Entry.NameHash < b->Entry.NameHash;
+	});
+
+	// 桶数量取不小于条目数的2的幂，保证每个桶平均不超过1个条目
+	std::uint32_t bucketCount = 1;
+	while (bucketCount < sorted.size())
+		bucketCount <<= 1;
+	const std::uint32_t bucketBits = Log2(bucketCount);
+
+	std::vector<std::uint32_t> buckets(bucketCount + 1, 0);
+	for (const PendingEntry* e : sorted)
+		++buckets[BucketIndex(e->Entry.NameHash, bucketBits) + 1];
+	for (std::uint32_t b = 0; b < bucketCount; ++b)
+		buckets[b + 1] += buckets[b];
+
+	AssetPackHeader header;
+	header.EntryCount = (std::uint32_t)sorted.size();
+	header.BucketCount = bucketCount;
+	header.PayloadAlignment = PayloadAlignment;
+	header.EntryTableOffset = AlignUp(sizeof(AssetPackHeader) + sizeof(std::uint32_t) * buckets.size(), 8);
+
+	// 计算每个负载的偏移
+	std::vector<AssetPackEntry> table;
+	table.reserve(sorted.size());
+	std::uint64_t offset = header.EntryTableOffset + sizeof(AssetPackEntry) * sorted.size();
+	for (const PendingEntry* e : sorted)
+	{
+		offset = AlignUp(offset, PayloadAlignment);
+		AssetPackEntry entry = e->Entry;
+		entry.Offset = offset;
+		table.push_back(entry);
+		offset += entry.StoredSize;
+	}
+	header.FileSize = offset;
+
+	outData.assign((std::size_t)header.FileSize, 0);
+	std::uint8_t* dst = outData.data();
+	std::memcpy(dst, &header, sizeof(header));
+	std::memcpy(dst + sizeof(header), buckets.data(), sizeof(std::uint32_t) * buckets.size());
+	if (!table.empty())
+		std::memcpy(dst + header.EntryTableOffset, table.data(), sizeof(AssetPackEntry) * table.size());
+	for (std::size_t i = 0; i < sorted.size(); ++i)
+	{
+		if (!sorted[i]->Payload.empty())
+			std::memcpy(dst + table[i].Offset, sorted[i]->Payload.data(), sorted[i]->Payload.size());
+	}
+}
+
+bool AssetPackBuilder::WriteToFile(const std::string& filename) const
+{
+	std::vector<std::uint8_t> data;
+	WriteToMemory(data);
+
+	std::ofstream fout(filename, std::ios::binary | std::ios::trunc);
+	if (!fout)
+		return false;
+
+	fout.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)data.size());
+	return fout.good();
+}
+
+
+AssetPackReader::~AssetPackReader()
+{
+	Close();
+}
+
+bool AssetPackReader::Open(const std::string& filename)
+{
+	Close();
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	FileHandle = file;
+	MappingHandle = mapping;
+	MappedData = static_cast<const std::uint8_t*>(view);
+	MappedSize = (std::size_t)fileSize.QuadPart;
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	void* view = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED)
+		return false;
+
+	MappedData = static_cast<const std::uint8_t*>(view);
+	MappedSize = (std::size_t)st.st_size;
+#endif
+
+	OwnsMapping = true;
+	if (!ValidateAndBind(MappedData, MappedSize))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool AssetPackReader::OpenFromMemory(const void* data, std::size_t byteSize)
+{
+	Close();
+
+	MappedData = static_cast<const std::uint8_t*>(data);
+	MappedSize = byteSize;
+	OwnsMapping = false;
+	if (!ValidateAndBind(MappedData, MappedSize))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void AssetPackReader::Close()
+{
+	if (OwnsMapping && MappedData != nullptr)
+	{
+#if defined(_WIN32)
+		UnmapViewOfFile(MappedData);
+		if (MappingHandle)
+			CloseHandle((HANDLE)MappingHandle);
+		if (FileHandle)
+			CloseHandle((HANDLE)FileHandle);
+#else
+		munmap(const_cast<std::uint8_t*>(MappedData), MappedSize);
+#endif
+	}
+
+	MappedData = nullptr;
+	MappedSize = 0;
+	Header = nullptr;
+	Buckets = nullptr;
+	Entries = nullptr;
+	BucketBits = 0;
+	FileHandle = nullptr;
+	MappingHandle = nullptr;
+	OwnsMapping = false;
+}
+
+bool AssetPackReader::ValidateAndBind(const std::uint8_t* data, std::size_t byteSize)
+{
+	if (data == nullptr || byteSize < sizeof(AssetPackHeader))
+		return false;
+
+	const AssetPackHeader* header = reinterpret_cast<const AssetPackHeader*>(data);
+	if (header->Magic != ASSETPACK_MAGIC || header->Version != ASSETPACK_VERSION)
+		return false;
+	if (header->FileSize > byteSize)
+		return false;
+	if (header->BucketCount == 0 || (header->BucketCount & (header->BucketCount - 1)) != 0)
+		return false;
+
+	const std::uint64_t bucketBytes = sizeof(std::uint32_t) * ((std::uint64_t)header->BucketCount + 1);
+	if (header->EntryTableOffset != AlignUp(sizeof(AssetPackHeader) + bucketBytes, 8))
+		return false;
+	if (header->EntryTableOffset + sizeof(AssetPackEntry) * (std::uint64_t)header->EntryCount > header->FileSize)
+		return false;
+
+	// 桶的起始下标必须单调不减且不超过条目数，否则FindEntry会越过条目表
+	const std::uint32_t* buckets = reinterpret_cast<const std::uint32_t*>(data + sizeof(AssetPackHeader));
+	if (buckets[0] != 0 || buckets[header->BucketCount] != header->EntryCount)
+		return false;
+	for (std::uint32_t b = 0; b < header->BucketCount; ++b)
+	{
+		if (buckets[b] > buckets[b + 1])
+			return false;
+	}
+
+	const AssetPackEntry* entries = reinterpret_cast<const AssetPackEntry*>(data + header->EntryTableOffset);
+	for (std::uint32_t i = 0; i < header->EntryCount; ++i)
+	{
+		const AssetPackEntry& e = entries[i];
+		if (e.Offset + e.StoredSize > header->FileSize || e.Offset + e.StoredSize < e.Offset)
+			return false;
+		if (e.Compression == AssetCompression::None && e.StoredSize != e.RawSize)
+			return false;
+	}
+
+	Header = header;
+	Buckets = buckets;
+	Entries = entries;
+	BucketBits = Log2(header->BucketCount);
+	return true;
+}
+
+const AssetPackEntry* AssetPackReader::FindEntry(std::uint64_t nameHash) const
+{
+	if (Header == nullptr)
+		return nullptr;
+
+	const std::uint32_t b = BucketIndex(nameHash, BucketBits);
+	for (std::uint32_t i = Buckets[b]; i < Buckets[b + 1]; ++i)
+	{
+		if (Entries[i].NameHash == nameHash)
+			return &Entries[i];
+	}
+	return nullptr;
+}
+
+const void* AssetPackReader::GetEntryData(const AssetPackEntry& entry) const
+{
+	if (Header == nullptr || entry.Compression != AssetCompression::None)
+		return nullptr;
+
+	return MappedData + entry.Offset;
+}
+
+bool AssetPackReader::ReadEntry(const AssetPackEntry& entry, std::vector<std::uint8_t>& outData) const
+{
+	if (Header == nullptr)
+		return false;
+
+	const std::uint8_t* src = MappedData + entry.Offset;
+	outData.resize((std::size_t)entry.RawSize);
+
+	switch (entry.Compression)
+	{
+	case AssetCompression::None:
+		if (entry.RawSize > 0)
+			std::memcpy(outData.data(), src, (std::size_t)entry.RawSize);
+		return true;
+	case AssetCompression::LZ:
+		return AssetDecompressLZ(src, (std::size_t)entry.StoredSize, outData.data(), outData.size());
+	default:
+		return false;
+	}
+}
+
+bool AssetPackReader::FindMesh(const std::string& name, MeshAssetView& outView) const
+{
+	const AssetPackEntry* entry = FindEntry(name);
+	if (entry == nullptr || entry->Type != AssetType::Mesh)
+		return false;
+
+	const void* payload = GetEntryData(*entry);
+	if (payload == nullptr)
+		return false;
+
+	return ParseMeshPayload(payload, entry->RawSize, outView);
+}
+
+bool AssetPackReader::ParseMeshPayload(const void* payload, std::uint64_t payloadSize, MeshAssetView& outView)
+{
+	if (payload == nullptr || payloadSize < sizeof(MeshAssetHeader))
+		return false;
+
+	const std::uint8_t* base = static_cast<const std::uint8_t*>(payload);
+	const MeshAssetHeader* header = reinterpret_cast<const MeshAssetHeader*>(base);
+	if (header->IndexByteSize != 2 && header->IndexByteSize != 4)
+		return false;
+	if ((header->VertexEncoding != MeshDataEncoding::None && header->VertexEncoding != MeshDataEncoding::Codec)
+		|| (header->IndexEncoding != MeshDataEncoding::None && header->IndexEncoding != MeshDataEncoding::Codec))
+		return false;
+	if (header->VertexEncoding == MeshDataEncoding::None && header->VertexDataStoredSize != (std::uint64_t)header->VertexByteStride * header->VertexCount)
+		return false;
+	if (header->IndexEncoding == MeshDataEncoding::None && header->IndexDataStoredSize != (std::uint64_t)header->IndexByteSize * header->IndexCount)
+		return false;
+
+	const std::uint64_t subsetEnd = sizeof(MeshAssetHeader) + sizeof(MeshAssetSubset) * (std::uint64_t)header->SubsetCount;
+	const std::uint64_t meshletEnd = subsetEnd + sizeof(MeshAssetMeshlet) * (std::uint64_t)header->MeshletCount;
+	const std::uint64_t vbEnd = header->VertexDataOffset + header->VertexDataStoredSize;
+	const std::uint64_t ibEnd = header->IndexDataOffset + header->IndexDataStoredSize;
+	if (meshletEnd > payloadSize || vbEnd > payloadSize || ibEnd > payloadSize)
+		return false;
+
+	outView.Header = header;
+	outView.Subsets = reinterpret_cast<const MeshAssetSubset*>(base + sizeof(MeshAssetHeader));
+	outView.Meshlets = header->MeshletCount > 0 ? reinterpret_cast<const MeshAssetMeshlet*>(base + subsetEnd) : nullptr;
+	outView.VertexData = base + header->VertexDataOffset;
+	outView.IndexData = base + header->IndexDataOffset;
+	return true;
+}
+
+bool MeshAssetView::DecodeVertexData(void* dst) const
+{
+	if (!IsVertexDataEncoded())
+	{
+		std::memcpy(dst, VertexData, (std::size_t)VertexDataByteSize());
+		return true;
+	}
+	return DecodeVertexBuffer(dst, Header->VertexCount, Header->VertexByteStride, VertexData, (std::size_t)Header->VertexDataStoredSize);
+}
+
+bool MeshAssetView::DecodeIndexData(void* dst) const
+{
+	if (!IsIndexDataEncoded())
+	{
+		std::memcpy(dst, IndexData, (std::size_t)IndexDataByteSize());
+		return true;
+	}
+	return DecodeIndexBuffer(dst, Header->IndexCount, Header->IndexByteSize, IndexData, (std::size_t)Header->IndexDataStoredSize);
+}
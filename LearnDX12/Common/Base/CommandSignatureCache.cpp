@@ -0,0 +1,36 @@
+﻿#include "Base/CommandSignatureCache.h"
+#include "Render/IndirectDraw.h"
+
+ID3D12CommandSignature* CommandSignatureCache::Get(ID3D12Device* device, ID3D12RootSignature* rootSignature, const std::uint32_t* rootConstantParameterIndex)
+{
+	const Key key = rootConstantParameterIndex != nullptr ? Key(rootSignature, *rootConstantParameterIndex) : Key(nullptr, NoRootConstant);
+	auto it = Signatures.find(key);
+	if (it != Signatures.end())
+		return it->second.Get();
+
+	D3D12_INDIRECT_ARGUMENT_DESC arguments[2] = {};
+	UINT argumentCount = 0;
+	if (rootConstantParameterIndex != nullptr)
+	{
+		arguments[argumentCount].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT;
+		arguments[argumentCount].Constant.RootParameterIndex = *rootConstantParameterIndex;
+		arguments[argumentCount].Constant.DestOffsetIn32BitValues = 0;
+		arguments[argumentCount].Constant.Num32BitValuesToSet = 1;
+		++argumentCount;
+	}
+	arguments[argumentCount].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+	++argumentCount;
+
+	D3D12_COMMAND_SIGNATURE_DESC desc = {};
+	desc.ByteStride = sizeof(IndirectDrawArguments);
+	desc.NumArgumentDescs = argumentCount;
+	desc.pArgumentDescs = arguments;
+	desc.NodeMask = 0;
+
+	// 只包含绘制参数时不需要根签名
+	Microsoft::WRL::ComPtr<ID3D12CommandSignature> signature;
+	ThrowIfFailed(device->CreateCommandSignature(&desc, rootConstantParameterIndex != nullptr ? rootSignature : nullptr, IID_PPV_ARGS(&signature)));
+	ID3D12CommandSignature* result = signature.Get();
+	Signatures.emplace(key, std::move(signature));
+	return result;
+}
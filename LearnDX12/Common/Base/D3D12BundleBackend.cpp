@@ -0,0 +1,26 @@
+﻿#include "Base/D3D12BundleBackend.h"
+
+CommandRecorder& D3D12BundleBackend::BeginBundle()
+{
+	Recording = Bundle();
+	ThrowIfFailed(Device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_BUNDLE, IID_PPV_ARGS(Recording.Allocator.GetAddressOf())));
+	ThrowIfFailed(Device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_BUNDLE, Recording.Allocator.Get(), nullptr,
+		IID_PPV_ARGS(Recording.CommandList.GetAddressOf())));
+	Recorder = std::make_unique<D3D12CommandRecorder>(Recording.CommandList.Get());
+	return *Recorder;
+}
+
+RenderHandle D3D12BundleBackend::EndBundle()
+{
+	ThrowIfFailed(Recording.CommandList->Close());
+	const RenderHandle handle = ToRenderHandle(Recording.CommandList.Get());
+	Bundles.emplace(handle, std::move(Recording));
+	Recording = Bundle();
+	Recorder.reset();
+	return handle;
+}
+
+void D3D12BundleBackend::ReleaseBundle(RenderHandle bundle)
+{
+	Bundles.erase(bundle);
+}
@@ -0,0 +1,49 @@
+﻿#include "Base/D3D12GpuTimestampBackend.h"
+#include "Profile/RenderCounters.h"
+
+D3D12GpuTimestampBackend::D3D12GpuTimestampBackend(ID3D12Device* device, ID3D12CommandQueue* commandQueue, ID3D12GraphicsCommandList* commandList)
+	: Device(device), CommandList(commandList)
+{
+	ThrowIfFailed(commandQueue->GetTimestampFrequency(&Frequency));
+}
+
+void D3D12GpuTimestampBackend::CreateQueries(std::uint32_t queryCount)
+{
+	D3D12_QUERY_HEAP_DESC heapDesc = {};
+	heapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+	heapDesc.Count = queryCount;
+	heapDesc.NodeMask = 0;
+	ThrowIfFailed(Device->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(QueryHeap.GetAddressOf())));
+
+	// ResolveQueryData的目标需处于COPY_DEST状态，回读堆的资源创建后不能再转换状态
+	CD3DX12_HEAP_PROPERTIES heapPro(D3D12_HEAP_TYPE_READBACK);
+	CD3DX12_RESOURCE_DESC resDesc = CD3DX12_RESOURCE_DESC::Buffer((UINT64)queryCount * sizeof(UINT64));
+	ThrowIfFailed(Device->CreateCommittedResource(&heapPro, D3D12_HEAP_FLAG_NONE, &resDesc,
+		D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(ReadbackBuffer.GetAddressOf())));
+	CountRender(RenderCounter::ResourcesCreated, 2);
+}
+
+void D3D12GpuTimestampBackend::WriteTimestamp(std::uint32_t query)
+{
+	CommandList->EndQuery(QueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, query);
+}
+
+void D3D12GpuTimestampBackend::ResolveTimestamps(std::uint32_t first, std::uint32_t count)
+{
+	CommandList->ResolveQueryData(QueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, first, count,
+		ReadbackBuffer.Get(), (UINT64)first * sizeof(UINT64));
+}
+
+bool D3D12GpuTimestampBackend::ReadTimestamps(std::uint32_t first, std::uint32_t count, std::uint64_t* outTicks)
+{
+	// 只映射需要读取的范围，Unmap时传入空范围表示CPU没有写入
+	D3D12_RANGE readRange = { (SIZE_T)first * sizeof(UINT64), (SIZE_T)(first + count) * sizeof(UINT64) };
+	void* mappedData = nullptr;
+	if (FAILED(ReadbackBuffer->Map(0, &readRange, &mappedData)))
+		return false;
+
+	memcpy(outTicks, static_cast<BYTE*>(mappedData) + readRange.Begin, (size_t)count * sizeof(UINT64));
+	D3D12_RANGE writtenRange = { 0, 0 };
+	ReadbackBuffer->Unmap(0, &writtenRange);
+	return true;
+}
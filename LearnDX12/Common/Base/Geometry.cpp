@@ -1,6 +1,12 @@
 ﻿#include "Base/Geometry.h"
 #include "DX12Util.h"
 #include "DXRenderDeviceManager.h"
+#include "Base/D3D12CommandRecorder.h"
+#include "Base/MeshGeometryBuilder.h"
+#include "Base/VertexLayout.h"
+#include "Mesh/GeometryGenerator.h"
+#include "Profile/RenderCounters.h"
+#include <cmath>
 
 
 
@@ -14,6 +20,16 @@ void Geometry::Initialize()
 	CreatePSO();
 }
 
+void Geometry::Initialize(const AssetPackReader& pack, const std::string& meshName)
+{
+	CreateConstantBuffers();
+	CreateRootSignature();
+	CreateShader(&pack);
+	if (!CreateVertexAndIndexBufferFromPack(pack, meshName))
+		CreateVertexAndIndexBuffer();
+	CreatePSO();
+}
+
 void Geometry::Draw(SystemTimer& Timer)
 {
 	ID3D12GraphicsCommandList* pCommandList = DXRenderDeviceManager::GetInstance().GetCommandList();
@@ -21,30 +37,86 @@ void Geometry::Draw(SystemTimer& Timer)
 	if (pCommandList == nullptr)
 		return;
 
-	// 将常量缓冲区描述符堆与渲染流水线绑定
-	ID3D12DescriptorHeap* descriptorHeaps[] = { CBVHeap.Get() };
-	pCommandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
-	// 将根签名与渲染流水线绑定
-	pCommandList->SetGraphicsRootSignature(RootSignature.Get());
-	// 将常量缓冲区中的数据与根描述符列表绑定
-	pCommandList->SetGraphicsRootDescriptorTable(0, CBVHeap->GetGPUDescriptorHandleForHeapStart());
-
-	// 向命令列表中设置顶点缓冲区描述符
-	pCommandList->IASetVertexBuffers(0,	// 该接口支持设置多个缓冲区，此参数表示起始输入缓冲区的索引 
-		1,								// 缓冲区的数量
-		&VertexBufferView);	// 指向一个缓冲区描述符数组
-	// 向命令列表中设置索引缓冲区描述符的数组指针
-	pCommandList->IASetIndexBuffer(&IndexBufferView);
-	// 指定将要绘制的图元类型
-	pCommandList->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-	// 以索引方式开始绘制(支持多实例渲染)
-	pCommandList->DrawIndexedInstanced(
-		36,		// 每个绘制实例需要绘制的索引数量	
-		1,		// 每次绘制1个实例
-		0,		// 从索引下标为0的位置开始读取索引
-		0,		// BaseVertexLocation 根据索引查找顶点时的基础顶点偏移(eg: 多个模型顶点索引数据合并后，可用此偏移表示绘制第几个模型)
-		0);		// 用于在多实例渲染时使用
+	if (PSO == nullptr || CBVHeap == nullptr || VertexBufferGPU == nullptr || IndexBufferGPU == nullptr)
+		return;
+
+	// 单独绘制时直接录制，不经过排序；与其他物体一起绘制时使用Submit加入帧级的绘制队列
+	D3D12CommandRecorder recorder(pCommandList);
+	recorder.SetDescriptorHeap(ToRenderHandle(CBVHeap.Get()));
+	recorder.SetGraphicsRootSignature(ToRenderHandle(RootSignature.Get()));
+	recorder.SetGraphicsRootDescriptorTable(0, ToRenderHandle(CBVHeap->GetGPUDescriptorHandleForHeapStart()));
+	recorder.SetPipelineState(ToRenderHandle(PSO.Get()));
+	recorder.SetVertexBuffer(VertexBufferBinding{ VertexBufferView.BufferLocation, VertexBufferView.SizeInBytes, VertexBufferView.StrideInBytes });
+	recorder.SetIndexBuffer(IndexBufferBinding{ IndexBufferView.BufferLocation, IndexBufferView.SizeInBytes, IndexBufferView.Format == DXGI_FORMAT_R32_UINT ? 4u : 2u });
+	recorder.SetPrimitiveTopology(PrimitiveTopologyTriangleList);
+
+	CurrentLod = SelectLod();
+
+	// 有Meshlet数据时只绘制剔除后可见的索引范围(Meshlet只覆盖LOD0)
+	if (CurrentLod == 0 && !Meshlets.Meshlets.empty())
+	{
+		CullMeshlets();
+		for (const MeshletDrawRange& range : VisibleRanges)
+			recorder.DrawIndexedInstanced(range.IndexCount, 1, range.StartIndexLocation, range.BaseVertexLocation, 0);
+		return;
+	}
+
+	for (const SubmeshGeometry& submesh : Submeshes)
+	{
+		if (submesh.LodLevel == CurrentLod)
+			recorder.DrawIndexedInstanced(submesh.IndexCount, 1, submesh.StartIndexLocation, submesh.BaseVertexLocation, 0);
+	}
+}
+
+void Geometry::Submit(DrawQueue& queue, std::uint32_t pass)
+{
+	if (PSO == nullptr || CBVHeap == nullptr || VertexBufferGPU == nullptr || IndexBufferGPU == nullptr)
+		return;
+
+	DrawPacket packet;
+	packet.PipelineState = ToRenderHandle(PSO.Get());
+	packet.RootSignature = ToRenderHandle(RootSignature.Get());
+	packet.DescriptorHeap = ToRenderHandle(CBVHeap.Get());
+	packet.DescriptorTable = ToRenderHandle(CBVHeap->GetGPUDescriptorHandleForHeapStart());
+	packet.VertexBuffer.BufferLocation = VertexBufferView.BufferLocation;
+	packet.VertexBuffer.SizeInBytes = VertexBufferView.SizeInBytes;
+	packet.VertexBuffer.StrideInBytes = VertexBufferView.StrideInBytes;
+	packet.IndexBuffer.BufferLocation = IndexBufferView.BufferLocation;
+	packet.IndexBuffer.SizeInBytes = IndexBufferView.SizeInBytes;
+	packet.IndexBuffer.IndexByteSize = IndexBufferView.Format == DXGI_FORMAT_R32_UINT ? 4 : 2;
+
+	// 深度为包围球中心在裁剪空间中的w(即视空间深度)，同一状态内由近到远绘制
+	const XMFLOAT4X4& m = WorldViewProj;
+	const XMFLOAT3& c = LodBounds.Center;
+	const float depth = c.x * m._14 + c.y * m._24 + c.z * m._34 + m._44;
+	const std::uint64_t sortKey = MakeDrawSortKey(pass, PipelineStateId, RootSignatureId, MaterialId, QuantizeDrawDepth(depth, SortDepthRange));
+
+	CurrentLod = SelectLod();
+
+	// 有Meshlet数据时只绘制剔除后可见的索引范围(Meshlet只覆盖LOD0)
+	if (CurrentLod == 0 && !Meshlets.Meshlets.empty())
+	{
+		CullMeshlets();
+		for (const MeshletDrawRange& range : VisibleRanges)
+		{
+			packet.IndexCount = range.IndexCount;
+			packet.StartIndexLocation = range.StartIndexLocation;
+			packet.BaseVertexLocation = range.BaseVertexLocation;
+			queue.Add(sortKey, packet);
+		}
+		return;
+	}
+
+	for (const SubmeshGeometry& submesh : Submeshes)
+	{
+		if (submesh.LodLevel != CurrentLod)
+			continue;
+
+		packet.IndexCount = submesh.IndexCount;					// 每个绘制实例需要绘制的索引数量
+		packet.StartIndexLocation = submesh.StartIndexLocation;	// 从索引缓冲区中的该位置开始读取索引
+		packet.BaseVertexLocation = submesh.BaseVertexLocation;	// 根据索引查找顶点时的基础顶点偏移
+		queue.Add(sortKey, packet);
+	}
 }
 
 
@@ -53,6 +125,41 @@ void Geometry::SetMatrixParameter(XMMATRIX& worldViewProj)
 	ObjectConstants objConstants;
 	XMStoreFloat4x4(&objConstants.WorldViewProj, XMMatrixTranspose(worldViewProj));
 	ObjectConstantBuffer->CopyData(0, objConstants);
+	XMStoreFloat4x4(&WorldViewProj, worldViewProj);
+}
+
+void Geometry::CullMeshlets()
+{
+	const MeshletCullView view = MeshletCuller::MakeCullView(WorldViewProj);
+	MeshletCuller::Cull(view, Meshlets.Meshlets.data(), Meshlets.Bounds.data(), Meshlets.Meshlets.size(), VisibleRanges, &LastCullStats);
+}
+
+UINT Geometry::SelectLod() const
+{
+	if (LodErrors.size() <= 1)
+		return 0;
+
+	// 行向量约定下clip.y = p·col1，clip.w = p·col3
+	// |col1.xyz|为模型空间单位长度在裁剪空间y方向的最大缩放，除以w后乘以视口半高即为像素大小
+	const XMFLOAT4X4& m = WorldViewProj;
+	const float scaleY = std::sqrt(m._12 * m._12 + m._22 * m._22 + m._32 * m._32);
+	const float scaleW = std::sqrt(m._14 * m._14 + m._24 * m._24 + m._34 * m._34);
+	const XMFLOAT3& c = LodBounds.Center;
+	const float nearestW = c.x * m._14 + c.y * m._24 + c.z * m._34 + m._44 - LodBounds.Radius * scaleW;
+
+	// 相机位于包围球内或附近时使用LOD0
+	if (nearestW <= 1e-4f)
+		return 0;
+
+	const float pixelsPerUnit = scaleY / nearestW * ViewportHeight * 0.5f;
+	UINT lod = 0;
+	for (UINT level = 1; level < (UINT)LodErrors.size(); ++level)
+	{
+		if (LodErrors[level] * pixelsPerUnit > LodPixelError)
+			break;
+		lod = level;
+	}
+	return lod;
 }
 
 
@@ -68,18 +175,40 @@ void Geometry::UploadVertexData(ID3D12Device* device, ID3D12GraphicsCommandList*
 	VertexBufferView.StrideInBytes = StrideSize;	// 每个顶点元素所占的字节数
 }
 
-void Geometry::UploadVertexIndexData(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* initData, UINT64 byteSize)
+void Geometry::UploadVertexIndexData(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* initData, UINT64 byteSize, DXGI_FORMAT indexFormat)
 {
 	if (!CreateAndUploadBuffer(device, cmdList, initData, byteSize, IndexBufferUploader, IndexBufferGPU))
 		return;
 
 	// 索引缓冲区描述符D3D12_INDEX_BUFFER_VIEW
 	IndexBufferView.BufferLocation = IndexBufferGPU->GetGPUVirtualAddress();	// 索引缓冲区地址
-	IndexBufferView.Format = DXGI_FORMAT_R16_UINT;		// 索引格式
+	IndexBufferView.Format = indexFormat;				// 索引格式
 	IndexBufferView.SizeInBytes = byteSize;				// 索引缓冲区大小
 
 }
 
+bool Geometry::UploadVertexData(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const std::function<bool(void*)>& fill, UINT64 StrideSize, UINT64 byteSize)
+{
+	if (!CreateAndFillBuffer(device, cmdList, byteSize, fill, VertexBufferUploader, VertexBufferGPU))
+		return false;
+
+	VertexBufferView.BufferLocation = VertexBufferGPU->GetGPUVirtualAddress();
+	VertexBufferView.SizeInBytes = byteSize;
+	VertexBufferView.StrideInBytes = StrideSize;
+	return true;
+}
+
+bool Geometry::UploadVertexIndexData(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const std::function<bool(void*)>& fill, UINT64 byteSize, DXGI_FORMAT indexFormat)
+{
+	if (!CreateAndFillBuffer(device, cmdList, byteSize, fill, IndexBufferUploader, IndexBufferGPU))
+		return false;
+
+	IndexBufferView.BufferLocation = IndexBufferGPU->GetGPUVirtualAddress();
+	IndexBufferView.Format = indexFormat;
+	IndexBufferView.SizeInBytes = byteSize;
+	return true;
+}
+
 bool Geometry::CreateAndUploadBuffer(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* initData, UINT64 byteSize, ComPtr<ID3D12Resource>& uploadBuffer, ComPtr<ID3D12Resource>& buffer)
 {
 	if (device == nullptr || cmdList == nullptr || initData == nullptr)
@@ -150,6 +279,60 @@ bool Geometry::CreateAndUploadBuffer(ID3D12Device* device, ID3D12GraphicsCommand
 	// 将最终顶点/索引缓冲区的资源状态由拷贝到的目标改为等待渲染流水线读取
 	cmdList->ResourceBarrier(1, &defaultResBarrier2);
 
+	CountRender(RenderCounter::ResourcesCreated, 2);
+	CountRender(RenderCounter::UploadBytes, byteSize);
+	CountRender(RenderCounter::Barriers, 2);
+
+	return true;
+}
+
+bool Geometry::CreateAndFillBuffer(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, UINT64 byteSize, const std::function<bool(void*)>& fill, ComPtr<ID3D12Resource>& uploadBuffer, ComPtr<ID3D12Resource>& buffer)
+{
+	if (device == nullptr || cmdList == nullptr || !fill)
+		return false;
+
+	CD3DX12_HEAP_PROPERTIES DX12HeapDefault = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	CD3DX12_HEAP_PROPERTIES DX12HeapUpload = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC DX12ResDesc = CD3DX12_RESOURCE_DESC::Buffer(byteSize);
+
+	ThrowIfFailed(device->CreateCommittedResource(
+		&DX12HeapUpload,
+		D3D12_HEAP_FLAG_NONE,
+		&DX12ResDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(uploadBuffer.GetAddressOf())));
+
+	// 数据直接写入Upload堆的映射内存(写合并内存，fill应顺序写入且不回读)
+	void* mappedData = nullptr;
+	CD3DX12_RANGE readRange(0, 0);		// CPU不读取该缓冲区
+	ThrowIfFailed(uploadBuffer->Map(0, &readRange, &mappedData));
+	const bool filled = fill(mappedData);
+	uploadBuffer->Unmap(0, nullptr);
+	if (!filled)
+	{
+		uploadBuffer.Reset();
+		return false;
+	}
+
+	ThrowIfFailed(device->CreateCommittedResource(
+		&DX12HeapDefault,
+		D3D12_HEAP_FLAG_NONE,
+		&DX12ResDesc,
+		D3D12_RESOURCE_STATE_COMMON,
+		nullptr,
+		IID_PPV_ARGS(buffer.GetAddressOf())));
+
+	CD3DX12_RESOURCE_BARRIER toCopyDest = CD3DX12_RESOURCE_BARRIER::Transition(buffer.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+	CD3DX12_RESOURCE_BARRIER toGenericRead = CD3DX12_RESOURCE_BARRIER::Transition(buffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ);
+	cmdList->ResourceBarrier(1, &toCopyDest);
+	cmdList->CopyBufferRegion(buffer.Get(), 0, uploadBuffer.Get(), 0, byteSize);
+	cmdList->ResourceBarrier(1, &toGenericRead);
+
+	CountRender(RenderCounter::ResourcesCreated, 2);
+	CountRender(RenderCounter::UploadBytes, byteSize);
+	CountRender(RenderCounter::Barriers, 2);
+
 	return true;
 }
 
@@ -239,74 +422,221 @@ void Geometry::CreateRootSignature()
 
 void Geometry::CreateVertexAndIndexBuffer()
 {
-	std::array<Vertex, 8> vertices =
-	{
-		Vertex({ XMFLOAT3(-1.0f, -1.0f, -1.0f), XMFLOAT4(Colors::White) }),
-		Vertex({ XMFLOAT3(-1.0f, +1.0f, -1.0f), XMFLOAT4(Colors::Black) }),
-		Vertex({ XMFLOAT3(+1.0f, +1.0f, -1.0f), XMFLOAT4(Colors::Red) }),
-		Vertex({ XMFLOAT3(+1.0f, -1.0f, -1.0f), XMFLOAT4(Colors::Green) }),
-		Vertex({ XMFLOAT3(-1.0f, -1.0f, +1.0f), XMFLOAT4(Colors::Blue) }),
-		Vertex({ XMFLOAT3(-1.0f, +1.0f, +1.0f), XMFLOAT4(Colors::Yellow) }),
-		Vertex({ XMFLOAT3(+1.0f, +1.0f, +1.0f), XMFLOAT4(Colors::Cyan) }),
-		Vertex({ XMFLOAT3(+1.0f, -1.0f, +1.0f), XMFLOAT4(Colors::Magenta) })
-	};
+	// 默认的立方体由GeometryGenerator生成并缓存，多个Geometry使用同一份数据
+	std::shared_ptr<const MeshData> box = GeometryCache::GetInstance().Get(GeometryDesc::Box(2.0f, 2.0f, 2.0f));
+	CreateVertexAndIndexBuffer(*box);
+	Name = "boxGeo";
+}
 
-	std::array<std::uint16_t, 36> indices =
-	{
-		// front face
-		0, 1, 2,
-		0, 2, 3,
+void Geometry::CreateVertexAndIndexBuffer(const MeshData& mesh)
+{
+	// 所有索引都能用16位表示时使用16位索引
+	const bool use16BitIndices = mesh.CanUse16BitIndices();
+	std::vector<std::uint16_t> indices16;
+	if (use16BitIndices)
+		indices16 = mesh.GetIndices16();
+	const void* indexData = use16BitIndices ? (const void*)indices16.data() : (const void*)mesh.Indices32.data();
 
-		// back face
-		4, 6, 5,
-		4, 7, 6,
+	const UINT vbByteSize = (UINT)mesh.Vertices.size() * sizeof(Vertex);
+	const UINT ibByteSize = (UINT)mesh.Indices32.size() * (use16BitIndices ? sizeof(std::uint16_t) : sizeof(std::uint32_t));
 
-		// left face
-		4, 5, 1,
-		4, 1, 0,
+	Name = mesh.Name;
 
-		// right face
-		3, 2, 6,
-		3, 6, 7,
+	ThrowIfFailed(D3DCreateBlob(vbByteSize, &VertexBufferCPU));
+	CopyMemory(VertexBufferCPU->GetBufferPointer(), mesh.Vertices.data(), vbByteSize);
 
-		// top face
-		1, 5, 6,
-		1, 6, 2,
+	ThrowIfFailed(D3DCreateBlob(ibByteSize, &IndexBufferCPU));
+	CopyMemory(IndexBufferCPU->GetBufferPointer(), indexData, ibByteSize);
 
-		// bottom face
-		4, 0, 3,
-		4, 3, 7
-	};
+	ID3D12Device* pD3DDevice = DXRenderDeviceManager::GetInstance().GetD3DDevice();
+	ID3D12GraphicsCommandList* pCommandList = DXRenderDeviceManager::GetInstance().GetCommandList();
+	UploadVertexData(pD3DDevice, pCommandList, mesh.Vertices.data(), sizeof(Vertex), vbByteSize);
+	UploadVertexIndexData(pD3DDevice, pCommandList, indexData, ibByteSize, use16BitIndices ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT);
 
-	const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
-	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::uint16_t);
+	Submeshes.clear();
+	for (const MeshSubset& subset : mesh.Subsets)
+		Submeshes.push_back(ToSubmeshGeometry(subset));
+	if (Submeshes.empty())
+	{
+		SubmeshGeometry submesh;
+		submesh.IndexCount = (UINT)mesh.Indices32.size();
+		Submeshes.push_back(submesh);
+	}
+	Meshlets = MeshletData();
+	LodErrors.clear();
+	CurrentLod = 0;
+	UpdateLodBounds();
+
+	// 顶点为Vertex格式，替换之前从资源包中加载的模型可能使用的其他格式
+	const auto layout = MakeInputLayout<ColorVertexFormat>();
+	InputLayout.assign(layout.begin(), layout.end());
+}
 
-	Name = "boxGeo";
+void Geometry::UpdateLodBounds()
+{
+	// LOD0子集包围盒的并集
+	bool hasBounds = false;
+	BoundingBox lodBox;
+	for (const SubmeshGeometry& submesh : Submeshes)
+	{
+		if (submesh.LodLevel != 0)
+			continue;
+		if (hasBounds)
+			BoundingBox::CreateMerged(lodBox, lodBox, submesh.Bounds);
+		else
+			lodBox = submesh.Bounds;
+		hasBounds = true;
+	}
+	BoundingSphere::CreateFromBoundingBox(LodBounds, lodBox);
+}
 
-	ThrowIfFailed(D3DCreateBlob(vbByteSize, &VertexBufferCPU));
-	CopyMemory(VertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
+bool Geometry::CreateVertexAndIndexBufferFromPack(const AssetPackReader& pack, const std::string& meshName)
+{
+	MeshAssetView meshView;
+	if (!pack.FindMesh(meshName, meshView))
+		return false;
 
-	ThrowIfFailed(D3DCreateBlob(ibByteSize, &IndexBufferCPU));
-	CopyMemory(IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+	// 根据资源包中记录的顶点格式生成InputLayout(0表示与Vertex相同的格式)
+	std::vector<D3D12_INPUT_ELEMENT_DESC> inputLayout;
+	UINT vertexStride = 0;
+	if (meshView.Header->VertexFormat == 0)
+	{
+		const auto layout = MakeInputLayout<ColorVertexFormat>();
+		inputLayout.assign(layout.begin(), layout.end());
+		vertexStride = ColorVertexFormat::Stride;
+	}
+	else if (!MakeInputLayout(meshView.Header->VertexFormat, inputLayout, vertexStride))
+	{
+		return false;
+	}
+	if (meshView.Header->VertexByteStride != vertexStride)
+		return false;
+
+	// 索引格式由AssetCooker按模型选择，能用16位表示时为16位
+	const DXGI_FORMAT indexFormat = meshView.Header->IndexByteSize == 4 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
 
 	ID3D12Device* pD3DDevice = DXRenderDeviceManager::GetInstance().GetD3DDevice();
 	ID3D12GraphicsCommandList* pCommandList = DXRenderDeviceManager::GetInstance().GetCommandList();
-	UploadVertexData(pD3DDevice, pCommandList, vertices.data(), sizeof(Vertex), vbByteSize);
-	UploadVertexIndexData(pD3DDevice, pCommandList, indices.data(), ibByteSize);
+	if (pD3DDevice == nullptr || pCommandList == nullptr)
+		return false;
+
+	// 编码的数据直接解码到Upload堆缓冲区中，不需要额外的内存缓冲区；
+	// 未编码的数据在映射视图中已按上传格式存放，直接作为上传源数据，不经过ID3DBlob中转
+	if (meshView.IsVertexDataEncoded())
+	{
+		if (!UploadVertexData(pD3DDevice, pCommandList, [&](void* dst) { return meshView.DecodeVertexData(dst); }, vertexStride, meshView.VertexDataByteSize()))
+			return false;
+	}
+	else
+		UploadVertexData(pD3DDevice, pCommandList, meshView.VertexData, vertexStride, meshView.VertexDataByteSize());
+
+	if (meshView.IsIndexDataEncoded())
+	{
+		if (!UploadVertexIndexData(pD3DDevice, pCommandList, [&](void* dst) { return meshView.DecodeIndexData(dst); }, meshView.IndexDataByteSize(), indexFormat))
+			return false;
+	}
+	else
+		UploadVertexIndexData(pD3DDevice, pCommandList, meshView.IndexData, meshView.IndexDataByteSize(), indexFormat);
+
+	// 两个缓冲区都创建成功后才替换顶点格式，解码失败时由调用方改用默认的立方体(Vertex格式)
+	Name = meshName;
+	InputLayout = inputLayout;
+	Submeshes.clear();
+	LodErrors.clear();
+	CurrentLod = 0;
+	for (std::uint32_t i = 0; i < meshView.Header->SubsetCount; ++i)
+	{
+		const MeshAssetSubset& subset = meshView.Subsets[i];
+		SubmeshGeometry submesh;
+		submesh.IndexCount = subset.IndexCount;
+		submesh.StartIndexLocation = subset.StartIndexLocation;
+		submesh.BaseVertexLocation = subset.BaseVertexLocation;
+		submesh.Bounds.Center = XMFLOAT3(subset.BoundsCenter);
+		submesh.Bounds.Extents = XMFLOAT3(subset.BoundsExtents);
+		submesh.LodLevel = subset.LodLevel;
+		submesh.LodError = subset.LodError;
+		Submeshes.push_back(submesh);
+
+		if (LodErrors.size() <= subset.LodLevel)
+			LodErrors.resize(subset.LodLevel + 1, 0.0f);
+		if (subset.LodError > LodErrors[subset.LodLevel])
+			LodErrors[subset.LodLevel] = subset.LodError;
+	}
+
+	UpdateLodBounds();
+
+	// Meshlet剔除数据(Meshlet的索引范围位于各子集内)
+	Meshlets = MeshletData();
+	for (std::uint32_t i = 0; i < meshView.Header->MeshletCount; ++i)
+	{
+		const MeshAssetMeshlet& source = meshView.Meshlets[i];
+		Meshlet meshlet;
+		meshlet.IndexCount = source.IndexCount;
+		meshlet.StartIndexLocation = source.StartIndexLocation;
+		meshlet.BaseVertexLocation = source.BaseVertexLocation;
+		meshlet.TriangleCount = source.IndexCount / 3;
+
+		MeshletBounds bounds;
+		bounds.Center = XMFLOAT3(source.Center);
+		bounds.Radius = source.Radius;
+		bounds.ConeAxis = XMFLOAT3(source.ConeAxis);
+		bounds.ConeCutoff = source.ConeCutoff;
+
+		Meshlets.Meshlets.push_back(meshlet);
+		Meshlets.Bounds.push_back(bounds);
+	}
+
+	// 没有子集信息时绘制全部索引
+	if (Submeshes.empty())
+	{
+		SubmeshGeometry submesh;
+		submesh.IndexCount = meshView.Header->IndexCount;
+		Submeshes.push_back(submesh);
+	}
+
+	return true;
 }
 
-void Geometry::CreateShader()
+void Geometry::CreateShader(const AssetPackReader* pPack)
 {
 	HRESULT hr = S_OK;
 
-	VSByteCode = d3dUtil::CompileShader(L"Shaders\\color.hlsl", nullptr, "VS", "vs_5_0");
-	PSByteCode = d3dUtil::CompileShader(L"Shaders\\color.hlsl", nullptr, "PS", "ps_5_0");
+	// 优先使用AssetCooker烘焙好的字节码，省去每次启动时的Shader编译
+	if (pPack == nullptr || !LoadShaderFromPack(*pPack, "color_vs", VSByteCode) || !LoadShaderFromPack(*pPack, "color_ps", PSByteCode))
+	{
+		VSByteCode = d3dUtil::CompileShader(L"Shaders\\color.hlsl", nullptr, "VS", "vs_5_0");
+		PSByteCode = d3dUtil::CompileShader(L"Shaders\\color.hlsl", nullptr, "PS", "ps_5_0");
+	}
+
+	// 由顶点格式描述生成与Vertex一致的InputLayout，资源包中的模型使用其他顶点格式时在加载模型时替换
+	const auto layout = MakeInputLayout<ColorVertexFormat>();
+	InputLayout.assign(layout.begin(), layout.end());
+}
+
+bool Geometry::LoadShaderFromPack(const AssetPackReader& pack, const std::string& name, ComPtr<ID3DBlob>& byteCode)
+{
+	const AssetPackEntry* pEntry = pack.FindEntry(name);
+	if (pEntry == nullptr || pEntry->Type != AssetType::Shader)
+		return false;
 
-	InputLayout =
+	ComPtr<ID3DBlob> blob;
+	ThrowIfFailed(D3DCreateBlob((SIZE_T)pEntry->RawSize, blob.GetAddressOf()));
+
+	const void* pData = pack.GetEntryData(*pEntry);
+	if (pData != nullptr)
 	{
-		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-		{ "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-	};
+		CopyMemory(blob->GetBufferPointer(), pData, (SIZE_T)pEntry->RawSize);
+	}
+	else
+	{
+		std::vector<std::uint8_t> data;
+		if (!pack.ReadEntry(*pEntry, data))
+			return false;
+		CopyMemory(blob->GetBufferPointer(), data.data(), data.size());
+	}
+
+	byteCode = blob;
+	return true;
 }
 
 void Geometry::CreatePSO()
@@ -342,4 +672,9 @@ void Geometry::CreatePSO()
 	psoDesc.SampleDesc.Quality = enableMSAA ? (DXRenderDeviceManager::GetInstance().GetMSAAQuality() - 1) : 0;
 	psoDesc.DSVFormat = DepthStencilFormat;
 	ThrowIfFailed(pD3DDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&PSO)));
+
+	// 排序键中使用的状态编号，Geometry没有材质，材质字段使用常量缓冲区描述符表的编号
+	PipelineStateId = GetRenderStateId(ToRenderHandle(PSO.Get()));
+	RootSignatureId = GetRenderStateId(ToRenderHandle(RootSignature.Get()));
+	MaterialId = CBVHeap != nullptr ? GetRenderStateId(ToRenderHandle(CBVHeap->GetGPUDescriptorHandleForHeapStart())) : 0;
 }
@@ -0,0 +1,41 @@
+﻿#include "Base/IndirectDrawRenderer.h"
+#include "Base/D3D12CommandRecorder.h"
+
+void IndirectDrawRenderer::ReserveArguments(ID3D12Device* device, std::size_t count)
+{
+	if (count <= ArgumentCapacity)
+		return;
+
+	// 按1.5倍增长，减少物体数量逐渐增加时的重新创建
+	std::size_t capacity = ArgumentCapacity + ArgumentCapacity / 2;
+	if (capacity < count)
+		capacity = count;
+	ArgumentBuffer = std::make_unique<UploadBuffer<IndirectDrawArguments>>(device, (UINT)capacity, false);
+	ArgumentCapacity = capacity;
+}
+
+std::uint32_t IndirectDrawRenderer::Record(ID3D12Device* device, CommandRecorder& recorder, const std::vector<IndirectDrawBucket>& buckets,
+	const MeshletCullView* pView, unsigned threadCount)
+{
+	std::size_t totalCount = 0;
+	for (const IndirectDrawBucket& bucket : buckets)
+		totalCount += bucket.Draws.GetCount();
+	if (totalCount == 0)
+		return 0;
+
+	ReserveArguments(device, totalCount);
+	IndirectDrawArguments* mappedArguments = ArgumentBuffer->MappedData();
+	const RenderHandle argumentBuffer = ToRenderHandle(ArgumentBuffer->Resource());
+
+	// 各桶的可见物体依次紧密写入参数缓冲区
+	std::uint32_t drawCount = 0;
+	for (const IndirectDrawBucket& bucket : buckets)
+	{
+		ID3D12CommandSignature* signature = Signatures.Get(device, reinterpret_cast<ID3D12RootSignature*>(bucket.State.RootSignature),
+			bucket.UseRootConstant ? &bucket.RootConstantParameterIndex : nullptr);
+		drawCount += Builder.Record(recorder, bucket, pView, ToRenderHandle(signature), mappedArguments + drawCount,
+			argumentBuffer, (std::uint64_t)drawCount * sizeof(IndirectDrawArguments), threadCount);
+	}
+	CountRender(RenderCounter::UploadBytes, (std::uint64_t)drawCount * sizeof(IndirectDrawArguments));
+	return drawCount;
+}
@@ -0,0 +1,53 @@
+﻿#include "Base/MeshGeometryBuilder.h"
+
+SubmeshGeometry ToSubmeshGeometry(const MeshSubset& subset)
+{
+	SubmeshGeometry submesh;
+	submesh.IndexCount = subset.IndexCount;
+	submesh.StartIndexLocation = subset.StartIndexLocation;
+	submesh.BaseVertexLocation = subset.BaseVertexLocation;
+	submesh.Bounds = subset.Bounds;
+	submesh.LodLevel = subset.LodLevel;
+	submesh.LodError = subset.LodError;
+	return submesh;
+}
+
+std::unique_ptr<MeshGeometry> CreateMeshGeometry(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const MeshData& mesh)
+{
+	if (device == nullptr || cmdList == nullptr || mesh.Vertices.empty() || mesh.Indices32.empty())
+		return nullptr;
+
+	auto geometry = std::make_unique<MeshGeometry>();
+	geometry->Name = mesh.Name;
+
+	const bool use16BitIndices = mesh.CanUse16BitIndices();
+	std::vector<std::uint16_t> indices16;
+	if (use16BitIndices)
+		indices16 = mesh.GetIndices16();
+	const void* indexData = use16BitIndices ? (const void*)indices16.data() : (const void*)mesh.Indices32.data();
+
+	geometry->VertexByteStride = sizeof(Vertex);
+	geometry->VertexBufferByteSize = (UINT)(mesh.Vertices.size() * sizeof(Vertex));
+	geometry->IndexFormat = use16BitIndices ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	geometry->IndexBufferByteSize = (UINT)(mesh.Indices32.size() * (use16BitIndices ? sizeof(std::uint16_t) : sizeof(std::uint32_t)));
+
+	ThrowIfFailed(D3DCreateBlob(geometry->VertexBufferByteSize, &geometry->VertexBufferCPU));
+	CopyMemory(geometry->VertexBufferCPU->GetBufferPointer(), mesh.Vertices.data(), geometry->VertexBufferByteSize);
+	ThrowIfFailed(D3DCreateBlob(geometry->IndexBufferByteSize, &geometry->IndexBufferCPU));
+	CopyMemory(geometry->IndexBufferCPU->GetBufferPointer(), indexData, geometry->IndexBufferByteSize);
+
+	geometry->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(device, cmdList, mesh.Vertices.data(), geometry->VertexBufferByteSize, geometry->VertexBufferUploader);
+	geometry->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(device, cmdList, indexData, geometry->IndexBufferByteSize, geometry->IndexBufferUploader);
+
+	for (const MeshSubset& subset : mesh.Subsets)
+		geometry->DrawArgs.emplace(subset.Name, ToSubmeshGeometry(subset));
+
+	// 没有子集信息时以网格名绘制全部索引
+	if (geometry->DrawArgs.empty())
+	{
+		SubmeshGeometry submesh;
+		submesh.IndexCount = (UINT)mesh.Indices32.size();
+		geometry->DrawArgs.emplace(mesh.Name, submesh);
+	}
+	return geometry;
+}
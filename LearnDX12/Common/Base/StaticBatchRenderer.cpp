@@ -0,0 +1,156 @@
+﻿#include "Base/StaticBatchRenderer.h"
+#include "Base/MeshGeometryBuilder.h"
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+	std::uint64_t HashBatchInputs(const StaticBatch& batch, const StaticBatchBinding& binding)
+	{
+		const std::uint64_t state[] =
+		{
+			binding.PipelineState, binding.RootSignature, binding.DescriptorHeap, binding.DescriptorTable,
+			binding.VertexBuffer.BufferLocation, binding.VertexBuffer.SizeInBytes, binding.VertexBuffer.StrideInBytes,
+			binding.IndexBuffer.BufferLocation, binding.IndexBuffer.SizeInBytes, binding.IndexBuffer.IndexByteSize,
+		};
+		std::uint64_t hash = HashBundleInputs(state, sizeof(state));
+		for (const MeshSubset& draw : batch.Mesh.Subsets)
+		{
+			const std::uint32_t arguments[] = { draw.IndexCount, draw.StartIndexLocation, (std::uint32_t)draw.BaseVertexLocation };
+			hash = HashBundleInputs(arguments, sizeof(arguments), hash);
+		}
+		return hash;
+	}
+}
+
+void StaticBatchRenderer::Create(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, std::vector<StaticBatch>&& batches,
+	const std::function<StaticBatchBinding(std::uint64_t stateKey)>& resolveState)
+{
+	Batches.clear();
+	Geometries.clear();
+	Bindings.clear();
+	BatchSortIds.clear();
+	BundleInputHashes.clear();
+
+	for (StaticBatch& batch : batches)
+	{
+		std::unique_ptr<MeshGeometry> geometry = CreateMeshGeometry(device, cmdList, batch.Mesh);
+		if (geometry == nullptr)
+			continue;
+
+		StaticBatchBinding binding = resolveState(batch.StateKey);
+		binding.VertexBuffer.BufferLocation = geometry->VertexBufferGPU->GetGPUVirtualAddress();
+		binding.VertexBuffer.SizeInBytes = geometry->VertexBufferByteSize;
+		binding.VertexBuffer.StrideInBytes = geometry->VertexByteStride;
+		binding.IndexBuffer.BufferLocation = geometry->IndexBufferGPU->GetGPUVirtualAddress();
+		binding.IndexBuffer.SizeInBytes = geometry->IndexBufferByteSize;
+		binding.IndexBuffer.IndexByteSize = geometry->IndexFormat == DXGI_FORMAT_R32_UINT ? 4 : 2;
+
+		// GPU上已有一份数据，内存中只保留绘制参数及包围盒
+		batch.Mesh.Vertices = std::vector<Vertex>();
+		batch.Mesh.Indices32 = std::vector<std::uint32_t>();
+		batch.Mesh.Normals = std::vector<XMFLOAT3>();
+		batch.Mesh.TexCoords = std::vector<XMFLOAT2>();
+		batch.Mesh.Tangents = std::vector<XMFLOAT4>();
+
+		Batches.push_back(std::move(batch));
+		Geometries.push_back(std::move(geometry));
+		Bindings.push_back(binding);
+		BatchSortIds.push_back(SortIds{ GetRenderStateId(binding.PipelineState), GetRenderStateId(binding.RootSignature), GetRenderStateId(binding.DescriptorTable) });
+		BundleInputHashes.push_back(HashBatchInputs(Batches.back(), binding));
+	}
+}
+
+std::uint32_t StaticBatchRenderer::Record(CommandRecorder& recorder, const MeshletCullView* pView) const
+{
+	std::uint32_t drawCount = 0;
+	for (std::size_t b = 0; b < Batches.size(); ++b)
+		drawCount += StaticBatcher::Record(recorder, Batches[b], Bindings[b], pView);
+	return drawCount;
+}
+
+void StaticBatchRenderer::Submit(DrawQueue& queue, const MeshletCullView* pView, std::uint32_t pass, float sortDepthRange) const
+{
+	for (std::size_t b = 0; b < Batches.size(); ++b)
+	{
+		const StaticBatchBinding& binding = Bindings[b];
+		const SortIds& ids = BatchSortIds[b];
+
+		DrawPacket packet;
+		packet.PipelineState = binding.PipelineState;
+		packet.RootSignature = binding.RootSignature;
+		packet.DescriptorHeap = binding.DescriptorHeap;
+		packet.DescriptorTable = binding.DescriptorTable;
+		packet.VertexBuffer = binding.VertexBuffer;
+		packet.IndexBuffer = binding.IndexBuffer;
+
+		for (const MeshSubset& draw : Batches[b].Mesh.Subsets)
+		{
+			float depth = 0.0f;
+			if (pView != nullptr)
+			{
+				if (StaticBatcher::IsOutsideFrustum(*pView, draw.Bounds))
+					continue;
+				const XMFLOAT4& nearPlane = pView->Planes[4];
+				depth = nearPlane.x * draw.Bounds.Center.x + nearPlane.y * draw.Bounds.Center.y + nearPlane.z * draw.Bounds.Center.z + nearPlane.w;
+			}
+
+			packet.IndexCount = draw.IndexCount;
+			packet.StartIndexLocation = draw.StartIndexLocation;
+			packet.BaseVertexLocation = draw.BaseVertexLocation;
+			queue.Add(MakeDrawSortKey(pass, ids.PipelineState, ids.RootSignature, ids.Material, QuantizeDrawDepth(depth, sortDepthRange)), packet);
+		}
+	}
+}
+
+void StaticBatchRenderer::BuildIndirectBuckets(std::vector<IndirectDrawBucket>& outBuckets) const
+{
+	for (std::size_t b = 0; b < Batches.size(); ++b)
+	{
+		const StaticBatchBinding& binding = Bindings[b];
+
+		IndirectDrawBucket bucket;
+		bucket.State.PipelineState = binding.PipelineState;
+		bucket.State.RootSignature = binding.RootSignature;
+		bucket.State.DescriptorHeap = binding.DescriptorHeap;
+		bucket.State.DescriptorTable = binding.DescriptorTable;
+		bucket.State.VertexBuffer = binding.VertexBuffer;
+		bucket.State.IndexBuffer = binding.IndexBuffer;
+
+		for (const MeshSubset& draw : Batches[b].Mesh.Subsets)
+		{
+			IndirectDrawArguments arguments;
+			arguments.IndexCountPerInstance = draw.IndexCount;
+			arguments.StartIndexLocation = draw.StartIndexLocation;
+			arguments.BaseVertexLocation = draw.BaseVertexLocation;
+			const XMFLOAT3& extents = draw.Bounds.Extents;
+			const float radius = std::sqrt(extents.x * extents.x + extents.y * extents.y + extents.z * extents.z);
+			bucket.Draws.Add(draw.Bounds.Center, radius, arguments);
+		}
+		outBuckets.push_back(std::move(bucket));
+	}
+}
+
+std::uint32_t StaticBatchRenderer::ExecuteBundles(BundleCache& cache, CommandRecorder& recorder, std::uint64_t firstBundleId) const
+{
+	std::uint32_t bundleCount = 0;
+	for (std::size_t b = 0; b < Batches.size(); ++b)
+	{
+		const StaticBatch& batch = Batches[b];
+		const StaticBatchBinding& binding = Bindings[b];
+		if (batch.Mesh.Subsets.empty())
+			continue;
+
+		const RenderHandle bundle = cache.GetOrRecord(firstBundleId + b, BundleInputHashes[b], [&](CommandRecorder& bundleRecorder)
+		{
+			StaticBatcher::Record(bundleRecorder, batch, binding);
+		});
+
+		// Bundle中设置的描述符堆需与调用方一致
+		recorder.SetDescriptorHeap(binding.DescriptorHeap);
+		recorder.ExecuteBundle(bundle);
+		++bundleCount;
+	}
+	return bundleCount;
+}
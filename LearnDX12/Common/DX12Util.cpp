@@ -1,5 +1,6 @@
 ﻿
 #include "DX12Util.h"
+#include "Profile/RenderCounters.h"
 #include <comdef.h>
 #include <fstream>
 
@@ -85,6 +86,10 @@ Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
 		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ);
 	cmdList->ResourceBarrier(1, &defaultResBarrier1);
 
+	CountRender(RenderCounter::ResourcesCreated, 2);
+	CountRender(RenderCounter::UploadBytes, byteSize);
+	CountRender(RenderCounter::Barriers, 2);
+
 	// Note: uploadBuffer has to be kept alive after the above function calls because
 	// the command list has not been executed yet that performs the actual copy.
 	// The caller can Release the uploadBuffer after it knows the copy has been executed.
@@ -1,6 +1,8 @@
 ﻿#include <WindowsX.h>
 #include <DirectXColors.h>
 #include "DXRenderDeviceManager.h"
+#include "Profile/CpuProfiler.h"
+#include "Profile/RenderCounters.h"
 
 
 
@@ -99,6 +101,7 @@ void DXRenderDeviceManager::Clear(SystemTimer& Timer, ID3D12PipelineState* pPipe
 	CD3DX12_RESOURCE_BARRIER currentBackBufferResBarrier = CD3DX12_RESOURCE_BARRIER::Transition(BackgroundBuffer[CurrBackBuffer].Get(),
 		D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
 	CommandList->ResourceBarrier(1, &currentBackBufferResBarrier);
+	CountRender(RenderCounter::Barriers);
 
 	// 设置视口及裁剪矩形
 	CommandList->RSSetViewports(1, &ScreenViewport);
@@ -121,6 +124,7 @@ void DXRenderDeviceManager::Present(SystemTimer& Timer)
 		D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
 
 	CommandList->ResourceBarrier(1, &currentBackBufferResBarrier);
+	CountRender(RenderCounter::Barriers);
 
 	// 关闭命令列表(完成本帧内的命令写入)
 	ThrowIfFailed(CommandList->Close());
@@ -135,6 +139,9 @@ void DXRenderDeviceManager::Present(SystemTimer& Timer)
 
 	// 等待GPU完成所有命令队列中的指令后CPU继续执行
 	FlushCommandQueue();
+
+	// 本帧的渲染计数
+	RenderCounters::GetInstance().EndFrame();
 }
 
 void DXRenderDeviceManager::ResetCommandList(ID3D12PipelineState* pPipelineState)
@@ -208,6 +215,8 @@ void DXRenderDeviceManager::ExecuteCommandQueue()
 
 void DXRenderDeviceManager::FlushCommandQueue()
 {
+	CPU_PROFILE_SCOPE("FlushCommandQueue");
+
 	// 更新CPU/GPU同步围栏值，带GPU完成此前所有命令列表中命令后CPU继续
 	CurrentFence++;
 
@@ -225,6 +234,7 @@ void DXRenderDeviceManager::FlushCommandQueue()
 		// CPU等待GPU执行完成
 		WaitForSingleObject(eventHandle, INFINITE);
 		CloseHandle(eventHandle);
+		CountRender(RenderCounter::FenceWaits);
 	}
 }
 
@@ -425,6 +435,7 @@ void DXRenderDeviceManager::CreateBufferDescriptor()
 		D3D12_RESOURCE_STATE_COMMON,	// 由于DX中每个资源在任何时刻都会标明其当前所处在渲染流水线中的状态，此处为该资源的默认初始状态
 		&optClear,	// 清理该资源时的清理值信息
 		IID_PPV_ARGS(DepthStencilBuffer.GetAddressOf())));		// 创建返回的深度模板缓冲区
+	CountRender(RenderCounter::ResourcesCreated);
 
 	// 与后台缓冲区的描述符创建方式(CreateRenderTarget)类似，使用CreateDepthStencilView创建深度/模板缓冲区描述符
 	D3DDevice->CreateDepthStencilView(DepthStencilBuffer.Get(), nullptr, DSVHeap->GetCPUDescriptorHandleForHeapStart());
@@ -433,6 +444,7 @@ void DXRenderDeviceManager::CreateBufferDescriptor()
 		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_DEPTH_WRITE);
 	// 将后台缓冲区资源从初始状态设置为写入状态，等待渲染命令对列表写入深度信息
 	CommandList->ResourceBarrier(1, &depthStencilResBarrier);
+	CountRender(RenderCounter::Barriers);
 }
 
 D3D12_CPU_DESCRIPTOR_HANDLE DXRenderDeviceManager::GetCurrentBackBufferDescriptor()
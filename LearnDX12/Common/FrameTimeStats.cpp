@@ -0,0 +1,202 @@
+﻿#include "FrameTimeStats.h"
+#include <algorithm>
+
+namespace
+{
+	const std::uint32_t SubBucketCount = 1u << FrameTimeStats::SubBucketBits;
+	const std::uint32_t SubBucketHalf = SubBucketCount / 2;
+	const std::size_t BucketCount = SubBucketCount + (FrameTimeStats::MaxMagnitude - FrameTimeStats::SubBucketBits) * SubBucketHalf;
+}
+
+FrameTimeStats::FrameTimeStats(const FrameTimeStatsOptions& options)
+	: Options(options)
+{
+	if (Options.HistorySize == 0)
+		Options.HistorySize = 1;
+	if (Options.MedianWindow == 0)
+		Options.MedianWindow = 1;
+	Reset();
+}
+
+std::size_t FrameTimeStats::GetBucketIndex(std::uint64_t microseconds)
+{
+	const std::uint64_t maxValue = (1ull << MaxMagnitude) - 1;
+	const std::uint64_t value = microseconds < maxValue ? microseconds : maxValue;
+	if (value < SubBucketCount)
+		return (std::size_t)value;
+
+	// 最高位之后保留SubBucketBits - 1位
+	std::uint32_t msb = SubBucketBits;
+	while ((value >> (msb + 1)) != 0)
+		++msb;
+	const std::uint32_t shift = msb - (SubBucketBits - 1);
+	const std::uint64_t sub = value >> shift;
+	return SubBucketCount + (std::size_t)(shift - 1) * SubBucketHalf + (std::size_t)(sub - SubBucketHalf);
+}
+
+std::uint64_t FrameTimeStats::GetBucketLowerBound(std::size_t index)
+{
+	if (index < SubBucketCount)
+		return index;
+	const std::size_t k = index - SubBucketCount;
+	const std::uint32_t shift = (std::uint32_t)(k / SubBucketHalf) + 1;
+	return (std::uint64_t)(SubBucketHalf + k % SubBucketHalf) << shift;
+}
+
+std::uint64_t FrameTimeStats::GetBucketUpperBound(std::size_t index)
+{
+	if (index < SubBucketCount)
+		return index;
+	const std::size_t k = index - SubBucketCount;
+	const std::uint32_t shift = (std::uint32_t)(k / SubBucketHalf) + 1;
+	return ((std::uint64_t)(SubBucketHalf + k % SubBucketHalf + 1) << shift) - 1;
+}
+
+void FrameTimeStats::Reset()
+{
+	Buckets.assign(BucketCount, 0);
+	History.clear();
+	History.reserve(Options.HistorySize);
+	HistoryNext = 0;
+	FrameCount = 0;
+	HitchCount = 0;
+	TotalMilliseconds = 0.0;
+	MinMilliseconds = 0.0;
+	MaxMilliseconds = 0.0;
+	RollingMedian = 0.0;
+}
+
+std::size_t FrameTimeStats::GetHistoryCount() const
+{
+	return History.size();
+}
+
+std::size_t FrameTimeStats::GetHistoryPosition(std::size_t index) const
+{
+	// 历史未写满时HistoryNext为0，最旧的帧位于开头
+	return History.size() < Options.HistorySize ? index : (HistoryNext + index) % History.size();
+}
+
+double FrameTimeStats::GetHistoryMilliseconds(std::size_t index) const
+{
+	return History[GetHistoryPosition(index)].Milliseconds;
+}
+
+bool FrameTimeStats::IsHistoryHitch(std::size_t index) const
+{
+	return History[GetHistoryPosition(index)].Hitch;
+}
+
+double FrameTimeStats::ComputeRollingMedian()
+{
+	const std::size_t count = std::min(Options.MedianWindow, History.size());
+	MedianScratch.resize(count);
+	for (std::size_t i = 0; i < count; ++i)
+		MedianScratch[i] = (float)GetHistoryMilliseconds(History.size() - count + i);
+
+	auto middle = MedianScratch.begin() + count / 2;
+	std::nth_element(MedianScratch.begin(), middle, MedianScratch.end());
+	return *middle;
+}
+
+bool FrameTimeStats::AddFrame(double seconds)
+{
+	const double milliseconds = seconds > 0.0 ? seconds * 1000.0 : 0.0;
+
+	// 窗口内的帧数达到一半后才检测卡顿，避免启动时的几帧误判
+	bool hitch = false;
+	if (History.size() * 2 >= Options.MedianWindow && !History.empty())
+	{
+		RollingMedian = ComputeRollingMedian();
+		hitch = milliseconds > RollingMedian * Options.HitchFactor && milliseconds - RollingMedian >= Options.MinHitchMilliseconds;
+	}
+
+	const HistoryEntry entry = { (float)milliseconds, hitch };
+	if (History.size() < Options.HistorySize)
+	{
+		History.push_back(entry);
+	}
+	else
+	{
+		History[HistoryNext] = entry;
+		HistoryNext = (HistoryNext + 1) % History.size();
+	}
+
+	++Buckets[GetBucketIndex((std::uint64_t)(milliseconds * 1000.0 + 0.5))];
+	MinMilliseconds = FrameCount == 0 ? milliseconds : std::min(MinMilliseconds, milliseconds);
+	MaxMilliseconds = FrameCount == 0 ? milliseconds : std::max(MaxMilliseconds, milliseconds);
+	TotalMilliseconds += milliseconds;
+	++FrameCount;
+	if (hitch)
+		++HitchCount;
+	return hitch;
+}
+
+double FrameTimeStats::GetPercentileMilliseconds(double p) const
+{
+	if (FrameCount == 0)
+		return 0.0;
+
+	p = p < 0.0 ? 0.0 : (p > 1.0 ? 1.0 : p);
+	std::uint64_t target = (std::uint64_t)(p * (double)FrameCount + 0.999999);
+	if (target == 0)
+		target = 1;
+
+	std::uint64_t cumulative = 0;
+	for (std::size_t i = 0; i < Buckets.size(); ++i)
+	{
+		cumulative += Buckets[i];
+		if (cumulative >= target)
+		{
+			// 区间中点，并限制在实际记录的范围内
+			const double value = (double)(GetBucketLowerBound(i) + GetBucketUpperBound(i)) * 0.5 / 1000.0;
+			return std::min(std::max(value, MinMilliseconds), MaxMilliseconds);
+		}
+	}
+	return MaxMilliseconds;
+}
+
+FrameTimeSummary FrameTimeStats::GetSummary() const
+{
+	FrameTimeSummary summary;
+	summary.FrameCount = FrameCount;
+	summary.HitchCount = HitchCount;
+	summary.MinMilliseconds = MinMilliseconds;
+	summary.MaxMilliseconds = MaxMilliseconds;
+	summary.MeanMilliseconds = FrameCount > 0 ? TotalMilliseconds / (double)FrameCount : 0.0;
+	summary.P50Milliseconds = GetPercentileMilliseconds(0.50);
+	summary.P95Milliseconds = GetPercentileMilliseconds(0.95);
+	summary.P99Milliseconds = GetPercentileMilliseconds(0.99);
+	return summary;
+}
+
+void FrameTimeStats::WriteCsv(std::ostream& stream) const
+{
+	stream << "frame,ms,hitch\n";
+	const std::uint64_t firstFrame = FrameCount - History.size();
+	for (std::size_t i = 0; i < History.size(); ++i)
+		stream << firstFrame + i << ',' << GetHistoryMilliseconds(i) << ',' << (IsHistoryHitch(i) ? 1 : 0) << '\n';
+}
+
+void FrameTimeStats::WriteJson(std::ostream& stream) const
+{
+	const FrameTimeSummary summary = GetSummary();
+	stream << "{\"frames\":" << summary.FrameCount
+		<< ",\"hitches\":" << summary.HitchCount
+		<< ",\"min_ms\":" << summary.MinMilliseconds
+		<< ",\"max_ms\":" << summary.MaxMilliseconds
+		<< ",\"mean_ms\":" << summary.MeanMilliseconds
+		<< ",\"p50_ms\":" << summary.P50Milliseconds
+		<< ",\"p95_ms\":" << summary.P95Milliseconds
+		<< ",\"p99_ms\":" << summary.P99Milliseconds
+		<< ",\"histogram\":[";
+	bool first = true;
+	for (std::size_t i = 0; i < Buckets.size(); ++i)
+	{
+		if (Buckets[i] == 0)
+			continue;
+		stream << (first ? "" : ",") << "{\"lower_us\":" << GetBucketLowerBound(i) << ",\"upper_us\":" << GetBucketUpperBound(i) << ",\"count\":" << Buckets[i] << "}";
+		first = false;
+	}
+	stream << "]}\n";
+}
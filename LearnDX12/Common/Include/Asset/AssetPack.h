@@ -0,0 +1,262 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+*	资源包(AssetPack)文件格式
+*
+*	+---------------------+  0
+*	| AssetPackHeader     |
+*	+---------------------+  sizeof(AssetPackHeader)
+*	| BucketTable         |  (BucketCount + 1) 个uint32，按Hash高位分桶后每个桶在EntryTable中的起始下标
+*	+---------------------+
+*	| EntryTable          |  EntryCount 个AssetPackEntry，按NameHash升序排列
+*	+---------------------+  按PayloadAlignment对齐
+*	| Payload 0           |
+*	+---------------------+  按PayloadAlignment对齐
+*	| Payload 1 ...       |
+*	+---------------------+
+*
+*	整个文件可以直接映射(mmap/MapViewOfFile)到内存中使用，查找时先用Hash高位定位桶，
+*	再在桶内(通常只有1~2个条目)线性比较，因此查找的期望复杂度为O(1)。
+*	未压缩的条目可直接从映射视图中取得数据指针，无需任何解析或拷贝。
+*/
+
+// 文件标识 'LDPK'
+#define ASSETPACK_MAGIC		0x4B50444C
+#define ASSETPACK_VERSION	5
+// 默认负载对齐(与D3D12常量缓冲区/缓冲区放置对齐一致，方便直接上传)
+#define ASSETPACK_DEFAULT_ALIGNMENT	256
+
+// 资源类型
+enum class AssetType : std::uint32_t
+{
+	Raw = 0,
+	Mesh = 1,
+	Shader = 2,
+};
+
+// 条目压缩方式
+enum class AssetCompression : std::uint32_t
+{
+	None = 0,
+	LZ = 1,
+};
+
+struct AssetPackHeader
+{
+	std::uint32_t Magic = ASSETPACK_MAGIC;
+	std::uint32_t Version = ASSETPACK_VERSION;
+	std::uint32_t EntryCount = 0;
+	std::uint32_t BucketCount = 0;			// 2的幂
+	std::uint32_t PayloadAlignment = ASSETPACK_DEFAULT_ALIGNMENT;
+	std::uint32_t Reserved = 0;
+	std::uint64_t EntryTableOffset = 0;
+	std::uint64_t FileSize = 0;
+};
+
+struct AssetPackEntry
+{
+	std::uint64_t NameHash = 0;
+	std::uint64_t Offset = 0;				// 负载在文件中的偏移
+	std::uint64_t StoredSize = 0;			// 负载在文件中的大小(压缩后)
+	std::uint64_t RawSize = 0;				// 负载解压后的大小
+	AssetType Type = AssetType::Raw;
+	AssetCompression Compression = AssetCompression::None;
+};
+
+/**
+*	Mesh类型负载的布局
+*	MeshAssetHeader | MeshAssetSubset[SubsetCount] | MeshAssetMeshlet[MeshletCount] | (对齐)VertexData | (对齐)IndexData
+*	VertexDataOffset/IndexDataOffset均相对于负载起始位置
+*	VertexEncoding/IndexEncoding为MeshDataEncoding::Codec时对应的数据为Mesh/MeshCodec.h编码后的数据，
+*	加载时由MeshAssetView::DecodeVertexData/DecodeIndexData直接解码到上传缓冲区中；
+*	顶点与索引分别决定是否编码，编码后没有变小的数据保持原样
+*/
+
+// Mesh负载中顶点/索引数据的存储方式
+enum class MeshDataEncoding : std::uint32_t
+{
+	None = 0,
+	Codec = 1,
+};
+
+struct MeshAssetHeader
+{
+	std::uint32_t VertexByteStride = 0;
+	std::uint32_t VertexCount = 0;
+	std::uint32_t IndexByteSize = 2;		// 2: R16_UINT  4: R32_UINT
+	std::uint32_t IndexCount = 0;
+	std::uint32_t SubsetCount = 0;
+	std::uint32_t VertexFormat = 0;			// 顶点格式标识(VertexFormat<...>::GetId())，0表示与Vertex相同的格式
+	std::uint32_t MeshletCount = 0;			// 0表示没有Meshlet剔除数据
+	MeshDataEncoding VertexEncoding = MeshDataEncoding::None;
+	MeshDataEncoding IndexEncoding = MeshDataEncoding::None;
+	std::uint32_t Reserved = 0;
+	std::uint64_t VertexDataOffset = 0;
+	std::uint64_t IndexDataOffset = 0;
+	std::uint64_t VertexDataStoredSize = 0;	// 顶点/索引数据在负载中的大小(编码后)
+	std::uint64_t IndexDataStoredSize = 0;
+};
+
+struct MeshAssetSubset
+{
+	std::uint64_t NameHash = 0;
+	std::uint32_t IndexCount = 0;
+	std::uint32_t StartIndexLocation = 0;
+	std::int32_t BaseVertexLocation = 0;
+	float BoundsCenter[3] = { 0.0f, 0.0f, 0.0f };
+	float BoundsExtents[3] = { 0.0f, 0.0f, 0.0f };
+	std::uint32_t LodLevel = 0;				// LOD级别，各级LOD的子集位于同一个索引缓冲区中
+	float LodError = 0.0f;					// 相对于LOD0的最大几何误差(模型空间距离)
+};
+
+// Meshlet在索引缓冲区中的范围及剔除数据(见Mesh/Meshlet.h)
+struct MeshAssetMeshlet
+{
+	std::uint32_t IndexCount = 0;
+	std::uint32_t StartIndexLocation = 0;
+	std::int32_t BaseVertexLocation = 0;
+	float Center[3] = { 0.0f, 0.0f, 0.0f };
+	float Radius = 0.0f;
+	float ConeAxis[3] = { 0.0f, 0.0f, 1.0f };
+	float ConeCutoff = 1.0f;
+};
+
+// 从映射视图中直接取得的Mesh数据(指针指向映射内存，生命周期与AssetPackReader一致)
+struct MeshAssetView
+{
+	const MeshAssetHeader* Header = nullptr;
+	const MeshAssetSubset* Subsets = nullptr;
+	const MeshAssetMeshlet* Meshlets = nullptr;
+	const void* VertexData = nullptr;
+	const void* IndexData = nullptr;
+
+	std::uint64_t VertexDataByteSize() const { return (std::uint64_t)Header->VertexByteStride * Header->VertexCount; }
+	std::uint64_t IndexDataByteSize() const { return (std::uint64_t)Header->IndexByteSize * Header->IndexCount; }
+
+	// 顶点/索引数据是否需要解码(未编码时VertexData/IndexData可直接作为上传数据)
+	bool IsVertexDataEncoded() const { return Header->VertexEncoding != MeshDataEncoding::None; }
+	bool IsIndexDataEncoded() const { return Header->IndexEncoding != MeshDataEncoding::None; }
+
+	// 将顶点/索引数据解码或拷贝到dst(VertexDataByteSize()/IndexDataByteSize()字节，eg: Upload堆缓冲区的映射内存)
+	bool DecodeVertexData(void* dst) const;
+	bool DecodeIndexData(void* dst) const;
+};
+
+// 资源名Hash(FNV-1a 64位)
+std::uint64_t AssetHash(const void* data, std::size_t byteSize, std::uint64_t seed = 0xcbf29ce484222325ull);
+std::uint64_t AssetNameHash(const std::string& name);
+
+// 简单的LZ77字节压缩/解压(用于可选的条目压缩)
+std::vector<std::uint8_t> AssetCompressLZ(const void* data, std::size_t byteSize);
+bool AssetDecompressLZ(const void* src, std::size_t srcSize, void* dst, std::size_t dstSize);
+
+
+// 资源包构建器
+class AssetPackBuilder
+{
+public:
+
+	explicit AssetPackBuilder(std::uint32_t payloadAlignment = ASSETPACK_DEFAULT_ALIGNMENT);
+
+	// 添加任意数据条目，compression为LZ时若压缩无收益则自动退化为不压缩
+	bool	AddEntry(const std::string& name, AssetType type, const void* data, std::size_t byteSize,
+		AssetCompression compression = AssetCompression::None);
+
+	// 添加Mesh条目(顶点/索引数据在负载内按PayloadAlignment对齐，便于直接上传)
+	bool	AddMesh(const std::string& name,
+		const void* vertexData, std::uint32_t vertexByteStride, std::uint32_t vertexCount, std::uint32_t vertexFormat,
+		const void* indexData, std::uint32_t indexByteSize, std::uint32_t indexCount,
+		const std::vector<MeshAssetSubset>& subsets, const std::vector<MeshAssetMeshlet>& meshlets,
+		MeshDataEncoding encoding = MeshDataEncoding::None,
+		AssetCompression compression = AssetCompression::None);
+
+	// 按Mesh负载布局序列化顶点/索引数据(离线工具可缓存该负载后以AddEntry加入资源包)
+	static bool	BuildMeshPayload(std::vector<std::uint8_t>& outPayload,
+		const void* vertexData, std::uint32_t vertexByteStride, std::uint32_t vertexCount, std::uint32_t vertexFormat,
+		const void* indexData, std::uint32_t indexByteSize, std::uint32_t indexCount,
+		const std::vector<MeshAssetSubset>& subsets, const std::vector<MeshAssetMeshlet>& meshlets,
+		MeshDataEncoding encoding = MeshDataEncoding::None,
+		std::uint32_t payloadAlignment = ASSETPACK_DEFAULT_ALIGNMENT);
+
+	// 将所有条目写入文件
+	bool	WriteToFile(const std::string& filename) const;
+
+	// 将所有条目序列化到内存
+	void	WriteToMemory(std::vector<std::uint8_t>& outData) const;
+
+	std::size_t	GetEntryCount() const { return Entries.size(); }
+
+private:
+
+	struct PendingEntry
+	{
+		AssetPackEntry Entry;
+		std::vector<std::uint8_t> Payload;
+	};
+
+	std::vector<PendingEntry> Entries;
+	std::uint32_t PayloadAlignment = ASSETPACK_DEFAULT_ALIGNMENT;
+};
+
+
+// 资源包读取器(映射整个文件，条目查找不做任何内存分配)
+class AssetPackReader
+{
+public:
+
+	AssetPackReader() = default;
+	~AssetPackReader();
+
+	AssetPackReader(const AssetPackReader& rhs) = delete;
+	AssetPackReader& operator=(const AssetPackReader& rhs) = delete;
+
+	// 映射资源包文件
+	bool	Open(const std::string& filename);
+
+	// 使用外部内存(不拷贝，调用者需保证内存生命周期)
+	bool	OpenFromMemory(const void* data, std::size_t byteSize);
+
+	void	Close();
+
+	bool	IsOpen() const { return Header != nullptr; }
+
+	// 按名字/Hash查找条目，未找到返回nullptr
+	const AssetPackEntry*	FindEntry(std::uint64_t nameHash) const;
+	const AssetPackEntry*	FindEntry(const std::string& name) const { return FindEntry(AssetNameHash(name)); }
+
+	// 获取未压缩条目在映射视图中的数据指针，压缩条目返回nullptr
+	const void*	GetEntryData(const AssetPackEntry& entry) const;
+
+	// 读取(必要时解压)条目数据
+	bool	ReadEntry(const AssetPackEntry& entry, std::vector<std::uint8_t>& outData) const;
+
+	// 从映射视图直接获取Mesh数据(仅支持未压缩的Mesh条目)
+	bool	FindMesh(const std::string& name, MeshAssetView& outView) const;
+
+	// 从已解压的Mesh负载中解析Mesh数据
+	static bool	ParseMeshPayload(const void* payload, std::uint64_t payloadSize, MeshAssetView& outView);
+
+	std::uint32_t	GetEntryCount() const { return Header ? Header->EntryCount : 0; }
+	const AssetPackEntry*	GetEntries() const { return Entries; }
+
+private:
+
+	bool	ValidateAndBind(const std::uint8_t* data, std::size_t byteSize);
+
+	const std::uint8_t* MappedData = nullptr;
+	std::size_t MappedSize = 0;
+
+	const AssetPackHeader* Header = nullptr;
+	const std::uint32_t* Buckets = nullptr;
+	const AssetPackEntry* Entries = nullptr;
+	std::uint32_t BucketBits = 0;
+
+	// 平台相关的文件映射句柄
+	void* FileHandle = nullptr;
+	void* MappingHandle = nullptr;
+	bool OwnsMapping = false;
+};
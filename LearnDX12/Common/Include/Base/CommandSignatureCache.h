@@ -0,0 +1,28 @@
+﻿#pragma once
+#include <cstdint>
+#include <map>
+#include <utility>
+#include "DX12Util.h"
+
+/**
+*	ExecuteIndirect使用的命令签名缓存
+*	命令参数为IndirectDrawArguments布局(步长24字节)：可选的1个32位根常量 + DrawIndexed。
+*	不使用根常量的签名与根签名无关，所有根签名共用一个。
+*/
+class CommandSignatureCache
+{
+public:
+
+	// rootConstantParameterIndex为nullptr时不包含根常量
+	ID3D12CommandSignature*	Get(ID3D12Device* device, ID3D12RootSignature* rootSignature, const std::uint32_t* rootConstantParameterIndex);
+
+	void	Clear() { Signatures.clear(); }
+
+private:
+
+	// (根签名, 根常量的根参数索引)，不使用根常量时为(nullptr, NoRootConstant)
+	using Key = std::pair<ID3D12RootSignature*, std::uint32_t>;
+	static const std::uint32_t NoRootConstant = 0xFFFFFFFFu;
+
+	std::map<Key, Microsoft::WRL::ComPtr<ID3D12CommandSignature>> Signatures;
+};
@@ -0,0 +1,37 @@
+﻿#pragma once
+#include <memory>
+#include <unordered_map>
+#include "DX12Util.h"
+#include "Base/D3D12CommandRecorder.h"
+#include "Render/BundleCache.h"
+
+/**
+*	D3D12_COMMAND_LIST_TYPE_BUNDLE的创建与释放
+*	每个Bundle使用独立的命令分配器，释放Bundle时一并释放。
+*/
+class D3D12BundleBackend : public BundleBackend
+{
+public:
+
+	explicit D3D12BundleBackend(ID3D12Device* device)
+		: Device(device)
+	{
+	}
+
+	CommandRecorder&	BeginBundle() override;
+	RenderHandle	EndBundle() override;
+	void	ReleaseBundle(RenderHandle bundle) override;
+
+private:
+
+	struct Bundle
+	{
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> Allocator;
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> CommandList;
+	};
+
+	ID3D12Device* Device = nullptr;
+	Bundle Recording;
+	std::unique_ptr<D3D12CommandRecorder> Recorder;
+	std::unordered_map<RenderHandle, Bundle> Bundles;
+};
@@ -0,0 +1,107 @@
+﻿#pragma once
+#include "DX12Util.h"
+#include "Profile/RenderCounters.h"
+#include "Render/CommandRecorder.h"
+
+// 转发到ID3D12GraphicsCommandList的录制实现
+class D3D12CommandRecorder : public CommandRecorder
+{
+public:
+
+	explicit D3D12CommandRecorder(ID3D12GraphicsCommandList* commandList)
+		: CommandList(commandList)
+	{
+	}
+
+	void SetPipelineState(RenderHandle pipelineState) override
+	{
+		CommandList->SetPipelineState(reinterpret_cast<ID3D12PipelineState*>(pipelineState));
+		CountRender(RenderCounter::PipelineStateChanges);
+	}
+
+	void SetGraphicsRootSignature(RenderHandle rootSignature) override
+	{
+		CommandList->SetGraphicsRootSignature(reinterpret_cast<ID3D12RootSignature*>(rootSignature));
+		CountRender(RenderCounter::RootSignatureChanges);
+	}
+
+	void SetDescriptorHeap(RenderHandle descriptorHeap) override
+	{
+		ID3D12DescriptorHeap* descriptorHeaps[] = { reinterpret_cast<ID3D12DescriptorHeap*>(descriptorHeap) };
+		CommandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
+		CountRender(RenderCounter::DescriptorHeapChanges);
+	}
+
+	void SetGraphicsRootDescriptorTable(std::uint32_t rootParameterIndex, RenderHandle baseDescriptor) override
+	{
+		D3D12_GPU_DESCRIPTOR_HANDLE handle;
+		handle.ptr = baseDescriptor;
+		CommandList->SetGraphicsRootDescriptorTable(rootParameterIndex, handle);
+	}
+
+	void SetVertexBuffer(const VertexBufferBinding& binding) override
+	{
+		D3D12_VERTEX_BUFFER_VIEW view;
+		view.BufferLocation = binding.BufferLocation;
+		view.SizeInBytes = binding.SizeInBytes;
+		view.StrideInBytes = binding.StrideInBytes;
+		CommandList->IASetVertexBuffers(0, 1, &view);
+	}
+
+	void SetIndexBuffer(const IndexBufferBinding& binding) override
+	{
+		D3D12_INDEX_BUFFER_VIEW view;
+		view.BufferLocation = binding.BufferLocation;
+		view.SizeInBytes = binding.SizeInBytes;
+		view.Format = binding.IndexByteSize == 4 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+		CommandList->IASetIndexBuffer(&view);
+	}
+
+	void SetPrimitiveTopology(std::uint32_t topology) override
+	{
+		CommandList->IASetPrimitiveTopology((D3D12_PRIMITIVE_TOPOLOGY)topology);
+	}
+
+	void SetGraphicsRoot32BitConstant(std::uint32_t rootParameterIndex, std::uint32_t value, std::uint32_t destOffsetIn32BitValues) override
+	{
+		CommandList->SetGraphicsRoot32BitConstant(rootParameterIndex, value, destOffsetIn32BitValues);
+	}
+
+	void DrawIndexedInstanced(std::uint32_t indexCount, std::uint32_t instanceCount, std::uint32_t startIndexLocation,
+		std::int32_t baseVertexLocation, std::uint32_t startInstanceLocation) override
+	{
+		CommandList->DrawIndexedInstanced(indexCount, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
+		CountRender(RenderCounter::DrawCalls);
+	}
+
+	void ExecuteIndirect(RenderHandle commandSignature, std::uint32_t maxCommandCount, RenderHandle argumentBuffer, std::uint64_t argumentBufferOffset) override
+	{
+		CommandList->ExecuteIndirect(reinterpret_cast<ID3D12CommandSignature*>(commandSignature), maxCommandCount,
+			reinterpret_cast<ID3D12Resource*>(argumentBuffer), argumentBufferOffset, nullptr, 0);
+		CountRender(RenderCounter::DrawCalls);
+	}
+
+	void ExecuteBundle(RenderHandle bundle) override
+	{
+		CommandList->ExecuteBundle(reinterpret_cast<ID3D12GraphicsCommandList*>(bundle));
+	}
+
+	ID3D12GraphicsCommandList* GetCommandList() const { return CommandList; }
+
+private:
+
+	ID3D12GraphicsCommandList* CommandList = nullptr;
+};
+
+// D3D12对象/描述符转换为录制接口的句柄
+inline RenderHandle ToRenderHandle(ID3D12DeviceChild* object)
+{
+	return (RenderHandle)reinterpret_cast<std::uintptr_t>(object);
+}
+
+inline RenderHandle ToRenderHandle(D3D12_GPU_DESCRIPTOR_HANDLE handle)
+{
+	return handle.ptr;
+}
+
+static_assert(PrimitiveTopologyTriangleList == D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST, "topology values follow D3D_PRIMITIVE_TOPOLOGY");
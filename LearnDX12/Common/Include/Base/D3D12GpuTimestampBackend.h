@@ -0,0 +1,33 @@
+﻿#pragma once
+#include "DX12Util.h"
+#include "Profile/GpuProfiler.h"
+
+/**
+*	D3D12_QUERY_HEAP_TYPE_TIMESTAMP查询堆及回读缓冲区
+*	时间戳写入构造时指定的命令列表(需为直接或计算队列的命令列表)，频率取自提交该命令列表的命令队列。
+*/
+class D3D12GpuTimestampBackend : public GpuTimestampBackend
+{
+public:
+
+	D3D12GpuTimestampBackend(ID3D12Device* device, ID3D12CommandQueue* commandQueue, ID3D12GraphicsCommandList* commandList);
+
+	// 之后的时间戳写入commandList
+	void	SetCommandList(ID3D12GraphicsCommandList* commandList) { CommandList = commandList; }
+
+	void	CreateQueries(std::uint32_t queryCount) override;
+	void	WriteTimestamp(std::uint32_t query) override;
+	void	ResolveTimestamps(std::uint32_t first, std::uint32_t count) override;
+	bool	ReadTimestamps(std::uint32_t first, std::uint32_t count, std::uint64_t* outTicks) override;
+	std::uint64_t	GetTimestampFrequency() const override { return Frequency; }
+
+private:
+
+	ID3D12Device* Device = nullptr;
+	ID3D12GraphicsCommandList* CommandList = nullptr;
+	UINT64 Frequency = 0;
+
+	Microsoft::WRL::ComPtr<ID3D12QueryHeap> QueryHeap;
+	// 回读堆上的缓冲区，每个查询8字节
+	Microsoft::WRL::ComPtr<ID3D12Resource> ReadbackBuffer;
+};
@@ -1,10 +1,15 @@
 ﻿#pragma once
+#include <functional>
 #include <string>
 #include <DirectXMath.h>
 #include "DX12Util.h"
 #include "UploadBuffer.h"
 #include "MathHelper.h"
 #include "SystemTimer.h"
+#include "Asset/AssetPack.h"
+#include "Mesh/MeshData.h"
+#include "Mesh/Meshlet.h"
+#include "Render/DrawQueue.h"
 using namespace DirectX;
 
 struct ObjectConstants
@@ -12,12 +17,6 @@ struct ObjectConstants
 	XMFLOAT4X4 WorldViewProj = MathHelper::Identity4x4();
 };
 
-struct Vertex
-{
-	XMFLOAT3 Pos;
-	XMFLOAT4 Color;
-};
-
 struct Geometry
 {
 public:
@@ -37,6 +36,22 @@ public:
 	D3D12_VERTEX_BUFFER_VIEW	VertexBufferView;
 	// 顶点索引缓冲区描述符
 	D3D12_INDEX_BUFFER_VIEW		IndexBufferView;
+	// 绘制的子集(超过65536个顶点的模型被拆分为多个使用16位索引的子集，各子集有各自的BaseVertexLocation)
+	std::vector<SubmeshGeometry>	Submeshes;
+	// 资源包中带有Meshlet剔除数据时，每帧剔除不可见的Meshlet后按合并的索引范围绘制(只使用Meshlets/Bounds)
+	MeshletData						Meshlets;
+	std::vector<MeshletDrawRange>	VisibleRanges;
+	MeshletCullStats				LastCullStats;
+	// 最近一次设置的WorldViewProj矩阵，用于在模型空间中剔除Meshlet及选择LOD
+	XMFLOAT4X4						WorldViewProj = MathHelper::Identity4x4();
+
+	// 各级LOD的最大几何误差(LodErrors[0]为0)，投影到屏幕上不超过LodPixelError像素的最低LOD被选中
+	std::vector<float>				LodErrors;
+	UINT							CurrentLod = 0;
+	float							LodPixelError = 1.0f;
+	float							ViewportHeight = 768.0f;
+	// LOD0所有子集的包围球，用于估计模型到相机的最近距离
+	BoundingSphere					LodBounds;
 
 	// 在显存级别为顶点/索引创建的缓冲区资源(Upload堆内存储的缓冲区，用于快速高效接受从内存传输而来的数据)
 	// 因此一般用此缓冲区接受内存上传的数据，然后将此缓冲区的数据拷贝的Default堆内存的缓冲区VertexBufferGPU/IndexBufferGPU
@@ -58,6 +73,12 @@ public:
 
 	ComPtr<ID3D12PipelineState> PSO = nullptr;
 
+	// 绘制排序键中的状态编号(创建PSO时分配)及深度字段对应的最大深度
+	std::uint32_t PipelineStateId = 0;
+	std::uint32_t RootSignatureId = 0;
+	std::uint32_t MaterialId = 0;
+	float SortDepthRange = 1000.0f;
+
 	DXGI_FORMAT BackBufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
 	DXGI_FORMAT DepthStencilFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
 
@@ -68,25 +89,38 @@ public:
 	// 初始化Gemetry数据
 	void	Initialize();
 
+	// 初始化Gemetry数据，顶点/索引数据从资源包中读取(资源包中不存在该模型时使用默认的立方体)
+	void	Initialize(const AssetPackReader& pack, const std::string& meshName);
+
 	// 设置渲染参数
 	void	SetMatrixParameter(XMMATRIX& matrixParam);
 
-	// 渲染
+	// 渲染(直接录制到命令列表)
 	void	Draw(SystemTimer& Timer);
 
+	// 将本帧的绘制(选择LOD、剔除Meshlet后)加入绘制队列，由队列排序后统一录制
+	void	Submit(DrawQueue& queue, std::uint32_t pass = 0);
+
 
 protected:
 
 	// 创建并上传数据到缓冲区
 	bool	CreateAndUploadBuffer(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* initData, UINT64 byteSize, ComPtr<ID3D12Resource>& uploadBuffer, ComPtr<ID3D12Resource>& buffer);
 
+	// 创建缓冲区，由fill直接向映射后的Upload堆缓冲区写入byteSize字节数据(eg: 解码资源包中编码的顶点数据)，省去中间的内存缓冲区
+	// fill返回false时不提交拷贝命令
+	bool	CreateAndFillBuffer(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, UINT64 byteSize, const std::function<bool(void*)>& fill, ComPtr<ID3D12Resource>& uploadBuffer, ComPtr<ID3D12Resource>& buffer);
+
 	// 从内存上传顶点数据到顶点缓冲区，先将内存顶点数据上传到显存的Upload堆缓冲区
 	// 然后将数据从Upload堆缓冲区将数据拷贝到用于读取的显存默认堆缓冲区供后续渲染流水线使用
 	void	UploadVertexData(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* initData, UINT64 StrideSize, UINT64 byteSize);
+	bool	UploadVertexData(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const std::function<bool(void*)>& fill, UINT64 StrideSize, UINT64 byteSize);
 
 	// 从内存上传顶点索引数据到顶点缓冲区，先将内存顶点数据上传到显存的Upload堆缓冲区
 	// 然后将数据从Upload堆缓冲区将数据拷贝到用于读取的显存默认堆缓冲区供后续渲染流水线使用
-	void	UploadVertexIndexData(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* initData, UINT64 byteSize);
+	// indexFormat为DXGI_FORMAT_R16_UINT或DXGI_FORMAT_R32_UINT
+	void	UploadVertexIndexData(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* initData, UINT64 byteSize, DXGI_FORMAT indexFormat);
+	bool	UploadVertexIndexData(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const std::function<bool(void*)>& fill, UINT64 byteSize, DXGI_FORMAT indexFormat);
 
 	// 创建常量缓冲区
 	void	CreateConstantBuffers();
@@ -94,13 +128,32 @@ protected:
 	// 创建RootSignature
 	void	CreateRootSignature();
 
-	// 创建Shader
-	void	CreateShader();
+	// 创建Shader，资源包中存在烘焙好的字节码时直接使用，不再运行时编译
+	void	CreateShader(const AssetPackReader* pPack = nullptr);
 
-	// 创建顶点/索引缓冲区
+	// 从资源包中读取烘焙好的Shader字节码
+	bool	LoadShaderFromPack(const AssetPackReader& pack, const std::string& name, ComPtr<ID3DBlob>& byteCode);
+
+	// 创建顶点/索引缓冲区(默认的立方体)
 	void	CreateVertexAndIndexBuffer();
 
+	// 由MeshData创建顶点/索引缓冲区，顶点为Vertex格式
+	void	CreateVertexAndIndexBuffer(const MeshData& mesh);
+
+	// 从资源包中创建顶点/索引缓冲区，数据直接从映射视图上传无需解析
+	// 返回false时InputLayout/子集/LOD数据保持不变
+	bool	CreateVertexAndIndexBufferFromPack(const AssetPackReader& pack, const std::string& meshName);
+
+	// 由Submeshes中LOD0子集的包围盒计算LodBounds
+	void	UpdateLodBounds();
+
 	// 创建PSO
 	void	CreatePSO();
 
+	// 用当前的WorldViewProj剔除Meshlet，结果写入VisibleRanges
+	void	CullMeshlets();
+
+	// 根据各级LOD误差投影到屏幕上的像素大小选择LOD
+	UINT	SelectLod() const;
+
 };
@@ -0,0 +1,30 @@
+﻿#pragma once
+#include <memory>
+#include <vector>
+#include "DX12Util.h"
+#include "UploadBuffer.h"
+#include "Base/CommandSignatureCache.h"
+#include "Render/IndirectDraw.h"
+
+/**
+*	间接绘制
+*	每帧剔除各桶的物体，可见物体的参数直接写入上传堆中的参数缓冲区，每个桶一次ExecuteIndirect。
+*	DXRenderDeviceManager::Present每帧等待GPU执行完成，参数缓冲区在下一帧重用，容量不足时重新创建。
+*/
+class IndirectDrawRenderer
+{
+public:
+
+	// 录制所有桶，pView为nullptr时不剔除，返回绘制的物体数量
+	std::uint32_t	Record(ID3D12Device* device, CommandRecorder& recorder, const std::vector<IndirectDrawBucket>& buckets,
+		const MeshletCullView* pView = nullptr, unsigned threadCount = 0);
+
+private:
+
+	void	ReserveArguments(ID3D12Device* device, std::size_t count);
+
+	CommandSignatureCache Signatures;
+	IndirectArgumentBuilder Builder;
+	std::unique_ptr<UploadBuffer<IndirectDrawArguments>> ArgumentBuffer;
+	std::size_t ArgumentCapacity = 0;
+};
@@ -0,0 +1,14 @@
+﻿#pragma once
+#include <memory>
+#include "DX12Util.h"
+#include "Mesh/MeshData.h"
+
+// MeshSubset转换为绘制参数
+SubmeshGeometry	ToSubmeshGeometry(const MeshSubset& subset);
+
+/**
+*	由MeshData创建MeshGeometry(eg: GeometryGenerator生成的几何体)
+*	顶点为Vertex格式，所有索引都能用16位表示时使用16位索引；每个子集以子集名写入DrawArgs(同名子集只保留第一个)。
+*	上传命令记录在cmdList中，执行完成前需保留返回结果中的Upload堆缓冲区。
+*/
+std::unique_ptr<MeshGeometry>	CreateMeshGeometry(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const MeshData& mesh);
@@ -0,0 +1,55 @@
+﻿#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+#include "DX12Util.h"
+#include "Render/BundleCache.h"
+#include "Render/DrawQueue.h"
+#include "Render/IndirectDraw.h"
+#include "Render/StaticBatcher.h"
+
+/**
+*	静态批次的GPU缓冲区及绘制
+*	每个批次创建一份顶点/索引缓冲区(MeshGeometry)，PSO/根签名/描述符由resolveState按批次的StateKey提供。
+*/
+class StaticBatchRenderer
+{
+public:
+
+	// 上传所有批次，上传命令记录在cmdList中；resolveState只需填写状态部分，缓冲区部分由本函数填写
+	void	Create(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, std::vector<StaticBatch>&& batches,
+		const std::function<StaticBatchBinding(std::uint64_t stateKey)>& resolveState);
+
+	// 录制所有批次，pView不为nullptr时剔除不可见的空间单元，返回绘制次数
+	std::uint32_t	Record(CommandRecorder& recorder, const MeshletCullView* pView = nullptr) const;
+
+	// 将可见的空间单元加入绘制队列，深度为单元包围盒中心到近平面的距离
+	void	Submit(DrawQueue& queue, const MeshletCullView* pView = nullptr, std::uint32_t pass = 0, float sortDepthRange = 1000.0f) const;
+
+	/**
+	*	每个批次录制为一个Bundle(批次b的id为firstBundleId + b)，之后各帧直接执行；批次重新创建后自动重新录制
+	*	Bundle内不剔除，返回执行的Bundle数量
+	*/
+	std::uint32_t	ExecuteBundles(BundleCache& cache, CommandRecorder& recorder, std::uint64_t firstBundleId = 0) const;
+
+	// 每个批次生成一个间接绘制桶，每个空间单元一条命令(包围球由单元包围盒得到)，追加到outBuckets
+	void	BuildIndirectBuckets(std::vector<IndirectDrawBucket>& outBuckets) const;
+
+	const std::vector<StaticBatch>&	GetBatches() const { return Batches; }
+
+private:
+
+	std::vector<StaticBatch> Batches;
+	std::vector<std::unique_ptr<MeshGeometry>> Geometries;
+	std::vector<StaticBatchBinding> Bindings;
+	// 各批次排序键中的PSO/根签名/材质(描述符表)编号
+	struct SortIds
+	{
+		std::uint32_t PipelineState;
+		std::uint32_t RootSignature;
+		std::uint32_t Material;
+	};
+	std::vector<SortIds> BatchSortIds;
+	// 各批次Bundle输入(状态、缓冲区及绘制参数)的Hash
+	std::vector<std::uint64_t> BundleInputHashes;
+};
@@ -0,0 +1,73 @@
+﻿#pragma once
+#include <array>
+#include <vector>
+#include "DX12Util.h"
+#include "Mesh/VertexFormat.h"
+
+// 顶点属性存储格式对应的DXGI格式
+constexpr DXGI_FORMAT GetDXGIFormat(VertexAttributeFormat format)
+{
+	switch (format)
+	{
+	case VertexAttributeFormat::Float2:			return DXGI_FORMAT_R32G32_FLOAT;
+	case VertexAttributeFormat::Float3:			return DXGI_FORMAT_R32G32B32_FLOAT;
+	case VertexAttributeFormat::Float4:			return DXGI_FORMAT_R32G32B32A32_FLOAT;
+	case VertexAttributeFormat::Half2:			return DXGI_FORMAT_R16G16_FLOAT;
+	case VertexAttributeFormat::Half4:			return DXGI_FORMAT_R16G16B16A16_FLOAT;
+	case VertexAttributeFormat::UNorm8x4:		return DXGI_FORMAT_R8G8B8A8_UNORM;
+	case VertexAttributeFormat::OctSNorm16x2:	return DXGI_FORMAT_R16G16_SNORM;
+	default:									return DXGI_FORMAT_UNKNOWN;
+	}
+}
+
+// 顶点属性语义对应的Shader语义名
+constexpr const char* GetSemanticName(VertexSemantic semantic)
+{
+	switch (semantic)
+	{
+	case VertexSemantic::Position:	return "POSITION";
+	case VertexSemantic::Normal:	return "NORMAL";
+	case VertexSemantic::TexCoord:	return "TEXCOORD";
+	case VertexSemantic::Color:		return "COLOR";
+	case VertexSemantic::Tangent:	return "TANGENT";
+	default:						return "";
+	}
+}
+
+constexpr D3D12_INPUT_ELEMENT_DESC MakeInputElement(const VertexElementDesc& element)
+{
+	return D3D12_INPUT_ELEMENT_DESC{ GetSemanticName(element.Semantic), element.SemanticIndex, GetDXGIFormat(element.Format),
+		0, element.Offset, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 };
+}
+
+// 由顶点格式描述在编译期生成InputLayout
+template<typename Format>
+constexpr std::array<D3D12_INPUT_ELEMENT_DESC, Format::AttributeCount> MakeInputLayout()
+{
+	std::array<D3D12_INPUT_ELEMENT_DESC, Format::AttributeCount> layout = {};
+	const auto elements = Format::GetElements();
+	for (std::size_t i = 0; i < elements.size(); ++i)
+		layout[i] = MakeInputElement(elements[i]);
+	return layout;
+}
+
+// 根据资源包中记录的顶点格式标识生成InputLayout，格式未知时返回false
+inline bool MakeInputLayout(std::uint32_t formatId, std::vector<D3D12_INPUT_ELEMENT_DESC>& outLayout, UINT& outStride)
+{
+	std::vector<VertexElementDesc> elements;
+	std::uint32_t stride = 0;
+	if (!GetVertexFormatElements(formatId, elements, stride))
+		return false;
+
+	outLayout.clear();
+	for (const VertexElementDesc& element : elements)
+		outLayout.push_back(MakeInputElement(element));
+	outStride = stride;
+	return true;
+}
+
+static_assert(MakeInputLayout<ColorVertexFormat>()[1].AlignedByteOffset == 12, "COLOR must follow float3 POSITION");
+static_assert(MakeInputLayout<PackedColorVertexFormat>()[0].Format == DXGI_FORMAT_R16G16B16A16_FLOAT, "packed POSITION is half4");
+static_assert(MakeInputLayout<PackedColorVertexFormat>()[1].AlignedByteOffset == 8, "packed COLOR follows half4 POSITION");
+static_assert(MakeInputLayout<PackedLitVertexFormat>()[3].AlignedByteOffset == 16, "packed lit COLOR offset");
+static_assert(MakeInputLayout<PackedTangentVertexFormat>()[2].AlignedByteOffset == 12, "packed TANGENT follows oct NORMAL");
@@ -28,6 +28,7 @@
 #include "Dx12.h"
 //#include "DDSTextureLoader.h"
 #include "MathHelper.h"
+#include "Render/MaterialConstants.h"
 
 extern const int gNumFrameResources;
 
@@ -157,6 +158,10 @@ struct SubmeshGeometry
 	// Bounding box of the geometry defined by this submesh. 
 	// This is used in later chapters of the book.
 	DirectX::BoundingBox Bounds;
+
+	// LOD级别(0为原始网格)及相对于原始网格的最大几何误差(模型空间距离)
+	UINT LodLevel = 0;
+	float LodError = 0.0f;
 };
 
 struct MeshGeometry
@@ -226,16 +231,6 @@ struct Light
 
 #define MaxLights 16
 
-struct MaterialConstants
-{
-	DirectX::XMFLOAT4 DiffuseAlbedo = { 1.0f, 1.0f, 1.0f, 1.0f };
-	DirectX::XMFLOAT3 FresnelR0 = { 0.01f, 0.01f, 0.01f };
-	float Roughness = 0.25f;
-
-	// Used in texture mapping.
-	DirectX::XMFLOAT4X4 MatTransform = MathHelper::Identity4x4();
-};
-
 // Simple struct to represent a material for our demos.  A production 3D engine
 // would likely create a class hierarchy of Materials.
 struct Material
@@ -89,6 +89,12 @@ public:
 		return CommandList.Get();
 	}
 
+	// 获取命令队列
+	ID3D12CommandQueue* GetCommandQueue()
+	{
+		return CommandQueue.Get();
+	}
+
 
 protected:
 
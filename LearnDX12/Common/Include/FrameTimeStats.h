@@ -0,0 +1,102 @@
+﻿#ifndef FRAMETIMESTATS_H
+#define FRAMETIMESTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+struct FrameTimeStatsOptions
+{
+	// 保留的最近帧数(CSV导出及滚动中位数使用)
+	std::size_t HistorySize = 1024;
+	// 滚动中位数的窗口帧数
+	std::size_t MedianWindow = 31;
+	// 帧时间超过滚动中位数的HitchFactor倍且至少多出MinHitchMilliseconds时记为卡顿
+	float HitchFactor = 2.0f;
+	float MinHitchMilliseconds = 4.0f;
+};
+
+struct FrameTimeSummary
+{
+	std::uint64_t FrameCount = 0;
+	std::uint64_t HitchCount = 0;
+	double MinMilliseconds = 0.0;
+	double MaxMilliseconds = 0.0;
+	double MeanMilliseconds = 0.0;
+	double P50Milliseconds = 0.0;
+	double P95Milliseconds = 0.0;
+	double P99Milliseconds = 0.0;
+};
+
+/**
+*	帧时间统计
+*	所有帧记录在HDR风格的对数-线性直方图中(以微秒计，每个2的幂区间分为32个子区间，相对误差约3%)，
+*	百分位数由直方图得到，内存及耗时与帧数无关；最近HistorySize帧另外保存在环形缓冲区中，
+*	用于以滚动中位数检测卡顿及导出逐帧数据。
+*/
+class FrameTimeStats
+{
+public:
+
+	explicit FrameTimeStats(const FrameTimeStatsOptions& options = FrameTimeStatsOptions());
+
+	// 记录一帧的耗时(秒)，返回该帧是否为卡顿
+	bool	AddFrame(double seconds);
+
+	void	Reset();
+
+	// p为[0, 1]，没有记录时返回0
+	double	GetPercentileMilliseconds(double p) const;
+
+	FrameTimeSummary	GetSummary() const;
+
+	std::uint64_t	GetFrameCount() const { return FrameCount; }
+	std::uint64_t	GetHitchCount() const { return HitchCount; }
+
+	// 最近一帧之前(不含该帧)MedianWindow帧的中位数
+	double	GetRollingMedianMilliseconds() const { return RollingMedian; }
+
+	// 最近的帧，由旧到新，index < GetHistoryCount()
+	std::size_t	GetHistoryCount() const;
+	double	GetHistoryMilliseconds(std::size_t index) const;
+	bool	IsHistoryHitch(std::size_t index) const;
+
+	// 最近各帧(帧序号, 毫秒, 是否卡顿)
+	void	WriteCsv(std::ostream& stream) const;
+	// 统计摘要及直方图中非空的区间
+	void	WriteJson(std::ostream& stream) const;
+
+	// 直方图区间
+	static const std::uint32_t SubBucketBits = 6;
+	static const std::uint32_t MaxMagnitude = 32;
+	static std::size_t	GetBucketIndex(std::uint64_t microseconds);
+	static std::uint64_t	GetBucketLowerBound(std::size_t index);
+	static std::uint64_t	GetBucketUpperBound(std::size_t index);
+
+private:
+
+	struct HistoryEntry
+	{
+		float Milliseconds;
+		bool Hitch;
+	};
+
+	std::size_t	GetHistoryPosition(std::size_t index) const;
+	double	ComputeRollingMedian();
+
+	FrameTimeStatsOptions Options;
+	std::vector<std::uint32_t> Buckets;
+	std::vector<HistoryEntry> History;
+	std::size_t HistoryNext = 0;
+	std::vector<float> MedianScratch;
+
+	std::uint64_t FrameCount = 0;
+	std::uint64_t HitchCount = 0;
+	double TotalMilliseconds = 0.0;
+	double MinMilliseconds = 0.0;
+	double MaxMilliseconds = 0.0;
+	double RollingMedian = 0.0;
+};
+
+#endif // FRAMETIMESTATS_H
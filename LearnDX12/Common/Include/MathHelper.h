@@ -6,29 +6,47 @@
 
 #pragma once
 
-#include <Windows.h>
+#include <cmath>
+#include <cstdlib>
 #include <DirectXMath.h>
+#include <cstddef>
 #include <cstdint>
+#include "RandomGenerator.h"
 
 class MathHelper
 {
 public:
+	// Random numbers come from the calling thread's own generator (see GetThreadRandom),
+	// so these are safe to call from worker threads without locking.
+
 	// Returns random float in [0, 1).
 	static float RandF()
 	{
-		return (float)(rand()) / (float)RAND_MAX;
+		return GetThreadRandom().NextFloat();
 	}
 
 	// Returns random float in [a, b).
 	static float RandF(float a, float b)
 	{
-		return a + RandF()*(b-a);
+		return GetThreadRandom().NextFloat(a, b);
 	}
 
-    static int Rand(int a, int b)
-    {
-        return a + rand() % ((b - a) + 1);
-    }
+	// Returns random int in [a, b].
+	static int Rand(int a, int b)
+	{
+		return GetThreadRandom().NextInt(a, b);
+	}
+
+	// Fills outValues with random floats in [a, b) / ints in [a, b] using the SIMD batch generator.
+	static void RandF(float* outValues, std::size_t count, float a = 0.0f, float b = 1.0f)
+	{
+		GetThreadBatchRandom().FillFloats(outValues, count, a, b);
+	}
+
+	static void Rand(int* outValues, std::size_t count, int a, int b)
+	{
+		GetThreadBatchRandom().FillInts(outValues, count, a, b);
+	}
 
 	template<typename T>
 	static T Min(const T& a, const T& b)
@@ -89,9 +107,14 @@ public:
         return I;
     }
 
+	// Uniformly distributed directions, w = 0.  The hemisphere is the one around n (n need not be normalized).
     static DirectX::XMVECTOR RandUnitVec3();
     static DirectX::XMVECTOR RandHemisphereUnitVec3(DirectX::XMVECTOR n);
 
+	// Batch versions filling count directions.
+	static void RandUnitVec3(DirectX::XMFLOAT3* outVectors, std::size_t count);
+	static void RandHemisphereUnitVec3(DirectX::FXMVECTOR n, DirectX::XMFLOAT3* outVectors, std::size_t count);
+
 	static const float Infinity;
 	static const float Pi;
 
@@ -0,0 +1,96 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "Mesh/MeshData.h"
+
+enum class GeometryShape : std::uint32_t
+{
+	Box,
+	Sphere,
+	Geosphere,
+	Cylinder,
+	Grid,
+};
+
+// 几何体生成参数，同时作为缓存的键，未使用的参数为0
+struct GeometryDesc
+{
+	GeometryShape Shape = GeometryShape::Box;
+	// Box: 宽/高/深  Sphere/Geosphere: 半径  Cylinder: 底面半径/顶面半径/高  Grid: 宽(x)/深(z)
+	float Size[3] = { 0.0f, 0.0f, 0.0f };
+	// Box: 每条边的分段数  Sphere/Cylinder: 经线(slice)/纬线(stack)分段数  Geosphere: 细分次数  Grid: 行(z)/列(x)顶点数
+	std::uint32_t Tessellation[2] = { 0, 0 };
+
+	static GeometryDesc	Box(float width, float height, float depth, std::uint32_t segments = 1);
+	static GeometryDesc	Sphere(float radius, std::uint32_t sliceCount, std::uint32_t stackCount);
+	static GeometryDesc	Geosphere(float radius, std::uint32_t subdivisions);
+	static GeometryDesc	Cylinder(float bottomRadius, float topRadius, float height, std::uint32_t sliceCount, std::uint32_t stackCount);
+	static GeometryDesc	Grid(float width, float depth, std::uint32_t rowCount, std::uint32_t columnCount);
+
+	bool operator==(const GeometryDesc& other) const;
+};
+
+/**
+*	程序化几何体生成
+*	顶点及索引数量由参数直接算出，所有数组一次分配后按下标写入，不逐个push_back；
+*	向量运算使用DirectXMath(x64上为SSE指令)，网格的索引使用SSE2每次写入两个四边形。
+*	坐标系为左手系，从外侧看三角形为顺时针(与D3D12默认的正面一致)。
+*	生成结果包含法线、纹理坐标及切线(w为+1，与MeshProcessor::ComputeTangents的约定一致)，
+*	顶点颜色由法线得到(n * 0.5 + 0.5)，便于只输出顶点颜色的Shader直接显示；每种几何体为一个子集。
+*/
+class GeometryGenerator
+{
+public:
+
+	static void	CreateBox(float width, float height, float depth, std::uint32_t segments, MeshData& outMesh);
+
+	// 经纬球，两极各一个顶点
+	static void	CreateSphere(float radius, std::uint32_t sliceCount, std::uint32_t stackCount, MeshData& outMesh);
+
+	// 由正二十面体细分得到的球，三角形大小均匀，细分次数不超过MaxGeosphereSubdivisions
+	static void	CreateGeosphere(float radius, std::uint32_t subdivisions, MeshData& outMesh);
+
+	// 沿y轴的圆台(两个半径相同时为圆柱)，中心在原点，包括顶面及底面
+	static void	CreateCylinder(float bottomRadius, float topRadius, float height, std::uint32_t sliceCount, std::uint32_t stackCount, MeshData& outMesh);
+
+	// xz平面上的网格，中心在原点，rowCount x columnCount个顶点
+	static void	CreateGrid(float width, float depth, std::uint32_t rowCount, std::uint32_t columnCount, MeshData& outMesh);
+
+	// 按desc生成
+	static void	Create(const GeometryDesc& desc, MeshData& outMesh);
+
+	static const std::uint32_t MaxGeosphereSubdivisions = 8;
+};
+
+/**
+*	按生成参数缓存的几何体，相同参数的请求直接返回已生成的结果
+*	返回的MeshData不可修改，可在多个线程中同时请求
+*/
+class GeometryCache
+{
+public:
+
+	static GeometryCache& GetInstance();
+
+	std::shared_ptr<const MeshData>	Get(const GeometryDesc& desc);
+
+	void	Clear();
+
+	std::size_t	GetHitCount() const;
+	std::size_t	GetMissCount() const;
+
+private:
+
+	struct DescHash
+	{
+		std::size_t operator()(const GeometryDesc& desc) const;
+	};
+
+	mutable std::mutex Mutex;
+	std::unordered_map<GeometryDesc, std::shared_ptr<const MeshData>, DescHash> Meshes;
+	std::size_t HitCount = 0;
+	std::size_t MissCount = 0;
+};
@@ -0,0 +1,31 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+*	GPU网格的无损顶点/索引编码
+*
+*	顶点: 按块(最多256个顶点)处理，块内每个字节位置构成一个字节平面，平面内按顶点顺序做字节差分并zigzag编码，
+*	      每16个差分值按所需位数(0/2/4/8位)打包，2位的组头记录位数。
+*	      经过顶点读取顺序优化的网格中相邻顶点相近，大部分差分值只需0~4位。
+*	      解码时使用SSE2并行完成解包、zigzag还原、前缀和及字节平面转置，每块先转置到缓存中的块缓冲区，
+*	      再顺序复制到输出，可直接解码到Upload堆映射的写合并内存中。
+*
+*	索引: 三角形FIFO编码，编码器维护最近的15条边及16个顶点，每个三角形写入一个编码字节:
+*	      高4位为共享边在边FIFO中的位置(15表示没有共享边)，低4位描述第三个顶点
+*	      (0: 下一个新顶点  1~14: 顶点FIFO中的位置  15: 显式写入与上一个顶点的zigzag差值)。
+*	      没有共享边的三角形另外写入两个字节描述三个顶点。三角形可能被旋转，但绕序保持不变。
+*/
+
+// 将vertexCount个步长为vertexByteStride的顶点编码到outData
+void	EncodeVertexBuffer(const void* vertices, std::size_t vertexCount, std::size_t vertexByteStride, std::vector<std::uint8_t>& outData);
+
+// 解码顶点到dst(vertexCount * vertexByteStride字节)，数据不完整或格式错误时返回false
+bool	DecodeVertexBuffer(void* dst, std::size_t vertexCount, std::size_t vertexByteStride, const void* data, std::size_t dataSize);
+
+// 编码三角形列表索引(indexByteSize为2或4)，索引数量不是3的倍数时返回false
+bool	EncodeIndexBuffer(const void* indices, std::size_t indexCount, std::size_t indexByteSize, std::vector<std::uint8_t>& outData);
+
+// 解码索引到dst(indexCount * indexByteSize字节)
+bool	DecodeIndexBuffer(void* dst, std::size_t indexCount, std::size_t indexByteSize, const void* data, std::size_t dataSize);
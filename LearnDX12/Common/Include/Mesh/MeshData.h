@@ -0,0 +1,102 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+// CPU端及默认的运行时顶点格式，对应的InputLayout由ColorVertexFormat(Mesh/VertexFormat.h)生成
+// POSITION: 0  COLOR: 12
+struct Vertex
+{
+	DirectX::XMFLOAT3 Pos;
+	DirectX::XMFLOAT4 Color;
+};
+static_assert(sizeof(Vertex) == 28, "Vertex layout must match ColorVertexFormat");
+
+// 网格中的一个子集，与SubmeshGeometry一一对应(不依赖D3D12，可在离线工具中使用)
+struct MeshSubset
+{
+	std::string Name;
+	std::uint32_t IndexCount = 0;
+	std::uint32_t StartIndexLocation = 0;
+	std::int32_t BaseVertexLocation = 0;
+
+	DirectX::BoundingBox Bounds;
+
+	// LOD级别(0为原始网格)及相对于原始网格的最大几何误差(模型空间距离)
+	std::uint32_t LodLevel = 0;
+	float LodError = 0.0f;
+};
+
+// CPU端网格数据，索引统一以32位存放，上传/打包时再决定索引格式
+struct MeshData
+{
+	std::string Name;
+
+	std::vector<Vertex> Vertices;
+	std::vector<std::uint32_t> Indices32;
+	std::vector<MeshSubset> Subsets;
+
+	// 可选的附加顶点属性(与Vertices一一对应，源数据中没有该属性时为空)
+	// Vertex中只保存运行时需要的属性，附加属性供离线处理及其他顶点格式使用
+	std::vector<DirectX::XMFLOAT3> Normals;
+	std::vector<DirectX::XMFLOAT2> TexCoords;
+	// 切线(w为副切线方向±1)，由MeshProcessor::ComputeTangents生成
+	std::vector<DirectX::XMFLOAT4> Tangents;
+
+	// 所有索引是否都能用16位表示
+	bool CanUse16BitIndices() const
+	{
+		for (std::uint32_t i : Indices32)
+		{
+			if (i > 0xFFFF)
+				return false;
+		}
+		return true;
+	}
+
+	std::vector<std::uint16_t> GetIndices16() const
+	{
+		std::vector<std::uint16_t> indices16(Indices32.size());
+		for (std::size_t i = 0; i < Indices32.size(); ++i)
+			indices16[i] = static_cast<std::uint16_t>(Indices32[i]);
+
+		return indices16;
+	}
+};
+
+// 用点p扩展最小/最大点
+inline void ExpandMinMax(DirectX::XMFLOAT3& vMin, DirectX::XMFLOAT3& vMax, const DirectX::XMFLOAT3& p)
+{
+	vMin.x = p.x < vMin.x ? p.x : vMin.x;
+	vMin.y = p.y < vMin.y ? p.y : vMin.y;
+	vMin.z = p.z < vMin.z ? p.z : vMin.z;
+	vMax.x = p.x > vMax.x ? p.x : vMax.x;
+	vMax.y = p.y > vMax.y ? p.y : vMax.y;
+	vMax.z = p.z > vMax.z ? p.z : vMax.z;
+}
+
+// 由最小/最大点构造包围盒
+inline DirectX::BoundingBox MakeBoundsFromMinMax(const DirectX::XMFLOAT3& vMin, const DirectX::XMFLOAT3& vMax)
+{
+	DirectX::BoundingBox bounds;
+	bounds.Center = DirectX::XMFLOAT3((vMin.x + vMax.x) * 0.5f, (vMin.y + vMax.y) * 0.5f, (vMin.z + vMax.z) * 0.5f);
+	bounds.Extents = DirectX::XMFLOAT3((vMax.x - vMin.x) * 0.5f, (vMax.y - vMin.y) * 0.5f, (vMax.z - vMin.z) * 0.5f);
+	return bounds;
+}
+
+// 计算子集所引用顶点的包围盒
+inline DirectX::BoundingBox ComputeSubsetBounds(const MeshData& mesh, const MeshSubset& subset)
+{
+	if (subset.IndexCount == 0)
+		return MakeBoundsFromMinMax(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+	const std::uint32_t* indices = mesh.Indices32.data() + subset.StartIndexLocation;
+	DirectX::XMFLOAT3 vMin = mesh.Vertices[indices[0] + subset.BaseVertexLocation].Pos;
+	DirectX::XMFLOAT3 vMax = vMin;
+	for (std::uint32_t i = 1; i < subset.IndexCount; ++i)
+		ExpandMinMax(vMin, vMax, mesh.Vertices[indices[i] + subset.BaseVertexLocation].Pos);
+
+	return MakeBoundsFromMinMax(vMin, vMax);
+}
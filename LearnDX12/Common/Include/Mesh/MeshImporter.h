@@ -0,0 +1,46 @@
+﻿#pragma once
+#include <string>
+#include <vector>
+#include "Mesh/MeshData.h"
+
+struct MeshImportOptions
+{
+	// 解析线程数量，0表示使用全部硬件线程
+	unsigned ThreadCount = 0;
+	// 通过Hash合并属性完全相同的顶点
+	bool DeduplicateVertices = true;
+};
+
+// 导入过程的统计信息
+struct MeshImportInfo
+{
+	// 导入过程中读取的所有文件(模型文件及glTF引用的buffer文件)
+	std::vector<std::string> SourceFiles;
+	std::size_t SourceByteSize = 0;
+	// 合并前的顶点(面顶点)数量
+	std::size_t SourceVertexCount = 0;
+	std::size_t TriangleCount = 0;
+};
+
+/**
+*	模型导入器，支持OBJ及glTF 2.0(.gltf + 外部.bin / .glb)本地文件
+*	OBJ文本被拆分为多段并行解析；glTF的各个图元并行读取。
+*	输出的MeshData中每个OBJ组/glTF图元对应一个子集，索引统一为32位，
+*	可通过MeshData::CanUse16BitIndices/GetIndices16决定最终的索引格式。
+*/
+class MeshImporter
+{
+public:
+
+	// 根据扩展名选择导入格式
+	static bool ImportFile(const std::string& filename, MeshData& outMesh, std::string& outError,
+		const MeshImportOptions& options = MeshImportOptions(), MeshImportInfo* pInfo = nullptr);
+
+	// 从内存中的OBJ文本导入
+	static bool ImportObj(const char* text, std::size_t byteSize, MeshData& outMesh, std::string& outError,
+		const MeshImportOptions& options = MeshImportOptions(), MeshImportInfo* pInfo = nullptr);
+
+	// 导入glTF 2.0文件(.gltf或.glb)
+	static bool ImportGltf(const std::string& filename, MeshData& outMesh, std::string& outError,
+		const MeshImportOptions& options = MeshImportOptions(), MeshImportInfo* pInfo = nullptr);
+};
@@ -0,0 +1,44 @@
+﻿#pragma once
+#include <cstdint>
+#include "Mesh/MeshData.h"
+
+// 16位索引可以表示的顶点数量
+const std::uint32_t MaxVerticesPer16BitSubset = 0x10000;
+
+// 索引格式选择及拆分结果的统计
+struct MeshIndexStats
+{
+	std::uint32_t IndexByteSize = 4;
+	std::uint64_t IndexCount = 0;
+	// 拆分前后的子集数量
+	std::uint32_t SourceSubsetCount = 0;
+	std::uint32_t SubsetCount = 0;
+	// 因跨越拆分边界而复制的顶点数量
+	std::uint32_t DuplicatedVertexCount = 0;
+	// 子集末尾不足一个三角形而移除的索引数量
+	std::uint32_t DroppedIndexCount = 0;
+
+	// 全部使用32位索引时的索引字节数
+	std::uint64_t IndexBytes32() const { return IndexCount * 4; }
+	std::uint64_t IndexBytes() const { return IndexCount * IndexByteSize; }
+
+	// 相对于32位索引节省的字节数(扣除复制顶点带来的额外顶点数据)
+	std::int64_t BytesSaved(std::uint32_t vertexByteStride) const
+	{
+		return (std::int64_t)(IndexBytes32() - IndexBytes()) - (std::int64_t)DuplicatedVertexCount * vertexByteStride;
+	}
+};
+
+// 存放mesh中索引所需的最小索引字节数(2或4)
+std::uint32_t	SelectIndexByteSize(const MeshData& mesh);
+
+/**
+*	使mesh可以使用16位索引:
+*	每个子集的索引改为相对于子集所引用的最小顶点，差值写入BaseVertexLocation；
+*	引用顶点范围超过65536的子集按三角形顺序拆分为多个同名子集，索引缓冲区中三角形的顺序不变。
+*	所有子集的顶点范围都不超过65536时只调整BaseVertexLocation；否则顶点数组按各部分首次引用的顺序重建，
+*	跨越部分边界的顶点在各部分中各有一份。
+*	子集的索引数量不是3的倍数时末尾的索引被移除；空的子集保留。
+*	结果的索引缓冲区只包含各子集的索引(不属于任何子集的索引被移除)。
+*/
+void	SplitMeshFor16BitIndices(MeshData& mesh, MeshIndexStats* pStats = nullptr);
@@ -0,0 +1,64 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Mesh/MeshData.h"
+
+// 顶点缓存模拟结果
+struct VertexCacheStats
+{
+	std::size_t TriangleCount = 0;
+	std::size_t VertexCount = 0;
+	std::size_t MissCount = 0;
+
+	// Average Cache Miss Ratio: 每个三角形平均需要变换的顶点数(0.5 ~ 3)
+	float	ACMR() const { return TriangleCount ? (float)MissCount / TriangleCount : 0.0f; }
+	// Average Transform to Vertex Ratio: 每个顶点平均被变换的次数(最优为1)
+	float	ATVR() const { return VertexCount ? (float)MissCount / VertexCount : 0.0f; }
+};
+
+struct MeshOptimizeOptions
+{
+	// 模拟的FIFO顶点缓存大小
+	std::uint32_t CacheSize = 16;
+	// 允许为减少Overdraw而增加的ACMR比例，0表示不进行Overdraw优化
+	float OverdrawThreshold = 1.05f;
+	// 按索引中首次引用的顺序重排顶点
+	bool OptimizeVertexFetch = true;
+	// 并行处理各子集的线程数量，0表示使用全部硬件线程
+	unsigned ThreadCount = 0;
+};
+
+struct MeshOptimizeStats
+{
+	VertexCacheStats Before;
+	VertexCacheStats After;
+	// 未被任何索引引用而移除的顶点数量
+	std::size_t RemovedVertexCount = 0;
+};
+
+/**
+*	索引/顶点顺序优化
+*	1. 顶点缓存: 使用Tipsify(Sander et al. 2007)重排各子集的三角形，提高变换后顶点缓存的命中率
+*	2. Overdraw: 在Tipsify输出的三角形簇基础上按朝外程度排序，使遮挡其他簇的簇尽量先绘制
+*	3. 顶点读取: 按三角形顺序重排顶点，使顶点读取尽量连续
+*/
+class MeshOptimizer
+{
+public:
+
+	// 依次执行上述优化，所有子集处理后BaseVertexLocation为0，应在SplitMeshFor16BitIndices之前调用
+	static void	OptimizeMesh(MeshData& mesh, const MeshOptimizeOptions& options = MeshOptimizeOptions(), MeshOptimizeStats* pStats = nullptr);
+
+	// 模拟FIFO顶点缓存，统计ACMR/ATVR
+	static VertexCacheStats	AnalyzeVertexCache(const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::uint32_t cacheSize = 16);
+
+	// Tipsify三角形重排，indices中的下标必须小于vertexCount
+	static void	OptimizeVertexCache(std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::uint32_t cacheSize = 16);
+
+	// 在不使ACMR超过原来threshold倍的前提下重排三角形簇以减少Overdraw，indices应为OptimizeVertexCache的输出
+	static void	OptimizeOverdraw(std::uint32_t* indices, std::size_t indexCount, const Vertex* vertices, std::size_t vertexCount,
+		std::uint32_t cacheSize = 16, float threshold = 1.05f);
+
+	// 按首次引用顺序重排顶点(包括Normals/TexCoords/Tangents)并修改索引，返回移除的未引用顶点数量
+	static std::size_t	OptimizeVertexFetch(MeshData& mesh);
+};
@@ -0,0 +1,76 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mesh/MeshData.h"
+
+struct MeshWeldOptions
+{
+	// 位置各分量之差都不超过该值的顶点视为位置相同，0表示位置必须完全相同
+	float PositionEpsilon = 0.0f;
+	// 颜色/法线/纹理坐标/切线各分量之差都不超过该值时才合并，小于0表示不比较属性(只按位置合并)
+	float AttributeEpsilon = 0.0f;
+	// 移除合并后退化(有重复顶点)的三角形
+	bool RemoveDegenerateTriangles = true;
+	// 并行处理使用的线程数量，0表示使用全部硬件线程
+	unsigned ThreadCount = 0;
+};
+
+struct MeshWeldStats
+{
+	std::size_t RemovedVertexCount = 0;
+	std::size_t RemovedTriangleCount = 0;
+};
+
+struct MeshNormalOptions
+{
+	// 位置相同而其他属性不同的顶点(纹理坐标/颜色接缝)使用相同的平滑法线，避免接缝处明暗不连续
+	bool SmoothAcrossSeams = true;
+	// 判断位置相同使用的误差
+	float PositionEpsilon = 0.0f;
+	unsigned ThreadCount = 0;
+};
+
+struct MeshTangentOptions
+{
+	unsigned ThreadCount = 0;
+};
+
+struct MeshTangentStats
+{
+	// 因两侧纹理映射方向(镜像)不同而复制的顶点数量
+	std::size_t SplitVertexCount = 0;
+	// 纹理坐标退化(面积为0)、不参与切线计算的三角形数量
+	std::size_t DegenerateTriangleCount = 0;
+};
+
+/**
+*	网格预处理: 顶点合并、法线及切线生成
+*	位置相同的顶点通过空间Hash网格查找，每个顶点最多检查相邻的8个单元；
+*	逐三角形的计算按三角形分段并行执行，结果再按顶点(通过顶点->三角形角的邻接表)并行汇总，
+*	不需要原子操作且结果与线程数量无关。
+*	处理结果写入MeshData的Normals/Tangents，由EncodeVertices<Format>()转换为Geometry使用的顶点格式。
+*/
+class MeshProcessor
+{
+public:
+
+	// 合并位置相同(误差范围内)且属性相同的顶点，所有子集的BaseVertexLocation变为0
+	// 应在MeshOptimizer::OptimizeMesh之前调用
+	static void	WeldVertices(MeshData& mesh, const MeshWeldOptions& options = MeshWeldOptions(), MeshWeldStats* pStats = nullptr);
+
+	// 按面积加权平均相邻三角形的法线，结果写入mesh.Normals
+	static void	ComputeNormals(MeshData& mesh, const MeshNormalOptions& options = MeshNormalOptions());
+
+	/**
+	*	生成与MikkTSpace约定一致的切线，结果写入mesh.Tangents:
+	*	切线由各三角形纹理坐标的偏导数得到，投影到顶点法线的切平面后按三角形在该顶点处的夹角加权平均；
+	*	w为副切线方向(bitangent = w * cross(normal, tangent))，纹理映射镜像的三角形为-1。
+	*	同一顶点两侧的镜像方向不同时复制该顶点。需要mesh.Normals及mesh.TexCoords，缺少时返回false。
+	*	复制的顶点追加到顶点数组末尾，应在SplitMeshFor16BitIndices之前调用
+	*/
+	static bool	ComputeTangents(MeshData& mesh, const MeshTangentOptions& options = MeshTangentOptions(), MeshTangentStats* pStats = nullptr);
+
+	// 为每个顶点找到位置相同(误差范围内)的编号最小的顶点，outRemap[v] <= v
+	static void	BuildPositionRemap(const MeshData& mesh, float positionEpsilon, std::vector<std::uint32_t>& outRemap, unsigned threadCount = 0);
+};
@@ -0,0 +1,56 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mesh/MeshData.h"
+
+struct MeshSimplifyOptions
+{
+	// 允许的最大几何误差(模型空间距离)，达到后停止简化，即使三角形数量尚未达到目标
+	float MaxError = 1e30f;
+	// 顶点属性(颜色/法线/纹理坐标)差异在折叠代价中的权重，0表示只考虑几何误差
+	float AttributeWeight = 1.0f;
+	// 锁定开放边界上的顶点(拆分子集的边界、模型的孔洞)，避免各部分之间出现裂缝
+	bool LockBorder = true;
+};
+
+struct MeshLodOptions
+{
+	// 各级LOD相对于LOD0的三角形比例
+	std::vector<float> Ratios = { 0.5f, 0.25f, 0.125f };
+	MeshSimplifyOptions Simplify;
+	// 三角形数量比上一级减少不足该比例时，该子集不再继续简化(更低的LOD沿用上一级的结果)
+	float MinReduction = 0.1f;
+	// LOD索引的顶点缓存优化使用的缓存大小
+	std::uint32_t CacheSize = 16;
+	// 并行处理各子集的线程数量，0表示使用全部硬件线程
+	unsigned ThreadCount = 0;
+};
+
+struct MeshLodStats
+{
+	// 各级LOD(包括LOD0)的三角形数量及最大几何误差
+	std::vector<std::size_t> TriangleCounts;
+	std::vector<float> Errors;
+};
+
+/**
+*	基于二次误差度量(Quadric Error Metrics, Garland & Heckbert 1997)的网格简化
+*	每次将一条边的一个端点折叠到另一个端点上，顶点位置保持不变，因此简化结果只是一组新的索引，
+*	可以与原网格共用同一个顶点缓冲区。
+*	折叠代价为两端点误差矩阵之和在目标位置的值，加上按边长缩放的属性差异；
+*	位置相同的多个顶点(属性接缝)及开放边界上的顶点被锁定，使三角形朝向翻转的折叠被拒绝。
+*/
+class MeshSimplifier
+{
+public:
+
+	// 将indices(与子集中的索引值含义相同，不包括baseVertexLocation)简化到不超过targetIndexCount个索引
+	// 结果写入outIndices，返回简化引入的最大几何误差(模型空间距离)
+	static float	Simplify(const MeshData& mesh, std::int32_t baseVertexLocation, const std::uint32_t* indices, std::size_t indexCount,
+		std::size_t targetIndexCount, std::vector<std::uint32_t>& outIndices, const MeshSimplifyOptions& options = MeshSimplifyOptions());
+
+	// 为所有LOD0子集生成LOD链，各级LOD作为附加子集(LodLevel > 0)追加到索引缓冲区末尾，与LOD0共用顶点
+	// LOD的索引经过顶点缓存优化，应在MeshOptimizer::OptimizeMesh及SplitMeshFor16BitIndices之后调用
+	static void	GenerateLods(MeshData& mesh, const MeshLodOptions& options = MeshLodOptions(), MeshLodStats* pStats = nullptr);
+};
@@ -0,0 +1,121 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+#include "Mesh/MeshData.h"
+
+// 每个Meshlet的最大顶点/三角形数量(与常见的Mesh Shader限制一致)
+const std::uint32_t MaxMeshletVertices = 64;
+const std::uint32_t MaxMeshletTriangles = 124;
+
+/**
+*	Meshlet: 子集中一组相邻的三角形
+*	构建时子集的三角形按Meshlet重新排列，每个Meshlet在索引缓冲区中占据连续的一段，
+*	因此既可以用DrawIndexedInstanced按段绘制，也可以通过顶点列表/局部三角形供Mesh Shader使用。
+*/
+struct Meshlet
+{
+	// 在索引缓冲区中的范围，BaseVertexLocation与所属子集相同
+	std::uint32_t StartIndexLocation = 0;
+	std::uint32_t IndexCount = 0;
+	std::int32_t BaseVertexLocation = 0;
+
+	// 在MeshletData::Vertices中的顶点列表
+	std::uint32_t VertexOffset = 0;
+	std::uint32_t VertexCount = 0;
+	// 在MeshletData::Triangles中的局部三角形(每个三角形3个字节，为顶点列表中的下标)
+	std::uint32_t TriangleOffset = 0;
+	std::uint32_t TriangleCount = 0;
+};
+
+// Meshlet的剔除数据
+struct MeshletBounds
+{
+	// 包围球
+	DirectX::XMFLOAT3 Center = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+	float Radius = 0.0f;
+
+	// 法线锥: 所有三角形法线与ConeAxis的夹角都不超过acos(sqrt(1 - ConeCutoff^2))
+	// ConeCutoff为1时法线分布过广，不能进行背面剔除
+	DirectX::XMFLOAT3 ConeAxis = DirectX::XMFLOAT3(0.0f, 0.0f, 1.0f);
+	float ConeCutoff = 1.0f;
+};
+
+struct MeshletData
+{
+	std::vector<Meshlet> Meshlets;
+	std::vector<MeshletBounds> Bounds;
+	// 各Meshlet引用的顶点(索引缓冲区中的值，不包括BaseVertexLocation)
+	std::vector<std::uint32_t> Vertices;
+	// 各Meshlet的局部三角形
+	std::vector<std::uint8_t> Triangles;
+};
+
+struct MeshletBuildOptions
+{
+	std::uint32_t MaxVertices = MaxMeshletVertices;
+	std::uint32_t MaxTriangles = MaxMeshletTriangles;
+	// 并行处理各子集的线程数量，0表示使用全部硬件线程
+	unsigned ThreadCount = 0;
+};
+
+// 剔除使用的视图(均在模型空间中)
+struct MeshletCullView
+{
+	// 视锥体的6个平面(ax + by + cz + d >= 0为内侧)
+	DirectX::XMFLOAT4 Planes[6];
+	DirectX::XMFLOAT3 CameraPosition = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+	bool ConeCulling = true;
+};
+
+// 剔除后需要绘制的一段索引
+struct MeshletDrawRange
+{
+	std::uint32_t StartIndexLocation = 0;
+	std::uint32_t IndexCount = 0;
+	std::int32_t BaseVertexLocation = 0;
+};
+
+struct MeshletCullStats
+{
+	std::size_t MeshletCount = 0;
+	std::size_t FrustumCulledCount = 0;
+	std::size_t ConeCulledCount = 0;
+	std::size_t VisibleTriangleCount = 0;
+	std::size_t DrawRangeCount = 0;
+
+	std::size_t VisibleCount() const { return MeshletCount - FrustumCulledCount - ConeCulledCount; }
+};
+
+class MeshletBuilder
+{
+public:
+
+	// 将mesh的各LOD0子集划分为Meshlet，子集内的三角形按Meshlet顺序重排(子集的范围不变)
+	// 应在MeshOptimizer::OptimizeMesh及SplitMeshFor16BitIndices之后调用，此时三角形顺序已具有较好的局部性
+	static void	BuildMeshlets(MeshData& mesh, MeshletData& outMeshlets, const MeshletBuildOptions& options = MeshletBuildOptions());
+
+	// 计算一个Meshlet的包围球及法线锥
+	static MeshletBounds	ComputeBounds(const MeshData& mesh, const MeshletData& meshlets, const Meshlet& meshlet);
+};
+
+class MeshletCuller
+{
+public:
+
+	// 由WorldViewProj矩阵(行向量约定，裁剪空间z范围[0,1])提取模型空间的视锥体平面，cameraPosition为模型空间中的相机位置
+	static MeshletCullView	MakeCullView(const DirectX::XMFLOAT4X4& worldViewProj, const DirectX::XMFLOAT3& cameraPosition);
+
+	// 相机位置由WorldViewProj的逆矩阵求出；正交投影时相机位于无穷远处，关闭法线锥剔除
+	static MeshletCullView	MakeCullView(const DirectX::XMFLOAT4X4& worldViewProj);
+
+	static bool	IsOutsideFrustum(const MeshletCullView& view, const MeshletBounds& bounds);
+
+	// 法线锥背向相机，Meshlet中所有三角形都是背面
+	static bool	IsBackFacing(const MeshletCullView& view, const MeshletBounds& bounds);
+
+	// 剔除不可见的Meshlet，索引范围相连且BaseVertexLocation相同的可见Meshlet合并为一段
+	static void	Cull(const MeshletCullView& view, const Meshlet* meshlets, const MeshletBounds* bounds, std::size_t meshletCount,
+		std::vector<MeshletDrawRange>& outRanges, MeshletCullStats* pStats = nullptr);
+};
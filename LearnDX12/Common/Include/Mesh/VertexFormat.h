@@ -0,0 +1,243 @@
+﻿#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+#include <DirectXPackedVector.h>
+#include "Mesh/MeshData.h"
+
+/**
+*	顶点格式描述
+*	顶点格式由若干VertexAttribute组成，各属性按声明顺序紧密排列，偏移与步长在编译期计算。
+*	D3D12的InputLayout由VertexLayout.h中的MakeInputLayout<Format>()根据同一份描述生成，
+*	离线工具则使用EncodeVertices<Format>()将MeshData转换为该格式的顶点数据。
+*/
+
+// 顶点属性语义，与Shader中的输入语义对应
+enum class VertexSemantic : std::uint32_t
+{
+	Position,
+	Normal,
+	TexCoord,
+	Color,
+	Tangent,
+};
+
+// 顶点属性的存储格式
+enum class VertexAttributeFormat : std::uint32_t
+{
+	Float2,
+	Float3,
+	Float4,
+	Half2,			// 16位浮点，Shader中读取为float2
+	Half4,			// 16位浮点，Shader中读取为float4(位置的w分量为1)
+	UNorm8x4,		// 8位无符号归一化，Shader中读取为[0,1]的float4
+	OctSNorm16x2,	// 八面体映射编码的单位向量，Shader中需用OctDecode解码
+};
+
+// 各存储格式对应的C++类型
+template<VertexAttributeFormat F> struct VertexAttributeTraits;
+template<> struct VertexAttributeTraits<VertexAttributeFormat::Float2> { using Type = DirectX::XMFLOAT2; };
+template<> struct VertexAttributeTraits<VertexAttributeFormat::Float3> { using Type = DirectX::XMFLOAT3; };
+template<> struct VertexAttributeTraits<VertexAttributeFormat::Float4> { using Type = DirectX::XMFLOAT4; };
+template<> struct VertexAttributeTraits<VertexAttributeFormat::Half2> { using Type = DirectX::PackedVector::XMHALF2; };
+template<> struct VertexAttributeTraits<VertexAttributeFormat::Half4> { using Type = DirectX::PackedVector::XMHALF4; };
+template<> struct VertexAttributeTraits<VertexAttributeFormat::UNorm8x4> { using Type = DirectX::PackedVector::XMUBYTEN4; };
+template<> struct VertexAttributeTraits<VertexAttributeFormat::OctSNorm16x2> { using Type = DirectX::PackedVector::XMSHORTN2; };
+
+// 顶点格式中的一个属性
+template<VertexSemantic S, VertexAttributeFormat F, std::uint32_t SemanticIndex = 0>
+struct VertexAttribute
+{
+	using Type = typename VertexAttributeTraits<F>::Type;
+
+	static constexpr VertexSemantic Semantic = S;
+	static constexpr VertexAttributeFormat Format = F;
+	static constexpr std::uint32_t Index = SemanticIndex;
+	static constexpr std::uint32_t Size = (std::uint32_t)sizeof(Type);
+};
+
+// 运行时可遍历的属性描述
+struct VertexElementDesc
+{
+	VertexSemantic Semantic;
+	std::uint32_t SemanticIndex;
+	VertexAttributeFormat Format;
+	std::uint32_t Offset;
+};
+
+template<typename... Attributes>
+struct VertexFormat
+{
+	static constexpr std::size_t AttributeCount = sizeof...(Attributes);
+	static constexpr std::uint32_t Stride = (Attributes::Size + ... + 0);
+
+	// 各属性的描述，偏移为之前所有属性大小之和
+	static constexpr std::array<VertexElementDesc, sizeof...(Attributes)> GetElements()
+	{
+		std::array<VertexElementDesc, sizeof...(Attributes)> elements = {};
+		std::uint32_t offset = 0;
+		std::size_t i = 0;
+		((elements[i++] = VertexElementDesc{ Attributes::Semantic, Attributes::Index, Attributes::Format, offset }, offset += Attributes::Size), ...);
+		return elements;
+	}
+
+	static constexpr std::uint32_t GetOffset(std::size_t attribute)
+	{
+		return GetElements()[attribute].Offset;
+	}
+
+	// 格式标识(属性描述的FNV-1a Hash)，写入资源包后运行时据此选择InputLayout
+	static constexpr std::uint32_t GetId()
+	{
+		std::uint32_t hash = 2166136261u;
+		for (const VertexElementDesc& e : GetElements())
+		{
+			const std::uint32_t values[4] = { (std::uint32_t)e.Semantic, e.SemanticIndex, (std::uint32_t)e.Format, e.Offset };
+			for (std::uint32_t v : values)
+			{
+				hash ^= v;
+				hash *= 16777619u;
+			}
+		}
+		return hash;
+	}
+};
+
+
+// 与Vertex相同的32位浮点格式，28字节
+using ColorVertexFormat = VertexFormat<
+	VertexAttribute<VertexSemantic::Position, VertexAttributeFormat::Float3>,
+	VertexAttribute<VertexSemantic::Color, VertexAttributeFormat::Float4>>;
+
+// 量化的位置+颜色，12字节
+struct PackedColorVertex
+{
+	DirectX::PackedVector::XMHALF4 Pos;
+	DirectX::PackedVector::XMUBYTEN4 Color;
+};
+
+using PackedColorVertexFormat = VertexFormat<
+	VertexAttribute<VertexSemantic::Position, VertexAttributeFormat::Half4>,
+	VertexAttribute<VertexSemantic::Color, VertexAttributeFormat::UNorm8x4>>;
+
+// 带法线/纹理坐标的32位浮点格式，48字节
+using LitVertexFormat = VertexFormat<
+	VertexAttribute<VertexSemantic::Position, VertexAttributeFormat::Float3>,
+	VertexAttribute<VertexSemantic::Normal, VertexAttributeFormat::Float3>,
+	VertexAttribute<VertexSemantic::TexCoord, VertexAttributeFormat::Float2>,
+	VertexAttribute<VertexSemantic::Color, VertexAttributeFormat::Float4>>;
+
+// 量化的位置+法线+纹理坐标+颜色，20字节
+struct PackedLitVertex
+{
+	DirectX::PackedVector::XMHALF4 Pos;
+	DirectX::PackedVector::XMSHORTN2 Normal;
+	DirectX::PackedVector::XMHALF2 TexC;
+	DirectX::PackedVector::XMUBYTEN4 Color;
+};
+
+using PackedLitVertexFormat = VertexFormat<
+	VertexAttribute<VertexSemantic::Position, VertexAttributeFormat::Half4>,
+	VertexAttribute<VertexSemantic::Normal, VertexAttributeFormat::OctSNorm16x2>,
+	VertexAttribute<VertexSemantic::TexCoord, VertexAttributeFormat::Half2>,
+	VertexAttribute<VertexSemantic::Color, VertexAttributeFormat::UNorm8x4>>;
+
+// 带切线的32位浮点格式(法线贴图)，64字节
+using TangentVertexFormat = VertexFormat<
+	VertexAttribute<VertexSemantic::Position, VertexAttributeFormat::Float3>,
+	VertexAttribute<VertexSemantic::Normal, VertexAttributeFormat::Float3>,
+	VertexAttribute<VertexSemantic::Tangent, VertexAttributeFormat::Float4>,
+	VertexAttribute<VertexSemantic::TexCoord, VertexAttributeFormat::Float2>,
+	VertexAttribute<VertexSemantic::Color, VertexAttributeFormat::Float4>>;
+
+// 量化的带切线格式，切线w分量为副切线方向，28字节
+struct PackedTangentVertex
+{
+	DirectX::PackedVector::XMHALF4 Pos;
+	DirectX::PackedVector::XMSHORTN2 Normal;
+	DirectX::PackedVector::XMHALF4 Tangent;
+	DirectX::PackedVector::XMHALF2 TexC;
+	DirectX::PackedVector::XMUBYTEN4 Color;
+};
+
+using PackedTangentVertexFormat = VertexFormat<
+	VertexAttribute<VertexSemantic::Position, VertexAttributeFormat::Half4>,
+	VertexAttribute<VertexSemantic::Normal, VertexAttributeFormat::OctSNorm16x2>,
+	VertexAttribute<VertexSemantic::Tangent, VertexAttributeFormat::Half4>,
+	VertexAttribute<VertexSemantic::TexCoord, VertexAttributeFormat::Half2>,
+	VertexAttribute<VertexSemantic::Color, VertexAttributeFormat::UNorm8x4>>;
+
+// 运行时可识别的顶点格式
+inline bool GetVertexFormatElements(std::uint32_t formatId, std::vector<VertexElementDesc>& outElements, std::uint32_t& outStride)
+{
+	auto assign = [&](auto format)
+	{
+		using Format = decltype(format);
+		const auto elements = Format::GetElements();
+		outElements.assign(elements.begin(), elements.end());
+		outStride = Format::Stride;
+		return true;
+	};
+
+	if (formatId == ColorVertexFormat::GetId())			return assign(ColorVertexFormat());
+	if (formatId == PackedColorVertexFormat::GetId())	return assign(PackedColorVertexFormat());
+	if (formatId == LitVertexFormat::GetId())			return assign(LitVertexFormat());
+	if (formatId == PackedLitVertexFormat::GetId())		return assign(PackedLitVertexFormat());
+	if (formatId == TangentVertexFormat::GetId())		return assign(TangentVertexFormat());
+	if (formatId == PackedTangentVertexFormat::GetId())	return assign(PackedTangentVertexFormat());
+	return false;
+}
+
+
+// 八面体映射编码单位向量，返回[-1,1]范围内的两个分量
+inline DirectX::XMFLOAT2 OctEncode(const DirectX::XMFLOAT3& n)
+{
+	const float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+	if (l1 <= 0.0f)
+		return DirectX::XMFLOAT2(0.0f, 0.0f);
+
+	float x = n.x / l1;
+	float y = n.y / l1;
+	if (n.z < 0.0f)
+	{
+		const float ox = x;
+		x = (1.0f - std::fabs(y)) * (ox >= 0.0f ? 1.0f : -1.0f);
+		y = (1.0f - std::fabs(ox)) * (y >= 0.0f ? 1.0f : -1.0f);
+	}
+	return DirectX::XMFLOAT2(x, y);
+}
+
+inline DirectX::XMFLOAT3 OctDecode(const DirectX::XMFLOAT2& e)
+{
+	float x = e.x;
+	float y = e.y;
+	const float z = 1.0f - std::fabs(x) - std::fabs(y);
+	if (z < 0.0f)
+	{
+		const float ox = x;
+		x = (1.0f - std::fabs(y)) * (ox >= 0.0f ? 1.0f : -1.0f);
+		y = (1.0f - std::fabs(ox)) * (y >= 0.0f ? 1.0f : -1.0f);
+	}
+	const float length = std::sqrt(x * x + y * y + z * z);
+	return DirectX::XMFLOAT3(x / length, y / length, z / length);
+}
+
+
+// 将一种语义的源数据转换为目标格式，写入dst(步长dstStride)
+void EncodeVertexAttribute(const MeshData& mesh, VertexSemantic semantic, VertexAttributeFormat format,
+	std::uint8_t* dst, std::size_t dstStride);
+
+// 将MeshData中的顶点转换为指定顶点格式，源数据中没有的属性使用默认值(法线(0,0,1)，纹理坐标(0,0)，切线(1,0,0,1))
+template<typename Format>
+void EncodeVertices(const MeshData& mesh, std::vector<std::uint8_t>& outData)
+{
+	outData.assign(mesh.Vertices.size() * Format::Stride, 0);
+	if (mesh.Vertices.empty())
+		return;
+
+	for (const VertexElementDesc& element : Format::GetElements())
+		EncodeVertexAttribute(mesh, element.Semantic, element.Format, outData.data() + element.Offset, Format::Stride);
+}
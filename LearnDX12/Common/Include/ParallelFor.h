@@ -0,0 +1,220 @@
+﻿#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// 默认的工作线程数量(包括调用线程)
+inline unsigned GetDefaultThreadCount()
+{
+	unsigned count = std::thread::hardware_concurrency();
+	return count == 0 ? 1 : count;
+}
+
+/**
+*	将[0, count)拆分为若干段，在多个线程上并行调用func(begin, end)
+*	每段不少于minBatch个元素，调用线程同样参与执行，所有段执行完成后返回
+*	每次调用都创建并等待新线程(每个线程数十微秒)，适合加载时的长任务，每帧执行的短任务使用WorkerPool
+*/
+template<typename Func>
+void ParallelFor(std::size_t count, std::size_t minBatch, Func&& func, unsigned threadCount = 0)
+{
+	if (count == 0)
+		return;
+
+	if (threadCount == 0)
+		threadCount = GetDefaultThreadCount();
+	if (minBatch == 0)
+		minBatch = 1;
+
+	// 每个线程领取多个小段，平衡各段耗时不均的情况
+	const std::size_t maxBatches = (count + minBatch - 1) / minBatch;
+	const std::size_t batchCount = std::min<std::size_t>(maxBatches, (std::size_t)threadCount * 4);
+	if (threadCount == 1 || batchCount <= 1)
+	{
+		func((std::size_t)0, count);
+		return;
+	}
+
+	const std::size_t batchSize = (count + batchCount - 1) / batchCount;
+	std::atomic<std::size_t> nextBatch(0);
+	auto worker = [&]()
+	{
+		for (std::size_t b = nextBatch++; b < batchCount; b = nextBatch++)
+		{
+			const std::size_t begin = b * batchSize;
+			const std::size_t end = std::min(begin + batchSize, count);
+			if (begin < end)
+				func(begin, end);
+		}
+	};
+
+	const unsigned helperCount = (unsigned)std::min<std::size_t>(threadCount, batchCount) - 1;
+	std::vector<std::thread> helpers;
+	helpers.reserve(helperCount);
+	for (unsigned t = 0; t < helperCount; ++t)
+		helpers.emplace_back(worker);
+
+	worker();
+
+	for (std::thread& helper : helpers)
+		helper.join();
+}
+
+/**
+*	常驻的工作线程池，供每帧执行的并行循环使用
+*	工作线程在两次任务之间等待条件变量，不重新创建；参与的线程数不超过硬件线程数，避免超额订阅。
+*	调用线程同样参与执行，先完成全部分段时不等待尚未唤醒的工作线程。
+*	同一时间只执行一个任务，任务执行中再次调用(嵌套或其他线程同时调用)时在调用线程上串行执行。
+*/
+class WorkerPool
+{
+public:
+
+	// 包括调用线程共GetDefaultThreadCount()个线程
+	static WorkerPool& GetInstance()
+	{
+		static WorkerPool pool(GetDefaultThreadCount() - 1);
+		return pool;
+	}
+
+	explicit WorkerPool(unsigned helperCount)
+	{
+		Helpers.reserve(helperCount);
+		for (unsigned t = 0; t < helperCount; ++t)
+			Helpers.emplace_back([this]() { WorkerMain(); });
+	}
+
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			Stopping = true;
+		}
+		WakeCondition.notify_all();
+		for (std::thread& helper : Helpers)
+			helper.join();
+	}
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// 包括调用线程
+	unsigned	GetThreadCount() const { return (unsigned)Helpers.size() + 1; }
+
+	// 与::ParallelFor相同，threadCount为0或超过线程池大小时使用全部线程
+	template<typename Func>
+	void	ParallelFor(std::size_t count, std::size_t minBatch, Func&& func, unsigned threadCount = 0)
+	{
+		if (count == 0)
+			return;
+
+		if (threadCount == 0 || threadCount > GetThreadCount())
+			threadCount = GetThreadCount();
+		if (minBatch == 0)
+			minBatch = 1;
+
+		const std::size_t maxBatches = (count + minBatch - 1) / minBatch;
+		const std::size_t batchCount = std::min<std::size_t>(maxBatches, (std::size_t)threadCount * 4);
+		std::unique_lock<std::mutex> runLock(RunMutex, std::try_to_lock);
+		if (threadCount == 1 || batchCount <= 1 || !runLock.owns_lock())
+		{
+			func((std::size_t)0, count);
+			return;
+		}
+
+		Job job;
+		job.Count = count;
+		job.BatchCount = batchCount;
+		job.BatchSize = (count + batchCount - 1) / batchCount;
+		job.Context = &func;
+		job.Invoke = [](void* context, std::size_t begin, std::size_t end) { (*static_cast<std::remove_reference_t<Func>*>(context))(begin, end); };
+		Run(job, (unsigned)std::min<std::size_t>(threadCount, batchCount) - 1);
+	}
+
+private:
+
+	struct Job
+	{
+		std::size_t Count = 0;
+		std::size_t BatchCount = 0;
+		std::size_t BatchSize = 0;
+		std::atomic<std::size_t> NextBatch{ 0 };
+		void* Context = nullptr;
+		void (*Invoke)(void*, std::size_t, std::size_t) = nullptr;
+
+		void	RunBatches()
+		{
+			for (std::size_t b = NextBatch++; b < BatchCount; b = NextBatch++)
+			{
+				const std::size_t begin = b * BatchSize;
+				const std::size_t end = std::min(begin + BatchSize, Count);
+				if (begin < end)
+					Invoke(Context, begin, end);
+			}
+		}
+	};
+
+	void	Run(Job& job, unsigned helperCount)
+	{
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			CurrentJob = &job;
+			++Generation;
+			JoinedCount = 0;
+			RequestedCount = helperCount;
+		}
+		WakeCondition.notify_all();
+
+		job.RunBatches();
+
+		// 关闭任务后不再有工作线程加入，等待已加入的线程完成
+		std::unique_lock<std::mutex> lock(Mutex);
+		CurrentJob = nullptr;
+		DoneCondition.wait(lock, [this]() { return RunningCount == 0; });
+	}
+
+	void	WorkerMain()
+	{
+		std::uint64_t seenGeneration = 0;
+		std::unique_lock<std::mutex> lock(Mutex);
+		for (;;)
+		{
+			WakeCondition.wait(lock, [&]()
+			{
+				return Stopping || (CurrentJob != nullptr && Generation != seenGeneration && JoinedCount < RequestedCount);
+			});
+			if (Stopping)
+				return;
+
+			seenGeneration = Generation;
+			++JoinedCount;
+			++RunningCount;
+			Job* job = CurrentJob;
+			lock.unlock();
+			job->RunBatches();
+			lock.lock();
+			if (--RunningCount == 0)
+				DoneCondition.notify_one();
+		}
+	}
+
+	std::vector<std::thread> Helpers;
+	// 保证同一时间只执行一个任务
+	std::mutex RunMutex;
+
+	std::mutex Mutex;
+	std::condition_variable WakeCondition;
+	std::condition_variable DoneCondition;
+	Job* CurrentJob = nullptr;
+	std::uint64_t Generation = 0;
+	unsigned JoinedCount = 0;
+	unsigned RequestedCount = 0;
+	unsigned RunningCount = 0;
+	bool Stopping = false;
+};
@@ -0,0 +1,195 @@
+﻿#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+*	CPU帧分析
+*	CPU_PROFILE_SCOPE("Name")在作用域结束时将一段耗时写入当前线程的环形缓冲区(单生产者单消费者，无锁)，
+*	CpuProfiler::EndFrame()在帧边界收集所有线程的记录，保留最近MaxCapturedFrames帧，可导出为Chrome trace_event JSON
+*	(chrome://tracing 或 Perfetto中打开)。
+*	定义CPUPROFILER_ENABLED为0时所有宏展开为空语句，不产生任何代码。
+*	开销：一个Scope为两次读取时间戳加一次写入缓冲区，基本等于两次__rdtsc的耗时。
+*	在rdtsc约17ns的虚拟机上实测一个Scope约35ns(FrameBenchmark的cpu_profiler/scope)，超出20ns的目标，超出部分来自时间戳本身；
+*	其他机器上以cpu_profiler/scope输出的ns/op及timestamp_ns为准。
+*/
+#if !defined(CPUPROFILER_ENABLED)
+#define CPUPROFILER_ENABLED 1
+#endif
+
+// x86下使用TSC计时(导出时换算为微秒)，其他平台使用steady_clock
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPUPROFILER_TSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#include <chrono>
+#endif
+
+// 一段耗时，Name需为字符串常量(只保存指针)
+struct CpuProfileEvent
+{
+	const char* Name = nullptr;
+	std::uint64_t Begin = 0;
+	std::uint64_t End = 0;
+	std::uint32_t ThreadIndex = 0;
+};
+
+// 单个线程的环形缓冲区，只有所属线程写入，只有EndFrame读取
+class CpuProfileThreadBuffer
+{
+public:
+
+	static const std::size_t Capacity = 1 << 14;
+
+	explicit CpuProfileThreadBuffer(std::uint32_t threadIndex)
+		: ThreadIndex(threadIndex)
+	{
+	}
+
+	void	Push(const char* name, std::uint64_t begin, std::uint64_t end)
+	{
+		const std::uint64_t head = Head.load(std::memory_order_relaxed);
+		Slot& slot = Slots[head & (Capacity - 1)];
+		slot.Name = name;
+		slot.Begin = begin;
+		slot.End = end;
+		Head.store(head + 1, std::memory_order_release);
+	}
+
+private:
+
+	friend class CpuProfiler;
+
+	struct Slot
+	{
+		const char* Name;
+		std::uint64_t Begin;
+		std::uint64_t End;
+	};
+
+	std::atomic<std::uint64_t> Head{ 0 };
+	// 已读取的位置，只由EndFrame访问
+	std::uint64_t Tail = 0;
+	std::uint32_t ThreadIndex = 0;
+	Slot Slots[Capacity];
+};
+
+class CpuProfiler
+{
+public:
+
+	static CpuProfiler&	GetInstance();
+
+	// 当前时间戳(TSC或steady_clock计数)
+	static std::uint64_t	Now()
+	{
+#if defined(CPUPROFILER_TSC)
+		return __rdtsc();
+#else
+		return (std::uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+	}
+
+	// 当前线程的缓冲区，线程第一次调用时创建
+	static CpuProfileThreadBuffer&	GetThreadBuffer()
+	{
+		CpuProfileThreadBuffer* buffer = CurrentThreadBuffer;
+		return buffer != nullptr ? *buffer : RegisterThread();
+	}
+
+	// 帧边界：收集各线程记录的事件，作为刚结束的一帧保存
+	void	EndFrame();
+
+	// 清空已收集的帧
+	void	Clear();
+
+	// 保留的最近帧数
+	void	SetMaxCapturedFrames(std::size_t frameCount);
+
+	// 环形缓冲区写满后被覆盖而丢失的事件数量(EndFrame调用间隔过长)
+	std::uint64_t	GetDroppedEventCount() const { return DroppedEventCount; }
+
+	// 已收集的帧数及事件
+	std::size_t	GetCapturedFrameCount() const;
+	void	GetCapturedEvents(std::vector<CpuProfileEvent>& outEvents) const;
+
+	// 时间戳计数与微秒的换算
+	double	GetTicksPerMicrosecond() const;
+
+	// 导出已收集的帧，每帧额外输出一个名为Frame的事件
+	void	WriteChromeTrace(std::ostream& stream) const;
+	bool	WriteChromeTrace(const std::string& filename) const;
+
+private:
+
+	CpuProfiler();
+
+	static CpuProfileThreadBuffer&	RegisterThread();
+
+	// 在头文件中以常量初始化，访问时不经过thread_local的初始化包装函数
+	static inline thread_local CpuProfileThreadBuffer* CurrentThreadBuffer = nullptr;
+
+	struct CapturedFrame
+	{
+		std::uint64_t Begin = 0;
+		std::uint64_t End = 0;
+		std::vector<CpuProfileEvent> Events;
+	};
+
+	mutable std::mutex Mutex;
+	std::vector<std::unique_ptr<CpuProfileThreadBuffer>> ThreadBuffers;
+	std::deque<CapturedFrame> Frames;
+	std::size_t MaxCapturedFrames = 300;
+	std::uint64_t FrameBegin = 0;
+	std::uint64_t DroppedEventCount = 0;
+
+	// 换算TSC使用的基准时间
+	std::uint64_t StartTicks = 0;
+	std::int64_t StartNanoseconds = 0;
+};
+
+// 记录所在作用域的耗时
+class CpuProfileScope
+{
+public:
+
+	explicit CpuProfileScope(const char* name)
+		: Buffer(CpuProfiler::GetThreadBuffer()), Name(name), Begin(CpuProfiler::Now())
+	{
+	}
+
+	~CpuProfileScope()
+	{
+		Buffer.Push(Name, Begin, CpuProfiler::Now());
+	}
+
+	CpuProfileScope(const CpuProfileScope&) = delete;
+	CpuProfileScope& operator=(const CpuProfileScope&) = delete;
+
+private:
+
+	CpuProfileThreadBuffer& Buffer;
+	const char* Name;
+	std::uint64_t Begin;
+};
+
+#define CPUPROFILER_CONCAT_INNER(a, b) a##b
+#define CPUPROFILER_CONCAT(a, b) CPUPROFILER_CONCAT_INNER(a, b)
+
+#if CPUPROFILER_ENABLED
+#define CPU_PROFILE_SCOPE(name) CpuProfileScope CPUPROFILER_CONCAT(cpuProfileScope, __LINE__)(name)
+#define CPU_PROFILE_END_FRAME() CpuProfiler::GetInstance().EndFrame()
+#else
+#define CPU_PROFILE_SCOPE(name) ((void)0)
+#define CPU_PROFILE_END_FRAME() ((void)0)
+#endif
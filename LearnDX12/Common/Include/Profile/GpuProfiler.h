@@ -0,0 +1,208 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+*	GPU时间戳查询的创建、写入、解析及读取
+*	D3D12实现见Base/D3D12GpuTimestampBackend.h，HeadlessGpuTimestampBackend在内存中模拟查询堆及回读缓冲区
+*/
+class GpuTimestampBackend
+{
+public:
+
+	virtual ~GpuTimestampBackend() = default;
+
+	// 创建queryCount个时间戳查询及同样大小的回读缓冲区
+	virtual void	CreateQueries(std::uint32_t queryCount) = 0;
+
+	// 在命令列表中写入时间戳(EndQuery)
+	virtual void	WriteTimestamp(std::uint32_t query) = 0;
+
+	// 将[first, first + count)的查询结果解析到回读缓冲区的相同位置(ResolveQueryData)
+	virtual void	ResolveTimestamps(std::uint32_t first, std::uint32_t count) = 0;
+
+	// 读取回读缓冲区，调用前GPU需已执行完对应的ResolveTimestamps
+	virtual bool	ReadTimestamps(std::uint32_t first, std::uint32_t count, std::uint64_t* outTicks) = 0;
+
+	// 时间戳每秒的计数
+	virtual std::uint64_t	GetTimestampFrequency() const = 0;
+};
+
+// 不提交到GPU的时间戳实现，时间戳取自手动推进的计数，CompleteGpuWork()模拟GPU执行完已提交的解析
+class HeadlessGpuTimestampBackend : public GpuTimestampBackend
+{
+public:
+
+	explicit HeadlessGpuTimestampBackend(std::uint64_t frequency = 1000000)
+		: Frequency(frequency)
+	{
+	}
+
+	void	CreateQueries(std::uint32_t queryCount) override;
+	void	WriteTimestamp(std::uint32_t query) override;
+	void	ResolveTimestamps(std::uint32_t first, std::uint32_t count) override;
+	bool	ReadTimestamps(std::uint32_t first, std::uint32_t count, std::uint64_t* outTicks) override;
+	std::uint64_t	GetTimestampFrequency() const override { return Frequency; }
+
+	// 推进之后写入的时间戳
+	void	AdvanceTicks(std::uint64_t ticks) { CurrentTick += ticks; }
+
+	// 执行所有已提交的解析
+	void	CompleteGpuWork();
+
+	std::uint32_t	GetQueryCount() const { return (std::uint32_t)Queries.size(); }
+	std::uint64_t	GetWriteCount() const { return WriteCount; }
+	std::uint64_t	GetReadCount() const { return ReadCount; }
+	// 读取了GPU尚未解析完成的范围的次数(D3D12中会读到旧数据或需要等待GPU)
+	std::uint64_t	GetStaleReadCount() const { return StaleReadCount; }
+
+private:
+
+	struct PendingResolve
+	{
+		std::uint32_t First = 0;
+		std::uint32_t Count = 0;
+	};
+
+	std::uint64_t Frequency = 0;
+	std::uint64_t CurrentTick = 0;
+	std::vector<std::uint64_t> Queries;
+	std::vector<std::uint64_t> Readback;
+	std::vector<PendingResolve> PendingResolves;
+	std::uint64_t WriteCount = 0;
+	std::uint64_t ReadCount = 0;
+	std::uint64_t StaleReadCount = 0;
+};
+
+// 一个Pass的耗时，Name需为字符串常量(只保存指针)
+struct GpuPassTiming
+{
+	const char* Name = nullptr;
+	// 嵌套深度，最外层为0
+	std::uint32_t Depth = 0;
+	double Milliseconds = 0.0;
+};
+
+// 一帧的GPU耗时
+struct GpuFrameTimings
+{
+	std::uint64_t FrameIndex = 0;
+	// BeginFrame到EndFrame之间的耗时
+	double FrameMilliseconds = 0.0;
+	// 按BeginScope的顺序排列
+	std::vector<GpuPassTiming> Passes;
+};
+
+/**
+*	GPU分Pass计时
+*	查询堆按同时在途的帧数(framesInFlight)划分，每帧使用自己的一段：
+*	BeginFrame/EndFrame写入整帧的时间戳，BeginScope/EndScope写入各Pass的时间戳，EndFrame将本帧用到的查询解析到回读缓冲区。
+*	framesInFlight帧后再次使用同一段前读取上次的结果，此时GPU已执行完那一帧(调用方在重用该帧的资源前已等待其围栏)，读取不会等待GPU。
+*	BeginFrame/EndFrame/BeginScope/EndScope需在录制同一命令列表的线程中调用。
+*/
+class GpuProfiler
+{
+public:
+
+	static const std::uint32_t InvalidScope = 0xffffffffu;
+
+	// 按framesInFlight * (2 + 2 * maxScopesPerFrame)创建查询
+	GpuProfiler(GpuTimestampBackend& backend, std::uint32_t framesInFlight, std::uint32_t maxScopesPerFrame = 64);
+
+	GpuProfiler(const GpuProfiler&) = delete;
+	GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+	// 读取framesInFlight帧前的结果并开始记录本帧
+	void	BeginFrame();
+
+	// 结束本帧并解析本帧的查询，未结束的Scope在此结束
+	void	EndFrame();
+
+	// 超出每帧的Scope数量时返回InvalidScope，对应的EndScope不做任何事
+	std::uint32_t	BeginScope(const char* name);
+	void	EndScope(std::uint32_t scope);
+
+	// 最近读取的一帧，尚无结果时HasResults()为false
+	const GpuFrameTimings&	GetLastFrame() const { return LastFrame; }
+	bool	HasResults() const { return HasLastFrame; }
+
+	// 最近读取的一帧中名为name的所有Pass耗时之和
+	double	GetPassMilliseconds(const char* name) const;
+
+	// 已开始的帧数
+	std::uint64_t	GetFrameIndex() const { return FrameIndex; }
+	// 结果相对于当前帧延迟的帧数
+	std::uint32_t	GetFrameLatency() const { return FramesInFlight; }
+	std::uint32_t	GetQueryCount() const { return FramesInFlight * QueriesPerFrame; }
+	// 超出每帧Scope数量而被丢弃的Scope数
+	std::uint64_t	GetDroppedScopeCount() const { return DroppedScopeCount; }
+
+	// 时间戳计数换算为毫秒，end早于begin时(如跨越时钟重置)返回0
+	static double	TicksToMilliseconds(std::uint64_t begin, std::uint64_t end, std::uint64_t frequency);
+
+	// 最近读取的一帧的文本表格
+	void	WriteText(std::ostream& stream) const;
+
+private:
+
+	struct ScopeRecord
+	{
+		const char* Name = nullptr;
+		std::uint32_t Depth = 0;
+		bool Ended = false;
+	};
+
+	struct FrameSlot
+	{
+		std::uint64_t FrameIndex = 0;
+		// 已解析，等待读取
+		bool Pending = false;
+		std::vector<ScopeRecord> Scopes;
+	};
+
+	std::uint32_t	GetFirstQuery(std::uint32_t slot) const { return slot * QueriesPerFrame; }
+	void	ReadSlot(FrameSlot& slot, std::uint32_t slotIndex);
+
+	GpuTimestampBackend& Backend;
+	std::uint32_t FramesInFlight = 0;
+	std::uint32_t MaxScopesPerFrame = 0;
+	// 每帧的查询数：整帧的开始及结束，各Scope的开始及结束
+	std::uint32_t QueriesPerFrame = 0;
+
+	std::vector<FrameSlot> Slots;
+	std::vector<std::uint64_t> ReadTicks;
+	std::uint64_t FrameIndex = 0;
+	std::uint32_t CurrentSlot = 0;
+	std::uint32_t CurrentDepth = 0;
+	bool InFrame = false;
+	std::uint64_t DroppedScopeCount = 0;
+
+	GpuFrameTimings LastFrame;
+	bool HasLastFrame = false;
+};
+
+// 记录所在作用域的GPU耗时
+class GpuProfileScope
+{
+public:
+
+	GpuProfileScope(GpuProfiler& profiler, const char* name)
+		: Profiler(profiler), Scope(profiler.BeginScope(name))
+	{
+	}
+
+	~GpuProfileScope()
+	{
+		Profiler.EndScope(Scope);
+	}
+
+	GpuProfileScope(const GpuProfileScope&) = delete;
+	GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+
+	GpuProfiler& Profiler;
+	std::uint32_t Scope;
+};
@@ -0,0 +1,105 @@
+﻿#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/**
+*	每帧的渲染计数
+*	各线程累加到自己的计数块(只有所属线程写入，不与其他线程竞争)，
+*	RenderCounters::EndFrame()汇总所有线程的计数，与上一帧的差值作为本帧的快照，并维护最近若干帧的滚动平均。
+*/
+enum class RenderCounter : std::uint32_t
+{
+	DrawCalls,				// DrawIndexedInstanced及ExecuteIndirect调用次数
+	PipelineStateChanges,
+	RootSignatureChanges,
+	DescriptorHeapChanges,
+	Barriers,				// ResourceBarrier中的屏障数量
+	UploadBytes,			// CPU写入上传堆的字节数
+	ResourcesCreated,
+	FenceWaits,				// CPU等待GPU围栏的次数
+	Count,
+};
+
+const std::size_t RenderCounterCount = (std::size_t)RenderCounter::Count;
+
+const char*	GetRenderCounterName(RenderCounter counter);
+
+struct RenderCounterSnapshot
+{
+	std::uint64_t FrameIndex = 0;
+	std::uint64_t Values[RenderCounterCount] = {};
+
+	std::uint64_t	Get(RenderCounter counter) const { return Values[(std::size_t)counter]; }
+};
+
+// 单个线程的计数，独占缓存行
+struct alignas(64) RenderCounterThreadBlock
+{
+	std::atomic<std::uint64_t> Values[RenderCounterCount] = {};
+};
+
+class RenderCounters
+{
+public:
+
+	static RenderCounters&	GetInstance();
+
+	static void	Add(RenderCounter counter, std::uint64_t value = 1)
+	{
+		// 只有当前线程写入，读取-写入无需原子加法
+		std::atomic<std::uint64_t>& total = GetThreadBlock().Values[(std::size_t)counter];
+		total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+	// 帧边界：生成本帧的快照
+	void	EndFrame();
+
+	// 最近一帧的快照，尚未调用EndFrame时全部为0
+	RenderCounterSnapshot	GetLastFrame() const;
+
+	// 最近GetHistoryCount()帧的平均值
+	double	GetRollingAverage(RenderCounter counter) const;
+	std::size_t	GetHistoryCount() const;
+
+	// 滚动平均的帧数，修改时清空已有的历史
+	void	SetHistorySize(std::size_t frameCount);
+
+	// 最近一帧及滚动平均的文本表格
+	void	WriteText(std::ostream& stream) const;
+
+private:
+
+	RenderCounters() = default;
+
+	static RenderCounterThreadBlock&	GetThreadBlock()
+	{
+		RenderCounterThreadBlock* block = CurrentThreadBlock;
+		return block != nullptr ? *block : RegisterThread();
+	}
+
+	static RenderCounterThreadBlock&	RegisterThread();
+
+	static thread_local RenderCounterThreadBlock* CurrentThreadBlock;
+
+	mutable std::mutex Mutex;
+	std::vector<std::unique_ptr<RenderCounterThreadBlock>> ThreadBlocks;
+	std::uint64_t PreviousTotals[RenderCounterCount] = {};
+	std::uint64_t FrameIndex = 0;
+
+	// 最近各帧的快照(环形)及其和
+	std::vector<RenderCounterSnapshot> History;
+	std::size_t HistorySize = 60;
+	std::size_t HistoryNext = 0;
+	std::uint64_t HistorySums[RenderCounterCount] = {};
+	RenderCounterSnapshot LastFrame;
+};
+
+inline void CountRender(RenderCounter counter, std::uint64_t value = 1)
+{
+	RenderCounters::Add(counter, value);
+}
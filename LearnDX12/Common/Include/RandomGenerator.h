@@ -0,0 +1,98 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+*	xoshiro128**伪随机数生成器，周期为2^128-1
+*	状态只有16字节，每次生成只需移位、异或与加法，比rand()快且统计质量更好
+*	实例不是线程安全的，多线程时每个线程使用各自的实例(见GetThreadRandom)
+*/
+class RandomGenerator
+{
+public:
+
+	static constexpr std::uint64_t DefaultSeed = 0x9E3779B97F4A7C15ull;
+
+	explicit RandomGenerator(std::uint64_t seed = DefaultSeed) { Seed(seed); }
+
+	// 用SplitMix64将种子展开为状态，相同的种子产生相同的序列
+	void			Seed(std::uint64_t seed);
+
+	// 均匀分布的32位整数
+	std::uint32_t	NextUInt()
+	{
+		const std::uint32_t result = Rotl(mState[1] * 5u, 7) * 9u;
+		const std::uint32_t t = mState[1] << 9;
+		mState[2] ^= mState[0];
+		mState[3] ^= mState[1];
+		mState[1] ^= mState[2];
+		mState[0] ^= mState[3];
+		mState[2] ^= t;
+		mState[3] = Rotl(mState[3], 11);
+		return result;
+	}
+
+	// [0, bound)内的均匀整数(乘法取高位，极少数情况下重新生成以消除偏差)，bound为0时返回0
+	std::uint32_t	NextUInt(std::uint32_t bound);
+
+	// [a, b]内的均匀整数
+	int				NextInt(int a, int b);
+
+	// [0, 1)内的均匀浮点数(取高24位，精度与float尾数一致)
+	float			NextFloat() { return (float)(NextUInt() >> 8) * (1.0f / 16777216.0f); }
+
+	// [a, b)内的均匀浮点数
+	float			NextFloat(float a, float b) { return a + NextFloat() * (b - a); }
+
+	// 相当于生成2^64个数，用于从同一状态派生互不重叠的序列
+	void			Jump();
+
+	static std::uint32_t	Rotl(std::uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+private:
+
+	friend class BatchRandomGenerator;
+
+	std::uint32_t mState[4];
+};
+
+/**
+*	8路并行的xoshiro128**，用于批量生成随机数(粒子初始化、采样点等)
+*	第i路的状态为种子状态Jump i次的结果，各路序列互不重叠
+*	使用AVX2(编译时定义__AVX2__)一次生成8个数，否则使用SSE2每次4个，不支持SIMD时逐路计算，
+*	各实现生成的整数序列完全相同
+*/
+class BatchRandomGenerator
+{
+public:
+
+	static constexpr std::size_t LaneCount = 8;
+
+	explicit BatchRandomGenerator(std::uint64_t seed = RandomGenerator::DefaultSeed) { Seed(seed); }
+
+	void	Seed(std::uint64_t seed);
+
+	// 均匀分布的32位整数。每次按8个一组生成，count不是8的倍数时最后一组多余的数被丢弃
+	void	FillUInts(std::uint32_t* outValues, std::size_t count);
+
+	// [a, b)内的均匀浮点数
+	void	FillFloats(float* outValues, std::size_t count, float a = 0.0f, float b = 1.0f);
+
+	// [a, b]内的均匀整数，使用乘法取高位映射(不重新生成)，每个值的概率偏差不超过(b - a + 1) / 2^32
+	void	FillInts(int* outValues, std::size_t count, int a, int b);
+
+private:
+
+	// mState[k][lane]为第lane路的第k个状态分量，便于按分量整组载入SIMD寄存器
+	alignas(32) std::uint32_t mState[4][LaneCount];
+};
+
+// 当前线程的随机数生成器，首次使用时由全局种子及线程的创建顺序初始化，不同线程的序列互不相关
+RandomGenerator&		GetThreadRandom();
+BatchRandomGenerator&	GetThreadBatchRandom();
+
+/**
+*	设置全局种子并重新初始化当前线程的生成器，用于复现结果
+*	其他已经使用过生成器的线程不受影响；工作线程的序列取决于其首次使用生成器的顺序
+*/
+void	SeedThreadRandom(std::uint64_t seed);
@@ -0,0 +1,111 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "Render/CommandRecorder.h"
+
+/**
+*	Bundle的创建与释放
+*	D3D12实现见Base/D3D12BundleBackend.h，HeadlessBundleBackend将Bundle中的命令保存在内存中
+*/
+class BundleBackend
+{
+public:
+
+	virtual ~BundleBackend() = default;
+
+	// 开始录制一个Bundle，返回的录制接口在EndBundle前有效
+	virtual CommandRecorder&	BeginBundle() = 0;
+
+	// 结束录制并返回Bundle句柄
+	virtual RenderHandle	EndBundle() = 0;
+
+	// 释放Bundle，调用前GPU需已执行完所有引用该Bundle的命令列表
+	virtual void	ReleaseBundle(RenderHandle bundle) = 0;
+};
+
+// 不提交到GPU的Bundle实现，句柄从1开始递增
+class HeadlessBundleBackend : public BundleBackend
+{
+public:
+
+	CommandRecorder&	BeginBundle() override;
+	RenderHandle	EndBundle() override;
+	void	ReleaseBundle(RenderHandle bundle) override;
+
+	// Bundle中录制的命令，bundle不存在时返回nullptr
+	const HeadlessCommandRecorder*	FindBundle(RenderHandle bundle) const;
+
+	std::size_t	GetLiveBundleCount() const { return Bundles.size(); }
+
+private:
+
+	std::unique_ptr<HeadlessCommandRecorder> Recording;
+	std::unordered_map<RenderHandle, std::unique_ptr<HeadlessCommandRecorder>> Bundles;
+	RenderHandle NextHandle = 1;
+};
+
+// 计算Bundle输入的Hash(FNV-1a 64位)，可将上一次的结果作为seed串联多段输入
+std::uint64_t	HashBundleInputs(const void* data, std::size_t byteSize, std::uint64_t seed = 0xcbf29ce484222325ull);
+
+struct BundleCacheStats
+{
+	// 重新录制的次数(首次录制及输入变化)
+	std::uint32_t RecordCount = 0;
+	// 直接重用已有Bundle的次数
+	std::uint32_t ReuseCount = 0;
+	std::uint32_t ReleaseCount = 0;
+};
+
+/**
+*	Bundle缓存
+*	每个Bundle以调用方指定的id标识，并记录录制时输入(状态、缓冲区、绘制参数)的Hash；
+*	Hash变化或被Invalidate时释放旧的Bundle并重新录制，否则直接返回已录制的Bundle。
+*	Bundle继承调用方的描述符堆，执行前调用方需设置与Bundle内相同的描述符堆。
+*/
+class BundleCache
+{
+public:
+
+	using RecordFunc = std::function<void(CommandRecorder& bundleRecorder)>;
+
+	explicit BundleCache(BundleBackend& backend)
+		: Backend(backend)
+	{
+	}
+
+	~BundleCache();
+
+	BundleCache(const BundleCache&) = delete;
+	BundleCache& operator=(const BundleCache&) = delete;
+
+	// 返回id对应的Bundle，不存在或inputHash变化时调用record重新录制
+	RenderHandle	GetOrRecord(std::uint64_t id, std::uint64_t inputHash, const RecordFunc& record);
+
+	// 下次GetOrRecord时重新录制
+	void	Invalidate(std::uint64_t id);
+
+	// 释放所有Bundle
+	void	Clear();
+
+	bool	Contains(std::uint64_t id) const { return Entries.find(id) != Entries.end(); }
+
+	std::size_t	GetBundleCount() const { return Entries.size(); }
+
+	const BundleCacheStats&	GetStats() const { return Stats; }
+
+private:
+
+	struct Entry
+	{
+		RenderHandle Bundle = 0;
+		std::uint64_t InputHash = 0;
+	};
+
+	BundleBackend& Backend;
+	std::unordered_map<std::uint64_t, Entry> Entries;
+	BundleCacheStats Stats;
+};
@@ -0,0 +1,117 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 录制接口中的GPU对象句柄: 管线状态/根签名/描述符堆为对象指针，描述符及缓冲区为GPU地址
+using RenderHandle = std::uint64_t;
+
+// D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST
+const std::uint32_t PrimitiveTopologyTriangleList = 4;
+
+struct VertexBufferBinding
+{
+	RenderHandle BufferLocation = 0;
+	std::uint32_t SizeInBytes = 0;
+	std::uint32_t StrideInBytes = 0;
+};
+
+struct IndexBufferBinding
+{
+	RenderHandle BufferLocation = 0;
+	std::uint32_t SizeInBytes = 0;
+	// 2或4
+	std::uint32_t IndexByteSize = 2;
+};
+
+/**
+*	绘制命令录制接口
+*	渲染逻辑通过该接口录制命令: D3D12CommandRecorder(Base/D3D12CommandRecorder.h)转发到ID3D12GraphicsCommandList，
+*	HeadlessCommandRecorder只把命令写入内存，不需要GPU，用于测量CPU录制开销及检查录制的命令序列。
+*/
+class CommandRecorder
+{
+public:
+
+	virtual ~CommandRecorder() = default;
+
+	virtual void	SetPipelineState(RenderHandle pipelineState) = 0;
+	virtual void	SetGraphicsRootSignature(RenderHandle rootSignature) = 0;
+	virtual void	SetDescriptorHeap(RenderHandle descriptorHeap) = 0;
+	virtual void	SetGraphicsRootDescriptorTable(std::uint32_t rootParameterIndex, RenderHandle baseDescriptor) = 0;
+	virtual void	SetVertexBuffer(const VertexBufferBinding& binding) = 0;
+	virtual void	SetIndexBuffer(const IndexBufferBinding& binding) = 0;
+	// 值与D3D_PRIMITIVE_TOPOLOGY相同
+	virtual void	SetPrimitiveTopology(std::uint32_t topology) = 0;
+	virtual void	SetGraphicsRoot32BitConstant(std::uint32_t rootParameterIndex, std::uint32_t value, std::uint32_t destOffsetIn32BitValues) = 0;
+	virtual void	DrawIndexedInstanced(std::uint32_t indexCount, std::uint32_t instanceCount, std::uint32_t startIndexLocation,
+		std::int32_t baseVertexLocation, std::uint32_t startInstanceLocation) = 0;
+	// commandSignature为ID3D12CommandSignature，argumentBuffer为存放参数的ID3D12Resource
+	virtual void	ExecuteIndirect(RenderHandle commandSignature, std::uint32_t maxCommandCount, RenderHandle argumentBuffer, std::uint64_t argumentBufferOffset) = 0;
+	// bundle为已关闭的Bundle命令列表
+	virtual void	ExecuteBundle(RenderHandle bundle) = 0;
+};
+
+enum class RecordedCommandType : std::uint32_t
+{
+	SetPipelineState,
+	SetGraphicsRootSignature,
+	SetDescriptorHeap,
+	SetGraphicsRootDescriptorTable,
+	SetVertexBuffer,
+	SetIndexBuffer,
+	SetPrimitiveTopology,
+	SetGraphicsRoot32BitConstant,
+	DrawIndexedInstanced,
+	ExecuteIndirect,
+	ExecuteBundle,
+	Count,
+};
+
+// 录制的一条命令，Handle及Args的含义与对应接口的参数顺序一致
+struct RecordedCommand
+{
+	RecordedCommandType Type;
+	std::uint32_t Args[5];
+	RenderHandle Handle;
+};
+
+// 不提交到GPU的录制实现，命令按顺序写入连续的数组
+class HeadlessCommandRecorder : public CommandRecorder
+{
+public:
+
+	// 清空录制的命令(保留已分配的内存)
+	void	Reset();
+
+	void	SetPipelineState(RenderHandle pipelineState) override;
+	void	SetGraphicsRootSignature(RenderHandle rootSignature) override;
+	void	SetDescriptorHeap(RenderHandle descriptorHeap) override;
+	void	SetGraphicsRootDescriptorTable(std::uint32_t rootParameterIndex, RenderHandle baseDescriptor) override;
+	void	SetVertexBuffer(const VertexBufferBinding& binding) override;
+	void	SetIndexBuffer(const IndexBufferBinding& binding) override;
+	void	SetPrimitiveTopology(std::uint32_t topology) override;
+	void	SetGraphicsRoot32BitConstant(std::uint32_t rootParameterIndex, std::uint32_t value, std::uint32_t destOffsetIn32BitValues) override;
+	void	DrawIndexedInstanced(std::uint32_t indexCount, std::uint32_t instanceCount, std::uint32_t startIndexLocation,
+		std::int32_t baseVertexLocation, std::uint32_t startInstanceLocation) override;
+	void	ExecuteIndirect(RenderHandle commandSignature, std::uint32_t maxCommandCount, RenderHandle argumentBuffer, std::uint64_t argumentBufferOffset) override;
+	void	ExecuteBundle(RenderHandle bundle) override;
+
+	const std::vector<RecordedCommand>& GetCommands() const { return Commands; }
+
+	std::size_t	GetCommandCount(RecordedCommandType type) const { return Counts[(std::size_t)type]; }
+
+	// 状态设置命令的数量(除绘制及执行Bundle外的所有命令)
+	std::size_t	GetStateCommandCount() const
+	{
+		return Commands.size() - GetCommandCount(RecordedCommandType::DrawIndexedInstanced) - GetCommandCount(RecordedCommandType::ExecuteIndirect)
+			- GetCommandCount(RecordedCommandType::ExecuteBundle);
+	}
+
+private:
+
+	void	Record(RecordedCommandType type, RenderHandle handle, std::uint32_t a0 = 0, std::uint32_t a1 = 0, std::uint32_t a2 = 0, std::uint32_t a3 = 0, std::uint32_t a4 = 0);
+
+	std::vector<RecordedCommand> Commands;
+	std::size_t Counts[(std::size_t)RecordedCommandType::Count] = {};
+};
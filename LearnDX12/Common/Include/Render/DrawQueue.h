@@ -0,0 +1,109 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Render/CommandRecorder.h"
+
+/**
+*	64位绘制排序键，高位优先:
+*	Pass(4) | PipelineState(12) | RootSignature(8) | Material(16) | Depth(24)
+*	同一Pass内按PSO、根签名、材质分组，状态相同时按深度由近到远排列。
+*/
+const std::uint32_t DrawSortKeyPassBits = 4;
+const std::uint32_t DrawSortKeyPipelineStateBits = 12;
+const std::uint32_t DrawSortKeyRootSignatureBits = 8;
+const std::uint32_t DrawSortKeyMaterialBits = 16;
+const std::uint32_t DrawSortKeyDepthBits = 24;
+
+// 各字段超出位数时截断
+inline std::uint64_t MakeDrawSortKey(std::uint32_t pass, std::uint32_t pipelineState, std::uint32_t rootSignature, std::uint32_t material, std::uint32_t depth)
+{
+	std::uint64_t key = pass & ((1u << DrawSortKeyPassBits) - 1);
+	key = (key << DrawSortKeyPipelineStateBits) | (pipelineState & ((1u << DrawSortKeyPipelineStateBits) - 1));
+	key = (key << DrawSortKeyRootSignatureBits) | (rootSignature & ((1u << DrawSortKeyRootSignatureBits) - 1));
+	key = (key << DrawSortKeyMaterialBits) | (material & ((1u << DrawSortKeyMaterialBits) - 1));
+	key = (key << DrawSortKeyDepthBits) | (depth & ((1u << DrawSortKeyDepthBits) - 1));
+	return key;
+}
+
+// 将[0, maxDepth]范围内的深度量化为排序键中的深度字段
+inline std::uint32_t QuantizeDrawDepth(float depth, float maxDepth)
+{
+	const float maxValue = (float)((1u << DrawSortKeyDepthBits) - 1);
+	const float t = maxDepth > 0.0f ? depth / maxDepth : 0.0f;
+	return t <= 0.0f ? 0u : (t >= 1.0f ? (std::uint32_t)maxValue : (std::uint32_t)(t * maxValue));
+}
+
+// 为PSO/根签名/材质等对象分配排序键中使用的编号(同一句柄始终返回相同编号，0句柄为0)，应在加载时调用并缓存结果
+std::uint32_t	GetRenderStateId(RenderHandle handle);
+
+// 一次绘制需要的全部状态及绘制参数
+struct DrawPacket
+{
+	RenderHandle PipelineState = 0;
+	RenderHandle RootSignature = 0;
+	RenderHandle DescriptorHeap = 0;
+	RenderHandle DescriptorTable = 0;
+	VertexBufferBinding VertexBuffer;
+	IndexBufferBinding IndexBuffer;
+	std::uint32_t Topology = PrimitiveTopologyTriangleList;
+
+	std::uint32_t IndexCount = 0;
+	std::uint32_t InstanceCount = 1;
+	std::uint32_t StartIndexLocation = 0;
+	std::int32_t BaseVertexLocation = 0;
+	std::uint32_t StartInstanceLocation = 0;
+};
+
+struct DrawSortEntry
+{
+	std::uint64_t Key;
+	std::uint32_t Packet;
+};
+
+struct DrawQueueStats
+{
+	std::uint32_t PacketCount = 0;
+	// 实际设置的状态数量
+	std::uint32_t StateCallCount = 0;
+	// 与前一次绘制相同而省略的状态数量(每次绘制都设置全部7项状态时的数量减去StateCallCount)
+	std::uint32_t RedundantStateCallCount = 0;
+};
+
+/**
+*	按LSD基数排序(每次8位，所有键该位相同时跳过)对entries稳定排序，scratch至少count个元素
+*	结果位于entries中
+*/
+void	RadixSortDrawKeys(DrawSortEntry* entries, DrawSortEntry* scratch, std::size_t count);
+
+/**
+*	绘制队列
+*	每帧收集各物体的DrawPacket及排序键，排序后按顺序录制，只设置与前一次绘制不同的状态。
+*	设置根签名或描述符堆后根参数失效，此时重新设置描述符表。
+*/
+class DrawQueue
+{
+public:
+
+	// 清空本帧的绘制(保留已分配的内存)
+	void	Reset();
+
+	void	Reserve(std::size_t packetCount);
+
+	void	Add(std::uint64_t sortKey, const DrawPacket& packet);
+
+	void	Sort();
+
+	// 按排序后的顺序录制
+	void	Execute(CommandRecorder& recorder, DrawQueueStats* pStats = nullptr) const;
+
+	std::size_t	GetPacketCount() const { return Packets.size(); }
+
+	const std::vector<DrawSortEntry>&	GetSortedEntries() const { return Entries; }
+
+private:
+
+	std::vector<DrawPacket> Packets;
+	std::vector<DrawSortEntry> Entries;
+	std::vector<DrawSortEntry> Scratch;
+};
@@ -0,0 +1,105 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mesh/Meshlet.h"
+#include "Render/DrawQueue.h"
+
+/**
+*	ExecuteIndirect的一条命令：1个32位根常量 + D3D12_DRAW_INDEXED_ARGUMENTS，24字节
+*	命令签名不包含根常量时参数从IndexCountPerInstance开始，步长相同
+*/
+struct IndirectDrawArguments
+{
+	std::uint32_t RootConstant = 0;
+	std::uint32_t IndexCountPerInstance = 0;
+	std::uint32_t InstanceCount = 1;
+	std::uint32_t StartIndexLocation = 0;
+	std::int32_t BaseVertexLocation = 0;
+	std::uint32_t StartInstanceLocation = 0;
+};
+
+static_assert(sizeof(IndirectDrawArguments) == 24, "IndirectDrawArguments must match the command signature stride");
+
+// 绘制参数在IndirectDrawArguments中的偏移(不使用根常量的命令签名)
+const std::uint64_t IndirectDrawArgumentsDrawOffset = 4;
+
+/**
+*	一组可间接绘制的物体
+*	包围球按分量分开存储(SoA)，剔除时每次读取4个物体
+*/
+struct IndirectDrawList
+{
+	std::vector<float> CenterX;
+	std::vector<float> CenterY;
+	std::vector<float> CenterZ;
+	std::vector<float> Radius;
+	std::vector<IndirectDrawArguments> Arguments;
+
+	void	Add(const DirectX::XMFLOAT3& center, float radius, const IndirectDrawArguments& arguments)
+	{
+		CenterX.push_back(center.x);
+		CenterY.push_back(center.y);
+		CenterZ.push_back(center.z);
+		Radius.push_back(radius);
+		Arguments.push_back(arguments);
+	}
+
+	void	Clear()
+	{
+		CenterX.clear();
+		CenterY.clear();
+		CenterZ.clear();
+		Radius.clear();
+		Arguments.clear();
+	}
+
+	std::size_t	GetCount() const { return Arguments.size(); }
+};
+
+/**
+*	使用相同状态的一组间接绘制，录制时一次ExecuteIndirect
+*	State中的绘制参数部分不使用
+*/
+struct IndirectDrawBucket
+{
+	DrawPacket State;
+	// 为true时每条命令先将RootConstant写入RootConstantParameterIndex指定的根参数
+	bool UseRootConstant = false;
+	std::uint32_t RootConstantParameterIndex = 0;
+	IndirectDrawList Draws;
+};
+
+/**
+*	间接绘制参数生成
+*	剔除与视锥体不相交的物体，将可见物体的参数按原顺序紧密写入参数缓冲区(通常为映射后的上传堆)。
+*	剔除每次处理4个物体(支持SSE时使用SIMD指令)，物体较多时分段在WorkerPool上并行：先统计各段的可见数量，
+*	由前缀和得到各段的写入位置后再并行写入，结果与单线程相同。
+*/
+class IndirectArgumentBuilder
+{
+public:
+
+	// 将draws中与视锥体相交的物体写入outArguments(至少draws.GetCount()个元素)，pView为nullptr时不剔除，返回写入的数量
+	std::uint32_t	Build(const IndirectDrawList& draws, const MeshletCullView* pView, IndirectDrawArguments* outArguments, unsigned threadCount = 0);
+
+	/**
+	*	生成参数并录制一个桶：可见物体不为0时设置桶的状态并调用一次ExecuteIndirect
+	*	outArguments为argumentBuffer中argumentBufferOffset处映射后的地址，返回可见物体数量
+	*/
+	std::uint32_t	Record(CommandRecorder& recorder, const IndirectDrawBucket& bucket, const MeshletCullView* pView,
+		RenderHandle commandSignature, IndirectDrawArguments* outArguments, RenderHandle argumentBuffer, std::uint64_t argumentBufferOffset,
+		unsigned threadCount = 0);
+
+	// 每段物体数量
+	static const std::size_t ChunkSize = 4096;
+	// 少于此数量时串行执行：每个物体的剔除及写入约5ns，16384个物体约80us，低于此规模时唤醒工作线程的开销抵消并行的收益
+	static const std::size_t ParallelMinCount = 16384;
+
+private:
+
+	// 每4个物体的可见掩码(低4位)
+	std::vector<std::uint8_t> VisibleMasks;
+	// 各段的写入位置，最后一项为可见物体总数
+	std::vector<std::uint32_t> ChunkOffsets;
+};
@@ -0,0 +1,14 @@
+﻿#pragma once
+#include <DirectXMath.h>
+#include "MathHelper.h"
+
+// 材质常量，不依赖D3D12，可在工具及基准测试中使用
+struct MaterialConstants
+{
+	DirectX::XMFLOAT4 DiffuseAlbedo = { 1.0f, 1.0f, 1.0f, 1.0f };
+	DirectX::XMFLOAT3 FresnelR0 = { 0.01f, 0.01f, 0.01f };
+	float Roughness = 0.25f;
+
+	// Used in texture mapping.
+	DirectX::XMFLOAT4X4 MatTransform = MathHelper::Identity4x4();
+};
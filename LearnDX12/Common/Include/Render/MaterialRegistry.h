@@ -0,0 +1,79 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Render/MaterialConstants.h"
+
+const std::uint32_t InvalidMaterialIndex = 0xFFFFFFFFu;
+
+struct MaterialUploadStats
+{
+	// 本次写入的材质数量及字节数
+	std::uint32_t UploadedCount = 0;
+	std::uint64_t UploadBytes = 0;
+	// 写入后仍需在之后的帧资源中写入的材质数量
+	std::uint32_t PendingCount = 0;
+};
+
+/**
+*	材质注册表
+*	所有材质的常量紧密存放在一个数组中，下标即材质在每个帧资源的材质缓冲区(常量缓冲区数组或StructuredBuffer)中的位置(MatCBIndex)。
+*	修改材质时将其加入脏列表并记录剩余帧数(帧资源数量)，每帧Upload只遍历脏列表，
+*	将其中的材质写入当前帧资源的缓冲区，剩余帧数减为0的材质从列表中移除。材质不变化时每帧不写入任何数据。
+*	帧资源按顺序轮流使用，每个帧资源的缓冲区创建后应先用WriteAll写入全部材质。
+*/
+class MaterialRegistry
+{
+public:
+
+	// frameResourceCount通常为gNumFrameResources
+	explicit MaterialRegistry(std::uint32_t frameResourceCount);
+
+	// 添加材质，返回其下标；名称已存在时返回InvalidMaterialIndex
+	std::uint32_t	Add(const std::string& name, const MaterialConstants& constants);
+
+	// 不存在时返回InvalidMaterialIndex
+	std::uint32_t	Find(const std::string& name) const;
+
+	const std::string&			GetName(std::uint32_t index) const { return Names[index]; }
+	const MaterialConstants&	Get(std::uint32_t index) const { return Constants[index]; }
+
+	// 修改材质常量并标记为脏
+	void	Set(std::uint32_t index, const MaterialConstants& constants);
+
+	// 直接修改Get返回的常量后调用；已在脏列表中的材质重新计算剩余帧数
+	void	MarkDirty(std::uint32_t index);
+
+	void	Reserve(std::size_t count);
+
+	std::size_t		GetCount() const { return Constants.size(); }
+	std::size_t		GetDirtyCount() const { return DirtyList.size(); }
+	std::uint32_t	GetFrameResourceCount() const { return FrameResourceCount; }
+
+	// 紧密排列的常量数组(StructuredBuffer的初始数据)
+	const MaterialConstants*	GetConstants() const { return Constants.data(); }
+
+	/**
+	*	将脏列表中的材质写入当前帧资源的缓冲区
+	*	mappedData为映射后的首地址，stride为元素步长(常量缓冲区为256字节对齐的大小，StructuredBuffer为sizeof(MaterialConstants))
+	*	返回写入的材质数量
+	*/
+	std::uint32_t	Upload(void* mappedData, std::size_t stride, MaterialUploadStats* pStats = nullptr);
+
+	// 写入所有材质(新创建的帧资源缓冲区)，不改变脏列表
+	void	WriteAll(void* mappedData, std::size_t stride) const;
+
+private:
+
+	std::uint32_t FrameResourceCount;
+
+	std::vector<MaterialConstants> Constants;
+	std::vector<std::string> Names;
+	std::unordered_map<std::string, std::uint32_t> NameIndices;
+
+	// 各材质还需写入的帧数，大于0时材质位于脏列表中
+	std::vector<std::uint32_t> FramesDirty;
+	std::vector<std::uint32_t> DirtyList;
+};
@@ -0,0 +1,111 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include "Mesh/Meshlet.h"
+
+/**
+*	渲染物体句柄：槽位下标 + 代数
+*	删除物体后槽位的代数加1，旧句柄随之失效；槽位可被之后创建的物体复用
+*/
+struct RenderableHandle
+{
+	std::uint32_t Slot = 0xFFFFFFFFu;
+	std::uint32_t Generation = 0;
+
+	bool	operator==(const RenderableHandle& rhs) const { return Slot == rhs.Slot && Generation == rhs.Generation; }
+	bool	operator!=(const RenderableHandle& rhs) const { return !(*this == rhs); }
+};
+
+const std::uint32_t InvalidRenderableIndex = 0xFFFFFFFFu;
+
+// 可见性标记
+enum RenderableVisibility : std::uint8_t
+{
+	RenderableHidden = 0,
+	RenderableVisible = 1,		// 参与剔除及绘制
+	RenderableCastShadow = 2,
+};
+
+struct RenderableDesc
+{
+	DirectX::XMFLOAT4X4 World = DirectX::XMFLOAT4X4(1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+	// 世界空间的包围盒
+	DirectX::BoundingBox Bounds;
+	std::uint32_t MeshId = 0;
+	std::uint32_t MaterialId = 0;
+	std::uint8_t Visibility = RenderableVisible;
+};
+
+/**
+*	数据导向的场景物体存储
+*	每种组件(世界矩阵、包围盒、模型、材质、可见性)各自存放在连续数组中，所有存活物体紧密排列在[0, GetCount())，
+*	每帧的循环(剔除、常量上传、排序键生成)只遍历需要的组件数组。
+*	删除时末尾物体移动到被删除的位置(swap-remove)，因此dense下标会变化，长期引用物体应使用句柄。
+*/
+class SceneStore
+{
+public:
+
+	RenderableHandle	Create(const RenderableDesc& desc);
+
+	// 句柄无效时返回false
+	bool	Destroy(RenderableHandle handle);
+
+	bool	IsAlive(RenderableHandle handle) const;
+
+	// 句柄对应的dense下标，句柄无效时返回InvalidRenderableIndex
+	std::uint32_t	GetIndex(RenderableHandle handle) const;
+
+	// dense下标对应的句柄
+	RenderableHandle	GetHandle(std::uint32_t index) const { return RenderableHandle{ DenseSlots[index], Slots[DenseSlots[index]].Generation }; }
+
+	void	Reserve(std::size_t count);
+
+	// 删除所有物体，所有句柄失效
+	void	Clear();
+
+	std::size_t	GetCount() const { return DenseSlots.size(); }
+
+	// 通过句柄修改组件，句柄无效时不做任何事
+	void	SetWorld(RenderableHandle handle, const DirectX::XMFLOAT4X4& world, const DirectX::BoundingBox& bounds);
+	void	SetMaterial(RenderableHandle handle, std::uint32_t materialId);
+	void	SetVisibility(RenderableHandle handle, std::uint8_t visibility);
+
+	// 组件数组，长度为GetCount()
+	const DirectX::XMFLOAT4X4*	GetWorlds() const { return Worlds.data(); }
+	DirectX::XMFLOAT4X4*		GetWorlds() { return Worlds.data(); }
+	const DirectX::BoundingBox*	GetBounds() const { return Bounds.data(); }
+	DirectX::BoundingBox*		GetBounds() { return Bounds.data(); }
+	const std::uint32_t*		GetMeshIds() const { return MeshIds.data(); }
+	const std::uint32_t*		GetMaterialIds() const { return MaterialIds.data(); }
+	const std::uint8_t*			GetVisibility() const { return Visibility.data(); }
+
+	/**
+	*	剔除：带RenderableVisible标记且包围盒与视锥体相交的物体的dense下标按顺序写入outIndices(先清空)
+	*	只读取可见性及包围盒数组
+	*/
+	void	CullVisible(const MeshletCullView& view, std::vector<std::uint32_t>& outIndices) const;
+
+private:
+
+	// 存活时Dense为物体的dense下标，空闲时为下一个空闲槽位
+	struct SlotEntry
+	{
+		std::uint32_t Dense = 0;
+		std::uint32_t Generation = 1;
+	};
+
+	std::vector<DirectX::XMFLOAT4X4> Worlds;
+	std::vector<DirectX::BoundingBox> Bounds;
+	std::vector<std::uint32_t> MeshIds;
+	std::vector<std::uint32_t> MaterialIds;
+	std::vector<std::uint8_t> Visibility;
+	// dense下标对应的槽位
+	std::vector<std::uint32_t> DenseSlots;
+
+	std::vector<SlotEntry> Slots;
+	std::uint32_t FreeSlot = 0xFFFFFFFFu;
+};
@@ -0,0 +1,81 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+#include "Mesh/MeshData.h"
+#include "Mesh/MeshIndexing.h"
+#include "Mesh/Meshlet.h"
+#include "Render/CommandRecorder.h"
+
+// 参与静态合批的一个物体，只合并LOD0的子集
+struct StaticBatchInstance
+{
+	const MeshData* Mesh = nullptr;
+	// 行向量约定(p' = p * World)
+	DirectX::XMFLOAT4X4 World;
+	// 物体使用的渲染状态(PSO/根签名/材质)，相同的物体合并到同一批次
+	std::uint64_t StateKey = 0;
+};
+
+struct StaticBatchOptions
+{
+	// 空间单元边长，物体按世界空间包围盒中心所在的单元分组，每个单元至少一次绘制以保留剔除粒度；0表示不按空间拆分
+	float CellSize = 32.0f;
+	// 一次绘制引用的最大顶点数，超过时拆分为多次绘制，使合并结果可以使用16位索引
+	std::uint32_t MaxVerticesPerDraw = MaxVerticesPer16BitSubset;
+	unsigned ThreadCount = 0;
+};
+
+/**
+*	StateKey相同的物体合并后的顶点/索引数据
+*	顶点已变换到世界空间，Mesh.Subsets中每个子集为一次绘制(Bounds为世界空间包围盒)，
+*	子集内的索引相对于BaseVertexLocation。源网格中没有的附加属性使用默认值(法线(0,0,1)，纹理坐标(0,0)，切线(1,0,0,1))。
+*/
+struct StaticBatch
+{
+	std::uint64_t StateKey = 0;
+	MeshData Mesh;
+};
+
+struct StaticBatchStats
+{
+	std::uint32_t InstanceCount = 0;
+	// 合并前(每个物体的每个LOD0子集一次)及合并后的绘制次数
+	std::uint32_t SourceDrawCount = 0;
+	std::uint32_t DrawCount = 0;
+	std::uint32_t BatchCount = 0;
+	std::uint64_t VertexCount = 0;
+	std::uint64_t IndexCount = 0;
+};
+
+// 录制一个静态批次需要的GPU状态及缓冲区
+struct StaticBatchBinding
+{
+	RenderHandle PipelineState = 0;
+	RenderHandle RootSignature = 0;
+	RenderHandle DescriptorHeap = 0;
+	RenderHandle DescriptorTable = 0;
+	VertexBufferBinding VertexBuffer;
+	IndexBufferBinding IndexBuffer;
+};
+
+/**
+*	静态合批
+*	加载时将渲染状态相同的静态物体变换到世界空间并合并到同一顶点/索引缓冲区，
+*	绘制时每个批次只设置一次状态，每个空间单元一次DrawIndexedInstanced。
+*	镜像变换(行列式小于0)的物体翻转三角形绕序及切线w分量。
+*/
+class StaticBatcher
+{
+public:
+
+	static void	Build(const StaticBatchInstance* instances, std::size_t instanceCount, const StaticBatchOptions& options,
+		std::vector<StaticBatch>& outBatches, StaticBatchStats* pStats = nullptr);
+
+	// 录制批次中与视锥体相交的绘制(pView为nullptr时不剔除)，没有可见绘制时不设置状态，返回绘制次数
+	static std::uint32_t	Record(CommandRecorder& recorder, const StaticBatch& batch, const StaticBatchBinding& binding, const MeshletCullView* pView = nullptr);
+
+	// 世界空间包围盒是否完全位于视锥体外
+	static bool	IsOutsideFrustum(const MeshletCullView& view, const DirectX::BoundingBox& bounds);
+};
@@ -0,0 +1,115 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+// 节点编号，创建后不变(节点在数组中的位置会在结构变化后重新排序)
+typedef std::uint32_t TransformId;
+const TransformId InvalidTransformId = 0xFFFFFFFFu;
+
+struct TransformHierarchyStats
+{
+	std::uint32_t NodeCount = 0;
+	std::uint32_t LevelCount = 0;
+	// 本次重新计算世界矩阵的节点数(SetLocal的节点及其所有子孙)
+	std::uint32_t UpdatedCount = 0;
+	// 本次是否因创建/删除节点重新排序
+	bool Rebuilt = false;
+};
+
+/**
+*	变换层级
+*	局部矩阵与世界矩阵按深度排序后分别存放在连续数组中(SoA)，父节点总在子节点之前，同一深度的节点连续存放。
+*	SetLocal只标记节点，Update从最浅的脏节点所在层开始逐层计算：节点自身被标记或父节点本次已更新时重新计算，
+*	同一层的节点互不依赖，较多时分段在WorkerPool上并行。未被标记的子树不计算。
+*	世界矩阵数组可直接用于常量上传，GetChangedIndices给出本次变化的下标，只需上传这些节点。
+*	矩阵为行向量约定：World = Local * ParentWorld。
+*/
+class TransformHierarchy
+{
+public:
+
+	// 创建节点，parent为InvalidTransformId时为根节点。新节点在下次Update时排序并计算世界矩阵
+	TransformId	Create(const DirectX::XMFLOAT4X4& local, TransformId parent = InvalidTransformId);
+
+	// 删除节点及其所有子孙节点，下次Update时从数组中移除
+	void		Destroy(TransformId id);
+
+	bool		IsValid(TransformId id) const;
+
+	void		Reserve(std::size_t nodeCount);
+
+	void		Clear();
+
+	void		SetLocal(TransformId id, const DirectX::XMFLOAT4X4& local);
+	const DirectX::XMFLOAT4X4&	GetLocal(TransformId id) const { return Locals[Indices[id]]; }
+
+	// 最近一次Update的结果
+	const DirectX::XMFLOAT4X4&	GetWorld(TransformId id) const { return Worlds[Indices[id]]; }
+
+	TransformId	GetParent(TransformId id) const;
+
+	/**
+	*	更新世界矩阵。创建/删除节点后先按深度重新排序，此时所有节点都重新计算(数组下标已改变，使用者需全部重新上传)
+	*	每层节点数不少于ParallelMinCount时使用threadCount个线程(0为默认数量)
+	*/
+	void		Update(unsigned threadCount = 0, TransformHierarchyStats* pStats = nullptr);
+
+	// 以下数组按深度排序，下标为GetIndex的结果，在Update后有效
+	std::size_t	GetCount() const { return Ids.size(); }
+	std::uint32_t	GetIndex(TransformId id) const { return Indices[id]; }
+	const DirectX::XMFLOAT4X4*	GetWorldMatrices() const { return Worlds.data(); }
+	const TransformId*			GetIds() const { return Ids.data(); }
+
+	// 上次Update中世界矩阵变化的节点下标(升序)
+	const std::vector<std::uint32_t>&	GetChangedIndices() const { return ChangedIndices; }
+
+	// 深度为level的节点下标范围[GetLevelBegin(level), GetLevelBegin(level + 1))
+	std::size_t	GetLevelCount() const { return LevelBegins.empty() ? 0 : LevelBegins.size() - 1; }
+	std::uint32_t	GetLevelBegin(std::size_t level) const { return LevelBegins[level]; }
+
+	// 每段处理的节点数量
+	static const std::size_t ParallelBatchSize = 4096;
+	// 一层的节点少于此数量时串行计算：每个节点约10~20ns，8192个节点约0.1ms，低于此规模时唤醒工作线程的开销抵消并行的收益
+	static const std::size_t ParallelMinCount = 8192;
+	// 收集变化节点只检查标记(每个节点约1ns)，节点少于此数量时串行
+	static const std::size_t CollectParallelMinCount = 65536;
+
+private:
+
+	enum NodeFlags : std::uint8_t
+	{
+		LocalDirty = 1,		// SetLocal后尚未更新
+		WorldChanged = 2,	// 上次Update中世界矩阵已重新计算
+		Destroyed = 4,
+	};
+
+	// 按深度重新排序，移除已删除的节点
+	void		Rebuild();
+
+	void		UpdateRange(std::size_t begin, std::size_t end);
+
+	// 收集[begin, count)中WorldChanged的节点，分段统计数量后并行写入
+	void		CollectChanged(std::size_t begin, unsigned threadCount);
+
+	// 按下标(深度排序后)存放
+	std::vector<DirectX::XMFLOAT4X4> Locals;
+	std::vector<DirectX::XMFLOAT4X4> Worlds;
+	// 父节点的下标，根节点为0xFFFFFFFF
+	std::vector<std::uint32_t> Parents;
+	std::vector<TransformId> Ids;
+	std::vector<std::uint8_t> Flags;
+
+	// 节点编号到下标，已删除的节点为0xFFFFFFFF(编号不复用)
+	std::vector<std::uint32_t> Indices;
+	std::vector<std::uint32_t> LevelBegins;
+	std::vector<std::uint32_t> ChangedIndices;
+	std::vector<std::uint32_t> ChunkOffsets;
+
+	// 从该层开始存在脏节点，没有时为LevelBegins.size()
+	std::size_t FirstDirtyLevel = 0;
+	bool HasDirty = false;
+	// 创建/删除节点后为true，新节点位于数组末尾，尚未排序
+	bool StructureDirty = false;
+};
@@ -1,11 +1,43 @@
-#ifndef SYSTEMTIMER_H
+﻿#ifndef SYSTEMTIMER_H
 #define SYSTEMTIMER_H
 
+#include <cstdint>
+#include "FrameTimeStats.h"
+
+// 计时使用的时钟，计数的单位为1/GetFrequency()秒
+class SystemClock
+{
+public:
+
+	virtual ~SystemClock() = default;
+
+	virtual std::int64_t GetCounter() const = 0;
+	virtual std::int64_t GetFrequency() const = 0;
+
+	// Windows下为QueryPerformanceCounter，其他平台为steady_clock
+	static SystemClock& GetDefault();
+};
+
+// 手动推进的时钟(计数单位为纳秒)，用于测试
+class ManualClock : public SystemClock
+{
+public:
+
+	std::int64_t GetCounter() const override { return mCounter; }
+	std::int64_t GetFrequency() const override { return 1000000000; }
+
+	void Advance(double seconds) { mCounter += (std::int64_t)(seconds * 1e9); }
+
+private:
+
+	std::int64_t mCounter = 0;
+};
+
 class SystemTimer
 {
 public:
 
-	SystemTimer();
+	explicit SystemTimer(SystemClock& clock = SystemClock::GetDefault(), const FrameTimeStatsOptions& statsOptions = FrameTimeStatsOptions());
 
 	float TotalTime()const; // in seconds
 	float DeltaTime()const; // in seconds
@@ -15,16 +47,25 @@ public:
 	void Stop();  // Call when paused.
 	void Tick();  // Call every frame.
 
+	// 每次Tick的帧时间统计(暂停期间不记录)
+	const FrameTimeStats& FrameStats()const { return mFrameStats; }
+	FrameTimeStats& FrameStats() { return mFrameStats; }
+
 private:
 
+	std::int64_t Now()const;
+
+	SystemClock& mClock;
+	FrameTimeStats mFrameStats;
+
 	double mSecondsPerCount;
 	double mDeltaTime;
 
-	__int64 mBaseTime;
-	__int64 mPausedTime;
-	__int64 mStopTime;
-	__int64 mPrevTime;
-	__int64 mCurrTime;
+	std::int64_t mBaseTime;
+	std::int64_t mPausedTime;
+	std::int64_t mStopTime;
+	std::int64_t mPrevTime;
+	std::int64_t mCurrTime;
 
 	bool mStopped;
 };
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "DX12Util.h"
+#include "Profile/RenderCounters.h"
 
 template<typename T>
 class UploadBuffer
@@ -34,6 +35,7 @@ public:
 			D3D12_RESOURCE_STATE_GENERIC_READ,	// 资源默认状态为读取
 			nullptr,
 			IID_PPV_ARGS(&mUploadBuffer)));	// 返回创建好的缓冲区
+		CountRender(RenderCounter::ResourcesCreated);
 
 
 		// 将缓冲区映射到一内存块地址
@@ -61,9 +63,16 @@ public:
 		return mUploadBuffer.Get();
 	}
 
+	// 映射后的内存首地址，非常量缓冲区的元素紧密排列，可直接批量写入
+	T* MappedData()const
+	{
+		return reinterpret_cast<T*>(mMappedData);
+	}
+
 	void CopyData(int elementIndex, const T& data)
 	{
 		memcpy(&mMappedData[elementIndex * mElementByteSize], &data, sizeof(T));
+		CountRender(RenderCounter::UploadBytes, sizeof(T));
 	}
 
 private:
@@ -33,50 +33,93 @@ float MathHelper::AngleFromXY(float x, float y)
 	return theta;
 }
 
+// Archimedes: z = cos(polar angle) is uniform in [-1, 1] for points uniform on the sphere,
+// so one uniform z and one uniform azimuth give a direction without any rejection loop.
 XMVECTOR MathHelper::RandUnitVec3()
 {
-	XMVECTOR One  = XMVectorSet(1.0f, 1.0f, 1.0f, 1.0f);
-	XMVECTOR Zero = XMVectorZero();
-
-	// Keep trying until we get a point on/in the hemisphere.
-	while(true)
-	{
-		// Generate random point in the cube [-1,1]^3.
-		XMVECTOR v = XMVectorSet(MathHelper::RandF(-1.0f, 1.0f), MathHelper::RandF(-1.0f, 1.0f), MathHelper::RandF(-1.0f, 1.0f), 0.0f);
+	RandomGenerator& random = GetThreadRandom();
+	const float z = 1.0f - 2.0f*random.NextFloat();
+	const float phi = random.NextFloat(-Pi, Pi);
+	const float r = sqrtf(Max(0.0f, 1.0f - z*z));
+
+	float sinPhi, cosPhi;
+	XMScalarSinCos(&sinPhi, &cosPhi, phi);
+	return XMVectorSet(r*cosPhi, r*sinPhi, z, 0.0f);
+}
 
-		// Ignore points outside the unit sphere in order to get an even distribution 
-		// over the unit sphere.  Otherwise points will clump more on the sphere near 
-		// the corners of the cube.
+// Reflecting the lower half of the sphere across the plane orthogonal to n maps it
+// onto the upper half, which keeps the distribution uniform.
+XMVECTOR MathHelper::RandHemisphereUnitVec3(XMVECTOR n)
+{
+	XMVECTOR v = RandUnitVec3();
 
-		if( XMVector3Greater( XMVector3LengthSq(v), One) )
-			continue;
+	// Like the batch overload, a degenerate normal (|n|^2 underflowing to zero) leaves v on the full sphere.
+	const float d = XMVectorGetX(XMVector3Dot(n, v));
+	const float nn = XMVectorGetX(XMVector3LengthSq(n));
+	if(d < 0.0f && nn > 0.0f)
+		v = XMVectorSubtract(v, XMVectorScale(n, 2.0f*d/nn));
 
-		return XMVector3Normalize(v);
-	}
+	return v;
 }
 
-XMVECTOR MathHelper::RandHemisphereUnitVec3(XMVECTOR n)
+namespace
 {
-	XMVECTOR One  = XMVectorSet(1.0f, 1.0f, 1.0f, 1.0f);
-	XMVECTOR Zero = XMVectorZero();
+	// Number of directions generated per pass on the stack (multiple of 4 for XMVectorSinCos).
+	const std::size_t RandChunkSize = 256;
 
-	// Keep trying until we get a point on/in the hemisphere.
-	while(true)
+	// Same construction as RandUnitVec3 but with batched uniforms and four sin/cos at a time.
+	void RandUnitVec3Chunk(XMFLOAT3* outVectors, std::size_t count)
 	{
-		// Generate random point in the cube [-1,1]^3.
-		XMVECTOR v = XMVectorSet(MathHelper::RandF(-1.0f, 1.0f), MathHelper::RandF(-1.0f, 1.0f), MathHelper::RandF(-1.0f, 1.0f), 0.0f);
+		XM_ALIGNED_DATA(16) float z[RandChunkSize];
+		XM_ALIGNED_DATA(16) float phi[RandChunkSize];
+		XM_ALIGNED_DATA(16) float sinPhi[RandChunkSize];
+		XM_ALIGNED_DATA(16) float cosPhi[RandChunkSize];
+
+		const std::size_t padded = (count + 3) & ~(std::size_t)3;
+		BatchRandomGenerator& random = GetThreadBatchRandom();
+		random.FillFloats(z, padded, 1.0f, -1.0f);	// z = 1 - 2u in (-1, 1]
+		random.FillFloats(phi, padded, -MathHelper::Pi, MathHelper::Pi);
+
+		for(std::size_t i = 0; i < padded; i += 4)
+		{
+			XMVECTOR s, c;
+			XMVectorSinCos(&s, &c, XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&phi[i])));
+			XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&sinPhi[i]), s);
+			XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&cosPhi[i]), c);
+		}
+
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			const float r = sqrtf(MathHelper::Max(0.0f, 1.0f - z[i]*z[i]));
+			outVectors[i] = XMFLOAT3(r*cosPhi[i], r*sinPhi[i], z[i]);
+		}
+	}
+}
 
-		// Ignore points outside the unit sphere in order to get an even distribution 
-		// over the unit sphere.  Otherwise points will clump more on the sphere near 
-		// the corners of the cube.
-		
-		if( XMVector3Greater( XMVector3LengthSq(v), One) )
-			continue;
+void MathHelper::RandUnitVec3(XMFLOAT3* outVectors, std::size_t count)
+{
+	for(std::size_t begin = 0; begin < count; begin += RandChunkSize)
+		RandUnitVec3Chunk(outVectors + begin, Min(RandChunkSize, count - begin));
+}
 
-		// Ignore points in the bottom hemisphere.
-		if( XMVector3Less( XMVector3Dot(n, v), Zero ) )
-			continue;
+void MathHelper::RandHemisphereUnitVec3(FXMVECTOR n, XMFLOAT3* outVectors, std::size_t count)
+{
+	RandUnitVec3(outVectors, count);
 
-		return XMVector3Normalize(v);
+	XMFLOAT3 normal;
+	XMStoreFloat3(&normal, n);
+	const float nn = normal.x*normal.x + normal.y*normal.y + normal.z*normal.z;
+	if(nn <= 0.0f)
+		return;
+
+	// Branch-free reflection of the directions below the plane.
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		XMFLOAT3& v = outVectors[i];
+		const float d = v.x*normal.x + v.y*normal.y + v.z*normal.z;
+		const float k = 2.0f*Min(d, 0.0f)/nn;
+		v.x -= k*normal.x;
+		v.y -= k*normal.y;
+		v.z -= k*normal.z;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,587 @@
+﻿#include "Mesh/GeometryGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GEOMETRYGENERATOR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+using namespace DirectX;
+
+namespace
+{
+	// 按顶点/索引数量一次分配所有数组，生成过程只按下标写入
+	void AllocateMesh(MeshData& mesh, const char* name, std::size_t vertexCount, std::size_t indexCount)
+	{
+		mesh.Name = name;
+		mesh.Vertices.resize(vertexCount);
+		mesh.Normals.resize(vertexCount);
+		mesh.TexCoords.resize(vertexCount);
+		mesh.Tangents.resize(vertexCount);
+		mesh.Indices32.resize(indexCount);
+
+		MeshSubset subset;
+		subset.Name = name;
+		subset.IndexCount = (std::uint32_t)indexCount;
+		mesh.Subsets.assign(1, subset);
+	}
+
+	inline void WriteVertex(MeshData& mesh, std::size_t v, const XMVECTOR& position, const XMVECTOR& normal, const XMVECTOR& tangent, float u, float tv)
+	{
+		const XMVECTOR half = XMVectorReplicate(0.5f);
+		XMStoreFloat3(&mesh.Vertices[v].Pos, position);
+		XMStoreFloat4(&mesh.Vertices[v].Color, XMVectorSetW(XMVectorMultiplyAdd(normal, half, half), 1.0f));
+		XMStoreFloat3(&mesh.Normals[v], normal);
+		XMStoreFloat4(&mesh.Tangents[v], XMVectorSetW(tangent, 1.0f));
+		mesh.TexCoords[v] = XMFLOAT2(u, tv);
+	}
+
+	// 由单位方向得到球面上的纹理坐标及沿经线方向(纹理u方向)的切线
+	inline void WriteSphereVertex(MeshData& mesh, std::size_t v, const XMVECTOR& direction, float radius)
+	{
+		XMFLOAT3 d;
+		XMStoreFloat3(&d, direction);
+		float theta = std::atan2(d.z, d.x);
+		if (theta < 0.0f)
+			theta += XM_2PI;
+		const float phi = std::acos(d.y < -1.0f ? -1.0f : (d.y > 1.0f ? 1.0f : d.y));
+
+		// 两极处切线没有定义，使用x轴
+		XMVECTOR tangent = XMVectorSet(-d.z, 0.0f, d.x, 0.0f);
+		tangent = (d.x * d.x + d.z * d.z) > 1e-12f ? XMVector3Normalize(tangent) : XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+		WriteVertex(mesh, v, XMVectorScale(direction, radius), direction, tangent, theta / XM_2PI, phi / XM_PI);
+	}
+
+	inline void WriteTriangle(std::uint32_t* indices, std::uint32_t a, std::uint32_t b, std::uint32_t c)
+	{
+		indices[0] = a;
+		indices[1] = b;
+		indices[2] = c;
+	}
+
+	/**
+	*	写入columnCount列顶点组成的相邻两行之间的四边形索引，a为上一行第一个顶点的编号
+	*	每个四边形(a, a+1, a+n) (a+n, a+1, a+n+1)，返回写入的索引数量
+	*/
+	std::size_t WriteQuadRow(std::uint32_t* out, std::uint32_t a, std::uint32_t columnCount)
+	{
+		const std::uint32_t n = columnCount;
+		const std::uint32_t quadCount = columnCount - 1;
+		std::uint32_t j = 0;
+#if defined(GEOMETRYGENERATOR_SSE2)
+		// 两个相邻四边形的12个索引为三组偏移加上相同的基址，每次基址加2
+		const __m128i offset0 = _mm_setr_epi32(0, 1, (int)n, (int)n);
+		const __m128i offset1 = _mm_setr_epi32(1, (int)n + 1, 1, 2);
+		const __m128i offset2 = _mm_setr_epi32((int)n + 1, (int)n + 1, 2, (int)n + 2);
+		const __m128i two = _mm_set1_epi32(2);
+		__m128i base = _mm_set1_epi32((int)a);
+		for (; j + 2 <= quadCount; j += 2)
+		{
+			__m128i* dst = reinterpret_cast<__m128i*>(out + j * 6);
+			_mm_storeu_si128(dst, _mm_add_epi32(base, offset0));
+			_mm_storeu_si128(dst + 1, _mm_add_epi32(base, offset1));
+			_mm_storeu_si128(dst + 2, _mm_add_epi32(base, offset2));
+			base = _mm_add_epi32(base, two);
+		}
+#endif
+		for (; j < quadCount; ++j)
+		{
+			const std::uint32_t v = a + j;
+			WriteTriangle(out + j * 6, v, v + 1, v + n);
+			WriteTriangle(out + j * 6 + 3, v + n, v + 1, v + n + 1);
+		}
+		return (std::size_t)quadCount * 6;
+	}
+
+	// 细分时相邻三角形共享的边中点(开放寻址Hash表，键为两端点编号)
+	class EdgeMidpointTable
+	{
+	public:
+
+		explicit EdgeMidpointTable(std::size_t maxEdges)
+		{
+			std::size_t capacity = 16;
+			while (capacity < maxEdges * 2)
+				capacity <<= 1;
+			Keys.resize(capacity);
+			Values.resize(capacity);
+			Mask = capacity - 1;
+		}
+
+		void Reset()
+		{
+			std::fill(Keys.begin(), Keys.end(), EmptyKey);
+		}
+
+		// 返回边(a, b)的中点编号，不存在时以nextVertex作为新顶点编号并返回true
+		bool FindOrAdd(std::uint32_t a, std::uint32_t b, std::uint32_t nextVertex, std::uint32_t& outVertex)
+		{
+			const std::uint64_t key = a < b ? ((std::uint64_t)a << 32 | b) : ((std::uint64_t)b << 32 | a);
+			std::size_t slot = (std::size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & Mask;
+			while (Keys[slot] != EmptyKey)
+			{
+				if (Keys[slot] == key)
+				{
+					outVertex = Values[slot];
+					return false;
+				}
+				slot = (slot + 1) & Mask;
+			}
+			Keys[slot] = key;
+			Values[slot] = nextVertex;
+			outVertex = nextVertex;
+			return true;
+		}
+
+	private:
+
+		static const std::uint64_t EmptyKey = ~0ull;
+		std::vector<std::uint64_t> Keys;
+		std::vector<std::uint32_t> Values;
+		std::size_t Mask = 0;
+	};
+}
+
+GeometryDesc GeometryDesc::Box(float width, float height, float depth, std::uint32_t segments)
+{
+	GeometryDesc desc;
+	desc.Shape = GeometryShape::Box;
+	desc.Size[0] = width;
+	desc.Size[1] = height;
+	desc.Size[2] = depth;
+	desc.Tessellation[0] = segments;
+	return desc;
+}
+
+GeometryDesc GeometryDesc::Sphere(float radius, std::uint32_t sliceCount, std::uint32_t stackCount)
+{
+	GeometryDesc desc;
+	desc.Shape = GeometryShape::Sphere;
+	desc.Size[0] = radius;
+	desc.Tessellation[0] = sliceCount;
+	desc.Tessellation[1] = stackCount;
+	return desc;
+}
+
+GeometryDesc GeometryDesc::Geosphere(float radius, std::uint32_t subdivisions)
+{
+	GeometryDesc desc;
+	desc.Shape = GeometryShape::Geosphere;
+	desc.Size[0] = radius;
+	desc.Tessellation[0] = subdivisions;
+	return desc;
+}
+
+GeometryDesc GeometryDesc::Cylinder(float bottomRadius, float topRadius, float height, std::uint32_t sliceCount, std::uint32_t stackCount)
+{
+	GeometryDesc desc;
+	desc.Shape = GeometryShape::Cylinder;
+	desc.Size[0] = bottomRadius;
+	desc.Size[1] = topRadius;
+	desc.Size[2] = height;
+	desc.Tessellation[0] = sliceCount;
+	desc.Tessellation[1] = stackCount;
+	return desc;
+}
+
+GeometryDesc GeometryDesc::Grid(float width, float depth, std::uint32_t rowCount, std::uint32_t columnCount)
+{
+	GeometryDesc desc;
+	desc.Shape = GeometryShape::Grid;
+	desc.Size[0] = width;
+	desc.Size[1] = depth;
+	desc.Tessellation[0] = rowCount;
+	desc.Tessellation[1] = columnCount;
+	return desc;
+}
+
+bool GeometryDesc::operator==(const GeometryDesc& other) const
+{
+	return Shape == other.Shape
+		&& std::memcmp(Size, other.Size, sizeof(Size)) == 0
+		&& Tessellation[0] == other.Tessellation[0] && Tessellation[1] == other.Tessellation[1];
+}
+
+void GeometryGenerator::CreateBox(float width, float height, float depth, std::uint32_t segments, MeshData& outMesh)
+{
+	if (segments == 0)
+		segments = 1;
+	const std::uint32_t side = segments + 1;
+	const std::uint32_t faceVertexCount = side * side;
+	AllocateMesh(outMesh, "box", 6 * (std::size_t)faceVertexCount, 6 * (std::size_t)segments * segments * 6);
+
+	// 各面的法线N及纹理u方向T，纹理v方向B = cross(N, T)，使cross(T, B) = N(从外侧看为顺时针)
+	static const float Faces[6][6] =
+	{
+		{  0.0f,  0.0f, -1.0f,		 1.0f, 0.0f,  0.0f },	// 前
+		{  0.0f,  0.0f,  1.0f,		-1.0f, 0.0f,  0.0f },	// 后
+		{  0.0f,  1.0f,  0.0f,		 1.0f, 0.0f,  0.0f },	// 上
+		{  0.0f, -1.0f,  0.0f,		 1.0f, 0.0f,  0.0f },	// 下
+		{ -1.0f,  0.0f,  0.0f,		 0.0f, 0.0f, -1.0f },	// 左
+		{  1.0f,  0.0f,  0.0f,		 0.0f, 0.0f,  1.0f },	// 右
+	};
+
+	const XMVECTOR halfExtents = XMVectorSet(width * 0.5f, height * 0.5f, depth * 0.5f, 0.0f);
+	const float step = 1.0f / segments;
+	std::uint32_t* indices = outMesh.Indices32.data();
+	for (std::uint32_t f = 0; f < 6; ++f)
+	{
+		const XMVECTOR normal = XMVectorSet(Faces[f][0], Faces[f][1], Faces[f][2], 0.0f);
+		const XMVECTOR tangent = XMVectorSet(Faces[f][3], Faces[f][4], Faces[f][5], 0.0f);
+		const XMVECTOR bitangent = XMVector3Cross(normal, tangent);
+
+		// 面上纹理坐标(0,0)处的顶点及u/v方向上的整条边
+		const XMVECTOR edgeU = XMVectorScale(XMVectorMultiply(tangent, halfExtents), 2.0f);
+		const XMVECTOR edgeV = XMVectorScale(XMVectorMultiply(bitangent, halfExtents), 2.0f);
+		const XMVECTOR origin = XMVectorSubtract(XMVectorMultiply(normal, halfExtents), XMVectorScale(XMVectorAdd(edgeU, edgeV), 0.5f));
+
+		const std::uint32_t base = f * faceVertexCount;
+		for (std::uint32_t i = 0; i < side; ++i)
+		{
+			const float v = i * step;
+			const XMVECTOR rowOrigin = XMVectorMultiplyAdd(edgeV, XMVectorReplicate(v), origin);
+			for (std::uint32_t j = 0; j < side; ++j)
+			{
+				const float u = j * step;
+				WriteVertex(outMesh, base + i * side + j, XMVectorMultiplyAdd(edgeU, XMVectorReplicate(u), rowOrigin), normal, tangent, u, v);
+			}
+		}
+
+		for (std::uint32_t i = 0; i < segments; ++i)
+			indices += WriteQuadRow(indices, base + i * side, side);
+	}
+
+	outMesh.Subsets[0].Bounds = MakeBoundsFromMinMax(XMFLOAT3(-width * 0.5f, -height * 0.5f, -depth * 0.5f), XMFLOAT3(width * 0.5f, height * 0.5f, depth * 0.5f));
+}
+
+void GeometryGenerator::CreateSphere(float radius, std::uint32_t sliceCount, std::uint32_t stackCount, MeshData& outMesh)
+{
+	sliceCount = sliceCount < 3 ? 3 : sliceCount;
+	stackCount = stackCount < 2 ? 2 : stackCount;
+
+	// 两极各一个顶点，中间stackCount - 1圈，每圈sliceCount + 1个顶点(首尾位置相同，纹理坐标不同)
+	const std::uint32_t ringVertexCount = sliceCount + 1;
+	const std::uint32_t vertexCount = 2 + (stackCount - 1) * ringVertexCount;
+	const std::size_t indexCount = (std::size_t)sliceCount * 6 + (std::size_t)(stackCount - 2) * sliceCount * 6;
+	AllocateMesh(outMesh, "sphere", vertexCount, indexCount);
+
+	const XMVECTOR xAxis = XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+	WriteVertex(outMesh, 0, XMVectorSet(0.0f, radius, 0.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), xAxis, 0.0f, 0.0f);
+
+	const float phiStep = XM_PI / stackCount;
+	const float thetaStep = XM_2PI / sliceCount;
+	for (std::uint32_t i = 1; i < stackCount; ++i)
+	{
+		float sinPhi, cosPhi;
+		XMScalarSinCos(&sinPhi, &cosPhi, i * phiStep);
+		for (std::uint32_t j = 0; j <= sliceCount; ++j)
+		{
+			float sinTheta, cosTheta;
+			XMScalarSinCos(&sinTheta, &cosTheta, j * thetaStep);
+			const XMVECTOR normal = XMVectorSet(sinPhi * cosTheta, cosPhi, sinPhi * sinTheta, 0.0f);
+			const XMVECTOR tangent = XMVectorSet(-sinTheta, 0.0f, cosTheta, 0.0f);
+			WriteVertex(outMesh, 1 + (i - 1) * ringVertexCount + j, XMVectorScale(normal, radius), normal, tangent,
+				(float)j / sliceCount, (float)i / stackCount);
+		}
+	}
+
+	const std::uint32_t southPole = vertexCount - 1;
+	WriteVertex(outMesh, southPole, XMVectorSet(0.0f, -radius, 0.0f, 0.0f), XMVectorSet(0.0f, -1.0f, 0.0f, 0.0f), xAxis, 0.0f, 1.0f);
+
+	std::uint32_t* indices = outMesh.Indices32.data();
+	for (std::uint32_t j = 0; j < sliceCount; ++j, indices += 3)
+		WriteTriangle(indices, 0, 1 + j + 1, 1 + j);
+
+	for (std::uint32_t i = 0; i + 2 < stackCount; ++i)
+		indices += WriteQuadRow(indices, 1 + i * ringVertexCount, ringVertexCount);
+
+	const std::uint32_t lastRing = southPole - ringVertexCount;
+	for (std::uint32_t j = 0; j < sliceCount; ++j, indices += 3)
+		WriteTriangle(indices, southPole, lastRing + j, lastRing + j + 1);
+
+	outMesh.Subsets[0].Bounds = MakeBoundsFromMinMax(XMFLOAT3(-radius, -radius, -radius), XMFLOAT3(radius, radius, radius));
+}
+
+void GeometryGenerator::CreateGeosphere(float radius, std::uint32_t subdivisions, MeshData& outMesh)
+{
+	if (subdivisions > MaxGeosphereSubdivisions)
+		subdivisions = MaxGeosphereSubdivisions;
+
+	// 细分k次后: 三角形20 * 4^k，边30 * 4^k，顶点10 * 4^k + 2
+	const std::size_t scale = (std::size_t)1 << (2 * subdivisions);
+	const std::size_t vertexCount = 10 * scale + 2;
+	const std::size_t triangleCount = 20 * scale;
+	AllocateMesh(outMesh, "geosphere", vertexCount, triangleCount * 3);
+
+	const float X = 0.525731f;
+	const float Z = 0.850651f;
+	static const float IcosahedronVertices[12][3] =
+	{
+		{ -X, 0.0f, Z }, { X, 0.0f, Z }, { -X, 0.0f, -Z }, { X, 0.0f, -Z },
+		{ 0.0f, Z, X }, { 0.0f, Z, -X }, { 0.0f, -Z, X }, { 0.0f, -Z, -X },
+		{ Z, X, 0.0f }, { -Z, X, 0.0f }, { Z, -X, 0.0f }, { -Z, -X, 0.0f },
+	};
+	static const std::uint32_t IcosahedronIndices[60] =
+	{
+		1, 4, 0,	4, 9, 0,	4, 5, 9,	8, 5, 4,	1, 8, 4,
+		1, 10, 8,	10, 3, 8,	8, 3, 5,	3, 2, 5,	3, 7, 2,
+		3, 10, 7,	10, 6, 7,	6, 11, 7,	6, 0, 11,	6, 1, 0,
+		10, 1, 6,	11, 0, 9,	2, 11, 9,	5, 2, 9,	11, 2, 7,
+	};
+
+	// 细分过程中只使用Vertices中的位置(单位向量)，最后统一生成其他属性
+	for (std::uint32_t v = 0; v < 12; ++v)
+		outMesh.Vertices[v].Pos = XMFLOAT3(IcosahedronVertices[v][0], IcosahedronVertices[v][1], IcosahedronVertices[v][2]);
+
+	std::vector<std::uint32_t> current(triangleCount * 3);
+	std::vector<std::uint32_t> next(subdivisions > 0 ? triangleCount * 3 : 0);
+	std::memcpy(current.data(), IcosahedronIndices, sizeof(IcosahedronIndices));
+	std::uint32_t currentVertexCount = 12;
+	std::size_t currentTriangleCount = 20;
+
+	EdgeMidpointTable midpoints(triangleCount * 3 / 2);
+	for (std::uint32_t level = 0; level < subdivisions; ++level)
+	{
+		midpoints.Reset();
+		auto midpoint = [&](std::uint32_t a, std::uint32_t b)
+		{
+			std::uint32_t m;
+			if (midpoints.FindOrAdd(a, b, currentVertexCount, m))
+			{
+				const XMVECTOR pa = XMLoadFloat3(&outMesh.Vertices[a].Pos);
+				const XMVECTOR pb = XMLoadFloat3(&outMesh.Vertices[b].Pos);
+				XMStoreFloat3(&outMesh.Vertices[m].Pos, XMVector3Normalize(XMVectorAdd(pa, pb)));
+				++currentVertexCount;
+			}
+			return m;
+		};
+
+		// 三角形(v0, v1, v2)的三条边中点m0(v0v1)/m1(v1v2)/m2(v0v2)，分为4个绕序相同的三角形
+		for (std::size_t t = 0; t < currentTriangleCount; ++t)
+		{
+			const std::uint32_t v0 = current[t * 3], v1 = current[t * 3 + 1], v2 = current[t * 3 + 2];
+			const std::uint32_t m0 = midpoint(v0, v1), m1 = midpoint(v1, v2), m2 = midpoint(v0, v2);
+			std::uint32_t* out = next.data() + t * 12;
+			WriteTriangle(out, v0, m0, m2);
+			WriteTriangle(out + 3, m0, m1, m2);
+			WriteTriangle(out + 6, m2, m1, v2);
+			WriteTriangle(out + 9, m0, v1, m1);
+		}
+		currentTriangleCount *= 4;
+		current.swap(next);
+	}
+
+	for (std::size_t v = 0; v < vertexCount; ++v)
+		WriteSphereVertex(outMesh, v, XMLoadFloat3(&outMesh.Vertices[v].Pos), radius);
+	std::memcpy(outMesh.Indices32.data(), current.data(), triangleCount * 3 * sizeof(std::uint32_t));
+
+	outMesh.Subsets[0].Bounds = MakeBoundsFromMinMax(XMFLOAT3(-radius, -radius, -radius), XMFLOAT3(radius, radius, radius));
+}
+
+void GeometryGenerator::CreateCylinder(float bottomRadius, float topRadius, float height, std::uint32_t sliceCount, std::uint32_t stackCount, MeshData& outMesh)
+{
+	sliceCount = sliceCount < 3 ? 3 : sliceCount;
+	stackCount = stackCount < 1 ? 1 : stackCount;
+
+	// 侧面stackCount + 1圈，顶面/底面各一圈加一个中心点
+	const std::uint32_t ringVertexCount = sliceCount + 1;
+	const std::uint32_t sideVertexCount = (stackCount + 1) * ringVertexCount;
+	const std::uint32_t capVertexCount = ringVertexCount + 1;
+	const std::size_t indexCount = (std::size_t)stackCount * sliceCount * 6 + (std::size_t)sliceCount * 3 * 2;
+	AllocateMesh(outMesh, "cylinder", sideVertexCount + capVertexCount * 2, indexCount);
+
+	const float stackHeight = height / stackCount;
+	const float radiusStep = (topRadius - bottomRadius) / stackCount;
+	const float thetaStep = XM_2PI / sliceCount;
+	for (std::uint32_t i = 0; i <= stackCount; ++i)
+	{
+		const float y = -0.5f * height + i * stackHeight;
+		const float r = bottomRadius + i * radiusStep;
+		for (std::uint32_t j = 0; j <= sliceCount; ++j)
+		{
+			float sinTheta, cosTheta;
+			XMScalarSinCos(&sinTheta, &cosTheta, j * thetaStep);
+
+			// 切线沿圆周方向，副切线沿母线向下(纹理v方向)，法线 = cross(T, B)
+			const XMVECTOR tangent = XMVectorSet(-sinTheta, 0.0f, cosTheta, 0.0f);
+			const XMVECTOR bitangent = XMVectorSet((bottomRadius - topRadius) * cosTheta, -height, (bottomRadius - topRadius) * sinTheta, 0.0f);
+			const XMVECTOR normal = XMVector3Normalize(XMVector3Cross(tangent, bitangent));
+			WriteVertex(outMesh, i * ringVertexCount + j, XMVectorSet(r * cosTheta, y, r * sinTheta, 0.0f), normal, tangent,
+				(float)j / sliceCount, 1.0f - (float)i / stackCount);
+		}
+	}
+
+	std::uint32_t* indices = outMesh.Indices32.data();
+	for (std::uint32_t i = 0; i < stackCount; ++i)
+	{
+		for (std::uint32_t j = 0; j < sliceCount; ++j, indices += 6)
+		{
+			const std::uint32_t a = i * ringVertexCount + j;
+			WriteTriangle(indices, a, a + ringVertexCount, a + ringVertexCount + 1);
+			WriteTriangle(indices + 3, a, a + ringVertexCount + 1, a + 1);
+		}
+	}
+
+	// 顶面/底面，纹理坐标为xz平面投影，v方向与cross(N, T)一致
+	const XMVECTOR xAxis = XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+	for (std::uint32_t cap = 0; cap < 2; ++cap)
+	{
+		const bool top = cap == 0;
+		const float y = top ? 0.5f * height : -0.5f * height;
+		const float r = top ? topRadius : bottomRadius;
+		const float vSign = top ? -1.0f : 1.0f;
+		const XMVECTOR normal = XMVectorSet(0.0f, top ? 1.0f : -1.0f, 0.0f, 0.0f);
+		const float uvScale = r > 0.0f ? 0.5f / r : 0.0f;
+		const std::uint32_t base = sideVertexCount + cap * capVertexCount;
+		for (std::uint32_t j = 0; j <= sliceCount; ++j)
+		{
+			float sinTheta, cosTheta;
+			XMScalarSinCos(&sinTheta, &cosTheta, j * thetaStep);
+			const float x = r * cosTheta, z = r * sinTheta;
+			WriteVertex(outMesh, base + j, XMVectorSet(x, y, z, 0.0f), normal, xAxis, x * uvScale + 0.5f, vSign * z * uvScale + 0.5f);
+		}
+		const std::uint32_t center = base + ringVertexCount;
+		WriteVertex(outMesh, center, XMVectorSet(0.0f, y, 0.0f, 0.0f), normal, xAxis, 0.5f, 0.5f);
+
+		for (std::uint32_t j = 0; j < sliceCount; ++j, indices += 3)
+		{
+			if (top)
+				WriteTriangle(indices, center, base + j + 1, base + j);
+			else
+				WriteTriangle(indices, center, base + j, base + j + 1);
+		}
+	}
+
+	const float maxRadius = bottomRadius > topRadius ? bottomRadius : topRadius;
+	outMesh.Subsets[0].Bounds = MakeBoundsFromMinMax(XMFLOAT3(-maxRadius, -0.5f * height, -maxRadius), XMFLOAT3(maxRadius, 0.5f * height, maxRadius));
+}
+
+void GeometryGenerator::CreateGrid(float width, float depth, std::uint32_t rowCount, std::uint32_t columnCount, MeshData& outMesh)
+{
+	rowCount = rowCount < 2 ? 2 : rowCount;
+	columnCount = columnCount < 2 ? 2 : columnCount;
+	const std::size_t vertexCount = (std::size_t)rowCount * columnCount;
+	AllocateMesh(outMesh, "grid", vertexCount, (std::size_t)(rowCount - 1) * (columnCount - 1) * 6);
+
+	// 法线/切线/颜色在整个网格中相同，逐行只计算z及v
+	const float dx = width / (columnCount - 1);
+	const float dz = depth / (rowCount - 1);
+	const float du = 1.0f / (columnCount - 1);
+	const float dv = 1.0f / (rowCount - 1);
+	const XMFLOAT3 normal(0.0f, 1.0f, 0.0f);
+	const XMFLOAT4 tangent(1.0f, 0.0f, 0.0f, 1.0f);
+	const XMFLOAT4 color(0.5f, 1.0f, 0.5f, 1.0f);
+	const float x0 = -0.5f * width;
+
+	Vertex* vertices = outMesh.Vertices.data();
+	XMFLOAT3* normals = outMesh.Normals.data();
+	XMFLOAT2* texCoords = outMesh.TexCoords.data();
+	XMFLOAT4* tangents = outMesh.Tangents.data();
+	for (std::uint32_t i = 0; i < rowCount; ++i)
+	{
+		const float z = 0.5f * depth - i * dz;
+		const float v = i * dv;
+		const std::size_t row = (std::size_t)i * columnCount;
+		for (std::uint32_t j = 0; j < columnCount; ++j)
+		{
+			vertices[row + j].Pos = XMFLOAT3(x0 + j * dx, 0.0f, z);
+			vertices[row + j].Color = color;
+			texCoords[row + j] = XMFLOAT2(j * du, v);
+		}
+		std::fill(normals + row, normals + row + columnCount, normal);
+		std::fill(tangents + row, tangents + row + columnCount, tangent);
+	}
+
+	std::uint32_t* indices = outMesh.Indices32.data();
+	for (std::uint32_t i = 0; i + 1 < rowCount; ++i)
+		indices += WriteQuadRow(indices, i * columnCount, columnCount);
+
+	outMesh.Subsets[0].Bounds = MakeBoundsFromMinMax(XMFLOAT3(-0.5f * width, 0.0f, -0.5f * depth), XMFLOAT3(0.5f * width, 0.0f, 0.5f * depth));
+}
+
+void GeometryGenerator::Create(const GeometryDesc& desc, MeshData& outMesh)
+{
+	switch (desc.Shape)
+	{
+	case GeometryShape::Box:
+		CreateBox(desc.Size[0], desc.Size[1], desc.Size[2], desc.Tessellation[0], outMesh);
+		break;
+	case GeometryShape::Sphere:
+		CreateSphere(desc.Size[0], desc.Tessellation[0], desc.Tessellation[1], outMesh);
+		break;
+	case GeometryShape::Geosphere:
+		CreateGeosphere(desc.Size[0], desc.Tessellation[0], outMesh);
+		break;
+	case GeometryShape::Cylinder:
+		CreateCylinder(desc.Size[0], desc.Size[1], desc.Size[2], desc.Tessellation[0], desc.Tessellation[1], outMesh);
+		break;
+	case GeometryShape::Grid:
+		CreateGrid(desc.Size[0], desc.Size[1], desc.Tessellation[0], desc.Tessellation[1], outMesh);
+		break;
+	}
+}
+
+std::size_t GeometryCache::DescHash::operator()(const GeometryDesc& desc) const
+{
+	std::uint32_t values[6];
+	values[0] = (std::uint32_t)desc.Shape;
+	std::memcpy(values + 1, desc.Size, sizeof(desc.Size));
+	values[4] = desc.Tessellation[0];
+	values[5] = desc.Tessellation[1];
+
+	std::uint64_t hash = 14695981039346656037ull;
+	for (std::uint32_t v : values)
+	{
+		hash ^= v;
+		hash *= 1099511628211ull;
+	}
+	return (std::size_t)hash;
+}
+
+GeometryCache& GeometryCache::GetInstance()
+{
+	static GeometryCache instance;
+	return instance;
+}
+
+std::shared_ptr<const MeshData> GeometryCache::Get(const GeometryDesc& desc)
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		auto it = Meshes.find(desc);
+		if (it != Meshes.end())
+		{
+			++HitCount;
+			return it->second;
+		}
+		++MissCount;
+	}
+
+	// 生成时不持有锁，多个线程同时请求同一参数时保留先插入的结果
+	std::shared_ptr<MeshData> mesh = std::make_shared<MeshData>();
+	GeometryGenerator::Create(desc, *mesh);
+
+	std::lock_guard<std::mutex> lock(Mutex);
+	return Meshes.emplace(desc, std::move(mesh)).first->second;
+}
+
+void GeometryCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	Meshes.clear();
+}
+
+std::size_t GeometryCache::GetHitCount() const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	return HitCount;
+}
+
+std::size_t GeometryCache::GetMissCount() const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	return MissCount;
+}
@@ -0,0 +1,591 @@
+﻿#include "Mesh/MeshCodec.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MESHCODEC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// 编码数据的格式标识(高4位)及版本(低4位)
+	const std::uint8_t VertexHeader = 0xA1;
+	const std::uint8_t IndexHeader = 0xE1;
+
+	// 每块顶点数据不超过该字节数，块内字节平面可留在L1缓存中
+	const std::size_t VertexBlockMaxSize = 8192;
+	const std::size_t VertexBlockMaxVertices = 256;
+	const std::size_t GroupSize = 16;
+
+	// 组的打包位数
+	const std::uint32_t GroupBits[4] = { 0, 2, 4, 8 };
+
+	std::size_t GetVertexBlockSize(std::size_t vertexByteStride)
+	{
+		std::size_t blockSize = std::min(VertexBlockMaxSize / vertexByteStride, VertexBlockMaxVertices);
+		blockSize &= ~(GroupSize - 1);
+		return std::max(blockSize, GroupSize);
+	}
+
+	inline std::uint8_t ZigZag8(std::uint8_t delta)
+	{
+		return (std::uint8_t)((delta << 1) ^ (std::uint8_t)((std::int8_t)delta >> 7));
+	}
+
+	inline std::uint8_t UnZigZag8(std::uint8_t value)
+	{
+		return (std::uint8_t)((value >> 1) ^ (std::uint8_t)(-(std::int8_t)(value & 1)));
+	}
+
+	inline std::uint32_t ZigZag32(std::int32_t delta)
+	{
+		return ((std::uint32_t)delta << 1) ^ (std::uint32_t)(delta >> 31);
+	}
+
+	inline std::int32_t UnZigZag32(std::uint32_t value)
+	{
+		return (std::int32_t)((value >> 1) ^ (0u - (value & 1)));
+	}
+
+	void WriteVarint(std::vector<std::uint8_t>& out, std::uint32_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back((std::uint8_t)(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back((std::uint8_t)value);
+	}
+
+	bool ReadVarint(const std::uint8_t*& p, const std::uint8_t* end, std::uint32_t& outValue)
+	{
+		std::uint32_t value = 0;
+		for (std::uint32_t shift = 0; shift < 35; shift += 7)
+		{
+			if (p == end)
+				return false;
+			const std::uint8_t byte = *p++;
+			value |= (std::uint32_t)(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				outValue = value;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// 打包一组16个zigzag差分值
+	void EncodeGroup(const std::uint8_t* values, std::uint32_t mode, std::vector<std::uint8_t>& out)
+	{
+		switch (mode)
+		{
+		case 1:
+			for (std::size_t i = 0; i < GroupSize; i += 4)
+				out.push_back((std::uint8_t)((values[i] << 6) | (values[i + 1] << 4) | (values[i + 2] << 2) | values[i + 3]));
+			break;
+		case 2:
+			for (std::size_t i = 0; i < GroupSize; i += 2)
+				out.push_back((std::uint8_t)((values[i] << 4) | values[i + 1]));
+			break;
+		case 3:
+			out.insert(out.end(), values, values + GroupSize);
+			break;
+		default:
+			break;
+		}
+	}
+
+	std::uint32_t SelectGroupMode(const std::uint8_t* values)
+	{
+		std::uint8_t maxValue = 0;
+		for (std::size_t i = 0; i < GroupSize; ++i)
+			maxValue = std::max(maxValue, values[i]);
+		return maxValue == 0 ? 0 : (maxValue < 4 ? 1 : (maxValue < 16 ? 2 : 3));
+	}
+
+#if defined(MESHCODEC_SSE2)
+	// 解包一组16个值并还原zigzag
+	inline __m128i DecodeGroup(const std::uint8_t* p, std::uint32_t mode)
+	{
+		__m128i values;
+		switch (mode)
+		{
+		case 1:
+		{
+			std::int32_t packed;
+			std::memcpy(&packed, p, sizeof(packed));
+			const __m128i x = _mm_cvtsi32_si128(packed);
+			const __m128i mask = _mm_set1_epi8(3);
+			const __m128i a = _mm_and_si128(_mm_srli_epi16(x, 6), mask);
+			const __m128i b = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+			const __m128i c = _mm_and_si128(_mm_srli_epi16(x, 2), mask);
+			const __m128i d = _mm_and_si128(x, mask);
+			values = _mm_unpacklo_epi16(_mm_unpacklo_epi8(a, b), _mm_unpacklo_epi8(c, d));
+			break;
+		}
+		case 2:
+		{
+			const __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+			const __m128i mask = _mm_set1_epi8(15);
+			values = _mm_unpacklo_epi8(_mm_and_si128(_mm_srli_epi16(x, 4), mask), _mm_and_si128(x, mask));
+			break;
+		}
+		case 3:
+			values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			break;
+		default:
+			return _mm_setzero_si128();
+		}
+
+		const __m128i half = _mm_and_si128(_mm_srli_epi16(values, 1), _mm_set1_epi8(0x7F));
+		const __m128i sign = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(values, _mm_set1_epi8(1)));
+		return _mm_xor_si128(half, sign);
+	}
+
+	// 16个字节的前缀和，carry为上一组最后一个值的广播
+	inline __m128i PrefixSum(__m128i x, __m128i carry)
+	{
+		x = _mm_add_epi8(x, _mm_slli_si128(x, 1));
+		x = _mm_add_epi8(x, _mm_slli_si128(x, 2));
+		x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+		x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+		return _mm_add_epi8(x, carry);
+	}
+
+	inline __m128i BroadcastLastByte(__m128i x)
+	{
+		x = _mm_unpackhi_epi8(x, x);
+		x = _mm_unpackhi_epi16(x, x);
+		return _mm_shuffle_epi32(x, 0xFF);
+	}
+
+	inline void Store4(std::uint8_t* dst, __m128i x)
+	{
+		const std::int32_t value = _mm_cvtsi128_si32(x);
+		std::memcpy(dst, &value, sizeof(value));
+	}
+
+	// 将包含4个顶点各4字节的行写入顶点数组
+	inline void StoreRow(std::uint8_t* dst, std::size_t vertexByteStride, __m128i row)
+	{
+		Store4(dst, row);
+		Store4(dst + vertexByteStride, _mm_srli_si128(row, 4));
+		Store4(dst + vertexByteStride * 2, _mm_srli_si128(row, 8));
+		Store4(dst + vertexByteStride * 3, _mm_srli_si128(row, 12));
+	}
+#endif
+
+	// 将一块的字节平面转置为顶点
+	void TransposeBlock(const std::uint8_t* planes, std::size_t planeSize, std::uint8_t* dst, std::size_t vertexCount, std::size_t vertexByteStride)
+	{
+		std::size_t k = 0;
+#if defined(MESHCODEC_SSE2)
+		// 每次转置4个字节平面的16个顶点
+		for (; k + 4 <= vertexByteStride; k += 4)
+		{
+			for (std::size_t v = 0; v < vertexCount; v += GroupSize)
+			{
+				const __m128i p0 = _mm_load_si128(reinterpret_cast<const __m128i*>(planes + (k + 0) * planeSize + v));
+				const __m128i p1 = _mm_load_si128(reinterpret_cast<const __m128i*>(planes + (k + 1) * planeSize + v));
+				const __m128i p2 = _mm_load_si128(reinterpret_cast<const __m128i*>(planes + (k + 2) * planeSize + v));
+				const __m128i p3 = _mm_load_si128(reinterpret_cast<const __m128i*>(planes + (k + 3) * planeSize + v));
+
+				const __m128i t0 = _mm_unpacklo_epi8(p0, p1);
+				const __m128i t1 = _mm_unpackhi_epi8(p0, p1);
+				const __m128i t2 = _mm_unpacklo_epi8(p2, p3);
+				const __m128i t3 = _mm_unpackhi_epi8(p2, p3);
+				const __m128i r0 = _mm_unpacklo_epi16(t0, t2);
+				const __m128i r1 = _mm_unpackhi_epi16(t0, t2);
+				const __m128i r2 = _mm_unpacklo_epi16(t1, t3);
+				const __m128i r3 = _mm_unpackhi_epi16(t1, t3);
+
+				std::uint8_t* out = dst + v * vertexByteStride + k;
+				if (v + GroupSize <= vertexCount)
+				{
+					StoreRow(out, vertexByteStride, r0);
+					StoreRow(out + vertexByteStride * 4, vertexByteStride, r1);
+					StoreRow(out + vertexByteStride * 8, vertexByteStride, r2);
+					StoreRow(out + vertexByteStride * 12, vertexByteStride, r3);
+				}
+				else
+				{
+					// 块末尾不足16个顶点时先写入临时缓冲区
+					alignas(16) std::uint8_t rows[GroupSize * 4];
+					_mm_store_si128(reinterpret_cast<__m128i*>(rows), r0);
+					_mm_store_si128(reinterpret_cast<__m128i*>(rows + 16), r1);
+					_mm_store_si128(reinterpret_cast<__m128i*>(rows + 32), r2);
+					_mm_store_si128(reinterpret_cast<__m128i*>(rows + 48), r3);
+					for (std::size_t i = 0; v + i < vertexCount; ++i)
+						std::memcpy(out + i * vertexByteStride, rows + i * 4, 4);
+				}
+			}
+		}
+#endif
+		for (; k < vertexByteStride; ++k)
+		{
+			const std::uint8_t* plane = planes + k * planeSize;
+			for (std::size_t v = 0; v < vertexCount; ++v)
+				dst[v * vertexByteStride + k] = plane[v];
+		}
+	}
+}
+
+void EncodeVertexBuffer(const void* vertices, std::size_t vertexCount, std::size_t vertexByteStride, std::vector<std::uint8_t>& outData)
+{
+	outData.clear();
+	outData.push_back(VertexHeader);
+	if (vertexCount == 0 || vertexByteStride == 0)
+		return;
+
+	const std::uint8_t* source = static_cast<const std::uint8_t*>(vertices);
+	const std::size_t blockSize = GetVertexBlockSize(vertexByteStride);
+
+	// 每个字节平面的差分基准为上一个顶点(跨块延续)
+	std::vector<std::uint8_t> baseline(vertexByteStride, 0);
+	std::vector<std::uint8_t> deltas(blockSize);
+	std::vector<std::uint8_t> data;
+
+	for (std::size_t blockStart = 0; blockStart < vertexCount; blockStart += blockSize)
+	{
+		const std::size_t count = std::min(blockSize, vertexCount - blockStart);
+		const std::size_t groupCount = (count + GroupSize - 1) / GroupSize;
+
+		for (std::size_t k = 0; k < vertexByteStride; ++k)
+		{
+			std::uint8_t previous = baseline[k];
+			for (std::size_t v = 0; v < groupCount * GroupSize; ++v)
+			{
+				// 末尾不足一组的部分差分为0
+				const std::uint8_t value = v < count ? source[(blockStart + v) * vertexByteStride + k] : previous;
+				deltas[v] = ZigZag8((std::uint8_t)(value - previous));
+				previous = value;
+			}
+			baseline[k] = previous;
+
+			// 组头(每组2位)之后为各组打包的数据
+			const std::size_t headerOffset = outData.size();
+			outData.resize(headerOffset + (groupCount + 3) / 4, 0);
+			data.clear();
+			for (std::size_t g = 0; g < groupCount; ++g)
+			{
+				const std::uint32_t mode = SelectGroupMode(deltas.data() + g * GroupSize);
+				outData[headerOffset + g / 4] |= (std::uint8_t)(mode << ((g % 4) * 2));
+				EncodeGroup(deltas.data() + g * GroupSize, mode, data);
+			}
+			outData.insert(outData.end(), data.begin(), data.end());
+		}
+	}
+}
+
+bool DecodeVertexBuffer(void* dst, std::size_t vertexCount, std::size_t vertexByteStride, const void* data, std::size_t dataSize)
+{
+	const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+	const std::uint8_t* end = p + dataSize;
+	if (dataSize < 1 || *p++ != VertexHeader)
+		return false;
+	if (vertexCount == 0 || vertexByteStride == 0)
+		return true;
+
+	const std::size_t blockSize = GetVertexBlockSize(vertexByteStride);
+	std::uint8_t* output = static_cast<std::uint8_t*>(dst);
+
+	// 一块的字节平面(每个平面按16字节对齐)及转置后的顶点，共约16KB，解码过程中留在缓存中；
+	// 转置按顶点步长写入分散的4字节，先写入块缓冲区再整块顺序复制到dst，
+	// dst为Upload堆映射的写合并内存时每次都能写满整个缓存行
+	std::vector<std::uint8_t> storage(blockSize * vertexByteStride * 2 + 16);
+	std::uint8_t* planes = storage.data() + ((16 - ((std::uintptr_t)storage.data() & 15)) & 15);
+	std::uint8_t* blockVertices = planes + blockSize * vertexByteStride;
+	std::vector<std::uint8_t> baseline(vertexByteStride, 0);
+
+	for (std::size_t blockStart = 0; blockStart < vertexCount; blockStart += blockSize)
+	{
+		const std::size_t count = std::min(blockSize, vertexCount - blockStart);
+		const std::size_t groupCount = (count + GroupSize - 1) / GroupSize;
+
+		for (std::size_t k = 0; k < vertexByteStride; ++k)
+		{
+			const std::uint8_t* header = p;
+			const std::size_t headerSize = (groupCount + 3) / 4;
+			if ((std::size_t)(end - p) < headerSize)
+				return false;
+			p += headerSize;
+
+			std::uint8_t* plane = planes + k * blockSize;
+#if defined(MESHCODEC_SSE2)
+			__m128i carry = _mm_set1_epi8((char)baseline[k]);
+#else
+			std::uint8_t previous = baseline[k];
+#endif
+			for (std::size_t g = 0; g < groupCount; ++g)
+			{
+				const std::uint32_t mode = (header[g / 4] >> ((g % 4) * 2)) & 3;
+				const std::size_t groupBytes = GroupBits[mode] * GroupSize / 8;
+				if ((std::size_t)(end - p) < groupBytes)
+					return false;
+
+#if defined(MESHCODEC_SSE2)
+				const __m128i values = PrefixSum(DecodeGroup(p, mode), carry);
+				_mm_store_si128(reinterpret_cast<__m128i*>(plane + g * GroupSize), values);
+				carry = BroadcastLastByte(values);
+#else
+				for (std::size_t i = 0; i < GroupSize; ++i)
+				{
+					std::uint8_t value = 0;
+					if (mode == 1)
+						value = (p[i / 4] >> (6 - (i % 4) * 2)) & 3;
+					else if (mode == 2)
+						value = (p[i / 2] >> ((i % 2) ? 0 : 4)) & 15;
+					else if (mode == 3)
+						value = p[i];
+					previous = (std::uint8_t)(previous + UnZigZag8(value));
+					plane[g * GroupSize + i] = previous;
+				}
+#endif
+				p += groupBytes;
+			}
+			baseline[k] = plane[groupCount * GroupSize - 1];
+		}
+
+		TransposeBlock(planes, blockSize, blockVertices, count, vertexByteStride);
+		std::memcpy(output + blockStart * vertexByteStride, blockVertices, count * vertexByteStride);
+	}
+
+	return p == end;
+}
+
+namespace
+{
+	const std::uint32_t EdgeFifoLookup = 15;
+	const std::uint32_t VertexFifoLookup = 14;
+	const std::uint32_t NoEdge = 15;
+	const std::uint32_t NextVertexCode = 0;
+	const std::uint32_t ExplicitVertexCode = 15;
+
+	// 编码器与解码器共用的FIFO状态，两者以完全相同的顺序更新
+	struct IndexCodecState
+	{
+		std::uint32_t EdgeFifo[16][2] = {};
+		std::uint32_t VertexFifo[16] = {};
+		std::uint32_t EdgeCount = 0;
+		std::uint32_t VertexCount = 0;
+		std::uint32_t Next = 0;
+		std::uint32_t Last = 0;
+
+		void PushEdge(std::uint32_t a, std::uint32_t b)
+		{
+			EdgeFifo[EdgeCount & 15][0] = a;
+			EdgeFifo[EdgeCount & 15][1] = b;
+			++EdgeCount;
+		}
+
+		void PushVertex(std::uint32_t v)
+		{
+			VertexFifo[VertexCount & 15] = v;
+			++VertexCount;
+		}
+
+		std::uint32_t FindEdge(std::uint32_t a, std::uint32_t b) const
+		{
+			for (std::uint32_t i = 0; i < EdgeFifoLookup && i < EdgeCount; ++i)
+			{
+				const std::uint32_t* edge = EdgeFifo[(EdgeCount - 1 - i) & 15];
+				if (edge[0] == a && edge[1] == b)
+					return i;
+			}
+			return NoEdge;
+		}
+
+		const std::uint32_t* GetEdge(std::uint32_t i) const { return EdgeFifo[(EdgeCount - 1 - i) & 15]; }
+
+		// 编码一个顶点，返回4位编码，显式顶点的差值写入data
+		std::uint32_t EncodeVertex(std::uint32_t v, std::vector<std::uint8_t>& data)
+		{
+			std::uint32_t code = ExplicitVertexCode;
+			if (v == Next)
+			{
+				code = NextVertexCode;
+			}
+			else
+			{
+				for (std::uint32_t i = 0; i < VertexFifoLookup && i < VertexCount; ++i)
+				{
+					if (VertexFifo[(VertexCount - 1 - i) & 15] == v)
+					{
+						code = 1 + i;
+						break;
+					}
+				}
+			}
+
+			if (code == ExplicitVertexCode)
+				WriteVarint(data, ZigZag32((std::int32_t)(v - Last)));
+			FinishVertex(v, code);
+			return code;
+		}
+
+		bool DecodeVertex(std::uint32_t code, const std::uint8_t*& data, const std::uint8_t* end, std::uint32_t& outVertex)
+		{
+			if (code == NextVertexCode)
+			{
+				outVertex = Next;
+			}
+			else if (code == ExplicitVertexCode)
+			{
+				std::uint32_t delta;
+				if (!ReadVarint(data, end, delta))
+					return false;
+				outVertex = Last + (std::uint32_t)UnZigZag32(delta);
+			}
+			else
+			{
+				if (code - 1 >= VertexCount)
+					return false;
+				outVertex = VertexFifo[(VertexCount - code) & 15];
+			}
+			FinishVertex(outVertex, code);
+			return true;
+		}
+
+		// 新顶点(下一个/显式)进入顶点FIFO，下一个新顶点预测为其后一个顶点(拆分子集的索引从0重新开始时也能继续命中)
+		void FinishVertex(std::uint32_t v, std::uint32_t code)
+		{
+			if (code == NextVertexCode || code == ExplicitVertexCode)
+			{
+				PushVertex(v);
+				Next = v + 1;
+			}
+			Last = v;
+		}
+	};
+
+	inline std::uint32_t LoadIndex(const void* indices, std::size_t indexByteSize, std::size_t i)
+	{
+		if (indexByteSize == 2)
+			return static_cast<const std::uint16_t*>(indices)[i];
+		return static_cast<const std::uint32_t*>(indices)[i];
+	}
+}
+
+bool EncodeIndexBuffer(const void* indices, std::size_t indexCount, std::size_t indexByteSize, std::vector<std::uint8_t>& outData)
+{
+	outData.clear();
+	if (indexCount % 3 != 0 || (indexByteSize != 2 && indexByteSize != 4))
+		return false;
+
+	const std::size_t triangleCount = indexCount / 3;
+	outData.reserve(1 + triangleCount * 2);
+	outData.push_back(IndexHeader);
+	outData.resize(1 + triangleCount);
+
+	IndexCodecState state;
+	std::vector<std::uint8_t> data;
+	for (std::size_t t = 0; t < triangleCount; ++t)
+	{
+		const std::uint32_t triangle[3] = { LoadIndex(indices, indexByteSize, t * 3), LoadIndex(indices, indexByteSize, t * 3 + 1), LoadIndex(indices, indexByteSize, t * 3 + 2) };
+
+		// 查找三条边中最近进入边FIFO的一条，三角形旋转为以该边开始
+		std::uint32_t edge = NoEdge;
+		std::uint32_t rotation = 0;
+		for (std::uint32_t r = 0; r < 3; ++r)
+		{
+			const std::uint32_t found = state.FindEdge(triangle[r], triangle[(r + 1) % 3]);
+			if (found < edge)
+			{
+				edge = found;
+				rotation = r;
+			}
+		}
+
+		std::uint8_t code;
+		if (edge != NoEdge)
+		{
+			const std::uint32_t a = triangle[rotation];
+			const std::uint32_t b = triangle[(rotation + 1) % 3];
+			const std::uint32_t c = triangle[(rotation + 2) % 3];
+			code = (std::uint8_t)((edge << 4) | state.EncodeVertex(c, data));
+			state.PushEdge(c, b);
+			state.PushEdge(a, c);
+		}
+		else
+		{
+			const std::size_t codeOffset = data.size();
+			data.push_back(0);
+			const std::uint32_t codeA = state.EncodeVertex(triangle[0], data);
+			const std::uint32_t codeB = state.EncodeVertex(triangle[1], data);
+			const std::uint32_t codeC = state.EncodeVertex(triangle[2], data);
+			data[codeOffset] = (std::uint8_t)((codeA << 4) | codeB);
+			code = (std::uint8_t)((NoEdge << 4) | codeC);
+			state.PushEdge(triangle[1], triangle[0]);
+			state.PushEdge(triangle[2], triangle[1]);
+			state.PushEdge(triangle[0], triangle[2]);
+		}
+		outData[1 + t] = code;
+	}
+
+	outData.insert(outData.end(), data.begin(), data.end());
+	return true;
+}
+
+bool DecodeIndexBuffer(void* dst, std::size_t indexCount, std::size_t indexByteSize, const void* data, std::size_t dataSize)
+{
+	if (indexCount % 3 != 0 || (indexByteSize != 2 && indexByteSize != 4))
+		return false;
+
+	const std::size_t triangleCount = indexCount / 3;
+	const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+	const std::uint8_t* end = p + dataSize;
+	if (dataSize < 1 + triangleCount || *p != IndexHeader)
+		return false;
+
+	const std::uint8_t* codes = p + 1;
+	const std::uint8_t* extra = codes + triangleCount;
+	std::uint16_t* output16 = static_cast<std::uint16_t*>(dst);
+	std::uint32_t* output32 = static_cast<std::uint32_t*>(dst);
+
+	IndexCodecState state;
+	for (std::size_t t = 0; t < triangleCount; ++t)
+	{
+		const std::uint32_t code = codes[t];
+		const std::uint32_t edge = code >> 4;
+		std::uint32_t a, b, c;
+		if (edge != NoEdge)
+		{
+			if (edge >= state.EdgeCount)
+				return false;
+			a = state.GetEdge(edge)[0];
+			b = state.GetEdge(edge)[1];
+			if (!state.DecodeVertex(code & 15, extra, end, c))
+				return false;
+			state.PushEdge(c, b);
+			state.PushEdge(a, c);
+		}
+		else
+		{
+			if (extra == end)
+				return false;
+			const std::uint32_t codes2 = *extra++;
+			if (!state.DecodeVertex(codes2 >> 4, extra, end, a) || !state.DecodeVertex(codes2 & 15, extra, end, b) || !state.DecodeVertex(code & 15, extra, end, c))
+				return false;
+			state.PushEdge(b, a);
+			state.PushEdge(c, b);
+			state.PushEdge(a, c);
+		}
+
+		if (indexByteSize == 2)
+		{
+			output16[t * 3] = (std::uint16_t)a;
+			output16[t * 3 + 1] = (std::uint16_t)b;
+			output16[t * 3 + 2] = (std::uint16_t)c;
+		}
+		else
+		{
+			output32[t * 3] = a;
+			output32[t * 3 + 1] = b;
+			output32[t * 3 + 2] = c;
+		}
+	}
+
+	return extra == end;
+}
@@ -0,0 +1,1438 @@
+﻿#include "Mesh/MeshImporter.h"
+#include "ParallelFor.h"
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace DirectX;
+
+namespace
+{
+	const std::int32_t NoIndex = INT32_MIN;
+	// 每段OBJ文本的最小字节数
+	const std::size_t ObjMinChunkBytes = 256 * 1024;
+
+	bool ReadFileBytes(const std::string& filename, std::vector<char>& outData)
+	{
+		std::ifstream fin(filename, std::ios::binary);
+		if (!fin)
+			return false;
+
+		fin.seekg(0, std::ios_base::end);
+		std::streamoff size = fin.tellg();
+		fin.seekg(0, std::ios_base::beg);
+		outData.resize((std::size_t)size);
+		fin.read(outData.data(), size);
+		return fin.good() || fin.eof();
+	}
+
+	std::string GetExtension(const std::string& filename)
+	{
+		std::size_t dot = filename.find_last_of('.');
+		if (dot == std::string::npos)
+			return std::string();
+
+		std::string ext = filename.substr(dot + 1);
+		for (char& c : ext)
+			c = (char)((c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c);
+		return ext;
+	}
+
+	std::string GetDirectory(const std::string& filename)
+	{
+		std::size_t slash = filename.find_last_of("/\\");
+		return slash == std::string::npos ? std::string() : filename.substr(0, slash + 1);
+	}
+
+	inline std::uint32_t HashCombine(std::uint32_t h, std::uint32_t v)
+	{
+		h ^= v + 0x9e3779b9u + (h << 6) + (h >> 2);
+		return h;
+	}
+
+	inline std::uint32_t HashBytes(const void* data, std::size_t byteSize)
+	{
+		const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+		std::uint32_t h = 2166136261u;
+		for (std::size_t i = 0; i < byteSize; ++i)
+		{
+			h ^= p[i];
+			h *= 16777619u;
+		}
+		return h;
+	}
+
+	/**
+	*	顶点去重使用的开放寻址Hash表
+	*	表的容量在构造时一次分配，插入过程中不再分配内存
+	*/
+	class VertexHashTable
+	{
+	public:
+
+		explicit VertexHashTable(std::size_t maxEntries)
+		{
+			std::size_t capacity = 16;
+			while (capacity < maxEntries * 2)
+				capacity <<= 1;
+			Slots.assign(capacity, Slot());
+			Mask = capacity - 1;
+		}
+
+		// 查找与equal(已有顶点下标)相等的顶点，不存在时以newIndex插入并返回newIndex
+		template<typename EqualFunc>
+		std::uint32_t FindOrAdd(std::uint32_t hash, std::uint32_t newIndex, EqualFunc&& equal)
+		{
+			std::size_t i = hash & Mask;
+			while (true)
+			{
+				Slot& slot = Slots[i];
+				if (slot.Index == EmptySlot)
+				{
+					slot.Hash = hash;
+					slot.Index = newIndex;
+					return newIndex;
+				}
+				if (slot.Hash == hash && equal(slot.Index))
+					return slot.Index;
+
+				i = (i + 1) & Mask;
+			}
+		}
+
+	private:
+
+		static const std::uint32_t EmptySlot = 0xFFFFFFFFu;
+
+		struct Slot
+		{
+			std::uint32_t Hash = 0;
+			std::uint32_t Index = EmptySlot;
+		};
+
+		std::vector<Slot> Slots;
+		std::size_t Mask = 0;
+	};
+
+	// 快速解析浮点数(不依赖locale)，失败时返回false且不移动指针
+	bool ParseFloat(const char*& p, const char* end, float& outValue)
+	{
+		const char* s = p;
+		while (s < end && (*s == ' ' || *s == '\t'))
+			++s;
+
+		bool negative = false;
+		if (s < end && (*s == '-' || *s == '+'))
+		{
+			negative = *s == '-';
+			++s;
+		}
+
+		double value = 0.0;
+		bool hasDigits = false;
+		while (s < end && *s >= '0' && *s <= '9')
+		{
+			value = value * 10.0 + (*s - '0');
+			++s;
+			hasDigits = true;
+		}
+
+		if (s < end && *s == '.')
+		{
+			++s;
+			double scale = 0.1;
+			while (s < end && *s >= '0' && *s <= '9')
+			{
+				value += (*s - '0') * scale;
+				scale *= 0.1;
+				++s;
+				hasDigits = true;
+			}
+		}
+
+		if (!hasDigits)
+			return false;
+
+		if (s < end && (*s == 'e' || *s == 'E'))
+		{
+			const char* e = s + 1;
+			bool negativeExp = false;
+			if (e < end && (*e == '-' || *e == '+'))
+			{
+				negativeExp = *e == '-';
+				++e;
+			}
+			int exponent = 0;
+			bool hasExpDigits = false;
+			while (e < end && *e >= '0' && *e <= '9')
+			{
+				exponent = exponent * 10 + (*e - '0');
+				++e;
+				hasExpDigits = true;
+			}
+			if (hasExpDigits)
+			{
+				value *= std::pow(10.0, negativeExp ? -exponent : exponent);
+				s = e;
+			}
+		}
+
+		outValue = (float)(negative ? -value : value);
+		p = s;
+		return true;
+	}
+
+	bool ParseInt(const char*& p, const char* end, std::int32_t& outValue)
+	{
+		const char* s = p;
+		bool negative = false;
+		if (s < end && (*s == '-' || *s == '+'))
+		{
+			negative = *s == '-';
+			++s;
+		}
+
+		std::int64_t value = 0;
+		const char* digits = s;
+		while (s < end && *s >= '0' && *s <= '9')
+		{
+			value = value * 10 + (*s - '0');
+			++s;
+		}
+		if (s == digits || value > INT32_MAX)
+			return false;
+
+		outValue = (std::int32_t)(negative ? -value : value);
+		p = s;
+		return true;
+	}
+
+
+	//-------------------------------------------------------------------------------------
+	// OBJ
+	//-------------------------------------------------------------------------------------
+
+	// 面顶点引用的属性下标，Relative中的位表示对应下标是相对于本段起始位置的下标
+	struct ObjCorner
+	{
+		std::int32_t V = NoIndex;
+		std::int32_t T = NoIndex;
+		std::int32_t N = NoIndex;
+		std::uint32_t Relative = 0;
+	};
+
+	struct ObjGroup
+	{
+		std::size_t Triangle = 0;
+		std::string Name;
+	};
+
+	// 一段OBJ文本的解析结果
+	struct ObjChunk
+	{
+		const char* Begin = nullptr;
+		const char* End = nullptr;
+
+		std::vector<XMFLOAT3> Positions;
+		std::vector<XMFLOAT4> Colors;
+		std::vector<XMFLOAT2> TexCoords;
+		std::vector<XMFLOAT3> Normals;
+		std::vector<ObjCorner> Corners;
+		std::vector<ObjGroup> Groups;
+		bool HasColors = false;
+
+		// 合并时使用的全局起始下标
+		std::size_t PositionBase = 0;
+		std::size_t TexCoordBase = 0;
+		std::size_t NormalBase = 0;
+		std::size_t CornerBase = 0;
+
+		std::string Error;
+	};
+
+	// 解析面顶点中的一个下标(v, vt或vn)，负数下标转换为相对于本段的下标
+	bool ResolveObjIndex(std::int32_t index, std::size_t localCount, std::int32_t& outIndex, bool& outRelative)
+	{
+		if (index > 0)
+		{
+			outIndex = index - 1;
+			outRelative = false;
+			return true;
+		}
+		if (index < 0)
+		{
+			outIndex = (std::int32_t)localCount + index;
+			outRelative = true;
+			return true;
+		}
+		return false;
+	}
+
+	void ParseObjChunk(ObjChunk& chunk)
+	{
+		std::vector<ObjCorner> polygon;
+		const char* p = chunk.Begin;
+		const char* end = chunk.End;
+		while (p < end)
+		{
+			const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+			if (lineEnd == nullptr)
+				lineEnd = end;
+
+			const char* s = p;
+			while (s < lineEnd && (*s == ' ' || *s == '\t'))
+				++s;
+
+			if (lineEnd - s >= 2 && s[0] == 'v' && (s[1] == ' ' || s[1] == '\t'))
+			{
+				const char* c = s + 1;
+				float values[6] = { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f };
+				int count = 0;
+				while (count < 6 && ParseFloat(c, lineEnd, values[count]))
+					++count;
+				if (count < 3)
+				{
+					chunk.Error = "invalid vertex position";
+					return;
+				}
+				chunk.Positions.push_back(XMFLOAT3(values[0], values[1], values[2]));
+				chunk.Colors.push_back(XMFLOAT4(values[3], values[4], values[5], 1.0f));
+				chunk.HasColors |= count >= 6;
+			}
+			else if (lineEnd - s >= 3 && s[0] == 'v' && s[1] == 't' && (s[2] == ' ' || s[2] == '\t'))
+			{
+				const char* c = s + 2;
+				XMFLOAT2 uv(0.0f, 0.0f);
+				if (!ParseFloat(c, lineEnd, uv.x))
+				{
+					chunk.Error = "invalid texture coordinate";
+					return;
+				}
+				ParseFloat(c, lineEnd, uv.y);
+				chunk.TexCoords.push_back(uv);
+			}
+			else if (lineEnd - s >= 3 && s[0] == 'v' && s[1] == 'n' && (s[2] == ' ' || s[2] == '\t'))
+			{
+				const char* c = s + 2;
+				XMFLOAT3 n;
+				if (!ParseFloat(c, lineEnd, n.x) || !ParseFloat(c, lineEnd, n.y) || !ParseFloat(c, lineEnd, n.z))
+				{
+					chunk.Error = "invalid normal";
+					return;
+				}
+				chunk.Normals.push_back(n);
+			}
+			else if (lineEnd - s >= 2 && s[0] == 'f' && (s[1] == ' ' || s[1] == '\t'))
+			{
+				polygon.clear();
+				const char* c = s + 1;
+				while (true)
+				{
+					while (c < lineEnd && (*c == ' ' || *c == '\t' || *c == '\r'))
+						++c;
+					if (c >= lineEnd)
+						break;
+
+					// v, v/vt, v//vn, v/vt/vn
+					ObjCorner corner;
+					std::int32_t index = 0;
+					bool relative = false;
+					if (!ParseInt(c, lineEnd, index) || !ResolveObjIndex(index, chunk.Positions.size(), corner.V, relative))
+					{
+						chunk.Error = "invalid face";
+						return;
+					}
+					corner.Relative |= relative ? 1u : 0u;
+
+					if (c < lineEnd && *c == '/')
+					{
+						++c;
+						if (c < lineEnd && *c != '/')
+						{
+							if (!ParseInt(c, lineEnd, index) || !ResolveObjIndex(index, chunk.TexCoords.size(), corner.T, relative))
+							{
+								chunk.Error = "invalid face";
+								return;
+							}
+							corner.Relative |= relative ? 2u : 0u;
+						}
+						if (c < lineEnd && *c == '/')
+						{
+							++c;
+							if (!ParseInt(c, lineEnd, index) || !ResolveObjIndex(index, chunk.Normals.size(), corner.N, relative))
+							{
+								chunk.Error = "invalid face";
+								return;
+							}
+							corner.Relative |= relative ? 4u : 0u;
+						}
+					}
+					polygon.push_back(corner);
+				}
+
+				// 多边形按扇形拆分为三角形
+				for (std::size_t i = 2; i < polygon.size(); ++i)
+				{
+					chunk.Corners.push_back(polygon[0]);
+					chunk.Corners.push_back(polygon[i - 1]);
+					chunk.Corners.push_back(polygon[i]);
+				}
+			}
+			else if (lineEnd - s >= 2 && (s[0] == 'o' || s[0] == 'g') && (s[1] == ' ' || s[1] == '\t'))
+			{
+				const char* nameBegin = s + 2;
+				const char* nameEnd = lineEnd;
+				while (nameBegin < nameEnd && (*nameBegin == ' ' || *nameBegin == '\t'))
+					++nameBegin;
+				while (nameEnd > nameBegin && (nameEnd[-1] == '\r' || nameEnd[-1] == ' ' || nameEnd[-1] == '\t'))
+					--nameEnd;
+
+				ObjGroup group;
+				group.Triangle = chunk.Corners.size() / 3;
+				group.Name.assign(nameBegin, nameEnd);
+				chunk.Groups.push_back(group);
+			}
+
+			p = lineEnd + 1;
+		}
+	}
+
+	// 将本段的下标转换为全局下标
+	bool ToGlobalIndex(std::int32_t index, bool relative, std::size_t base, std::size_t count, std::int32_t& outIndex)
+	{
+		if (index == NoIndex)
+		{
+			outIndex = NoIndex;
+			return true;
+		}
+
+		const std::int64_t global = relative ? (std::int64_t)base + index : (std::int64_t)index;
+		if (global < 0 || global >= (std::int64_t)count)
+			return false;
+
+		outIndex = (std::int32_t)global;
+		return true;
+	}
+
+	// 由各段中的分组标记构建子集
+	void BuildObjSubsets(const std::vector<ObjChunk>& chunks, std::size_t triangleCount, MeshData& outMesh)
+	{
+		std::vector<ObjGroup> groups;
+		groups.push_back({ 0, "default" });
+		for (const ObjChunk& chunk : chunks)
+		{
+			for (const ObjGroup& group : chunk.Groups)
+			{
+				ObjGroup global = group;
+				global.Triangle += chunk.CornerBase / 3;
+				// 没有任何三角形的分组由后续分组替代
+				if (groups.back().Triangle == global.Triangle)
+					groups.back() = global;
+				else
+					groups.push_back(global);
+			}
+		}
+
+		for (std::size_t i = 0; i < groups.size(); ++i)
+		{
+			const std::size_t first = groups[i].Triangle;
+			const std::size_t last = i + 1 < groups.size() ? groups[i + 1].Triangle : triangleCount;
+			if (last <= first)
+				continue;
+
+			MeshSubset subset;
+			subset.Name = groups[i].Name;
+			subset.StartIndexLocation = (std::uint32_t)(first * 3);
+			subset.IndexCount = (std::uint32_t)((last - first) * 3);
+			outMesh.Subsets.push_back(subset);
+		}
+	}
+
+	void ComputeAllSubsetBounds(MeshData& mesh, unsigned threadCount)
+	{
+		ParallelFor(mesh.Subsets.size(), 1, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+				mesh.Subsets[i].Bounds = ComputeSubsetBounds(mesh, mesh.Subsets[i]);
+		}, threadCount);
+	}
+
+
+	//-------------------------------------------------------------------------------------
+	// JSON(仅用于读取glTF)
+	//-------------------------------------------------------------------------------------
+
+	struct JsonValue
+	{
+		enum class Type { Null, Bool, Number, String, Array, Object };
+
+		Type ValueType = Type::Null;
+		bool Bool = false;
+		double Number = 0.0;
+		std::string String;
+		std::vector<JsonValue> Array;
+		std::vector<std::pair<std::string, JsonValue>> Object;
+
+		const JsonValue* Find(const char* key) const
+		{
+			for (const auto& member : Object)
+			{
+				if (member.first == key)
+					return &member.second;
+			}
+			return nullptr;
+		}
+
+		double GetNumber(const char* key, double defaultValue) const
+		{
+			const JsonValue* v = Find(key);
+			return (v && v->ValueType == Type::Number) ? v->Number : defaultValue;
+		}
+
+		int GetInt(const char* key, int defaultValue) const
+		{
+			return (int)GetNumber(key, defaultValue);
+		}
+
+		std::string GetString(const char* key) const
+		{
+			const JsonValue* v = Find(key);
+			return (v && v->ValueType == Type::String) ? v->String : std::string();
+		}
+
+		bool GetBool(const char* key, bool defaultValue) const
+		{
+			const JsonValue* v = Find(key);
+			return (v && v->ValueType == Type::Bool) ? v->Bool : defaultValue;
+		}
+	};
+
+	class JsonParser
+	{
+	public:
+
+		JsonParser(const char* begin, const char* end) : P(begin), End(end) {}
+
+		bool Parse(JsonValue& outValue)
+		{
+			return ParseValue(outValue, 0) && (SkipSpaces(), P == End);
+		}
+
+	private:
+
+		void SkipSpaces()
+		{
+			while (P < End && (*P == ' ' || *P == '\t' || *P == '\n' || *P == '\r'))
+				++P;
+		}
+
+		bool Match(const char* literal)
+		{
+			std::size_t length = std::strlen(literal);
+			if ((std::size_t)(End - P) < length || std::memcmp(P, literal, length) != 0)
+				return false;
+			P += length;
+			return true;
+		}
+
+		bool ParseString(std::string& outString)
+		{
+			if (P >= End || *P != '"')
+				return false;
+			++P;
+			while (P < End && *P != '"')
+			{
+				char c = *P++;
+				if (c != '\\')
+				{
+					outString.push_back(c);
+					continue;
+				}
+				if (P >= End)
+					return false;
+				char e = *P++;
+				switch (e)
+				{
+				case 'n': outString.push_back('\n'); break;
+				case 't': outString.push_back('\t'); break;
+				case 'r': outString.push_back('\r'); break;
+				case 'b': outString.push_back('\b'); break;
+				case 'f': outString.push_back('\f'); break;
+				case 'u':
+				{
+					// 仅保留ASCII范围的字符，glTF中的键与路径通常不含转义的非ASCII字符
+					if (End - P < 4)
+						return false;
+					unsigned code = (unsigned)std::strtoul(std::string(P, P + 4).c_str(), nullptr, 16);
+					outString.push_back(code < 0x80 ? (char)code : '?');
+					P += 4;
+					break;
+				}
+				default: outString.push_back(e); break;
+				}
+			}
+			if (P >= End)
+				return false;
+			++P;
+			return true;
+		}
+
+		bool ParseValue(JsonValue& outValue, int depth)
+		{
+			if (depth > 64)
+				return false;
+
+			SkipSpaces();
+			if (P >= End)
+				return false;
+
+			switch (*P)
+			{
+			case '{':
+			{
+				++P;
+				outValue.ValueType = JsonValue::Type::Object;
+				SkipSpaces();
+				if (P < End && *P == '}')
+				{
+					++P;
+					return true;
+				}
+				while (true)
+				{
+					SkipSpaces();
+					std::pair<std::string, JsonValue> member;
+					if (!ParseString(member.first))
+						return false;
+					SkipSpaces();
+					if (P >= End || *P != ':')
+						return false;
+					++P;
+					if (!ParseValue(member.second, depth + 1))
+						return false;
+					outValue.Object.push_back(std::move(member));
+					SkipSpaces();
+					if (P < End && *P == ',')
+					{
+						++P;
+						continue;
+					}
+					if (P < End && *P == '}')
+					{
+						++P;
+						return true;
+					}
+					return false;
+				}
+			}
+			case '[':
+			{
+				++P;
+				outValue.ValueType = JsonValue::Type::Array;
+				SkipSpaces();
+				if (P < End && *P == ']')
+				{
+					++P;
+					return true;
+				}
+				while (true)
+				{
+					outValue.Array.emplace_back();
+					if (!ParseValue(outValue.Array.back(), depth + 1))
+						return false;
+					SkipSpaces();
+					if (P < End && *P == ',')
+					{
+						++P;
+						continue;
+					}
+					if (P < End && *P == ']')
+					{
+						++P;
+						return true;
+					}
+					return false;
+				}
+			}
+			case '"':
+				outValue.ValueType = JsonValue::Type::String;
+				return ParseString(outValue.String);
+			case 't':
+				outValue.ValueType = JsonValue::Type::Bool;
+				outValue.Bool = true;
+				return Match("true");
+			case 'f':
+				outValue.ValueType = JsonValue::Type::Bool;
+				outValue.Bool = false;
+				return Match("false");
+			case 'n':
+				outValue.ValueType = JsonValue::Type::Null;
+				return Match("null");
+			default:
+			{
+				char* numberEnd = nullptr;
+				std::string number;
+				while (P < End && (std::strchr("+-.eE", *P) != nullptr || (*P >= '0' && *P <= '9')))
+					number.push_back(*P++);
+				outValue.ValueType = JsonValue::Type::Number;
+				outValue.Number = std::strtod(number.c_str(), &numberEnd);
+				return !number.empty() && numberEnd == number.c_str() + number.size();
+			}
+			}
+		}
+
+		const char* P;
+		const char* End;
+	};
+
+
+	//-------------------------------------------------------------------------------------
+	// glTF
+	//-------------------------------------------------------------------------------------
+
+	const int GltfComponentByte = 5120;
+	const int GltfComponentUnsignedByte = 5121;
+	const int GltfComponentShort = 5122;
+	const int GltfComponentUnsignedShort = 5123;
+	const int GltfComponentUnsignedInt = 5125;
+	const int GltfComponentFloat = 5126;
+	const int GltfModeTriangles = 4;
+
+	bool DecodeBase64(const std::string& text, std::vector<char>& outData)
+	{
+		auto decodeChar = [](char c) -> int
+		{
+			if (c >= 'A' && c <= 'Z') return c - 'A';
+			if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+			if (c >= '0' && c <= '9') return c - '0' + 52;
+			if (c == '+') return 62;
+			if (c == '/') return 63;
+			return -1;
+		};
+
+		outData.clear();
+		outData.reserve(text.size() / 4 * 3);
+		unsigned bits = 0;
+		int bitCount = 0;
+		for (char c : text)
+		{
+			if (c == '=')
+				break;
+			int v = decodeChar(c);
+			if (v < 0)
+				return false;
+			bits = (bits << 6) | (unsigned)v;
+			bitCount += 6;
+			if (bitCount >= 8)
+			{
+				bitCount -= 8;
+				outData.push_back((char)((bits >> bitCount) & 0xFF));
+			}
+		}
+		return true;
+	}
+
+	// 访问器所描述的一段类型化数据
+	struct GltfAccessorView
+	{
+		const std::uint8_t* Data = nullptr;
+		std::size_t Count = 0;
+		std::size_t Stride = 0;
+		int ComponentType = 0;
+		int ComponentCount = 0;
+		bool Normalized = false;
+	};
+
+	struct GltfDocument
+	{
+		JsonValue Root;
+		std::vector<std::vector<char>> Buffers;
+	};
+
+	int GltfComponentCount(const std::string& type)
+	{
+		if (type == "SCALAR") return 1;
+		if (type == "VEC2") return 2;
+		if (type == "VEC3") return 3;
+		if (type == "VEC4") return 4;
+		return 0;
+	}
+
+	std::size_t GltfComponentSize(int componentType)
+	{
+		switch (componentType)
+		{
+		case GltfComponentByte:
+		case GltfComponentUnsignedByte: return 1;
+		case GltfComponentShort:
+		case GltfComponentUnsignedShort: return 2;
+		case GltfComponentUnsignedInt:
+		case GltfComponentFloat: return 4;
+		default: return 0;
+		}
+	}
+
+	bool GetAccessorView(const GltfDocument& doc, int accessorIndex, GltfAccessorView& outView, std::string& outError)
+	{
+		const JsonValue* accessors = doc.Root.Find("accessors");
+		const JsonValue* bufferViews = doc.Root.Find("bufferViews");
+		if (accessors == nullptr || accessorIndex < 0 || accessorIndex >= (int)accessors->Array.size())
+		{
+			outError = "invalid accessor";
+			return false;
+		}
+
+		const JsonValue& accessor = accessors->Array[accessorIndex];
+		if (accessor.Find("sparse") != nullptr)
+		{
+			outError = "sparse accessors are not supported";
+			return false;
+		}
+
+		outView.Count = (std::size_t)accessor.GetNumber("count", 0);
+		outView.ComponentType = accessor.GetInt("componentType", 0);
+		outView.ComponentCount = GltfComponentCount(accessor.GetString("type"));
+		outView.Normalized = accessor.GetBool("normalized", false);
+		const std::size_t elementSize = GltfComponentSize(outView.ComponentType) * outView.ComponentCount;
+		if (elementSize == 0)
+		{
+			outError = "unsupported accessor format";
+			return false;
+		}
+
+		const int viewIndex = accessor.GetInt("bufferView", -1);
+		if (bufferViews == nullptr || viewIndex < 0 || viewIndex >= (int)bufferViews->Array.size())
+		{
+			outError = "accessor without bufferView is not supported";
+			return false;
+		}
+
+		const JsonValue& view = bufferViews->Array[viewIndex];
+		const int bufferIndex = view.GetInt("buffer", -1);
+		if (bufferIndex < 0 || bufferIndex >= (int)doc.Buffers.size())
+		{
+			outError = "invalid buffer";
+			return false;
+		}
+
+		const std::vector<char>& buffer = doc.Buffers[bufferIndex];
+		const std::size_t offset = (std::size_t)view.GetNumber("byteOffset", 0) + (std::size_t)accessor.GetNumber("byteOffset", 0);
+		outView.Stride = (std::size_t)view.GetNumber("byteStride", 0);
+		if (outView.Stride == 0)
+			outView.Stride = elementSize;
+
+		if (outView.Count > 0 && offset + outView.Stride * (outView.Count - 1) + elementSize > buffer.size())
+		{
+			outError = "accessor out of buffer range";
+			return false;
+		}
+
+		outView.Data = reinterpret_cast<const std::uint8_t*>(buffer.data()) + offset;
+		return true;
+	}
+
+	// 读取一个元素的第c个分量并转换为float(normalized整数映射到[0,1]或[-1,1])
+	float ReadComponent(const GltfAccessorView& view, std::size_t element, int c)
+	{
+		const std::uint8_t* p = view.Data + element * view.Stride + GltfComponentSize(view.ComponentType) * c;
+		switch (view.ComponentType)
+		{
+		case GltfComponentFloat: { float v; std::memcpy(&v, p, 4); return v; }
+		case GltfComponentUnsignedByte: return view.Normalized ? *p / 255.0f : (float)*p;
+		case GltfComponentByte: { std::int8_t v = (std::int8_t)*p; return view.Normalized ? std::fmax(v / 127.0f, -1.0f) : (float)v; }
+		case GltfComponentUnsignedShort: { std::uint16_t v; std::memcpy(&v, p, 2); return view.Normalized ? v / 65535.0f : (float)v; }
+		case GltfComponentShort: { std::int16_t v; std::memcpy(&v, p, 2); return view.Normalized ? std::fmax(v / 32767.0f, -1.0f) : (float)v; }
+		case GltfComponentUnsignedInt: { std::uint32_t v; std::memcpy(&v, p, 4); return (float)v; }
+		default: return 0.0f;
+		}
+	}
+
+	std::uint32_t ReadIndex(const GltfAccessorView& view, std::size_t element)
+	{
+		const std::uint8_t* p = view.Data + element * view.Stride;
+		switch (view.ComponentType)
+		{
+		case GltfComponentUnsignedByte: return *p;
+		case GltfComponentUnsignedShort: { std::uint16_t v; std::memcpy(&v, p, 2); return v; }
+		case GltfComponentUnsignedInt: { std::uint32_t v; std::memcpy(&v, p, 4); return v; }
+		default: return 0;
+		}
+	}
+
+	bool LoadGltfDocument(const std::string& filename, GltfDocument& outDoc, std::string& outError, MeshImportInfo* pInfo)
+	{
+		std::vector<char> fileData;
+		if (!ReadFileBytes(filename, fileData))
+		{
+			outError = "cannot read " + filename;
+			return false;
+		}
+		if (pInfo)
+		{
+			pInfo->SourceFiles.push_back(filename);
+			pInfo->SourceByteSize += fileData.size();
+		}
+
+		const char* jsonBegin = fileData.data();
+		const char* jsonEnd = fileData.data() + fileData.size();
+		std::vector<char> glbBinary;
+
+		// GLB: 12字节文件头 + JSON块 + 可选的BIN块
+		if (fileData.size() >= 12 && std::memcmp(fileData.data(), "glTF", 4) == 0)
+		{
+			std::size_t offset = 12;
+			bool hasJson = false;
+			while (offset + 8 <= fileData.size())
+			{
+				std::uint32_t chunkLength = 0, chunkType = 0;
+				std::memcpy(&chunkLength, fileData.data() + offset, 4);
+				std::memcpy(&chunkType, fileData.data() + offset + 4, 4);
+				offset += 8;
+				if (offset + chunkLength > fileData.size())
+				{
+					outError = "truncated GLB chunk";
+					return false;
+				}
+				if (chunkType == 0x4E4F534A && !hasJson)		// 'JSON'
+				{
+					jsonBegin = fileData.data() + offset;
+					jsonEnd = jsonBegin + chunkLength;
+					hasJson = true;
+				}
+				else if (chunkType == 0x004E4942 && glbBinary.empty())	// 'BIN\0'
+				{
+					glbBinary.assign(fileData.data() + offset, fileData.data() + offset + chunkLength);
+				}
+				offset += (chunkLength + 3) & ~3u;
+			}
+			if (!hasJson)
+			{
+				outError = "GLB without JSON chunk";
+				return false;
+			}
+		}
+
+		JsonParser parser(jsonBegin, jsonEnd);
+		if (!parser.Parse(outDoc.Root) || outDoc.Root.ValueType != JsonValue::Type::Object)
+		{
+			outError = "invalid glTF JSON";
+			return false;
+		}
+
+		const JsonValue* buffers = outDoc.Root.Find("buffers");
+		if (buffers != nullptr)
+		{
+			const std::string directory = GetDirectory(filename);
+			for (std::size_t i = 0; i < buffers->Array.size(); ++i)
+			{
+				const std::string uri = buffers->Array[i].GetString("uri");
+				std::vector<char> data;
+				if (uri.empty())
+				{
+					// 没有uri的buffer为GLB中的BIN块
+					data = glbBinary;
+				}
+				else if (uri.compare(0, 5, "data:") == 0)
+				{
+					std::size_t comma = uri.find(";base64,");
+					if (comma == std::string::npos || !DecodeBase64(uri.substr(comma + 8), data))
+					{
+						outError = "unsupported data uri";
+						return false;
+					}
+				}
+				else if (uri.find("://") != std::string::npos)
+				{
+					outError = "only local buffers are supported: " + uri;
+					return false;
+				}
+				else
+				{
+					const std::string path = directory + uri;
+					if (!ReadFileBytes(path, data))
+					{
+						outError = "cannot read buffer " + path;
+						return false;
+					}
+					if (pInfo)
+					{
+						pInfo->SourceFiles.push_back(path);
+						pInfo->SourceByteSize += data.size();
+					}
+				}
+
+				if (data.size() < (std::size_t)buffers->Array[i].GetNumber("byteLength", 0))
+				{
+					outError = "buffer smaller than byteLength";
+					return false;
+				}
+				outDoc.Buffers.push_back(std::move(data));
+			}
+		}
+		return true;
+	}
+
+	// 一个图元在合并后的源顶点/索引数组中的位置
+	struct GltfPrimitive
+	{
+		const JsonValue* Json = nullptr;
+		std::string Name;
+		std::size_t VertexBase = 0;
+		std::size_t VertexCount = 0;
+		std::size_t IndexBase = 0;
+		std::size_t IndexCount = 0;
+		std::string Error;
+	};
+
+	// 源顶点的全部属性，用于去重比较
+	struct GltfSourceVertex
+	{
+		XMFLOAT3 Position;
+		XMFLOAT3 Normal;
+		XMFLOAT2 TexCoord;
+		XMFLOAT4 Color;
+	};
+}
+
+
+bool MeshImporter::ImportFile(const std::string& filename, MeshData& outMesh, std::string& outError,
+	const MeshImportOptions& options, MeshImportInfo* pInfo)
+{
+	const std::string ext = GetExtension(filename);
+	if (ext == "gltf" || ext == "glb")
+		return ImportGltf(filename, outMesh, outError, options, pInfo);
+
+	if (ext != "obj")
+	{
+		outError = "unsupported mesh format: " + filename;
+		return false;
+	}
+
+	std::vector<char> text;
+	if (!ReadFileBytes(filename, text))
+	{
+		outError = "cannot read " + filename;
+		return false;
+	}
+	if (pInfo)
+		pInfo->SourceFiles.push_back(filename);
+
+	return ImportObj(text.data(), text.size(), outMesh, outError, options, pInfo);
+}
+
+bool MeshImporter::ImportObj(const char* text, std::size_t byteSize, MeshData& outMesh, std::string& outError,
+	const MeshImportOptions& options, MeshImportInfo* pInfo)
+{
+	const unsigned threadCount = options.ThreadCount ? options.ThreadCount : GetDefaultThreadCount();
+
+	// 在换行处将文本拆分为若干段
+	std::size_t chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(byteSize / ObjMinChunkBytes, (std::size_t)threadCount * 4));
+	std::vector<ObjChunk> chunks;
+	chunks.reserve(chunkCount);
+	const char* end = text + byteSize;
+	const char* begin = text;
+	for (std::size_t i = 0; i < chunkCount && begin < end; ++i)
+	{
+		const char* chunkEnd = i + 1 == chunkCount ? end : text + byteSize / chunkCount * (i + 1);
+		if (chunkEnd < begin)
+			chunkEnd = begin;
+		const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+		chunkEnd = newline ? newline + 1 : end;
+
+		ObjChunk chunk;
+		chunk.Begin = begin;
+		chunk.End = chunkEnd;
+		chunks.push_back(std::move(chunk));
+		begin = chunkEnd;
+	}
+
+	// 第一步: 各段并行解析
+	ParallelFor(chunks.size(), 1, [&](std::size_t b, std::size_t e)
+	{
+		for (std::size_t i = b; i < e; ++i)
+			ParseObjChunk(chunks[i]);
+	}, threadCount);
+
+	// 第二步: 计算各段属性在全局数组中的起始下标
+	std::size_t positionCount = 0, texCoordCount = 0, normalCount = 0, cornerCount = 0;
+	bool hasColors = false;
+	for (ObjChunk& chunk : chunks)
+	{
+		if (!chunk.Error.empty())
+		{
+			outError = chunk.Error;
+			return false;
+		}
+		chunk.PositionBase = positionCount;
+		chunk.TexCoordBase = texCoordCount;
+		chunk.NormalBase = normalCount;
+		chunk.CornerBase = cornerCount;
+		positionCount += chunk.Positions.size();
+		texCoordCount += chunk.TexCoords.size();
+		normalCount += chunk.Normals.size();
+		cornerCount += chunk.Corners.size();
+		hasColors |= chunk.HasColors;
+	}
+
+	if (cornerCount == 0)
+	{
+		outError = "no faces";
+		return false;
+	}
+	if (cornerCount > 0xFFFFFFFFull)
+	{
+		outError = "mesh too large";
+		return false;
+	}
+
+	// 合并属性并将面顶点下标转换为全局下标
+	std::vector<XMFLOAT3> positions(positionCount);
+	std::vector<XMFLOAT4> colors(positionCount);
+	std::vector<XMFLOAT2> texCoords(texCoordCount);
+	std::vector<XMFLOAT3> normals(normalCount);
+	std::vector<ObjCorner> corners(cornerCount);
+	std::vector<std::uint32_t> cornerHashes(cornerCount);
+	bool rangeError = false;
+	ParallelFor(chunks.size(), 1, [&](std::size_t b, std::size_t e)
+	{
+		for (std::size_t i = b; i < e; ++i)
+		{
+			const ObjChunk& chunk = chunks[i];
+			std::copy(chunk.Positions.begin(), chunk.Positions.end(), positions.begin() + chunk.PositionBase);
+			std::copy(chunk.Colors.begin(), chunk.Colors.end(), colors.begin() + chunk.PositionBase);
+			std::copy(chunk.TexCoords.begin(), chunk.TexCoords.end(), texCoords.begin() + chunk.TexCoordBase);
+			std::copy(chunk.Normals.begin(), chunk.Normals.end(), normals.begin() + chunk.NormalBase);
+
+			for (std::size_t c = 0; c < chunk.Corners.size(); ++c)
+			{
+				const ObjCorner& local = chunk.Corners[c];
+				ObjCorner& global = corners[chunk.CornerBase + c];
+				if (!ToGlobalIndex(local.V, (local.Relative & 1) != 0, chunk.PositionBase, positionCount, global.V)
+					|| !ToGlobalIndex(local.T, (local.Relative & 2) != 0, chunk.TexCoordBase, texCoordCount, global.T)
+					|| !ToGlobalIndex(local.N, (local.Relative & 4) != 0, chunk.NormalBase, normalCount, global.N))
+				{
+					rangeError = true;
+					return;
+				}
+				global.Relative = 0;
+				cornerHashes[chunk.CornerBase + c] = HashCombine(HashCombine((std::uint32_t)global.V, (std::uint32_t)global.T), (std::uint32_t)global.N);
+			}
+		}
+	}, threadCount);
+
+	if (rangeError)
+	{
+		outError = "face index out of range";
+		return false;
+	}
+
+	// 第三步: 通过Hash合并引用相同属性的面顶点
+	const bool hasTexCoords = texCoordCount > 0;
+	const bool hasNormals = normalCount > 0;
+	std::vector<ObjCorner> uniqueCorners;
+	uniqueCorners.reserve(options.DeduplicateVertices ? positionCount : cornerCount);
+	outMesh.Indices32.resize(cornerCount);
+
+	if (options.DeduplicateVertices)
+	{
+		VertexHashTable table(cornerCount);
+		for (std::size_t c = 0; c < cornerCount; ++c)
+		{
+			const ObjCorner& corner = corners[c];
+			const std::uint32_t index = table.FindOrAdd(cornerHashes[c], (std::uint32_t)uniqueCorners.size(), [&](std::uint32_t existing)
+			{
+				const ObjCorner& other = uniqueCorners[existing];
+				return other.V == corner.V && other.T == corner.T && other.N == corner.N;
+			});
+			if (index == uniqueCorners.size())
+				uniqueCorners.push_back(corner);
+			outMesh.Indices32[c] = index;
+		}
+	}
+	else
+	{
+		uniqueCorners = corners;
+		for (std::size_t c = 0; c < cornerCount; ++c)
+			outMesh.Indices32[c] = (std::uint32_t)c;
+	}
+
+	// 按合并结果生成顶点
+	const std::size_t vertexCount = uniqueCorners.size();
+	outMesh.Vertices.resize(vertexCount);
+	outMesh.Normals.assign(hasNormals ? vertexCount : 0, XMFLOAT3(0.0f, 0.0f, 0.0f));
+	outMesh.TexCoords.assign(hasTexCoords ? vertexCount : 0, XMFLOAT2(0.0f, 0.0f));
+	ParallelFor(vertexCount, 4096, [&](std::size_t b, std::size_t e)
+	{
+		for (std::size_t i = b; i < e; ++i)
+		{
+			const ObjCorner& corner = uniqueCorners[i];
+			outMesh.Vertices[i].Pos = positions[corner.V];
+			outMesh.Vertices[i].Color = hasColors ? colors[corner.V] : XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+			if (hasNormals && corner.N != NoIndex)
+				outMesh.Normals[i] = normals[corner.N];
+			if (hasTexCoords && corner.T != NoIndex)
+				outMesh.TexCoords[i] = texCoords[corner.T];
+		}
+	}, threadCount);
+
+	outMesh.Subsets.clear();
+	BuildObjSubsets(chunks, cornerCount / 3, outMesh);
+	ComputeAllSubsetBounds(outMesh, threadCount);
+
+	if (pInfo)
+	{
+		pInfo->SourceByteSize += byteSize;
+		pInfo->SourceVertexCount += cornerCount;
+		pInfo->TriangleCount += cornerCount / 3;
+	}
+	return true;
+}
+
+bool MeshImporter::ImportGltf(const std::string& filename, MeshData& outMesh, std::string& outError,
+	const MeshImportOptions& options, MeshImportInfo* pInfo)
+{
+	const unsigned threadCount = options.ThreadCount ? options.ThreadCount : GetDefaultThreadCount();
+
+	GltfDocument doc;
+	if (!LoadGltfDocument(filename, doc, outError, pInfo))
+		return false;
+
+	// 收集所有三角形图元并计算其在合并数组中的位置
+	std::vector<GltfPrimitive> primitives;
+	const JsonValue* meshes = doc.Root.Find("meshes");
+	if (meshes == nullptr || meshes->Array.empty())
+	{
+		outError = "no meshes";
+		return false;
+	}
+
+	const JsonValue* accessors = doc.Root.Find("accessors");
+	std::size_t vertexCount = 0, indexCount = 0;
+	for (std::size_t m = 0; m < meshes->Array.size(); ++m)
+	{
+		const JsonValue& mesh = meshes->Array[m];
+		const JsonValue* prims = mesh.Find("primitives");
+		if (prims == nullptr)
+			continue;
+
+		std::string meshName = mesh.GetString("name");
+		if (meshName.empty())
+			meshName = "mesh" + std::to_string(m);
+
+		for (std::size_t p = 0; p < prims->Array.size(); ++p)
+		{
+			const JsonValue& prim = prims->Array[p];
+			if (prim.GetInt("mode", GltfModeTriangles) != GltfModeTriangles)
+				continue;
+
+			const JsonValue* attributes = prim.Find("attributes");
+			const int positionAccessor = attributes ? attributes->GetInt("POSITION", -1) : -1;
+			if (accessors == nullptr || positionAccessor < 0 || positionAccessor >= (int)accessors->Array.size())
+			{
+				outError = meshName + ": primitive without POSITION";
+				return false;
+			}
+
+			GltfPrimitive primitive;
+			primitive.Json = &prim;
+			primitive.Name = prims->Array.size() == 1 ? meshName : meshName + "_" + std::to_string(p);
+			primitive.VertexCount = (std::size_t)accessors->Array[positionAccessor].GetNumber("count", 0);
+			const int indexAccessor = prim.GetInt("indices", -1);
+			if (indexAccessor >= 0 && indexAccessor < (int)accessors->Array.size())
+				primitive.IndexCount = (std::size_t)accessors->Array[indexAccessor].GetNumber("count", 0);
+			else
+				primitive.IndexCount = primitive.VertexCount;
+			primitive.IndexCount -= primitive.IndexCount % 3;
+
+			primitive.VertexBase = vertexCount;
+			primitive.IndexBase = indexCount;
+			vertexCount += primitive.VertexCount;
+			indexCount += primitive.IndexCount;
+			primitives.push_back(primitive);
+		}
+	}
+
+	if (indexCount == 0)
+	{
+		outError = "no triangles";
+		return false;
+	}
+	if (vertexCount > 0xFFFFFFFFull)
+	{
+		outError = "mesh too large";
+		return false;
+	}
+
+	// 各图元并行读取顶点属性及索引，索引转换为合并后的源顶点下标
+	bool hasNormals = false, hasTexCoords = false;
+	for (const GltfPrimitive& primitive : primitives)
+	{
+		const JsonValue* attributes = primitive.Json->Find("attributes");
+		hasNormals |= attributes->Find("NORMAL") != nullptr;
+		hasTexCoords |= attributes->Find("TEXCOORD_0") != nullptr;
+	}
+
+	std::vector<GltfSourceVertex> sourceVertices(vertexCount);
+	std::vector<std::uint32_t> sourceIndices(indexCount);
+	ParallelFor(primitives.size(), 1, [&](std::size_t b, std::size_t e)
+	{
+		for (std::size_t i = b; i < e; ++i)
+		{
+			GltfPrimitive& primitive = primitives[i];
+			const JsonValue* attributes = primitive.Json->Find("attributes");
+
+			GltfAccessorView positions, normals, texCoords, colors, indices;
+			if (!GetAccessorView(doc, attributes->GetInt("POSITION", -1), positions, primitive.Error))
+				continue;
+			if (positions.ComponentCount != 3)
+			{
+				primitive.Error = "POSITION must be VEC3";
+				continue;
+			}
+
+			const bool primHasNormals = attributes->Find("NORMAL") != nullptr;
+			const bool primHasTexCoords = attributes->Find("TEXCOORD_0") != nullptr;
+			const bool primHasColors = attributes->Find("COLOR_0") != nullptr;
+			if ((primHasNormals && !GetAccessorView(doc, attributes->GetInt("NORMAL", -1), normals, primitive.Error))
+				|| (primHasTexCoords && !GetAccessorView(doc, attributes->GetInt("TEXCOORD_0", -1), texCoords, primitive.Error))
+				|| (primHasColors && !GetAccessorView(doc, attributes->GetInt("COLOR_0", -1), colors, primitive.Error)))
+				continue;
+
+			if ((primHasNormals && normals.Count < primitive.VertexCount)
+				|| (primHasTexCoords && texCoords.Count < primitive.VertexCount)
+				|| (primHasColors && colors.Count < primitive.VertexCount))
+			{
+				primitive.Error = "attribute count mismatch";
+				continue;
+			}
+
+			for (std::size_t v = 0; v < primitive.VertexCount; ++v)
+			{
+				GltfSourceVertex& out = sourceVertices[primitive.VertexBase + v];
+				out.Position = XMFLOAT3(ReadComponent(positions, v, 0), ReadComponent(positions, v, 1), ReadComponent(positions, v, 2));
+				out.Normal = primHasNormals ? XMFLOAT3(ReadComponent(normals, v, 0), ReadComponent(normals, v, 1), ReadComponent(normals, v, 2)) : XMFLOAT3(0.0f, 0.0f, 0.0f);
+				out.TexCoord = primHasTexCoords ? XMFLOAT2(ReadComponent(texCoords, v, 0), ReadComponent(texCoords, v, 1)) : XMFLOAT2(0.0f, 0.0f);
+				if (primHasColors)
+				{
+					out.Color = XMFLOAT4(ReadComponent(colors, v, 0), ReadComponent(colors, v, 1), ReadComponent(colors, v, 2),
+						colors.ComponentCount == 4 ? ReadComponent(colors, v, 3) : 1.0f);
+				}
+				else
+				{
+					out.Color = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+				}
+			}
+
+			const int indexAccessor = primitive.Json->GetInt("indices", -1);
+			if (indexAccessor >= 0)
+			{
+				if (!GetAccessorView(doc, indexAccessor, indices, primitive.Error))
+					continue;
+				for (std::size_t k = 0; k < primitive.IndexCount; ++k)
+				{
+					const std::uint32_t index = ReadIndex(indices, k);
+					if (index >= primitive.VertexCount)
+					{
+						primitive.Error = "index out of range";
+						break;
+					}
+					sourceIndices[primitive.IndexBase + k] = (std::uint32_t)primitive.VertexBase + index;
+				}
+			}
+			else
+			{
+				for (std::size_t k = 0; k < primitive.IndexCount; ++k)
+					sourceIndices[primitive.IndexBase + k] = (std::uint32_t)(primitive.VertexBase + k);
+			}
+		}
+	}, threadCount);
+
+	for (const GltfPrimitive& primitive : primitives)
+	{
+		if (!primitive.Error.empty())
+		{
+			outError = primitive.Name + ": " + primitive.Error;
+			return false;
+		}
+	}
+
+	// 通过Hash合并属性完全相同的顶点(glTF导出时常在图元之间或硬边处重复顶点)
+	std::vector<std::uint32_t> remap(vertexCount);
+	std::vector<std::uint32_t> uniqueSource;
+	if (options.DeduplicateVertices)
+	{
+		std::vector<std::uint32_t> hashes(vertexCount);
+		ParallelFor(vertexCount, 4096, [&](std::size_t b, std::size_t e)
+		{
+			for (std::size_t i = b; i < e; ++i)
+				hashes[i] = HashBytes(&sourceVertices[i], sizeof(GltfSourceVertex));
+		}, threadCount);
+
+		uniqueSource.reserve(vertexCount);
+		VertexHashTable table(vertexCount);
+		for (std::size_t i = 0; i < vertexCount; ++i)
+		{
+			const std::uint32_t index = table.FindOrAdd(hashes[i], (std::uint32_t)uniqueSource.size(), [&](std::uint32_t existing)
+			{
+				return std::memcmp(&sourceVertices[uniqueSource[existing]], &sourceVertices[i], sizeof(GltfSourceVertex)) == 0;
+			});
+			if (index == uniqueSource.size())
+				uniqueSource.push_back((std::uint32_t)i);
+			remap[i] = index;
+		}
+	}
+	else
+	{
+		uniqueSource.resize(vertexCount);
+		for (std::size_t i = 0; i < vertexCount; ++i)
+			uniqueSource[i] = remap[i] = (std::uint32_t)i;
+	}
+
+	const std::size_t uniqueCount = uniqueSource.size();
+	outMesh.Vertices.resize(uniqueCount);
+	outMesh.Normals.assign(hasNormals ? uniqueCount : 0, XMFLOAT3(0.0f, 0.0f, 0.0f));
+	outMesh.TexCoords.assign(hasTexCoords ? uniqueCount : 0, XMFLOAT2(0.0f, 0.0f));
+	ParallelFor(uniqueCount, 4096, [&](std::size_t b, std::size_t e)
+	{
+		for (std::size_t i = b; i < e; ++i)
+		{
+			const GltfSourceVertex& source = sourceVertices[uniqueSource[i]];
+			outMesh.Vertices[i].Pos = source.Position;
+			outMesh.Vertices[i].Color = source.Color;
+			if (hasNormals)
+				outMesh.Normals[i] = source.Normal;
+			if (hasTexCoords)
+				outMesh.TexCoords[i] = source.TexCoord;
+		}
+	}, threadCount);
+
+	outMesh.Indices32.resize(indexCount);
+	ParallelFor(indexCount, 16384, [&](std::size_t b, std::size_t e)
+	{
+		for (std::size_t i = b; i < e; ++i)
+			outMesh.Indices32[i] = remap[sourceIndices[i]];
+	}, threadCount);
+
+	outMesh.Subsets.clear();
+	for (const GltfPrimitive& primitive : primitives)
+	{
+		if (primitive.IndexCount == 0)
+			continue;
+
+		MeshSubset subset;
+		subset.Name = primitive.Name;
+		subset.StartIndexLocation = (std::uint32_t)primitive.IndexBase;
+		subset.IndexCount = (std::uint32_t)primitive.IndexCount;
+		outMesh.Subsets.push_back(subset);
+	}
+	ComputeAllSubsetBounds(outMesh, threadCount);
+
+	if (pInfo)
+	{
+		pInfo->SourceVertexCount += vertexCount;
+		pInfo->TriangleCount += indexCount / 3;
+	}
+	return true;
+}
@@ -0,0 +1,198 @@
+﻿#include "Mesh/MeshIndexing.h"
+#include <algorithm>
+
+namespace
+{
+	const std::uint32_t InvalidLocalIndex = 0xFFFFFFFFu;
+
+	// 子集引用顶点的最小/最大下标(包括BaseVertexLocation)
+	void GetSubsetVertexRange(const MeshData& mesh, const MeshSubset& subset, std::int64_t& outMin, std::int64_t& outMax)
+	{
+		outMin = INT64_MAX;
+		outMax = INT64_MIN;
+		const std::uint32_t* indices = mesh.Indices32.data() + subset.StartIndexLocation;
+		for (std::uint32_t i = 0; i < subset.IndexCount; ++i)
+		{
+			const std::int64_t v = (std::int64_t)indices[i] + subset.BaseVertexLocation;
+			outMin = std::min(outMin, v);
+			outMax = std::max(outMax, v);
+		}
+	}
+
+	// 拆分过程中的一个部分，引用的顶点按首次引用顺序复制到新的顶点数组中
+	struct SubsetChunk
+	{
+		std::uint32_t FirstIndex = 0;
+		std::uint32_t IndexCount = 0;
+		std::vector<std::uint32_t> Vertices;
+	};
+}
+
+std::uint32_t SelectIndexByteSize(const MeshData& mesh)
+{
+	return mesh.CanUse16BitIndices() ? 2 : 4;
+}
+
+void SplitMeshFor16BitIndices(MeshData& mesh, MeshIndexStats* pStats)
+{
+	MeshIndexStats stats;
+	stats.SourceSubsetCount = (std::uint32_t)mesh.Subsets.size();
+
+	// 没有子集时整个索引缓冲区视为一个子集
+	if (mesh.Subsets.empty() && !mesh.Indices32.empty())
+	{
+		MeshSubset subset;
+		subset.Name = mesh.Name;
+		subset.IndexCount = (std::uint32_t)mesh.Indices32.size();
+		mesh.Subsets.push_back(subset);
+	}
+
+	// 子集末尾不足一个三角形的索引不构成图元，从子集中移除
+	for (MeshSubset& subset : mesh.Subsets)
+	{
+		const std::uint32_t remainder = subset.IndexCount % 3;
+		stats.DroppedIndexCount += remainder;
+		subset.IndexCount -= remainder;
+	}
+
+	// 所有子集引用的顶点范围都不超过65536时，只需调整BaseVertexLocation，顶点数组保持不变
+	bool rangesFit = true;
+	for (const MeshSubset& subset : mesh.Subsets)
+	{
+		std::int64_t minVertex, maxVertex;
+		GetSubsetVertexRange(mesh, subset, minVertex, maxVertex);
+		rangesFit &= subset.IndexCount == 0 || maxVertex - minVertex < MaxVerticesPer16BitSubset;
+	}
+
+	if (rangesFit)
+	{
+		for (MeshSubset& subset : mesh.Subsets)
+		{
+			std::int64_t minVertex, maxVertex;
+			GetSubsetVertexRange(mesh, subset, minVertex, maxVertex);
+			if (subset.IndexCount == 0)
+				continue;
+
+			std::uint32_t* indices = mesh.Indices32.data() + subset.StartIndexLocation;
+			for (std::uint32_t i = 0; i < subset.IndexCount; ++i)
+				indices[i] = (std::uint32_t)(indices[i] + subset.BaseVertexLocation - minVertex);
+			subset.BaseVertexLocation = (std::int32_t)minVertex;
+		}
+	}
+	else
+	{
+		// 各子集按三角形顺序划分为引用不超过65536个不同顶点的部分，
+		// 顶点数组重建为各部分所引用顶点的依次拼接，只有跨越部分边界的顶点被复制
+		std::vector<std::uint32_t> localIndex(mesh.Vertices.size(), InvalidLocalIndex);
+		std::vector<bool> referenced(mesh.Vertices.size(), false);
+		std::vector<Vertex> vertices;
+		std::vector<DirectX::XMFLOAT3> normals;
+		std::vector<DirectX::XMFLOAT2> texCoords;
+		std::vector<DirectX::XMFLOAT4> tangents;
+		std::vector<MeshSubset> subsets;
+		std::size_t referencedCount = 0;
+
+		auto emitChunk = [&](const MeshSubset& source, SubsetChunk& chunk)
+		{
+			MeshSubset subset;
+			subset.Name = source.Name;
+			subset.LodLevel = source.LodLevel;
+			subset.LodError = source.LodError;
+			subset.StartIndexLocation = chunk.FirstIndex;
+			subset.IndexCount = chunk.IndexCount;
+			subset.BaseVertexLocation = (std::int32_t)vertices.size();
+
+			std::uint32_t* indices = mesh.Indices32.data() + chunk.FirstIndex;
+			for (std::uint32_t i = 0; i < chunk.IndexCount; ++i)
+				indices[i] = localIndex[indices[i] + source.BaseVertexLocation];
+
+			for (std::uint32_t v : chunk.Vertices)
+			{
+				vertices.push_back(mesh.Vertices[v]);
+				if (!mesh.Normals.empty())
+					normals.push_back(mesh.Normals[v]);
+				if (!mesh.TexCoords.empty())
+					texCoords.push_back(mesh.TexCoords[v]);
+				if (!mesh.Tangents.empty())
+					tangents.push_back(mesh.Tangents[v]);
+				if (!referenced[v])
+				{
+					referenced[v] = true;
+					++referencedCount;
+				}
+				localIndex[v] = InvalidLocalIndex;
+			}
+
+			subsets.push_back(subset);
+			chunk = SubsetChunk();
+		};
+
+		for (const MeshSubset& source : mesh.Subsets)
+		{
+			SubsetChunk chunk;
+			chunk.FirstIndex = source.StartIndexLocation;
+
+			const std::uint32_t* indices = mesh.Indices32.data() + source.StartIndexLocation;
+			for (std::uint32_t t = 0; t + 3 <= source.IndexCount; t += 3)
+			{
+				std::uint32_t newVertices = 0;
+				for (std::uint32_t k = 0; k < 3; ++k)
+					newVertices += localIndex[indices[t + k] + source.BaseVertexLocation] == InvalidLocalIndex ? 1 : 0;
+
+				if (chunk.Vertices.size() + newVertices > MaxVerticesPer16BitSubset)
+				{
+					emitChunk(source, chunk);
+					chunk.FirstIndex = source.StartIndexLocation + t;
+				}
+
+				for (std::uint32_t k = 0; k < 3; ++k)
+				{
+					const std::uint32_t v = indices[t + k] + source.BaseVertexLocation;
+					if (localIndex[v] == InvalidLocalIndex)
+					{
+						localIndex[v] = (std::uint32_t)chunk.Vertices.size();
+						chunk.Vertices.push_back(v);
+					}
+				}
+				chunk.IndexCount += 3;
+			}
+
+			// 空的子集也保留(与只调整BaseVertexLocation时一致)
+			emitChunk(source, chunk);
+		}
+
+		stats.DuplicatedVertexCount = (std::uint32_t)(vertices.size() - referencedCount);
+		mesh.Vertices = std::move(vertices);
+		mesh.Normals = std::move(normals);
+		mesh.TexCoords = std::move(texCoords);
+		mesh.Tangents = std::move(tangents);
+		mesh.Subsets = std::move(subsets);
+	}
+
+	// 不属于任何子集的索引(eg: 上面移除的末尾索引)仍是拆分前的顶点下标，会使索引无法用16位表示，
+	// 此时按子集顺序重建索引缓冲区，只保留各子集的三角形
+	std::size_t subsetIndexCount = 0;
+	for (const MeshSubset& subset : mesh.Subsets)
+		subsetIndexCount += subset.IndexCount;
+	if (subsetIndexCount != mesh.Indices32.size())
+	{
+		std::vector<std::uint32_t> indices;
+		indices.reserve(subsetIndexCount);
+		for (MeshSubset& subset : mesh.Subsets)
+		{
+			const auto begin = mesh.Indices32.begin() + subset.StartIndexLocation;
+			subset.StartIndexLocation = (std::uint32_t)indices.size();
+			indices.insert(indices.end(), begin, begin + subset.IndexCount);
+		}
+		mesh.Indices32 = std::move(indices);
+	}
+
+	for (MeshSubset& subset : mesh.Subsets)
+		subset.Bounds = ComputeSubsetBounds(mesh, subset);
+
+	stats.IndexCount = mesh.Indices32.size();
+	stats.SubsetCount = (std::uint32_t)mesh.Subsets.size();
+	stats.IndexByteSize = SelectIndexByteSize(mesh);
+	if (pStats)
+		*pStats = stats;
+}
@@ -0,0 +1,453 @@
+﻿#include "Mesh/MeshOptimizer.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const std::uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+	// FIFO顶点缓存模拟，顶点在最近cacheSize次缓存写入之内被写入过即视为命中
+	class FifoCache
+	{
+	public:
+
+		FifoCache(std::size_t vertexCount, std::uint32_t cacheSize)
+			: Stamps(vertexCount, 0), CacheSize(cacheSize), Time(cacheSize + 1) {}
+
+		// 访问顶点v，未命中时返回true
+		bool Access(std::uint32_t v)
+		{
+			if (Time - Stamps[v] > CacheSize)
+			{
+				Stamps[v] = Time++;
+				return true;
+			}
+			return false;
+		}
+
+		// 清空缓存
+		void Reset()
+		{
+			Time += CacheSize + 1;
+		}
+
+		std::uint32_t AgeOf(std::uint32_t v) const { return Time - Stamps[v]; }
+
+	private:
+
+		std::vector<std::uint32_t> Stamps;
+		std::uint32_t CacheSize;
+		std::uint32_t Time;
+	};
+
+	// 子集中的一个三角形簇
+	struct TriangleCluster
+	{
+		std::size_t FirstTriangle = 0;
+		std::size_t TriangleCount = 0;
+		float SortKey = 0.0f;
+	};
+
+	// 子集的局部顶点编号，使各个子集的优化只需要与子集顶点数量相关的临时内存
+	struct LocalSubset
+	{
+		std::vector<std::uint32_t> Indices;
+		std::vector<std::uint32_t> GlobalVertices;
+	};
+
+	void BuildLocalSubset(const MeshData& mesh, const MeshSubset& subset, std::vector<std::uint32_t>& globalToLocal, LocalSubset& outLocal)
+	{
+		outLocal.Indices.resize(subset.IndexCount - subset.IndexCount % 3);
+		outLocal.GlobalVertices.clear();
+		const std::uint32_t* indices = mesh.Indices32.data() + subset.StartIndexLocation;
+		for (std::size_t i = 0; i < outLocal.Indices.size(); ++i)
+		{
+			const std::uint32_t v = (std::uint32_t)(indices[i] + subset.BaseVertexLocation);
+			if (globalToLocal[v] == InvalidIndex)
+			{
+				globalToLocal[v] = (std::uint32_t)outLocal.GlobalVertices.size();
+				outLocal.GlobalVertices.push_back(v);
+			}
+			outLocal.Indices[i] = globalToLocal[v];
+		}
+
+		// 恢复临时表供下一个子集使用
+		for (std::uint32_t v : outLocal.GlobalVertices)
+			globalToLocal[v] = InvalidIndex;
+	}
+
+	// 整个索引缓冲区按子集的BaseVertexLocation展开后的顶点下标
+	std::vector<std::uint32_t> GetAbsoluteIndices(const MeshData& mesh)
+	{
+		std::vector<std::uint32_t> indices(mesh.Indices32);
+		for (const MeshSubset& subset : mesh.Subsets)
+		{
+			for (std::uint32_t i = 0; i < subset.IndexCount; ++i)
+				indices[subset.StartIndexLocation + i] += subset.BaseVertexLocation;
+		}
+		return indices;
+	}
+
+	VertexCacheStats AnalyzeMesh(const MeshData& mesh, std::uint32_t cacheSize)
+	{
+		std::vector<std::uint32_t> indices = GetAbsoluteIndices(mesh);
+		return MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), mesh.Vertices.size(), cacheSize);
+	}
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::uint32_t cacheSize)
+{
+	VertexCacheStats stats;
+	stats.TriangleCount = indexCount / 3;
+
+	FifoCache cache(vertexCount, cacheSize);
+	std::vector<bool> referenced(vertexCount, false);
+	for (std::size_t i = 0; i < indexCount; ++i)
+	{
+		const std::uint32_t v = indices[i];
+		stats.MissCount += cache.Access(v) ? 1 : 0;
+		if (!referenced[v])
+		{
+			referenced[v] = true;
+			++stats.VertexCount;
+		}
+	}
+	return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::uint32_t cacheSize)
+{
+	const std::size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0 || vertexCount == 0)
+		return;
+
+	// 每个顶点尚未输出的相邻三角形数量，及顶点-三角形邻接表
+	std::vector<std::uint32_t> liveCount(vertexCount, 0);
+	for (std::size_t i = 0; i < triangleCount * 3; ++i)
+		++liveCount[indices[i]];
+
+	std::vector<std::uint32_t> adjacencyOffset(vertexCount + 1, 0);
+	for (std::size_t v = 0; v < vertexCount; ++v)
+		adjacencyOffset[v + 1] = adjacencyOffset[v] + liveCount[v];
+
+	std::vector<std::uint32_t> adjacency(triangleCount * 3);
+	std::vector<std::uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+	for (std::size_t t = 0; t < triangleCount; ++t)
+	{
+		for (std::size_t k = 0; k < 3; ++k)
+			adjacency[fill[indices[t * 3 + k]]++] = (std::uint32_t)t;
+	}
+
+	std::vector<std::uint32_t> timeStamp(vertexCount, 0);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<std::uint32_t> deadEnd;
+	std::vector<std::uint32_t> candidates;
+	std::vector<std::uint32_t> output;
+	output.reserve(triangleCount * 3);
+
+	std::uint32_t time = cacheSize + 1;
+	std::size_t cursor = 0;
+	std::int64_t fan = indices[0];
+	while (fan >= 0)
+	{
+		// 输出扇形顶点所有尚未输出的相邻三角形
+		candidates.clear();
+		for (std::uint32_t a = adjacencyOffset[fan]; a < adjacencyOffset[fan + 1]; ++a)
+		{
+			const std::uint32_t t = adjacency[a];
+			if (emitted[t])
+				continue;
+
+			for (std::size_t k = 0; k < 3; ++k)
+			{
+				const std::uint32_t v = indices[t * 3 + k];
+				output.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				--liveCount[v];
+				if (time - timeStamp[v] > cacheSize)
+					timeStamp[v] = time++;
+			}
+			emitted[t] = true;
+		}
+
+		// 在候选顶点中选择输出其剩余三角形后仍在缓存中且在缓存中停留最久的顶点
+		std::int64_t next = -1;
+		std::int64_t bestPriority = -1;
+		for (std::uint32_t v : candidates)
+		{
+			if (liveCount[v] == 0)
+				continue;
+
+			std::int64_t priority = 0;
+			if (time - timeStamp[v] + 2 * liveCount[v] <= cacheSize)
+				priority = time - timeStamp[v];
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				next = v;
+			}
+		}
+
+		// 没有合适的候选顶点时，从最近输出的顶点中回溯，再找不到则顺序查找
+		if (next < 0)
+		{
+			while (!deadEnd.empty())
+			{
+				const std::uint32_t v = deadEnd.back();
+				deadEnd.pop_back();
+				if (liveCount[v] > 0)
+				{
+					next = v;
+					break;
+				}
+			}
+		}
+		if (next < 0)
+		{
+			while (cursor < vertexCount)
+			{
+				if (liveCount[cursor] > 0)
+				{
+					next = (std::int64_t)cursor;
+					break;
+				}
+				++cursor;
+			}
+		}
+		fan = next;
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::uint32_t* indices, std::size_t indexCount, const Vertex* vertices, std::size_t vertexCount,
+	std::uint32_t cacheSize, float threshold)
+{
+	const std::size_t triangleCount = indexCount / 3;
+	if (triangleCount < 2)
+		return;
+
+	// 1. 三个顶点都未命中缓存的三角形是Tipsify重新开始的位置，以此划分硬边界
+	std::vector<TriangleCluster> hardClusters;
+	{
+		FifoCache cache(vertexCount, cacheSize);
+		for (std::size_t t = 0; t < triangleCount; ++t)
+		{
+			int misses = 0;
+			for (std::size_t k = 0; k < 3; ++k)
+				misses += cache.Access(indices[t * 3 + k]) ? 1 : 0;
+
+			if (t == 0 || misses == 3)
+			{
+				TriangleCluster cluster;
+				cluster.FirstTriangle = t;
+				hardClusters.push_back(cluster);
+			}
+			++hardClusters.back().TriangleCount;
+		}
+	}
+
+	// 2. 在簇内部，当从簇起点开始的ACMR不超过整个簇ACMR的threshold倍时再次划分(每个新簇以空缓存开始)
+	std::vector<TriangleCluster> clusters;
+	{
+		FifoCache cache(vertexCount, cacheSize);
+		for (const TriangleCluster& hard : hardClusters)
+		{
+			cache.Reset();
+			std::size_t clusterMisses = 0;
+			for (std::size_t t = hard.FirstTriangle; t < hard.FirstTriangle + hard.TriangleCount; ++t)
+			{
+				for (std::size_t k = 0; k < 3; ++k)
+					clusterMisses += cache.Access(indices[t * 3 + k]) ? 1 : 0;
+			}
+			const float limit = (float)clusterMisses / hard.TriangleCount * threshold;
+
+			cache.Reset();
+			TriangleCluster current;
+			current.FirstTriangle = hard.FirstTriangle;
+			std::size_t misses = 0;
+			for (std::size_t t = hard.FirstTriangle; t < hard.FirstTriangle + hard.TriangleCount; ++t)
+			{
+				for (std::size_t k = 0; k < 3; ++k)
+					misses += cache.Access(indices[t * 3 + k]) ? 1 : 0;
+				++current.TriangleCount;
+
+				const bool last = t + 1 == hard.FirstTriangle + hard.TriangleCount;
+				if (last || (float)misses <= limit * current.TriangleCount)
+				{
+					clusters.push_back(current);
+					current = TriangleCluster();
+					current.FirstTriangle = t + 1;
+					misses = 0;
+					cache.Reset();
+				}
+			}
+		}
+	}
+
+	if (clusters.size() < 2)
+		return;
+
+	// 3. 计算各簇的面积加权中心与平均法线，朝向网格外侧程度越大的簇越先绘制
+	auto triangleData = [&](std::size_t t, float centroid[3], float normal[3])
+	{
+		const DirectX::XMFLOAT3& p0 = vertices[indices[t * 3 + 0]].Pos;
+		const DirectX::XMFLOAT3& p1 = vertices[indices[t * 3 + 1]].Pos;
+		const DirectX::XMFLOAT3& p2 = vertices[indices[t * 3 + 2]].Pos;
+		const float e1[3] = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+		const float e2[3] = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+		// 未归一化的法线，长度为三角形面积的2倍
+		normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+		normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+		normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+		centroid[0] = (p0.x + p1.x + p2.x) / 3.0f;
+		centroid[1] = (p0.y + p1.y + p2.y) / 3.0f;
+		centroid[2] = (p0.z + p1.z + p2.z) / 3.0f;
+		return std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+	};
+
+	double meshCenter[3] = { 0.0, 0.0, 0.0 };
+	double meshArea = 0.0;
+	for (std::size_t t = 0; t < triangleCount; ++t)
+	{
+		float c[3], n[3];
+		const float area = triangleData(t, c, n);
+		for (int i = 0; i < 3; ++i)
+			meshCenter[i] += c[i] * area;
+		meshArea += area;
+	}
+	for (int i = 0; i < 3; ++i)
+		meshCenter[i] = meshArea > 0.0 ? meshCenter[i] / meshArea : 0.0;
+
+	for (TriangleCluster& cluster : clusters)
+	{
+		double center[3] = { 0.0, 0.0, 0.0 };
+		double normal[3] = { 0.0, 0.0, 0.0 };
+		double area = 0.0;
+		for (std::size_t t = cluster.FirstTriangle; t < cluster.FirstTriangle + cluster.TriangleCount; ++t)
+		{
+			float c[3], n[3];
+			const float a = triangleData(t, c, n);
+			for (int i = 0; i < 3; ++i)
+			{
+				center[i] += c[i] * a;
+				normal[i] += n[i];
+			}
+			area += a;
+		}
+
+		const double normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if (area <= 0.0 || normalLength <= 0.0)
+		{
+			cluster.SortKey = 0.0f;
+			continue;
+		}
+
+		double key = 0.0;
+		for (int i = 0; i < 3; ++i)
+			key += (center[i] / area - meshCenter[i]) * (normal[i] / normalLength);
+		cluster.SortKey = (float)key;
+	}
+
+	std::stable_sort(clusters.begin(), clusters.end(), [](const TriangleCluster& a, const TriangleCluster& b)
+	{
+		return a.SortKey > b.SortKey;
+	});
+
+	std::vector<std::uint32_t> sorted;
+	sorted.reserve(triangleCount * 3);
+	for (const TriangleCluster& cluster : clusters)
+		sorted.insert(sorted.end(), indices + cluster.FirstTriangle * 3, indices + (cluster.FirstTriangle + cluster.TriangleCount) * 3);
+
+	std::copy(sorted.begin(), sorted.end(), indices);
+}
+
+std::size_t MeshOptimizer::OptimizeVertexFetch(MeshData& mesh)
+{
+	const std::size_t vertexCount = mesh.Vertices.size();
+	std::vector<std::uint32_t> indices = GetAbsoluteIndices(mesh);
+
+	// 按索引缓冲区中首次出现的顺序为顶点重新编号
+	std::vector<std::uint32_t> remap(vertexCount, InvalidIndex);
+	std::uint32_t next = 0;
+	for (std::uint32_t& index : indices)
+	{
+		if (remap[index] == InvalidIndex)
+			remap[index] = next++;
+		index = remap[index];
+	}
+
+	std::vector<Vertex> vertices(next);
+	std::vector<DirectX::XMFLOAT3> normals(mesh.Normals.empty() ? 0 : next);
+	std::vector<DirectX::XMFLOAT2> texCoords(mesh.TexCoords.empty() ? 0 : next);
+	std::vector<DirectX::XMFLOAT4> tangents(mesh.Tangents.empty() ? 0 : next);
+	for (std::size_t v = 0; v < vertexCount; ++v)
+	{
+		const std::uint32_t target = remap[v];
+		if (target == InvalidIndex)
+			continue;
+
+		vertices[target] = mesh.Vertices[v];
+		if (!normals.empty())
+			normals[target] = mesh.Normals[v];
+		if (!texCoords.empty())
+			texCoords[target] = mesh.TexCoords[v];
+		if (!tangents.empty())
+			tangents[target] = mesh.Tangents[v];
+	}
+
+	mesh.Vertices = std::move(vertices);
+	mesh.Normals = std::move(normals);
+	mesh.TexCoords = std::move(texCoords);
+	mesh.Tangents = std::move(tangents);
+	mesh.Indices32 = std::move(indices);
+	for (MeshSubset& subset : mesh.Subsets)
+		subset.BaseVertexLocation = 0;
+
+	return vertexCount - next;
+}
+
+void MeshOptimizer::OptimizeMesh(MeshData& mesh, const MeshOptimizeOptions& options, MeshOptimizeStats* pStats)
+{
+	MeshOptimizeStats stats;
+	stats.Before = AnalyzeMesh(mesh, options.CacheSize);
+
+	// 各子集的三角形互不交叉，可并行优化
+	ParallelFor(mesh.Subsets.size(), 1, [&](std::size_t begin, std::size_t end)
+	{
+		std::vector<std::uint32_t> globalToLocal(mesh.Vertices.size(), InvalidIndex);
+		std::vector<Vertex> localVertices;
+		LocalSubset local;
+		for (std::size_t s = begin; s < end; ++s)
+		{
+			MeshSubset& subset = mesh.Subsets[s];
+			BuildLocalSubset(mesh, subset, globalToLocal, local);
+			if (local.Indices.empty())
+				continue;
+
+			OptimizeVertexCache(local.Indices.data(), local.Indices.size(), local.GlobalVertices.size(), options.CacheSize);
+			if (options.OverdrawThreshold > 0.0f)
+			{
+				localVertices.resize(local.GlobalVertices.size());
+				for (std::size_t v = 0; v < local.GlobalVertices.size(); ++v)
+					localVertices[v] = mesh.Vertices[local.GlobalVertices[v]];
+				OptimizeOverdraw(local.Indices.data(), local.Indices.size(), localVertices.data(), localVertices.size(),
+					options.CacheSize, options.OverdrawThreshold);
+			}
+
+			std::uint32_t* indices = mesh.Indices32.data() + subset.StartIndexLocation;
+			for (std::size_t i = 0; i < local.Indices.size(); ++i)
+				indices[i] = local.GlobalVertices[local.Indices[i]];
+			subset.BaseVertexLocation = 0;
+		}
+	}, options.ThreadCount);
+
+	if (options.OptimizeVertexFetch)
+		stats.RemovedVertexCount = OptimizeVertexFetch(mesh);
+
+	stats.After = AnalyzeMesh(mesh, options.CacheSize);
+	if (pStats)
+		*pStats = stats;
+}
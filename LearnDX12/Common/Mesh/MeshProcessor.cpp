@@ -0,0 +1,553 @@
+﻿#include "Mesh/MeshProcessor.h"
+#include "ParallelFor.h"
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace
+{
+	const std::uint32_t InvalidIndex = 0xFFFFFFFFu;
+	// 并行处理时每段的最小顶点/三角形/索引数量
+	const std::size_t VertexBatch = 4096;
+	const std::size_t TriangleBatch = 4096;
+	const std::size_t IndexBatch = 16384;
+
+	inline XMFLOAT3 Sub(const XMFLOAT3& a, const XMFLOAT3& b) { return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z); }
+	inline XMFLOAT3 Scale(const XMFLOAT3& a, float s) { return XMFLOAT3(a.x * s, a.y * s, a.z * s); }
+	inline float Dot(const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	inline XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+	}
+
+	// 将v投影到法线为n的平面上
+	inline XMFLOAT3 ProjectOnPlane(const XMFLOAT3& v, const XMFLOAT3& n)
+	{
+		const float d = Dot(v, n);
+		return XMFLOAT3(v.x - n.x * d, v.y - n.y * d, v.z - n.z * d);
+	}
+
+	// 归一化，长度为0时返回false且不修改v
+	inline bool Normalize(XMFLOAT3& v)
+	{
+		const float lengthSq = Dot(v, v);
+		if (!(lengthSq > 1e-30f))
+			return false;
+		v = Scale(v, 1.0f / std::sqrt(lengthSq));
+		return true;
+	}
+
+	inline bool Near(const float* a, const float* b, std::size_t count, float epsilon)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if (!(std::fabs(a[i] - b[i]) <= epsilon))
+				return false;
+		}
+		return true;
+	}
+
+	// 按子集顺序展开所有三角形的绝对顶点编号(包括BaseVertexLocation)
+	void GatherCorners(const MeshData& mesh, std::vector<std::uint32_t>& outCorners, unsigned threadCount)
+	{
+		std::size_t total = 0;
+		for (const MeshSubset& subset : mesh.Subsets)
+			total += subset.IndexCount / 3 * 3;
+		outCorners.resize(total);
+
+		std::size_t offset = 0;
+		for (const MeshSubset& subset : mesh.Subsets)
+		{
+			const std::uint32_t* src = mesh.Indices32.data() + subset.StartIndexLocation;
+			std::uint32_t* dst = outCorners.data() + offset;
+			ParallelFor(subset.IndexCount / 3 * 3, IndexBatch, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+					dst[i] = src[i] + subset.BaseVertexLocation;
+			}, threadCount);
+			offset += subset.IndexCount / 3 * 3;
+		}
+	}
+
+	// 建立 顶点(经过group映射) -> 三角形角 的邻接表，offsets[v]~offsets[v+1]为顶点v的三角形角编号
+	void BuildCornerAdjacency(const std::vector<std::uint32_t>& corners, const std::uint32_t* group, std::size_t vertexCount,
+		std::vector<std::uint32_t>& outOffsets, std::vector<std::uint32_t>& outCorners)
+	{
+		outOffsets.assign(vertexCount + 1, 0);
+		for (std::uint32_t v : corners)
+			++outOffsets[(group ? group[v] : v) + 1];
+		for (std::size_t v = 0; v < vertexCount; ++v)
+			outOffsets[v + 1] += outOffsets[v];
+
+		std::vector<std::uint32_t> cursor(outOffsets.begin(), outOffsets.end() - 1);
+		outCorners.resize(corners.size());
+		for (std::size_t c = 0; c < corners.size(); ++c)
+			outCorners[cursor[group ? group[corners[c]] : corners[c]]++] = (std::uint32_t)c;
+	}
+
+	/**
+	*	顶点位置的空间Hash网格
+	*	单元大小为误差的16倍，与一个位置相差不超过误差的点在每个轴上最多跨越2个单元，
+	*	大部分顶点只需检查1个单元(单元为2倍误差时总是需要检查8个单元)；误差为0时直接按坐标的位模式Hash。
+	*	各Hash桶中的顶点按编号升序存放，查找编号最小的匹配顶点时可以提前结束
+	*/
+	class PositionGrid
+	{
+	public:
+
+		PositionGrid(const MeshData& mesh, float epsilon, unsigned threadCount)
+			: Vertices(mesh.Vertices), Epsilon(epsilon), InvCellSize(epsilon > 0.0f ? 1.0 / (16.0 * epsilon) : 0.0)
+		{
+			const std::size_t vertexCount = Vertices.size();
+			std::size_t bucketCount = 16;
+			while (bucketCount < vertexCount)
+				bucketCount <<= 1;
+			Mask = (std::uint32_t)(bucketCount - 1);
+
+			std::vector<std::uint32_t> buckets(vertexCount);
+			ParallelFor(vertexCount, VertexBatch, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t v = begin; v < end; ++v)
+				{
+					const XMFLOAT3& p = Vertices[v].Pos;
+					buckets[v] = Epsilon > 0.0f ? HashCell(CellOf(p.x), CellOf(p.y), CellOf(p.z)) : HashExact(p);
+				}
+			}, threadCount);
+
+			Offsets.assign(bucketCount + 1, 0);
+			for (std::uint32_t b : buckets)
+				++Offsets[b + 1];
+			for (std::size_t b = 0; b < bucketCount; ++b)
+				Offsets[b + 1] += Offsets[b];
+
+			std::vector<std::uint32_t> cursor(Offsets.begin(), Offsets.end() - 1);
+			Entries.resize(vertexCount);
+			for (std::size_t v = 0; v < vertexCount; ++v)
+				Entries[cursor[buckets[v]]++] = (std::uint32_t)v;
+		}
+
+		// 查找编号小于v、与v位置相同且accept(j)为true的编号最小的顶点，不存在时返回InvalidIndex
+		template<typename Accept>
+		std::uint32_t FindFirst(std::uint32_t v, Accept&& accept) const
+		{
+			const XMFLOAT3& p = Vertices[v].Pos;
+			if (Epsilon <= 0.0f)
+				return ScanBucket(HashExact(p), v, p, accept);
+
+			const std::int64_t x0 = CellOf(p.x - Epsilon), x1 = CellOf(p.x + Epsilon);
+			const std::int64_t y0 = CellOf(p.y - Epsilon), y1 = CellOf(p.y + Epsilon);
+			const std::int64_t z0 = CellOf(p.z - Epsilon), z1 = CellOf(p.z + Epsilon);
+			std::uint32_t best = v;
+			for (std::int64_t x = x0; x <= x1; ++x)
+			{
+				for (std::int64_t y = y0; y <= y1; ++y)
+				{
+					for (std::int64_t z = z0; z <= z1; ++z)
+					{
+						const std::uint32_t j = ScanBucket(HashCell(x, y, z), best, p, accept);
+						if (j != InvalidIndex)
+							best = j;
+					}
+				}
+			}
+			return best == v ? InvalidIndex : best;
+		}
+
+	private:
+
+		std::int64_t CellOf(float value) const { return (std::int64_t)std::floor(value * InvCellSize); }
+
+		std::uint32_t HashCell(std::int64_t x, std::int64_t y, std::int64_t z) const
+		{
+			std::uint64_t h = (std::uint64_t)x * 0x9E3779B97F4A7C15ull;
+			h ^= (std::uint64_t)y * 0xC2B2AE3D27D4EB4Full + (h >> 29);
+			h ^= (std::uint64_t)z * 0x165667B19E3779F9ull + (h >> 32);
+			return (std::uint32_t)(h ^ (h >> 32)) & Mask;
+		}
+
+		std::uint32_t HashExact(const XMFLOAT3& p) const
+		{
+			// 加0使-0.0与0.0的位模式相同
+			const float values[3] = { p.x + 0.0f, p.y + 0.0f, p.z + 0.0f };
+			std::uint32_t bits[3];
+			std::memcpy(bits, values, sizeof(bits));
+			std::uint32_t h = 2166136261u;
+			for (std::uint32_t b : bits)
+				h = (h ^ b) * 16777619u;
+			return (h ^ (h >> 15)) & Mask;
+		}
+
+		template<typename Accept>
+		std::uint32_t ScanBucket(std::uint32_t bucket, std::uint32_t limit, const XMFLOAT3& p, Accept& accept) const
+		{
+			for (std::uint32_t e = Offsets[bucket]; e < Offsets[bucket + 1]; ++e)
+			{
+				const std::uint32_t j = Entries[e];
+				if (j >= limit)
+					break;
+				const XMFLOAT3& q = Vertices[j].Pos;
+				if (Near(&p.x, &q.x, 3, Epsilon) && accept(j))
+					return j;
+			}
+			return InvalidIndex;
+		}
+
+		const std::vector<Vertex>& Vertices;
+		float Epsilon;
+		double InvCellSize;
+		std::uint32_t Mask = 0;
+		std::vector<std::uint32_t> Offsets;
+		std::vector<std::uint32_t> Entries;
+	};
+
+	// 将remap[v] <= v的链(v->j->k)统一到编号最小的顶点，按升序处理时remap[remap[v]]已经确定
+	void ResolveRemapChains(std::vector<std::uint32_t>& remap)
+	{
+		for (std::size_t v = 0; v < remap.size(); ++v)
+			remap[v] = remap[remap[v]];
+	}
+
+	// 由切平面上的加权切线之和得到单位切线，和为0时任取一个与法线垂直的方向
+	XMFLOAT4 FinalizeTangent(const XMFLOAT3& sum, const XMFLOAT3& normal, float sign)
+	{
+		XMFLOAT3 t = ProjectOnPlane(sum, normal);
+		if (!Normalize(t))
+		{
+			const XMFLOAT3 axis = std::fabs(normal.x) < 0.9f ? XMFLOAT3(1.0f, 0.0f, 0.0f) : XMFLOAT3(0.0f, 1.0f, 0.0f);
+			t = Cross(axis, normal);
+			if (!Normalize(t))
+				t = XMFLOAT3(1.0f, 0.0f, 0.0f);
+		}
+		return XMFLOAT4(t.x, t.y, t.z, sign);
+	}
+}
+
+void MeshProcessor::BuildPositionRemap(const MeshData& mesh, float positionEpsilon, std::vector<std::uint32_t>& outRemap, unsigned threadCount)
+{
+	const std::size_t vertexCount = mesh.Vertices.size();
+	outRemap.resize(vertexCount);
+	PositionGrid grid(mesh, positionEpsilon, threadCount);
+	ParallelFor(vertexCount, VertexBatch, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t v = begin; v < end; ++v)
+		{
+			const std::uint32_t j = grid.FindFirst((std::uint32_t)v, [](std::uint32_t) { return true; });
+			outRemap[v] = j == InvalidIndex ? (std::uint32_t)v : j;
+		}
+	}, threadCount);
+	ResolveRemapChains(outRemap);
+}
+
+void MeshProcessor::WeldVertices(MeshData& mesh, const MeshWeldOptions& options, MeshWeldStats* pStats)
+{
+	MeshWeldStats stats;
+	const std::size_t vertexCount = mesh.Vertices.size();
+	const bool hasNormals = mesh.Normals.size() == vertexCount;
+	const bool hasTexCoords = mesh.TexCoords.size() == vertexCount;
+	const bool hasTangents = mesh.Tangents.size() == vertexCount;
+
+	// 除位置外的所有属性都在误差范围内才可以合并
+	auto sameAttributes = [&](std::uint32_t a, std::uint32_t b)
+	{
+		const float epsilon = options.AttributeEpsilon;
+		if (epsilon < 0.0f)
+			return true;
+		return Near(&mesh.Vertices[a].Color.x, &mesh.Vertices[b].Color.x, 4, epsilon)
+			&& (!hasNormals || Near(&mesh.Normals[a].x, &mesh.Normals[b].x, 3, epsilon))
+			&& (!hasTexCoords || Near(&mesh.TexCoords[a].x, &mesh.TexCoords[b].x, 2, epsilon))
+			&& (!hasTangents || Near(&mesh.Tangents[a].x, &mesh.Tangents[b].x, 4, epsilon));
+	};
+
+	std::vector<std::uint32_t> remap(vertexCount);
+	{
+		PositionGrid grid(mesh, options.PositionEpsilon, options.ThreadCount);
+		ParallelFor(vertexCount, VertexBatch, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t v = begin; v < end; ++v)
+			{
+				const std::uint32_t j = grid.FindFirst((std::uint32_t)v, [&](std::uint32_t candidate) { return sameAttributes((std::uint32_t)v, candidate); });
+				remap[v] = j == InvalidIndex ? (std::uint32_t)v : j;
+			}
+		}, options.ThreadCount);
+	}
+	ResolveRemapChains(remap);
+
+	// 保留的顶点按原顺序重新编号，被合并的顶点映射到保留顶点的新编号
+	std::vector<std::uint32_t> newIndex(vertexCount);
+	std::uint32_t keptCount = 0;
+	for (std::size_t v = 0; v < vertexCount; ++v)
+		newIndex[v] = remap[v] == v ? keptCount++ : newIndex[remap[v]];
+	stats.RemovedVertexCount = vertexCount - keptCount;
+
+	if (keptCount < vertexCount)
+	{
+		std::vector<Vertex> vertices(keptCount);
+		std::vector<XMFLOAT3> normals(hasNormals ? keptCount : 0);
+		std::vector<XMFLOAT2> texCoords(hasTexCoords ? keptCount : 0);
+		std::vector<XMFLOAT4> tangents(hasTangents ? keptCount : 0);
+		ParallelFor(vertexCount, VertexBatch, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t v = begin; v < end; ++v)
+			{
+				if (remap[v] != v)
+					continue;
+				const std::uint32_t target = newIndex[v];
+				vertices[target] = mesh.Vertices[v];
+				if (hasNormals)
+					normals[target] = mesh.Normals[v];
+				if (hasTexCoords)
+					texCoords[target] = mesh.TexCoords[v];
+				if (hasTangents)
+					tangents[target] = mesh.Tangents[v];
+			}
+		}, options.ThreadCount);
+		mesh.Vertices = std::move(vertices);
+		mesh.Normals = std::move(normals);
+		mesh.TexCoords = std::move(texCoords);
+		mesh.Tangents = std::move(tangents);
+	}
+
+	// 按子集顺序重建索引缓冲区，索引改为绝对顶点编号
+	std::vector<std::uint32_t> indices(mesh.Indices32.size());
+	std::size_t indexCount = 0;
+	for (MeshSubset& subset : mesh.Subsets)
+	{
+		const std::uint32_t* src = mesh.Indices32.data() + subset.StartIndexLocation;
+		std::uint32_t* dst = indices.data() + indexCount;
+		ParallelFor(subset.IndexCount, IndexBatch, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+				dst[i] = newIndex[src[i] + subset.BaseVertexLocation];
+		}, options.ThreadCount);
+
+		std::uint32_t keptIndexCount = subset.IndexCount;
+		if (options.RemoveDegenerateTriangles)
+		{
+			keptIndexCount = 0;
+			for (std::uint32_t t = 0; t + 3 <= subset.IndexCount; t += 3)
+			{
+				const std::uint32_t a = dst[t], b = dst[t + 1], c = dst[t + 2];
+				if (a == b || b == c || c == a)
+					continue;
+				dst[keptIndexCount] = a;
+				dst[keptIndexCount + 1] = b;
+				dst[keptIndexCount + 2] = c;
+				keptIndexCount += 3;
+			}
+			stats.RemovedTriangleCount += (subset.IndexCount - keptIndexCount) / 3;
+		}
+
+		subset.StartIndexLocation = (std::uint32_t)indexCount;
+		subset.IndexCount = keptIndexCount;
+		subset.BaseVertexLocation = 0;
+		indexCount += keptIndexCount;
+	}
+	indices.resize(indexCount);
+	mesh.Indices32 = std::move(indices);
+
+	if (pStats)
+		*pStats = stats;
+}
+
+void MeshProcessor::ComputeNormals(MeshData& mesh, const MeshNormalOptions& options)
+{
+	const std::size_t vertexCount = mesh.Vertices.size();
+	std::vector<std::uint32_t> corners;
+	GatherCorners(mesh, corners, options.ThreadCount);
+	const std::size_t triangleCount = corners.size() / 3;
+
+	// 三角形法线未归一化，长度为面积的2倍，求和即为按面积加权
+	std::vector<XMFLOAT3> faceNormals(triangleCount);
+	ParallelFor(triangleCount, TriangleBatch, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t t = begin; t < end; ++t)
+		{
+			const XMFLOAT3& p0 = mesh.Vertices[corners[t * 3]].Pos;
+			const XMFLOAT3& p1 = mesh.Vertices[corners[t * 3 + 1]].Pos;
+			const XMFLOAT3& p2 = mesh.Vertices[corners[t * 3 + 2]].Pos;
+			faceNormals[t] = Cross(Sub(p1, p0), Sub(p2, p0));
+		}
+	}, options.ThreadCount);
+
+	// 接缝两侧位置相同的顶点归为一组，法线按组计算
+	std::vector<std::uint32_t> group;
+	if (options.SmoothAcrossSeams)
+		BuildPositionRemap(mesh, options.PositionEpsilon, group, options.ThreadCount);
+
+	std::vector<std::uint32_t> offsets, adjacency;
+	BuildCornerAdjacency(corners, group.empty() ? nullptr : group.data(), vertexCount, offsets, adjacency);
+
+	std::vector<XMFLOAT3> normals(vertexCount);
+	ParallelFor(vertexCount, VertexBatch, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t v = begin; v < end; ++v)
+		{
+			if (!group.empty() && group[v] != v)
+				continue;
+
+			XMFLOAT3 sum(0.0f, 0.0f, 0.0f);
+			for (std::uint32_t a = offsets[v]; a < offsets[v + 1]; ++a)
+			{
+				const XMFLOAT3& n = faceNormals[adjacency[a] / 3];
+				sum.x += n.x;
+				sum.y += n.y;
+				sum.z += n.z;
+			}
+			if (!Normalize(sum))
+				sum = XMFLOAT3(0.0f, 0.0f, 1.0f);
+			normals[v] = sum;
+		}
+	}, options.ThreadCount);
+
+	if (!group.empty())
+	{
+		ParallelFor(vertexCount, VertexBatch, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t v = begin; v < end; ++v)
+				normals[v] = normals[group[v]];
+		}, options.ThreadCount);
+	}
+
+	mesh.Normals = std::move(normals);
+}
+
+bool MeshProcessor::ComputeTangents(MeshData& mesh, const MeshTangentOptions& options, MeshTangentStats* pStats)
+{
+	const std::size_t vertexCount = mesh.Vertices.size();
+	if (mesh.Normals.size() != vertexCount || mesh.TexCoords.size() != vertexCount)
+		return false;
+
+	MeshTangentStats stats;
+	std::vector<std::uint32_t> corners;
+	GatherCorners(mesh, corners, options.ThreadCount);
+	const std::size_t triangleCount = corners.size() / 3;
+
+	// 每个三角形角的切线(已投影到顶点切平面并乘以角度权重)及纹理映射方向(0表示退化的三角形)
+	std::vector<XMFLOAT3> cornerTangents(corners.size());
+	std::vector<std::int8_t> cornerSigns(corners.size());
+	ParallelFor(triangleCount, TriangleBatch, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t t = begin; t < end; ++t)
+		{
+			const std::uint32_t* tri = corners.data() + t * 3;
+			const XMFLOAT3 p[3] = { mesh.Vertices[tri[0]].Pos, mesh.Vertices[tri[1]].Pos, mesh.Vertices[tri[2]].Pos };
+			const XMFLOAT2& uv0 = mesh.TexCoords[tri[0]];
+			const XMFLOAT2& uv1 = mesh.TexCoords[tri[1]];
+			const XMFLOAT2& uv2 = mesh.TexCoords[tri[2]];
+
+			// 与MikkTSpace相同: vOs = t2 * d1 - t1 * d2，按纹理空间有向面积的符号翻转后归一化
+			const XMFLOAT3 d1 = Sub(p[1], p[0]);
+			const XMFLOAT3 d2 = Sub(p[2], p[0]);
+			const float s1 = uv1.x - uv0.x, t1 = uv1.y - uv0.y;
+			const float s2 = uv2.x - uv0.x, t2 = uv2.y - uv0.y;
+			const float signedAreaSTx2 = s1 * t2 - s2 * t1;
+			XMFLOAT3 os(t2 * d1.x - t1 * d2.x, t2 * d1.y - t1 * d2.y, t2 * d1.z - t1 * d2.z);
+			if (signedAreaSTx2 == 0.0f || !Normalize(os))
+			{
+				for (std::size_t k = 0; k < 3; ++k)
+				{
+					cornerTangents[t * 3 + k] = XMFLOAT3(0.0f, 0.0f, 0.0f);
+					cornerSigns[t * 3 + k] = 0;
+				}
+				continue;
+			}
+			const std::int8_t sign = signedAreaSTx2 > 0.0f ? 1 : -1;
+			if (sign < 0)
+				os = Scale(os, -1.0f);
+
+			for (std::size_t k = 0; k < 3; ++k)
+			{
+				const XMFLOAT3& n = mesh.Normals[tri[k]];
+				XMFLOAT3 tangent = ProjectOnPlane(os, n);
+				XMFLOAT3 e1 = ProjectOnPlane(Sub(p[(k + 1) % 3], p[k]), n);
+				XMFLOAT3 e2 = ProjectOnPlane(Sub(p[(k + 2) % 3], p[k]), n);
+				float angle = 0.0f;
+				if (Normalize(tangent) && Normalize(e1) && Normalize(e2))
+				{
+					const float cosAngle = Dot(e1, e2);
+					angle = std::acos(cosAngle < -1.0f ? -1.0f : (cosAngle > 1.0f ? 1.0f : cosAngle));
+				}
+				cornerTangents[t * 3 + k] = Scale(tangent, angle);
+				cornerSigns[t * 3 + k] = sign;
+			}
+		}
+	}, options.ThreadCount);
+
+	for (std::size_t t = 0; t < triangleCount; ++t)
+		stats.DegenerateTriangleCount += cornerSigns[t * 3] == 0 ? 1 : 0;
+
+	std::vector<std::uint32_t> offsets, adjacency;
+	BuildCornerAdjacency(corners, nullptr, vertexCount, offsets, adjacency);
+
+	// 两侧映射方向都存在的顶点，mirrored中为镜像一侧(w = -1)的切线
+	std::vector<XMFLOAT4> tangents(vertexCount);
+	std::vector<XMFLOAT4> mirrored(vertexCount);
+	std::vector<std::uint8_t> split(vertexCount, 0);
+	ParallelFor(vertexCount, VertexBatch, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t v = begin; v < end; ++v)
+		{
+			XMFLOAT3 sums[2] = { XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f) };
+			bool present[2] = { false, false };
+			for (std::uint32_t a = offsets[v]; a < offsets[v + 1]; ++a)
+			{
+				const std::uint32_t c = adjacency[a];
+				if (cornerSigns[c] == 0)
+					continue;
+				const int side = cornerSigns[c] > 0 ? 0 : 1;
+				sums[side].x += cornerTangents[c].x;
+				sums[side].y += cornerTangents[c].y;
+				sums[side].z += cornerTangents[c].z;
+				present[side] = true;
+			}
+
+			const XMFLOAT3& n = mesh.Normals[v];
+			if (present[0] && present[1])
+			{
+				split[v] = 1;
+				mirrored[v] = FinalizeTangent(sums[1], n, -1.0f);
+			}
+			tangents[v] = present[0] || !present[1] ? FinalizeTangent(sums[0], n, 1.0f) : FinalizeTangent(sums[1], n, -1.0f);
+		}
+	}, options.ThreadCount);
+
+	// 复制需要拆分的顶点，镜像一侧的三角形改为引用复制的顶点
+	std::vector<std::uint32_t> splitIndex(vertexCount, InvalidIndex);
+	for (std::size_t v = 0; v < vertexCount; ++v)
+	{
+		if (!split[v])
+			continue;
+		splitIndex[v] = (std::uint32_t)mesh.Vertices.size();
+		mesh.Vertices.push_back(mesh.Vertices[v]);
+		mesh.Normals.push_back(mesh.Normals[v]);
+		mesh.TexCoords.push_back(mesh.TexCoords[v]);
+		tangents.push_back(mirrored[v]);
+		++stats.SplitVertexCount;
+	}
+
+	if (stats.SplitVertexCount > 0)
+	{
+		std::size_t offset = 0;
+		for (const MeshSubset& subset : mesh.Subsets)
+		{
+			std::uint32_t* indices = mesh.Indices32.data() + subset.StartIndexLocation;
+			const std::size_t count = subset.IndexCount / 3 * 3;
+			ParallelFor(count, IndexBatch, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					const std::uint32_t v = corners[offset + i];
+					if (cornerSigns[offset + i] < 0 && splitIndex[v] != InvalidIndex)
+						indices[i] = splitIndex[v] - subset.BaseVertexLocation;
+				}
+			}, options.ThreadCount);
+			offset += count;
+		}
+	}
+
+	mesh.Tangents = std::move(tangents);
+	if (pStats)
+		*pStats = stats;
+	return true;
+}
@@ -0,0 +1,490 @@
+﻿#include "Mesh/MeshSimplifier.h"
+#include "Mesh/MeshOptimizer.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+	const std::uint32_t InvalidIndex = 0xFFFFFFFFu;
+	// 每个顶点最多参与比较的属性分量(颜色4 + 法线3 + 纹理坐标2)
+	const std::uint32_t MaxAttributeCount = 9;
+
+	inline XMFLOAT3 Sub(const XMFLOAT3& a, const XMFLOAT3& b) { return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z); }
+	inline float Dot(const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	inline XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+	}
+
+	// 对称4x4误差矩阵，Evaluate(p)为p到各平面距离平方的加权和
+	struct Quadric
+	{
+		double A00 = 0, A01 = 0, A02 = 0, A11 = 0, A12 = 0, A22 = 0;
+		double B0 = 0, B1 = 0, B2 = 0;
+		double C = 0;
+		double Weight = 0;
+
+		void AddPlane(double a, double b, double c, double d, double weight)
+		{
+			A00 += weight * a * a; A01 += weight * a * b; A02 += weight * a * c;
+			A11 += weight * b * b; A12 += weight * b * c; A22 += weight * c * c;
+			B0 += weight * a * d; B1 += weight * b * d; B2 += weight * c * d;
+			C += weight * d * d;
+			Weight += weight;
+		}
+
+		void Add(const Quadric& q)
+		{
+			A00 += q.A00; A01 += q.A01; A02 += q.A02; A11 += q.A11; A12 += q.A12; A22 += q.A22;
+			B0 += q.B0; B1 += q.B1; B2 += q.B2;
+			C += q.C;
+			Weight += q.Weight;
+		}
+
+		double Evaluate(const XMFLOAT3& p) const
+		{
+			const double x = p.x, y = p.y, z = p.z;
+			return A00 * x * x + 2.0 * A01 * x * y + 2.0 * A02 * x * z + A11 * y * y + 2.0 * A12 * y * z + A22 * z * z
+				+ 2.0 * (B0 * x + B1 * y + B2 * z) + C;
+		}
+	};
+
+	struct Collapse
+	{
+		float Cost;
+		// 几何误差的平方(按面积加权的平均距离平方)
+		float ErrorSq;
+		std::uint32_t From;
+		std::uint32_t To;
+	};
+
+	// 简化过程使用的局部顶点编号，临时内存只与被简化的三角形数量相关
+	struct LocalMesh
+	{
+		std::vector<std::uint32_t> Vertices;		// 局部顶点 -> 索引值
+		std::vector<XMFLOAT3> Positions;
+		std::vector<float> Attributes;				// 每个顶点AttributeCount个分量
+		std::uint32_t AttributeCount = 0;
+		std::vector<std::uint32_t> Indices;
+		std::vector<bool> Locked;
+	};
+
+	void BuildLocalMesh(const MeshData& mesh, std::int32_t baseVertexLocation, const std::uint32_t* indices, std::size_t indexCount, LocalMesh& out)
+	{
+		// 索引值 -> 局部顶点(排序后去重，避免按整个顶点数组分配临时表)
+		out.Vertices.assign(indices, indices + indexCount);
+		std::sort(out.Vertices.begin(), out.Vertices.end());
+		out.Vertices.erase(std::unique(out.Vertices.begin(), out.Vertices.end()), out.Vertices.end());
+
+		out.Indices.resize(indexCount);
+		for (std::size_t i = 0; i < indexCount; ++i)
+			out.Indices[i] = (std::uint32_t)(std::lower_bound(out.Vertices.begin(), out.Vertices.end(), indices[i]) - out.Vertices.begin());
+
+		const bool hasNormals = mesh.Normals.size() == mesh.Vertices.size();
+		const bool hasTexCoords = mesh.TexCoords.size() == mesh.Vertices.size();
+		out.AttributeCount = 4 + (hasNormals ? 3 : 0) + (hasTexCoords ? 2 : 0);
+
+		const std::size_t vertexCount = out.Vertices.size();
+		out.Positions.resize(vertexCount);
+		out.Attributes.resize(vertexCount * out.AttributeCount);
+		for (std::size_t v = 0; v < vertexCount; ++v)
+		{
+			const std::size_t source = (std::size_t)((std::int64_t)out.Vertices[v] + baseVertexLocation);
+			out.Positions[v] = mesh.Vertices[source].Pos;
+
+			float* attributes = out.Attributes.data() + v * out.AttributeCount;
+			const XMFLOAT4& color = mesh.Vertices[source].Color;
+			*attributes++ = color.x;
+			*attributes++ = color.y;
+			*attributes++ = color.z;
+			*attributes++ = color.w;
+			if (hasNormals)
+			{
+				*attributes++ = mesh.Normals[source].x;
+				*attributes++ = mesh.Normals[source].y;
+				*attributes++ = mesh.Normals[source].z;
+			}
+			if (hasTexCoords)
+			{
+				*attributes++ = mesh.TexCoords[source].x;
+				*attributes++ = mesh.TexCoords[source].y;
+			}
+		}
+	}
+
+	// 锁定属性接缝(位置相同的多个顶点)及开放边界上的顶点
+	void LockVertices(LocalMesh& local, bool lockBorder)
+	{
+		const std::size_t vertexCount = local.Positions.size();
+		local.Locked.assign(vertexCount, false);
+
+		// 按位置排序，相同位置的顶点相邻，同时为每个位置分配编号
+		std::vector<std::uint32_t> order(vertexCount);
+		for (std::size_t v = 0; v < vertexCount; ++v)
+			order[v] = (std::uint32_t)v;
+		auto positionLess = [&](std::uint32_t a, std::uint32_t b)
+		{
+			const XMFLOAT3& pa = local.Positions[a];
+			const XMFLOAT3& pb = local.Positions[b];
+			if (pa.x != pb.x) return pa.x < pb.x;
+			if (pa.y != pb.y) return pa.y < pb.y;
+			return pa.z < pb.z;
+		};
+		std::sort(order.begin(), order.end(), positionLess);
+
+		std::vector<std::uint32_t> positionId(vertexCount);
+		std::uint32_t nextId = 0;
+		for (std::size_t i = 0; i < vertexCount; ++i)
+		{
+			if (i > 0 && positionLess(order[i - 1], order[i]))
+				++nextId;
+			positionId[order[i]] = nextId;
+			if (i > 0 && !positionLess(order[i - 1], order[i]))
+			{
+				local.Locked[order[i - 1]] = true;
+				local.Locked[order[i]] = true;
+			}
+		}
+
+		if (!lockBorder)
+			return;
+
+		// 只被一个三角形使用的边(按位置比较)为开放边界
+		struct Edge
+		{
+			std::uint64_t Key;
+			std::uint32_t A, B;
+			bool operator<(const Edge& rhs) const { return Key < rhs.Key; }
+		};
+		std::vector<Edge> edges;
+		edges.reserve(local.Indices.size());
+		for (std::size_t t = 0; t + 3 <= local.Indices.size(); t += 3)
+		{
+			for (std::size_t k = 0; k < 3; ++k)
+			{
+				const std::uint32_t a = local.Indices[t + k];
+				const std::uint32_t b = local.Indices[t + (k + 1) % 3];
+				const std::uint64_t pa = positionId[a], pb = positionId[b];
+				edges.push_back(Edge{ pa < pb ? (pa << 32 | pb) : (pb << 32 | pa), a, b });
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		for (std::size_t i = 0; i < edges.size();)
+		{
+			std::size_t j = i + 1;
+			while (j < edges.size() && edges[j].Key == edges[i].Key)
+				++j;
+			if (j - i == 1)
+			{
+				local.Locked[edges[i].A] = true;
+				local.Locked[edges[i].B] = true;
+			}
+			i = j;
+		}
+	}
+
+	float AttributeDistanceSq(const LocalMesh& local, std::uint32_t a, std::uint32_t b)
+	{
+		const float* pa = local.Attributes.data() + (std::size_t)a * local.AttributeCount;
+		const float* pb = local.Attributes.data() + (std::size_t)b * local.AttributeCount;
+		float distance = 0.0f;
+		for (std::uint32_t i = 0; i < local.AttributeCount; ++i)
+			distance += (pa[i] - pb[i]) * (pa[i] - pb[i]);
+		return distance;
+	}
+
+	// 将from折叠到to后，from周围(不包含to)的三角形朝向是否保持不变
+	bool PreservesOrientation(const LocalMesh& local, const std::vector<std::uint32_t>& adjacencyOffsets, const std::vector<std::uint32_t>& adjacency,
+		std::uint32_t from, std::uint32_t to)
+	{
+		for (std::uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; ++a)
+		{
+			const std::uint32_t* triangle = local.Indices.data() + (std::size_t)adjacency[a] * 3;
+			if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+				continue;
+
+			// 以from为第一个顶点旋转三角形，保持绕序
+			std::uint32_t k = triangle[0] == from ? 0 : (triangle[1] == from ? 1 : 2);
+			const XMFLOAT3& p1 = local.Positions[triangle[(k + 1) % 3]];
+			const XMFLOAT3& p2 = local.Positions[triangle[(k + 2) % 3]];
+			const XMFLOAT3 before = Cross(Sub(p1, local.Positions[from]), Sub(p2, local.Positions[from]));
+			const XMFLOAT3 after = Cross(Sub(p1, local.Positions[to]), Sub(p2, local.Positions[to]));
+			if (Dot(before, after) <= 0.0f)
+				return false;
+		}
+		return true;
+	}
+}
+
+float MeshSimplifier::Simplify(const MeshData& mesh, std::int32_t baseVertexLocation, const std::uint32_t* indices, std::size_t indexCount,
+	std::size_t targetIndexCount, std::vector<std::uint32_t>& outIndices, const MeshSimplifyOptions& options)
+{
+	indexCount -= indexCount % 3;
+	outIndices.assign(indices, indices + indexCount);
+	if (indexCount <= targetIndexCount)
+		return 0.0f;
+
+	LocalMesh local;
+	BuildLocalMesh(mesh, baseVertexLocation, indices, indexCount, local);
+	LockVertices(local, options.LockBorder);
+
+	// 各顶点的误差矩阵为相邻三角形所在平面的面积加权和
+	const std::size_t vertexCount = local.Positions.size();
+	std::vector<Quadric> quadrics(vertexCount);
+	for (std::size_t t = 0; t < indexCount; t += 3)
+	{
+		const std::uint32_t i0 = local.Indices[t], i1 = local.Indices[t + 1], i2 = local.Indices[t + 2];
+		const XMFLOAT3 n = Cross(Sub(local.Positions[i1], local.Positions[i0]), Sub(local.Positions[i2], local.Positions[i0]));
+		const double length = std::sqrt((double)Dot(n, n));
+		if (length <= 0.0)
+			continue;
+
+		const double a = n.x / length, b = n.y / length, c = n.z / length;
+		const double d = -(a * local.Positions[i0].x + b * local.Positions[i0].y + c * local.Positions[i0].z);
+		const double area = length * 0.5;
+		quadrics[i0].AddPlane(a, b, c, d, area);
+		quadrics[i1].AddPlane(a, b, c, d, area);
+		quadrics[i2].AddPlane(a, b, c, d, area);
+	}
+
+	const double maxErrorSq = (double)options.MaxError * options.MaxError;
+	float resultErrorSq = 0.0f;
+
+	std::vector<std::uint32_t> adjacencyOffsets;
+	std::vector<std::uint32_t> adjacency;
+	std::vector<Collapse> collapses;
+	std::vector<std::uint32_t> remap(vertexCount);
+	std::vector<bool> touched(vertexCount);
+
+	// 每一轮按代价从小到大执行互不相邻的折叠，然后重建索引，直到达到目标或无法继续折叠
+	while (local.Indices.size() > targetIndexCount)
+	{
+		const std::size_t triangleCount = local.Indices.size() / 3;
+
+		adjacencyOffsets.assign(vertexCount + 1, 0);
+		for (std::uint32_t v : local.Indices)
+			++adjacencyOffsets[v + 1];
+		for (std::size_t v = 0; v < vertexCount; ++v)
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		adjacency.resize(local.Indices.size());
+		{
+			std::vector<std::uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (std::size_t i = 0; i < local.Indices.size(); ++i)
+				adjacency[cursor[local.Indices[i]]++] = (std::uint32_t)(i / 3);
+		}
+
+		// 每条边取两个折叠方向中代价较小的一个
+		// 锁定边界时可折叠的边都是内部边，在相邻的两个三角形中各出现一次，只取a < b的一次
+		collapses.clear();
+		for (std::size_t t = 0; t < triangleCount; ++t)
+		{
+			for (std::size_t k = 0; k < 3; ++k)
+			{
+				const std::uint32_t a = local.Indices[t * 3 + k];
+				const std::uint32_t b = local.Indices[t * 3 + (k + 1) % 3];
+				if ((local.Locked[a] && local.Locked[b]) || (options.LockBorder && a > b))
+					continue;
+				const XMFLOAT3 edge = Sub(local.Positions[a], local.Positions[b]);
+				const float attributeCost = options.AttributeWeight * AttributeDistanceSq(local, a, b) * Dot(edge, edge);
+
+				Quadric q = quadrics[a];
+				q.Add(quadrics[b]);
+				const double weight = q.Weight > 0.0 ? q.Weight : 1.0;
+
+				Collapse best = { 0.0f, 0.0f, InvalidIndex, InvalidIndex };
+				if (!local.Locked[a])
+				{
+					const float errorSq = (float)std::max(0.0, q.Evaluate(local.Positions[b]) / weight);
+					best = Collapse{ errorSq + attributeCost, errorSq, a, b };
+				}
+				if (!local.Locked[b])
+				{
+					const float errorSq = (float)std::max(0.0, q.Evaluate(local.Positions[a]) / weight);
+					if (best.From == InvalidIndex || errorSq + attributeCost < best.Cost)
+						best = Collapse{ errorSq + attributeCost, errorSq, b, a };
+				}
+				if (best.From != InvalidIndex && best.ErrorSq <= maxErrorSq)
+					collapses.push_back(best);
+			}
+		}
+		if (collapses.empty())
+			break;
+
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs)
+		{
+			return lhs.Cost < rhs.Cost || (lhs.Cost == rhs.Cost && (lhs.From < rhs.From || (lhs.From == rhs.From && lhs.To < rhs.To)));
+		});
+
+		for (std::size_t v = 0; v < vertexCount; ++v)
+			remap[v] = (std::uint32_t)v;
+		std::fill(touched.begin(), touched.end(), false);
+
+		// 折叠后from的一环邻域在本轮中不再参与折叠，保证朝向检查使用的顶点位置都是最终位置
+		const std::size_t trianglesToRemove = (local.Indices.size() - targetIndexCount + 2) / 3;
+		std::size_t removed = 0;
+		std::size_t collapseCount = 0;
+		for (const Collapse& collapse : collapses)
+		{
+			if (removed >= trianglesToRemove)
+				break;
+			if (touched[collapse.From] || touched[collapse.To])
+				continue;
+			if (!PreservesOrientation(local, adjacencyOffsets, adjacency, collapse.From, collapse.To))
+				continue;
+
+			for (std::uint32_t a = adjacencyOffsets[collapse.From]; a < adjacencyOffsets[collapse.From + 1]; ++a)
+			{
+				const std::uint32_t* triangle = local.Indices.data() + (std::size_t)adjacency[a] * 3;
+				if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+					++removed;
+				touched[triangle[0]] = true;
+				touched[triangle[1]] = true;
+				touched[triangle[2]] = true;
+			}
+
+			remap[collapse.From] = collapse.To;
+			quadrics[collapse.To].Add(quadrics[collapse.From]);
+			resultErrorSq = std::max(resultErrorSq, collapse.ErrorSq);
+			++collapseCount;
+		}
+		if (collapseCount == 0)
+			break;
+
+		// 应用折叠并移除退化的三角形
+		std::size_t write = 0;
+		for (std::size_t t = 0; t < triangleCount; ++t)
+		{
+			const std::uint32_t i0 = remap[local.Indices[t * 3]];
+			const std::uint32_t i1 = remap[local.Indices[t * 3 + 1]];
+			const std::uint32_t i2 = remap[local.Indices[t * 3 + 2]];
+			if (i0 == i1 || i1 == i2 || i0 == i2)
+				continue;
+			local.Indices[write++] = i0;
+			local.Indices[write++] = i1;
+			local.Indices[write++] = i2;
+		}
+		local.Indices.resize(write);
+	}
+
+	outIndices.resize(local.Indices.size());
+	for (std::size_t i = 0; i < local.Indices.size(); ++i)
+		outIndices[i] = local.Vertices[local.Indices[i]];
+	return std::sqrt(resultErrorSq);
+}
+
+void MeshSimplifier::GenerateLods(MeshData& mesh, const MeshLodOptions& options, MeshLodStats* pStats)
+{
+	// 每个LOD0子集的各级LOD结果
+	struct SubsetLods
+	{
+		std::vector<std::vector<std::uint32_t>> Indices;
+		std::vector<float> Errors;
+	};
+
+	std::vector<std::size_t> baseSubsets;
+	for (std::size_t s = 0; s < mesh.Subsets.size(); ++s)
+	{
+		if (mesh.Subsets[s].LodLevel == 0)
+			baseSubsets.push_back(s);
+	}
+
+	const std::size_t levelCount = options.Ratios.size();
+	std::vector<SubsetLods> results(baseSubsets.size());
+
+	// 各子集独立简化，每一级从上一级的结果继续简化，误差按级累加
+	ParallelFor(baseSubsets.size(), 1, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			const MeshSubset& subset = mesh.Subsets[baseSubsets[i]];
+			const std::uint32_t* indices = mesh.Indices32.data() + subset.StartIndexLocation;
+			const std::size_t indexCount = subset.IndexCount - subset.IndexCount % 3;
+
+			SubsetLods& lods = results[i];
+			std::vector<std::uint32_t> previous(indices, indices + indexCount);
+			float previousError = 0.0f;
+			bool converged = false;
+			for (std::size_t level = 0; level < levelCount; ++level)
+			{
+				std::vector<std::uint32_t> simplified;
+				float error = previousError;
+				const std::size_t target = (std::size_t)(indexCount / 3 * options.Ratios[level]) * 3;
+				if (!converged && target < previous.size())
+				{
+					error += MeshSimplifier::Simplify(mesh, subset.BaseVertexLocation, previous.data(), previous.size(), target, simplified, options.Simplify);
+					converged = simplified.size() > previous.size() * (1.0f - options.MinReduction);
+				}
+				else
+				{
+					simplified = previous;
+				}
+
+				if (!simplified.empty())
+				{
+					const std::uint32_t maxIndex = *std::max_element(simplified.begin(), simplified.end());
+					MeshOptimizer::OptimizeVertexCache(simplified.data(), simplified.size(), (std::size_t)maxIndex + 1, options.CacheSize);
+				}
+
+				lods.Indices.push_back(simplified);
+				lods.Errors.push_back(error);
+				previous = std::move(simplified);
+				previousError = error;
+			}
+		}
+	}, options.ThreadCount);
+
+	MeshLodStats stats;
+	stats.TriangleCounts.assign(levelCount + 1, 0);
+	stats.Errors.assign(levelCount + 1, 0.0f);
+	for (std::size_t s : baseSubsets)
+		stats.TriangleCounts[0] += mesh.Subsets[s].IndexCount / 3;
+
+	// 所有子集都无法继续简化的级别不再生成
+	std::size_t usefulLevels = 0;
+	for (std::size_t level = 0; level < levelCount; ++level)
+	{
+		std::size_t triangles = 0;
+		std::size_t previousTriangles = 0;
+		for (const SubsetLods& lods : results)
+		{
+			triangles += lods.Indices[level].size() / 3;
+			previousTriangles += level == 0 ? 0 : lods.Indices[level - 1].size() / 3;
+		}
+		if (level == 0)
+			previousTriangles = stats.TriangleCounts[0];
+		if (triangles >= previousTriangles)
+			break;
+		usefulLevels = level + 1;
+	}
+
+	for (std::size_t level = 0; level < usefulLevels; ++level)
+	{
+		for (std::size_t i = 0; i < baseSubsets.size(); ++i)
+		{
+			const MeshSubset base = mesh.Subsets[baseSubsets[i]];
+			const std::vector<std::uint32_t>& indices = results[i].Indices[level];
+
+			MeshSubset subset;
+			subset.Name = base.Name;
+			subset.StartIndexLocation = (std::uint32_t)mesh.Indices32.size();
+			subset.IndexCount = (std::uint32_t)indices.size();
+			subset.BaseVertexLocation = base.BaseVertexLocation;
+			subset.Bounds = base.Bounds;
+			subset.LodLevel = (std::uint32_t)level + 1;
+			subset.LodError = results[i].Errors[level];
+			mesh.Indices32.insert(mesh.Indices32.end(), indices.begin(), indices.end());
+			mesh.Subsets.push_back(subset);
+
+			stats.TriangleCounts[level + 1] += indices.size() / 3;
+			stats.Errors[level + 1] = std::max(stats.Errors[level + 1], subset.LodError);
+		}
+	}
+
+	stats.TriangleCounts.resize(usefulLevels + 1);
+	stats.Errors.resize(usefulLevels + 1);
+	if (pStats)
+		*pStats = stats;
+}
@@ -0,0 +1,468 @@
+﻿#include "Mesh/Meshlet.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+	const std::uint32_t InvalidIndex = 0xFFFFFFFFu;
+	const std::uint8_t InvalidSlot = 0xFF;
+
+	inline XMFLOAT3 Sub(const XMFLOAT3& a, const XMFLOAT3& b) { return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z); }
+	inline float Dot(const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	inline float Length(const XMFLOAT3& a) { return std::sqrt(Dot(a, a)); }
+	inline XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+	}
+
+	// 一个子集的Meshlet划分结果，各子集并行构建后依次拼接
+	struct SubsetMeshlets
+	{
+		std::vector<Meshlet> Meshlets;
+		std::vector<std::uint32_t> Vertices;
+		std::vector<std::uint8_t> Triangles;
+		// 按Meshlet顺序重排后的索引
+		std::vector<std::uint32_t> Indices;
+	};
+
+	/**
+	*	贪心划分: 从第一个未使用的三角形开始，每次从与当前Meshlet顶点相邻的三角形中选择新增顶点最少的一个(相同时取先出现的)，
+	*	没有相邻三角形时按原顺序取下一个未使用的三角形，顶点或三角形数量达到上限时开始新的Meshlet。
+	*	输入的三角形顺序经过顶点缓存优化，按原顺序取三角形同样具有空间局部性。
+	*/
+	void BuildSubsetMeshlets(const MeshData& mesh, const MeshSubset& subset, const MeshletBuildOptions& options,
+		std::vector<std::uint32_t>& globalToLocal, SubsetMeshlets& out)
+	{
+		const std::uint32_t triangleCount = subset.IndexCount / 3;
+		const std::uint32_t* indices = mesh.Indices32.data() + subset.StartIndexLocation;
+
+		// 局部顶点编号，临时内存只与子集大小相关
+		std::vector<std::uint32_t> localVertices;
+		std::vector<std::uint32_t> localIndices(triangleCount * 3);
+		for (std::uint32_t i = 0; i < triangleCount * 3; ++i)
+		{
+			const std::uint32_t v = indices[i];
+			if (globalToLocal[v] == InvalidIndex)
+			{
+				globalToLocal[v] = (std::uint32_t)localVertices.size();
+				localVertices.push_back(v);
+			}
+			localIndices[i] = globalToLocal[v];
+		}
+		for (std::uint32_t v : localVertices)
+			globalToLocal[v] = InvalidIndex;
+
+		// 顶点 -> 相邻三角形
+		const std::size_t vertexCount = localVertices.size();
+		std::vector<std::uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (std::uint32_t v : localIndices)
+			++adjacencyOffsets[v + 1];
+		for (std::size_t v = 0; v < vertexCount; ++v)
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		std::vector<std::uint32_t> adjacency(localIndices.size());
+		{
+			std::vector<std::uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (std::uint32_t t = 0; t < triangleCount; ++t)
+			{
+				for (std::uint32_t k = 0; k < 3; ++k)
+					adjacency[cursor[localIndices[t * 3 + k]]++] = t;
+			}
+		}
+
+		std::vector<bool> emitted(triangleCount, false);
+		// 各顶点尚未划分的相邻三角形数量，为0的顶点在选择候选三角形时跳过
+		std::vector<std::uint32_t> liveTriangles(vertexCount);
+		for (std::size_t v = 0; v < vertexCount; ++v)
+			liveTriangles[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+		std::vector<std::uint8_t> slots(vertexCount, InvalidSlot);
+		std::vector<std::uint32_t> meshletVertices;
+		std::vector<std::uint32_t> meshletTriangles;
+		std::uint32_t nextSeed = 0;
+
+		auto newVertexCount = [&](std::uint32_t t)
+		{
+			std::uint32_t count = 0;
+			for (std::uint32_t k = 0; k < 3; ++k)
+				count += slots[localIndices[t * 3 + k]] == InvalidSlot ? 1 : 0;
+			return count;
+		};
+
+		auto flush = [&]()
+		{
+			if (meshletTriangles.empty())
+				return;
+
+			Meshlet meshlet;
+			meshlet.StartIndexLocation = subset.StartIndexLocation + (std::uint32_t)out.Indices.size();
+			meshlet.IndexCount = (std::uint32_t)meshletTriangles.size() * 3;
+			meshlet.BaseVertexLocation = subset.BaseVertexLocation;
+			meshlet.VertexOffset = (std::uint32_t)out.Vertices.size();
+			meshlet.VertexCount = (std::uint32_t)meshletVertices.size();
+			meshlet.TriangleOffset = (std::uint32_t)out.Triangles.size() / 3;
+			meshlet.TriangleCount = (std::uint32_t)meshletTriangles.size();
+
+			for (std::uint32_t t : meshletTriangles)
+			{
+				for (std::uint32_t k = 0; k < 3; ++k)
+				{
+					const std::uint32_t v = localIndices[t * 3 + k];
+					out.Indices.push_back(localVertices[v]);
+					out.Triangles.push_back(slots[v]);
+				}
+			}
+			for (std::uint32_t v : meshletVertices)
+			{
+				out.Vertices.push_back(localVertices[v]);
+				slots[v] = InvalidSlot;
+			}
+
+			out.Meshlets.push_back(meshlet);
+			meshletVertices.clear();
+			meshletTriangles.clear();
+		};
+
+		auto append = [&](std::uint32_t t)
+		{
+			emitted[t] = true;
+			for (std::uint32_t k = 0; k < 3; ++k)
+			{
+				const std::uint32_t v = localIndices[t * 3 + k];
+				--liveTriangles[v];
+				if (slots[v] == InvalidSlot)
+				{
+					slots[v] = (std::uint8_t)meshletVertices.size();
+					meshletVertices.push_back(v);
+				}
+			}
+			meshletTriangles.push_back(t);
+		};
+
+		for (std::uint32_t added = 0; added < triangleCount; ++added)
+		{
+			// 在当前Meshlet顶点的相邻三角形中选择新增顶点最少的
+			std::uint32_t best = InvalidIndex;
+			std::uint32_t bestNew = 4;
+			for (std::uint32_t v : meshletVertices)
+			{
+				if (liveTriangles[v] == 0)
+					continue;
+				for (std::uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1] && bestNew > 0; ++a)
+				{
+					const std::uint32_t t = adjacency[a];
+					if (emitted[t])
+						continue;
+					const std::uint32_t count = newVertexCount(t);
+					if (count < bestNew || (count == bestNew && t < best))
+					{
+						best = t;
+						bestNew = count;
+					}
+				}
+				if (bestNew == 0)
+					break;
+			}
+
+			// 没有相邻的三角形时取原顺序中下一个未使用的三角形
+			if (best == InvalidIndex)
+			{
+				while (emitted[nextSeed])
+					++nextSeed;
+				best = nextSeed;
+				bestNew = newVertexCount(best);
+			}
+
+			if (meshletVertices.size() + bestNew > options.MaxVertices || meshletTriangles.size() >= options.MaxTriangles)
+			{
+				flush();
+				// 新的Meshlet从原顺序中下一个未使用的三角形开始，保持与输入顺序相近
+				while (emitted[nextSeed])
+					++nextSeed;
+				best = nextSeed;
+			}
+
+			append(best);
+		}
+		flush();
+
+		// 不足一个三角形的剩余索引保持在子集末尾
+		for (std::uint32_t i = triangleCount * 3; i < subset.IndexCount; ++i)
+			out.Indices.push_back(indices[i]);
+	}
+
+	// Ritter包围球
+	BoundingSphere ComputeBoundingSphere(const XMFLOAT3* points, std::size_t count)
+	{
+		BoundingSphere sphere;
+		sphere.Center = XMFLOAT3(0.0f, 0.0f, 0.0f);
+		sphere.Radius = 0.0f;
+		if (count == 0)
+			return sphere;
+
+		// 以各坐标轴上距离最远的一对极值点作为初始直径
+		std::size_t minPoint[3] = { 0, 0, 0 };
+		std::size_t maxPoint[3] = { 0, 0, 0 };
+		for (std::size_t i = 1; i < count; ++i)
+		{
+			const float p[3] = { points[i].x, points[i].y, points[i].z };
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				const float* pMin = &points[minPoint[axis]].x;
+				const float* pMax = &points[maxPoint[axis]].x;
+				if (p[axis] < pMin[axis])
+					minPoint[axis] = i;
+				if (p[axis] > pMax[axis])
+					maxPoint[axis] = i;
+			}
+		}
+
+		int bestAxis = 0;
+		float bestDistance = -1.0f;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const XMFLOAT3 d = Sub(points[maxPoint[axis]], points[minPoint[axis]]);
+			if (Dot(d, d) > bestDistance)
+			{
+				bestDistance = Dot(d, d);
+				bestAxis = axis;
+			}
+		}
+
+		const XMFLOAT3& p0 = points[minPoint[bestAxis]];
+		const XMFLOAT3& p1 = points[maxPoint[bestAxis]];
+		XMFLOAT3 center((p0.x + p1.x) * 0.5f, (p0.y + p1.y) * 0.5f, (p0.z + p1.z) * 0.5f);
+		float radius = std::sqrt(bestDistance) * 0.5f;
+
+		// 扩大球体直到包含所有点
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const XMFLOAT3 d = Sub(points[i], center);
+			const float distance = Length(d);
+			if (distance > radius)
+			{
+				const float newRadius = (radius + distance) * 0.5f;
+				const float k = (newRadius - radius) / distance;
+				center = XMFLOAT3(center.x + d.x * k, center.y + d.y * k, center.z + d.z * k);
+				radius = newRadius;
+			}
+		}
+
+		sphere.Center = center;
+		sphere.Radius = radius;
+		return sphere;
+	}
+}
+
+void MeshletBuilder::BuildMeshlets(MeshData& mesh, MeshletData& outMeshlets, const MeshletBuildOptions& options)
+{
+	outMeshlets = MeshletData();
+
+	// 每个Meshlet的顶点需能用8位局部下标表示
+	MeshletBuildOptions buildOptions = options;
+	buildOptions.MaxVertices = std::max<std::uint32_t>(3, std::min<std::uint32_t>(buildOptions.MaxVertices, 255));
+	buildOptions.MaxTriangles = std::max<std::uint32_t>(1, buildOptions.MaxTriangles);
+
+	// 各子集的索引范围互不重叠，可并行划分
+	std::vector<SubsetMeshlets> results(mesh.Subsets.size());
+	ParallelFor(mesh.Subsets.size(), 1, [&](std::size_t begin, std::size_t end)
+	{
+		std::vector<std::uint32_t> globalToLocal;
+		for (std::size_t s = begin; s < end; ++s)
+		{
+			// 只为LOD0划分Meshlet，更低的LOD按子集整体绘制
+			const MeshSubset& subset = mesh.Subsets[s];
+			if (subset.IndexCount < 3 || subset.LodLevel != 0)
+				continue;
+
+			// 索引值不包括BaseVertexLocation，临时表按子集中最大的索引值分配
+			const std::uint32_t* indices = mesh.Indices32.data() + subset.StartIndexLocation;
+			const std::uint32_t maxIndex = *std::max_element(indices, indices + subset.IndexCount);
+			if (globalToLocal.size() <= maxIndex)
+				globalToLocal.resize((std::size_t)maxIndex + 1, InvalidIndex);
+
+			BuildSubsetMeshlets(mesh, subset, buildOptions, globalToLocal, results[s]);
+			std::copy(results[s].Indices.begin(), results[s].Indices.end(), mesh.Indices32.begin() + subset.StartIndexLocation);
+			results[s].Indices = std::vector<std::uint32_t>();
+		}
+	}, options.ThreadCount);
+
+	for (const SubsetMeshlets& result : results)
+	{
+		const std::uint32_t vertexOffset = (std::uint32_t)outMeshlets.Vertices.size();
+		const std::uint32_t triangleOffset = (std::uint32_t)outMeshlets.Triangles.size() / 3;
+		for (Meshlet meshlet : result.Meshlets)
+		{
+			meshlet.VertexOffset += vertexOffset;
+			meshlet.TriangleOffset += triangleOffset;
+			outMeshlets.Meshlets.push_back(meshlet);
+		}
+		outMeshlets.Vertices.insert(outMeshlets.Vertices.end(), result.Vertices.begin(), result.Vertices.end());
+		outMeshlets.Triangles.insert(outMeshlets.Triangles.end(), result.Triangles.begin(), result.Triangles.end());
+	}
+
+	outMeshlets.Bounds.resize(outMeshlets.Meshlets.size());
+	ParallelFor(outMeshlets.Meshlets.size(), 256, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t i = begin; i < end; ++i)
+			outMeshlets.Bounds[i] = ComputeBounds(mesh, outMeshlets, outMeshlets.Meshlets[i]);
+	}, options.ThreadCount);
+}
+
+MeshletBounds MeshletBuilder::ComputeBounds(const MeshData& mesh, const MeshletData& meshlets, const Meshlet& meshlet)
+{
+	MeshletBounds bounds;
+
+	// BuildMeshlets保证每个Meshlet不超过255个顶点
+	XMFLOAT3 points[256];
+	const std::uint32_t pointCount = std::min<std::uint32_t>(meshlet.VertexCount, 256);
+	for (std::uint32_t i = 0; i < pointCount; ++i)
+		points[i] = mesh.Vertices[meshlets.Vertices[meshlet.VertexOffset + i] + meshlet.BaseVertexLocation].Pos;
+
+	const BoundingSphere sphere = ComputeBoundingSphere(points, pointCount);
+	bounds.Center = sphere.Center;
+	bounds.Radius = sphere.Radius;
+
+	// 法线锥轴为各三角形单位法线的平均方向(顺时针为正面，法线为cross(p1 - p0, p2 - p0))
+	const std::uint8_t* triangles = meshlets.Triangles.data() + meshlet.TriangleOffset * 3;
+	auto triangleNormal = [&](std::uint32_t t, XMFLOAT3& outNormal)
+	{
+		const XMFLOAT3& p0 = points[triangles[t * 3 + 0]];
+		const XMFLOAT3& p1 = points[triangles[t * 3 + 1]];
+		const XMFLOAT3& p2 = points[triangles[t * 3 + 2]];
+		const XMFLOAT3 n = Cross(Sub(p1, p0), Sub(p2, p0));
+		const float length = Length(n);
+		if (length <= 0.0f)
+			return false;
+		outNormal = XMFLOAT3(n.x / length, n.y / length, n.z / length);
+		return true;
+	};
+
+	XMFLOAT3 axis(0.0f, 0.0f, 0.0f);
+	XMFLOAT3 normal;
+	for (std::uint32_t t = 0; t < meshlet.TriangleCount; ++t)
+	{
+		if (triangleNormal(t, normal))
+			axis = XMFLOAT3(axis.x + normal.x, axis.y + normal.y, axis.z + normal.z);
+	}
+
+	const float axisLength = Length(axis);
+	if (axisLength <= 0.0f)
+		return bounds;
+	axis = XMFLOAT3(axis.x / axisLength, axis.y / axisLength, axis.z / axisLength);
+
+	// 退化三角形没有确定的朝向，不参与锥角计算
+	float minDot = 1.0f;
+	for (std::uint32_t t = 0; t < meshlet.TriangleCount; ++t)
+	{
+		if (triangleNormal(t, normal))
+			minDot = std::min(minDot, Dot(normal, axis));
+	}
+
+	// 法线锥张角接近或超过90度时剔除几乎不会成功，不再进行锥体测试
+	bounds.ConeAxis = axis;
+	bounds.ConeCutoff = minDot <= 0.1f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+	return bounds;
+}
+
+MeshletCullView MeshletCuller::MakeCullView(const XMFLOAT4X4& worldViewProj, const XMFLOAT3& cameraPosition)
+{
+	// 行向量约定下clip = p * M，平面由M的列组合得到(Gribb/Hartmann)
+	const XMFLOAT4X4& m = worldViewProj;
+	auto column = [&](int c) { return XMFLOAT4(m.m[0][c], m.m[1][c], m.m[2][c], m.m[3][c]); };
+	const XMFLOAT4 c0 = column(0), c1 = column(1), c2 = column(2), c3 = column(3);
+
+	MeshletCullView view;
+	view.Planes[0] = XMFLOAT4(c3.x + c0.x, c3.y + c0.y, c3.z + c0.z, c3.w + c0.w);	// left
+	view.Planes[1] = XMFLOAT4(c3.x - c0.x, c3.y - c0.y, c3.z - c0.z, c3.w - c0.w);	// right
+	view.Planes[2] = XMFLOAT4(c3.x + c1.x, c3.y + c1.y, c3.z + c1.z, c3.w + c1.w);	// bottom
+	view.Planes[3] = XMFLOAT4(c3.x - c1.x, c3.y - c1.y, c3.z - c1.z, c3.w - c1.w);	// top
+	view.Planes[4] = c2;																// near (z >= 0)
+	view.Planes[5] = XMFLOAT4(c3.x - c2.x, c3.y - c2.y, c3.z - c2.z, c3.w - c2.w);	// far
+
+	for (XMFLOAT4& plane : view.Planes)
+	{
+		const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > 0.0f)
+			plane = XMFLOAT4(plane.x / length, plane.y / length, plane.z / length, plane.w / length);
+	}
+
+	view.CameraPosition = cameraPosition;
+	return view;
+}
+
+MeshletCullView MeshletCuller::MakeCullView(const XMFLOAT4X4& worldViewProj)
+{
+	// 相机在裁剪空间中为(0,0,c,0)，因此模型空间中的相机位置为WorldViewProj逆矩阵的第3行(齐次坐标)
+	const XMMATRIX m = XMLoadFloat4x4(&worldViewProj);
+	XMVECTOR det = XMMatrixDeterminant(m);
+	XMFLOAT4 eye;
+	XMStoreFloat4(&eye, XMMatrixInverse(&det, m).r[2]);
+
+	const bool perspective = std::fabs(eye.w) > 1e-6f;
+	MeshletCullView view = MakeCullView(worldViewProj, perspective ? XMFLOAT3(eye.x / eye.w, eye.y / eye.w, eye.z / eye.w) : XMFLOAT3(0.0f, 0.0f, 0.0f));
+	view.ConeCulling = perspective;
+	return view;
+}
+
+bool MeshletCuller::IsOutsideFrustum(const MeshletCullView& view, const MeshletBounds& bounds)
+{
+	for (const XMFLOAT4& plane : view.Planes)
+	{
+		if (plane.x * bounds.Center.x + plane.y * bounds.Center.y + plane.z * bounds.Center.z + plane.w < -bounds.Radius)
+			return true;
+	}
+	return false;
+}
+
+bool MeshletCuller::IsBackFacing(const MeshletCullView& view, const MeshletBounds& bounds)
+{
+	// 以包围球代替锥顶的保守测试: dot(center - camera, axis) >= cutoff * |center - camera| + radius
+	const XMFLOAT3 toCenter = Sub(bounds.Center, view.CameraPosition);
+	return Dot(toCenter, bounds.ConeAxis) >= bounds.ConeCutoff * Length(toCenter) + bounds.Radius;
+}
+
+void MeshletCuller::Cull(const MeshletCullView& view, const Meshlet* meshlets, const MeshletBounds* bounds, std::size_t meshletCount,
+	std::vector<MeshletDrawRange>& outRanges, MeshletCullStats* pStats)
+{
+	MeshletCullStats stats;
+	stats.MeshletCount = meshletCount;
+	outRanges.clear();
+
+	for (std::size_t i = 0; i < meshletCount; ++i)
+	{
+		if (IsOutsideFrustum(view, bounds[i]))
+		{
+			++stats.FrustumCulledCount;
+			continue;
+		}
+		if (view.ConeCulling && IsBackFacing(view, bounds[i]))
+		{
+			++stats.ConeCulledCount;
+			continue;
+		}
+
+		const Meshlet& meshlet = meshlets[i];
+		stats.VisibleTriangleCount += meshlet.IndexCount / 3;
+		if (!outRanges.empty())
+		{
+			MeshletDrawRange& last = outRanges.back();
+			if (last.BaseVertexLocation == meshlet.BaseVertexLocation && last.StartIndexLocation + last.IndexCount == meshlet.StartIndexLocation)
+			{
+				last.IndexCount += meshlet.IndexCount;
+				continue;
+			}
+		}
+
+		MeshletDrawRange range;
+		range.StartIndexLocation = meshlet.StartIndexLocation;
+		range.IndexCount = meshlet.IndexCount;
+		range.BaseVertexLocation = meshlet.BaseVertexLocation;
+		outRanges.push_back(range);
+	}
+
+	stats.DrawRangeCount = outRanges.size();
+	if (pStats)
+		*pStats = stats;
+}
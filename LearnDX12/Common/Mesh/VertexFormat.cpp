@@ -0,0 +1,193 @@
+﻿#include "Mesh/VertexFormat.h"
+#include <cstring>
+
+using namespace DirectX;
+using namespace DirectX::PackedVector;
+
+// 顶点格式的布局在编译期校验，格式描述与对应结构体不一致时无法通过编译
+static_assert(ColorVertexFormat::Stride == sizeof(Vertex), "ColorVertexFormat must match Vertex");
+static_assert(ColorVertexFormat::GetOffset(0) == offsetof(Vertex, Pos), "ColorVertexFormat position offset");
+static_assert(ColorVertexFormat::GetOffset(1) == offsetof(Vertex, Color), "ColorVertexFormat color offset");
+
+static_assert(PackedColorVertexFormat::Stride == sizeof(PackedColorVertex) && sizeof(PackedColorVertex) == 12, "PackedColorVertexFormat stride");
+static_assert(PackedColorVertexFormat::GetOffset(0) == offsetof(PackedColorVertex, Pos), "PackedColorVertexFormat position offset");
+static_assert(PackedColorVertexFormat::GetOffset(1) == offsetof(PackedColorVertex, Color), "PackedColorVertexFormat color offset");
+
+static_assert(LitVertexFormat::Stride == 48, "LitVertexFormat stride");
+static_assert(LitVertexFormat::GetOffset(3) == 32, "LitVertexFormat color offset");
+
+static_assert(PackedLitVertexFormat::Stride == sizeof(PackedLitVertex) && sizeof(PackedLitVertex) == 20, "PackedLitVertexFormat stride");
+static_assert(PackedLitVertexFormat::GetOffset(0) == offsetof(PackedLitVertex, Pos), "PackedLitVertexFormat position offset");
+static_assert(PackedLitVertexFormat::GetOffset(1) == offsetof(PackedLitVertex, Normal), "PackedLitVertexFormat normal offset");
+static_assert(PackedLitVertexFormat::GetOffset(2) == offsetof(PackedLitVertex, TexC), "PackedLitVertexFormat texcoord offset");
+static_assert(PackedLitVertexFormat::GetOffset(3) == offsetof(PackedLitVertex, Color), "PackedLitVertexFormat color offset");
+
+static_assert(TangentVertexFormat::Stride == 64, "TangentVertexFormat stride");
+static_assert(PackedTangentVertexFormat::Stride == sizeof(PackedTangentVertex) && sizeof(PackedTangentVertex) == 28, "PackedTangentVertexFormat stride");
+static_assert(PackedTangentVertexFormat::GetOffset(2) == offsetof(PackedTangentVertex, Tangent), "PackedTangentVertexFormat tangent offset");
+static_assert(PackedTangentVertexFormat::GetOffset(3) == offsetof(PackedTangentVertex, TexC), "PackedTangentVertexFormat texcoord offset");
+static_assert(PackedTangentVertexFormat::GetOffset(4) == offsetof(PackedTangentVertex, Color), "PackedTangentVertexFormat color offset");
+
+static_assert(ColorVertexFormat::GetId() != PackedColorVertexFormat::GetId()
+	&& LitVertexFormat::GetId() != PackedLitVertexFormat::GetId()
+	&& ColorVertexFormat::GetId() != LitVertexFormat::GetId()
+	&& TangentVertexFormat::GetId() != PackedTangentVertexFormat::GetId()
+	&& TangentVertexFormat::GetId() != LitVertexFormat::GetId()
+	&& PackedTangentVertexFormat::GetId() != PackedLitVertexFormat::GetId(), "vertex format ids must be unique");
+
+namespace
+{
+	// 一种语义的源数据流(Position/Color来自Vertices，Normal/TexCoord/Tangent来自附加属性)
+	struct AttributeSource
+	{
+		const float* Data = nullptr;
+		std::size_t Stride = 0;
+		std::uint32_t ComponentCount = 0;
+		// 源数据不存在或分量不足时使用的默认值
+		float Defaults[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	};
+
+	AttributeSource GetAttributeSource(const MeshData& mesh, VertexSemantic semantic)
+	{
+		AttributeSource source;
+		switch (semantic)
+		{
+		case VertexSemantic::Position:
+			source.Data = &mesh.Vertices[0].Pos.x;
+			source.Stride = sizeof(Vertex);
+			source.ComponentCount = 3;
+			source.Defaults[3] = 1.0f;
+			break;
+		case VertexSemantic::Color:
+			source.Data = &mesh.Vertices[0].Color.x;
+			source.Stride = sizeof(Vertex);
+			source.ComponentCount = 4;
+			break;
+		case VertexSemantic::Normal:
+			source.Defaults[2] = 1.0f;
+			if (mesh.Normals.size() == mesh.Vertices.size())
+			{
+				source.Data = &mesh.Normals[0].x;
+				source.Stride = sizeof(XMFLOAT3);
+				source.ComponentCount = 3;
+			}
+			break;
+		case VertexSemantic::TexCoord:
+			if (mesh.TexCoords.size() == mesh.Vertices.size())
+			{
+				source.Data = &mesh.TexCoords[0].x;
+				source.Stride = sizeof(XMFLOAT2);
+				source.ComponentCount = 2;
+			}
+			break;
+		case VertexSemantic::Tangent:
+			source.Defaults[0] = 1.0f;
+			source.Defaults[3] = 1.0f;
+			if (mesh.Tangents.size() == mesh.Vertices.size())
+			{
+				source.Data = &mesh.Tangents[0].x;
+				source.Stride = sizeof(XMFLOAT4);
+				source.ComponentCount = 4;
+			}
+			break;
+		}
+		return source;
+	}
+
+	// 读取第i个顶点的4个分量，不足部分使用默认值
+	inline XMFLOAT4 LoadSource(const AttributeSource& source, std::size_t i)
+	{
+		float values[4] = { source.Defaults[0], source.Defaults[1], source.Defaults[2], source.Defaults[3] };
+		if (source.Data != nullptr)
+		{
+			const float* p = reinterpret_cast<const float*>(reinterpret_cast<const std::uint8_t*>(source.Data) + i * source.Stride);
+			for (std::uint32_t c = 0; c < source.ComponentCount; ++c)
+				values[c] = p[c];
+		}
+		return XMFLOAT4(values);
+	}
+
+	std::uint32_t GetComponentCount(VertexAttributeFormat format)
+	{
+		switch (format)
+		{
+		case VertexAttributeFormat::Float2:
+		case VertexAttributeFormat::Half2:
+		case VertexAttributeFormat::OctSNorm16x2:
+			return 2;
+		case VertexAttributeFormat::Float3:
+			return 3;
+		default:
+			return 4;
+		}
+	}
+}
+
+void EncodeVertexAttribute(const MeshData& mesh, VertexSemantic semantic, VertexAttributeFormat format,
+	std::uint8_t* dst, std::size_t dstStride)
+{
+	const std::size_t count = mesh.Vertices.size();
+	if (count == 0)
+		return;
+
+	const AttributeSource source = GetAttributeSource(mesh, semantic);
+	const std::uint32_t componentCount = GetComponentCount(format);
+
+	switch (format)
+	{
+	case VertexAttributeFormat::Float2:
+	case VertexAttributeFormat::Float3:
+	case VertexAttributeFormat::Float4:
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const XMFLOAT4 value = LoadSource(source, i);
+			std::memcpy(dst + i * dstStride, &value, componentCount * sizeof(float));
+		}
+		break;
+	}
+	case VertexAttributeFormat::Half2:
+	case VertexAttributeFormat::Half4:
+	{
+		// 源数据中存在的分量使用XMConvertFloatToHalfStream批量转换(支持F16C时使用SIMD指令)，其余分量填充默认值
+		for (std::uint32_t c = 0; c < componentCount; ++c)
+		{
+			HALF* pOutput = reinterpret_cast<HALF*>(dst + c * sizeof(HALF));
+			if (source.Data != nullptr && c < source.ComponentCount)
+			{
+				XMConvertFloatToHalfStream(pOutput, dstStride, source.Data + c, source.Stride, count);
+			}
+			else
+			{
+				const HALF value = XMConvertFloatToHalf(source.Defaults[c]);
+				for (std::size_t i = 0; i < count; ++i)
+					std::memcpy(dst + i * dstStride + c * sizeof(HALF), &value, sizeof(HALF));
+			}
+		}
+		break;
+	}
+	case VertexAttributeFormat::UNorm8x4:
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const XMFLOAT4 value = LoadSource(source, i);
+			XMUBYTEN4 packed;
+			XMStoreUByteN4(&packed, XMLoadFloat4(&value));
+			std::memcpy(dst + i * dstStride, &packed, sizeof(packed));
+		}
+		break;
+	}
+	case VertexAttributeFormat::OctSNorm16x2:
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const XMFLOAT4 value = LoadSource(source, i);
+			const XMFLOAT2 encoded = OctEncode(XMFLOAT3(value.x, value.y, value.z));
+			XMSHORTN2 packed;
+			XMStoreShortN2(&packed, XMVectorSet(encoded.x, encoded.y, 0.0f, 0.0f));
+			std::memcpy(dst + i * dstStride, &packed, sizeof(packed));
+		}
+		break;
+	}
+	}
+}
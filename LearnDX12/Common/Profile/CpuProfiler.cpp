@@ -0,0 +1,185 @@
+﻿#include "Profile/CpuProfiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+namespace
+{
+	std::int64_t SteadyNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void WriteJsonString(std::ostream& stream, const char* text)
+	{
+		stream << '"';
+		for (const char* c = text != nullptr ? text : ""; *c != '\0'; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+				stream << '\\' << *c;
+			else if ((unsigned char)*c < 0x20)
+				stream << ' ';
+			else
+				stream << *c;
+		}
+		stream << '"';
+	}
+}
+
+CpuProfiler& CpuProfiler::GetInstance()
+{
+	static CpuProfiler instance;
+	return instance;
+}
+
+CpuProfiler::CpuProfiler()
+	: StartTicks(Now()), StartNanoseconds(SteadyNanoseconds())
+{
+}
+
+CpuProfileThreadBuffer& CpuProfiler::RegisterThread()
+{
+	CpuProfiler& profiler = GetInstance();
+	std::lock_guard<std::mutex> lock(profiler.Mutex);
+	// 缓冲区在线程退出后仍保留，未读取的事件在下一次EndFrame时收集
+	profiler.ThreadBuffers.push_back(std::make_unique<CpuProfileThreadBuffer>((std::uint32_t)profiler.ThreadBuffers.size()));
+	CurrentThreadBuffer = profiler.ThreadBuffers.back().get();
+	return *CurrentThreadBuffer;
+}
+
+void CpuProfiler::EndFrame()
+{
+	const std::uint64_t frameEnd = Now();
+	std::lock_guard<std::mutex> lock(Mutex);
+
+	// 超出保留帧数时重用最早一帧的内存
+	CapturedFrame frame;
+	if (MaxCapturedFrames > 0 && Frames.size() >= MaxCapturedFrames)
+	{
+		frame = std::move(Frames.front());
+		Frames.pop_front();
+		frame.Events.clear();
+	}
+
+	const std::uint64_t capacity = CpuProfileThreadBuffer::Capacity;
+	for (const std::unique_ptr<CpuProfileThreadBuffer>& buffer : ThreadBuffers)
+	{
+		const std::uint64_t head = buffer->Head.load(std::memory_order_acquire);
+		std::uint64_t tail = buffer->Tail;
+		if (head - tail > capacity)
+		{
+			DroppedEventCount += head - tail - capacity;
+			tail = head - capacity;
+		}
+
+		const std::size_t first = frame.Events.size();
+		for (std::uint64_t i = tail; i < head; ++i)
+		{
+			const CpuProfileThreadBuffer::Slot& slot = buffer->Slots[i & (capacity - 1)];
+			CpuProfileEvent event;
+			event.Name = slot.Name;
+			event.Begin = slot.Begin;
+			event.End = slot.End;
+			event.ThreadIndex = buffer->ThreadIndex;
+			frame.Events.push_back(event);
+		}
+
+		// 读取期间所属线程继续写入，已被覆盖的记录可能不完整，丢弃；
+		// 所属线程可能正在写入第newHead个记录(尚未发布)，与其共用位置的记录同样丢弃
+		const std::uint64_t newHead = buffer->Head.load(std::memory_order_acquire);
+		if (newHead + 1 - tail > capacity)
+		{
+			const std::uint64_t overwritten = std::min(newHead + 1 - capacity, head) - tail;
+			frame.Events.erase(frame.Events.begin() + first, frame.Events.begin() + first + (std::size_t)overwritten);
+			DroppedEventCount += overwritten;
+		}
+		buffer->Tail = head;
+	}
+
+	frame.Begin = FrameBegin != 0 ? FrameBegin : StartTicks;
+	frame.End = frameEnd;
+	FrameBegin = frameEnd;
+	if (MaxCapturedFrames > 0)
+		Frames.push_back(std::move(frame));
+}
+
+void CpuProfiler::Clear()
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	Frames.clear();
+	DroppedEventCount = 0;
+}
+
+void CpuProfiler::SetMaxCapturedFrames(std::size_t frameCount)
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	MaxCapturedFrames = frameCount;
+	while (Frames.size() > MaxCapturedFrames)
+		Frames.pop_front();
+}
+
+std::size_t CpuProfiler::GetCapturedFrameCount() const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	return Frames.size();
+}
+
+void CpuProfiler::GetCapturedEvents(std::vector<CpuProfileEvent>& outEvents) const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	outEvents.clear();
+	for (const CapturedFrame& frame : Frames)
+		outEvents.insert(outEvents.end(), frame.Events.begin(), frame.Events.end());
+}
+
+double CpuProfiler::GetTicksPerMicrosecond() const
+{
+#if defined(CPUPROFILER_TSC)
+	// 以构造后经过的时间校准TSC频率
+	const std::uint64_t ticks = Now() - StartTicks;
+	const std::int64_t nanoseconds = SteadyNanoseconds() - StartNanoseconds;
+	return nanoseconds > 0 ? (double)ticks * 1000.0 / (double)nanoseconds : 1.0;
+#else
+	using Period = std::chrono::steady_clock::period;
+	return (double)Period::den / ((double)Period::num * 1000000.0);
+#endif
+}
+
+void CpuProfiler::WriteChromeTrace(std::ostream& stream) const
+{
+	const double ticksPerMicrosecond = GetTicksPerMicrosecond();
+
+	std::lock_guard<std::mutex> lock(Mutex);
+	const std::uint64_t origin = Frames.empty() ? 0 : Frames.front().Begin;
+	auto toMicroseconds = [&](std::uint64_t ticks) { return ticks >= origin ? (double)(ticks - origin) / ticksPerMicrosecond : 0.0; };
+
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	auto writeEvent = [&](const char* name, std::uint64_t begin, std::uint64_t end, std::uint32_t threadIndex)
+	{
+		stream << (first ? "\n" : ",\n") << "{\"name\":";
+		WriteJsonString(stream, name);
+		stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << threadIndex
+			<< ",\"ts\":" << toMicroseconds(begin) << ",\"dur\":" << (end >= begin ? (double)(end - begin) / ticksPerMicrosecond : 0.0) << "}";
+		first = false;
+	};
+
+	// 帧事件放在单独的tid上，不与线程0的事件嵌套
+	const std::uint32_t frameThread = (std::uint32_t)ThreadBuffers.size();
+	for (const CapturedFrame& frame : Frames)
+	{
+		writeEvent("Frame", frame.Begin, frame.End, frameThread);
+		for (const CpuProfileEvent& event : frame.Events)
+			writeEvent(event.Name, event.Begin, event.End, event.ThreadIndex);
+	}
+	stream << "\n]}\n";
+}
+
+bool CpuProfiler::WriteChromeTrace(const std::string& filename) const
+{
+	std::ofstream stream(filename, std::ios::out | std::ios::trunc);
+	if (!stream)
+		return false;
+	WriteChromeTrace(stream);
+	return (bool)stream;
+}
@@ -0,0 +1,182 @@
+﻿#include "Profile/GpuProfiler.h"
+#include <cassert>
+#include <cstring>
+#include <iomanip>
+#include <string>
+
+void HeadlessGpuTimestampBackend::CreateQueries(std::uint32_t queryCount)
+{
+	Queries.assign(queryCount, 0);
+	Readback.assign(queryCount, 0);
+	PendingResolves.clear();
+}
+
+void HeadlessGpuTimestampBackend::WriteTimestamp(std::uint32_t query)
+{
+	assert(query < Queries.size());
+	Queries[query] = CurrentTick;
+	++WriteCount;
+}
+
+void HeadlessGpuTimestampBackend::ResolveTimestamps(std::uint32_t first, std::uint32_t count)
+{
+	assert((std::size_t)first + count <= Queries.size());
+	PendingResolves.push_back({ first, count });
+}
+
+bool HeadlessGpuTimestampBackend::ReadTimestamps(std::uint32_t first, std::uint32_t count, std::uint64_t* outTicks)
+{
+	if ((std::size_t)first + count > Readback.size())
+		return false;
+
+	++ReadCount;
+	for (const PendingResolve& pending : PendingResolves)
+	{
+		if (pending.First < first + count && first < pending.First + pending.Count)
+		{
+			++StaleReadCount;
+			break;
+		}
+	}
+	std::memcpy(outTicks, Readback.data() + first, count * sizeof(std::uint64_t));
+	return true;
+}
+
+void HeadlessGpuTimestampBackend::CompleteGpuWork()
+{
+	for (const PendingResolve& pending : PendingResolves)
+		std::memcpy(Readback.data() + pending.First, Queries.data() + pending.First, pending.Count * sizeof(std::uint64_t));
+	PendingResolves.clear();
+}
+
+GpuProfiler::GpuProfiler(GpuTimestampBackend& backend, std::uint32_t framesInFlight, std::uint32_t maxScopesPerFrame)
+	: Backend(backend), FramesInFlight(framesInFlight > 0 ? framesInFlight : 1), MaxScopesPerFrame(maxScopesPerFrame),
+	QueriesPerFrame(2 + 2 * maxScopesPerFrame)
+{
+	Slots.resize(FramesInFlight);
+	for (FrameSlot& slot : Slots)
+		slot.Scopes.reserve(MaxScopesPerFrame);
+	ReadTicks.resize(QueriesPerFrame);
+	Backend.CreateQueries(GetQueryCount());
+}
+
+void GpuProfiler::BeginFrame()
+{
+	assert(!InFrame);
+	CurrentSlot = (std::uint32_t)(FrameIndex % FramesInFlight);
+	FrameSlot& slot = Slots[CurrentSlot];
+	if (slot.Pending)
+		ReadSlot(slot, CurrentSlot);
+
+	slot.FrameIndex = FrameIndex;
+	slot.Scopes.clear();
+	CurrentDepth = 0;
+	InFrame = true;
+	Backend.WriteTimestamp(GetFirstQuery(CurrentSlot));
+}
+
+void GpuProfiler::EndFrame()
+{
+	assert(InFrame);
+	FrameSlot& slot = Slots[CurrentSlot];
+	const std::uint32_t firstQuery = GetFirstQuery(CurrentSlot);
+
+	// 未结束的Scope以帧结束的时间为准
+	for (std::size_t i = slot.Scopes.size(); i > 0; --i)
+	{
+		if (!slot.Scopes[i - 1].Ended)
+			EndScope((std::uint32_t)(i - 1));
+	}
+
+	Backend.WriteTimestamp(firstQuery + 1);
+	Backend.ResolveTimestamps(firstQuery, 2 + 2 * (std::uint32_t)slot.Scopes.size());
+	slot.Pending = true;
+	InFrame = false;
+	++FrameIndex;
+}
+
+std::uint32_t GpuProfiler::BeginScope(const char* name)
+{
+	FrameSlot& slot = Slots[CurrentSlot];
+	if (!InFrame || slot.Scopes.size() >= MaxScopesPerFrame)
+	{
+		++DroppedScopeCount;
+		return InvalidScope;
+	}
+
+	const std::uint32_t scope = (std::uint32_t)slot.Scopes.size();
+	ScopeRecord record;
+	record.Name = name;
+	record.Depth = CurrentDepth++;
+	slot.Scopes.push_back(record);
+	Backend.WriteTimestamp(GetFirstQuery(CurrentSlot) + 2 + 2 * scope);
+	return scope;
+}
+
+void GpuProfiler::EndScope(std::uint32_t scope)
+{
+	FrameSlot& slot = Slots[CurrentSlot];
+	if (!InFrame || scope >= slot.Scopes.size() || slot.Scopes[scope].Ended)
+		return;
+
+	slot.Scopes[scope].Ended = true;
+	--CurrentDepth;
+	Backend.WriteTimestamp(GetFirstQuery(CurrentSlot) + 3 + 2 * scope);
+}
+
+void GpuProfiler::ReadSlot(FrameSlot& slot, std::uint32_t slotIndex)
+{
+	slot.Pending = false;
+	const std::uint32_t queryCount = 2 + 2 * (std::uint32_t)slot.Scopes.size();
+	if (!Backend.ReadTimestamps(GetFirstQuery(slotIndex), queryCount, ReadTicks.data()))
+		return;
+
+	const std::uint64_t frequency = Backend.GetTimestampFrequency();
+	LastFrame.FrameIndex = slot.FrameIndex;
+	LastFrame.FrameMilliseconds = TicksToMilliseconds(ReadTicks[0], ReadTicks[1], frequency);
+	LastFrame.Passes.clear();
+	for (std::size_t i = 0; i < slot.Scopes.size(); ++i)
+	{
+		GpuPassTiming pass;
+		pass.Name = slot.Scopes[i].Name;
+		pass.Depth = slot.Scopes[i].Depth;
+		pass.Milliseconds = TicksToMilliseconds(ReadTicks[2 + 2 * i], ReadTicks[3 + 2 * i], frequency);
+		LastFrame.Passes.push_back(pass);
+	}
+	HasLastFrame = true;
+}
+
+double GpuProfiler::GetPassMilliseconds(const char* name) const
+{
+	double milliseconds = 0.0;
+	for (const GpuPassTiming& pass : LastFrame.Passes)
+	{
+		if (pass.Name == name || (pass.Name != nullptr && name != nullptr && std::strcmp(pass.Name, name) == 0))
+			milliseconds += pass.Milliseconds;
+	}
+	return milliseconds;
+}
+
+double GpuProfiler::TicksToMilliseconds(std::uint64_t begin, std::uint64_t end, std::uint64_t frequency)
+{
+	if (frequency == 0 || end < begin)
+		return 0.0;
+	return (double)(end - begin) * 1000.0 / (double)frequency;
+}
+
+void GpuProfiler::WriteText(std::ostream& stream) const
+{
+	if (!HasLastFrame)
+	{
+		stream << "no gpu timings\n";
+		return;
+	}
+
+	stream << "gpu frame " << LastFrame.FrameIndex << ": " << std::fixed << std::setprecision(3) << LastFrame.FrameMilliseconds << " ms\n";
+	for (const GpuPassTiming& pass : LastFrame.Passes)
+	{
+		stream << std::string(2 * (pass.Depth + 1), ' ') << std::left << std::setw(24) << (pass.Name != nullptr ? pass.Name : "")
+			<< std::right << std::setw(10) << pass.Milliseconds << " ms\n";
+	}
+	stream.unsetf(std::ios::fixed);
+}
@@ -0,0 +1,116 @@
+﻿#include "Profile/RenderCounters.h"
+#include <iomanip>
+
+thread_local RenderCounterThreadBlock* RenderCounters::CurrentThreadBlock = nullptr;
+
+const char* GetRenderCounterName(RenderCounter counter)
+{
+	switch (counter)
+	{
+	case RenderCounter::DrawCalls:				return "DrawCalls";
+	case RenderCounter::PipelineStateChanges:	return "PipelineStateChanges";
+	case RenderCounter::RootSignatureChanges:	return "RootSignatureChanges";
+	case RenderCounter::DescriptorHeapChanges:	return "DescriptorHeapChanges";
+	case RenderCounter::Barriers:				return "Barriers";
+	case RenderCounter::UploadBytes:			return "UploadBytes";
+	case RenderCounter::ResourcesCreated:		return "ResourcesCreated";
+	case RenderCounter::FenceWaits:				return "FenceWaits";
+	default:									return "";
+	}
+}
+
+RenderCounters& RenderCounters::GetInstance()
+{
+	static RenderCounters instance;
+	return instance;
+}
+
+RenderCounterThreadBlock& RenderCounters::RegisterThread()
+{
+	RenderCounters& counters = GetInstance();
+	std::lock_guard<std::mutex> lock(counters.Mutex);
+	// 线程退出后计数块仍保留，累计值不会减少
+	counters.ThreadBlocks.push_back(std::make_unique<RenderCounterThreadBlock>());
+	CurrentThreadBlock = counters.ThreadBlocks.back().get();
+	return *CurrentThreadBlock;
+}
+
+void RenderCounters::EndFrame()
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+
+	std::uint64_t totals[RenderCounterCount] = {};
+	for (const std::unique_ptr<RenderCounterThreadBlock>& block : ThreadBlocks)
+	{
+		for (std::size_t c = 0; c < RenderCounterCount; ++c)
+			totals[c] += block->Values[c].load(std::memory_order_relaxed);
+	}
+
+	RenderCounterSnapshot snapshot;
+	snapshot.FrameIndex = FrameIndex++;
+	for (std::size_t c = 0; c < RenderCounterCount; ++c)
+	{
+		snapshot.Values[c] = totals[c] - PreviousTotals[c];
+		PreviousTotals[c] = totals[c];
+	}
+	LastFrame = snapshot;
+
+	if (HistorySize == 0)
+		return;
+	if (History.size() < HistorySize)
+	{
+		History.push_back(snapshot);
+	}
+	else
+	{
+		for (std::size_t c = 0; c < RenderCounterCount; ++c)
+			HistorySums[c] -= History[HistoryNext].Values[c];
+		History[HistoryNext] = snapshot;
+		HistoryNext = (HistoryNext + 1) % HistorySize;
+	}
+	for (std::size_t c = 0; c < RenderCounterCount; ++c)
+		HistorySums[c] += snapshot.Values[c];
+}
+
+RenderCounterSnapshot RenderCounters::GetLastFrame() const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	return LastFrame;
+}
+
+double RenderCounters::GetRollingAverage(RenderCounter counter) const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	return History.empty() ? 0.0 : (double)HistorySums[(std::size_t)counter] / (double)History.size();
+}
+
+std::size_t RenderCounters::GetHistoryCount() const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	return History.size();
+}
+
+void RenderCounters::SetHistorySize(std::size_t frameCount)
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	HistorySize = frameCount;
+	History.clear();
+	HistoryNext = 0;
+	for (std::uint64_t& sum : HistorySums)
+		sum = 0;
+}
+
+void RenderCounters::WriteText(std::ostream& stream) const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	stream << "frame " << LastFrame.FrameIndex << ", average of " << History.size() << " frames\n";
+	stream << std::left << std::setw(24) << "counter" << std::right << std::setw(14) << "last" << std::setw(16) << "average" << '\n';
+	for (std::size_t c = 0; c < RenderCounterCount; ++c)
+	{
+		const double average = History.empty() ? 0.0 : (double)HistorySums[c] / (double)History.size();
+		stream << std::left << std::setw(24) << GetRenderCounterName((RenderCounter)c)
+			<< std::right << std::setw(14) << LastFrame.Values[c]
+			<< std::setw(16) << std::fixed << std::setprecision(2) << average << '\n';
+	}
+	stream.unsetf(std::ios::fixed);
+}
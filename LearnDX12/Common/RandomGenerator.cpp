@@ -0,0 +1,282 @@
+﻿#include "RandomGenerator.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(__AVX2__)
+#define RANDOM_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RANDOM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	std::uint64_t SplitMix64(std::uint64_t& state)
+	{
+		std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// 每次最多在栈上生成的数量(浮点数及整数先生成整数再转换)
+	constexpr std::size_t ChunkSize = 256;
+
+#if defined(RANDOM_AVX2)
+	__m256i Rotl(__m256i x, int k)
+	{
+		return _mm256_or_si256(_mm256_slli_epi32(x, k), _mm256_srli_epi32(x, 32 - k));
+	}
+
+	// 生成blockCount组，每组8个(第lane路的结果写到out[block * 8 + lane])
+	void GenerateBlocks(std::uint32_t (&state)[4][BatchRandomGenerator::LaneCount], std::uint32_t* out, std::size_t blockCount)
+	{
+		__m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[0]));
+		__m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[1]));
+		__m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[2]));
+		__m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[3]));
+		for (std::size_t b = 0; b < blockCount; ++b)
+		{
+			// rotl(s1 * 5, 7) * 9，乘法用移位加法代替
+			const __m256i m5 = _mm256_add_epi32(_mm256_slli_epi32(s1, 2), s1);
+			const __m256i r = Rotl(m5, 7);
+			const __m256i result = _mm256_add_epi32(_mm256_slli_epi32(r, 3), r);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + b * 8), result);
+
+			const __m256i t = _mm256_slli_epi32(s1, 9);
+			s2 = _mm256_xor_si256(s2, s0);
+			s3 = _mm256_xor_si256(s3, s1);
+			s1 = _mm256_xor_si256(s1, s2);
+			s0 = _mm256_xor_si256(s0, s3);
+			s2 = _mm256_xor_si256(s2, t);
+			s3 = Rotl(s3, 11);
+		}
+		_mm256_store_si256(reinterpret_cast<__m256i*>(state[0]), s0);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(state[1]), s1);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(state[2]), s2);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(state[3]), s3);
+	}
+#elif defined(RANDOM_SSE2)
+	__m128i Rotl(__m128i x, int k)
+	{
+		return _mm_or_si128(_mm_slli_epi32(x, k), _mm_srli_epi32(x, 32 - k));
+	}
+
+	// 8路分为两组，每组4路
+	void GenerateBlocks(std::uint32_t (&state)[4][BatchRandomGenerator::LaneCount], std::uint32_t* out, std::size_t blockCount)
+	{
+		for (std::size_t half = 0; half < 2; ++half)
+		{
+			const std::size_t lane = half * 4;
+			__m128i s0 = _mm_load_si128(reinterpret_cast<const __m128i*>(&state[0][lane]));
+			__m128i s1 = _mm_load_si128(reinterpret_cast<const __m128i*>(&state[1][lane]));
+			__m128i s2 = _mm_load_si128(reinterpret_cast<const __m128i*>(&state[2][lane]));
+			__m128i s3 = _mm_load_si128(reinterpret_cast<const __m128i*>(&state[3][lane]));
+			for (std::size_t b = 0; b < blockCount; ++b)
+			{
+				// rotl(s1 * 5, 7) * 9，SSE2没有32位乘法，用移位加法代替
+				const __m128i m5 = _mm_add_epi32(_mm_slli_epi32(s1, 2), s1);
+				const __m128i r = Rotl(m5, 7);
+				const __m128i result = _mm_add_epi32(_mm_slli_epi32(r, 3), r);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + b * 8 + lane), result);
+
+				const __m128i t = _mm_slli_epi32(s1, 9);
+				s2 = _mm_xor_si128(s2, s0);
+				s3 = _mm_xor_si128(s3, s1);
+				s1 = _mm_xor_si128(s1, s2);
+				s0 = _mm_xor_si128(s0, s3);
+				s2 = _mm_xor_si128(s2, t);
+				s3 = Rotl(s3, 11);
+			}
+			_mm_store_si128(reinterpret_cast<__m128i*>(&state[0][lane]), s0);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&state[1][lane]), s1);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&state[2][lane]), s2);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&state[3][lane]), s3);
+		}
+	}
+#else
+	void GenerateBlocks(std::uint32_t (&state)[4][BatchRandomGenerator::LaneCount], std::uint32_t* out, std::size_t blockCount)
+	{
+		for (std::size_t b = 0; b < blockCount; ++b)
+		{
+			for (std::size_t lane = 0; lane < BatchRandomGenerator::LaneCount; ++lane)
+			{
+				std::uint32_t& s0 = state[0][lane];
+				std::uint32_t& s1 = state[1][lane];
+				std::uint32_t& s2 = state[2][lane];
+				std::uint32_t& s3 = state[3][lane];
+				out[b * 8 + lane] = RandomGenerator::Rotl(s1 * 5u, 7) * 9u;
+				const std::uint32_t t = s1 << 9;
+				s2 ^= s0;
+				s3 ^= s1;
+				s1 ^= s2;
+				s0 ^= s3;
+				s2 ^= t;
+				s3 = RandomGenerator::Rotl(s3, 11);
+			}
+		}
+	}
+#endif
+
+	std::atomic<std::uint64_t> gRandomSeed(RandomGenerator::DefaultSeed);
+	std::atomic<std::uint32_t> gRandomThreadCount(0);
+
+	// 每个线程的生成器，按线程首次使用的顺序编号
+	struct ThreadRandomState
+	{
+		std::uint32_t ThreadIndex;
+		RandomGenerator Random;
+		BatchRandomGenerator BatchRandom;
+
+		ThreadRandomState() : ThreadIndex(gRandomThreadCount++)
+		{
+			Reseed(gRandomSeed.load());
+		}
+
+		// 线程序号与生成器类型混入种子，经SplitMix64展开后各序列互不相关
+		void Reseed(std::uint64_t seed)
+		{
+			Random.Seed(seed ^ ((std::uint64_t)ThreadIndex * 2 + 0) * 0xD1B54A32D192ED03ull);
+			BatchRandom.Seed(seed ^ ((std::uint64_t)ThreadIndex * 2 + 1) * 0xD1B54A32D192ED03ull);
+		}
+	};
+
+	ThreadRandomState& GetThreadRandomState()
+	{
+		thread_local ThreadRandomState state;
+		return state;
+	}
+}
+
+void RandomGenerator::Seed(std::uint64_t seed)
+{
+	const std::uint64_t a = SplitMix64(seed);
+	const std::uint64_t b = SplitMix64(seed);
+	mState[0] = (std::uint32_t)a;
+	mState[1] = (std::uint32_t)(a >> 32);
+	mState[2] = (std::uint32_t)b;
+	mState[3] = (std::uint32_t)(b >> 32);
+}
+
+std::uint32_t RandomGenerator::NextUInt(std::uint32_t bound)
+{
+	// Lemire: 32位随机数乘以bound取高32位，低32位落在[0, 2^32 mod bound)内的结果需要重新生成
+	std::uint64_t m = (std::uint64_t)NextUInt() * bound;
+	std::uint32_t low = (std::uint32_t)m;
+	if (low < bound)
+	{
+		const std::uint32_t threshold = (0u - bound) % bound;
+		while (low < threshold)
+		{
+			m = (std::uint64_t)NextUInt() * bound;
+			low = (std::uint32_t)m;
+		}
+	}
+	return (std::uint32_t)(m >> 32);
+}
+
+int RandomGenerator::NextInt(int a, int b)
+{
+	// 范围包括整个32位时range溢出为0
+	const std::uint32_t range = (std::uint32_t)b - (std::uint32_t)a + 1u;
+	const std::uint32_t offset = range == 0 ? NextUInt() : NextUInt(range);
+	return (int)((std::uint32_t)a + offset);
+}
+
+void RandomGenerator::Jump()
+{
+	static const std::uint32_t JumpTable[4] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+
+	std::uint32_t s[4] = {};
+	for (std::uint32_t jump : JumpTable)
+	{
+		for (int bit = 0; bit < 32; ++bit)
+		{
+			if (jump & (1u << bit))
+			{
+				for (int k = 0; k < 4; ++k)
+					s[k] ^= mState[k];
+			}
+			NextUInt();
+		}
+	}
+	std::memcpy(mState, s, sizeof(mState));
+}
+
+void BatchRandomGenerator::Seed(std::uint64_t seed)
+{
+	RandomGenerator random(seed);
+	for (std::size_t lane = 0; lane < LaneCount; ++lane)
+	{
+		for (int k = 0; k < 4; ++k)
+			mState[k][lane] = random.mState[k];
+		random.Jump();
+	}
+}
+
+void BatchRandomGenerator::FillUInts(std::uint32_t* outValues, std::size_t count)
+{
+	const std::size_t blockCount = count / LaneCount;
+	GenerateBlocks(mState, outValues, blockCount);
+
+	const std::size_t remain = count - blockCount * LaneCount;
+	if (remain > 0)
+	{
+		std::uint32_t block[LaneCount];
+		GenerateBlocks(mState, block, 1);
+		std::memcpy(outValues + blockCount * LaneCount, block, remain * sizeof(std::uint32_t));
+	}
+}
+
+void BatchRandomGenerator::FillFloats(float* outValues, std::size_t count, float a, float b)
+{
+	const float scale = 1.0f / 16777216.0f;
+	const float range = b - a;
+	std::uint32_t chunk[ChunkSize];
+	for (std::size_t begin = 0; begin < count; begin += ChunkSize)
+	{
+		const std::size_t n = count - begin < ChunkSize ? count - begin : ChunkSize;
+		FillUInts(chunk, n);
+		// 高24位转换为int后再转为float，便于编译器使用SIMD转换指令
+		for (std::size_t i = 0; i < n; ++i)
+			outValues[begin + i] = a + (float)(std::int32_t)(chunk[i] >> 8) * scale * range;
+	}
+}
+
+void BatchRandomGenerator::FillInts(int* outValues, std::size_t count, int a, int b)
+{
+	const std::uint32_t range = (std::uint32_t)b - (std::uint32_t)a + 1u;
+	std::uint32_t chunk[ChunkSize];
+	for (std::size_t begin = 0; begin < count; begin += ChunkSize)
+	{
+		const std::size_t n = count - begin < ChunkSize ? count - begin : ChunkSize;
+		FillUInts(chunk, n);
+		if (range == 0)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				outValues[begin + i] = (int)((std::uint32_t)a + chunk[i]);
+		}
+		else
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				outValues[begin + i] = (int)((std::uint32_t)a + (std::uint32_t)(((std::uint64_t)chunk[i] * range) >> 32));
+		}
+	}
+}
+
+RandomGenerator& GetThreadRandom()
+{
+	return GetThreadRandomState().Random;
+}
+
+BatchRandomGenerator& GetThreadBatchRandom()
+{
+	return GetThreadRandomState().BatchRandom;
+}
+
+void SeedThreadRandom(std::uint64_t seed)
+{
+	gRandomSeed = seed;
+	GetThreadRandomState().Reseed(seed);
+}
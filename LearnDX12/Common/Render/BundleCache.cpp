@@ -0,0 +1,97 @@
+﻿#include "Render/BundleCache.h"
+
+CommandRecorder& HeadlessBundleBackend::BeginBundle()
+{
+	Recording = std::make_unique<HeadlessCommandRecorder>();
+	return *Recording;
+}
+
+RenderHandle HeadlessBundleBackend::EndBundle()
+{
+	const RenderHandle handle = NextHandle++;
+	Bundles.emplace(handle, std::move(Recording));
+	return handle;
+}
+
+void HeadlessBundleBackend::ReleaseBundle(RenderHandle bundle)
+{
+	Bundles.erase(bundle);
+}
+
+const HeadlessCommandRecorder* HeadlessBundleBackend::FindBundle(RenderHandle bundle) const
+{
+	auto it = Bundles.find(bundle);
+	return it != Bundles.end() ? it->second.get() : nullptr;
+}
+
+std::uint64_t HashBundleInputs(const void* data, std::size_t byteSize, std::uint64_t seed)
+{
+	const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+	std::uint64_t hash = seed;
+	for (std::size_t i = 0; i < byteSize; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+BundleCache::~BundleCache()
+{
+	Clear();
+}
+
+RenderHandle BundleCache::GetOrRecord(std::uint64_t id, std::uint64_t inputHash, const RecordFunc& record)
+{
+	auto it = Entries.find(id);
+	if (it != Entries.end())
+	{
+		if (it->second.Bundle != 0 && it->second.InputHash == inputHash)
+		{
+			++Stats.ReuseCount;
+			return it->second.Bundle;
+		}
+		if (it->second.Bundle != 0)
+		{
+			Backend.ReleaseBundle(it->second.Bundle);
+			++Stats.ReleaseCount;
+		}
+	}
+	else
+	{
+		it = Entries.emplace(id, Entry()).first;
+	}
+
+	record(Backend.BeginBundle());
+	it->second.Bundle = Backend.EndBundle();
+	it->second.InputHash = inputHash;
+	++Stats.RecordCount;
+	return it->second.Bundle;
+}
+
+void BundleCache::Invalidate(std::uint64_t id)
+{
+	auto it = Entries.find(id);
+	if (it == Entries.end())
+		return;
+
+	if (it->second.Bundle != 0)
+	{
+		Backend.ReleaseBundle(it->second.Bundle);
+		++Stats.ReleaseCount;
+	}
+	Entries.erase(it);
+}
+
+void BundleCache::Clear()
+{
+	for (auto& pair : Entries)
+	{
+		if (pair.second.Bundle != 0)
+		{
+			Backend.ReleaseBundle(pair.second.Bundle);
+			++Stats.ReleaseCount;
+		}
+	}
+	Entries.clear();
+}
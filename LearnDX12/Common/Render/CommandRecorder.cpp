@@ -0,0 +1,72 @@
+﻿#include "Render/CommandRecorder.h"
+
+void HeadlessCommandRecorder::Reset()
+{
+	Commands.clear();
+	for (std::size_t& count : Counts)
+		count = 0;
+}
+
+void HeadlessCommandRecorder::Record(RecordedCommandType type, RenderHandle handle, std::uint32_t a0, std::uint32_t a1, std::uint32_t a2, std::uint32_t a3, std::uint32_t a4)
+{
+	Commands.push_back(RecordedCommand{ type, { a0, a1, a2, a3, a4 }, handle });
+	++Counts[(std::size_t)type];
+}
+
+void HeadlessCommandRecorder::SetPipelineState(RenderHandle pipelineState)
+{
+	Record(RecordedCommandType::SetPipelineState, pipelineState);
+}
+
+void HeadlessCommandRecorder::SetGraphicsRootSignature(RenderHandle rootSignature)
+{
+	Record(RecordedCommandType::SetGraphicsRootSignature, rootSignature);
+}
+
+void HeadlessCommandRecorder::SetDescriptorHeap(RenderHandle descriptorHeap)
+{
+	Record(RecordedCommandType::SetDescriptorHeap, descriptorHeap);
+}
+
+void HeadlessCommandRecorder::SetGraphicsRootDescriptorTable(std::uint32_t rootParameterIndex, RenderHandle baseDescriptor)
+{
+	Record(RecordedCommandType::SetGraphicsRootDescriptorTable, baseDescriptor, rootParameterIndex);
+}
+
+void HeadlessCommandRecorder::SetVertexBuffer(const VertexBufferBinding& binding)
+{
+	Record(RecordedCommandType::SetVertexBuffer, binding.BufferLocation, binding.SizeInBytes, binding.StrideInBytes);
+}
+
+void HeadlessCommandRecorder::SetIndexBuffer(const IndexBufferBinding& binding)
+{
+	Record(RecordedCommandType::SetIndexBuffer, binding.BufferLocation, binding.SizeInBytes, binding.IndexByteSize);
+}
+
+void HeadlessCommandRecorder::SetPrimitiveTopology(std::uint32_t topology)
+{
+	Record(RecordedCommandType::SetPrimitiveTopology, 0, topology);
+}
+
+void HeadlessCommandRecorder::SetGraphicsRoot32BitConstant(std::uint32_t rootParameterIndex, std::uint32_t value, std::uint32_t destOffsetIn32BitValues)
+{
+	Record(RecordedCommandType::SetGraphicsRoot32BitConstant, 0, rootParameterIndex, value, destOffsetIn32BitValues);
+}
+
+void HeadlessCommandRecorder::DrawIndexedInstanced(std::uint32_t indexCount, std::uint32_t instanceCount, std::uint32_t startIndexLocation,
+	std::int32_t baseVertexLocation, std::uint32_t startInstanceLocation)
+{
+	Record(RecordedCommandType::DrawIndexedInstanced, 0, indexCount, instanceCount, startIndexLocation, (std::uint32_t)baseVertexLocation, startInstanceLocation);
+}
+
+void HeadlessCommandRecorder::ExecuteIndirect(RenderHandle commandSignature, std::uint32_t maxCommandCount, RenderHandle argumentBuffer, std::uint64_t argumentBufferOffset)
+{
+	// 参数缓冲区句柄及偏移分别存入Args[1..2]及Args[3..4]
+	Record(RecordedCommandType::ExecuteIndirect, commandSignature, maxCommandCount,
+		(std::uint32_t)argumentBuffer, (std::uint32_t)(argumentBuffer >> 32), (std::uint32_t)argumentBufferOffset, (std::uint32_t)(argumentBufferOffset >> 32));
+}
+
+void HeadlessCommandRecorder::ExecuteBundle(RenderHandle bundle)
+{
+	Record(RecordedCommandType::ExecuteBundle, bundle);
+}
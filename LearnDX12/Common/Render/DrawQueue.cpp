@@ -0,0 +1,150 @@
+﻿#include "Render/DrawQueue.h"
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+// 缓冲区绑定按字节比较
+static_assert(sizeof(VertexBufferBinding) == 16 && sizeof(IndexBufferBinding) == 16, "buffer bindings must not contain padding");
+
+std::uint32_t GetRenderStateId(RenderHandle handle)
+{
+	if (handle == 0)
+		return 0;
+
+	static std::mutex mutex;
+	static std::unordered_map<RenderHandle, std::uint32_t> ids;
+	std::lock_guard<std::mutex> lock(mutex);
+	return ids.emplace(handle, (std::uint32_t)ids.size() + 1).first->second;
+}
+
+void RadixSortDrawKeys(DrawSortEntry* entries, DrawSortEntry* scratch, std::size_t count)
+{
+	if (count <= 1)
+		return;
+
+	// 一次遍历统计所有8个字节的直方图
+	std::uint32_t histograms[8][256];
+	std::memset(histograms, 0, sizeof(histograms));
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const std::uint64_t key = entries[i].Key;
+		for (std::uint32_t pass = 0; pass < 8; ++pass)
+			++histograms[pass][(key >> (pass * 8)) & 0xFF];
+	}
+
+	DrawSortEntry* src = entries;
+	DrawSortEntry* dst = scratch;
+	for (std::uint32_t pass = 0; pass < 8; ++pass)
+	{
+		std::uint32_t* histogram = histograms[pass];
+		const std::uint32_t shift = pass * 8;
+
+		// 所有键在该字节相同时顺序不变
+		if (histogram[(src[0].Key >> shift) & 0xFF] == count)
+			continue;
+
+		std::uint32_t offset = 0;
+		for (std::uint32_t digit = 0; digit < 256; ++digit)
+		{
+			const std::uint32_t digitCount = histogram[digit];
+			histogram[digit] = offset;
+			offset += digitCount;
+		}
+
+		for (std::size_t i = 0; i < count; ++i)
+			dst[histogram[(src[i].Key >> shift) & 0xFF]++] = src[i];
+
+		DrawSortEntry* temp = src;
+		src = dst;
+		dst = temp;
+	}
+
+	if (src != entries)
+		std::memcpy(entries, src, count * sizeof(DrawSortEntry));
+}
+
+void DrawQueue::Reset()
+{
+	Packets.clear();
+	Entries.clear();
+}
+
+void DrawQueue::Reserve(std::size_t packetCount)
+{
+	Packets.reserve(packetCount);
+	Entries.reserve(packetCount);
+}
+
+void DrawQueue::Add(std::uint64_t sortKey, const DrawPacket& packet)
+{
+	Entries.push_back(DrawSortEntry{ sortKey, (std::uint32_t)Packets.size() });
+	Packets.push_back(packet);
+}
+
+void DrawQueue::Sort()
+{
+	if (Scratch.size() < Entries.size())
+		Scratch.resize(Entries.size());
+	RadixSortDrawKeys(Entries.data(), Scratch.data(), Entries.size());
+}
+
+void DrawQueue::Execute(CommandRecorder& recorder, DrawQueueStats* pStats) const
+{
+	// 每次绘制都设置的状态: 描述符堆/根签名/描述符表/PSO/顶点缓冲区/索引缓冲区/图元类型
+	const std::uint32_t StatesPerDraw = 7;
+	std::uint32_t stateCalls = 0;
+
+	const DrawPacket* previous = nullptr;
+	for (const DrawSortEntry& entry : Entries)
+	{
+		const DrawPacket& packet = Packets[entry.Packet];
+
+		const bool heapChanged = previous == nullptr || packet.DescriptorHeap != previous->DescriptorHeap;
+		const bool rootSignatureChanged = previous == nullptr || packet.RootSignature != previous->RootSignature;
+		if (heapChanged)
+		{
+			recorder.SetDescriptorHeap(packet.DescriptorHeap);
+			++stateCalls;
+		}
+		if (rootSignatureChanged)
+		{
+			recorder.SetGraphicsRootSignature(packet.RootSignature);
+			++stateCalls;
+		}
+		if (heapChanged || rootSignatureChanged || packet.DescriptorTable != previous->DescriptorTable)
+		{
+			recorder.SetGraphicsRootDescriptorTable(0, packet.DescriptorTable);
+			++stateCalls;
+		}
+		if (previous == nullptr || packet.PipelineState != previous->PipelineState)
+		{
+			recorder.SetPipelineState(packet.PipelineState);
+			++stateCalls;
+		}
+		if (previous == nullptr || std::memcmp(&packet.VertexBuffer, &previous->VertexBuffer, sizeof(VertexBufferBinding)) != 0)
+		{
+			recorder.SetVertexBuffer(packet.VertexBuffer);
+			++stateCalls;
+		}
+		if (previous == nullptr || std::memcmp(&packet.IndexBuffer, &previous->IndexBuffer, sizeof(IndexBufferBinding)) != 0)
+		{
+			recorder.SetIndexBuffer(packet.IndexBuffer);
+			++stateCalls;
+		}
+		if (previous == nullptr || packet.Topology != previous->Topology)
+		{
+			recorder.SetPrimitiveTopology(packet.Topology);
+			++stateCalls;
+		}
+
+		recorder.DrawIndexedInstanced(packet.IndexCount, packet.InstanceCount, packet.StartIndexLocation, packet.BaseVertexLocation, packet.StartInstanceLocation);
+		previous = &packet;
+	}
+
+	if (pStats != nullptr)
+	{
+		pStats->PacketCount = (std::uint32_t)Entries.size();
+		pStats->StateCallCount = stateCalls;
+		pStats->RedundantStateCallCount = (std::uint32_t)Entries.size() * StatesPerDraw - stateCalls;
+	}
+}
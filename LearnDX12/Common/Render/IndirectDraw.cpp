@@ -0,0 +1,195 @@
+﻿#include "Render/IndirectDraw.h"
+#include <algorithm>
+#include <cstring>
+#include "ParallelFor.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define INDIRECTDRAW_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+	// 剔除4个物体(first开始的count个，count <= 4)，返回可见掩码
+	std::uint32_t CullGroupScalar(const MeshletCullView& view, const IndirectDrawList& draws, std::size_t first, std::size_t count)
+	{
+		std::uint32_t mask = 0;
+		for (std::size_t k = 0; k < count; ++k)
+		{
+			const std::size_t i = first + k;
+			bool visible = true;
+			for (const DirectX::XMFLOAT4& plane : view.Planes)
+			{
+				const float distance = plane.x * draws.CenterX[i] + plane.y * draws.CenterY[i] + plane.z * draws.CenterZ[i] + plane.w;
+				if (distance < -draws.Radius[i])
+				{
+					visible = false;
+					break;
+				}
+			}
+			if (visible)
+				mask |= 1u << k;
+		}
+		return mask;
+	}
+
+#if defined(INDIRECTDRAW_SSE)
+	// 6个平面的各分量分别广播到4个通道
+	struct CullPlanesSSE
+	{
+		__m128 A[6];
+		__m128 B[6];
+		__m128 C[6];
+		__m128 D[6];
+	};
+
+	CullPlanesSSE MakeCullPlanes(const MeshletCullView& view)
+	{
+		CullPlanesSSE planes;
+		for (int p = 0; p < 6; ++p)
+		{
+			planes.A[p] = _mm_set1_ps(view.Planes[p].x);
+			planes.B[p] = _mm_set1_ps(view.Planes[p].y);
+			planes.C[p] = _mm_set1_ps(view.Planes[p].z);
+			planes.D[p] = _mm_set1_ps(view.Planes[p].w);
+		}
+		return planes;
+	}
+
+	inline std::uint32_t CullGroupSSE(const CullPlanesSSE& planes, const IndirectDrawList& draws, std::size_t first)
+	{
+		const __m128 x = _mm_loadu_ps(&draws.CenterX[first]);
+		const __m128 y = _mm_loadu_ps(&draws.CenterY[first]);
+		const __m128 z = _mm_loadu_ps(&draws.CenterZ[first]);
+		const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&draws.Radius[first]));
+
+		__m128 outside = _mm_setzero_ps();
+		for (int p = 0; p < 6; ++p)
+		{
+			__m128 distance = _mm_add_ps(_mm_mul_ps(planes.A[p], x), planes.D[p]);
+			distance = _mm_add_ps(distance, _mm_mul_ps(planes.B[p], y));
+			distance = _mm_add_ps(distance, _mm_mul_ps(planes.C[p], z));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negRadius));
+		}
+		return ~(std::uint32_t)_mm_movemask_ps(outside) & 0xFu;
+	}
+#endif
+
+	// 剔除[groupBegin, groupEnd)范围内的物体组，写入可见掩码并返回可见数量
+	std::uint32_t CullGroups(const MeshletCullView& view, const IndirectDrawList& draws, std::size_t groupBegin, std::size_t groupEnd, std::uint8_t* masks)
+	{
+		const std::size_t count = draws.GetCount();
+		std::uint32_t visibleCount = 0;
+#if defined(INDIRECTDRAW_SSE)
+		const CullPlanesSSE planes = MakeCullPlanes(view);
+#endif
+		for (std::size_t g = groupBegin; g < groupEnd; ++g)
+		{
+			const std::size_t first = g * 4;
+			std::uint32_t mask;
+#if defined(INDIRECTDRAW_SSE)
+			if (first + 4 <= count)
+				mask = CullGroupSSE(planes, draws, first);
+			else
+#endif
+				mask = CullGroupScalar(view, draws, first, std::min<std::size_t>(4, count - first));
+
+			masks[g] = (std::uint8_t)mask;
+			visibleCount += (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + (mask >> 3);
+		}
+		return visibleCount;
+	}
+
+	// 按掩码将可见物体的参数顺序写入outArguments
+	void WriteVisibleArguments(const IndirectDrawList& draws, const std::uint8_t* masks, std::size_t groupBegin, std::size_t groupEnd,
+		IndirectDrawArguments* outArguments)
+	{
+		const IndirectDrawArguments* arguments = draws.Arguments.data();
+		for (std::size_t g = groupBegin; g < groupEnd; ++g)
+		{
+			std::uint32_t mask = masks[g];
+			if (mask == 0xFu)
+			{
+				std::memcpy(outArguments, arguments + g * 4, 4 * sizeof(IndirectDrawArguments));
+				outArguments += 4;
+				continue;
+			}
+			for (std::uint32_t k = 0; mask != 0; ++k, mask >>= 1)
+			{
+				if (mask & 1)
+					*outArguments++ = arguments[g * 4 + k];
+			}
+		}
+	}
+}
+
+std::uint32_t IndirectArgumentBuilder::Build(const IndirectDrawList& draws, const MeshletCullView* pView, IndirectDrawArguments* outArguments, unsigned threadCount)
+{
+	const std::size_t count = draws.GetCount();
+	if (count == 0)
+		return 0;
+
+	if (pView == nullptr)
+	{
+		std::memcpy(outArguments, draws.Arguments.data(), count * sizeof(IndirectDrawArguments));
+		return (std::uint32_t)count;
+	}
+
+	const std::size_t groupCount = (count + 3) / 4;
+	const std::size_t groupsPerChunk = ChunkSize / 4;
+	const std::size_t chunkCount = (groupCount + groupsPerChunk - 1) / groupsPerChunk;
+	VisibleMasks.resize(groupCount);
+	ChunkOffsets.assign(chunkCount + 1, 0);
+	WorkerPool& pool = WorkerPool::GetInstance();
+	if (count < ParallelMinCount)
+		threadCount = 1;
+
+	// 剔除并统计各段的可见数量
+	pool.ParallelFor(chunkCount, 1, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t c = begin; c < end; ++c)
+		{
+			const std::size_t groupBegin = c * groupsPerChunk;
+			const std::size_t groupEnd = std::min(groupBegin + groupsPerChunk, groupCount);
+			ChunkOffsets[c + 1] = CullGroups(*pView, draws, groupBegin, groupEnd, VisibleMasks.data());
+		}
+	}, threadCount);
+
+	for (std::size_t c = 0; c < chunkCount; ++c)
+		ChunkOffsets[c + 1] += ChunkOffsets[c];
+
+	// 各段写入互不重叠的区间
+	pool.ParallelFor(chunkCount, 1, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t c = begin; c < end; ++c)
+		{
+			const std::size_t groupBegin = c * groupsPerChunk;
+			const std::size_t groupEnd = std::min(groupBegin + groupsPerChunk, groupCount);
+			WriteVisibleArguments(draws, VisibleMasks.data(), groupBegin, groupEnd, outArguments + ChunkOffsets[c]);
+		}
+	}, threadCount);
+
+	return ChunkOffsets[chunkCount];
+}
+
+std::uint32_t IndirectArgumentBuilder::Record(CommandRecorder& recorder, const IndirectDrawBucket& bucket, const MeshletCullView* pView,
+	RenderHandle commandSignature, IndirectDrawArguments* outArguments, RenderHandle argumentBuffer, std::uint64_t argumentBufferOffset,
+	unsigned threadCount)
+{
+	const std::uint32_t visibleCount = Build(bucket.Draws, pView, outArguments, threadCount);
+	if (visibleCount == 0)
+		return 0;
+
+	const DrawPacket& state = bucket.State;
+	recorder.SetDescriptorHeap(state.DescriptorHeap);
+	recorder.SetGraphicsRootSignature(state.RootSignature);
+	recorder.SetGraphicsRootDescriptorTable(0, state.DescriptorTable);
+	recorder.SetPipelineState(state.PipelineState);
+	recorder.SetVertexBuffer(state.VertexBuffer);
+	recorder.SetIndexBuffer(state.IndexBuffer);
+	recorder.SetPrimitiveTopology(state.Topology);
+
+	const std::uint64_t offset = argumentBufferOffset + (bucket.UseRootConstant ? 0 : IndirectDrawArgumentsDrawOffset);
+	recorder.ExecuteIndirect(commandSignature, visibleCount, argumentBuffer, offset);
+	return visibleCount;
+}
@@ -0,0 +1,97 @@
+﻿#include "Render/MaterialRegistry.h"
+#include <cstring>
+#include "Profile/RenderCounters.h"
+
+MaterialRegistry::MaterialRegistry(std::uint32_t frameResourceCount) :
+	FrameResourceCount(frameResourceCount > 0 ? frameResourceCount : 1)
+{
+}
+
+std::uint32_t MaterialRegistry::Add(const std::string& name, const MaterialConstants& constants)
+{
+	const std::uint32_t index = (std::uint32_t)Constants.size();
+	if (!NameIndices.emplace(name, index).second)
+		return InvalidMaterialIndex;
+
+	Constants.push_back(constants);
+	Names.push_back(name);
+	FramesDirty.push_back(0);
+	// 新材质同样需要写入每个帧资源
+	MarkDirty(index);
+	return index;
+}
+
+std::uint32_t MaterialRegistry::Find(const std::string& name) const
+{
+	auto it = NameIndices.find(name);
+	return it != NameIndices.end() ? it->second : InvalidMaterialIndex;
+}
+
+void MaterialRegistry::Set(std::uint32_t index, const MaterialConstants& constants)
+{
+	Constants[index] = constants;
+	MarkDirty(index);
+}
+
+void MaterialRegistry::MarkDirty(std::uint32_t index)
+{
+	if (FramesDirty[index] == 0)
+		DirtyList.push_back(index);
+	FramesDirty[index] = FrameResourceCount;
+}
+
+void MaterialRegistry::Reserve(std::size_t count)
+{
+	Constants.reserve(count);
+	Names.reserve(count);
+	NameIndices.reserve(count);
+	FramesDirty.reserve(count);
+}
+
+std::uint32_t MaterialRegistry::Upload(void* mappedData, std::size_t stride, MaterialUploadStats* pStats)
+{
+	std::uint8_t* data = static_cast<std::uint8_t*>(mappedData);
+	const std::uint32_t uploadedCount = (std::uint32_t)DirtyList.size();
+	for (std::size_t i = 0; i < DirtyList.size();)
+	{
+		const std::uint32_t index = DirtyList[i];
+		std::memcpy(data + index * stride, &Constants[index], sizeof(MaterialConstants));
+
+		// 所有帧资源都已写入的材质与列表末尾交换后移除
+		if (--FramesDirty[index] == 0)
+		{
+			DirtyList[i] = DirtyList.back();
+			DirtyList.pop_back();
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	const std::uint64_t uploadBytes = (std::uint64_t)uploadedCount * sizeof(MaterialConstants);
+	if (uploadBytes > 0)
+		CountRender(RenderCounter::UploadBytes, uploadBytes);
+	if (pStats)
+	{
+		pStats->UploadedCount = uploadedCount;
+		pStats->UploadBytes = uploadBytes;
+		pStats->PendingCount = (std::uint32_t)DirtyList.size();
+	}
+	return uploadedCount;
+}
+
+void MaterialRegistry::WriteAll(void* mappedData, std::size_t stride) const
+{
+	std::uint8_t* data = static_cast<std::uint8_t*>(mappedData);
+	if (stride == sizeof(MaterialConstants))
+	{
+		std::memcpy(data, Constants.data(), Constants.size() * sizeof(MaterialConstants));
+	}
+	else
+	{
+		for (std::size_t i = 0; i < Constants.size(); ++i)
+			std::memcpy(data + i * stride, &Constants[i], sizeof(MaterialConstants));
+	}
+	CountRender(RenderCounter::UploadBytes, (std::uint64_t)Constants.size() * sizeof(MaterialConstants));
+}
@@ -0,0 +1,135 @@
+﻿#include "Render/SceneStore.h"
+#include "Render/StaticBatcher.h"
+
+using namespace DirectX;
+
+RenderableHandle SceneStore::Create(const RenderableDesc& desc)
+{
+	std::uint32_t slot = FreeSlot;
+	if (slot != InvalidRenderableIndex)
+	{
+		FreeSlot = Slots[slot].Dense;
+	}
+	else
+	{
+		slot = (std::uint32_t)Slots.size();
+		Slots.emplace_back();
+	}
+
+	Slots[slot].Dense = (std::uint32_t)DenseSlots.size();
+	DenseSlots.push_back(slot);
+	Worlds.push_back(desc.World);
+	Bounds.push_back(desc.Bounds);
+	MeshIds.push_back(desc.MeshId);
+	MaterialIds.push_back(desc.MaterialId);
+	Visibility.push_back(desc.Visibility);
+	return RenderableHandle{ slot, Slots[slot].Generation };
+}
+
+bool SceneStore::Destroy(RenderableHandle handle)
+{
+	const std::uint32_t index = GetIndex(handle);
+	if (index == InvalidRenderableIndex)
+		return false;
+
+	// 末尾物体移动到被删除的位置
+	const std::uint32_t last = (std::uint32_t)DenseSlots.size() - 1;
+	if (index != last)
+	{
+		Worlds[index] = Worlds[last];
+		Bounds[index] = Bounds[last];
+		MeshIds[index] = MeshIds[last];
+		MaterialIds[index] = MaterialIds[last];
+		Visibility[index] = Visibility[last];
+		DenseSlots[index] = DenseSlots[last];
+		Slots[DenseSlots[index]].Dense = index;
+	}
+	Worlds.pop_back();
+	Bounds.pop_back();
+	MeshIds.pop_back();
+	MaterialIds.pop_back();
+	Visibility.pop_back();
+	DenseSlots.pop_back();
+
+	// 代数为0的句柄(默认构造)始终无效
+	SlotEntry& entry = Slots[handle.Slot];
+	entry.Generation = entry.Generation + 1 == 0 ? 1 : entry.Generation + 1;
+	entry.Dense = FreeSlot;
+	FreeSlot = handle.Slot;
+	return true;
+}
+
+bool SceneStore::IsAlive(RenderableHandle handle) const
+{
+	return GetIndex(handle) != InvalidRenderableIndex;
+}
+
+std::uint32_t SceneStore::GetIndex(RenderableHandle handle) const
+{
+	if (handle.Slot >= Slots.size() || Slots[handle.Slot].Generation != handle.Generation)
+		return InvalidRenderableIndex;
+	return Slots[handle.Slot].Dense;
+}
+
+void SceneStore::Reserve(std::size_t count)
+{
+	Worlds.reserve(count);
+	Bounds.reserve(count);
+	MeshIds.reserve(count);
+	MaterialIds.reserve(count);
+	Visibility.reserve(count);
+	DenseSlots.reserve(count);
+	Slots.reserve(count);
+}
+
+void SceneStore::Clear()
+{
+	// 代数递增使旧句柄失效，槽位全部放回空闲链表
+	for (std::uint32_t slot : DenseSlots)
+	{
+		SlotEntry& entry = Slots[slot];
+		entry.Generation = entry.Generation + 1 == 0 ? 1 : entry.Generation + 1;
+		entry.Dense = FreeSlot;
+		FreeSlot = slot;
+	}
+	Worlds.clear();
+	Bounds.clear();
+	MeshIds.clear();
+	MaterialIds.clear();
+	Visibility.clear();
+	DenseSlots.clear();
+}
+
+void SceneStore::SetWorld(RenderableHandle handle, const XMFLOAT4X4& world, const BoundingBox& bounds)
+{
+	const std::uint32_t index = GetIndex(handle);
+	if (index == InvalidRenderableIndex)
+		return;
+	Worlds[index] = world;
+	Bounds[index] = bounds;
+}
+
+void SceneStore::SetMaterial(RenderableHandle handle, std::uint32_t materialId)
+{
+	const std::uint32_t index = GetIndex(handle);
+	if (index != InvalidRenderableIndex)
+		MaterialIds[index] = materialId;
+}
+
+void SceneStore::SetVisibility(RenderableHandle handle, std::uint8_t visibility)
+{
+	const std::uint32_t index = GetIndex(handle);
+	if (index != InvalidRenderableIndex)
+		Visibility[index] = visibility;
+}
+
+void SceneStore::CullVisible(const MeshletCullView& view, std::vector<std::uint32_t>& outIndices) const
+{
+	outIndices.clear();
+	const std::size_t count = GetCount();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if ((Visibility[i] & RenderableVisible) != 0 && !StaticBatcher::IsOutsideFrustum(view, Bounds[i]))
+			outIndices.push_back((std::uint32_t)i);
+	}
+}
@@ -0,0 +1,388 @@
+﻿#include "Render/StaticBatcher.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+
+using namespace DirectX;
+
+namespace
+{
+	// 源网格中一个LOD0子集及其引用的顶点范围(同一网格的所有实例共用)
+	struct SourcePiece
+	{
+		std::uint32_t StartIndexLocation = 0;
+		std::uint32_t IndexCount = 0;
+		std::int32_t BaseVertexLocation = 0;
+		std::uint32_t FirstVertex = 0;
+		std::uint32_t VertexCount = 0;
+		BoundingBox Bounds;
+	};
+
+	// 一个实例的一个子集在合并结果中的位置
+	struct Piece
+	{
+		std::uint32_t Instance = 0;
+		std::uint32_t Source = 0;
+		std::int32_t Cell[3] = { 0, 0, 0 };
+		BoundingBox Bounds;
+
+		std::uint32_t Batch = 0;
+		std::uint32_t DstVertex = 0;
+		std::uint32_t DstIndex = 0;
+		// 所属绘制的BaseVertexLocation
+		std::uint32_t DrawBaseVertex = 0;
+	};
+
+	// 世界矩阵左上3x3的余子式矩阵(= 行列式 * 逆矩阵的转置)，用于变换法线
+	struct NormalMatrix
+	{
+		float M[3][3];
+		float Determinant;
+	};
+
+	NormalMatrix MakeNormalMatrix(const XMFLOAT4X4& world)
+	{
+		const float (*a)[4] = world.m;
+		NormalMatrix n;
+		n.M[0][0] = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+		n.M[0][1] = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+		n.M[0][2] = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+		n.M[1][0] = a[0][2] * a[2][1] - a[0][1] * a[2][2];
+		n.M[1][1] = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+		n.M[1][2] = a[0][1] * a[2][0] - a[0][0] * a[2][1];
+		n.M[2][0] = a[0][1] * a[1][2] - a[0][2] * a[1][1];
+		n.M[2][1] = a[0][2] * a[1][0] - a[0][0] * a[1][2];
+		n.M[2][2] = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+		n.Determinant = a[0][0] * n.M[0][0] + a[0][1] * n.M[0][1] + a[0][2] * n.M[0][2];
+		return n;
+	}
+
+	inline XMFLOAT3 TransformPoint(const XMFLOAT4X4& m, const XMFLOAT3& p)
+	{
+		return XMFLOAT3(
+			p.x * m.m[0][0] + p.y * m.m[1][0] + p.z * m.m[2][0] + m.m[3][0],
+			p.x * m.m[0][1] + p.y * m.m[1][1] + p.z * m.m[2][1] + m.m[3][1],
+			p.x * m.m[0][2] + p.y * m.m[1][2] + p.z * m.m[2][2] + m.m[3][2]);
+	}
+
+	inline XMFLOAT3 TransformVector(const float (*m)[4], float x, float y, float z)
+	{
+		return XMFLOAT3(
+			x * m[0][0] + y * m[1][0] + z * m[2][0],
+			x * m[0][1] + y * m[1][1] + z * m[2][1],
+			x * m[0][2] + y * m[1][2] + z * m[2][2]);
+	}
+
+	inline XMFLOAT3 TransformNormal(const NormalMatrix& n, const XMFLOAT3& v)
+	{
+		return XMFLOAT3(
+			v.x * n.M[0][0] + v.y * n.M[1][0] + v.z * n.M[2][0],
+			v.x * n.M[0][1] + v.y * n.M[1][1] + v.z * n.M[2][1],
+			v.x * n.M[0][2] + v.y * n.M[1][2] + v.z * n.M[2][2]);
+	}
+
+	inline XMFLOAT3 Normalize(const XMFLOAT3& v, float scale = 1.0f)
+	{
+		const float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+		if (length <= 0.0f)
+			return v;
+		const float k = scale / length;
+		return XMFLOAT3(v.x * k, v.y * k, v.z * k);
+	}
+
+	// 包围盒变换后的轴对齐包围盒
+	BoundingBox TransformBounds(const XMFLOAT4X4& m, const BoundingBox& bounds)
+	{
+		BoundingBox result;
+		result.Center = TransformPoint(m, bounds.Center);
+		const XMFLOAT3& e = bounds.Extents;
+		result.Extents = XMFLOAT3(
+			std::fabs(e.x * m.m[0][0]) + std::fabs(e.y * m.m[1][0]) + std::fabs(e.z * m.m[2][0]),
+			std::fabs(e.x * m.m[0][1]) + std::fabs(e.y * m.m[1][1]) + std::fabs(e.z * m.m[2][1]),
+			std::fabs(e.x * m.m[0][2]) + std::fabs(e.y * m.m[1][2]) + std::fabs(e.z * m.m[2][2]));
+		return result;
+	}
+
+	// 收集网格中LOD0子集引用的顶点范围，没有子集时整个索引缓冲区作为一个子集
+	void CollectSourcePieces(const MeshData& mesh, std::vector<SourcePiece>& outPieces)
+	{
+		std::vector<MeshSubset> wholeMesh;
+		const std::vector<MeshSubset>* pSubsets = &mesh.Subsets;
+		if (mesh.Subsets.empty())
+		{
+			MeshSubset subset;
+			subset.IndexCount = (std::uint32_t)mesh.Indices32.size();
+			subset.Bounds = ComputeSubsetBounds(mesh, subset);
+			wholeMesh.push_back(subset);
+			pSubsets = &wholeMesh;
+		}
+
+		for (const MeshSubset& subset : *pSubsets)
+		{
+			if (subset.LodLevel != 0 || subset.IndexCount == 0 || (std::size_t)subset.StartIndexLocation + subset.IndexCount > mesh.Indices32.size())
+				continue;
+
+			const std::uint32_t* indices = mesh.Indices32.data() + subset.StartIndexLocation;
+			const auto range = std::minmax_element(indices, indices + subset.IndexCount);
+			const std::int64_t firstVertex = (std::int64_t)subset.BaseVertexLocation + *range.first;
+			const std::int64_t endVertex = (std::int64_t)subset.BaseVertexLocation + *range.second + 1;
+			if (firstVertex < 0 || endVertex > (std::int64_t)mesh.Vertices.size())
+				continue;
+
+			SourcePiece piece;
+			piece.StartIndexLocation = subset.StartIndexLocation;
+			piece.IndexCount = subset.IndexCount - subset.IndexCount % 3;
+			piece.BaseVertexLocation = subset.BaseVertexLocation;
+			piece.FirstVertex = (std::uint32_t)firstVertex;
+			piece.VertexCount = (std::uint32_t)(endVertex - firstVertex);
+			piece.Bounds = subset.Bounds;
+			outPieces.push_back(piece);
+		}
+	}
+
+	// 变换一个实例子集的顶点并写入索引
+	void WritePiece(const StaticBatchInstance& instance, const SourcePiece& source, const Piece& piece, MeshData& dst)
+	{
+		const MeshData& src = *instance.Mesh;
+		const XMFLOAT4X4& world = instance.World;
+		const NormalMatrix normalMatrix = MakeNormalMatrix(world);
+		const bool mirrored = normalMatrix.Determinant < 0.0f;
+		const float normalSign = mirrored ? -1.0f : 1.0f;
+
+		const bool srcNormals = src.Normals.size() == src.Vertices.size();
+		const bool srcTexCoords = src.TexCoords.size() == src.Vertices.size();
+		const bool srcTangents = src.Tangents.size() == src.Vertices.size();
+		for (std::uint32_t v = 0; v < source.VertexCount; ++v)
+		{
+			const std::size_t s = (std::size_t)source.FirstVertex + v;
+			const std::size_t d = (std::size_t)piece.DstVertex + v;
+			dst.Vertices[d].Pos = TransformPoint(world, src.Vertices[s].Pos);
+			dst.Vertices[d].Color = src.Vertices[s].Color;
+
+			if (!dst.Normals.empty())
+			{
+				const XMFLOAT3 normal = srcNormals ? src.Normals[s] : XMFLOAT3(0.0f, 0.0f, 1.0f);
+				dst.Normals[d] = Normalize(TransformNormal(normalMatrix, normal), normalSign);
+			}
+			if (!dst.TexCoords.empty())
+				dst.TexCoords[d] = srcTexCoords ? src.TexCoords[s] : XMFLOAT2(0.0f, 0.0f);
+			if (!dst.Tangents.empty())
+			{
+				const XMFLOAT4 tangent = srcTangents ? src.Tangents[s] : XMFLOAT4(1.0f, 0.0f, 0.0f, 1.0f);
+				const XMFLOAT3 t = Normalize(TransformVector(world.m, tangent.x, tangent.y, tangent.z));
+				dst.Tangents[d] = XMFLOAT4(t.x, t.y, t.z, mirrored ? -tangent.w : tangent.w);
+			}
+		}
+
+		// 源索引 + BaseVertexLocation为源顶点编号，映射到所属绘制中的相对编号
+		const std::int64_t offset = (std::int64_t)source.BaseVertexLocation - source.FirstVertex + piece.DstVertex - piece.DrawBaseVertex;
+		const std::uint32_t* srcIndices = src.Indices32.data() + source.StartIndexLocation;
+		std::uint32_t* dstIndices = dst.Indices32.data() + piece.DstIndex;
+		for (std::uint32_t i = 0; i < source.IndexCount; i += 3)
+		{
+			dstIndices[i] = (std::uint32_t)(srcIndices[i] + offset);
+			dstIndices[i + 1] = (std::uint32_t)(srcIndices[mirrored ? i + 2 : i + 1] + offset);
+			dstIndices[i + 2] = (std::uint32_t)(srcIndices[mirrored ? i + 1 : i + 2] + offset);
+		}
+	}
+}
+
+void StaticBatcher::Build(const StaticBatchInstance* instances, std::size_t instanceCount, const StaticBatchOptions& options,
+	std::vector<StaticBatch>& outBatches, StaticBatchStats* pStats)
+{
+	outBatches.clear();
+
+	// 同一网格的多个实例只扫描一次索引
+	std::vector<SourcePiece> sourcePieces;
+	std::unordered_map<const MeshData*, std::pair<std::uint32_t, std::uint32_t>> meshPieces;
+	std::vector<Piece> pieces;
+	for (std::size_t i = 0; i < instanceCount; ++i)
+	{
+		const StaticBatchInstance& instance = instances[i];
+		if (instance.Mesh == nullptr)
+			continue;
+
+		auto it = meshPieces.find(instance.Mesh);
+		if (it == meshPieces.end())
+		{
+			const std::uint32_t first = (std::uint32_t)sourcePieces.size();
+			CollectSourcePieces(*instance.Mesh, sourcePieces);
+			it = meshPieces.emplace(instance.Mesh, std::make_pair(first, (std::uint32_t)sourcePieces.size() - first)).first;
+		}
+
+		for (std::uint32_t s = it->second.first; s < it->second.first + it->second.second; ++s)
+		{
+			Piece piece;
+			piece.Instance = (std::uint32_t)i;
+			piece.Source = s;
+			piece.Bounds = TransformBounds(instance.World, sourcePieces[s].Bounds);
+			if (options.CellSize > 0.0f)
+			{
+				piece.Cell[0] = (std::int32_t)std::floor(piece.Bounds.Center.x / options.CellSize);
+				piece.Cell[1] = (std::int32_t)std::floor(piece.Bounds.Center.y / options.CellSize);
+				piece.Cell[2] = (std::int32_t)std::floor(piece.Bounds.Center.z / options.CellSize);
+			}
+			pieces.push_back(piece);
+		}
+	}
+
+	// 按渲染状态及空间单元排序，同一单元内保持实例顺序
+	std::vector<std::uint32_t> order(pieces.size());
+	std::iota(order.begin(), order.end(), 0u);
+	std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b)
+	{
+		const Piece& pa = pieces[a];
+		const Piece& pb = pieces[b];
+		const std::uint64_t ka = instances[pa.Instance].StateKey;
+		const std::uint64_t kb = instances[pb.Instance].StateKey;
+		if (ka != kb)
+			return ka < kb;
+		return std::lexicographical_compare(pa.Cell, pa.Cell + 3, pb.Cell, pb.Cell + 3);
+	});
+
+	// 分配各部分在批次中的位置: 状态变化时开始新的批次，单元变化或顶点数超过上限时开始新的绘制
+	struct BatchLayout
+	{
+		std::uint32_t VertexCount = 0;
+		std::uint32_t IndexCount = 0;
+		bool HasNormals = false;
+		bool HasTexCoords = false;
+		bool HasTangents = false;
+		std::vector<XMFLOAT3> DrawMin;
+		std::vector<XMFLOAT3> DrawMax;
+	};
+	std::vector<BatchLayout> layouts;
+	const Piece* previous = nullptr;
+	for (std::uint32_t p : order)
+	{
+		Piece& piece = pieces[p];
+		const StaticBatchInstance& instance = instances[piece.Instance];
+		const SourcePiece& source = sourcePieces[piece.Source];
+
+		if (previous == nullptr || instances[previous->Instance].StateKey != instance.StateKey)
+		{
+			outBatches.emplace_back();
+			outBatches.back().StateKey = instance.StateKey;
+			outBatches.back().Mesh.Name = "static batch " + std::to_string(outBatches.size() - 1);
+			layouts.emplace_back();
+			previous = nullptr;
+		}
+		StaticBatch& batch = outBatches.back();
+		BatchLayout& layout = layouts.back();
+
+		const bool sameCell = previous != nullptr && std::equal(piece.Cell, piece.Cell + 3, previous->Cell);
+		if (!sameCell || layout.VertexCount - previous->DrawBaseVertex + source.VertexCount > options.MaxVerticesPerDraw)
+		{
+			MeshSubset draw;
+			draw.Name = "cell " + std::to_string(piece.Cell[0]) + "," + std::to_string(piece.Cell[1]) + "," + std::to_string(piece.Cell[2]);
+			draw.StartIndexLocation = layout.IndexCount;
+			draw.BaseVertexLocation = (std::int32_t)layout.VertexCount;
+			batch.Mesh.Subsets.push_back(draw);
+			layout.DrawMin.push_back(XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX));
+			layout.DrawMax.push_back(XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+		}
+
+		MeshSubset& draw = batch.Mesh.Subsets.back();
+		piece.Batch = (std::uint32_t)outBatches.size() - 1;
+		piece.DstVertex = layout.VertexCount;
+		piece.DstIndex = layout.IndexCount;
+		piece.DrawBaseVertex = (std::uint32_t)draw.BaseVertexLocation;
+		draw.IndexCount += source.IndexCount;
+		layout.VertexCount += source.VertexCount;
+		layout.IndexCount += source.IndexCount;
+
+		const XMFLOAT3& c = piece.Bounds.Center;
+		const XMFLOAT3& e = piece.Bounds.Extents;
+		ExpandMinMax(layout.DrawMin.back(), layout.DrawMax.back(), XMFLOAT3(c.x - e.x, c.y - e.y, c.z - e.z));
+		ExpandMinMax(layout.DrawMin.back(), layout.DrawMax.back(), XMFLOAT3(c.x + e.x, c.y + e.y, c.z + e.z));
+
+		const MeshData& src = *instance.Mesh;
+		layout.HasNormals |= !src.Normals.empty();
+		layout.HasTexCoords |= !src.TexCoords.empty();
+		layout.HasTangents |= !src.Tangents.empty();
+		previous = &piece;
+	}
+
+	for (std::size_t b = 0; b < outBatches.size(); ++b)
+	{
+		MeshData& mesh = outBatches[b].Mesh;
+		const BatchLayout& layout = layouts[b];
+		mesh.Vertices.resize(layout.VertexCount);
+		mesh.Indices32.resize(layout.IndexCount);
+		if (layout.HasNormals)
+			mesh.Normals.resize(layout.VertexCount);
+		if (layout.HasTexCoords)
+			mesh.TexCoords.resize(layout.VertexCount);
+		if (layout.HasTangents)
+			mesh.Tangents.resize(layout.VertexCount);
+		for (std::size_t d = 0; d < mesh.Subsets.size(); ++d)
+			mesh.Subsets[d].Bounds = MakeBoundsFromMinMax(layout.DrawMin[d], layout.DrawMax[d]);
+	}
+
+	// 各部分写入的范围互不重叠，可并行变换
+	ParallelFor(pieces.size(), 64, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t p = begin; p < end; ++p)
+		{
+			const Piece& piece = pieces[p];
+			WritePiece(instances[piece.Instance], sourcePieces[piece.Source], piece, outBatches[piece.Batch].Mesh);
+		}
+	}, options.ThreadCount);
+
+	if (pStats != nullptr)
+	{
+		*pStats = StaticBatchStats();
+		pStats->InstanceCount = (std::uint32_t)instanceCount;
+		pStats->SourceDrawCount = (std::uint32_t)pieces.size();
+		pStats->BatchCount = (std::uint32_t)outBatches.size();
+		for (const StaticBatch& batch : outBatches)
+		{
+			pStats->DrawCount += (std::uint32_t)batch.Mesh.Subsets.size();
+			pStats->VertexCount += batch.Mesh.Vertices.size();
+			pStats->IndexCount += batch.Mesh.Indices32.size();
+		}
+	}
+}
+
+bool StaticBatcher::IsOutsideFrustum(const MeshletCullView& view, const BoundingBox& bounds)
+{
+	const XMFLOAT3& c = bounds.Center;
+	const XMFLOAT3& e = bounds.Extents;
+	for (const XMFLOAT4& plane : view.Planes)
+	{
+		const float distance = plane.x * c.x + plane.y * c.y + plane.z * c.z + plane.w;
+		const float radius = std::fabs(plane.x) * e.x + std::fabs(plane.y) * e.y + std::fabs(plane.z) * e.z;
+		if (distance < -radius)
+			return true;
+	}
+	return false;
+}
+
+std::uint32_t StaticBatcher::Record(CommandRecorder& recorder, const StaticBatch& batch, const StaticBatchBinding& binding, const MeshletCullView* pView)
+{
+	std::uint32_t drawCount = 0;
+	for (const MeshSubset& draw : batch.Mesh.Subsets)
+	{
+		if (pView != nullptr && IsOutsideFrustum(*pView, draw.Bounds))
+			continue;
+
+		// 批次内所有绘制使用相同的状态及缓冲区，只在第一次可见的绘制前设置
+		if (drawCount == 0)
+		{
+			recorder.SetDescriptorHeap(binding.DescriptorHeap);
+			recorder.SetGraphicsRootSignature(binding.RootSignature);
+			recorder.SetGraphicsRootDescriptorTable(0, binding.DescriptorTable);
+			recorder.SetPipelineState(binding.PipelineState);
+			recorder.SetVertexBuffer(binding.VertexBuffer);
+			recorder.SetIndexBuffer(binding.IndexBuffer);
+			recorder.SetPrimitiveTopology(PrimitiveTopologyTriangleList);
+		}
+		recorder.DrawIndexedInstanced(draw.IndexCount, 1, draw.StartIndexLocation, draw.BaseVertexLocation, 0);
+		++drawCount;
+	}
+	return drawCount;
+}
@@ -0,0 +1,254 @@
+﻿#include "Render/TransformHierarchy.h"
+#include <algorithm>
+#include "ParallelFor.h"
+
+using namespace DirectX;
+
+namespace
+{
+	const std::uint32_t InvalidIndex = 0xFFFFFFFFu;
+}
+
+TransformId TransformHierarchy::Create(const XMFLOAT4X4& local, TransformId parent)
+{
+	const TransformId id = (TransformId)Indices.size();
+	const std::uint32_t index = (std::uint32_t)Ids.size();
+	Indices.push_back(index);
+	Ids.push_back(id);
+	Locals.push_back(local);
+	Worlds.push_back(local);
+	Parents.push_back(IsValid(parent) ? Indices[parent] : InvalidIndex);
+	Flags.push_back(LocalDirty);
+	StructureDirty = true;
+	HasDirty = true;
+	return id;
+}
+
+void TransformHierarchy::Destroy(TransformId id)
+{
+	if (!IsValid(id))
+		return;
+	// 子孙节点在Rebuild中随父节点一起移除
+	Flags[Indices[id]] |= Destroyed;
+	StructureDirty = true;
+}
+
+bool TransformHierarchy::IsValid(TransformId id) const
+{
+	return id < Indices.size() && Indices[id] != InvalidIndex && (Flags[Indices[id]] & Destroyed) == 0;
+}
+
+void TransformHierarchy::Reserve(std::size_t nodeCount)
+{
+	Locals.reserve(nodeCount);
+	Worlds.reserve(nodeCount);
+	Parents.reserve(nodeCount);
+	Ids.reserve(nodeCount);
+	Flags.reserve(nodeCount);
+	Indices.reserve(nodeCount);
+}
+
+void TransformHierarchy::Clear()
+{
+	Locals.clear();
+	Worlds.clear();
+	Parents.clear();
+	Ids.clear();
+	Flags.clear();
+	Indices.clear();
+	LevelBegins.clear();
+	ChangedIndices.clear();
+	FirstDirtyLevel = 0;
+	HasDirty = false;
+	StructureDirty = false;
+}
+
+void TransformHierarchy::SetLocal(TransformId id, const XMFLOAT4X4& local)
+{
+	const std::uint32_t index = Indices[id];
+	Locals[index] = local;
+	Flags[index] |= LocalDirty;
+	HasDirty = true;
+	// 结构变化时Rebuild将所有节点标记为脏，不需要记录层
+	if (!StructureDirty)
+	{
+		const std::size_t level = (std::size_t)(std::upper_bound(LevelBegins.begin(), LevelBegins.end(), index) - LevelBegins.begin()) - 1;
+		FirstDirtyLevel = std::min(FirstDirtyLevel, level);
+	}
+}
+
+TransformId TransformHierarchy::GetParent(TransformId id) const
+{
+	const std::uint32_t parent = Parents[Indices[id]];
+	return parent == InvalidIndex ? InvalidTransformId : Ids[parent];
+}
+
+void TransformHierarchy::Update(unsigned threadCount, TransformHierarchyStats* pStats)
+{
+	TransformHierarchyStats stats;
+
+	// 清除上次的变化标记(Rebuild会改变下标，需在此之前清除)
+	for (std::uint32_t index : ChangedIndices)
+		Flags[index] &= ~WorldChanged;
+	ChangedIndices.clear();
+
+	if (StructureDirty)
+	{
+		Rebuild();
+		stats.Rebuilt = true;
+	}
+
+	if (HasDirty)
+	{
+		const std::size_t levelCount = GetLevelCount();
+		for (std::size_t level = FirstDirtyLevel; level < levelCount; ++level)
+		{
+			const std::size_t begin = LevelBegins[level];
+			const std::size_t end = LevelBegins[level + 1];
+			if (end - begin < ParallelMinCount)
+			{
+				UpdateRange(begin, end);
+				continue;
+			}
+			WorkerPool::GetInstance().ParallelFor(end - begin, ParallelBatchSize, [&](std::size_t first, std::size_t last)
+				{
+					UpdateRange(begin + first, begin + last);
+				}, threadCount);
+		}
+		if (FirstDirtyLevel < levelCount)
+			CollectChanged(LevelBegins[FirstDirtyLevel], threadCount);
+
+		HasDirty = false;
+		FirstDirtyLevel = levelCount;
+	}
+
+	if (pStats)
+	{
+		stats.NodeCount = (std::uint32_t)GetCount();
+		stats.LevelCount = (std::uint32_t)GetLevelCount();
+		stats.UpdatedCount = (std::uint32_t)ChangedIndices.size();
+		*pStats = stats;
+	}
+}
+
+void TransformHierarchy::Rebuild()
+{
+	// 当前数组中父节点总在子节点之前(已排序部分之后按创建顺序追加)，一次遍历即可得到深度
+	const std::size_t count = Ids.size();
+	const std::uint32_t DeadDepth = 0xFFFFFFFFu;
+	std::vector<std::uint32_t> depths(count);
+	std::vector<std::uint32_t> levelCounts;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const std::uint32_t parent = Parents[i];
+		if ((Flags[i] & Destroyed) != 0 || (parent != InvalidIndex && depths[parent] == DeadDepth))
+		{
+			depths[i] = DeadDepth;
+			Indices[Ids[i]] = InvalidIndex;
+			continue;
+		}
+		const std::uint32_t depth = parent == InvalidIndex ? 0 : depths[parent] + 1;
+		depths[i] = depth;
+		if (depth >= levelCounts.size())
+			levelCounts.resize(depth + 1, 0);
+		++levelCounts[depth];
+	}
+
+	LevelBegins.assign(levelCounts.size() + 1, 0);
+	for (std::size_t level = 0; level < levelCounts.size(); ++level)
+		LevelBegins[level + 1] = LevelBegins[level] + levelCounts[level];
+
+	// 同一层内保持原来的相对顺序
+	std::vector<std::uint32_t> cursors(LevelBegins.begin(), LevelBegins.end() - 1);
+	std::vector<std::uint32_t> newIndices(count, InvalidIndex);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (depths[i] != DeadDepth)
+			newIndices[i] = cursors[depths[i]]++;
+	}
+
+	const std::size_t aliveCount = LevelBegins.back();
+	std::vector<XMFLOAT4X4> locals(aliveCount), worlds(aliveCount);
+	std::vector<std::uint32_t> parents(aliveCount);
+	std::vector<TransformId> ids(aliveCount);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const std::uint32_t index = newIndices[i];
+		if (index == InvalidIndex)
+			continue;
+		locals[index] = Locals[i];
+		worlds[index] = Worlds[i];
+		parents[index] = Parents[i] == InvalidIndex ? InvalidIndex : newIndices[Parents[i]];
+		ids[index] = Ids[i];
+		Indices[Ids[i]] = index;
+	}
+
+	Locals.swap(locals);
+	Worlds.swap(worlds);
+	Parents.swap(parents);
+	Ids.swap(ids);
+	Flags.assign(aliveCount, LocalDirty);
+
+	StructureDirty = false;
+	HasDirty = aliveCount > 0;
+	FirstDirtyLevel = 0;
+}
+
+void TransformHierarchy::UpdateRange(std::size_t begin, std::size_t end)
+{
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		const std::uint32_t parent = Parents[i];
+		const bool parentChanged = parent != InvalidIndex && (Flags[parent] & WorldChanged) != 0;
+		if ((Flags[i] & LocalDirty) == 0 && !parentChanged)
+			continue;
+
+		XMMATRIX world = XMLoadFloat4x4(&Locals[i]);
+		if (parent != InvalidIndex)
+			world = XMMatrixMultiply(world, XMLoadFloat4x4(&Worlds[parent]));
+		XMStoreFloat4x4(&Worlds[i], world);
+		Flags[i] = WorldChanged;
+	}
+}
+
+void TransformHierarchy::CollectChanged(std::size_t begin, unsigned threadCount)
+{
+	const std::size_t count = GetCount() - begin;
+	const std::size_t chunkCount = (count + ParallelBatchSize - 1) / ParallelBatchSize;
+	ChunkOffsets.assign(chunkCount + 1, 0);
+	WorkerPool& pool = WorkerPool::GetInstance();
+	if (count < CollectParallelMinCount)
+		threadCount = 1;
+
+	pool.ParallelFor(chunkCount, 1, [&](std::size_t first, std::size_t last)
+		{
+			for (std::size_t chunk = first; chunk < last; ++chunk)
+			{
+				const std::size_t chunkBegin = begin + chunk * ParallelBatchSize;
+				const std::size_t chunkEnd = std::min(chunkBegin + ParallelBatchSize, GetCount());
+				std::uint32_t changed = 0;
+				for (std::size_t i = chunkBegin; i < chunkEnd; ++i)
+					changed += (Flags[i] & WorldChanged) != 0 ? 1 : 0;
+				ChunkOffsets[chunk + 1] = changed;
+			}
+		}, threadCount);
+
+	for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+		ChunkOffsets[chunk + 1] += ChunkOffsets[chunk];
+
+	ChangedIndices.resize(ChunkOffsets[chunkCount]);
+	pool.ParallelFor(chunkCount, 1, [&](std::size_t first, std::size_t last)
+		{
+			for (std::size_t chunk = first; chunk < last; ++chunk)
+			{
+				const std::size_t chunkBegin = begin + chunk * ParallelBatchSize;
+				const std::size_t chunkEnd = std::min(chunkBegin + ParallelBatchSize, GetCount());
+				std::uint32_t* out = ChangedIndices.data() + ChunkOffsets[chunk];
+				for (std::size_t i = chunkBegin; i < chunkEnd; ++i)
+				{
+					if ((Flags[i] & WorldChanged) != 0)
+						*out++ = (std::uint32_t)i;
+				}
+			}
+		}, threadCount);
+}
@@ -1,16 +1,77 @@
-﻿#include <windows.h>
+﻿#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <chrono>
+#endif
 #include "SystemTimer.h"
 
+namespace
+{
+#if defined(_WIN32)
+	class PerformanceCounterClock : public SystemClock
+	{
+	public:
+
+		PerformanceCounterClock()
+		{
+			// 返回高频检测1s检测的次数
+			LARGE_INTEGER countsPerSec;
+			QueryPerformanceFrequency(&countsPerSec);
+			mFrequency = countsPerSec.QuadPart;
+		}
+
+		std::int64_t GetCounter() const override
+		{
+			LARGE_INTEGER counter;
+			QueryPerformanceCounter(&counter);
+			return counter.QuadPart;
+		}
+
+		std::int64_t GetFrequency() const override { return mFrequency; }
+
+	private:
+
+		std::int64_t mFrequency = 1;
+	};
+	using DefaultClock = PerformanceCounterClock;
+#else
+	class SteadyClock : public SystemClock
+	{
+	public:
 
+		std::int64_t GetCounter() const override
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
 
-SystemTimer::SystemTimer()
-	: mSecondsPerCount(0.0), mDeltaTime(-1.0), mBaseTime(0),
-	mPausedTime(0), mPrevTime(0), mCurrTime(0), mStopped(false)
+		std::int64_t GetFrequency() const override { return 1000000000; }
+	};
+	using DefaultClock = SteadyClock;
+#endif
+}
+
+SystemClock& SystemClock::GetDefault()
 {
-	// 记录高频检测的频率
-	__int64 countsPerSec;
-	QueryPerformanceFrequency((LARGE_INTEGER*)&countsPerSec);	// 返回高频检测1s检测的次数countsPerSec
-	mSecondsPerCount = 1.0 / (double)countsPerSec;	// 记录检测频率用于后续计算帧间隔时间
+	static DefaultClock clock;
+	return clock;
+}
+
+SystemTimer::SystemTimer(SystemClock& clock, const FrameTimeStatsOptions& statsOptions)
+	: mClock(clock), mFrameStats(statsOptions), mSecondsPerCount(0.0), mDeltaTime(-1.0), mBaseTime(0),
+	mPausedTime(0), mStopTime(0), mPrevTime(0), mCurrTime(0), mStopped(false)
+{
+	// 记录检测频率用于后续计算帧间隔时间
+	mSecondsPerCount = 1.0 / (double)mClock.GetFrequency();
+
+	// 未调用Reset时第一帧的间隔从构造时开始计算
+	mBaseTime = Now();
+	mPrevTime = mBaseTime;
+	mCurrTime = mBaseTime;
+}
+
+std::int64_t SystemTimer::Now()const
+{
+	return mClock.GetCounter();
 }
 
 // 统计自Reset开始到现在的执行时间(不包括Stop期间的时间)
@@ -53,8 +114,7 @@ float SystemTimer::DeltaTime()const
 
 void SystemTimer::Reset()
 {
-	__int64 currTime;
-	QueryPerformanceCounter((LARGE_INTEGER*)&currTime);
+	std::int64_t currTime = Now();
 
 	mBaseTime = currTime;
 	mPrevTime = currTime;
@@ -64,8 +124,7 @@ void SystemTimer::Reset()
 
 void SystemTimer::Start()
 {
-	__int64 startTime;
-	QueryPerformanceCounter((LARGE_INTEGER*)&startTime);
+	std::int64_t startTime = Now();
 
 
 	// Accumulate the time elapsed between stop and start pairs.
@@ -88,8 +147,7 @@ void SystemTimer::Stop()
 {
 	if (!mStopped)
 	{
-		__int64 currTime;
-		QueryPerformanceCounter((LARGE_INTEGER*)&currTime);
+		std::int64_t currTime = Now();
 
 		mStopTime = currTime;
 		mStopped = true;
@@ -104,8 +162,7 @@ void SystemTimer::Tick()
 		return;
 	}
 
-	__int64 currTime;
-	QueryPerformanceCounter((LARGE_INTEGER*)&currTime);
+	std::int64_t currTime = Now();
 	mCurrTime = currTime;
 
 	// 当前帧的高频检测次数减去上一帧时高频检测次数乘以高频检测频率可以计算出两帧的时间间隔
@@ -121,4 +178,6 @@ void SystemTimer::Tick()
 	{
 		mDeltaTime = 0.0;
 	}
+
+	mFrameStats.AddFrame(mDeltaTime);
 }
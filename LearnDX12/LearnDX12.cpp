@@ -4,9 +4,22 @@
 #include "framework.h"
 #include "LearnDX12.h"
 #include "Base/Geometry.h"
+#include "Base/D3D12BundleBackend.h"
+#include "Base/D3D12CommandRecorder.h"
+#include "Base/D3D12GpuTimestampBackend.h"
+#include "Base/IndirectDrawRenderer.h"
+#include "Base/StaticBatchRenderer.h"
+#include "Base/VertexLayout.h"
+#include "Mesh/GeometryGenerator.h"
+#include "Render/TransformHierarchy.h"
+#include "Profile/CpuProfiler.h"
+#include "Profile/GpuProfiler.h"
+#include "Profile/RenderCounters.h"
 #include "SystemTimer.h"
 #include "DXRenderDeviceManager.h"
 
+#include <fstream>
+
 #define MAX_LOADSTRING 100
 
 // 全局变量:
@@ -16,11 +29,35 @@ SystemTimer systemTimer;
 WCHAR szTitle[MAX_LOADSTRING];                  // 标题栏文本
 WCHAR szWindowClass[MAX_LOADSTRING];            // 主窗口类名
 std::unique_ptr<Geometry> mBoxGeo = nullptr;
+TransformHierarchy mTransforms;					// 场景物体的变换层级，世界矩阵按深度排序连续存放
+TransformId mBoxTransform = InvalidTransformId;
+AssetPackReader mAssetPack;					// AssetCooker烘焙生成的资源包
+StaticBatchRenderer mStaticScene;				// 合并后的静态物体
+DrawQueue mDrawQueue;							// 每帧的绘制队列，排序后只设置变化的状态
+IndirectDrawRenderer mIndirectDraw;				// 静态物体剔除后每个批次一次ExecuteIndirect
+std::vector<IndirectDrawBucket> mStaticBuckets;
+std::unique_ptr<D3D12BundleBackend> mBundleBackend;
+std::unique_ptr<BundleCache> mStaticBundles;	// 每个静态批次录制一次的Bundle
+std::unique_ptr<D3D12GpuTimestampBackend> mGpuTimestamps;
+std::unique_ptr<GpuProfiler> mGpuProfiler;		// 各Pass的GPU耗时
+// GPU计时结果延迟读取的帧数(Present中每帧都等待GPU完成，2帧后读取时GPU必然已执行完)
+const std::uint32_t GpuProfileFrameLatency = 2;
+
+// 静态物体的绘制方式
+enum class StaticDrawMode
+{
+	DrawQueue,		// 逐单元剔除后加入绘制队列
+	Indirect,		// 剔除后每个批次一次ExecuteIndirect
+	Bundle,			// 不剔除，执行加载后录制的Bundle
+};
+StaticDrawMode mStaticDrawMode = StaticDrawMode::Bundle;
 float mTheta = 1.5f * XM_PI;
 float mPhi = XM_PIDIV4;
 float mRadius = 5.0f;
 
 void UpdateGeometry();
+void CreateStaticScene();
+void DrawScene();
 
 // 此代码模块中包含的函数的前向声明:
 ATOM                MyRegisterClass(HINSTANCE hInstance);
@@ -58,7 +95,16 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 	DXRenderDeviceManager::GetInstance().ResetCommandList();
 
 	mBoxGeo = std::make_unique<Geometry>();
-	mBoxGeo->Initialize();
+	// 存在烘焙好的资源包时从资源包中读取模型及Shader，否则使用默认数据并运行时编译Shader
+	if (mAssetPack.Open("Assets\\Cooked.pak"))
+		mBoxGeo->Initialize(mAssetPack, "box");
+	else
+		mBoxGeo->Initialize();
+	mBoxTransform = mTransforms.Create(MathHelper::Identity4x4());
+	CreateStaticScene();
+	mGpuTimestamps = std::make_unique<D3D12GpuTimestampBackend>(DXRenderDeviceManager::GetInstance().GetD3DDevice(),
+		DXRenderDeviceManager::GetInstance().GetCommandQueue(), DXRenderDeviceManager::GetInstance().GetCommandList());
+	mGpuProfiler = std::make_unique<GpuProfiler>(*mGpuTimestamps, GpuProfileFrameLatency);
 
 	DXRenderDeviceManager::GetInstance().ExecuteCommandQueue();
 
@@ -76,19 +122,52 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 
 			if (msg.message != WM_QUIT)
 			{
-				systemTimer.Tick();
-				DXRenderDeviceManager::GetInstance().Tick(systemTimer);
-				UpdateGeometry();
-				DXRenderDeviceManager::GetInstance().Clear(systemTimer, mBoxGeo ? mBoxGeo->PSO.Get() : nullptr);
+				{
+					CPU_PROFILE_SCOPE("Tick");
+					systemTimer.Tick();
+					DXRenderDeviceManager::GetInstance().Tick(systemTimer);
+				}
+				{
+					CPU_PROFILE_SCOPE("UpdateGeometry");
+					UpdateGeometry();
+				}
+				{
+					CPU_PROFILE_SCOPE("Clear");
+					DXRenderDeviceManager::GetInstance().Clear(systemTimer, mBoxGeo ? mBoxGeo->PSO.Get() : nullptr);
+					mGpuProfiler->BeginFrame();
+				}
 
 				if (mBoxGeo)
-					mBoxGeo->Draw(systemTimer);
-
-				DXRenderDeviceManager::GetInstance().Present(systemTimer);
+				{
+					CPU_PROFILE_SCOPE("Draw");
+					DrawScene();
+				}
+
+				{
+					CPU_PROFILE_SCOPE("Present");
+					mGpuProfiler->EndFrame();
+					DXRenderDeviceManager::GetInstance().Present(systemTimer);
+				}
+				CPU_PROFILE_END_FRAME();
 			}
 		}
 	}
 
+#if CPUPROFILER_ENABLED
+	// 退出时导出最近若干帧的CPU耗时
+	CpuProfiler::GetInstance().WriteChromeTrace("CpuProfile.json");
+#endif
+
+	// 退出时导出帧时间的统计摘要(百分位数、卡顿次数及直方图)及最近各帧的耗时
+	std::ofstream frameStatsJson("FrameStats.json");
+	systemTimer.FrameStats().WriteJson(frameStatsJson);
+	std::ofstream frameStatsCsv("FrameStats.csv");
+	systemTimer.FrameStats().WriteCsv(frameStatsCsv);
+	std::ofstream renderCounters("RenderCounters.txt");
+	RenderCounters::GetInstance().WriteText(renderCounters);
+	std::ofstream gpuTimings("GpuTimings.txt");
+	mGpuProfiler->WriteText(gpuTimings);
+
 	return (int)msg.wParam;
 }
 
@@ -105,7 +184,9 @@ void UpdateGeometry()
 	float y = mRadius * cosf(mPhi);
 
 
-	XMFLOAT4X4 mWorld = MathHelper::Identity4x4();
+	// 只重新计算局部矩阵变化的子树，常量直接从世界矩阵数组读取
+	mTransforms.Update();
+	const XMFLOAT4X4& mWorld = mTransforms.GetWorldMatrices()[mTransforms.GetIndex(mBoxTransform)];
 	XMFLOAT4X4 mView = MathHelper::Identity4x4();
 	XMFLOAT4X4 mProj = MathHelper::Identity4x4();
 	XMMATRIX P = XMMatrixPerspectiveFovLH(0.25f * MathHelper::Pi, 1280.0f/ 768.0f, 1.0f, 1000.0f);
@@ -126,6 +207,94 @@ void UpdateGeometry()
 	mBoxGeo->SetMatrixParameter(worldViewProj);
 }
 
+void CreateStaticScene()
+{
+	// 静态物体与mBoxGeo共用PSO/根签名/常量缓冲区，mBoxGeo的InputLayout需为Vertex格式(资源包中的box需以vertex=float烘焙)
+	if (mBoxGeo == nullptr)
+		return;
+	const auto colorLayout = MakeInputLayout<ColorVertexFormat>();
+	bool sameLayout = mBoxGeo->InputLayout.size() == colorLayout.size();
+	for (std::size_t i = 0; sameLayout && i < colorLayout.size(); ++i)
+		sameLayout = mBoxGeo->InputLayout[i].Format == colorLayout[i].Format && mBoxGeo->InputLayout[i].AlignedByteOffset == colorLayout[i].AlignedByteOffset;
+	if (!sameLayout)
+	{
+		::OutputDebugStringA("static batching: skipped, box vertex format is not ColorVertexFormat (cook box with vertex=float)\n");
+		return;
+	}
+
+	// 立方体周围的地面上摆放的小物体，按空间单元合并
+	std::shared_ptr<const MeshData> meshes[] =
+	{
+		GeometryCache::GetInstance().Get(GeometryDesc::Box(0.5f, 0.5f, 0.5f)),
+		GeometryCache::GetInstance().Get(GeometryDesc::Cylinder(0.2f, 0.15f, 0.6f, 12, 1)),
+		GeometryCache::GetInstance().Get(GeometryDesc::Geosphere(0.25f, 1)),
+	};
+	const int gridSize = 16;
+	std::vector<StaticBatchInstance> instances;
+	for (int i = 0; i < gridSize; ++i)
+	{
+		for (int j = 0; j < gridSize; ++j)
+		{
+			StaticBatchInstance instance;
+			instance.Mesh = meshes[(i + j) % _countof(meshes)].get();
+			XMStoreFloat4x4(&instance.World, XMMatrixRotationY(0.4f * (i * gridSize + j))
+				* XMMatrixTranslation((i - gridSize / 2 + 0.5f) * 1.5f, -1.5f, (j - gridSize / 2 + 0.5f) * 1.5f));
+			instances.push_back(instance);
+		}
+	}
+
+	StaticBatchOptions options;
+	options.CellSize = 6.0f;
+	std::vector<StaticBatch> batches;
+	StaticBatchStats stats;
+	StaticBatcher::Build(instances.data(), instances.size(), options, batches, &stats);
+
+	StaticBatchBinding state;
+	state.PipelineState = ToRenderHandle(mBoxGeo->PSO.Get());
+	state.RootSignature = ToRenderHandle(mBoxGeo->RootSignature.Get());
+	state.DescriptorHeap = ToRenderHandle(mBoxGeo->CBVHeap.Get());
+	state.DescriptorTable = ToRenderHandle(mBoxGeo->CBVHeap->GetGPUDescriptorHandleForHeapStart());
+	mStaticScene.Create(DXRenderDeviceManager::GetInstance().GetD3DDevice(), DXRenderDeviceManager::GetInstance().GetCommandList(),
+		std::move(batches), [&](std::uint64_t) { return state; });
+	mStaticBuckets.clear();
+	mStaticScene.BuildIndirectBuckets(mStaticBuckets);
+
+	// 批次重新创建时Bundle的输入Hash变化，下次绘制时自动重新录制
+	if (mStaticBundles == nullptr)
+	{
+		mBundleBackend = std::make_unique<D3D12BundleBackend>(DXRenderDeviceManager::GetInstance().GetD3DDevice());
+		mStaticBundles = std::make_unique<BundleCache>(*mBundleBackend);
+	}
+
+	char report[128];
+	sprintf_s(report, "static batching: %u draws -> %u draws (%u batches)\n", stats.SourceDrawCount, stats.DrawCount, stats.BatchCount);
+	::OutputDebugStringA(report);
+}
+
+void DrawScene()
+{
+	mDrawQueue.Reset();
+	mBoxGeo->Submit(mDrawQueue);
+
+	// 静态物体的顶点已在世界空间，与mBoxGeo(世界矩阵为单位矩阵)共用WorldViewProj，由其逆矩阵求出的相机位置即世界空间中的相机位置
+	const MeshletCullView view = MeshletCuller::MakeCullView(mBoxGeo->WorldViewProj);
+	if (mStaticDrawMode == StaticDrawMode::DrawQueue)
+		mStaticScene.Submit(mDrawQueue, &view);
+
+	mDrawQueue.Sort();
+	D3D12CommandRecorder recorder(DXRenderDeviceManager::GetInstance().GetCommandList());
+	{
+		GpuProfileScope gpuScope(*mGpuProfiler, "DrawQueue");
+		mDrawQueue.Execute(recorder);
+	}
+
+	GpuProfileScope gpuScope(*mGpuProfiler, "StaticScene");
+	if (mStaticDrawMode == StaticDrawMode::Indirect)
+		mIndirectDraw.Record(DXRenderDeviceManager::GetInstance().GetD3DDevice(), recorder, mStaticBuckets, &view);
+	else if (mStaticDrawMode == StaticDrawMode::Bundle && mStaticBundles != nullptr)
+		mStaticScene.ExecuteBundles(*mStaticBundles, recorder);
+}
+
 //
 //  函数: MyRegisterClass()
 //
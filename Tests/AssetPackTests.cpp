@@ -0,0 +1,353 @@
+﻿#include "TestHarness.h"
+#include "Asset/AssetPack.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// 可重复的伪随机字节
+	std::vector<std::uint8_t> MakeRandomBytes(std::size_t byteSize, std::uint32_t seed)
+	{
+		std::vector<std::uint8_t> bytes(byteSize);
+		for (std::uint8_t& b : bytes)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			b = (std::uint8_t)(seed >> 24);
+		}
+		return bytes;
+	}
+
+	bool LZRoundTrip(const std::vector<std::uint8_t>& data)
+	{
+		const std::vector<std::uint8_t> compressed = AssetCompressLZ(data.data(), data.size());
+		std::vector<std::uint8_t> decompressed(data.size());
+		return AssetDecompressLZ(compressed.data(), compressed.size(), decompressed.data(), decompressed.size())
+			&& decompressed == data;
+	}
+
+	// 顶点为位置 + 法线 + 纹理坐标(32字节)的网格，索引为规则网格的三角形
+	struct TestMesh
+	{
+		std::vector<float> Vertices;
+		std::vector<std::uint16_t> Indices;
+		std::vector<MeshAssetSubset> Subsets;
+		std::vector<MeshAssetMeshlet> Meshlets;
+
+		static const std::uint32_t Stride = 32;
+
+		explicit TestMesh(std::uint32_t side)
+		{
+			for (std::uint32_t z = 0; z < side; ++z)
+			{
+				for (std::uint32_t x = 0; x < side; ++x)
+				{
+					const float v[8] = { (float)x, 0.0f, (float)z, 0.0f, 1.0f, 0.0f, (float)x / side, (float)z / side };
+					Vertices.insert(Vertices.end(), v, v + 8);
+				}
+			}
+			for (std::uint32_t z = 0; z + 1 < side; ++z)
+			{
+				for (std::uint32_t x = 0; x + 1 < side; ++x)
+				{
+					const std::uint16_t i0 = (std::uint16_t)(z * side + x);
+					const std::uint16_t quad[6] = { i0, (std::uint16_t)(i0 + side), (std::uint16_t)(i0 + 1),
+						(std::uint16_t)(i0 + 1), (std::uint16_t)(i0 + side), (std::uint16_t)(i0 + side + 1) };
+					Indices.insert(Indices.end(), quad, quad + 6);
+				}
+			}
+
+			MeshAssetSubset subset;
+			subset.NameHash = AssetNameHash("grid");
+			subset.IndexCount = (std::uint32_t)Indices.size();
+			subset.BoundsExtents[0] = subset.BoundsExtents[2] = 0.5f * side;
+			Subsets.push_back(subset);
+
+			MeshAssetMeshlet meshlet;
+			meshlet.IndexCount = subset.IndexCount;
+			meshlet.Radius = (float)side;
+			Meshlets.push_back(meshlet);
+		}
+
+		std::uint32_t GetVertexCount() const { return (std::uint32_t)(Vertices.size() * sizeof(float) / Stride); }
+
+		bool AddTo(AssetPackBuilder& builder, const std::string& name, MeshDataEncoding encoding, AssetCompression compression) const
+		{
+			return builder.AddMesh(name, Vertices.data(), Stride, GetVertexCount(), 0, Indices.data(), 2, (std::uint32_t)Indices.size(),
+				Subsets, Meshlets, encoding, compression);
+		}
+
+		// 解码后的顶点/索引数据及子集、Meshlet与原始数据一致
+		bool Matches(const MeshAssetView& view) const
+		{
+			if (view.Header->VertexCount != GetVertexCount() || view.Header->VertexByteStride != Stride
+				|| view.Header->IndexCount != Indices.size() || view.Header->IndexByteSize != 2
+				|| view.Header->SubsetCount != Subsets.size() || view.Header->MeshletCount != Meshlets.size())
+				return false;
+
+			std::vector<std::uint8_t> vertices((std::size_t)view.VertexDataByteSize());
+			std::vector<std::uint8_t> indices((std::size_t)view.IndexDataByteSize());
+			return view.DecodeVertexData(vertices.data()) && view.DecodeIndexData(indices.data())
+				&& std::memcmp(vertices.data(), Vertices.data(), vertices.size()) == 0
+				&& std::memcmp(indices.data(), Indices.data(), indices.size()) == 0
+				&& std::memcmp(view.Subsets, Subsets.data(), sizeof(MeshAssetSubset) * Subsets.size()) == 0
+				&& std::memcmp(view.Meshlets, Meshlets.data(), sizeof(MeshAssetMeshlet) * Meshlets.size()) == 0;
+		}
+	};
+
+	// 含多种条目的资源包
+	void BuildTestPack(std::vector<std::uint8_t>& outData, std::size_t extraEntries)
+	{
+		AssetPackBuilder builder;
+		const std::vector<std::uint8_t> random = MakeRandomBytes(4096, 1);
+		builder.AddEntry("random", AssetType::Raw, random.data(), random.size(), AssetCompression::LZ);
+		for (std::size_t i = 0; i < extraEntries; ++i)
+		{
+			const std::string name = "entry" + std::to_string(i);
+			builder.AddEntry(name, AssetType::Raw, name.data(), name.size());
+		}
+		builder.WriteToMemory(outData);
+	}
+}
+
+TEST_CASE(AssetPack, LZRoundTrip)
+{
+	CHECK(LZRoundTrip({}));
+	CHECK(LZRoundTrip({ 42 }));
+	CHECK(LZRoundTrip(MakeRandomBytes(3, 7)));
+	CHECK(LZRoundTrip(MakeRandomBytes(100000, 7)));
+
+	// 长度超过15 + 255的字面量及匹配、与输出重叠的匹配(连续相同字节)
+	std::vector<std::uint8_t> runs(70000, 'a');
+	for (std::size_t i = 0; i < 600; ++i)
+		runs[i] = (std::uint8_t)(i * 7);
+	for (std::size_t i = 30000; i < runs.size(); i += 13)
+		runs[i] = 'b';
+	CHECK(LZRoundTrip(runs));
+	CHECK(AssetCompressLZ(runs.data(), runs.size()).size() < runs.size() / 4);
+
+	// 周期性数据(偏移等于周期的匹配)
+	std::vector<std::uint8_t> periodic(10000);
+	for (std::size_t i = 0; i < periodic.size(); ++i)
+		periodic[i] = (std::uint8_t)(i % 37);
+	CHECK(LZRoundTrip(periodic));
+}
+
+TEST_CASE(AssetPack, LZRejectsCorruptInput)
+{
+	const std::vector<std::uint8_t> data = MakeRandomBytes(5000, 11);
+	const std::vector<std::uint8_t> compressed = AssetCompressLZ(data.data(), data.size());
+	std::vector<std::uint8_t> out(data.size() + 1);
+
+	// 截断的输入、错误的输出大小
+	CHECK(!AssetDecompressLZ(compressed.data(), compressed.size() / 2, out.data(), data.size()));
+	CHECK(!AssetDecompressLZ(compressed.data(), compressed.size(), out.data(), data.size() - 1));
+	CHECK(!AssetDecompressLZ(compressed.data(), compressed.size(), out.data(), data.size() + 1));
+	CHECK(AssetDecompressLZ(compressed.data(), compressed.size(), out.data(), data.size()));
+
+	// 偏移超出已输出的数据
+	const std::uint8_t badOffset[] = { 0x10, 'a', 0x08, 0x00 };
+	CHECK(!AssetDecompressLZ(badOffset, sizeof(badOffset), out.data(), 5));
+}
+
+TEST_CASE(AssetPack, EntriesRoundTrip)
+{
+	AssetPackBuilder builder(64);
+	const std::vector<std::uint8_t> random = MakeRandomBytes(5000, 3);
+	std::string text(100000, 'a');
+	for (std::size_t i = 0; i < text.size(); i += 7)
+		text[i] = 'b';
+
+	CHECK(builder.AddEntry("text", AssetType::Raw, text.data(), text.size(), AssetCompression::LZ));
+	CHECK(builder.AddEntry("random", AssetType::Shader, random.data(), random.size(), AssetCompression::LZ));
+	CHECK(builder.AddEntry("empty", AssetType::Raw, nullptr, 0));
+	for (int i = 0; i < 300; ++i)
+	{
+		const std::string name = "entry" + std::to_string(i);
+		CHECK(builder.AddEntry(name, AssetType::Raw, name.data(), name.size()));
+	}
+	// 同名条目无法区分
+	CHECK(!builder.AddEntry("text", AssetType::Raw, text.data(), 1));
+	CHECK(builder.GetEntryCount() == 303);
+
+	std::vector<std::uint8_t> data;
+	builder.WriteToMemory(data);
+	AssetPackReader reader;
+	REQUIRE(reader.OpenFromMemory(data.data(), data.size()));
+	CHECK(reader.GetEntryCount() == 303);
+
+	std::vector<std::uint8_t> out;
+	const AssetPackEntry* entry = reader.FindEntry("text");
+	REQUIRE(entry != nullptr);
+	CHECK(entry->Compression == AssetCompression::LZ && entry->StoredSize < entry->RawSize);
+	CHECK(reader.GetEntryData(*entry) == nullptr);
+	CHECK(reader.ReadEntry(*entry, out) && std::string(out.begin(), out.end()) == text);
+
+	// 压缩无收益时退化为不压缩
+	entry = reader.FindEntry("random");
+	REQUIRE(entry != nullptr);
+	CHECK(entry->Type == AssetType::Shader && entry->Compression == AssetCompression::None);
+	CHECK(reader.ReadEntry(*entry, out) && out == random);
+
+	entry = reader.FindEntry("empty");
+	REQUIRE(entry != nullptr);
+	CHECK(entry->RawSize == 0 && reader.ReadEntry(*entry, out) && out.empty());
+
+	for (int i = 0; i < 300; ++i)
+	{
+		const std::string name = "entry" + std::to_string(i);
+		entry = reader.FindEntry(name);
+		REQUIRE(entry != nullptr);
+		CHECK(entry->Offset % 64 == 0);
+		CHECK(std::memcmp(reader.GetEntryData(*entry), name.data(), name.size()) == 0);
+	}
+	CHECK(reader.FindEntry("missing") == nullptr);
+}
+
+TEST_CASE(AssetPack, MeshPayloadRoundTrip)
+{
+	const TestMesh mesh(40);
+	AssetPackBuilder builder;
+	CHECK(mesh.AddTo(builder, "plain", MeshDataEncoding::None, AssetCompression::None));
+	CHECK(mesh.AddTo(builder, "codec", MeshDataEncoding::Codec, AssetCompression::None));
+	CHECK(mesh.AddTo(builder, "lz", MeshDataEncoding::None, AssetCompression::LZ));
+
+	std::vector<std::uint8_t> data;
+	builder.WriteToMemory(data);
+	AssetPackReader reader;
+	REQUIRE(reader.OpenFromMemory(data.data(), data.size()));
+
+	// 未编码时顶点/索引数据可直接上传，并按负载对齐
+	MeshAssetView view;
+	REQUIRE(reader.FindMesh("plain", view));
+	CHECK(!view.IsVertexDataEncoded() && !view.IsIndexDataEncoded());
+	CHECK((std::uintptr_t)view.VertexData % ASSETPACK_DEFAULT_ALIGNMENT == (std::uintptr_t)data.data() % ASSETPACK_DEFAULT_ALIGNMENT);
+	CHECK(std::memcmp(view.IndexData, mesh.Indices.data(), mesh.Indices.size() * 2) == 0);
+	CHECK(mesh.Matches(view));
+
+	REQUIRE(reader.FindMesh("codec", view));
+	CHECK(view.IsVertexDataEncoded() && view.IsIndexDataEncoded());
+	CHECK(view.Header->VertexDataStoredSize + view.Header->IndexDataStoredSize < view.VertexDataByteSize() + view.IndexDataByteSize());
+	CHECK(mesh.Matches(view));
+
+	// 压缩的Mesh条目需先解压再解析
+	const AssetPackEntry* entry = reader.FindEntry("lz");
+	REQUIRE(entry != nullptr);
+	CHECK(entry->Compression == AssetCompression::LZ);
+	CHECK(!reader.FindMesh("lz", view));
+	std::vector<std::uint8_t> payload;
+	REQUIRE(reader.ReadEntry(*entry, payload));
+	REQUIRE(AssetPackReader::ParseMeshPayload(payload.data(), payload.size(), view));
+	CHECK(mesh.Matches(view));
+
+	// 截断的负载
+	CHECK(!AssetPackReader::ParseMeshPayload(payload.data(), payload.size() - 1, view));
+}
+
+TEST_CASE(AssetPack, CodecDecidedPerStream)
+{
+	// 盒子的8个顶点(只有位置)编码后变大，保持原样；36个索引编码后变小
+	const float positions[8][3] = { { -1, -1, -1 }, { -1, 1, -1 }, { 1, 1, -1 }, { 1, -1, -1 }, { -1, -1, 1 }, { -1, 1, 1 }, { 1, 1, 1 }, { 1, -1, 1 } };
+	const std::uint16_t indices[36] = { 0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6, 4, 5, 1, 4, 1, 0, 3, 2, 6, 3, 6, 7, 1, 5, 6, 1, 6, 2, 4, 0, 3, 4, 3, 7 };
+	std::vector<std::uint8_t> payload;
+	REQUIRE(AssetPackBuilder::BuildMeshPayload(payload, positions, 12, 8, 0, indices, 2, 36, {}, {}, MeshDataEncoding::Codec));
+
+	MeshAssetView view;
+	REQUIRE(AssetPackReader::ParseMeshPayload(payload.data(), payload.size(), view));
+	CHECK(!view.IsVertexDataEncoded() && view.Header->VertexDataStoredSize == sizeof(positions));
+	CHECK(std::memcmp(view.VertexData, positions, sizeof(positions)) == 0);
+	CHECK(view.IsIndexDataEncoded() && view.Header->IndexDataStoredSize < sizeof(indices));
+
+	std::uint8_t vertices[sizeof(positions)];
+	std::uint16_t decoded[36];
+	CHECK(view.DecodeVertexData(vertices) && std::memcmp(vertices, positions, sizeof(positions)) == 0);
+	REQUIRE(view.DecodeIndexData(decoded));
+	// 三角形可能被旋转，比较每个三角形旋转到最小顶点在前后的结果
+	for (std::size_t t = 0; t < 36; t += 3)
+	{
+		auto normalize = [](const std::uint16_t* tri)
+		{
+			const std::size_t first = tri[0] <= tri[1] && tri[0] <= tri[2] ? 0 : (tri[1] <= tri[2] ? 1 : 2);
+			return (std::uint64_t)tri[first] << 32 | (std::uint64_t)tri[(first + 1) % 3] << 16 | tri[(first + 2) % 3];
+		};
+		CHECK(normalize(decoded + t) == normalize(indices + t));
+	}
+
+	// 索引无法编码(不是三角形列表)时顶点仍可单独编码
+	std::vector<float> grid(3 * 1024);
+	for (std::size_t i = 0; i < 1024; ++i)
+	{
+		grid[i * 3] = (float)(i % 32);
+		grid[i * 3 + 2] = (float)(i / 32);
+	}
+	REQUIRE(AssetPackBuilder::BuildMeshPayload(payload, grid.data(), 12, 1024, 0, indices, 2, 35, {}, {}, MeshDataEncoding::Codec));
+	REQUIRE(AssetPackReader::ParseMeshPayload(payload.data(), payload.size(), view));
+	CHECK(view.IsVertexDataEncoded() && !view.IsIndexDataEncoded());
+	std::vector<float> decodedGrid(grid.size());
+	CHECK(view.DecodeVertexData(decodedGrid.data()) && decodedGrid == grid);
+}
+
+TEST_CASE(AssetPack, FileRoundTrip)
+{
+	const std::string filename = (std::filesystem::temp_directory_path() / "AssetPackTests.pak").string();
+	const TestMesh mesh(16);
+	AssetPackBuilder builder;
+	CHECK(mesh.AddTo(builder, "mesh", MeshDataEncoding::Codec, AssetCompression::None));
+	REQUIRE(builder.WriteToFile(filename));
+
+	{
+		AssetPackReader reader;
+		REQUIRE(reader.Open(filename));
+		MeshAssetView view;
+		REQUIRE(reader.FindMesh("mesh", view));
+		CHECK(mesh.Matches(view));
+		reader.Close();
+		CHECK(!reader.IsOpen() && reader.FindEntry("mesh") == nullptr);
+	}
+	std::remove(filename.c_str());
+
+	AssetPackReader reader;
+	CHECK(!reader.Open(filename));
+}
+
+TEST_CASE(AssetPack, RejectsCorruptPack)
+{
+	std::vector<std::uint8_t> data;
+	BuildTestPack(data, 20);
+	AssetPackReader reader;
+	REQUIRE(reader.OpenFromMemory(data.data(), data.size()));
+	reader.Close();
+
+	AssetPackHeader header;
+	std::memcpy(&header, data.data(), sizeof(header));
+	REQUIRE(header.BucketCount >= 4);
+
+	auto openModified = [&](std::size_t offset, std::uint32_t value)
+	{
+		std::vector<std::uint8_t> copy = data;
+		std::memcpy(copy.data() + offset, &value, sizeof(value));
+		AssetPackReader corrupt;
+		return corrupt.OpenFromMemory(copy.data(), copy.size());
+	};
+
+	// 文件头
+	CHECK(!reader.OpenFromMemory(data.data(), sizeof(AssetPackHeader) - 1));
+	CHECK(!reader.OpenFromMemory(data.data(), data.size() - 1));
+	CHECK(!openModified(offsetof(AssetPackHeader, Magic), 0));
+	CHECK(!openModified(offsetof(AssetPackHeader, Version), ASSETPACK_VERSION + 1));
+	CHECK(!openModified(offsetof(AssetPackHeader, BucketCount), header.BucketCount - 1));
+
+	// 桶的起始下标必须单调不减且不超过条目数
+	const std::size_t bucketTable = sizeof(AssetPackHeader);
+	CHECK(!openModified(bucketTable + sizeof(std::uint32_t) * 2, header.EntryCount + 5));
+	CHECK(!openModified(bucketTable + sizeof(std::uint32_t) * 2, 0xFFFFFFFFu));
+	CHECK(!openModified(bucketTable, 1));
+	CHECK(!openModified(bucketTable + sizeof(std::uint32_t) * header.BucketCount, header.EntryCount + 1));
+
+	// 条目的负载超出文件
+	const std::size_t firstEntry = (std::size_t)header.EntryTableOffset;
+	CHECK(!openModified(firstEntry + offsetof(AssetPackEntry, Offset), (std::uint32_t)data.size()));
+}
@@ -0,0 +1,229 @@
+﻿#include "TestHarness.h"
+#include "Render/BundleCache.h"
+#include "Render/CommandRecorder.h"
+#include "Render/DrawQueue.h"
+#include <vector>
+
+namespace
+{
+	// 期望的一条命令，只比较类型、句柄及前两个参数
+	struct ExpectedCommand
+	{
+		RecordedCommandType Type;
+		RenderHandle Handle;
+		std::uint32_t Arg0;
+		std::uint32_t Arg1;
+	};
+
+	bool MatchesStream(const HeadlessCommandRecorder& recorder, const std::vector<ExpectedCommand>& expected)
+	{
+		const std::vector<RecordedCommand>& commands = recorder.GetCommands();
+		if (commands.size() != expected.size())
+			return false;
+		for (std::size_t i = 0; i < commands.size(); ++i)
+		{
+			const RecordedCommand& c = commands[i];
+			const ExpectedCommand& e = expected[i];
+			if (c.Type != e.Type || c.Handle != e.Handle || c.Args[0] != e.Arg0 || c.Args[1] != e.Arg1)
+				return false;
+		}
+		return true;
+	}
+
+	bool SameStream(const HeadlessCommandRecorder& a, const HeadlessCommandRecorder& b)
+	{
+		const std::vector<RecordedCommand>& x = a.GetCommands();
+		const std::vector<RecordedCommand>& y = b.GetCommands();
+		if (x.size() != y.size())
+			return false;
+		for (std::size_t i = 0; i < x.size(); ++i)
+		{
+			if (x[i].Type != y[i].Type || x[i].Handle != y[i].Handle)
+				return false;
+			for (std::size_t k = 0; k < 5; ++k)
+			{
+				if (x[i].Args[k] != y[i].Args[k])
+					return false;
+			}
+		}
+		return true;
+	}
+
+	DrawPacket MakePacket(RenderHandle pipelineState, RenderHandle descriptorTable, RenderHandle vertexBuffer, std::uint32_t indexCount)
+	{
+		DrawPacket packet;
+		packet.PipelineState = pipelineState;
+		packet.RootSignature = 0x1000;
+		packet.DescriptorHeap = 0x2000;
+		packet.DescriptorTable = descriptorTable;
+		packet.VertexBuffer.BufferLocation = vertexBuffer;
+		packet.VertexBuffer.SizeInBytes = 0x100;
+		packet.VertexBuffer.StrideInBytes = 28;
+		packet.IndexBuffer.BufferLocation = vertexBuffer + 0x100000;
+		packet.IndexBuffer.SizeInBytes = 0x80;
+		packet.IndexCount = indexCount;
+		return packet;
+	}
+
+	// 3个绘制：PSO相同的两个只有描述符表不同，第三个使用另一个PSO
+	void FillQueue(DrawQueue& queue)
+	{
+		queue.Reset();
+		queue.Add(MakeDrawSortKey(0, 2, 1, 0, 0), MakePacket(0x200, 0x5000, 0x10000, 36));
+		queue.Add(MakeDrawSortKey(0, 1, 1, 0, 5), MakePacket(0x100, 0x5100, 0x10000, 12));
+		queue.Add(MakeDrawSortKey(0, 1, 1, 0, 1), MakePacket(0x100, 0x5000, 0x10000, 24));
+		queue.Sort();
+	}
+
+	void RecordTriangle(CommandRecorder& recorder, RenderHandle pipelineState)
+	{
+		recorder.SetPipelineState(pipelineState);
+		recorder.SetPrimitiveTopology(PrimitiveTopologyTriangleList);
+		recorder.DrawIndexedInstanced(3, 1, 0, 0, 0);
+	}
+}
+
+TEST_CASE(CommandRecorder, HeadlessRecordsArguments)
+{
+	HeadlessCommandRecorder recorder;
+	VertexBufferBinding vertexBuffer;
+	vertexBuffer.BufferLocation = 0x10000;
+	vertexBuffer.SizeInBytes = 280;
+	vertexBuffer.StrideInBytes = 28;
+	recorder.SetVertexBuffer(vertexBuffer);
+	recorder.SetGraphicsRoot32BitConstant(1, 42, 3);
+	recorder.DrawIndexedInstanced(36, 2, 6, -4, 1);
+	recorder.ExecuteIndirect(0x300, 100, 0x400, 256);
+
+	const std::vector<RecordedCommand>& commands = recorder.GetCommands();
+	REQUIRE(commands.size() == 4);
+	CHECK(commands[0].Type == RecordedCommandType::SetVertexBuffer && commands[0].Handle == 0x10000 && commands[0].Args[0] == 280 && commands[0].Args[1] == 28);
+	CHECK(commands[1].Type == RecordedCommandType::SetGraphicsRoot32BitConstant && commands[1].Args[0] == 1 && commands[1].Args[1] == 42 && commands[1].Args[2] == 3);
+	CHECK(commands[2].Type == RecordedCommandType::DrawIndexedInstanced && commands[2].Args[0] == 36 && commands[2].Args[1] == 2
+		&& commands[2].Args[2] == 6 && (std::int32_t)commands[2].Args[3] == -4 && commands[2].Args[4] == 1);
+	CHECK(commands[3].Type == RecordedCommandType::ExecuteIndirect && commands[3].Handle == 0x300 && commands[3].Args[0] == 100);
+	CHECK(recorder.GetCommandCount(RecordedCommandType::DrawIndexedInstanced) == 1);
+	CHECK(recorder.GetStateCommandCount() == 2);
+
+	recorder.Reset();
+	CHECK(recorder.GetCommands().empty() && recorder.GetCommandCount(RecordedCommandType::SetVertexBuffer) == 0);
+}
+
+TEST_CASE(CommandRecorder, DrawQueueRecordsStateDeltas)
+{
+	DrawQueue queue;
+	FillQueue(queue);
+	HeadlessCommandRecorder recorder;
+	DrawQueueStats stats;
+	queue.Execute(recorder, &stats);
+
+	// 按键排序后依次为24/12/36个索引的绘制，只设置与前一次绘制不同的状态
+	const std::vector<ExpectedCommand> expected = {
+		{ RecordedCommandType::SetDescriptorHeap, 0x2000, 0, 0 },
+		{ RecordedCommandType::SetGraphicsRootSignature, 0x1000, 0, 0 },
+		{ RecordedCommandType::SetGraphicsRootDescriptorTable, 0x5000, 0, 0 },
+		{ RecordedCommandType::SetPipelineState, 0x100, 0, 0 },
+		{ RecordedCommandType::SetVertexBuffer, 0x10000, 0x100, 28 },
+		{ RecordedCommandType::SetIndexBuffer, 0x110000, 0x80, 2 },
+		{ RecordedCommandType::SetPrimitiveTopology, 0, PrimitiveTopologyTriangleList, 0 },
+		{ RecordedCommandType::DrawIndexedInstanced, 0, 24, 1 },
+		{ RecordedCommandType::SetGraphicsRootDescriptorTable, 0x5100, 0, 0 },
+		{ RecordedCommandType::DrawIndexedInstanced, 0, 12, 1 },
+		{ RecordedCommandType::SetGraphicsRootDescriptorTable, 0x5000, 0, 0 },
+		{ RecordedCommandType::SetPipelineState, 0x200, 0, 0 },
+		{ RecordedCommandType::DrawIndexedInstanced, 0, 36, 1 },
+	};
+	CHECK(MatchesStream(recorder, expected));
+	CHECK(stats.PacketCount == 3 && stats.StateCallCount == 10 && stats.RedundantStateCallCount == 11);
+}
+
+TEST_CASE(BundleCache, RecordsOnceAndReuses)
+{
+	HeadlessBundleBackend backend;
+	BundleCache cache(backend);
+	int recordCount = 0;
+	auto record = [&](CommandRecorder& bundleRecorder)
+	{
+		++recordCount;
+		RecordTriangle(bundleRecorder, 0x100);
+	};
+
+	const RenderHandle bundle = cache.GetOrRecord(7, 1234, record);
+	CHECK(bundle != 0 && cache.GetOrRecord(7, 1234, record) == bundle);
+	CHECK(recordCount == 1);
+	CHECK(cache.GetStats().RecordCount == 1 && cache.GetStats().ReuseCount == 1);
+
+	const HeadlessCommandRecorder* contents = backend.FindBundle(bundle);
+	REQUIRE(contents != nullptr);
+	const std::vector<ExpectedCommand> expected = {
+		{ RecordedCommandType::SetPipelineState, 0x100, 0, 0 },
+		{ RecordedCommandType::SetPrimitiveTopology, 0, PrimitiveTopologyTriangleList, 0 },
+		{ RecordedCommandType::DrawIndexedInstanced, 0, 3, 1 },
+	};
+	CHECK(MatchesStream(*contents, expected));
+
+	// 执行Bundle时外层命令列表中只有一条命令
+	HeadlessCommandRecorder recorder;
+	recorder.ExecuteBundle(bundle);
+	CHECK(recorder.GetCommands().size() == 1 && recorder.GetCommands()[0].Type == RecordedCommandType::ExecuteBundle
+		&& recorder.GetCommands()[0].Handle == bundle);
+	CHECK(recorder.GetStateCommandCount() == 0);
+}
+
+TEST_CASE(BundleCache, BundleMatchesDirectRecording)
+{
+	DrawQueue queue;
+	FillQueue(queue);
+	HeadlessCommandRecorder direct;
+	queue.Execute(direct);
+
+	HeadlessBundleBackend backend;
+	BundleCache cache(backend);
+	const RenderHandle bundle = cache.GetOrRecord(1, 1, [&](CommandRecorder& bundleRecorder) { queue.Execute(bundleRecorder); });
+	const HeadlessCommandRecorder* contents = backend.FindBundle(bundle);
+	REQUIRE(contents != nullptr);
+	CHECK(SameStream(*contents, direct));
+}
+
+TEST_CASE(BundleCache, InputChangeRerecords)
+{
+	HeadlessBundleBackend backend;
+	BundleCache cache(backend);
+	const RenderHandle first = cache.GetOrRecord(1, 10, [](CommandRecorder& r) { RecordTriangle(r, 0x100); });
+	const RenderHandle other = cache.GetOrRecord(2, 20, [](CommandRecorder& r) { RecordTriangle(r, 0x300); });
+	const RenderHandle second = cache.GetOrRecord(1, 11, [](CommandRecorder& r) { RecordTriangle(r, 0x200); });
+
+	// 只有输入变化的Bundle被重新录制，旧的Bundle被释放
+	CHECK(second != first && backend.FindBundle(first) == nullptr);
+	CHECK(backend.FindBundle(other) != nullptr && backend.GetLiveBundleCount() == 2);
+	REQUIRE(backend.FindBundle(second) != nullptr);
+	CHECK(backend.FindBundle(second)->GetCommands()[0].Handle == 0x200);
+	CHECK(cache.GetStats().RecordCount == 3 && cache.GetStats().ReleaseCount == 1);
+}
+
+TEST_CASE(BundleCache, InvalidateAndClear)
+{
+	HeadlessBundleBackend backend;
+	{
+		BundleCache cache(backend);
+		int recordCount = 0;
+		auto record = [&](CommandRecorder& r)
+		{
+			++recordCount;
+			RecordTriangle(r, 0x100);
+		};
+		const RenderHandle first = cache.GetOrRecord(1, 10, record);
+		cache.Invalidate(1);
+		const RenderHandle second = cache.GetOrRecord(1, 10, record);
+		CHECK(recordCount == 2 && second != first && backend.FindBundle(first) == nullptr);
+
+		cache.Clear();
+		CHECK(cache.GetBundleCount() == 0 && !cache.Contains(1) && backend.GetLiveBundleCount() == 0);
+
+		cache.GetOrRecord(1, 10, record);
+		cache.GetOrRecord(2, 10, record);
+		CHECK(backend.GetLiveBundleCount() == 2);
+	}
+	// 析构时释放所有Bundle
+	CHECK(backend.GetLiveBundleCount() == 0);
+}
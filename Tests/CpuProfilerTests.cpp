@@ -0,0 +1,328 @@
+﻿// 本文件中的CPU_PROFILE_*宏被编译掉，用于检验禁用时不产生事件；其余测试直接使用CpuProfileScope及缓冲区
+#define CPUPROFILER_ENABLED 0
+#include "TestHarness.h"
+#include "Profile/CpuProfiler.h"
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CPUPROFILER_TEST_STRING_INNER(x) #x
+#define CPUPROFILER_TEST_STRING(x) CPUPROFILER_TEST_STRING_INNER(x)
+
+namespace
+{
+	// 收集之前测试留下的事件后清空，每个测试从空的状态开始
+	CpuProfiler& ResetProfiler(std::size_t maxCapturedFrames)
+	{
+		CpuProfiler& profiler = CpuProfiler::GetInstance();
+		profiler.SetMaxCapturedFrames(maxCapturedFrames);
+		profiler.EndFrame();
+		profiler.Clear();
+		return profiler;
+	}
+
+	std::vector<CpuProfileEvent> GetEventsNamed(const CpuProfiler& profiler, const char* name)
+	{
+		std::vector<CpuProfileEvent> events;
+		profiler.GetCapturedEvents(events);
+		std::vector<CpuProfileEvent> named;
+		for (const CpuProfileEvent& event : events)
+		{
+			if (event.Name != nullptr && std::strcmp(event.Name, name) == 0)
+				named.push_back(event);
+		}
+		return named;
+	}
+
+	// 只做语法检查的JSON解析，统计traceEvents数组的元素数量
+	class JsonChecker
+	{
+	public:
+
+		explicit JsonChecker(const std::string& text)
+			: Text(text)
+		{
+		}
+
+		bool	Check()
+		{
+			return ParseValue(0) && (SkipSpace(), Position == Text.size());
+		}
+
+		std::size_t	GetTraceEventCount() const { return TraceEventCount; }
+
+	private:
+
+		void	SkipSpace()
+		{
+			while (Position < Text.size() && (Text[Position] == ' ' || Text[Position] == '\n' || Text[Position] == '\r' || Text[Position] == '\t'))
+				++Position;
+		}
+
+		bool	Consume(char c)
+		{
+			SkipSpace();
+			if (Position >= Text.size() || Text[Position] != c)
+				return false;
+			++Position;
+			return true;
+		}
+
+		bool	ParseString(std::string* outText)
+		{
+			if (!Consume('"'))
+				return false;
+			while (Position < Text.size())
+			{
+				const char c = Text[Position++];
+				if (c == '"')
+					return true;
+				if ((unsigned char)c < 0x20)
+					return false;
+				if (c == '\\')
+				{
+					if (Position >= Text.size() || std::strchr("\"\\/bfnrtu", Text[Position]) == nullptr)
+						return false;
+					// \u后的4位十六进制数不做检查
+					if (outText)
+						outText->push_back(Text[Position]);
+					++Position;
+				}
+				else if (outText)
+				{
+					outText->push_back(c);
+				}
+			}
+			return false;
+		}
+
+		bool	ParseNumber()
+		{
+			const std::size_t begin = Position;
+			if (Position < Text.size() && Text[Position] == '-')
+				++Position;
+			auto digits = [&]()
+			{
+				const std::size_t start = Position;
+				while (Position < Text.size() && Text[Position] >= '0' && Text[Position] <= '9')
+					++Position;
+				return Position > start;
+			};
+			if (!digits())
+				return false;
+			if (Position < Text.size() && Text[Position] == '.')
+			{
+				++Position;
+				if (!digits())
+					return false;
+			}
+			if (Position < Text.size() && (Text[Position] == 'e' || Text[Position] == 'E'))
+			{
+				++Position;
+				if (Position < Text.size() && (Text[Position] == '+' || Text[Position] == '-'))
+					++Position;
+				if (!digits())
+					return false;
+			}
+			return Position > begin;
+		}
+
+		bool	ParseValue(int depth)
+		{
+			SkipSpace();
+			if (Position >= Text.size() || depth > 16)
+				return false;
+			const char c = Text[Position];
+			if (c == '"')
+				return ParseString(nullptr);
+			if (c == '{')
+			{
+				++Position;
+				if (Consume('}'))
+					return true;
+				do
+				{
+					std::string key;
+					SkipSpace();
+					if (!ParseString(&key) || !Consume(':'))
+						return false;
+					if (key == "traceEvents" && depth == 0)
+					{
+						if (!ParseArray(depth + 1, &TraceEventCount))
+							return false;
+					}
+					else if (!ParseValue(depth + 1))
+					{
+						return false;
+					}
+				} while (Consume(','));
+				return Consume('}');
+			}
+			if (c == '[')
+				return ParseArray(depth, nullptr);
+			for (const char* literal : { "true", "false", "null" })
+			{
+				if (Text.compare(Position, std::strlen(literal), literal) == 0)
+				{
+					Position += std::strlen(literal);
+					return true;
+				}
+			}
+			return ParseNumber();
+		}
+
+		bool	ParseArray(int depth, std::size_t* outCount)
+		{
+			if (!Consume('['))
+				return false;
+			if (Consume(']'))
+				return true;
+			std::size_t count = 0;
+			do
+			{
+				if (!ParseValue(depth + 1))
+					return false;
+				++count;
+			} while (Consume(','));
+			if (outCount)
+				*outCount = count;
+			return Consume(']');
+		}
+
+		const std::string& Text;
+		std::size_t Position = 0;
+		std::size_t TraceEventCount = 0;
+	};
+}
+
+TEST_CASE(CpuProfiler, ScopesCollectedAtFrameEnd)
+{
+	CpuProfiler& profiler = ResetProfiler(8);
+	{
+		CpuProfileScope outer("Outer");
+		CpuProfileScope inner("Inner");
+	}
+	profiler.EndFrame();
+	profiler.EndFrame();
+	CHECK(profiler.GetCapturedFrameCount() == 2);
+
+	// 内层先结束先写入，外层包含内层
+	std::vector<CpuProfileEvent> events;
+	profiler.GetCapturedEvents(events);
+	REQUIRE(events.size() == 2);
+	CHECK(std::strcmp(events[0].Name, "Inner") == 0 && std::strcmp(events[1].Name, "Outer") == 0);
+	CHECK(events[1].Begin <= events[0].Begin && events[0].End <= events[1].End);
+	CHECK(profiler.GetDroppedEventCount() == 0);
+
+	// 超出保留帧数时丢弃最早的帧
+	profiler.SetMaxCapturedFrames(1);
+	CHECK(profiler.GetCapturedFrameCount() == 1);
+	profiler.GetCapturedEvents(events);
+	CHECK(events.empty());
+}
+
+TEST_CASE(CpuProfiler, CompiledOutMacrosRecordNothing)
+{
+	CpuProfiler& profiler = ResetProfiler(8);
+	CHECK(std::string(CPUPROFILER_TEST_STRING(CPU_PROFILE_SCOPE("Disabled"))) == "((void)0)");
+	CHECK(std::string(CPUPROFILER_TEST_STRING(CPU_PROFILE_END_FRAME())) == "((void)0)");
+
+	for (int i = 0; i < 100; ++i)
+	{
+		CPU_PROFILE_SCOPE("Disabled");
+	}
+	CPU_PROFILE_END_FRAME();
+	CHECK(profiler.GetCapturedFrameCount() == 0);
+
+	profiler.EndFrame();
+	std::vector<CpuProfileEvent> events;
+	profiler.GetCapturedEvents(events);
+	CHECK(events.empty());
+}
+
+TEST_CASE(CpuProfiler, OverflowCountsDroppedEvents)
+{
+	CpuProfiler& profiler = ResetProfiler(8);
+
+	// 在新线程中写入超过缓冲区容量的事件后才收集，最早的事件被覆盖
+	const std::uint64_t emitted = 2 * CpuProfileThreadBuffer::Capacity + 123;
+	std::thread producer([&]()
+	{
+		CpuProfileThreadBuffer& buffer = CpuProfiler::GetThreadBuffer();
+		for (std::uint64_t i = 0; i < emitted; ++i)
+			buffer.Push("Overflow", i, i + 1);
+	});
+	producer.join();
+	profiler.EndFrame();
+
+	const std::vector<CpuProfileEvent> events = GetEventsNamed(profiler, "Overflow");
+	CHECK(events.size() + profiler.GetDroppedEventCount() == emitted);
+	// 与正在写入的位置相同的一个记录也被丢弃，保留的是最近的事件
+	CHECK(events.size() + 1 >= CpuProfileThreadBuffer::Capacity && events.size() <= CpuProfileThreadBuffer::Capacity);
+	REQUIRE(!events.empty());
+	CHECK(events.back().Begin == emitted - 1);
+}
+
+TEST_CASE(CpuProfiler, ConcurrentProducerNeverLosesCount)
+{
+	CpuProfiler& profiler = ResetProfiler(1 << 20);
+
+	// 写入的同时不断收集：所有事件要么被收集要么计为丢弃，收集到的事件没有被部分覆盖
+	const std::uint64_t emitted = 1 << 19;
+	std::atomic<bool> done{ false };
+	std::thread producer([&]()
+	{
+		CpuProfileThreadBuffer& buffer = CpuProfiler::GetThreadBuffer();
+		for (std::uint64_t i = 0; i < emitted; ++i)
+			buffer.Push("Concurrent", i, 2 * i + 1);
+		done.store(true);
+	});
+	while (!done.load())
+		profiler.EndFrame();
+	producer.join();
+	profiler.EndFrame();
+
+	const std::vector<CpuProfileEvent> events = GetEventsNamed(profiler, "Concurrent");
+	CHECK(events.size() + profiler.GetDroppedEventCount() == emitted);
+	bool intact = true;
+	bool ordered = true;
+	for (std::size_t i = 0; i < events.size(); ++i)
+	{
+		intact = intact && events[i].End == 2 * events[i].Begin + 1;
+		ordered = ordered && (i == 0 || events[i].Begin > events[i - 1].Begin);
+	}
+	CHECK(intact);
+	CHECK(ordered);
+	profiler.SetMaxCapturedFrames(300);
+}
+
+TEST_CASE(CpuProfiler, ChromeTraceIsValidJson)
+{
+	CpuProfiler& profiler = ResetProfiler(8);
+
+	// 名称中的引号、反斜杠及控制字符需要转义或替换
+	const char* names[] = { "Plain", "Quote\"d", "Back\\slash", "Line\nbreak\tand\x01" };
+	for (int frame = 0; frame < 3; ++frame)
+	{
+		for (const char* name : names)
+			CpuProfileScope scope(name);
+		profiler.EndFrame();
+	}
+
+	std::ostringstream stream;
+	profiler.WriteChromeTrace(stream);
+	const std::string text = stream.str();
+	JsonChecker checker(text);
+	CHECK(checker.Check());
+	// 每帧4个事件及1个Frame事件
+	CHECK(checker.GetTraceEventCount() == 3 * 4 + 3);
+	CHECK(text.find("\"name\":\"Quote\\\"d\"") != std::string::npos);
+	CHECK(text.find("\"name\":\"Back\\\\slash\"") != std::string::npos);
+	CHECK(text.find("\"ph\":\"X\"") != std::string::npos);
+
+	// 检查器本身能识别错误
+	CHECK(!JsonChecker("{\"traceEvents\":[{\"name\":\"a\nb\"}]}").Check());
+	CHECK(!JsonChecker("{\"traceEvents\":[{},]}").Check());
+}
@@ -0,0 +1,158 @@
+﻿#include "TestHarness.h"
+#include "FrameTimeStats.h"
+#include "SystemTimer.h"
+#include <cmath>
+#include <sstream>
+#include <string>
+
+namespace
+{
+	bool Near(double value, double expected, double relativeError)
+	{
+		return std::fabs(value - expected) <= expected * relativeError;
+	}
+
+	std::size_t CountLines(const std::string& text)
+	{
+		std::size_t lines = 0;
+		for (char c : text)
+			lines += c == '\n' ? 1 : 0;
+		return lines;
+	}
+}
+
+TEST_CASE(FrameTimeStats, BucketBounds)
+{
+	// 相邻区间首尾相接，每个值落在自己区间的上下界之内，区间宽度不超过下界的1/32
+	bool contiguous = true;
+	for (std::size_t i = 0; i + 1 < FrameTimeStats::GetBucketIndex(1ull << 31); ++i)
+		contiguous = contiguous && FrameTimeStats::GetBucketUpperBound(i) + 1 == FrameTimeStats::GetBucketLowerBound(i + 1);
+	CHECK(contiguous);
+
+	bool contained = true;
+	bool narrow = true;
+	std::uint32_t state = 5;
+	for (std::uint64_t i = 0; i < 200000; ++i)
+	{
+		state = state * 1664525u + 1013904223u;
+		const std::uint64_t value = i < 10000 ? i : (std::uint64_t)state >> (state & 15);
+		const std::size_t index = FrameTimeStats::GetBucketIndex(value);
+		const std::uint64_t lower = FrameTimeStats::GetBucketLowerBound(index);
+		const std::uint64_t upper = FrameTimeStats::GetBucketUpperBound(index);
+		contained = contained && lower <= value && value <= upper;
+		narrow = narrow && (value < 64 || (upper - lower + 1) * 32 <= lower);
+	}
+	CHECK(contained);
+	CHECK(narrow);
+
+	// 小于64微秒时精确
+	CHECK(FrameTimeStats::GetBucketIndex(63) == 63 && FrameTimeStats::GetBucketLowerBound(63) == 63 && FrameTimeStats::GetBucketUpperBound(63) == 63);
+
+	// 超出范围的值落在最后一个区间
+	const std::size_t last = FrameTimeStats::GetBucketIndex(~0ull);
+	CHECK(FrameTimeStats::GetBucketIndex(1ull << 40) == last);
+	CHECK(FrameTimeStats::GetBucketUpperBound(last) == (1ull << FrameTimeStats::MaxMagnitude) - 1);
+}
+
+TEST_CASE(FrameTimeStats, Percentiles)
+{
+	// 1~100毫秒各一帧(乱序加入)
+	FrameTimeStats stats;
+	for (int i = 0; i < 100; ++i)
+		stats.AddFrame((double)((i * 37) % 100 + 1) / 1000.0);
+
+	const FrameTimeSummary summary = stats.GetSummary();
+	CHECK(summary.FrameCount == 100);
+	CHECK(summary.MinMilliseconds == 1.0 && summary.MaxMilliseconds == 100.0);
+	CHECK(Near(summary.MeanMilliseconds, 50.5, 1e-9));
+	CHECK(Near(summary.P50Milliseconds, 50.0, 0.03));
+	CHECK(Near(summary.P95Milliseconds, 95.0, 0.03));
+	CHECK(Near(summary.P99Milliseconds, 99.0, 0.03));
+	// 区间中点限制在记录的最小/最大值之间
+	CHECK(stats.GetPercentileMilliseconds(0.0) == 1.0 && Near(stats.GetPercentileMilliseconds(1.0), 100.0, 0.03));
+	CHECK(stats.GetPercentileMilliseconds(1.0) <= 100.0);
+
+	// 值的往返：所有帧相同时百分位数即为该值
+	FrameTimeStats single;
+	for (int i = 0; i < 10; ++i)
+		single.AddFrame(0.0166667);
+	CHECK(single.GetPercentileMilliseconds(0.5) == single.GetSummary().MinMilliseconds);
+	CHECK(Near(single.GetPercentileMilliseconds(0.99), 16.6667, 1e-4));
+
+	FrameTimeStats empty;
+	CHECK(empty.GetPercentileMilliseconds(0.5) == 0.0);
+}
+
+TEST_CASE(FrameTimeStats, HitchesAgainstRollingMedian)
+{
+	FrameTimeStatsOptions options;
+	options.HistorySize = 64;
+	options.MedianWindow = 31;
+	FrameTimeStats stats(options);
+
+	// 16ms左右抖动的帧中注入卡顿：启动时的卡顿(窗口未达到一半)及未超过阈值的波动不计
+	std::size_t expectedHitches = 0;
+	for (int frame = 0; frame < 200; ++frame)
+	{
+		double milliseconds = 16.0 + (frame % 5) * 0.5;
+		bool spike = false;
+		if (frame == 3)
+			milliseconds = 100.0;
+		else if (frame % 40 == 20)
+		{
+			milliseconds = 45.0;
+			spike = true;
+		}
+		else if (frame % 40 == 30)
+			milliseconds = 25.0;
+
+		const bool hitch = stats.AddFrame(milliseconds / 1000.0);
+		CHECK(hitch == spike);
+		expectedHitches += spike ? 1 : 0;
+	}
+	CHECK(stats.GetHitchCount() == expectedHitches && expectedHitches == 5);
+	CHECK(Near(stats.GetRollingMedianMilliseconds(), 17.0, 0.05));
+
+	// 环形缓冲区只保留最近64帧，卡顿标记与帧对应(第180帧为卡顿)
+	CHECK(stats.GetHistoryCount() == 64);
+	CHECK(stats.IsHistoryHitch(180 - 136) && Near(stats.GetHistoryMilliseconds(180 - 136), 45.0, 1e-6));
+
+	std::ostringstream csv;
+	stats.WriteCsv(csv);
+	CHECK(CountLines(csv.str()) == 65);
+	CHECK(csv.str().find("frame,ms,hitch\n136,") == 0);
+	CHECK(csv.str().find("\n180,45,1\n") != std::string::npos);
+
+	std::ostringstream json;
+	stats.WriteJson(json);
+	CHECK(json.str().find("{\"frames\":200,\"hitches\":5,") == 0);
+	CHECK(json.str().find("\"histogram\":[{\"lower_us\":") != std::string::npos);
+}
+
+TEST_CASE(FrameTimeStats, TimerSkipsPausedTicks)
+{
+	ManualClock clock;
+	SystemTimer timer(clock);
+	timer.Reset();
+	for (int i = 0; i < 10; ++i)
+	{
+		clock.Advance(0.016);
+		timer.Tick();
+	}
+
+	// 暂停期间的Tick不记录，恢复后的第一帧不包括暂停的时间
+	timer.Stop();
+	clock.Advance(5.0);
+	timer.Tick();
+	CHECK(timer.DeltaTime() == 0.0f);
+	clock.Advance(5.0);
+	timer.Start();
+	clock.Advance(0.016);
+	timer.Tick();
+
+	const FrameTimeSummary summary = timer.FrameStats().GetSummary();
+	CHECK(summary.FrameCount == 11);
+	CHECK(Near(summary.MaxMilliseconds, 16.0, 1e-6) && Near(summary.MinMilliseconds, 16.0, 1e-6));
+	CHECK(Near(timer.DeltaTime(), 0.016, 1e-6));
+	CHECK(Near(timer.TotalTime(), 0.176, 1e-5));
+}
@@ -0,0 +1,164 @@
+﻿#include "TestHarness.h"
+#include "Profile/GpuProfiler.h"
+#include <sstream>
+#include <string>
+
+namespace
+{
+	// 每秒1000个计数，1个计数即1毫秒
+	const std::uint64_t TicksPerSecond = 1000;
+
+	// 耗时frameTicks个计数且没有Pass的一帧，结束后GPU立即执行完
+	void RunEmptyFrame(GpuProfiler& profiler, HeadlessGpuTimestampBackend& backend, std::uint64_t frameTicks)
+	{
+		profiler.BeginFrame();
+		backend.AdvanceTicks(frameTicks);
+		profiler.EndFrame();
+		backend.CompleteGpuWork();
+	}
+}
+
+TEST_CASE(GpuProfiler, TimestampPairing)
+{
+	HeadlessGpuTimestampBackend backend(TicksPerSecond);
+	GpuProfiler profiler(backend, 1, 4);
+	CHECK(backend.GetQueryCount() == 10);
+
+	profiler.BeginFrame();
+	backend.AdvanceTicks(1);
+	const std::uint32_t shadow = profiler.BeginScope("Shadow");
+	backend.AdvanceTicks(2);
+	profiler.EndScope(shadow);
+	const std::uint32_t opaque = profiler.BeginScope("Opaque");
+	backend.AdvanceTicks(5);
+	profiler.EndScope(opaque);
+	backend.AdvanceTicks(1);
+	profiler.EndFrame();
+	backend.CompleteGpuWork();
+	CHECK(backend.GetWriteCount() == 6);
+
+	// 下一帧开始时读取上一帧的结果，每个Pass使用自己的开始/结束时间戳
+	CHECK(!profiler.HasResults());
+	profiler.BeginFrame();
+	REQUIRE(profiler.HasResults());
+	const GpuFrameTimings& frame = profiler.GetLastFrame();
+	CHECK(frame.FrameIndex == 0 && frame.FrameMilliseconds == 9.0);
+	REQUIRE(frame.Passes.size() == 2);
+	CHECK(std::string(frame.Passes[0].Name) == "Shadow" && frame.Passes[0].Milliseconds == 2.0 && frame.Passes[0].Depth == 0);
+	CHECK(std::string(frame.Passes[1].Name) == "Opaque" && frame.Passes[1].Milliseconds == 5.0 && frame.Passes[1].Depth == 0);
+	profiler.EndFrame();
+	CHECK(backend.GetStaleReadCount() == 0);
+}
+
+TEST_CASE(GpuProfiler, NestedScopes)
+{
+	HeadlessGpuTimestampBackend backend(TicksPerSecond);
+	GpuProfiler profiler(backend, 1, 8);
+
+	profiler.BeginFrame();
+	{
+		GpuProfileScope scene(profiler, "Scene");
+		backend.AdvanceTicks(1);
+		{
+			GpuProfileScope opaque(profiler, "Draw");
+			backend.AdvanceTicks(4);
+		}
+		{
+			GpuProfileScope transparent(profiler, "Draw");
+			backend.AdvanceTicks(2);
+			GpuProfileScope particles(profiler, "Particles");
+			backend.AdvanceTicks(3);
+		}
+	}
+	// 未结束的Scope在EndFrame时结束
+	profiler.BeginScope("Post");
+	backend.AdvanceTicks(6);
+	profiler.EndFrame();
+	backend.CompleteGpuWork();
+	profiler.BeginFrame();
+
+	REQUIRE(profiler.HasResults());
+	const GpuFrameTimings& frame = profiler.GetLastFrame();
+	REQUIRE(frame.Passes.size() == 5);
+	const std::uint32_t depths[] = { 0, 1, 1, 2, 0 };
+	const double milliseconds[] = { 10.0, 4.0, 5.0, 3.0, 6.0 };
+	for (std::size_t i = 0; i < 5; ++i)
+		CHECK(frame.Passes[i].Depth == depths[i] && frame.Passes[i].Milliseconds == milliseconds[i]);
+	CHECK(frame.FrameMilliseconds == 16.0);
+	CHECK(profiler.GetPassMilliseconds("Draw") == 9.0);
+	CHECK(profiler.GetPassMilliseconds("Missing") == 0.0);
+
+	std::ostringstream text;
+	profiler.WriteText(text);
+	CHECK(text.str().find("      Particles") != std::string::npos);
+}
+
+TEST_CASE(GpuProfiler, FrameLatencyReadback)
+{
+	HeadlessGpuTimestampBackend backend(TicksPerSecond);
+	const std::uint32_t framesInFlight = 3;
+	GpuProfiler profiler(backend, framesInFlight, 2);
+	CHECK(profiler.GetFrameLatency() == framesInFlight);
+
+	// 第N帧开始时读取第N - framesInFlight帧的结果，每帧耗时不同以区分
+	for (std::uint64_t frame = 0; frame < 10; ++frame)
+	{
+		profiler.BeginFrame();
+		if (frame < framesInFlight)
+		{
+			CHECK(!profiler.HasResults());
+		}
+		else
+		{
+			CHECK(profiler.HasResults() && profiler.GetLastFrame().FrameIndex == frame - framesInFlight);
+			CHECK(profiler.GetLastFrame().FrameMilliseconds == (double)(frame - framesInFlight + 1));
+		}
+		backend.AdvanceTicks(frame + 1);
+		profiler.EndFrame();
+		backend.CompleteGpuWork();
+	}
+	CHECK(backend.GetReadCount() == 10 - framesInFlight);
+	CHECK(backend.GetStaleReadCount() == 0);
+	CHECK(profiler.GetFrameIndex() == 10);
+}
+
+TEST_CASE(GpuProfiler, ReadBeforeGpuCompletesIsStale)
+{
+	HeadlessGpuTimestampBackend backend(TicksPerSecond);
+	GpuProfiler profiler(backend, 1, 2);
+	profiler.BeginFrame();
+	backend.AdvanceTicks(3);
+	profiler.EndFrame();
+
+	// 只有1帧在途时，GPU未执行完上一帧就开始下一帧会读到未解析的数据
+	profiler.BeginFrame();
+	CHECK(backend.GetStaleReadCount() == 1);
+	profiler.EndFrame();
+	backend.CompleteGpuWork();
+	RunEmptyFrame(profiler, backend, 2);
+	CHECK(backend.GetStaleReadCount() == 1);
+}
+
+TEST_CASE(GpuProfiler, DropsScopesPastLimit)
+{
+	HeadlessGpuTimestampBackend backend(TicksPerSecond);
+	GpuProfiler profiler(backend, 1, 2);
+	CHECK(profiler.BeginScope("OutsideFrame") == GpuProfiler::InvalidScope);
+
+	profiler.BeginFrame();
+	const std::uint32_t a = profiler.BeginScope("A");
+	profiler.EndScope(a);
+	const std::uint32_t b = profiler.BeginScope("B");
+	profiler.EndScope(b);
+	const std::uint32_t c = profiler.BeginScope("C");
+	CHECK(c == GpuProfiler::InvalidScope);
+	profiler.EndScope(c);
+	profiler.EndFrame();
+	backend.CompleteGpuWork();
+	CHECK(profiler.GetDroppedScopeCount() == 2);
+
+	RunEmptyFrame(profiler, backend, 1);
+	REQUIRE(profiler.HasResults());
+	REQUIRE(profiler.GetLastFrame().Passes.size() == 2);
+	CHECK(std::string(profiler.GetLastFrame().Passes[1].Name) == "B");
+}
@@ -0,0 +1,192 @@
+﻿#include "TestHarness.h"
+#include "Render/MaterialRegistry.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+	const std::uint32_t FrameResourceCount = 3;
+
+	MaterialConstants MakeMaterialConstants(std::uint32_t seed)
+	{
+		MaterialConstants constants;
+		constants.DiffuseAlbedo = XMFLOAT4((float)(seed % 256) / 255.0f, (float)(seed / 256 % 256) / 255.0f, 0.5f, 1.0f);
+		constants.Roughness = (float)(seed % 100) / 100.0f;
+		return constants;
+	}
+
+	bool SameConstants(const MaterialConstants& a, const MaterialConstants& b)
+	{
+		return std::memcmp(&a, &b, sizeof(MaterialConstants)) == 0;
+	}
+
+	// 每个帧资源一个缓冲区，按帧轮流写入
+	struct FrameBuffers
+	{
+		std::vector<std::vector<MaterialConstants>> Buffers;
+		std::size_t Frame = 0;
+
+		explicit FrameBuffers(std::size_t materialCount)
+			: Buffers(FrameResourceCount, std::vector<MaterialConstants>(materialCount, MakeMaterialConstants(0xFFFF)))
+		{
+		}
+
+		std::vector<MaterialConstants>& Upload(MaterialRegistry& registry, MaterialUploadStats& stats)
+		{
+			std::vector<MaterialConstants>& buffer = Buffers[Frame++ % FrameResourceCount];
+			registry.Upload(buffer.data(), sizeof(MaterialConstants), &stats);
+			return buffer;
+		}
+	};
+
+	MaterialRegistry MakeRegistry(std::uint32_t materialCount)
+	{
+		MaterialRegistry registry(FrameResourceCount);
+		for (std::uint32_t i = 0; i < materialCount; ++i)
+			registry.Add("material" + std::to_string(i), MakeMaterialConstants(i));
+		return registry;
+	}
+}
+
+TEST_CASE(MaterialRegistry, AddAndFind)
+{
+	MaterialRegistry registry = MakeRegistry(4);
+	CHECK(registry.GetCount() == 4 && registry.GetDirtyCount() == 4);
+	CHECK(registry.Find("material2") == 2 && registry.Find("missing") == InvalidMaterialIndex);
+	CHECK(registry.Add("material1", MakeMaterialConstants(9)) == InvalidMaterialIndex && registry.GetCount() == 4);
+	CHECK(SameConstants(registry.Get(1), MakeMaterialConstants(1)));
+}
+
+TEST_CASE(MaterialRegistry, CountdownWritesEachFrameResourceOnce)
+{
+	MaterialRegistry registry = MakeRegistry(3);
+	FrameBuffers frames(3);
+	MaterialUploadStats stats;
+
+	// 新材质写入每个帧资源各一次，之后不再写入
+	for (std::uint32_t frame = 0; frame < FrameResourceCount; ++frame)
+	{
+		std::vector<MaterialConstants>& buffer = frames.Upload(registry, stats);
+		CHECK(stats.UploadedCount == 3 && stats.UploadBytes == 3 * sizeof(MaterialConstants));
+		CHECK(stats.PendingCount == (frame + 1 < FrameResourceCount ? 3u : 0u));
+		CHECK(std::memcmp(buffer.data(), registry.GetConstants(), 3 * sizeof(MaterialConstants)) == 0);
+	}
+	frames.Upload(registry, stats);
+	CHECK(stats.UploadedCount == 0 && stats.UploadBytes == 0 && registry.GetDirtyCount() == 0);
+
+	// 修改后的材质在之后的FrameResourceCount帧中依次写入每个帧资源
+	registry.Set(1, MakeMaterialConstants(100));
+	for (std::uint32_t frame = 0; frame < FrameResourceCount; ++frame)
+	{
+		std::vector<MaterialConstants>& buffer = frames.Upload(registry, stats);
+		CHECK(stats.UploadedCount == 1 && SameConstants(buffer[1], MakeMaterialConstants(100)));
+		CHECK(registry.GetDirtyCount() == (frame + 1 < FrameResourceCount ? 1u : 0u));
+	}
+	for (const std::vector<MaterialConstants>& buffer : frames.Buffers)
+		CHECK(std::memcmp(buffer.data(), registry.GetConstants(), 3 * sizeof(MaterialConstants)) == 0);
+
+	frames.Upload(registry, stats);
+	CHECK(stats.UploadedCount == 0 && stats.PendingCount == 0);
+}
+
+TEST_CASE(MaterialRegistry, ReDirtyWhilePending)
+{
+	MaterialRegistry registry = MakeRegistry(4);
+	FrameBuffers frames(4);
+	MaterialUploadStats stats;
+	for (std::uint32_t frame = 0; frame < FrameResourceCount; ++frame)
+		frames.Upload(registry, stats);
+
+	// 写入一个帧资源后再次修改：不重复加入脏列表，剩余帧数重新计算
+	registry.Set(2, MakeMaterialConstants(200));
+	frames.Upload(registry, stats);
+	registry.Set(2, MakeMaterialConstants(300));
+	registry.MarkDirty(2);
+	CHECK(registry.GetDirtyCount() == 1);
+	for (std::uint32_t frame = 0; frame < FrameResourceCount; ++frame)
+	{
+		std::vector<MaterialConstants>& buffer = frames.Upload(registry, stats);
+		CHECK(stats.UploadedCount == 1 && SameConstants(buffer[2], MakeMaterialConstants(300)));
+	}
+	CHECK(registry.GetDirtyCount() == 0);
+
+	// 所有帧资源都是最后一次修改的值
+	for (const std::vector<MaterialConstants>& buffer : frames.Buffers)
+		CHECK(SameConstants(buffer[2], MakeMaterialConstants(300)));
+}
+
+TEST_CASE(MaterialRegistry, RemovalWhileOthersDirty)
+{
+	// 剩余帧数不同的材质交错在脏列表中：移除一个时与末尾交换，换到当前位置的材质在同一帧仍被写入
+	MaterialRegistry registry = MakeRegistry(5);
+	FrameBuffers frames(5);
+	MaterialUploadStats stats;
+	frames.Upload(registry, stats);
+	registry.Set(0, MakeMaterialConstants(10));
+	registry.Set(3, MakeMaterialConstants(13));
+	frames.Upload(registry, stats);
+	CHECK(stats.UploadedCount == 5 && stats.PendingCount == 5);
+
+	// 1、2、4写完所有帧资源后被移除，0和3还需写入1帧
+	std::vector<MaterialConstants>& buffer = frames.Upload(registry, stats);
+	CHECK(stats.UploadedCount == 5 && stats.PendingCount == 2);
+	CHECK(std::memcmp(buffer.data(), registry.GetConstants(), 5 * sizeof(MaterialConstants)) == 0);
+
+	std::vector<MaterialConstants>& last = frames.Upload(registry, stats);
+	CHECK(stats.UploadedCount == 2 && stats.PendingCount == 0);
+	CHECK(SameConstants(last[0], MakeMaterialConstants(10)) && SameConstants(last[3], MakeMaterialConstants(13)));
+	for (const std::vector<MaterialConstants>& b : frames.Buffers)
+		CHECK(std::memcmp(b.data(), registry.GetConstants(), 5 * sizeof(MaterialConstants)) == 0);
+}
+
+TEST_CASE(MaterialRegistry, RandomEditsKeepBuffersInSync)
+{
+	/**
+	*	每帧随机修改部分材质后写入轮到的帧资源缓冲区，写入后该缓冲区应与所有材质的当前值一致，
+	*	不再修改后经过FrameResourceCount帧不再写入任何数据
+	*/
+	const std::size_t materialCount = 1000;
+	const std::size_t frameCount = 64;
+	MaterialRegistry registry = MakeRegistry((std::uint32_t)materialCount);
+	FrameBuffers frames(materialCount);
+	std::uint32_t state = 777u;
+	std::size_t mismatches = 0;
+	std::size_t lateUploads = 0;
+	for (std::size_t frame = 0; frame < frameCount; ++frame)
+	{
+		// 前半部分每帧修改0~7个材质(可能重复)，后半部分不修改
+		const std::size_t changes = frame < frameCount / 2 ? frame % 8 : 0;
+		for (std::size_t c = 0; c < changes; ++c)
+		{
+			state = state * 1664525u + 1013904223u;
+			registry.Set((state >> 8) % (std::uint32_t)materialCount, MakeMaterialConstants(state));
+		}
+
+		MaterialUploadStats stats;
+		std::vector<MaterialConstants>& buffer = frames.Upload(registry, stats);
+		if (std::memcmp(buffer.data(), registry.GetConstants(), materialCount * sizeof(MaterialConstants)) != 0)
+			++mismatches;
+		if (frame >= frameCount / 2 + FrameResourceCount && (stats.UploadBytes != 0 || registry.GetDirtyCount() != 0))
+			++lateUploads;
+	}
+	CHECK(mismatches == 0);
+	CHECK(lateUploads == 0);
+}
+
+TEST_CASE(MaterialRegistry, WriteAllWithStride)
+{
+	// 常量缓冲区数组的元素按256字节对齐，WriteAll不改变脏列表
+	const std::size_t stride = 256;
+	MaterialRegistry registry = MakeRegistry(4);
+	std::vector<std::uint8_t> buffer(4 * stride, 0xCD);
+	registry.WriteAll(buffer.data(), stride);
+	bool same = true;
+	for (std::uint32_t i = 0; i < 4; ++i)
+		same = same && std::memcmp(buffer.data() + i * stride, &registry.Get(i), sizeof(MaterialConstants)) == 0;
+	CHECK(same);
+	CHECK(buffer[sizeof(MaterialConstants)] == 0xCD);
+	CHECK(registry.GetDirtyCount() == 4);
+}
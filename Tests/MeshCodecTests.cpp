@@ -0,0 +1,240 @@
+﻿#include "TestHarness.h"
+#include "Mesh/MeshCodec.h"
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	// 平滑变化的顶点数据(每个字节平面的差分较小)，末尾字节随机以覆盖8位组
+	std::vector<std::uint8_t> MakeVertices(std::size_t vertexCount, std::size_t vertexByteStride)
+	{
+		std::vector<std::uint8_t> vertices(vertexCount * vertexByteStride);
+		std::uint32_t state = 12345;
+		for (std::size_t v = 0; v < vertexCount; ++v)
+		{
+			for (std::size_t k = 0; k < vertexByteStride; ++k)
+			{
+				state = state * 1664525u + 1013904223u;
+				vertices[v * vertexByteStride + k] = k + 1 == vertexByteStride ? (std::uint8_t)(state >> 24) : (std::uint8_t)(v * (k + 1) / 3);
+			}
+		}
+		return vertices;
+	}
+
+	// 规则网格的三角形列表，相邻三角形共享边
+	std::vector<std::uint32_t> MakeGridIndices(std::uint32_t rows, std::uint32_t columns, std::uint32_t baseIndex)
+	{
+		std::vector<std::uint32_t> indices;
+		for (std::uint32_t y = 0; y < rows; ++y)
+		{
+			for (std::uint32_t x = 0; x < columns; ++x)
+			{
+				const std::uint32_t v = baseIndex + y * (columns + 1) + x;
+				const std::uint32_t quad[6] = { v, v + columns + 1, v + 1, v + 1, v + columns + 1, v + columns + 2 };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+		return indices;
+	}
+
+	// 互不相连的三角形，顶点在[0, maxIndex]内随机跳跃，覆盖显式写入的zigzag差值(正负方向)
+	std::vector<std::uint32_t> MakeScatteredIndices(std::size_t triangleCount, std::uint32_t maxIndex)
+	{
+		std::vector<std::uint32_t> indices(triangleCount * 3);
+		std::uint32_t state = 2024;
+		for (std::uint32_t& index : indices)
+		{
+			state = state * 1664525u + 1013904223u;
+			index = (std::uint32_t)(((std::uint64_t)state * ((std::uint64_t)maxIndex + 1)) >> 32);
+		}
+		return indices;
+	}
+
+	// 解码结果与原三角形相同，只允许三角形内的旋转(绕序不变)
+	bool SameTriangles(const std::vector<std::uint32_t>& expected, const std::vector<std::uint32_t>& decoded)
+	{
+		if (expected.size() != decoded.size())
+			return false;
+		for (std::size_t t = 0; t < expected.size(); t += 3)
+		{
+			bool found = false;
+			for (std::size_t r = 0; r < 3 && !found; ++r)
+			{
+				found = decoded[t] == expected[t + r] && decoded[t + 1] == expected[t + (r + 1) % 3] && decoded[t + 2] == expected[t + (r + 2) % 3];
+			}
+			if (!found)
+				return false;
+		}
+		return true;
+	}
+
+	// 按indexByteSize编码后解码，返回解码的索引(失败时为空)
+	std::vector<std::uint32_t> RoundTripIndices(const std::vector<std::uint32_t>& indices, std::size_t indexByteSize, std::vector<std::uint8_t>& encoded)
+	{
+		std::vector<std::uint16_t> indices16(indices.begin(), indices.end());
+		const void* source = indexByteSize == 2 ? (const void*)indices16.data() : (const void*)indices.data();
+		if (!EncodeIndexBuffer(source, indices.size(), indexByteSize, encoded))
+			return {};
+
+		std::vector<std::uint32_t> decoded(indices.size());
+		if (indexByteSize == 2)
+		{
+			std::vector<std::uint16_t> decoded16(indices.size());
+			if (!DecodeIndexBuffer(decoded16.data(), indices.size(), 2, encoded.data(), encoded.size()))
+				return {};
+			decoded.assign(decoded16.begin(), decoded16.end());
+		}
+		else if (!DecodeIndexBuffer(decoded.data(), indices.size(), 4, encoded.data(), encoded.size()))
+		{
+			return {};
+		}
+		return decoded;
+	}
+
+	// 每个三角形的编码字节中高4位为15(没有共享边)及低4位为15(显式差值)的数量
+	void CountIndexCodes(const std::vector<std::uint8_t>& encoded, std::size_t triangleCount, std::size_t& noEdgeCount, std::size_t& explicitCount)
+	{
+		noEdgeCount = 0;
+		explicitCount = 0;
+		for (std::size_t t = 0; t < triangleCount; ++t)
+		{
+			noEdgeCount += (encoded[1 + t] >> 4) == 15 ? 1 : 0;
+			explicitCount += (encoded[1 + t] & 15) == 15 ? 1 : 0;
+		}
+	}
+}
+
+TEST_CASE(MeshCodec, VertexRoundTrip)
+{
+	// 覆盖不是4的倍数的步长、不足一组及跨多个块的顶点数量
+	const std::size_t strides[] = { 4, 6, 12, 32, 44, 256 };
+	const std::size_t counts[] = { 1, 15, 16, 17, 255, 256, 257, 1000 };
+	for (std::size_t stride : strides)
+	{
+		for (std::size_t count : counts)
+		{
+			const std::vector<std::uint8_t> vertices = MakeVertices(count, stride);
+			std::vector<std::uint8_t> encoded;
+			EncodeVertexBuffer(vertices.data(), count, stride, encoded);
+
+			// 解码结果之后的字节不能被写入
+			std::vector<std::uint8_t> decoded(vertices.size() + 64, 0xCD);
+			CHECK(DecodeVertexBuffer(decoded.data(), count, stride, encoded.data(), encoded.size()));
+			CHECK(std::memcmp(decoded.data(), vertices.data(), vertices.size()) == 0);
+			bool untouched = true;
+			for (std::size_t i = vertices.size(); i < decoded.size(); ++i)
+				untouched = untouched && decoded[i] == 0xCD;
+			CHECK(untouched);
+		}
+	}
+}
+
+TEST_CASE(MeshCodec, VertexRejectsTruncatedData)
+{
+	const std::vector<std::uint8_t> vertices = MakeVertices(300, 12);
+	std::vector<std::uint8_t> encoded;
+	EncodeVertexBuffer(vertices.data(), 300, 12, encoded);
+
+	std::vector<std::uint8_t> decoded(vertices.size());
+	CHECK(!DecodeVertexBuffer(decoded.data(), 300, 12, encoded.data(), encoded.size() - 1));
+	CHECK(!DecodeVertexBuffer(decoded.data(), 300, 12, encoded.data(), encoded.size() / 2));
+	encoded.push_back(0);
+	CHECK(!DecodeVertexBuffer(decoded.data(), 300, 12, encoded.data(), encoded.size()));
+}
+
+TEST_CASE(MeshCodec, IndexRoundTripSharedEdges)
+{
+	// 网格中大部分三角形通过边FIFO引用前面的边，编码后不到16位索引的一半
+	for (std::size_t indexByteSize : { (std::size_t)2, (std::size_t)4 })
+	{
+		const std::uint32_t baseIndex = indexByteSize == 2 ? 100 : 70000;
+		const std::vector<std::uint32_t> indices = MakeGridIndices(30, 40, baseIndex);
+		std::vector<std::uint8_t> encoded;
+		CHECK(SameTriangles(indices, RoundTripIndices(indices, indexByteSize, encoded)));
+
+		const std::size_t triangleCount = indices.size() / 3;
+		std::size_t noEdgeCount = 0, explicitCount = 0;
+		CountIndexCodes(encoded, triangleCount, noEdgeCount, explicitCount);
+		CHECK(noEdgeCount < triangleCount / 10);
+		CHECK(encoded.size() < triangleCount * 3);
+	}
+}
+
+TEST_CASE(MeshCodec, IndexRoundTripExplicitDeltas)
+{
+	// 不共享边且顶点跳跃较大的三角形全部使用显式差值，32位时差值超过16位
+	const std::uint32_t maxIndices[] = { 0xFFFF, 0xFFFFFFFFu };
+	for (std::size_t k = 0; k < 2; ++k)
+	{
+		const std::size_t indexByteSize = k == 0 ? 2 : 4;
+		const std::vector<std::uint32_t> indices = MakeScatteredIndices(500, maxIndices[k]);
+		std::vector<std::uint8_t> encoded;
+		CHECK(SameTriangles(indices, RoundTripIndices(indices, indexByteSize, encoded)));
+
+		std::size_t noEdgeCount = 0, explicitCount = 0;
+		CountIndexCodes(encoded, 500, noEdgeCount, explicitCount);
+		CHECK(noEdgeCount == 500 && explicitCount == 500);
+	}
+
+	// 网格与零散三角形交替，顶点FIFO、边FIFO及显式差值混合出现
+	std::vector<std::uint32_t> mixed = MakeGridIndices(4, 4, 10);
+	const std::vector<std::uint32_t> scattered = MakeScatteredIndices(20, 60000);
+	mixed.insert(mixed.end(), scattered.begin(), scattered.end());
+	const std::vector<std::uint32_t> grid = MakeGridIndices(4, 4, 10);
+	mixed.insert(mixed.end(), grid.begin(), grid.end());
+	std::vector<std::uint8_t> encoded;
+	CHECK(SameTriangles(mixed, RoundTripIndices(mixed, 2, encoded)));
+	CHECK(SameTriangles(mixed, RoundTripIndices(mixed, 4, encoded)));
+
+	// 空的索引
+	std::vector<std::uint8_t> empty;
+	CHECK(EncodeIndexBuffer(nullptr, 0, 2, empty) && DecodeIndexBuffer(nullptr, 0, 2, empty.data(), empty.size()));
+}
+
+TEST_CASE(MeshCodec, IndexRejectsInvalidInput)
+{
+	const std::vector<std::uint32_t> indices = MakeGridIndices(8, 8, 0);
+	std::vector<std::uint8_t> encoded;
+	std::vector<std::uint32_t> decoded(indices.size());
+
+	// 索引数量不是3的倍数，或索引大小不是2/4
+	CHECK(!EncodeIndexBuffer(indices.data(), indices.size() - 1, 4, encoded));
+	CHECK(!EncodeIndexBuffer(indices.data(), indices.size(), 3, encoded));
+	REQUIRE(EncodeIndexBuffer(indices.data(), indices.size(), 4, encoded));
+	CHECK(!DecodeIndexBuffer(decoded.data(), indices.size() - 1, 4, encoded.data(), encoded.size()));
+	CHECK(!DecodeIndexBuffer(decoded.data(), indices.size(), 3, encoded.data(), encoded.size()));
+
+	// 截断、多余的数据及错误的头
+	CHECK(!DecodeIndexBuffer(decoded.data(), indices.size(), 4, encoded.data(), encoded.size() - 1));
+	CHECK(!DecodeIndexBuffer(decoded.data(), indices.size(), 4, encoded.data(), 1 + indices.size() / 3 - 1));
+	std::vector<std::uint8_t> padded = encoded;
+	padded.push_back(0);
+	CHECK(!DecodeIndexBuffer(decoded.data(), indices.size(), 4, padded.data(), padded.size()));
+	std::vector<std::uint8_t> badHeader = encoded;
+	badHeader[0] ^= 0xFF;
+	CHECK(!DecodeIndexBuffer(decoded.data(), indices.size(), 4, badHeader.data(), badHeader.size()));
+
+	// 第一个三角形引用不存在的边
+	std::vector<std::uint8_t> badEdge = encoded;
+	badEdge[1] = 0x00;
+	CHECK(!DecodeIndexBuffer(decoded.data(), indices.size(), 4, badEdge.data(), badEdge.size()));
+
+	// 随机数据不能越界读写(解码可能成功，只检查输出之后的内存未被改写)
+	std::uint32_t state = 99;
+	for (int trial = 0; trial < 200; ++trial)
+	{
+		std::vector<std::uint8_t> garbage(encoded.size());
+		for (std::uint8_t& b : garbage)
+		{
+			state = state * 1664525u + 1013904223u;
+			b = (std::uint8_t)(state >> 24);
+		}
+		garbage[0] = encoded[0];
+		std::vector<std::uint32_t> output(indices.size() + 16, 0xCDCDCDCDu);
+		DecodeIndexBuffer(output.data(), indices.size(), 4, garbage.data(), garbage.size());
+		bool untouched = true;
+		for (std::size_t i = indices.size(); i < output.size(); ++i)
+			untouched = untouched && output[i] == 0xCDCDCDCDu;
+		CHECK(untouched);
+	}
+}
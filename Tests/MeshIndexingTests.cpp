@@ -0,0 +1,237 @@
+﻿#include "TestHarness.h"
+#include "Mesh/MeshIndexing.h"
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+	// side x side个顶点的网格，带法线及纹理坐标(用于检查附加属性随顶点一起复制)
+	void AddGrid(MeshData& mesh, const std::string& name, std::uint32_t side, float y)
+	{
+		const std::uint32_t base = (std::uint32_t)mesh.Vertices.size();
+		for (std::uint32_t z = 0; z < side; ++z)
+		{
+			for (std::uint32_t x = 0; x < side; ++x)
+			{
+				mesh.Vertices.push_back(Vertex{ XMFLOAT3((float)x, y, (float)z), XMFLOAT4((float)x / side, (float)z / side, y, 1.0f) });
+				mesh.Normals.push_back(XMFLOAT3(0.0f, 1.0f, (float)(x + z)));
+				mesh.TexCoords.push_back(XMFLOAT2((float)x, (float)z));
+			}
+		}
+
+		MeshSubset subset;
+		subset.Name = name;
+		subset.StartIndexLocation = (std::uint32_t)mesh.Indices32.size();
+		for (std::uint32_t z = 0; z + 1 < side; ++z)
+		{
+			for (std::uint32_t x = 0; x + 1 < side; ++x)
+			{
+				const std::uint32_t i0 = base + z * side + x;
+				const std::uint32_t quad[6] = { i0, i0 + side, i0 + 1, i0 + 1, i0 + side, i0 + side + 1 };
+				mesh.Indices32.insert(mesh.Indices32.end(), quad, quad + 6);
+			}
+		}
+		subset.IndexCount = (std::uint32_t)mesh.Indices32.size() - subset.StartIndexLocation;
+		mesh.Subsets.push_back(subset);
+	}
+
+	// 以顶点内容表示的三角形，拆分前后应完全一致(三角形顺序不变)
+	struct TriangleCorner
+	{
+		Vertex Point;
+		XMFLOAT3 Normal;
+		XMFLOAT2 TexCoord;
+	};
+
+	// 按子集名收集三角形，同名子集(拆分结果)依次拼接
+	std::vector<std::pair<std::string, std::vector<TriangleCorner>>> CollectTriangles(const MeshData& mesh)
+	{
+		std::vector<std::pair<std::string, std::vector<TriangleCorner>>> result;
+		for (const MeshSubset& subset : mesh.Subsets)
+		{
+			if (result.empty() || result.back().first != subset.Name)
+				result.emplace_back(subset.Name, std::vector<TriangleCorner>());
+			for (std::uint32_t i = 0; i < subset.IndexCount; ++i)
+			{
+				const std::size_t v = (std::size_t)mesh.Indices32[subset.StartIndexLocation + i] + subset.BaseVertexLocation;
+				result.back().second.push_back(TriangleCorner{ mesh.Vertices[v], mesh.Normals[v], mesh.TexCoords[v] });
+			}
+		}
+		return result;
+	}
+
+	bool SameTriangles(const MeshData& before, const MeshData& after)
+	{
+		const auto a = CollectTriangles(before);
+		const auto b = CollectTriangles(after);
+		if (a.size() != b.size())
+			return false;
+		for (std::size_t i = 0; i < a.size(); ++i)
+		{
+			if (a[i].first != b[i].first || a[i].second.size() != b[i].second.size()
+				|| std::memcmp(a[i].second.data(), b[i].second.data(), sizeof(TriangleCorner) * a[i].second.size()) != 0)
+				return false;
+		}
+		return true;
+	}
+
+	// 每个子集的索引都可用16位表示且引用的顶点都在顶点数组内
+	bool SubsetsFit16Bit(const MeshData& mesh)
+	{
+		for (const MeshSubset& subset : mesh.Subsets)
+		{
+			std::set<std::uint32_t> referenced;
+			for (std::uint32_t i = 0; i < subset.IndexCount; ++i)
+			{
+				const std::uint32_t index = mesh.Indices32[subset.StartIndexLocation + i];
+				if (index >= MaxVerticesPer16BitSubset || subset.BaseVertexLocation < 0
+					|| (std::size_t)index + subset.BaseVertexLocation >= mesh.Vertices.size())
+					return false;
+				referenced.insert(index);
+			}
+			if (referenced.size() > MaxVerticesPer16BitSubset)
+				return false;
+		}
+		return true;
+	}
+}
+
+TEST_CASE(MeshIndexing, SplitLargeMesh)
+{
+	// 300 x 300 = 90000个顶点，必须拆分
+	MeshData mesh;
+	AddGrid(mesh, "terrain", 300, 0.0f);
+	const MeshData source = mesh;
+	REQUIRE(!source.CanUse16BitIndices());
+
+	MeshIndexStats stats;
+	SplitMeshFor16BitIndices(mesh, &stats);
+	CHECK(stats.SourceSubsetCount == 1);
+	CHECK(stats.SubsetCount == mesh.Subsets.size() && mesh.Subsets.size() >= 2);
+	CHECK(stats.IndexByteSize == 2 && SelectIndexByteSize(mesh) == 2);
+	CHECK(stats.IndexCount == source.Indices32.size() && mesh.Indices32.size() == source.Indices32.size());
+	CHECK(stats.DroppedIndexCount == 0);
+	CHECK(mesh.Normals.size() == mesh.Vertices.size() && mesh.TexCoords.size() == mesh.Vertices.size());
+	CHECK(SubsetsFit16Bit(mesh));
+	CHECK(SameTriangles(source, mesh));
+
+	// 只有跨越部分边界的一行顶点被复制
+	CHECK(stats.DuplicatedVertexCount == mesh.Vertices.size() - source.Vertices.size());
+	CHECK(stats.DuplicatedVertexCount < 2 * 300 * (stats.SubsetCount - 1));
+	CHECK(stats.BytesSaved(sizeof(Vertex)) > 0);
+
+	// 各部分的包围盒包含其顶点
+	for (const MeshSubset& subset : mesh.Subsets)
+		CHECK(subset.Bounds.Extents.x > 0.0f && subset.Bounds.Extents.z > 0.0f);
+}
+
+TEST_CASE(MeshIndexing, SplitShuffledTriangles)
+{
+	// 三角形顺序打乱后每个部分引用的顶点分散，拆分出的部分更多但结果仍然正确
+	MeshData mesh;
+	AddGrid(mesh, "shuffled", 260, 1.0f);
+	std::uint32_t state = 1;
+	const std::size_t triangleCount = mesh.Indices32.size() / 3;
+	for (std::size_t t = triangleCount - 1; t > 0; --t)
+	{
+		state = state * 1664525u + 1013904223u;
+		const std::size_t other = (std::size_t)(state >> 8) % (t + 1);
+		for (std::size_t k = 0; k < 3; ++k)
+			std::swap(mesh.Indices32[t * 3 + k], mesh.Indices32[other * 3 + k]);
+	}
+	const MeshData source = mesh;
+
+	MeshIndexStats stats;
+	SplitMeshFor16BitIndices(mesh, &stats);
+	CHECK(SelectIndexByteSize(mesh) == 2);
+	CHECK(SubsetsFit16Bit(mesh));
+	CHECK(SameTriangles(source, mesh));
+}
+
+TEST_CASE(MeshIndexing, RebaseWithoutSplit)
+{
+	// 两个子集各自的顶点范围不超过65536，只调整BaseVertexLocation，顶点数组不变
+	MeshData mesh;
+	AddGrid(mesh, "lower", 200, 0.0f);
+	AddGrid(mesh, "upper", 200, 5.0f);
+	const MeshData source = mesh;
+	REQUIRE(!source.CanUse16BitIndices());
+
+	MeshIndexStats stats;
+	SplitMeshFor16BitIndices(mesh, &stats);
+	CHECK(stats.SubsetCount == 2 && stats.DuplicatedVertexCount == 0);
+	CHECK(mesh.Vertices.size() == source.Vertices.size());
+	CHECK(std::memcmp(mesh.Vertices.data(), source.Vertices.data(), sizeof(Vertex) * source.Vertices.size()) == 0);
+	CHECK(mesh.Subsets[0].BaseVertexLocation == 0 && mesh.Subsets[1].BaseVertexLocation == 200 * 200);
+	CHECK(SelectIndexByteSize(mesh) == 2);
+	CHECK(SameTriangles(source, mesh));
+}
+
+TEST_CASE(MeshIndexing, WholeBufferWithoutSubsets)
+{
+	MeshData mesh;
+	AddGrid(mesh, "", 300, 0.0f);
+	mesh.Name = "unnamed";
+	mesh.Subsets.clear();
+
+	SplitMeshFor16BitIndices(mesh);
+	REQUIRE(mesh.Subsets.size() >= 2);
+	for (const MeshSubset& subset : mesh.Subsets)
+		CHECK(subset.Name == "unnamed");
+	CHECK(SubsetsFit16Bit(mesh) && SelectIndexByteSize(mesh) == 2);
+}
+
+TEST_CASE(MeshIndexing, TrailingIndicesDropped)
+{
+	// 拆分及只调整BaseVertexLocation时: 第一个子集末尾多出两个索引(不构成三角形)，其值超出16位范围
+	for (int split = 0; split < 2; ++split)
+	{
+		MeshData mesh;
+		AddGrid(mesh, "first", split ? 300 : 100, 0.0f);
+		const std::uint32_t first = mesh.Subsets[0].IndexCount;
+		mesh.Indices32.insert(mesh.Indices32.begin() + first, { 70000u, 70001u });
+		mesh.Subsets[0].IndexCount += 2;
+		AddGrid(mesh, "second", 100, 1.0f);
+
+		MeshData expected = mesh;
+		expected.Subsets[0].IndexCount = first;
+
+		MeshIndexStats stats;
+		SplitMeshFor16BitIndices(mesh, &stats);
+		CHECK(stats.DroppedIndexCount == 2);
+		CHECK(stats.IndexCount == expected.Indices32.size() - 2 && mesh.Indices32.size() == stats.IndexCount);
+		CHECK(SelectIndexByteSize(mesh) == 2);
+		CHECK(SubsetsFit16Bit(mesh));
+		CHECK(SameTriangles(expected, mesh));
+		for (const MeshSubset& subset : mesh.Subsets)
+			CHECK(subset.IndexCount % 3 == 0);
+	}
+}
+
+TEST_CASE(MeshIndexing, EmptySubsetsKept)
+{
+	// 拆分及只调整BaseVertexLocation时空的子集都保留
+	for (std::uint32_t side : { 300u, 100u })
+	{
+		MeshData mesh;
+		MeshSubset empty;
+		empty.Name = "empty";
+		mesh.Subsets.push_back(empty);
+		AddGrid(mesh, "grid", side, 0.0f);
+		mesh.Subsets.push_back(empty);
+		mesh.Subsets.back().Name = "tail";
+		mesh.Subsets.back().StartIndexLocation = (std::uint32_t)mesh.Indices32.size();
+		const MeshData source = mesh;
+
+		SplitMeshFor16BitIndices(mesh);
+		REQUIRE(mesh.Subsets.size() >= 3);
+		CHECK(mesh.Subsets.front().Name == "empty" && mesh.Subsets.front().IndexCount == 0);
+		CHECK(mesh.Subsets.back().Name == "tail" && mesh.Subsets.back().IndexCount == 0);
+		CHECK(SubsetsFit16Bit(mesh));
+		CHECK(SameTriangles(source, mesh));
+	}
+}
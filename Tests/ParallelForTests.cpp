@@ -0,0 +1,65 @@
+﻿#include "TestHarness.h"
+#include "ParallelFor.h"
+#include <atomic>
+#include <vector>
+
+TEST_CASE(WorkerPool, CoversEveryIndexOnce)
+{
+	WorkerPool pool(3);
+	CHECK(pool.GetThreadCount() == 4);
+	for (std::size_t count : { (std::size_t)1, (std::size_t)7, (std::size_t)1000, (std::size_t)100003 })
+	{
+		for (unsigned threadCount : { 0u, 1u, 2u, 16u })
+		{
+			std::vector<std::atomic<int>> hits(count);
+			for (std::atomic<int>& hit : hits)
+				hit = 0;
+			pool.ParallelFor(count, 16, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+					++hits[i];
+			}, threadCount);
+
+			bool once = true;
+			for (const std::atomic<int>& hit : hits)
+				once = once && hit == 1;
+			CHECK(once);
+		}
+	}
+}
+
+TEST_CASE(WorkerPool, RepeatedJobs)
+{
+	// 连续提交大量短任务，工作线程在任务之间等待而不重新创建
+	WorkerPool pool(3);
+	std::atomic<std::size_t> total(0);
+	for (int job = 0; job < 2000; ++job)
+		pool.ParallelFor(4096, 64, [&](std::size_t begin, std::size_t end) { total += end - begin; });
+	CHECK(total == (std::size_t)2000 * 4096);
+}
+
+TEST_CASE(WorkerPool, NestedCallRunsSerially)
+{
+	WorkerPool pool(3);
+	std::atomic<std::size_t> total(0);
+	pool.ParallelFor(16, 1, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t i = begin; i < end; ++i)
+			pool.ParallelFor(100, 1, [&](std::size_t first, std::size_t last) { total += last - first; });
+	});
+	CHECK(total == 1600);
+}
+
+TEST_CASE(WorkerPool, NoHelpers)
+{
+	WorkerPool pool(0);
+	CHECK(pool.GetThreadCount() == 1);
+	std::size_t calls = 0;
+	std::size_t covered = 0;
+	pool.ParallelFor(10000, 16, [&](std::size_t begin, std::size_t end)
+	{
+		++calls;
+		covered += end - begin;
+	}, 8);
+	CHECK(calls == 1 && covered == 10000);
+}
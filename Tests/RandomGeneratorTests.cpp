@@ -0,0 +1,254 @@
+﻿#include "TestHarness.h"
+#include "MathHelper.h"
+#include "RandomGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+	// 分布检验的样本数及固定种子，检验结果可复现
+	const std::size_t SampleCount = 1 << 18;
+	const std::uint64_t SampleSeed = 1;
+
+	// 各桶期望数量相同时的卡方统计量
+	double ChiSquare(const std::vector<std::uint64_t>& histogram, std::size_t sampleCount)
+	{
+		const double expected = (double)sampleCount / (double)histogram.size();
+		double chi = 0.0;
+		for (std::uint64_t n : histogram)
+			chi += ((double)n - expected) * ((double)n - expected) / expected;
+		return chi;
+	}
+
+	// 自由度为dof的卡方分布的上0.05%分位数(Wilson-Hilferty近似)，均匀分布时超过的概率约为1/2000
+	double ChiSquareLimit(std::size_t dof)
+	{
+		const double k = (double)dof;
+		const double t = 1.0 - 2.0 / (9.0 * k) + 3.29 * std::sqrt(2.0 / (9.0 * k));
+		return k * t * t * t;
+	}
+
+	std::size_t Bucket(double t, std::size_t bucketCount)
+	{
+		const std::size_t bucket = t <= 0.0 ? 0 : (std::size_t)(t * (double)bucketCount);
+		return bucket < bucketCount ? bucket : bucketCount - 1;
+	}
+
+	// [a, b)内的均匀分布：卡方、均值且没有超出范围的值
+	bool IsUniform(const std::vector<float>& values, float a, float b)
+	{
+		std::vector<std::uint64_t> histogram(64);
+		double sum = 0.0;
+		for (float v : values)
+		{
+			if (v < a || v >= b)
+				return false;
+			histogram[Bucket((v - a) / (b - a), histogram.size())]++;
+			sum += v;
+		}
+		const double mean = sum / (double)values.size();
+		return ChiSquare(histogram, values.size()) <= ChiSquareLimit(histogram.size() - 1)
+			&& std::fabs(mean - 0.5 * (a + b)) / (b - a) <= 0.005;
+	}
+
+	// [a, b]内的均匀整数，范围不是2的幂时取模及乘法映射的偏差都会体现在卡方中
+	bool IsUniform(const std::vector<int>& values, int a, int b)
+	{
+		std::vector<std::uint64_t> histogram((std::size_t)(b - a + 1));
+		for (int v : values)
+		{
+			if (v < a || v > b)
+				return false;
+			histogram[(std::size_t)(v - a)]++;
+		}
+		return ChiSquare(histogram, values.size()) <= ChiSquareLimit(histogram.size() - 1);
+	}
+
+	/**
+	*	单位球面上的均匀分布：z与方位角均为均匀分布(阿基米德定理)，平均向量接近0
+	*	半球(n不为空)：与n的点积在[0, 1]上均匀分布，平均点积为0.5；方位角分布取决于n，不检验
+	*/
+	bool IsUniformDirections(const std::vector<XMFLOAT3>& directions, const XMFLOAT3* n)
+	{
+		std::vector<std::uint64_t> heightHistogram(64), azimuthHistogram(64);
+		double sumX = 0.0, sumY = 0.0, sumZ = 0.0, sumDot = 0.0;
+		for (const XMFLOAT3& v : directions)
+		{
+			const double length = std::sqrt((double)v.x * v.x + (double)v.y * v.y + (double)v.z * v.z);
+			if (std::fabs(length - 1.0) > 1e-4)
+				return false;
+			sumX += v.x;
+			sumY += v.y;
+			sumZ += v.z;
+			azimuthHistogram[Bucket((std::atan2((double)v.y, (double)v.x) + XM_PI) / XM_2PI, azimuthHistogram.size())]++;
+			if (n)
+			{
+				const double d = (double)v.x * n->x + (double)v.y * n->y + (double)v.z * n->z;
+				if (d < -1e-6)
+					return false;
+				sumDot += d;
+				heightHistogram[Bucket(d, heightHistogram.size())]++;
+			}
+			else
+			{
+				heightHistogram[Bucket(0.5 * (v.z + 1.0), heightHistogram.size())]++;
+			}
+		}
+
+		const double count = (double)directions.size();
+		if (ChiSquare(heightHistogram, directions.size()) > ChiSquareLimit(heightHistogram.size() - 1))
+			return false;
+		if (n)
+			return std::fabs(sumDot / count - 0.5) <= 0.005;
+		return ChiSquare(azimuthHistogram, directions.size()) <= ChiSquareLimit(azimuthHistogram.size() - 1)
+			&& std::sqrt(sumX * sumX + sumY * sumY + sumZ * sumZ) / count <= 0.005;
+	}
+}
+
+TEST_CASE(RandomGenerator, KnownAnswer)
+{
+	// 参考实现(SplitMix64展开种子1，xoshiro128**)的前6个输出及Jump后的前4个输出
+	const std::uint32_t expected[] = { 0x650941ba, 0x54d30301, 0x25d2f321, 0x3fabdca9, 0x2ab8e0a6, 0xf9890067 };
+	const std::uint32_t expectedJump[] = { 0x4a2276b1, 0xd209907d, 0xa3b25b33, 0xc9480e20 };
+
+	RandomGenerator random(1);
+	for (std::uint32_t value : expected)
+		CHECK(random.NextUInt() == value);
+
+	random.Seed(1);
+	random.Jump();
+	for (std::uint32_t value : expectedJump)
+		CHECK(random.NextUInt() == value);
+}
+
+TEST_CASE(RandomGenerator, BatchLanesMatchJumpedSequences)
+{
+	// 第lane路与Jump lane次的单个生成器序列相同，与使用的SIMD实现无关
+	const std::size_t blockCount = 5;
+	BatchRandomGenerator batch(SampleSeed);
+	std::vector<std::uint32_t> values(BatchRandomGenerator::LaneCount * blockCount);
+	batch.FillUInts(values.data(), values.size());
+
+	RandomGenerator random(SampleSeed);
+	bool same = true;
+	for (std::size_t lane = 0; lane < BatchRandomGenerator::LaneCount; ++lane)
+	{
+		RandomGenerator laneRandom = random;
+		for (std::size_t b = 0; b < blockCount; ++b)
+			same = same && values[b * BatchRandomGenerator::LaneCount + lane] == laneRandom.NextUInt();
+		random.Jump();
+	}
+	CHECK(same);
+
+	// 不是8的倍数时最后一组多余的数被丢弃
+	BatchRandomGenerator partial(SampleSeed);
+	std::vector<std::uint32_t> head(11);
+	partial.FillUInts(head.data(), head.size());
+	std::vector<std::uint32_t> next(8);
+	partial.FillUInts(next.data(), next.size());
+	CHECK(std::equal(head.begin(), head.end(), values.begin()));
+	CHECK(std::equal(next.begin(), next.end(), values.begin() + 16));
+}
+
+TEST_CASE(RandomGenerator, Ranges)
+{
+	RandomGenerator random(SampleSeed);
+	bool inRange = true;
+	for (std::size_t i = 0; i < 100000; ++i)
+	{
+		const float f = random.NextFloat();
+		const float g = random.NextFloat(-2.0f, 3.0f);
+		const std::uint32_t u = random.NextUInt(7);
+		const int n = random.NextInt(-3, 6);
+		inRange = inRange && f >= 0.0f && f < 1.0f && g >= -2.0f && g < 3.0f && u < 7 && n >= -3 && n <= 6;
+	}
+	CHECK(inRange);
+	CHECK(random.NextUInt(0) == 0 && random.NextUInt(1) == 0);
+	CHECK(random.NextInt(5, 5) == 5);
+
+	// 范围包括整个32位
+	bool negative = false, positive = false;
+	for (int i = 0; i < 64; ++i)
+	{
+		const int n = random.NextInt(INT32_MIN, INT32_MAX);
+		negative = negative || n < 0;
+		positive = positive || n > 0;
+	}
+	CHECK(negative && positive);
+
+	BatchRandomGenerator batch(SampleSeed);
+	std::vector<int> ints(1000);
+	batch.FillInts(ints.data(), ints.size(), 100, 100);
+	CHECK(std::all_of(ints.begin(), ints.end(), [](int v) { return v == 100; }));
+}
+
+TEST_CASE(RandomGenerator, UniformFloats)
+{
+	SeedThreadRandom(SampleSeed);
+	std::vector<float> samples(SampleCount);
+	for (float& v : samples)
+		v = MathHelper::RandF(-2.0f, 3.0f);
+	CHECK(IsUniform(samples, -2.0f, 3.0f));
+
+	MathHelper::RandF(samples.data(), samples.size(), -2.0f, 3.0f);
+	CHECK(IsUniform(samples, -2.0f, 3.0f));
+}
+
+TEST_CASE(RandomGenerator, UniformInts)
+{
+	SeedThreadRandom(SampleSeed);
+	std::vector<int> samples(SampleCount);
+	for (int& v : samples)
+		v = MathHelper::Rand(-3, 6);
+	CHECK(IsUniform(samples, -3, 6));
+
+	MathHelper::Rand(samples.data(), samples.size(), -3, 6);
+	CHECK(IsUniform(samples, -3, 6));
+}
+
+TEST_CASE(RandomGenerator, UniformDirections)
+{
+	SeedThreadRandom(SampleSeed);
+	// 半球的法线不是坐标轴且未单位化
+	const XMVECTOR normal = XMVectorSet(1.2f, 0.0f, 1.6f, 0.0f);
+	XMFLOAT3 unitNormal;
+	XMStoreFloat3(&unitNormal, XMVector3Normalize(normal));
+
+	std::vector<XMFLOAT3> samples(SampleCount);
+	for (XMFLOAT3& v : samples)
+		XMStoreFloat3(&v, MathHelper::RandUnitVec3());
+	CHECK(IsUniformDirections(samples, nullptr));
+	MathHelper::RandUnitVec3(samples.data(), samples.size());
+	CHECK(IsUniformDirections(samples, nullptr));
+
+	for (XMFLOAT3& v : samples)
+		XMStoreFloat3(&v, MathHelper::RandHemisphereUnitVec3(normal));
+	CHECK(IsUniformDirections(samples, &unitNormal));
+	MathHelper::RandHemisphereUnitVec3(normal, samples.data(), samples.size());
+	CHECK(IsUniformDirections(samples, &unitNormal));
+}
+
+TEST_CASE(RandomGenerator, DegenerateHemisphereNormal)
+{
+	// 法线为0或长度的平方下溢为0时不做反射，两种实现都返回整个球面上的单位向量而不是NaN
+	SeedThreadRandom(SampleSeed);
+	const XMVECTOR normals[] = { XMVectorZero(), XMVectorSet(1e-30f, -1e-30f, 0.0f, 0.0f) };
+	for (XMVECTOR normal : normals)
+	{
+		std::vector<XMFLOAT3> samples(4096);
+		for (XMFLOAT3& v : samples)
+			XMStoreFloat3(&v, MathHelper::RandHemisphereUnitVec3(normal));
+		std::vector<XMFLOAT3> batch(samples.size());
+		MathHelper::RandHemisphereUnitVec3(normal, batch.data(), batch.size());
+
+		auto isUnit = [](const XMFLOAT3& v) { return std::fabs(std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z) - 1.0f) <= 1e-4f; };
+		CHECK(std::all_of(samples.begin(), samples.end(), isUnit));
+		CHECK(std::all_of(batch.begin(), batch.end(), isUnit));
+		// 没有被反射到一侧
+		CHECK(std::any_of(samples.begin(), samples.end(), [](const XMFLOAT3& v) { return v.x < 0.0f; }));
+		CHECK(std::any_of(batch.begin(), batch.end(), [](const XMFLOAT3& v) { return v.x < 0.0f; }));
+	}
+}
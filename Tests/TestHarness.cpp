@@ -0,0 +1,84 @@
+﻿// TestHarness.cpp : 单元测试入口
+//
+// 在不需要GPU的环境下测试Common中与D3D12无关的模块，D3D12相关的部分通过Headless后端测试。
+//
+// 用法: UnitTests [--filter <Suite.Name>]
+//
+// Linux下构建(需要DirectXMath头文件):
+//   g++ -std=c++17 -O2 -I<DirectXMath>/Inc -ILearnDX12/Common/Include Tests/*.cpp
+//       LearnDX12/Common/Asset/AssetPack.cpp LearnDX12/Common/Mesh/{MeshCodec,MeshIndexing}.cpp
+//       LearnDX12/Common/Render/{BundleCache,CommandRecorder,DrawQueue,MaterialRegistry}.cpp
+//       LearnDX12/Common/Profile/{CpuProfiler,GpuProfiler,RenderCounters}.cpp
+//       LearnDX12/Common/{FrameTimeStats,MathHelper,RandomGenerator,SystemTimer}.cpp -lpthread -o UnitTests
+//
+
+#include "TestHarness.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	struct TestEntry
+	{
+		std::string Name;
+		TestFunction Function;
+	};
+
+	// 函数内的静态变量，保证注册时已初始化(各测试文件的静态初始化顺序不确定)
+	std::vector<TestEntry>& GetTests()
+	{
+		static std::vector<TestEntry> tests;
+		return tests;
+	}
+
+	std::size_t CurrentFailures = 0;
+}
+
+TestRegistrar::TestRegistrar(const char* suite, const char* name, TestFunction function)
+{
+	GetTests().push_back(TestEntry{ std::string(suite) + "." + name, function });
+}
+
+void ReportTestFailure(const char* file, int line, const std::string& expression)
+{
+	++CurrentFailures;
+	std::fprintf(stderr, "  %s(%d): CHECK(%s) failed\n", file, line, expression.c_str());
+}
+
+std::size_t RunTests(const std::string& filter)
+{
+	std::size_t runCount = 0;
+	std::size_t failedCount = 0;
+	for (const TestEntry& test : GetTests())
+	{
+		if (!filter.empty() && test.Name.find(filter) == std::string::npos)
+			continue;
+
+		CurrentFailures = 0;
+		test.Function();
+		++runCount;
+		if (CurrentFailures > 0)
+			++failedCount;
+		std::fprintf(stderr, "%-56s %s\n", test.Name.c_str(), CurrentFailures > 0 ? "FAILED" : "ok");
+	}
+
+	std::fprintf(stderr, "%zu tests, %zu failed\n", runCount, failedCount);
+	return failedCount;
+}
+
+int main(int argc, char** argv)
+{
+	std::string filter;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			filter = argv[++i];
+		else
+		{
+			std::fprintf(stderr, "usage: UnitTests [--filter <Suite.Name>]\n");
+			return 2;
+		}
+	}
+	return RunTests(filter) > 0 ? 1 : 0;
+}
@@ -0,0 +1,33 @@
+﻿#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+*	单元测试的公共部分：测试用例注册、检查宏及运行
+*	每个测试用例是一个无参数函数，以TEST_CASE(Suite, Name)定义后自动注册，CHECK失败时记录文件及行号并继续执行，
+*	REQUIRE失败时结束当前用例。全部用例通过时进程退出码为0，否则为1。
+*/
+typedef void(*TestFunction)();
+
+// 注册测试用例(由TEST_CASE在静态初始化时调用)
+struct TestRegistrar
+{
+	TestRegistrar(const char* suite, const char* name, TestFunction function);
+};
+
+// 记录一次检查失败
+void	ReportTestFailure(const char* file, int line, const std::string& expression);
+
+// 运行名称(Suite.Name)包含filter的用例，filter为空时运行全部，返回失败的用例数
+std::size_t	RunTests(const std::string& filter);
+
+#define TEST_CASE(suite, name) \
+	static void suite##_##name(); \
+	static const TestRegistrar suite##_##name##Registrar(#suite, #name, suite##_##name); \
+	static void suite##_##name()
+
+#define CHECK(expression) \
+	do { if (!(expression)) ReportTestFailure(__FILE__, __LINE__, #expression); } while (0)
+
+#define REQUIRE(expression) \
+	do { if (!(expression)) { ReportTestFailure(__FILE__, __LINE__, #expression); return; } } while (0)